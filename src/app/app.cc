@@ -149,10 +149,16 @@ constexpr double kSimulationFixedHz = 60.0;
 constexpr double kSimulationFixedStepSeconds = 1.0 / kSimulationFixedHz;
 constexpr double kFrameDeltaClampSeconds = 0.25;
 constexpr int kMaxSimulationStepsPerFrame = 8;
-// Off-thread chunk mesh jobs launched per frame. Meshing no longer costs
-// main-thread time, so this bounds worker occupancy and per-frame upload
-// size rather than remesh CPU (the old inline budget was 6).
-constexpr std::size_t kChunkMeshJobsPerFrame = 8;
+// Worker time, per mesh worker, that background chunk remeshes may claim
+// each frame. Meshing no longer costs main-thread time, so this bounds worker
+// occupancy and per-frame upload size; urgent (edited) chunks ignore it.
+constexpr float kChunkMeshBudgetMsPerWorker = 4.0f;
+// The mesh scheduler's view wedge assumes a 16:9 window; a wider one only
+// demotes a few edge chunks to the offscreen penalty.
+constexpr float kChunkMeshAssumedAspect = 16.0f / 9.0f;
+// Chunk layers kept resident above and below the streaming focus, so peaks
+// that rise out of the surface layer are streamed with it.
+constexpr int kStreamingRadiusChunksY = 1;
 
 using odai::math::Aabb3f;
 
@@ -1051,12 +1057,17 @@ bool App::init() {
     // HUD elements.
     m_strategyMapMode = true;
     glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
+    odai::world::World::ChunkStreamingConfig streamingConfig = m_world.streamingConfig();
+    streamingConfig.radiusChunksY = kStreamingRadiusChunksY;
+    m_world.setStreamingConfig(streamingConfig);
     const auto rendererInitStart = Clock::now();
     if (!m_renderer.init(m_window, m_world.chunkGrid())) {
         VOX_LOGE("app") << "renderer init failed";
         return false;
     }
     VOX_LOGI("app") << "init step renderer init took " << elapsedMs(rendererInitStart) << " ms";
+    // Uploaded chunk meshes go back to the scheduler's pool when replaced.
+    m_renderer.setChunkMeshBufferPool(&m_chunkMeshScheduler.bufferPool());
     if (!m_renderer.uploadImportedScene(m_importedScene)) {
         VOX_LOGE("app") << "strategy map scene upload failed";
         return false;
@@ -1257,12 +1268,18 @@ void App::update(float dt, float simulationAlpha) {
         if (rendererMeshingOptions.mode != m_chunkMeshScheduler.meshingOptions().mode) {
             m_chunkMeshScheduler.setMeshingOptions(rendererMeshingOptions);
         }
-        const int cameraChunkX = static_cast<int>(
-            std::floor(m_camera.x / static_cast<float>(odai::world::Chunk::kSizeX)));
-        const int cameraChunkZ = static_cast<int>(
-            std::floor(m_camera.z / static_cast<float>(odai::world::Chunk::kSizeZ)));
-        m_chunkMeshScheduler.kickJobs(
-            m_world.chunkGrid(), cameraChunkX, cameraChunkZ, kChunkMeshJobsPerFrame);
+        const float yawRadians = odai::math::radians(m_camera.yawDegrees);
+        const float halfVerticalFov = odai::math::radians(m_camera.fovDegrees) * 0.5f;
+        odai::world::ChunkMeshKickParams kickParams;
+        kickParams.cameraX = m_camera.x;
+        kickParams.cameraZ = m_camera.z;
+        kickParams.forwardX = std::cos(yawRadians);
+        kickParams.forwardZ = std::sin(yawRadians);
+        kickParams.halfFovRadians = std::atan(std::tan(halfVerticalFov) * kChunkMeshAssumedAspect);
+        kickParams.budgetMs = kChunkMeshBudgetMsPerWorker *
+            static_cast<float>(std::max<std::size_t>(m_jobSystem.workerCount(), 1u));
+        kickParams.now = odai::world::ChunkMeshClock::now();
+        m_chunkMeshScheduler.kickJobs(m_world.chunkGrid(), kickParams);
         std::vector<odai::world::ChunkMeshResult> readyMeshes =
             m_chunkMeshScheduler.drainReady(m_world.chunkGrid());
         if (!readyMeshes.empty() &&
@@ -3005,6 +3022,19 @@ bool App::applyVoxelEdit(
         appendNeighborChunkForWorldVoxel(targetX, targetY, targetZ + 1);
     }
 
+    // Every touched chunk goes through the debounced edit path. The player is
+    // looking at the edited chunk itself, so it also takes the urgent lane and
+    // shows up this frame instead of behind background streaming work.
+    const odai::world::ChunkMeshClock::time_point editTime = odai::world::ChunkMeshClock::now();
+    for (const std::size_t chunkIndex : outDirtyChunkIndices) {
+        const odai::world::Chunk& chunk = m_world.chunkGrid().chunks()[chunkIndex];
+        const odai::world::ChunkMeshKey key{chunk.chunkX(), chunk.chunkY(), chunk.chunkZ()};
+        m_chunkMeshScheduler.markEdited(key, editTime);
+        if (chunkIndex == editedChunkIndex) {
+            m_chunkMeshScheduler.markUrgent(key);
+        }
+    }
+
     return true;
 }
 
@@ -3065,8 +3095,11 @@ void App::regenerateWorld() {
 }
 
 void App::refreshStreamingWindow(bool forceRendererUpload) {
+    // The strategy camera hovers far above the map, so the vertical window
+    // follows the y = 0 plane it looks at rather than the camera itself.
+    const float streamingFocusY = m_strategyMapMode ? 0.0f : m_camera.y;
     const odai::world::World::ChunkStreamingUpdate streamingUpdate =
-        m_world.updateStreamingWindowForWorldPosition(m_camera.x, m_camera.z);
+        m_world.updateStreamingWindowForWorldPosition(m_camera.x, streamingFocusY, m_camera.z);
     const odai::world::World::ChunkStreamingStats& streamingStats = streamingUpdate.stats;
     if (!streamingStats.changed && !forceRendererUpload) {
         return;
@@ -3084,8 +3117,10 @@ void App::refreshStreamingWindow(bool forceRendererUpload) {
     m_hasAppliedClipmapConfig = true;
     if (clipmapConfigChanged || !m_chunkClipmapIndex.valid()) {
         m_chunkClipmapIndex.rebuild(m_world.chunkGrid());
-    } else {
+    } else if (forceRendererUpload) {
         m_chunkClipmapIndex.syncResidentChunks(m_world.chunkGrid());
+    } else {
+        m_chunkClipmapIndex.syncResidentChunks(m_world.chunkGrid(), streamingUpdate);
     }
     m_visibleChunkIndices.clear();
     m_visibleChunkGraceFrames.assign(m_world.chunkGrid().chunkCount(), 0u);
@@ -3099,16 +3134,20 @@ void App::refreshStreamingWindow(bool forceRendererUpload) {
     } else {
         // Incremental refresh: dirty the scheduler instead of remeshing on the
         // main thread; workers mesh the chunks and update() uploads results.
+        // Resident neighbors that meshed without the new chunks are re-dirtied
+        // so their seam faces get culled.
         const std::vector<odai::world::Chunk>& chunks = m_world.chunkGrid().chunks();
+        std::vector<odai::world::ChunkMeshKey> arrivedChunkKeys;
+        arrivedChunkKeys.reserve(streamingUpdate.residentChunkIndicesNeedingUpload.size());
         for (const std::size_t chunkIndex : streamingUpdate.residentChunkIndicesNeedingUpload) {
             if (chunkIndex >= chunks.size()) {
                 uploadOk = false;
                 break;
             }
             const odai::world::Chunk& chunk = chunks[chunkIndex];
-            m_chunkMeshScheduler.markDirty(
-                odai::world::ChunkMeshKey{chunk.chunkX(), chunk.chunkY(), chunk.chunkZ()});
+            arrivedChunkKeys.push_back(odai::world::ChunkMeshKey{chunk.chunkX(), chunk.chunkY(), chunk.chunkZ()});
         }
+        m_chunkMeshScheduler.markChunksArrived(m_world.chunkGrid(), arrivedChunkKeys);
     }
     if (!uploadOk) {
         VOX_LOGE("app") << "streaming update failed to refresh resident chunk meshes";
@@ -3116,7 +3155,8 @@ void App::refreshStreamingWindow(bool forceRendererUpload) {
     }
 
     VOX_LOGI("app") << "chunk streaming update: center="
-                    << streamingStats.centerChunkX << "," << streamingStats.centerChunkZ
+                    << streamingStats.centerChunkX << "," << streamingStats.centerChunkY
+                    << "," << streamingStats.centerChunkZ
                     << ", resident=" << streamingStats.residentChunkCount
                     << "/" << streamingStats.storedChunkCount
                     << ", generated=" << streamingUpdate.generatedChunkKeys.size()
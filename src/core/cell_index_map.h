@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "core/grid3.h"
+#include "core/hash.h"
+
+// Core CellIndexMap subsystem
+// Responsible for: a flat cell -> index lookup for sparse grid objects that are
+// placed and removed one at a time (belts, pipes, rails).
+// Should NOT do: own the objects it indexes, or store more than one index per cell.
+namespace odai::core {
+
+// Open addressing with linear probing over packCell21 keys. Erase shifts the
+// following run back instead of leaving tombstones, so lookups stay short no
+// matter how many place/remove edits a layout has seen. Cells must fit the
+// 21-bit signed range packCell21 encodes.
+class CellIndexMap {
+public:
+    static constexpr std::int32_t kNotFound = -1;
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0u; }
+
+    void clear() {
+        m_slots.assign(m_slots.size(), Slot{});
+        m_size = 0;
+    }
+
+    void reserve(std::size_t count) {
+        std::size_t capacity = kMinCapacity;
+        while (capacity < count * 2u) {
+            capacity *= 2u;
+        }
+        if (capacity > m_slots.size()) {
+            rehash(capacity);
+        }
+    }
+
+    std::int32_t find(const Cell3i& cell) const {
+        if (m_size == 0u) {
+            return kNotFound;
+        }
+        const std::uint64_t key = packCell21(cell);
+        const std::size_t mask = m_slots.size() - 1u;
+        for (std::size_t slot = homeSlot(key); ; slot = (slot + 1u) & mask) {
+            const Slot& entry = m_slots[slot];
+            if (entry.key == key) {
+                return entry.value;
+            }
+            if (entry.key == kEmptyKey) {
+                return kNotFound;
+            }
+        }
+    }
+
+    // Inserts or overwrites the index stored for cell.
+    void insert(const Cell3i& cell, std::int32_t value) {
+        if ((m_size + 1u) * 2u > m_slots.size()) {
+            rehash(m_slots.empty() ? kMinCapacity : m_slots.size() * 2u);
+        }
+        const std::uint64_t key = packCell21(cell);
+        const std::size_t mask = m_slots.size() - 1u;
+        for (std::size_t slot = homeSlot(key); ; slot = (slot + 1u) & mask) {
+            Slot& entry = m_slots[slot];
+            if (entry.key == key) {
+                entry.value = value;
+                return;
+            }
+            if (entry.key == kEmptyKey) {
+                entry.key = key;
+                entry.value = value;
+                ++m_size;
+                return;
+            }
+        }
+    }
+
+    bool erase(const Cell3i& cell) {
+        if (m_size == 0u) {
+            return false;
+        }
+        const std::uint64_t key = packCell21(cell);
+        const std::size_t mask = m_slots.size() - 1u;
+        std::size_t hole = homeSlot(key);
+        while (m_slots[hole].key != key) {
+            if (m_slots[hole].key == kEmptyKey) {
+                return false;
+            }
+            hole = (hole + 1u) & mask;
+        }
+        // Backward-shift: pull each later entry of the run into the hole
+        // unless its home slot lies cyclically in (hole, slot].
+        for (std::size_t slot = (hole + 1u) & mask; m_slots[slot].key != kEmptyKey; slot = (slot + 1u) & mask) {
+            const std::size_t home = homeSlot(m_slots[slot].key);
+            const bool homeAfterHole = ((slot - home) & mask) < ((slot - hole) & mask);
+            if (!homeAfterHole) {
+                m_slots[hole] = m_slots[slot];
+                hole = slot;
+            }
+        }
+        m_slots[hole] = Slot{};
+        --m_size;
+        return true;
+    }
+
+private:
+    static constexpr std::uint64_t kEmptyKey = ~0ull;  // packCell21 never sets bit 63
+    static constexpr std::size_t kMinCapacity = 16u;
+
+    struct Slot {
+        std::uint64_t key = kEmptyKey;
+        std::int32_t value = kNotFound;
+    };
+
+    std::size_t homeSlot(std::uint64_t key) const {
+        return static_cast<std::size_t>(mix64(key)) & (m_slots.size() - 1u);
+    }
+
+    void rehash(std::size_t capacity) {
+        std::vector<Slot> previous = std::move(m_slots);
+        m_slots.assign(capacity, Slot{});
+        const std::size_t mask = capacity - 1u;
+        for (const Slot& entry : previous) {
+            if (entry.key == kEmptyKey) {
+                continue;
+            }
+            std::size_t slot = homeSlot(entry.key);
+            while (m_slots[slot].key != kEmptyKey) {
+                slot = (slot + 1u) & mask;
+            }
+            m_slots[slot] = entry;
+        }
+    }
+
+    std::vector<Slot> m_slots;
+    std::size_t m_size = 0;
+};
+
+}  // namespace odai::core
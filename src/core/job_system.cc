@@ -1,65 +1,226 @@
 #include "core/job_system.h"
 
+#include <chrono>
 #include <utility>
 
 namespace odai::core {
 
+namespace {
+
+// Which pool (if any) the current thread is a worker of, and its queue. Lets
+// jobs spawned from a job stay on the spawning worker's deque.
+thread_local const JobSystem* t_workerOwner = nullptr;
+thread_local std::size_t t_workerIndex = 0;
+
+// How long wait() sleeps between looking for jobs to help with. Short enough
+// that a continuation queued while waiting is picked up promptly, long enough
+// that an idle waiter does not spin a core.
+constexpr std::chrono::microseconds kWaitPollInterval{200};
+
+} // namespace
+
 JobSystem::JobSystem(unsigned threadCount) {
+    m_queues.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
     m_workers.reserve(threadCount);
     for (unsigned i = 0; i < threadCount; ++i) {
-        m_workers.emplace_back([this]() { workerLoop(); });
+        m_workers.emplace_back([this, i]() { workerLoop(i); });
     }
 }
 
 JobSystem::~JobSystem() {
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_stopRequested = true;
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopRequested.store(true);
     }
     m_wakeCv.notify_all();
     for (std::thread& worker : m_workers) {
         worker.join();
     }
+    // A continuation released by a non-worker thread (e.g. one helping in
+    // wait()) can land on a deque whose worker already exited; run it here
+    // rather than drop it.
+    while (!m_queues.empty() && tryRunOne(0, false)) {
+    }
+}
+
+void JobSystem::enqueue(Job job, JobPriority priority, JobCounter* signal) {
+    account(job, signal);
+    dispatch(std::move(job), priority, signal);
+}
+
+void JobSystem::enqueueAfter(JobCounter& dependency, Job job, JobPriority priority, JobCounter* signal) {
+    account(job, signal);
+    {
+        std::lock_guard<std::mutex> lock(dependency.m_mutex);
+        if (dependency.m_pending.load(std::memory_order_acquire) != 0u) {
+            dependency.m_continuations.push_back(JobCounter::Continuation{std::move(job), priority, signal});
+            return;
+        }
+    }
+    dispatch(std::move(job), priority, signal);
 }
 
-void JobSystem::enqueue(std::function<void()> job) {
+void JobSystem::wait(JobCounter& counter) {
+    const std::size_t homeQueue = (t_workerOwner == this) ? t_workerIndex : 0u;
+    while (!counter.done()) {
+        if (!m_queues.empty() && tryRunOne(homeQueue, true)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(counter.m_mutex);
+        counter.m_doneCv.wait_for(lock, kWaitPollInterval, [&counter]() { return counter.done(); });
+    }
+    // The last decrement happens under the counter's mutex; taking it once
+    // more guarantees the signalling thread has let go before the caller is
+    // free to destroy the counter.
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void JobSystem::waitIdle() {
     if (m_workers.empty()) {
-        job();
         return;
     }
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_queue.push_back(std::move(job));
+    std::unique_lock<std::mutex> lock(m_idleMutex);
+    m_idleCv.wait(lock, [this]() { return m_outstandingJobCount.load() == 0u; });
+}
+
+JobSystemStats JobSystem::stats() const {
+    JobSystemStats snapshot{};
+    snapshot.jobsExecuted = m_jobsExecuted.load(std::memory_order_relaxed);
+    snapshot.jobsStolen = m_jobsStolen.load(std::memory_order_relaxed);
+    snapshot.heapAllocatedJobs = m_heapAllocatedJobs.load(std::memory_order_relaxed);
+    snapshot.jobsRunByWaiters = m_jobsRunByWaiters.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void JobSystem::account(const Job& job, JobCounter* signal) {
+    if (signal != nullptr) {
+        std::lock_guard<std::mutex> lock(signal->m_mutex);
+        signal->m_pending.fetch_add(1u, std::memory_order_acq_rel);
+    }
+    m_outstandingJobCount.fetch_add(1u);
+    if (job.isHeapAllocated()) {
+        m_heapAllocatedJobs.fetch_add(1u, std::memory_order_relaxed);
     }
-    m_wakeCv.notify_one();
 }
 
-void JobSystem::waitIdle() {
+void JobSystem::dispatch(Job job, JobPriority priority, JobCounter* signal) {
     if (m_workers.empty()) {
+        job();
+        m_jobsExecuted.fetch_add(1u, std::memory_order_relaxed);
+        finishJob(signal);
         return;
     }
-    std::unique_lock<std::mutex> lock(m_mutex);
-    m_idleCv.wait(lock, [this]() { return m_queue.empty() && m_activeJobCount == 0; });
+
+    const std::size_t queueIndex = currentQueueHint();
+    // Count before publishing: a worker that pops the job immediately must not
+    // drive the count below zero.
+    m_queuedJobCount.fetch_add(1u);
+    {
+        WorkerQueue& queue = *m_queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.lanes[static_cast<std::size_t>(priority)].push_back(QueuedJob{std::move(job), signal});
+    }
+    // Pairs with the sleeping-count increment in workerLoop(): either this
+    // load sees the sleeper, or the sleeper's predicate sees the queued job.
+    if (m_sleepingWorkerCount.load() > 0u) {
+        { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+        m_wakeCv.notify_one();
+    }
 }
 
-void JobSystem::workerLoop() {
-    std::unique_lock<std::mutex> lock(m_mutex);
-    for (;;) {
-        m_wakeCv.wait(lock, [this]() { return m_stopRequested || !m_queue.empty(); });
-        if (m_stopRequested && m_queue.empty()) {
+bool JobSystem::tryRunOne(std::size_t homeQueue, bool fromWaiter) {
+    QueuedJob queued;
+    if (!tryPop(homeQueue, queued)) {
+        return false;
+    }
+    queued.job();
+    m_jobsExecuted.fetch_add(1u, std::memory_order_relaxed);
+    if (fromWaiter) {
+        m_jobsRunByWaiters.fetch_add(1u, std::memory_order_relaxed);
+    }
+    finishJob(queued.signal);
+    return true;
+}
+
+bool JobSystem::tryPop(std::size_t homeQueue, QueuedJob& outJob) {
+    if (m_queuedJobCount.load() == 0u) {
+        return false;
+    }
+    const std::size_t queueCount = m_queues.size();
+    for (std::size_t lane = 0; lane < kJobPriorityCount; ++lane) {
+        for (std::size_t offset = 0; offset < queueCount; ++offset) {
+            WorkerQueue& queue = *m_queues[(homeQueue + offset) % queueCount];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            std::deque<QueuedJob>& jobs = queue.lanes[lane];
+            if (jobs.empty()) {
+                continue;
+            }
+            // Owner and thieves both take the oldest job: submitters (e.g. the
+            // mesh scheduler's nearest-first kick) rely on FIFO within a lane.
+            outJob = std::move(jobs.front());
+            jobs.pop_front();
+            m_queuedJobCount.fetch_sub(1u);
+            if (offset != 0u) {
+                m_jobsStolen.fetch_add(1u, std::memory_order_relaxed);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::finishJob(JobCounter* signal) {
+    if (signal != nullptr) {
+        signalCounter(*signal);
+    }
+    if (m_outstandingJobCount.fetch_sub(1u) == 1u) {
+        { std::lock_guard<std::mutex> lock(m_idleMutex); }
+        m_idleCv.notify_all();
+    }
+}
+
+void JobSystem::signalCounter(JobCounter& counter) {
+    std::vector<JobCounter::Continuation> released;
+    {
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+        if (counter.m_pending.fetch_sub(1u, std::memory_order_acq_rel) != 1u) {
             return;
         }
-        std::function<void()> job = std::move(m_queue.front());
-        m_queue.pop_front();
-        ++m_activeJobCount;
-        lock.unlock();
-        job();
-        lock.lock();
-        --m_activeJobCount;
-        if (m_queue.empty() && m_activeJobCount == 0) {
-            m_idleCv.notify_all();
+        released.swap(counter.m_continuations);
+        // Notified under the lock: once it is released, a waiter may return
+        // and destroy the counter.
+        counter.m_doneCv.notify_all();
+    }
+    for (JobCounter::Continuation& continuation : released) {
+        dispatch(std::move(continuation.job), continuation.priority, continuation.signal);
+    }
+}
+
+void JobSystem::workerLoop(std::size_t workerIndex) {
+    t_workerOwner = this;
+    t_workerIndex = workerIndex;
+    for (;;) {
+        if (tryRunOne(workerIndex, false)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingWorkerCount.fetch_add(1u);
+        m_wakeCv.wait(lock, [this]() { return m_stopRequested.load() || m_queuedJobCount.load() != 0u; });
+        m_sleepingWorkerCount.fetch_sub(1u);
+        if (m_stopRequested.load() && m_queuedJobCount.load() == 0u) {
+            return;
         }
     }
 }
 
+std::size_t JobSystem::currentQueueHint() {
+    if (t_workerOwner == this) {
+        return t_workerIndex;
+    }
+    return m_nextQueue.fetch_add(1u, std::memory_order_relaxed) % m_queues.size();
+}
+
 } // namespace odai::core
@@ -1,24 +1,193 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
-#include <functional>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-// Minimal fixed-size worker pool: enqueue fire-and-forget jobs, wait for the
-// queue to drain. Deliberately has no job dependencies, priorities, or work
-// stealing — higher-level systems (e.g. world::ChunkMeshScheduler) own all
-// scheduling policy and use this purely as an executor, keeping lifecycle
-// state explicit instead of encoding it in a job graph.
+// Fixed-size work-stealing worker pool with priority lanes and counter-based
+// dependencies. Still an executor, not a scheduler: higher-level systems (e.g.
+// world::ChunkMeshScheduler) own lifecycle state and scheduling policy, and
+// pick a lane and a JobCounter per job; the pool only decides which worker
+// runs it.
+//
+// Each worker owns one deque per JobPriority lane behind its own small mutex,
+// so workers only touch each other's queues when they run dry and steal. Jobs
+// submitted from outside the pool are spread round-robin over the workers;
+// jobs submitted from inside a job land on the submitting worker's own deque.
+// Lanes are strict: a worker drains High (its own, then stolen) before it
+// looks at Normal, and Normal before Low.
 //
 // threadCount == 0 selects synchronous mode: enqueue() runs the job inline on
-// the calling thread. Tests use this for deterministic, single-threaded runs
-// of the exact same scheduling code.
+// the calling thread, and a continuation runs inline the moment its counter
+// reaches zero. Tests use this for deterministic, single-threaded runs of the
+// exact same scheduling code.
 namespace odai::core {
 
+enum class JobPriority : std::uint8_t {
+    // Latency-critical work the player is waiting on (the chunk being edited).
+    High = 0,
+    Normal = 1,
+    // Background prefetch; runs only when nothing more urgent is queued.
+    Low = 2
+};
+
+inline constexpr std::size_t kJobPriorityCount = 3;
+
+// Move-only type-erased callable with inline storage. Lambdas whose captures
+// fit kInlineBytes (pointers, indices, a key and a generation) are stored in
+// place; larger or throwing-move callables fall back to one heap allocation,
+// which is what std::function did for every job.
+class Job {
+public:
+    static constexpr std::size_t kInlineBytes = 48;
+
+    Job() = default;
+
+    template <typename Fn,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, Job> &&
+                                          std::is_invocable_r_v<void, std::decay_t<Fn>&>>>
+    Job(Fn&& fn) { // NOLINT(google-explicit-constructor): lambdas convert implicitly like std::function
+        using Stored = std::decay_t<Fn>;
+        if constexpr (fitsInline<Stored>()) {
+            ::new (static_cast<void*>(m_storage.data())) Stored(std::forward<Fn>(fn));
+            m_ops = &kInlineOps<Stored>;
+        } else {
+            ::new (static_cast<void*>(m_storage.data())) Stored*(new Stored(std::forward<Fn>(fn)));
+            m_ops = &kHeapOps<Stored>;
+        }
+    }
+
+    Job(Job&& other) noexcept { moveFrom(other); }
+
+    Job& operator=(Job&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+
+    ~Job() { reset(); }
+
+    void operator()() { m_ops->invoke(m_storage.data()); }
+
+    [[nodiscard]] explicit operator bool() const { return m_ops != nullptr; }
+    [[nodiscard]] bool isHeapAllocated() const { return m_ops != nullptr && m_ops->heap; }
+
+    template <typename Fn>
+    [[nodiscard]] static constexpr bool fitsInline() {
+        return sizeof(Fn) <= kInlineBytes && alignof(Fn) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        // Move-constructs into `to` and destroys `from`.
+        void (*relocate)(void* from, void* to) noexcept;
+        void (*destroy)(void* storage) noexcept;
+        bool heap;
+    };
+
+    template <typename Fn>
+    static constexpr Ops kInlineOps{
+        [](void* storage) { (*static_cast<Fn*>(storage))(); },
+        [](void* from, void* to) noexcept {
+            ::new (to) Fn(std::move(*static_cast<Fn*>(from)));
+            static_cast<Fn*>(from)->~Fn();
+        },
+        [](void* storage) noexcept { static_cast<Fn*>(storage)->~Fn(); },
+        false
+    };
+
+    template <typename Fn>
+    static constexpr Ops kHeapOps{
+        [](void* storage) { (**static_cast<Fn**>(storage))(); },
+        [](void* from, void* to) noexcept { ::new (to) Fn*(*static_cast<Fn**>(from)); },
+        [](void* storage) noexcept { delete *static_cast<Fn**>(storage); },
+        true
+    };
+
+    void moveFrom(Job& other) noexcept {
+        if (other.m_ops != nullptr) {
+            other.m_ops->relocate(other.m_storage.data(), m_storage.data());
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if (m_ops != nullptr) {
+            m_ops->destroy(m_storage.data());
+            m_ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) std::array<unsigned char, kInlineBytes> m_storage{};
+    const Ops* m_ops = nullptr;
+};
+
+class JobSystem;
+
+// Completion counter shared by a group of jobs. Every job enqueued with this
+// counter as its signal increments it on submission and decrements it when it
+// finishes; jobs enqueued *after* it are held back until it reaches zero.
+//
+// Caller-owned and deliberately not reference counted (no per-job allocation):
+// the counter must outlive every job that signals it and every continuation
+// waiting on it. The usual shape is a counter on the stack followed by
+// JobSystem::wait() on it.
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+    ~JobCounter() = default;
+
+    [[nodiscard]] bool done() const { return m_pending.load(std::memory_order_acquire) == 0u; }
+    [[nodiscard]] std::uint32_t pending() const { return m_pending.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+
+    struct Continuation {
+        Job job;
+        JobPriority priority = JobPriority::Normal;
+        JobCounter* signal = nullptr;
+    };
+
+    std::atomic<std::uint32_t> m_pending{0};
+    // Guards increments/decrements against continuation registration so a
+    // continuation can never be parked on a counter that just hit zero.
+    std::mutex m_mutex;
+    std::condition_variable m_doneCv;
+    std::vector<Continuation> m_continuations;
+};
+
+// Cumulative since construction. Relaxed counters: telemetry, not control flow.
+struct JobSystemStats {
+    std::uint64_t jobsExecuted = 0;
+    // Jobs a worker took from another worker's deque.
+    std::uint64_t jobsStolen = 0;
+    // Jobs whose callable did not fit Job::kInlineBytes.
+    std::uint64_t heapAllocatedJobs = 0;
+    // Jobs run by a thread blocked in wait() instead of by a pool worker.
+    std::uint64_t jobsRunByWaiters = 0;
+};
+
 class JobSystem {
 public:
     explicit JobSystem(unsigned threadCount);
@@ -27,21 +196,69 @@ public:
     JobSystem(const JobSystem&) = delete;
     JobSystem& operator=(const JobSystem&) = delete;
 
-    void enqueue(std::function<void()> job);
-    // Blocks until the queue is empty and no worker is executing a job.
+    // `signal`, when non-null, is incremented now and decremented once the job
+    // has run.
+    void enqueue(Job job, JobPriority priority = JobPriority::Normal, JobCounter* signal = nullptr);
+    // Runs `job` once `dependency` reaches zero (immediately if it already
+    // has). `signal` is incremented now, so a chain of counters is pending
+    // end-to-end before its first job starts.
+    void enqueueAfter(
+        JobCounter& dependency,
+        Job job,
+        JobPriority priority = JobPriority::Normal,
+        JobCounter* signal = nullptr
+    );
+    // Blocks until `counter` reaches zero. The calling thread runs queued jobs
+    // while it waits, so waiting from inside a job cannot starve the pool.
+    void wait(JobCounter& counter);
+    // Blocks until every submitted job, including held-back continuations, has
+    // run. Must not be called from inside a job.
     void waitIdle();
     [[nodiscard]] std::size_t workerCount() const { return m_workers.size(); }
+    [[nodiscard]] JobSystemStats stats() const;
 
 private:
-    void workerLoop();
+    struct QueuedJob {
+        Job job;
+        JobCounter* signal = nullptr;
+    };
 
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::array<std::deque<QueuedJob>, kJobPriorityCount> lanes;
+    };
+
+    // Counts the job as outstanding and registers it with its signal counter.
+    void account(const Job& job, JobCounter* signal);
+    // Runs inline (synchronous mode) or queues an already-accounted job.
+    void dispatch(Job job, JobPriority priority, JobCounter* signal);
+    bool tryRunOne(std::size_t homeQueue, bool fromWaiter);
+    bool tryPop(std::size_t homeQueue, QueuedJob& outJob);
+    void finishJob(JobCounter* signal);
+    void signalCounter(JobCounter& counter);
+    void workerLoop(std::size_t workerIndex);
+    [[nodiscard]] std::size_t currentQueueHint();
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
     std::vector<std::thread> m_workers;
-    std::deque<std::function<void()>> m_queue;
-    mutable std::mutex m_mutex;
+    std::atomic<std::size_t> m_nextQueue{0};
+
+    // Jobs sitting in some deque. Workers sleep only while this is zero.
+    std::atomic<std::size_t> m_queuedJobCount{0};
+    std::atomic<std::uint32_t> m_sleepingWorkerCount{0};
+    std::mutex m_sleepMutex;
     std::condition_variable m_wakeCv;
+
+    // Submitted (queued, running, or parked as a continuation) but not finished.
+    std::atomic<std::size_t> m_outstandingJobCount{0};
+    std::mutex m_idleMutex;
     std::condition_variable m_idleCv;
-    std::size_t m_activeJobCount = 0;
-    bool m_stopRequested = false;
+    std::atomic<bool> m_stopRequested{false};
+
+    std::atomic<std::uint64_t> m_jobsExecuted{0};
+    std::atomic<std::uint64_t> m_jobsStolen{0};
+    std::atomic<std::uint64_t> m_heapAllocatedJobs{0};
+    std::atomic<std::uint64_t> m_jobsRunByWaiters{0};
 };
 
 } // namespace odai::core
@@ -0,0 +1,57 @@
+#pragma once
+
+// Read-only memory-mapped file.
+//
+// The OS pages bytes in on first touch, so opening a large file is O(1) and a
+// reader that only looks at a directory plus a handful of records never reads
+// the rest. Views are const: nothing here writes through the mapping.
+//
+// On Windows a mapped file cannot be replaced or deleted, so writers that
+// replace a file they are also reading close() it first and reopen afterwards.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace odai::core {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Maps the whole file. Fails (and stays closed) for missing or empty files.
+    bool open(const std::filesystem::path& path);
+    void close();
+
+    [[nodiscard]] bool isOpen() const { return m_data != nullptr; }
+    [[nodiscard]] std::span<const std::uint8_t> bytes() const { return {m_data, m_size}; }
+
+private:
+    void moveFrom(MappedFile& other) noexcept;
+
+    const std::uint8_t* m_data = nullptr;
+    std::size_t m_size = 0;
+    // Windows file and file-mapping HANDLEs; unused on POSIX, where the view
+    // alone keeps the mapping alive.
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+};
+
+// Forces an already-written file's data to stable storage (fsync /
+// FlushFileBuffers). Writers that publish a file by renaming a temp file over
+// the old one call this before the rename, so a crash can leave the old file or
+// the new one but never a renamed, half-written one.
+bool flushFileToStorage(const std::filesystem::path& path);
+
+// Best effort: persists a rename inside `directory` on POSIX. No-op on
+// Windows, where MoveFileEx already updates the directory entry durably.
+void flushDirectoryToStorage(const std::filesystem::path& directory);
+
+} // namespace odai::core
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "core/job_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Core ParallelFor subsystem
+// Responsible for: data-parallel loops and fork/join groups on top of
+// core::JobSystem, with the calling thread doing its share of the work.
+// Should NOT do: own threads, pick grain sizes for callers, or reorder results.
+//
+// Determinism contract: an index range is always cut into the same
+// ceil(count / grain) sub-ranges, whatever the worker count, and every
+// reduction folds the per-range partials left to right in range order. So a
+// given (range, grain) produces bit-identical results on 0, 1 or 16 workers,
+// and threadCount == 0 runs the exact same partition serially. Callers whose
+// output is pinned by golden vectors write per-index results into
+// preallocated slots (or concatenate per-range outputs in range order) rather
+// than reducing floats across ranges with a different grain than before.
+//
+// Loop bodies must not throw: they run on pool workers, where an escaping
+// exception terminates, exactly as with JobSystem::enqueue.
+namespace odai::core {
+
+// Fork/join over a JobCounter. The destructor waits, so a group on the stack
+// can never outlive the jobs that reference it.
+class TaskGroup {
+public:
+    explicit TaskGroup(JobSystem& jobs, JobPriority priority = JobPriority::Normal)
+        : m_jobs(jobs),
+          m_priority(priority) {}
+    ~TaskGroup() { wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(Job job) { m_jobs.enqueue(std::move(job), m_priority, &m_counter); }
+    // Helps run queued jobs until every job in the group has finished.
+    void wait() { m_jobs.wait(m_counter); }
+
+    [[nodiscard]] JobSystem& jobs() const { return m_jobs; }
+
+private:
+    JobSystem& m_jobs;
+    JobPriority m_priority;
+    JobCounter m_counter;
+};
+
+[[nodiscard]] inline std::size_t parallelRangeCount(std::size_t begin, std::size_t end, std::size_t grain) {
+    if (end <= begin) {
+        return 0;
+    }
+    const std::size_t safeGrain = std::max<std::size_t>(grain, 1u);
+    return ((end - begin) + safeGrain - 1u) / safeGrain;
+}
+
+// Calls fn(rangeIndex, rangeBegin, rangeEnd) once per grain-sized sub-range of
+// [begin, end). Ranges are claimed dynamically by the caller and by up to
+// workerCount() helper jobs, so uneven per-range cost still balances.
+template <typename Fn>
+void parallelForRanges(
+    JobSystem& jobs,
+    std::size_t begin,
+    std::size_t end,
+    std::size_t grain,
+    Fn&& fn,
+    JobPriority priority = JobPriority::Normal
+) {
+    const std::size_t rangeCount = parallelRangeCount(begin, end, grain);
+    const std::size_t safeGrain = std::max<std::size_t>(grain, 1u);
+    const auto runRange = [&](std::size_t rangeIndex) {
+        const std::size_t rangeBegin = begin + (rangeIndex * safeGrain);
+        const std::size_t rangeEnd = std::min(end, rangeBegin + safeGrain);
+        fn(rangeIndex, rangeBegin, rangeEnd);
+    };
+
+    if (rangeCount <= 1u || jobs.workerCount() == 0u) {
+        for (std::size_t rangeIndex = 0; rangeIndex < rangeCount; ++rangeIndex) {
+            runRange(rangeIndex);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> nextRange{0};
+    const auto drain = [&]() {
+        for (;;) {
+            const std::size_t rangeIndex = nextRange.fetch_add(1u, std::memory_order_relaxed);
+            if (rangeIndex >= rangeCount) {
+                return;
+            }
+            runRange(rangeIndex);
+        }
+    };
+
+    TaskGroup group(jobs, priority);
+    const std::size_t helperCount = std::min(jobs.workerCount(), rangeCount - 1u);
+    for (std::size_t helper = 0; helper < helperCount; ++helper) {
+        // One pointer of capture: stays in Job's inline storage.
+        group.run([&drain]() { drain(); });
+    }
+    drain();
+    group.wait();
+}
+
+// Per-index convenience over parallelForRanges: fn(index).
+template <typename Fn>
+void parallelFor(
+    JobSystem& jobs,
+    std::size_t begin,
+    std::size_t end,
+    std::size_t grain,
+    Fn&& fn,
+    JobPriority priority = JobPriority::Normal
+) {
+    parallelForRanges(
+        jobs,
+        begin,
+        end,
+        grain,
+        [&fn](std::size_t, std::size_t rangeBegin, std::size_t rangeEnd) {
+            for (std::size_t index = rangeBegin; index < rangeEnd; ++index) {
+                fn(index);
+            }
+        },
+        priority
+    );
+}
+
+// Deterministic reduction: mapRange(rangeBegin, rangeEnd) -> T per sub-range,
+// then combine(accumulator, partial) left to right in range order starting
+// from `identity`. Identical output for any worker count (see header note).
+template <typename T, typename MapFn, typename CombineFn>
+[[nodiscard]] T parallelReduce(
+    JobSystem& jobs,
+    std::size_t begin,
+    std::size_t end,
+    std::size_t grain,
+    T identity,
+    MapFn&& mapRange,
+    CombineFn&& combine,
+    JobPriority priority = JobPriority::Normal
+) {
+    std::vector<T> partials(parallelRangeCount(begin, end, grain), identity);
+    parallelForRanges(
+        jobs,
+        begin,
+        end,
+        grain,
+        [&](std::size_t rangeIndex, std::size_t rangeBegin, std::size_t rangeEnd) {
+            partials[rangeIndex] = mapRange(rangeBegin, rangeEnd);
+        },
+        priority
+    );
+    T result = std::move(identity);
+    for (T& partial : partials) {
+        result = combine(std::move(result), std::move(partial));
+    }
+    return result;
+}
+
+} // namespace odai::core
@@ -24,6 +24,9 @@ constexpr float kFrustumCullPadVoxels = 8.0f;
 constexpr float kFrustumNearDistance = 0.1f;
 constexpr float kFrustumFarDistance = 400.0f;
 constexpr float kFootstepStrideVoxels = 1.6f;
+// Chunk layers kept resident above and below the player's, so peaks above
+// the surface layer and the ground under the player stream in with it.
+constexpr int kStreamingRadiusChunksY = 1;
 
 float wrapDegreesSigned(float degrees) {
     float wrapped = std::fmod(degrees, 360.0f);
@@ -151,7 +154,10 @@ bool VoxelCraftApp::onInit() {
     m_gameplayUiState.hotbarItems[4] = odai::render::InventoryItemId::Red;
 
     world::World::LoadResult loadResult{};
-    m_world.loadOrInitialize(m_worldPath, &loadResult);
+    m_world.loadOrInitialize(m_worldPath, &loadResult, &m_jobSystem);
+    world::World::ChunkStreamingConfig streamingConfig = m_world.streamingConfig();
+    streamingConfig.radiusChunksY = kStreamingRadiusChunksY;
+    m_world.setStreamingConfig(streamingConfig);
     VOX_LOGI("voxelcraft") << (loadResult.loadedFromFile ? "loaded world " : "generating fresh world ")
                            << m_worldPath.string();
 
@@ -190,7 +196,7 @@ bool VoxelCraftApp::onInit() {
 
 void VoxelCraftApp::onShutdown() {
     m_streamingPipeline.stop();
-    saveWorld();
+    saveWorld(true);
 }
 
 void VoxelCraftApp::sampleInput() {
@@ -247,7 +253,7 @@ void VoxelCraftApp::sampleInput() {
 
     const bool saveKeyDown = glfwGetKey(m_window, GLFW_KEY_F5) == GLFW_PRESS;
     if (saveKeyDown && !m_wasSaveKeyDown) {
-        saveWorld();
+        saveWorld(false);
     }
     m_wasSaveKeyDown = saveKeyDown;
 
@@ -349,12 +355,17 @@ void VoxelCraftApp::updateBlockInteraction() {
 }
 
 void VoxelCraftApp::tickAutosave(float dt) {
+    m_saveProgress = m_world.pollSave();
+    if (m_saveProgress.state == world::World::SaveState::Failed) {
+        VOX_LOGE("voxelcraft") << "failed to save world to " << m_worldPath.string();
+        m_worldDirty = true;
+    }
     if (!m_worldDirty) {
         return;
     }
     m_worldAutosaveElapsedSeconds += dt;
     if (m_worldAutosaveElapsedSeconds >= kWorldAutosaveDelaySeconds) {
-        saveWorld();
+        saveWorld(false);
     }
 }
 
@@ -370,18 +381,28 @@ void VoxelCraftApp::tickFootstepAudio(float dxHorizontal, float dzHorizontal) {
     m_audio.playSoundAt(m_sfxFootstep, odai::math::Vector3{m_player.x, m_player.y, m_player.z});
 }
 
-void VoxelCraftApp::saveWorld() {
-    if (m_world.save(m_worldPath)) {
-        m_worldDirty = false;
-        m_worldAutosaveElapsedSeconds = 0.0f;
-    } else {
-        VOX_LOGE("voxelcraft") << "failed to save world to " << m_worldPath.string();
+void VoxelCraftApp::saveWorld(bool blocking) {
+    if (blocking) {
+        if (m_world.save(m_worldPath)) {
+            m_worldDirty = false;
+            m_worldAutosaveElapsedSeconds = 0.0f;
+        } else {
+            VOX_LOGE("voxelcraft") << "failed to save world to " << m_worldPath.string();
+        }
+        return;
     }
+    // Edits made while the snapshot is written set m_worldDirty again and are
+    // picked up by the next autosave; a failure is reported by pollSave().
+    if (m_world.isSaveInFlight() || !m_world.beginSave(m_worldPath, m_jobSystem)) {
+        return;
+    }
+    m_worldDirty = false;
+    m_worldAutosaveElapsedSeconds = 0.0f;
 }
 
 void VoxelCraftApp::refreshStreamingWindow(bool forceRendererUpload) {
     const world::World::ChunkStreamingUpdate update =
-        m_world.updateStreamingWindowForWorldPosition(m_player.x, m_player.z);
+        m_world.updateStreamingWindowForWorldPosition(m_player.x, m_player.y, m_player.z);
     if (!update.stats.changed && !forceRendererUpload) {
         return;
     }
@@ -398,8 +419,10 @@ void VoxelCraftApp::refreshStreamingWindow(bool forceRendererUpload) {
     m_hasAppliedClipmapConfig = true;
     if (clipmapConfigChanged || !m_clipmapIndex.valid()) {
         m_clipmapIndex.rebuild(m_world.chunkGrid());
-    } else {
+    } else if (forceRendererUpload) {
         m_clipmapIndex.syncResidentChunks(m_world.chunkGrid());
+    } else {
+        m_clipmapIndex.syncResidentChunks(m_world.chunkGrid(), update);
     }
 
     const bool uploadOk = update.requiresFullMeshUpload || forceRendererUpload
@@ -416,14 +439,21 @@ void VoxelCraftApp::refreshStreamingWindow(bool forceRendererUpload) {
 
 void VoxelCraftApp::updateChunkStreaming() {
     for (ChunkStreamingPipeline::CompletedChunk& completed : m_streamingPipeline.drainCompleted()) {
-        m_world.insertGeneratedChunk(completed.key, std::move(completed.chunk));
+        // The pipeline's chunks are plain buildProceduralChunk output.
+        m_world.insertGeneratedChunk(completed.key, std::move(completed.chunk), true);
     }
 
     const world::World::ChunkStreamingConfig config = m_world.streamingConfig();
-    std::vector<world::World::ChunkKey> desiredKeys = computeDesiredChunkKeys(config, m_player.x, m_player.z);
+    std::vector<world::World::ChunkKey> desiredKeys = computeDesiredChunkKeys(config, m_player.x, m_player.y, m_player.z);
 
     for (const world::World::ChunkKey& key : desiredKeys) {
-        m_streamingPipeline.requestChunk(key);
+        // Drained chunks, and chunks the world paged in or built itself, are
+        // not generated again.
+        if (m_world.hasChunk(key)) {
+            m_streamingPipeline.cancelChunk(key);
+        } else {
+            m_streamingPipeline.requestChunk(key);
+        }
     }
     for (const world::World::ChunkKey& previousKey : m_lastDesiredChunkKeys) {
         const bool stillDesired =
@@ -433,6 +463,9 @@ void VoxelCraftApp::updateChunkStreaming() {
         }
     }
     m_lastDesiredChunkKeys = std::move(desiredKeys);
+    const world::World::ChunkStreamingStats& streamingStats = m_world.streamingStats();
+    (void)m_streamingPipeline.kickJobs(
+        streamingStats.centerChunkX, streamingStats.centerChunkY, streamingStats.centerChunkZ);
 
     refreshStreamingWindow(false);
 }
@@ -494,6 +527,23 @@ void VoxelCraftApp::drawHud() {
         odai::ui::UiRect{cx - (kCrosshairThickness * 0.5f), cy - kCrosshairHalfLength,
                          cx + (kCrosshairThickness * 0.5f), cy + kCrosshairHalfLength},
         crosshairColor);
+
+    if (m_saveProgress.state == world::World::SaveState::Writing && m_saveProgress.chunkCount > 0) {
+        // Background save indicator: a thin bar filling left to right.
+        constexpr float kSaveBarWidth = 96.0f;
+        constexpr float kSaveBarHeight = 4.0f;
+        constexpr float kSaveBarMargin = 12.0f;
+        const float fraction = std::min(
+            1.0f, static_cast<float>(m_saveProgress.chunksWritten) / static_cast<float>(m_saveProgress.chunkCount));
+        const float left = static_cast<float>(fbW) - kSaveBarMargin - kSaveBarWidth;
+        const float top = kSaveBarMargin;
+        m_uiDrawList.addRectFilled(
+            odai::ui::UiRect{left, top, left + kSaveBarWidth, top + kSaveBarHeight},
+            odai::ui::UiColor{0.0f, 0.0f, 0.0f, 0.45f});
+        m_uiDrawList.addRectFilled(
+            odai::ui::UiRect{left, top, left + (kSaveBarWidth * fraction), top + kSaveBarHeight},
+            odai::ui::UiColor{1.0f, 1.0f, 1.0f, 0.82f});
+    }
 }
 
 void VoxelCraftApp::onRender(float dt) {
@@ -518,7 +568,7 @@ void VoxelCraftApp::onRender(float dt) {
     const odai::core::CellAabb frustumBounds = computeFrustumBroadPhaseBounds(
         odai::math::Vector3{camera.x, camera.y, camera.z},
         camera.yawDegrees, camera.pitchDegrees, camera.fovDegrees, aspect);
-    m_visibleChunkIndices = m_clipmapIndex.queryChunksIntersecting(frustumBounds);
+    m_clipmapIndex.queryChunksIntersecting(frustumBounds, m_visibleChunkIndices);
 
     WorldFrameContent worldContent{};
     worldContent.chunkGrid = &m_world.chunkGrid();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "audio/audio_types.h"
+#include "core/job_system.h"
 #include "engine/game_app.h"
 #include "games/voxelcraft/voxelcraft_player.h"
 #include "games/voxelcraft/voxelcraft_streaming.h"
@@ -10,6 +11,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <thread>
 #include <vector>
 
 // VoxelCraft: a single-player first-person voxel sandbox (walk, break/place blocks,
@@ -34,7 +36,8 @@ private:
     void updateBlockInteraction();
     void tickAutosave(float dt);
     void tickFootstepAudio(float dxHorizontal, float dzHorizontal);
-    void saveWorld();
+    // Blocking saves are for shutdown; everything else writes on m_jobSystem.
+    void saveWorld(bool blocking);
     void drawHud();
 
     [[nodiscard]] render::CameraPose interpolatedCameraPose(float alpha) const;
@@ -44,11 +47,16 @@ private:
     PlayerInputSnapshot m_pendingInput{};
     VoxelBreakProgress m_breakProgress{};
 
+    // Shared worker pool for CPU-parallel world work (saved-world decode,
+    // background saves, chunk streaming).
+    // Declared before the world so it outlives anything that enqueues on it.
+    core::JobSystem m_jobSystem{
+        std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1u};
     world::World m_world;
     world::ChunkClipmapIndex m_clipmapIndex;
     world::ClipmapConfig m_appliedClipmapConfig{};
     bool m_hasAppliedClipmapConfig = false;
-    ChunkStreamingPipeline m_streamingPipeline;
+    ChunkStreamingPipeline m_streamingPipeline{m_jobSystem};
     std::vector<world::World::ChunkKey> m_lastDesiredChunkKeys;
 
     render::GameplayUiState m_gameplayUiState{};
@@ -59,6 +67,7 @@ private:
     std::filesystem::path m_worldPath{"voxelcraft_world.vxw"};
     bool m_worldDirty = false;
     float m_worldAutosaveElapsedSeconds = 0.0f;
+    world::World::SaveProgress m_saveProgress{};
 
     bool m_mouseCaptured = true;
     bool m_wasEscapeDown = false;
@@ -2,7 +2,9 @@
 
 #include "world/chunk_grid.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <utility>
 
 namespace odai::games::voxelcraft {
@@ -23,21 +25,32 @@ int floorDivInt(int value, int divisor) {
 std::vector<odai::world::World::ChunkKey> computeDesiredChunkKeys(
     const odai::world::World::ChunkStreamingConfig& config,
     float worldX,
+    float worldY,
     float worldZ
 ) {
     const int centerChunkX = floorDivInt(static_cast<int>(std::floor(worldX)), odai::world::Chunk::kSizeX);
+    const int centerChunkY = config.radiusChunksY > 0
+        ? floorDivInt(static_cast<int>(std::floor(worldY)), odai::world::Chunk::kSizeY)
+        : 0;
     const int centerChunkZ = floorDivInt(static_cast<int>(std::floor(worldZ)), odai::world::Chunk::kSizeZ);
-    const int radiusX = config.radiusChunksX + kChunkPrefetchMarginChunks;
-    const int radiusZ = config.radiusChunksZ + kChunkPrefetchMarginChunks;
-
-    std::vector<odai::world::World::ChunkKey> keys;
-    keys.reserve(static_cast<std::size_t>(((radiusX * 2) + 1) * ((radiusZ * 2) + 1)));
-    for (int chunkZ = centerChunkZ - radiusZ; chunkZ <= centerChunkZ + radiusZ; ++chunkZ) {
-        for (int chunkX = centerChunkX - radiusX; chunkX <= centerChunkX + radiusX; ++chunkX) {
-            keys.push_back(odai::world::World::ChunkKey{chunkX, 0, chunkZ});
-        }
+    return odai::world::World::streamingWindowKeys(
+        config, centerChunkX, centerChunkY, centerChunkZ, kChunkPrefetchMarginChunks);
+}
+
+std::vector<odai::world::World::ChunkKey> computeDesiredChunkKeys(
+    const odai::world::World::ChunkStreamingConfig& config,
+    float worldX,
+    float worldZ
+) {
+    return computeDesiredChunkKeys(config, worldX, 0.0f, worldZ);
+}
+
+ChunkStreamingPipeline::ChunkStreamingPipeline(odai::core::JobSystem& jobs, ChunkStreamingPipelineConfig config)
+    : m_jobs(jobs),
+      m_config(config) {
+    if (m_config.maxInFlight == 0u) {
+        m_config.maxInFlight = std::max<std::size_t>(2u, m_jobs.workerCount() * 2u);
     }
-    return keys;
 }
 
 ChunkStreamingPipeline::~ChunkStreamingPipeline() {
@@ -45,73 +58,200 @@ ChunkStreamingPipeline::~ChunkStreamingPipeline() {
 }
 
 void ChunkStreamingPipeline::start() {
-    if (m_worker.joinable()) {
-        return;
-    }
-    m_shuttingDown = false;
-    m_worker = std::thread(&ChunkStreamingPipeline::workerLoop, this);
+    m_running = true;
 }
 
 void ChunkStreamingPipeline::stop() {
-    if (!m_worker.joinable()) {
-        return;
+    m_running = false;
+    for (auto& [key, request] : m_requests) {
+        request->cancelled.store(true, std::memory_order_relaxed);
     }
-    m_shuttingDown = true;
-    m_wake.notify_all();
-    m_worker.join();
+    m_jobs.wait(m_jobCounter);
+    m_pending.clear();
+    m_requests.clear();
+    m_inFlightCount = 0;
+    std::lock_guard<std::mutex> lock(m_finishedMutex);
+    m_finished.clear();
 }
 
 void ChunkStreamingPipeline::requestChunk(const odai::world::World::ChunkKey& key) {
-    std::lock_guard<std::mutex> lock(m_requestMutex);
-    m_cancelled.erase(key);
-    if (!m_requested.insert(key).second) {
+    const auto requestIt = m_requests.find(key);
+    if (requestIt != m_requests.end()) {
+        // A launched request that was cancelled keeps its slot until drained.
+        requestIt->second->cancelled.store(false, std::memory_order_relaxed);
         return;
     }
-    m_pendingRequests.push_back(key);
-    m_wake.notify_one();
+    auto request = std::make_shared<Request>();
+    request->key = key;
+    request->requestTime = ChunkStreamingClock::now();
+    m_requests.emplace(key, request);
+    m_pending.push_back(std::move(request));
+    ++m_stats.requested;
 }
 
 void ChunkStreamingPipeline::cancelChunk(const odai::world::World::ChunkKey& key) {
-    std::lock_guard<std::mutex> lock(m_requestMutex);
-    m_cancelled.insert(key);
+    const auto requestIt = m_requests.find(key);
+    if (requestIt == m_requests.end()) {
+        return;
+    }
+    if (requestIt->second->launched) {
+        requestIt->second->cancelled.store(true, std::memory_order_relaxed);
+        return;
+    }
+    const auto pendingIt = std::find(m_pending.begin(), m_pending.end(), requestIt->second);
+    if (pendingIt != m_pending.end()) {
+        m_pending.erase(pendingIt);
+    }
+    m_requests.erase(requestIt);
+    ++m_stats.cancelledPending;
 }
 
-std::vector<ChunkStreamingPipeline::CompletedChunk> ChunkStreamingPipeline::drainCompleted() {
-    std::vector<CompletedChunk> drained;
-    std::lock_guard<std::mutex> lock(m_completedMutex);
-    drained.reserve(m_completed.size());
-    for (auto& completed : m_completed) {
-        drained.push_back(std::move(completed));
+std::size_t ChunkStreamingPipeline::kickJobs(int cameraChunkX, int cameraChunkY, int cameraChunkZ) {
+    if (!m_running || m_pending.empty() || m_inFlightCount >= m_config.maxInFlight) {
+        return 0;
     }
-    m_completed.clear();
-    return drained;
+
+    const auto distanceRank = [&](const Request& request) {
+        const int ring = std::max(
+            std::abs(request.key.chunkX - cameraChunkX),
+            std::abs(request.key.chunkZ - cameraChunkZ)
+        );
+        return std::make_pair(ring, std::abs(request.key.chunkY - cameraChunkY));
+    };
+    // Launch order is the tail of m_pending, so sort farthest first.
+    std::stable_sort(
+        m_pending.begin(),
+        m_pending.end(),
+        [&](const std::shared_ptr<Request>& a, const std::shared_ptr<Request>& b) {
+            return distanceRank(*b) < distanceRank(*a);
+        }
+    );
+
+    std::size_t launched = 0;
+    while (!m_pending.empty() && m_inFlightCount < m_config.maxInFlight) {
+        std::shared_ptr<Request> request = std::move(m_pending.back());
+        m_pending.pop_back();
+        request->launched = true;
+        request->launchTime = ChunkStreamingClock::now();
+        ++m_inFlightCount;
+        ++launched;
+        m_generatingCount.fetch_add(1u, std::memory_order_relaxed);
+        m_jobs.enqueue(
+            [this, request = std::move(request)]() mutable { runGenerateStage(std::move(request)); },
+            odai::core::JobPriority::Low,
+            &m_jobCounter
+        );
+    }
+    return launched;
 }
 
-void ChunkStreamingPipeline::workerLoop() {
-    for (;;) {
-        odai::world::World::ChunkKey key{};
-        bool cancelled = false;
-        {
-            std::unique_lock<std::mutex> lock(m_requestMutex);
-            m_wake.wait(lock, [this] { return m_shuttingDown.load() || !m_pendingRequests.empty(); });
-            if (m_shuttingDown.load()) {
-                return;
-            }
-            key = m_pendingRequests.front();
-            m_pendingRequests.pop_front();
-            m_requested.erase(key);
-            cancelled = m_cancelled.erase(key) > 0;
+void ChunkStreamingPipeline::runGenerateStage(std::shared_ptr<Request> request) {
+    if (request->cancelled.load(std::memory_order_relaxed)) {
+        m_generatingCount.fetch_sub(1u, std::memory_order_relaxed);
+        finishRequest(std::move(request), StageOutcome::CancelledBeforeGenerate);
+        return;
+    }
+
+    const auto generateStart = ChunkStreamingClock::now();
+    request->chunk = odai::world::buildProceduralChunk(
+        request->key.chunkX,
+        request->key.chunkY,
+        request->key.chunkZ,
+        nullptr,
+        &m_terrainCache
+    );
+    request->generateMs =
+        std::chrono::duration<float, std::milli>(ChunkStreamingClock::now() - generateStart).count();
+    m_generatingCount.fetch_sub(1u, std::memory_order_relaxed);
+    if (request->cancelled.load(std::memory_order_relaxed)) {
+        finishRequest(std::move(request), StageOutcome::CancelledBeforeMesh);
+        return;
+    }
+
+    // Normal priority: a generated chunk finishes ahead of new generate jobs.
+    m_meshingCount.fetch_add(1u, std::memory_order_relaxed);
+    m_jobs.enqueue(
+        [this, request = std::move(request)]() mutable { runMeshStage(std::move(request)); },
+        odai::core::JobPriority::Normal,
+        &m_jobCounter
+    );
+}
+
+void ChunkStreamingPipeline::runMeshStage(std::shared_ptr<Request> request) {
+    const auto meshStart = ChunkStreamingClock::now();
+    request->meshes = odai::world::buildChunkLodMeshes(request->chunk);
+    request->meshMs = std::chrono::duration<float, std::milli>(ChunkStreamingClock::now() - meshStart).count();
+    m_meshingCount.fetch_sub(1u, std::memory_order_relaxed);
+    finishRequest(std::move(request), StageOutcome::Completed);
+}
+
+void ChunkStreamingPipeline::finishRequest(std::shared_ptr<Request> request, StageOutcome outcome) {
+    request->outcome = outcome;
+    std::lock_guard<std::mutex> lock(m_finishedMutex);
+    m_finished.push_back(std::move(request));
+}
+
+std::vector<ChunkStreamingPipeline::CompletedChunk> ChunkStreamingPipeline::drainCompleted() {
+    std::vector<std::shared_ptr<Request>> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_finishedMutex);
+        finished.swap(m_finished);
+    }
+
+    std::vector<CompletedChunk> drained;
+    drained.reserve(finished.size());
+    const auto now = ChunkStreamingClock::now();
+    for (std::shared_ptr<Request>& request : finished) {
+        --m_inFlightCount;
+        const bool cancelled = request->cancelled.load(std::memory_order_relaxed);
+        if (request->outcome != StageOutcome::Completed && !cancelled) {
+            // Re-requested after its job saw the cancellation: start over.
+            request->launched = false;
+            request->outcome = StageOutcome::Completed;
+            m_pending.push_back(std::move(request));
+            continue;
         }
+        m_requests.erase(request->key);
         if (cancelled) {
+            switch (request->outcome) {
+            case StageOutcome::CancelledBeforeGenerate:
+                ++m_stats.cancelledBeforeGenerate;
+                break;
+            case StageOutcome::CancelledBeforeMesh:
+                ++m_stats.cancelledBeforeMesh;
+                break;
+            case StageOutcome::Completed:
+                ++m_stats.cancelledAfterMesh;
+                break;
+            }
             continue;
         }
 
-        odai::world::Chunk chunk = odai::world::buildProceduralChunk(key.chunkX, key.chunkY, key.chunkZ);
-        odai::world::ChunkLodMeshes meshes = odai::world::buildChunkLodMeshes(chunk);
-
-        std::lock_guard<std::mutex> lock(m_completedMutex);
-        m_completed.push_back(CompletedChunk{key, std::move(chunk), std::move(meshes)});
+        const float requestToDrainMs = std::chrono::duration<float, std::milli>(now - request->requestTime).count();
+        ++m_stats.drained;
+        m_stats.generateMsTotal += request->generateMs;
+        m_stats.meshMsTotal += request->meshMs;
+        m_stats.requestToLaunchMsTotal +=
+            std::chrono::duration<double, std::milli>(request->launchTime - request->requestTime).count();
+        m_stats.requestToDrainMsTotal += requestToDrainMs;
+        m_stats.maxRequestToDrainMs = std::max(m_stats.maxRequestToDrainMs, requestToDrainMs);
+        drained.push_back(CompletedChunk{request->key, std::move(request->chunk), std::move(request->meshes)});
     }
+    return drained;
+}
+
+ChunkStreamingPipelineStats ChunkStreamingPipeline::stats() const {
+    ChunkStreamingPipelineStats stats = m_stats;
+    stats.pendingCount = m_pending.size();
+    stats.generatingCount = m_generatingCount.load(std::memory_order_relaxed);
+    stats.meshingCount = m_meshingCount.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_finishedMutex);
+    stats.completedCount = m_finished.size();
+    return stats;
+}
+
+void ChunkStreamingPipeline::resetStats() {
+    m_stats = ChunkStreamingPipelineStats{};
 }
 
 } // namespace odai::games::voxelcraft
@@ -1,19 +1,21 @@
 #pragma once
 
+#include "core/job_system.h"
 #include "world/chunk.h"
 #include "world/chunk_mesher.h"
 #include "world/world.h"
 
 #include <atomic>
-#include <condition_variable>
-#include <deque>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <mutex>
-#include <thread>
-#include <unordered_set>
+#include <unordered_map>
 #include <vector>
 
 // VoxelCraft async chunk streaming pipeline
-// Responsible for: generating + meshing chunks off the main thread so
+// Responsible for: generating + meshing chunks on the shared job system so
 // World::updateStreamingWindowForWorldPosition never blocks on buildProceduralChunk /
 // buildChunkLodMeshes while the player is moving.
 // Should NOT do: touch World/ChunkClipmapIndex directly (both stay main-thread-only; the
@@ -27,13 +29,85 @@ constexpr int kChunkPrefetchMarginChunks = 1;
 // The set of chunk keys the streaming pipeline should have generated, given a world
 // position and World's own streaming radius config, plus a prefetch margin. Pure function
 // (no World/pipeline state) so it's independently testable -- see
-// tests/foundation_tests.cc's VoxelCraftStreaming cases.
+// tests/foundation_tests.cc's VoxelCraftStreaming cases. Keys come nearest first (see
+// World::streamingWindowKeys), so the camera's column is requested before the rim. The
+// margin applies vertically too when config.radiusChunksY > 0; otherwise only the surface
+// layer is requested.
 [[nodiscard]] std::vector<odai::world::World::ChunkKey> computeDesiredChunkKeys(
     const odai::world::World::ChunkStreamingConfig& config,
     float worldX,
+    float worldY,
     float worldZ
 );
+// Centered on the surface layer (chunkY == 0).
+[[nodiscard]] std::vector<odai::world::World::ChunkKey> computeDesiredChunkKeys(
+    const odai::world::World::ChunkStreamingConfig& config,
+    float worldX,
+    float worldZ
+);
+
+using ChunkStreamingClock = std::chrono::steady_clock;
+
+struct ChunkStreamingPipelineConfig {
+    // Requests launched onto the job system at once. The rest wait on the main
+    // thread, where re-prioritizing and cancelling them is free. 0 picks two
+    // per pool worker.
+    std::size_t maxInFlight = 0;
+};
+
+// Queue depths are a snapshot; counters and timings are cumulative since
+// construction or the last resetStats(). Every timing is measured from
+// requestChunk(), so requestToDrain minus generate and mesh is time spent
+// waiting: in the pending queue, behind other jobs, or for drainCompleted().
+// If that wait keeps growing while the player moves, the prefetch margin is
+// too small for the pool.
+struct ChunkStreamingPipelineStats {
+    // Requested, not yet launched.
+    std::size_t pendingCount = 0;
+    // Launched, still generating (or queued to).
+    std::size_t generatingCount = 0;
+    // Generated, still meshing (or queued to).
+    std::size_t meshingCount = 0;
+    // Finished, waiting for drainCompleted().
+    std::size_t completedCount = 0;
+
+    std::uint64_t requested = 0;
+    std::uint64_t drained = 0;
+    // Cancelled while pending: cost nothing.
+    std::uint64_t cancelledPending = 0;
+    // Cancelled after launch and dropped at the next stage boundary: before
+    // generating, before meshing, or finished but not yet drained.
+    std::uint64_t cancelledBeforeGenerate = 0;
+    std::uint64_t cancelledBeforeMesh = 0;
+    std::uint64_t cancelledAfterMesh = 0;
+
+    // Sums over drained chunks; divide by `drained` for averages.
+    double generateMsTotal = 0.0;
+    double meshMsTotal = 0.0;
+    double requestToLaunchMsTotal = 0.0;
+    double requestToDrainMsTotal = 0.0;
+    float maxRequestToDrainMs = 0.0f;
+
+    [[nodiscard]] float averageRequestToDrainMs() const {
+        return drained > 0u ? static_cast<float>(requestToDrainMsTotal / static_cast<double>(drained)) : 0.0f;
+    }
+};
 
+// Generates and meshes requested chunks on a shared core::JobSystem.
+//
+// Each request runs as two jobs: a Low-priority generate job, which on
+// finishing enqueues a Normal-priority mesh job for the same chunk, so one
+// chunk's meshing overlaps the next chunk's generation and finished chunks are
+// not held up behind new ones. Every request carries a cancellation flag that
+// the jobs check before each stage; cancelChunk() on a running request stops
+// it at the next stage boundary instead of letting it run to the end.
+//
+// Requests wait on the main thread until kickJobs() launches them, nearest to
+// the camera chunk first, at most maxInFlight at a time; so when the player
+// moves, the next kick launches what is now closest, not what was asked for
+// first.
+//
+// Main-thread API, except that jobs finish into a mutex-guarded queue.
 class ChunkStreamingPipeline {
 public:
     struct CompletedChunk {
@@ -42,37 +116,85 @@ public:
         odai::world::ChunkLodMeshes meshes;
     };
 
-    ChunkStreamingPipeline() = default;
+    explicit ChunkStreamingPipeline(odai::core::JobSystem& jobs, ChunkStreamingPipelineConfig config = {});
+    // stop()s.
     ~ChunkStreamingPipeline();
     ChunkStreamingPipeline(const ChunkStreamingPipeline&) = delete;
     ChunkStreamingPipeline& operator=(const ChunkStreamingPipeline&) = delete;
 
+    // Requests are only launched between start() and stop(). stop() cancels
+    // everything, waits for launched jobs and discards all results.
     void start();
     void stop();
 
-    // No-op if this key is already requested/in-flight.
+    // No-op if this key is already pending, in flight or waiting to be drained;
+    // revives it if it was cancelled but its job has not noticed yet.
     void requestChunk(const odai::world::World::ChunkKey& key);
-    // No-op if the job already started generating (the pipeline still hands back a result
-    // the caller can simply discard as out-of-radius); otherwise drops the pending request.
+    // Drops a pending request outright; flags a launched one so its job stops
+    // at the next stage boundary.
     void cancelChunk(const odai::world::World::ChunkKey& key);
 
+    // Orders pending requests by distance to the camera chunk -- horizontal
+    // ring, then layer, as World::streamingWindowKeys does -- and launches the
+    // nearest until maxInFlight are running. Call once per frame. Returns the
+    // number launched.
+    std::size_t kickJobs(int cameraChunkX, int cameraChunkY, int cameraChunkZ);
+
     // Non-blocking. Call once per frame on the main thread.
     [[nodiscard]] std::vector<CompletedChunk> drainCompleted();
 
+    [[nodiscard]] ChunkStreamingPipelineStats stats() const;
+    void resetStats();
+
 private:
-    void workerLoop();
+    enum class StageOutcome : std::uint8_t {
+        Completed,
+        CancelledBeforeGenerate,
+        CancelledBeforeMesh
+    };
+
+    // Shared by the main thread and the request's jobs. Only `cancelled` is
+    // touched by both at once; the rest is written by whichever job holds the
+    // request and read on the main thread after it is handed back.
+    struct Request {
+        odai::world::World::ChunkKey key{};
+        std::atomic<bool> cancelled{false};
+        bool launched = false;
+        ChunkStreamingClock::time_point requestTime{};
+        ChunkStreamingClock::time_point launchTime{};
+        StageOutcome outcome = StageOutcome::Completed;
+        float generateMs = 0.0f;
+        float meshMs = 0.0f;
+        odai::world::Chunk chunk;
+        odai::world::ChunkLodMeshes meshes;
+    };
+
+    void runGenerateStage(std::shared_ptr<Request> request);
+    void runMeshStage(std::shared_ptr<Request> request);
+    void finishRequest(std::shared_ptr<Request> request, StageOutcome outcome);
+
+    odai::core::JobSystem& m_jobs;
+    ChunkStreamingPipelineConfig m_config;
+    bool m_running = false;
+
+    std::unordered_map<odai::world::World::ChunkKey, std::shared_ptr<Request>, odai::world::World::ChunkKeyHash>
+        m_requests;
+    std::vector<std::shared_ptr<Request>> m_pending;
+    std::size_t m_inFlightCount = 0;
+    // Every launched job signals this; stop() waits on it.
+    odai::core::JobCounter m_jobCounter;
+
+    std::atomic<std::size_t> m_generatingCount{0};
+    std::atomic<std::size_t> m_meshingCount{0};
 
-    std::thread m_worker;
-    std::atomic<bool> m_shuttingDown{false};
+    // Shared by every generate job; a job that needs a region another job is
+    // building waits for it.
+    odai::world::TerrainPatchCache m_terrainCache;
 
-    std::mutex m_requestMutex;
-    std::condition_variable m_wake;
-    std::deque<odai::world::World::ChunkKey> m_pendingRequests;
-    std::unordered_set<odai::world::World::ChunkKey, odai::world::World::ChunkKeyHash> m_requested;
-    std::unordered_set<odai::world::World::ChunkKey, odai::world::World::ChunkKeyHash> m_cancelled;
+    mutable std::mutex m_finishedMutex;
+    std::vector<std::shared_ptr<Request>> m_finished;
 
-    std::mutex m_completedMutex;
-    std::deque<CompletedChunk> m_completed;
+    ChunkStreamingPipelineStats m_stats{};
 };
 
 } // namespace odai::games::voxelcraft
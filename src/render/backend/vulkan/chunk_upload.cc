@@ -1909,6 +1909,9 @@ bool RendererBackend::uploadChunkMeshes(
     }
     if (m_chunkMeshRebuildRequested) {
         // A queued full rebuild re-meshes everything synchronously anyway.
+        for (odai::world::ChunkMeshResult& result : results) {
+            recycleChunkLodMeshes(std::move(result.meshes));
+        }
         return true;
     }
     // Map each result to its resident chunk index; drop results for chunks
@@ -1927,6 +1930,9 @@ bool RendererBackend::uploadChunkMeshes(
         }
     }
     if (chunkIndices.empty()) {
+        for (odai::world::ChunkMeshResult& result : results) {
+            recycleChunkLodMeshes(std::move(result.meshes));
+        }
         return true;
     }
     for (odai::world::ChunkMeshResult& result : results) {
@@ -1936,6 +1942,7 @@ bool RendererBackend::uploadChunkMeshes(
             m_externalChunkMeshResults.end(),
             [&](const odai::world::ChunkMeshResult& existing) { return existing.key == result.key; });
         if (existingIt != m_externalChunkMeshResults.end()) {
+            recycleChunkLodMeshes(std::move(existingIt->meshes));
             *existingIt = std::move(result);
         } else {
             m_externalChunkMeshResults.push_back(std::move(result));
@@ -1968,6 +1975,7 @@ bool RendererBackend::consumeExternalChunkMeshResult(
         return false;
     }
     if (chunkArrayIndex < m_chunkLodMeshCache.size()) {
+        recycleChunkLodMeshes(std::move(m_chunkLodMeshCache[chunkArrayIndex]));
         m_chunkLodMeshCache[chunkArrayIndex] = std::move(resultIt->meshes);
     }
     outStats = resultIt->stats;
@@ -1975,6 +1983,14 @@ bool RendererBackend::consumeExternalChunkMeshResult(
     return true;
 }
 
+void RendererBackend::recycleChunkLodMeshes(odai::world::ChunkLodMeshes&& meshes) {
+    if (m_chunkMeshBufferPool != nullptr) {
+        m_chunkMeshBufferPool->release(std::move(meshes));
+        return;
+    }
+    meshes = odai::world::ChunkLodMeshes{};
+}
+
 
 bool RendererBackend::useSpatialPartitioningQueries() const {
     return m_debugEnableSpatialQueries;
@@ -2056,7 +2072,7 @@ bool RendererBackend::createChunkBuffers(const odai::world::ChunkGrid& chunkGrid
         m_chunkDrawRanges.assign(expectedDrawRangeCount, ChunkDrawRange{});
     }
     const std::vector<ChunkResidentKey> previousResidentKeys = std::move(m_chunkResidentKeys);
-    const std::vector<odai::world::ChunkLodMeshes> previousChunkLodMeshCache = std::move(m_chunkLodMeshCache);
+    std::vector<odai::world::ChunkLodMeshes> previousChunkLodMeshCache = std::move(m_chunkLodMeshCache);
     std::vector<RtChunkSceneRecord> previousRtChunkSceneRecords = std::move(m_rtChunkSceneRecords);
 
     m_chunkResidentKeys.assign(chunks.size(), ChunkResidentKey{});
@@ -2064,6 +2080,8 @@ bool RendererBackend::createChunkBuffers(const odai::world::ChunkGrid& chunkGrid
     m_rtChunkSceneRecords.assign(chunks.size(), RtChunkSceneRecord{});
 
     std::vector<std::uint8_t> remeshMask(chunks.size(), 0u);
+    std::vector<std::uint8_t> enteredMask(chunks.size(), 0u);
+    std::vector<std::uint8_t> previousKeptMask(previousResidentKeys.size(), 0u);
     bool reusedAnyChunkCache = false;
     for (std::size_t chunkArrayIndex = 0; chunkArrayIndex < chunks.size(); ++chunkArrayIndex) {
         const ChunkResidentKey key = chunkResidentKeyForChunk(chunks[chunkArrayIndex]);
@@ -2072,12 +2090,15 @@ bool RendererBackend::createChunkBuffers(const odai::world::ChunkGrid& chunkGrid
         const auto previousIt = std::find(previousResidentKeys.begin(), previousResidentKeys.end(), key);
         if (previousIt == previousResidentKeys.end()) {
             remeshMask[chunkArrayIndex] = 1u;
+            enteredMask[chunkArrayIndex] = 1u;
             continue;
         }
 
         const std::size_t previousIndex = static_cast<std::size_t>(std::distance(previousResidentKeys.begin(), previousIt));
+        previousKeptMask[previousIndex] = 1u;
         if (previousIndex < previousChunkLodMeshCache.size()) {
-            m_chunkLodMeshCache[chunkArrayIndex] = previousChunkLodMeshCache[previousIndex];
+            // Resident keys are unique, so each previous entry moves at most once.
+            m_chunkLodMeshCache[chunkArrayIndex] = std::move(previousChunkLodMeshCache[previousIndex]);
             reusedAnyChunkCache = true;
         } else {
             remeshMask[chunkArrayIndex] = 1u;
@@ -2093,10 +2114,40 @@ bool RendererBackend::createChunkBuffers(const odai::world::ChunkGrid& chunkGrid
             previousRtIt->chunkZ = std::numeric_limits<int>::min();
         }
     }
+    // Meshes of chunks that left the resident set.
+    for (odai::world::ChunkLodMeshes& leftover : previousChunkLodMeshCache) {
+        recycleChunkLodMeshes(std::move(leftover));
+    }
     if (previousResidentKeys.empty() || !reusedAnyChunkCache) {
         m_chunkLodMeshCacheValid = false;
         std::fill(remeshMask.begin(), remeshMask.end(), 1u);
     }
+    // Meshes cull faces against, and take seam AO from, resident neighbors,
+    // so a cached mesh next to a chunk that just entered or left is out of date.
+    const odai::world::ChunkNeighborLookup neighborLookup(chunks);
+    auto markFaceNeighborsForRemesh = [&](const odai::world::ChunkMeshKey& changedKey) {
+        for (std::uint32_t faceId = 0; faceId < odai::world::kChunkFaceCount; ++faceId) {
+            const odai::world::Chunk* neighbor =
+                neighborLookup.find(odai::world::chunkMeshNeighborKey(changedKey, faceId));
+            if (neighbor != nullptr) {
+                remeshMask[static_cast<std::size_t>(neighbor - chunks.data())] = 1u;
+            }
+        }
+    };
+    for (std::size_t chunkArrayIndex = 0; chunkArrayIndex < chunks.size(); ++chunkArrayIndex) {
+        if (enteredMask[chunkArrayIndex] == 0u) {
+            continue;
+        }
+        const odai::world::Chunk& entered = chunks[chunkArrayIndex];
+        markFaceNeighborsForRemesh(odai::world::ChunkMeshKey{entered.chunkX(), entered.chunkY(), entered.chunkZ()});
+    }
+    for (std::size_t previousIndex = 0; previousIndex < previousResidentKeys.size(); ++previousIndex) {
+        if (previousKeptMask[previousIndex] != 0u) {
+            continue;
+        }
+        const ChunkResidentKey& exited = previousResidentKeys[previousIndex];
+        markFaceNeighborsForRemesh(odai::world::ChunkMeshKey{exited.chunkX, exited.chunkY, exited.chunkZ});
+    }
     for (const std::size_t chunkIndex : remeshChunkIndices) {
         if (chunkIndex >= chunks.size()) {
             rollbackChunkDrawState();
@@ -2135,7 +2186,22 @@ bool RendererBackend::createChunkBuffers(const odai::world::ChunkGrid& chunkGrid
     const auto countMeshGeometry = [](const odai::world::ChunkLodMeshes& lodMeshes, std::size_t& outVertices, std::size_t& outIndices) {
         for (const odai::world::ChunkMeshData& lodMesh : lodMeshes.lodMeshes) {
             outVertices += lodMesh.vertices.size();
-            outIndices += lodMesh.indices.size();
+            outIndices += lodMesh.indexCount();
+        }
+    };
+    // Inline rebuilds mesh into the cache entry's own buffers; the pool is
+    // told about any growth so its byte accounting covers them too.
+    const auto rebuildCachedChunkMeshes = [&](std::size_t chunkArrayIndex, odai::world::ChunkMeshingStats& meshingStats) {
+        odai::world::ChunkLodMeshes& cached = m_chunkLodMeshCache[chunkArrayIndex];
+        const std::size_t capacityBytesBefore = odai::world::chunkMeshCapacityBytes(cached);
+        odai::world::buildChunkLodMeshesInto(
+            neighborLookup.neighborhood(chunks[chunkArrayIndex]),
+            m_chunkMeshingOptions,
+            &meshingStats,
+            cached
+        );
+        if (m_chunkMeshBufferPool != nullptr) {
+            m_chunkMeshBufferPool->recordBuild(capacityBytesBefore, cached);
         }
     };
     const bool fullRemesh =
@@ -2146,8 +2212,7 @@ bool RendererBackend::createChunkBuffers(const odai::world::ChunkGrid& chunkGrid
         for (std::size_t chunkArrayIndex = 0; chunkArrayIndex < chunks.size(); ++chunkArrayIndex) {
             odai::world::ChunkMeshingStats meshingStats{};
             if (!consumeExternalChunkMeshResult(chunkArrayIndex, meshingStats)) {
-                m_chunkLodMeshCache[chunkArrayIndex] =
-                    odai::world::buildChunkLodMeshes(chunks[chunkArrayIndex], m_chunkMeshingOptions, &meshingStats);
+                rebuildCachedChunkMeshes(chunkArrayIndex, meshingStats);
             }
             countMeshGeometry(
                 m_chunkLodMeshCache[chunkArrayIndex],
@@ -2172,8 +2237,7 @@ bool RendererBackend::createChunkBuffers(const odai::world::ChunkGrid& chunkGrid
         for (const std::size_t chunkArrayIndex : uniqueRemeshChunkIndices) {
             odai::world::ChunkMeshingStats meshingStats{};
             if (!consumeExternalChunkMeshResult(chunkArrayIndex, meshingStats)) {
-                m_chunkLodMeshCache[chunkArrayIndex] =
-                    odai::world::buildChunkLodMeshes(chunks[chunkArrayIndex], m_chunkMeshingOptions, &meshingStats);
+                rebuildCachedChunkMeshes(chunkArrayIndex, meshingStats);
             }
             countMeshGeometry(
                 m_chunkLodMeshCache[chunkArrayIndex],
@@ -2254,7 +2318,7 @@ bool RendererBackend::createChunkBuffers(const odai::world::ChunkGrid& chunkGrid
             drawRange.vertexOffset = 0;
             drawRange.indexCount = 0;
 
-            if (chunkMesh.vertices.empty() || chunkMesh.indices.empty()) {
+            if (chunkMesh.vertices.empty() || chunkMesh.indexCount() == 0u) {
                 continue;
             }
 
@@ -2268,18 +2332,15 @@ bool RendererBackend::createChunkBuffers(const odai::world::ChunkGrid& chunkGrid
             const uint32_t firstIndex = static_cast<uint32_t>(combinedIndices.size());
 
             combinedVertices.insert(combinedVertices.end(), chunkMesh.vertices.begin(), chunkMesh.vertices.end());
-            combinedIndices.reserve(combinedIndices.size() + chunkMesh.indices.size());
-            for (const std::uint32_t index : chunkMesh.indices) {
-                combinedIndices.push_back(index + baseVertex);
-            }
+            odai::world::appendMeshIndices(chunkMesh, baseVertex, combinedIndices);
             if (lodIndex == 0u &&
                 m_rayTracingCapabilityProbe.rayTracingCoreReady &&
                 rtEligible &&
                 (remeshChunk || !rtChunkRecord.geometryResident || previousRtEligible != rtEligible)) {
                 // RT shadows should trace against the highest-detail chunk mesh.
                 rtChunkRecord.vertexCount = static_cast<std::uint32_t>(chunkMesh.vertices.size());
-                rtChunkRecord.indexCount = static_cast<std::uint32_t>(chunkMesh.indices.size());
-                rtChunkRecord.geometryResident = !chunkMesh.vertices.empty() && !chunkMesh.indices.empty();
+                rtChunkRecord.indexCount = static_cast<std::uint32_t>(chunkMesh.indexCount());
+                rtChunkRecord.geometryResident = true;
                 std::vector<RtVertex> rtChunkVertices;
                 rtChunkVertices.reserve(chunkMesh.vertices.size());
                 for (const odai::world::PackedVoxelVertex& vertex : chunkMesh.vertices) {
@@ -2287,7 +2348,9 @@ bool RendererBackend::createChunkBuffers(const odai::world::ChunkGrid& chunkGrid
                         decodePackedVoxelVertexPosition(vertex.bits, drawRange.offsetX, drawRange.offsetY, drawRange.offsetZ)
                     );
                 }
-                if (!createRtGeometryBuffers(m_bufferAllocator, rtChunkVertices, chunkMesh.indices, rtChunkRecord.geometry)) {
+                m_rtChunkIndexScratch.clear();
+                odai::world::appendMeshIndices(chunkMesh, 0u, m_rtChunkIndexScratch);
+                if (!createRtGeometryBuffers(m_bufferAllocator, rtChunkVertices, m_rtChunkIndexScratch, rtChunkRecord.geometry)) {
                     VOX_LOGE("render") << "chunk RT geometry buffer allocation failed for chunk ("
                                        << rtChunkRecord.chunkX << ","
                                        << rtChunkRecord.chunkY << ","
@@ -2301,9 +2364,9 @@ bool RendererBackend::createChunkBuffers(const odai::world::ChunkGrid& chunkGrid
             drawRange.firstIndex = firstIndex;
             // Indices are already rebased into global vertex space.
             drawRange.vertexOffset = 0;
-            drawRange.indexCount = static_cast<uint32_t>(chunkMesh.indices.size());
+            drawRange.indexCount = static_cast<uint32_t>(chunkMesh.indexCount());
             uploadedVertexCount += chunkMesh.vertices.size();
-            uploadedIndexCount += chunkMesh.indices.size();
+            uploadedIndexCount += chunkMesh.indexCount();
         }
 
         if (!rtEligible) {
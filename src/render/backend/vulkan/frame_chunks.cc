@@ -35,6 +35,7 @@ std::size_t selectChunkLodIndex(
 RendererBackend::FrameChunkDrawData RendererBackend::prepareFrameChunkDrawData(
     const std::vector<odai::world::Chunk>& chunks,
     std::span<const std::size_t> visibleChunkIndices,
+    const std::vector<std::size_t>* mainViewChunkIndices,
     const std::array<odai::math::Matrix4, kShadowCascadeCount>& lightViewProjMatrices,
     int cameraChunkX,
     int cameraChunkY,
@@ -115,7 +116,11 @@ RendererBackend::FrameChunkDrawData RendererBackend::prepareFrameChunkDrawData(
     };
 
     if (!suppressVoxelChunks) {
-        if (!visibleChunkIndices.empty()) {
+        if (mainViewChunkIndices != nullptr) {
+            for (const std::size_t chunkArrayIndex : *mainViewChunkIndices) {
+                appendChunkLods(chunkArrayIndex, chunkInstanceData, chunkIndirectCommands, true);
+            }
+        } else if (!visibleChunkIndices.empty()) {
             for (const std::size_t chunkArrayIndex : visibleChunkIndices) {
                 appendChunkLods(chunkArrayIndex, chunkInstanceData, chunkIndirectCommands, true);
             }
@@ -262,15 +262,19 @@ void RendererBackend::renderFrame(
         });
     }
     if (!m_externalChunkMeshResults.empty()) {
-        std::erase_if(m_externalChunkMeshResults, [&](const odai::world::ChunkMeshResult& result) {
-            return std::find_if(
-                       chunkGrid.chunks().begin(),
-                       chunkGrid.chunks().end(),
-                       [&](const odai::world::Chunk& chunk) {
-                           return chunk.chunkX() == result.key.x &&
-                                  chunk.chunkY() == result.key.y &&
-                                  chunk.chunkZ() == result.key.z;
-                       }) == chunkGrid.chunks().end();
+        std::erase_if(m_externalChunkMeshResults, [&](odai::world::ChunkMeshResult& result) {
+            const bool evicted = std::find_if(
+                                     chunkGrid.chunks().begin(),
+                                     chunkGrid.chunks().end(),
+                                     [&](const odai::world::Chunk& chunk) {
+                                         return chunk.chunkX() == result.key.x &&
+                                                chunk.chunkY() == result.key.y &&
+                                                chunk.chunkZ() == result.key.z;
+                                     }) == chunkGrid.chunks().end();
+            if (evicted) {
+                recycleChunkLodMeshes(std::move(result.meshes));
+            }
+            return evicted;
         });
     }
     m_debugChunkPendingRemeshCount = static_cast<std::uint32_t>(m_pendingChunkRemeshKeys.size());
@@ -1424,6 +1428,7 @@ void RendererBackend::renderFrame(
                 auto* chunkMeta = static_cast<VoxelGiChunkMetaUpload*>(chunkMetaSliceOpt->mapped);
                 auto* chunkVoxels = static_cast<uint32_t*>(chunkVoxelsSliceOpt->mapped);
                 const std::vector<odai::world::Chunk>& chunks = chunkGrid.chunks();
+                std::vector<odai::world::Voxel> giChunkVoxelScratch;
                 for (std::size_t batchIndex = 0; batchIndex < occupancyChunkBatch.size(); ++batchIndex) {
                     const std::size_t chunkIndex = occupancyChunkBatch[batchIndex];
                     if (chunkIndex >= chunks.size()) {
@@ -1436,7 +1441,8 @@ void RendererBackend::renderFrame(
                     chunkMeta[batchIndex].voxelOffset =
                         static_cast<uint32_t>(batchIndex * static_cast<std::size_t>(kVoxelGiChunkVoxelCount));
 
-                    const std::vector<odai::world::Voxel>& voxels = chunk.voxels();
+                    chunk.copyDenseVoxels(giChunkVoxelScratch);
+                    const std::vector<odai::world::Voxel>& voxels = giChunkVoxelScratch;
                     const std::size_t voxelWriteOffset = batchIndex * static_cast<std::size_t>(kVoxelGiChunkVoxelCount);
                     for (std::size_t voxelIndex = 0; voxelIndex < voxels.size(); ++voxelIndex) {
                         const odai::world::Voxel& voxel = voxels[voxelIndex];
@@ -1664,10 +1670,27 @@ void RendererBackend::renderFrame(
     const auto& beltCargoInstanceSliceOpt = frameInstanceDrawData.beltCargoInstanceSliceOpt;
     const std::vector<ReadyMagicaDraw>& readyMagicaDraws = frameInstanceDrawData.readyMagicaDraws;
 
+    // CPU frustum + Hi-Z occlusion pass for the camera view. The occlusion
+    // depth buffer assumes a perspective eye, so ortho views keep frustum
+    // culling only.
+    m_debugVisibilityCullingStats = {};
+    m_visibilityCuller.settings().occlusionEnabled = m_debugEnableOcclusionCulling && !camera.orthographic;
+    const bool cullVoxelChunks = legacySceneRenderingEnabled && m_importedMeshDraws.empty();
+    if (cullVoxelChunks) {
+        m_visibilityCuller.cullChunks(
+            chunkGrid.chunks(),
+            visibleChunkIndices,
+            mvp,
+            eye,
+            m_cameraVisibleChunkIndices,
+            m_debugVisibilityCullingStats);
+    }
+
     const FrameChunkDrawData frameChunkDrawData = legacySceneRenderingEnabled
         ? prepareFrameChunkDrawData(
             chunkGrid.chunks(),
             visibleChunkIndices,
+            cullVoxelChunks ? &m_cameraVisibleChunkIndices : nullptr,
             lightViewProjMatrices,
             cameraChunkX,
             cameraChunkY,
@@ -1748,78 +1771,61 @@ void RendererBackend::renderFrame(
         m_importedMeshDraws.size());
     std::uint32_t importedTerrainDrawCountForFrame = m_importedTerrainDrawCount;
     const bool importedPageCullingEnabled = !m_importedPageDrawRanges.empty();
-    auto importedPageIntersectsClip = [](
-                                          const ImportedScenePageDrawRange& pageRange,
-                                          const odai::math::Matrix4& clipMatrix,
-                                          float clipMargin
-                                      ) -> bool {
-        if (pageRange.drawCount == 0u) {
-            return false;
-        }
-        if (pageRange.boundsMin[0] > pageRange.boundsMax[0] ||
-            pageRange.boundsMin[1] > pageRange.boundsMax[1] ||
-            pageRange.boundsMin[2] > pageRange.boundsMax[2]) {
-            return true;
-        }
-
-        std::array<odai::math::Vector3, 8> corners = {
-            odai::math::Vector3{pageRange.boundsMin[0], pageRange.boundsMin[1], pageRange.boundsMin[2]},
-            odai::math::Vector3{pageRange.boundsMax[0], pageRange.boundsMin[1], pageRange.boundsMin[2]},
-            odai::math::Vector3{pageRange.boundsMin[0], pageRange.boundsMax[1], pageRange.boundsMin[2]},
-            odai::math::Vector3{pageRange.boundsMax[0], pageRange.boundsMax[1], pageRange.boundsMin[2]},
-            odai::math::Vector3{pageRange.boundsMin[0], pageRange.boundsMin[1], pageRange.boundsMax[2]},
-            odai::math::Vector3{pageRange.boundsMax[0], pageRange.boundsMin[1], pageRange.boundsMax[2]},
-            odai::math::Vector3{pageRange.boundsMin[0], pageRange.boundsMax[1], pageRange.boundsMax[2]},
-            odai::math::Vector3{pageRange.boundsMax[0], pageRange.boundsMax[1], pageRange.boundsMax[2]},
-        };
-
-        float ndcMinX = std::numeric_limits<float>::max();
-        float ndcMinY = std::numeric_limits<float>::max();
-        float ndcMinZ = std::numeric_limits<float>::max();
-        float ndcMaxX = std::numeric_limits<float>::lowest();
-        float ndcMaxY = std::numeric_limits<float>::lowest();
-        float ndcMaxZ = std::numeric_limits<float>::lowest();
-        for (const odai::math::Vector3& corner : corners) {
-            const odai::math::Vector4 clip =
-                odai::math::multiply(clipMatrix, odai::math::Vector4{corner, 1.0f});
-            // Any corner at/behind the near plane makes the perspective divide
-            // (sign-flipped w) produce garbage NDC, which would wrongly cull pages
-            // straddling the camera — common for foreground chunks and the whole-map
-            // overlay under the tilted 3D camera. Treat such pages as visible.
-            if (clip.w <= 1e-4f) {
-                return true;
+    if (importedPageCullingEnabled) {
+        m_importedPageCullBounds.clear();
+        m_importedPageCullBounds.reserve(m_importedPageDrawRanges.size());
+        m_importedTerrainPageMask.assign(m_importedPageDrawRanges.size(), 0u);
+        for (std::size_t pageIndex = 0; pageIndex < m_importedPageDrawRanges.size(); ++pageIndex) {
+            const ImportedScenePageDrawRange& pageRange = m_importedPageDrawRanges[pageIndex];
+            m_importedPageCullBounds.push(
+                odai::math::Vector3{pageRange.boundsMin[0], pageRange.boundsMin[1], pageRange.boundsMin[2]},
+                odai::math::Vector3{pageRange.boundsMax[0], pageRange.boundsMax[1], pageRange.boundsMax[2]});
+            // Terrain and statics never share a page; all-terrain pages are
+            // landscape heightfields and can occlude what lies beneath them.
+            const bool validBounds =
+                pageRange.boundsMin[0] <= pageRange.boundsMax[0] &&
+                pageRange.boundsMin[1] <= pageRange.boundsMax[1] &&
+                pageRange.boundsMin[2] <= pageRange.boundsMax[2];
+            if (validBounds && pageRange.drawCount > 0u && pageRange.terrainDrawCount >= pageRange.drawCount) {
+                m_importedTerrainPageMask[pageIndex] = 1u;
             }
-            const float invW = 1.0f / clip.w;
-            const float ndcX = clip.x * invW;
-            const float ndcY = clip.y * invW;
-            const float ndcZ = clip.z * invW;
-            ndcMinX = std::min(ndcMinX, ndcX);
-            ndcMinY = std::min(ndcMinY, ndcY);
-            ndcMinZ = std::min(ndcMinZ, ndcZ);
-            ndcMaxX = std::max(ndcMaxX, ndcX);
-            ndcMaxY = std::max(ndcMaxY, ndcY);
-            ndcMaxZ = std::max(ndcMaxZ, ndcZ);
         }
-
-        return !(ndcMaxX < (-1.0f - clipMargin) ||
-                 ndcMinX > (1.0f + clipMargin) ||
-                 ndcMaxY < (-1.0f - clipMargin) ||
-                 ndcMinY > (1.0f + clipMargin) ||
-                 ndcMaxZ < (0.0f - clipMargin) ||
-                 ndcMinZ > (1.0f + clipMargin));
-    };
+    }
+    // The camera view also runs the Hi-Z occlusion test; shadow cascades see
+    // geometry the camera cannot, so they only get the frustum test.
     auto buildVisibleImportedDraws = [&](
                                       const odai::math::Matrix4& clipMatrix,
                                       float clipMargin,
+                                      bool cameraView,
                                       std::vector<ImportedMeshDraw>& outDraws
                                   ) -> std::uint32_t {
         outDraws.clear();
         if (outDraws.capacity() < m_importedMeshDraws.size()) {
             outDraws.reserve(m_importedMeshDraws.size());
         }
-        m_visibleImportedPageScratch.assign(m_importedPageDrawRanges.size(), 0u);
+        if (cameraView) {
+            m_visibilityCuller.cullPages(
+                m_importedPageCullBounds,
+                m_importedTerrainPageMask,
+                clipMatrix,
+                eye,
+                clipMargin,
+                m_visibleImportedPageScratch,
+                m_debugVisibilityCullingStats);
+        } else {
+            frustumTestBounds(
+                extractCullFrustum(clipMatrix, clipMargin),
+                m_importedPageCullBounds,
+                m_visibleImportedPageScratch);
+        }
         for (std::size_t pageIndex = 0; pageIndex < m_importedPageDrawRanges.size(); ++pageIndex) {
-            if (importedPageIntersectsClip(m_importedPageDrawRanges[pageIndex], clipMatrix, clipMargin)) {
+            const ImportedScenePageDrawRange& pageRange = m_importedPageDrawRanges[pageIndex];
+            if (pageRange.drawCount == 0u) {
+                m_visibleImportedPageScratch[pageIndex] = 0u;
+            } else if (pageRange.boundsMin[0] > pageRange.boundsMax[0] ||
+                       pageRange.boundsMin[1] > pageRange.boundsMax[1] ||
+                       pageRange.boundsMin[2] > pageRange.boundsMax[2]) {
+                // Pages without valid bounds are always drawn.
                 m_visibleImportedPageScratch[pageIndex] = 1u;
             }
         }
@@ -1861,7 +1867,7 @@ void RendererBackend::renderFrame(
         constexpr float kImportedMainClipMargin = 0.04f;
         constexpr float kImportedShadowClipMargin = 0.08f;
         m_visibleImportedTerrainDrawCount =
-            buildVisibleImportedDraws(mvp, kImportedMainClipMargin, m_visibleImportedMeshDraws);
+            buildVisibleImportedDraws(mvp, kImportedMainClipMargin, true, m_visibleImportedMeshDraws);
         importedMeshDrawsForFrame = std::span<const ImportedMeshDraw>(
             m_visibleImportedMeshDraws.data(),
             m_visibleImportedMeshDraws.size());
@@ -1870,6 +1876,7 @@ void RendererBackend::renderFrame(
             m_visibleImportedShadowTerrainDrawCounts[cascadeIndex] = buildVisibleImportedDraws(
                 lightViewProjMatrices[cascadeIndex],
                 kImportedShadowClipMargin,
+                false,
                 m_visibleImportedShadowMeshDraws[cascadeIndex]);
         }
     }
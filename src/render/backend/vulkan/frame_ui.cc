@@ -994,6 +994,7 @@ void RendererBackend::buildMeshingDebugUi() {
     }
 
     ImGui::Checkbox("Use Spatial Queries", &m_debugEnableSpatialQueries);
+    ImGui::Checkbox("Hi-Z Occlusion Culling", &m_debugEnableOcclusionCulling);
     int clipmapLevels = static_cast<int>(m_debugClipmapConfig.levelCount);
     int clipmapGridResolution = m_debugClipmapConfig.gridResolution;
     int clipmapBaseVoxelSize = m_debugClipmapConfig.baseVoxelSize;
@@ -1021,6 +1022,9 @@ void RendererBackend::buildMeshingDebugUi() {
             m_chunkMeshRebuildRequested = true;
             m_pendingChunkRemeshKeys.clear();
             // Off-thread meshes built with the previous mode are now wrong.
+            for (odai::world::ChunkMeshResult& result : m_externalChunkMeshResults) {
+                recycleChunkLodMeshes(std::move(result.meshes));
+            }
             m_externalChunkMeshResults.clear();
             VOX_LOGI("render") << "chunk meshing mode changed to "
                                << (nextMode == odai::world::MeshingMode::Greedy ? "Greedy" : "Naive")
@@ -1047,6 +1051,15 @@ void RendererBackend::buildMeshingDebugUi() {
         );
     }
 
+    ImGui::Text(
+        "Cull Chunks F/O: %u / %u  Pages F/O: %u / %u  Occluders: %u",
+        m_debugVisibilityCullingStats.frustumCulledChunkCount,
+        m_debugVisibilityCullingStats.occlusionCulledChunkCount,
+        m_debugVisibilityCullingStats.frustumCulledPageCount,
+        m_debugVisibilityCullingStats.occlusionCulledPageCount,
+        m_debugVisibilityCullingStats.occluderCount
+    );
+
     ImGui::Text("Chunk Mesh Vert/Idx: %u / %u", m_debugChunkMeshVertexCount, m_debugChunkMeshIndexCount);
     ImGui::Text("Last Chunk Remesh: %.2f ms (%u)", m_debugChunkLastRemeshMs, m_debugChunkLastRemeshedChunkCount);
     ImGui::Text("Chunk Remesh Pending/Batch: %u / %u", m_debugChunkPendingRemeshCount, m_debugChunkRemeshBatchCount);
@@ -2496,6 +2496,8 @@ void RendererBackend::shutdown() {
     m_debugClipmapConfig = odai::world::ClipmapConfig{};
     m_debugSpatialQueriesUsed = false;
     m_debugSpatialQueryStats = {};
+    m_debugEnableOcclusionCulling = true;
+    m_debugVisibilityCullingStats = {};
     m_debugSpatialVisibleChunkCount = 0;
     m_debugCpuFrameTotalMsHistory.clear();
     m_debugCpuFrameWorkMsHistory.clear();
@@ -9,6 +9,7 @@
 #include "render/frame_graph.h"
 #include "render/backend/vulkan/pipeline_manager.h"
 #include "render/backend/vulkan/ui_renderer.h"
+#include "render/backend/vulkan/visibility_culling.h"
 #include "render/renderer_types.h"
 #include "sim/simulation.h"
 #include "world/clipmap_index.h"
@@ -309,6 +310,9 @@ public:
     // Meshing mode the renderer's own (full-rebuild) path uses. Callers driving
     // an off-thread mesher must mirror it so both paths agree.
     [[nodiscard]] odai::world::MeshingOptions chunkMeshingOptions() const { return m_chunkMeshingOptions; }
+    // Where chunk meshes go when the renderer is done with them (replaced in
+    // the LOD cache, or dropped before upload). Null frees them instead.
+    void setChunkMeshBufferPool(odai::world::ChunkMeshBufferPool* pool) { m_chunkMeshBufferPool = pool; }
     bool useSpatialPartitioningQueries() const;
     odai::world::ClipmapConfig clipmapQueryConfig() const;
     void setSpatialQueryStats(bool used, const odai::world::SpatialQueryStats& stats, std::uint32_t visibleChunkCount);
@@ -507,6 +511,7 @@ private:
     // Moves a stored off-thread mesh result into the LOD cache for the given
     // resident chunk index. Returns false when no result is stored for it.
     bool consumeExternalChunkMeshResult(std::size_t chunkArrayIndex, odai::world::ChunkMeshingStats& outStats);
+    void recycleChunkLodMeshes(odai::world::ChunkLodMeshes&& meshes);
     bool createFrameResources();
     bool createGpuTimestampResources();
     bool createImGuiResources();
@@ -963,9 +968,13 @@ private:
         float simulationAlpha
     );
 
+    // mainViewChunkIndices, when set, replaces visibleChunkIndices for the
+    // camera pass (an empty list then draws nothing); shadow casters are
+    // still picked around visibleChunkIndices.
     FrameChunkDrawData prepareFrameChunkDrawData(
         const std::vector<odai::world::Chunk>& chunks,
         std::span<const std::size_t> visibleChunkIndices,
+        const std::vector<std::size_t>* mainViewChunkIndices,
         const std::array<odai::math::Matrix4, kShadowCascadeCount>& lightViewProjMatrices,
         int cameraChunkX,
         int cameraChunkY,
@@ -1381,6 +1390,10 @@ private:
     std::array<std::vector<ImportedMeshDraw>, kShadowCascadeCount> m_visibleImportedShadowMeshDraws;
     std::vector<std::uint32_t> m_importedTextureSlots;
     std::vector<std::uint8_t> m_visibleImportedPageScratch;
+    VisibilityCuller m_visibilityCuller;
+    std::vector<std::size_t> m_cameraVisibleChunkIndices;
+    CullBoundsSoA m_importedPageCullBounds;
+    std::vector<std::uint8_t> m_importedTerrainPageMask;
     std::uint32_t m_visibleImportedTerrainDrawCount = 0;
     std::array<std::uint32_t, kShadowCascadeCount> m_visibleImportedShadowTerrainDrawCounts{};
     std::vector<ImportedGiTriangle> m_importedGiTriangles;
@@ -1403,6 +1416,9 @@ private:
     // Off-thread mesh results waiting to be consumed by the remesh path;
     // keyed by chunk grid coordinates, replaced on newer arrival.
     std::vector<odai::world::ChunkMeshResult> m_externalChunkMeshResults;
+    odai::world::ChunkMeshBufferPool* m_chunkMeshBufferPool = nullptr;
+    // Reused per chunk for RT geometry: chunk meshes carry no index buffer.
+    std::vector<std::uint32_t> m_rtChunkIndexScratch;
     uint32_t m_previewIndexCount = 0;
     uint32_t m_pipeIndexCount = 0;
     uint32_t m_transportIndexCount = 0;
@@ -1590,6 +1606,10 @@ private:
     odai::world::ClipmapConfig m_debugClipmapConfig{};
     bool m_debugSpatialQueriesUsed = false;
     odai::world::SpatialQueryStats m_debugSpatialQueryStats{};
+    // Written by renderFrame's CPU frustum/Hi-Z pass; the app-side query
+    // stats above are replaced wholesale every frame.
+    bool m_debugEnableOcclusionCulling = true;
+    odai::world::SpatialQueryStats m_debugVisibilityCullingStats{};
     std::uint32_t m_debugSpatialVisibleChunkCount = 0;
     std::uint32_t m_debugChunkIndirectCommandCount = 0;
     std::uint32_t m_debugDrawCallsTotal = 0;
@@ -0,0 +1,749 @@
+#include "render/backend/vulkan/visibility_culling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// The frustum test runs four boxes per step on SSE2, which every x86-64 target
+// has. It evaluates the plane equations in the same order as the scalar path,
+// so both produce the same visibility bytes.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ODAI_CULLING_SSE2 1
+#endif
+
+namespace odai::render {
+
+namespace {
+
+// Corners closer to the eye plane than this are treated as crossing it.
+constexpr float kMinClipW = 1e-4f;
+
+struct ProjectedPoint {
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+};
+
+// Pixel-space depth plane z = a * x + b * y + c of one front face.
+struct DepthPlane {
+    double a = 0.0;
+    double b = 0.0;
+    double c = 0.0;
+};
+
+odai::math::Vector3 boxCorner(
+    const odai::math::Vector3& boundsMin,
+    const odai::math::Vector3& boundsMax,
+    int cornerIndex
+) {
+    return odai::math::Vector3{
+        (cornerIndex & 1) != 0 ? boundsMax.x : boundsMin.x,
+        (cornerIndex & 2) != 0 ? boundsMax.y : boundsMin.y,
+        (cornerIndex & 4) != 0 ? boundsMax.z : boundsMin.z
+    };
+}
+
+float axisValue(const odai::math::Vector3& v, int axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+// Projects the 8 corners into pixel space (x, y) plus NDC depth. Fails when
+// any corner sits behind the eye or in front of the near plane.
+bool projectBoxCorners(
+    const odai::math::Matrix4& clipFromWorld,
+    const odai::math::Vector3& boundsMin,
+    const odai::math::Vector3& boundsMax,
+    int width,
+    int height,
+    std::array<ProjectedPoint, 8>& outCorners
+) {
+    for (int cornerIndex = 0; cornerIndex < 8; ++cornerIndex) {
+        const odai::math::Vector4 clip = odai::math::multiply(
+            clipFromWorld,
+            odai::math::Vector4{boxCorner(boundsMin, boundsMax, cornerIndex), 1.0f}
+        );
+        if (!(clip.w > kMinClipW) || clip.z < 0.0f) {
+            return false;
+        }
+        const double invW = 1.0 / static_cast<double>(clip.w);
+        ProjectedPoint& point = outCorners[static_cast<std::size_t>(cornerIndex)];
+        point.x = ((static_cast<double>(clip.x) * invW) + 1.0) * 0.5 * static_cast<double>(width);
+        point.y = ((static_cast<double>(clip.y) * invW) + 1.0) * 0.5 * static_cast<double>(height);
+        point.z = static_cast<double>(clip.z) * invW;
+    }
+    return true;
+}
+
+double cross2d(const ProjectedPoint& o, const ProjectedPoint& a, const ProjectedPoint& b) {
+    return ((a.x - o.x) * (b.y - o.y)) - ((a.y - o.y) * (b.x - o.x));
+}
+
+// Counter-clockwise convex hull (monotone chain); collinear points dropped.
+std::size_t convexHull(std::array<ProjectedPoint, 8> points, std::array<ProjectedPoint, 16>& outHull) {
+    std::sort(points.begin(), points.end(), [](const ProjectedPoint& lhs, const ProjectedPoint& rhs) {
+        return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y);
+    });
+    std::size_t count = 0;
+    for (const ProjectedPoint& point : points) {
+        while (count >= 2 && cross2d(outHull[count - 2], outHull[count - 1], point) <= 0.0) {
+            --count;
+        }
+        outHull[count++] = point;
+    }
+    const std::size_t lowerCount = count + 1;
+    for (std::size_t i = points.size() - 1; i-- > 0;) {
+        while (count >= lowerCount && cross2d(outHull[count - 2], outHull[count - 1], points[i]) <= 0.0) {
+            --count;
+        }
+        outHull[count++] = points[i];
+    }
+    return count > 1 ? count - 1 : count;
+}
+
+bool isOpaqueSolidCell(const odai::world::Chunk::MacroCell& cell) {
+    // Leaves are alpha-tested, so they never count as occluders.
+    return cell.resolution == odai::world::Chunk::CellResolution::Uniform &&
+           cell.voxel.type != odai::world::VoxelType::Empty &&
+           cell.voxel.type != odai::world::VoxelType::Leaves;
+}
+
+int floorDivide(float value, int divisor) {
+    return static_cast<int>(std::floor(value / static_cast<float>(divisor)));
+}
+
+float distanceSquaredToBounds(
+    const odai::math::Vector3& point,
+    const odai::math::Vector3& boundsMin,
+    const odai::math::Vector3& boundsMax
+) {
+    const float dx = std::max({boundsMin.x - point.x, 0.0f, point.x - boundsMax.x});
+    const float dy = std::max({boundsMin.y - point.y, 0.0f, point.y - boundsMax.y});
+    const float dz = std::max({boundsMin.z - point.z, 0.0f, point.z - boundsMax.z});
+    return (dx * dx) + (dy * dy) + (dz * dz);
+}
+
+}  // namespace
+
+void CullBoundsSoA::clear() {
+    minX.clear();
+    minY.clear();
+    minZ.clear();
+    maxX.clear();
+    maxY.clear();
+    maxZ.clear();
+}
+
+void CullBoundsSoA::reserve(std::size_t count) {
+    minX.reserve(count);
+    minY.reserve(count);
+    minZ.reserve(count);
+    maxX.reserve(count);
+    maxY.reserve(count);
+    maxZ.reserve(count);
+}
+
+void CullBoundsSoA::push(const odai::math::Vector3& boundsMin, const odai::math::Vector3& boundsMax) {
+    minX.push_back(boundsMin.x);
+    minY.push_back(boundsMin.y);
+    minZ.push_back(boundsMin.z);
+    maxX.push_back(boundsMax.x);
+    maxY.push_back(boundsMax.y);
+    maxZ.push_back(boundsMax.z);
+}
+
+CullFrustum extractCullFrustum(const odai::math::Matrix4& clipFromWorld, float clipMargin) {
+    const auto row = [&](int r) {
+        return std::array<float, 4>{
+            clipFromWorld(r, 0), clipFromWorld(r, 1), clipFromWorld(r, 2), clipFromWorld(r, 3)
+        };
+    };
+    const auto combine = [](const std::array<float, 4>& lhs, float lhsScale, const std::array<float, 4>& rhs, float rhsScale) {
+        return std::array<float, 4>{
+            (lhs[0] * lhsScale) + (rhs[0] * rhsScale),
+            (lhs[1] * lhsScale) + (rhs[1] * rhsScale),
+            (lhs[2] * lhsScale) + (rhs[2] * rhsScale),
+            (lhs[3] * lhsScale) + (rhs[3] * rhsScale)
+        };
+    };
+
+    const std::array<float, 4> rowX = row(0);
+    const std::array<float, 4> rowY = row(1);
+    const std::array<float, 4> rowZ = row(2);
+    const std::array<float, 4> rowW = row(3);
+    const float extent = 1.0f + clipMargin;
+
+    CullFrustum frustum{};
+    frustum.planes[0] = combine(rowW, extent, rowX, 1.0f);
+    frustum.planes[1] = combine(rowW, extent, rowX, -1.0f);
+    frustum.planes[2] = combine(rowW, extent, rowY, 1.0f);
+    frustum.planes[3] = combine(rowW, extent, rowY, -1.0f);
+    frustum.planes[4] = combine(rowW, clipMargin, rowZ, 1.0f);
+    frustum.planes[5] = combine(rowW, extent, rowZ, -1.0f);
+    return frustum;
+}
+
+bool frustumIntersectsBounds(
+    const CullFrustum& frustum,
+    const odai::math::Vector3& boundsMin,
+    const odai::math::Vector3& boundsMax
+) {
+    // A box is outside when its corner furthest along a plane normal (the
+    // "positive vertex") is still behind that plane.
+    for (const std::array<float, 4>& plane : frustum.planes) {
+        const float x = plane[0] >= 0.0f ? boundsMax.x : boundsMin.x;
+        const float y = plane[1] >= 0.0f ? boundsMax.y : boundsMin.y;
+        const float z = plane[2] >= 0.0f ? boundsMax.z : boundsMin.z;
+        const float distance = (plane[0] * x) + (plane[1] * y) + (plane[2] * z) + plane[3];
+        if (!(distance >= 0.0f)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void frustumTestBounds(
+    const CullFrustum& frustum,
+    const CullBoundsSoA& bounds,
+    std::vector<std::uint8_t>& outVisible
+) {
+    const std::size_t count = bounds.size();
+    outVisible.resize(count);
+    std::size_t index = 0;
+
+#if defined(ODAI_CULLING_SSE2)
+    const __m128 zero = _mm_setzero_ps();
+    for (; index + 4 <= count; index += 4) {
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const std::array<float, 4>& plane : frustum.planes) {
+            const float* xs = plane[0] >= 0.0f ? bounds.maxX.data() : bounds.minX.data();
+            const float* ys = plane[1] >= 0.0f ? bounds.maxY.data() : bounds.minY.data();
+            const float* zs = plane[2] >= 0.0f ? bounds.maxZ.data() : bounds.minZ.data();
+            __m128 distance = _mm_mul_ps(_mm_set1_ps(plane[0]), _mm_loadu_ps(xs + index));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane[1]), _mm_loadu_ps(ys + index)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane[2]), _mm_loadu_ps(zs + index)));
+            distance = _mm_add_ps(distance, _mm_set1_ps(plane[3]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+        }
+        const int laneMask = _mm_movemask_ps(inside);
+        outVisible[index + 0] = static_cast<std::uint8_t>((laneMask >> 0) & 1);
+        outVisible[index + 1] = static_cast<std::uint8_t>((laneMask >> 1) & 1);
+        outVisible[index + 2] = static_cast<std::uint8_t>((laneMask >> 2) & 1);
+        outVisible[index + 3] = static_cast<std::uint8_t>((laneMask >> 3) & 1);
+    }
+#endif
+
+    for (; index < count; ++index) {
+        const bool visible = frustumIntersectsBounds(
+            frustum,
+            odai::math::Vector3{bounds.minX[index], bounds.minY[index], bounds.minZ[index]},
+            odai::math::Vector3{bounds.maxX[index], bounds.maxY[index], bounds.maxZ[index]}
+        );
+        outVisible[index] = visible ? 1u : 0u;
+    }
+}
+
+OcclusionDepthBuffer::OcclusionDepthBuffer(int width, int height)
+    : m_width(std::max(width, 1)),
+      m_height(std::max(height, 1)) {
+    int levelWidth = m_width;
+    int levelHeight = m_height;
+    std::size_t offset = 0;
+    while (true) {
+        m_levels.push_back(Level{levelWidth, levelHeight, offset});
+        offset += static_cast<std::size_t>(levelWidth) * static_cast<std::size_t>(levelHeight);
+        if (levelWidth == 1 && levelHeight == 1) {
+            break;
+        }
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+    m_depth.assign(offset, 1.0f);
+}
+
+void OcclusionDepthBuffer::begin(const odai::math::Matrix4& clipFromWorld, const odai::math::Vector3& eye) {
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+    m_clipFromWorld = clipFromWorld;
+    m_eye = eye;
+    m_rasterizedOccluderCount = 0;
+    m_hierarchyBuilt = false;
+}
+
+bool OcclusionDepthBuffer::rasterizeOccluderBox(
+    const odai::math::Vector3& boundsMin,
+    const odai::math::Vector3& boundsMax
+) {
+    m_hierarchyBuilt = false;
+    if (m_eye.x >= boundsMin.x && m_eye.x <= boundsMax.x &&
+        m_eye.y >= boundsMin.y && m_eye.y <= boundsMax.y &&
+        m_eye.z >= boundsMin.z && m_eye.z <= boundsMax.z) {
+        return false;
+    }
+
+    std::array<ProjectedPoint, 8> corners{};
+    if (!projectBoxCorners(m_clipFromWorld, boundsMin, boundsMax, m_width, m_height, corners)) {
+        return false;
+    }
+
+    // Along any ray through the silhouette, the box surface is where the ray
+    // crosses the last front-facing plane, so the front surface depth is the
+    // max of the front faces' plane depths. Each plane is affine in pixel
+    // space, so its max over a pixel lies on one of the pixel's corners.
+    std::array<DepthPlane, 3> planes{};
+    std::size_t planeCount = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        int side = -1;
+        if (axisValue(m_eye, axis) < axisValue(boundsMin, axis)) {
+            side = 0;
+        } else if (axisValue(m_eye, axis) > axisValue(boundsMax, axis)) {
+            side = 1;
+        } else {
+            continue;
+        }
+        const int axisU = (axis + 1) % 3;
+        const int axisV = (axis + 2) % 3;
+        // A zero-area face (flat occluders such as terrain quads) is never
+        // the entry face of a ray that hits the box interior.
+        if (!(axisValue(boundsMax, axisU) > axisValue(boundsMin, axisU)) ||
+            !(axisValue(boundsMax, axisV) > axisValue(boundsMin, axisV))) {
+            continue;
+        }
+        const int sideBits = side << axis;
+        const ProjectedPoint& p0 = corners[static_cast<std::size_t>(sideBits)];
+        const ProjectedPoint& p1 = corners[static_cast<std::size_t>(sideBits | (1 << axisU))];
+        const ProjectedPoint& p2 = corners[static_cast<std::size_t>(sideBits | (1 << axisV))];
+        const double e1x = p1.x - p0.x;
+        const double e1y = p1.y - p0.y;
+        const double e1z = p1.z - p0.z;
+        const double e2x = p2.x - p0.x;
+        const double e2y = p2.y - p0.y;
+        const double e2z = p2.z - p0.z;
+        const double nx = (e1y * e2z) - (e1z * e2y);
+        const double ny = (e1z * e2x) - (e1x * e2z);
+        const double nz = (e1x * e2y) - (e1y * e2x);
+        if (std::abs(nz) <= 1e-9 * (std::abs(nx) + std::abs(ny) + std::abs(nz))) {
+            // Seen edge-on: the face still bounds the surface, but its depth
+            // plane is unusable, so skip the whole box rather than guess.
+            return false;
+        }
+        DepthPlane& plane = planes[planeCount++];
+        plane.a = -nx / nz;
+        plane.b = -ny / nz;
+        plane.c = p0.z - (plane.a * p0.x) - (plane.b * p0.y);
+    }
+    if (planeCount == 0) {
+        return false;
+    }
+
+    std::array<ProjectedPoint, 16> hull{};
+    const std::size_t hullCount = convexHull(corners, hull);
+    if (hullCount < 3) {
+        return false;
+    }
+
+    double hullMinX = hull[0].x;
+    double hullMaxX = hull[0].x;
+    double hullMinY = hull[0].y;
+    double hullMaxY = hull[0].y;
+    for (std::size_t i = 1; i < hullCount; ++i) {
+        hullMinX = std::min(hullMinX, hull[i].x);
+        hullMaxX = std::max(hullMaxX, hull[i].x);
+        hullMinY = std::min(hullMinY, hull[i].y);
+        hullMaxY = std::max(hullMaxY, hull[i].y);
+    }
+    if (hullMaxX <= 0.0 || hullMinX >= static_cast<double>(m_width) ||
+        hullMaxY <= 0.0 || hullMinY >= static_cast<double>(m_height)) {
+        return false;
+    }
+
+    const int rowBegin = std::max(0, static_cast<int>(std::floor(hullMinY)));
+    const int rowEnd = std::min(m_height, static_cast<int>(std::ceil(hullMaxY)));
+    float* depth = m_depth.data();
+    for (int py = rowBegin; py < rowEnd; ++py) {
+        // A pixel is written only when all four of its corners are inside
+        // every hull edge. Each edge's worst corner is fixed by the edge
+        // direction, which turns the test into an interval on px.
+        double spanBegin = std::max(0.0, std::floor(hullMinX));
+        double spanEnd = std::min(static_cast<double>(m_width - 1), std::ceil(hullMaxX) - 1.0);
+        for (std::size_t i = 0; i < hullCount && spanBegin <= spanEnd; ++i) {
+            const ProjectedPoint& a = hull[i];
+            const ProjectedPoint& b = hull[(i + 1) % hullCount];
+            const double ex = b.x - a.x;
+            const double ey = b.y - a.y;
+            // edge(x, y) = ex * (y - a.y) - ey * (x - a.x) >= 0 inside.
+            const double cornerY = static_cast<double>(py) + (ex < 0.0 ? 1.0 : 0.0);
+            const double cornerDx = ey > 0.0 ? 1.0 : 0.0;
+            const double rhs = (ex * (cornerY - a.y)) + (ey * a.x) - (ey * cornerDx);
+            // Inside iff ey * px <= rhs.
+            if (ey > 0.0) {
+                spanEnd = std::min(spanEnd, std::floor(rhs / ey));
+            } else if (ey < 0.0) {
+                spanBegin = std::max(spanBegin, std::ceil(rhs / ey));
+            } else if (rhs < 0.0) {
+                spanBegin = spanEnd + 1.0;
+            }
+        }
+        if (spanBegin > spanEnd) {
+            continue;
+        }
+
+        float* row = depth + (static_cast<std::size_t>(py) * static_cast<std::size_t>(m_width));
+        const int pxBegin = static_cast<int>(spanBegin);
+        const int pxEnd = static_cast<int>(spanEnd);
+        for (int px = pxBegin; px <= pxEnd; ++px) {
+            double surfaceDepth = 0.0;
+            for (std::size_t planeIndex = 0; planeIndex < planeCount; ++planeIndex) {
+                const DepthPlane& plane = planes[planeIndex];
+                const double x = static_cast<double>(px) + (plane.a > 0.0 ? 1.0 : 0.0);
+                const double y = static_cast<double>(py) + (plane.b > 0.0 ? 1.0 : 0.0);
+                surfaceDepth = std::max(surfaceDepth, (plane.a * x) + (plane.b * y) + plane.c);
+            }
+            if (surfaceDepth >= 1.0) {
+                continue;
+            }
+            // Round up so float storage never moves the occluder closer.
+            float stored = static_cast<float>(surfaceDepth);
+            if (static_cast<double>(stored) < surfaceDepth) {
+                stored = std::nextafter(stored, 2.0f);
+            }
+            row[px] = std::min(row[px], stored);
+        }
+    }
+
+    ++m_rasterizedOccluderCount;
+    return true;
+}
+
+void OcclusionDepthBuffer::buildHierarchy() {
+    for (std::size_t levelIndex = 1; levelIndex < m_levels.size(); ++levelIndex) {
+        const Level& source = m_levels[levelIndex - 1];
+        const Level& target = m_levels[levelIndex];
+        const float* sourceDepth = m_depth.data() + source.offset;
+        float* targetDepth = m_depth.data() + target.offset;
+        for (int y = 0; y < target.height; ++y) {
+            const int sy0 = y * 2;
+            const int sy1 = std::min(sy0 + 1, source.height - 1);
+            for (int x = 0; x < target.width; ++x) {
+                const int sx0 = x * 2;
+                const int sx1 = std::min(sx0 + 1, source.width - 1);
+                const float top = std::max(
+                    sourceDepth[(static_cast<std::size_t>(sy0) * source.width) + sx0],
+                    sourceDepth[(static_cast<std::size_t>(sy0) * source.width) + sx1]);
+                const float bottom = std::max(
+                    sourceDepth[(static_cast<std::size_t>(sy1) * source.width) + sx0],
+                    sourceDepth[(static_cast<std::size_t>(sy1) * source.width) + sx1]);
+                targetDepth[(static_cast<std::size_t>(y) * target.width) + x] = std::max(top, bottom);
+            }
+        }
+    }
+    m_hierarchyBuilt = true;
+}
+
+bool OcclusionDepthBuffer::isOccluded(
+    const odai::math::Vector3& boundsMin,
+    const odai::math::Vector3& boundsMax
+) const {
+    if (!m_hierarchyBuilt || m_rasterizedOccluderCount == 0) {
+        return false;
+    }
+    std::array<ProjectedPoint, 8> corners{};
+    if (!projectBoxCorners(m_clipFromWorld, boundsMin, boundsMax, m_width, m_height, corners)) {
+        return false;
+    }
+
+    double nearestDepth = corners[0].z;
+    double rectMinX = corners[0].x;
+    double rectMaxX = corners[0].x;
+    double rectMinY = corners[0].y;
+    double rectMaxY = corners[0].y;
+    for (const ProjectedPoint& corner : corners) {
+        nearestDepth = std::min(nearestDepth, corner.z);
+        rectMinX = std::min(rectMinX, corner.x);
+        rectMaxX = std::max(rectMaxX, corner.x);
+        rectMinY = std::min(rectMinY, corner.y);
+        rectMaxY = std::max(rectMaxY, corner.y);
+    }
+    if (rectMaxX < 0.0 || rectMinX > static_cast<double>(m_width) ||
+        rectMaxY < 0.0 || rectMinY > static_cast<double>(m_height)) {
+        return false;
+    }
+
+    const int x0 = std::clamp(static_cast<int>(std::floor(rectMinX)), 0, m_width - 1);
+    const int x1 = std::clamp(static_cast<int>(std::floor(rectMaxX)), 0, m_width - 1);
+    const int y0 = std::clamp(static_cast<int>(std::floor(rectMinY)), 0, m_height - 1);
+    const int y1 = std::clamp(static_cast<int>(std::floor(rectMaxY)), 0, m_height - 1);
+
+    // Climb until the rectangle spans at most 4x4 texels; a texel at level L
+    // holds the max depth of the level-0 pixels whose index >> L lands on it.
+    std::size_t levelIndex = 0;
+    while (levelIndex + 1 < m_levels.size() &&
+           (((x1 >> levelIndex) - (x0 >> levelIndex)) > 3 || ((y1 >> levelIndex) - (y0 >> levelIndex)) > 3)) {
+        ++levelIndex;
+    }
+    const Level& level = m_levels[levelIndex];
+    const float* levelDepth = m_depth.data() + level.offset;
+    const int shift = static_cast<int>(levelIndex);
+    for (int y = y0 >> shift; y <= (y1 >> shift); ++y) {
+        for (int x = x0 >> shift; x <= (x1 >> shift); ++x) {
+            const float occluderDepth = levelDepth[(static_cast<std::size_t>(y) * level.width) + x];
+            if (static_cast<double>(occluderDepth) >= nearestDepth) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+float OcclusionDepthBuffer::depthAt(int level, int x, int y) const {
+    if (level < 0 || level >= levelCount()) {
+        return 1.0f;
+    }
+    const Level& info = m_levels[static_cast<std::size_t>(level)];
+    if (x < 0 || y < 0 || x >= info.width || y >= info.height) {
+        return 1.0f;
+    }
+    return m_depth[info.offset + (static_cast<std::size_t>(y) * info.width) + x];
+}
+
+void appendChunkOccluderBoxes(const odai::world::Chunk& chunk, std::vector<OccluderBox>& outBoxes) {
+    using odai::world::Chunk;
+    constexpr int kColumnsX = Chunk::kMacroSizeX;
+    constexpr int kColumnsZ = Chunk::kMacroSizeZ;
+
+    std::array<int, static_cast<std::size_t>(kColumnsX * kColumnsZ)> solidHeight{};
+    bool anySolid = false;
+    for (int mz = 0; mz < kColumnsZ; ++mz) {
+        for (int mx = 0; mx < kColumnsX; ++mx) {
+            int height = 0;
+            while (height < Chunk::kMacroSizeY && isOpaqueSolidCell(chunk.macroCellAt(mx, height, mz))) {
+                ++height;
+            }
+            solidHeight[static_cast<std::size_t>(mx + (mz * kColumnsX))] = height;
+            anySolid = anySolid || height > 0;
+        }
+    }
+    if (!anySolid) {
+        return;
+    }
+
+    struct Run {
+        int x0 = 0;
+        int x1 = 0;
+        int z0 = 0;
+        int z1 = 0;
+        int height = 0;
+    };
+    std::array<Run, static_cast<std::size_t>(kColumnsX * kColumnsZ)> runs{};
+    std::size_t runCount = 0;
+    for (int mz = 0; mz < kColumnsZ; ++mz) {
+        int mx = 0;
+        while (mx < kColumnsX) {
+            const int height = solidHeight[static_cast<std::size_t>(mx + (mz * kColumnsX))];
+            int runEnd = mx + 1;
+            while (runEnd < kColumnsX && solidHeight[static_cast<std::size_t>(runEnd + (mz * kColumnsX))] == height) {
+                ++runEnd;
+            }
+            if (height > 0) {
+                bool merged = false;
+                for (std::size_t i = 0; i < runCount; ++i) {
+                    Run& run = runs[i];
+                    if (run.z1 == mz && run.x0 == mx && run.x1 == runEnd && run.height == height) {
+                        run.z1 = mz + 1;
+                        merged = true;
+                        break;
+                    }
+                }
+                if (!merged) {
+                    runs[runCount++] = Run{mx, runEnd, mz, mz + 1, height};
+                }
+            }
+            mx = runEnd;
+        }
+    }
+
+    const float originX = static_cast<float>(chunk.chunkX() * Chunk::kSizeX);
+    const float originY = static_cast<float>(chunk.chunkY() * Chunk::kSizeY);
+    const float originZ = static_cast<float>(chunk.chunkZ() * Chunk::kSizeZ);
+    constexpr float kCellSize = static_cast<float>(Chunk::kMacroVoxelSize);
+    for (std::size_t i = 0; i < runCount; ++i) {
+        const Run& run = runs[i];
+        outBoxes.push_back(OccluderBox{
+            odai::math::Vector3{
+                originX + (static_cast<float>(run.x0) * kCellSize),
+                originY,
+                originZ + (static_cast<float>(run.z0) * kCellSize)
+            },
+            odai::math::Vector3{
+                originX + (static_cast<float>(run.x1) * kCellSize),
+                originY + (static_cast<float>(run.height) * kCellSize),
+                originZ + (static_cast<float>(run.z1) * kCellSize)
+            }
+        });
+    }
+}
+
+VisibilityCuller::VisibilityCuller(int depthWidth, int depthHeight)
+    : m_depthBuffer(depthWidth, depthHeight) {}
+
+void VisibilityCuller::cullChunks(
+    std::span<const odai::world::Chunk> chunks,
+    std::span<const std::size_t> candidateChunkIndices,
+    const odai::math::Matrix4& clipFromWorld,
+    const odai::math::Vector3& eye,
+    std::vector<std::size_t>& outVisibleChunkIndices,
+    odai::world::SpatialQueryStats& stats
+) {
+    using odai::world::Chunk;
+    outVisibleChunkIndices.clear();
+    const bool allChunks = candidateChunkIndices.empty();
+    const std::size_t candidateCount = allChunks ? chunks.size() : candidateChunkIndices.size();
+
+    m_candidateChunkIndices.clear();
+    m_candidateChunkIndices.reserve(candidateCount);
+    m_bounds.clear();
+    m_bounds.reserve(candidateCount);
+    for (std::size_t i = 0; i < candidateCount; ++i) {
+        const std::size_t chunkIndex = allChunks ? i : candidateChunkIndices[i];
+        if (chunkIndex >= chunks.size()) {
+            continue;
+        }
+        const Chunk& chunk = chunks[chunkIndex];
+        const odai::math::Vector3 boundsMin{
+            static_cast<float>(chunk.chunkX() * Chunk::kSizeX),
+            static_cast<float>(chunk.chunkY() * Chunk::kSizeY),
+            static_cast<float>(chunk.chunkZ() * Chunk::kSizeZ)
+        };
+        m_candidateChunkIndices.push_back(chunkIndex);
+        m_bounds.push(
+            boundsMin,
+            boundsMin + odai::math::Vector3{
+                static_cast<float>(Chunk::kSizeX),
+                static_cast<float>(Chunk::kSizeY),
+                static_cast<float>(Chunk::kSizeZ)
+            }
+        );
+    }
+
+    frustumTestBounds(extractCullFrustum(clipFromWorld), m_bounds, m_frustumVisible);
+
+    bool occlusionReady = false;
+    if (m_settings.occlusionEnabled) {
+        const int eyeChunkX = floorDivide(eye.x, Chunk::kSizeX);
+        const int eyeChunkY = floorDivide(eye.y, Chunk::kSizeY);
+        const int eyeChunkZ = floorDivide(eye.z, Chunk::kSizeZ);
+        m_occluderOrder.clear();
+        for (std::size_t i = 0; i < m_candidateChunkIndices.size(); ++i) {
+            if (m_frustumVisible[i] == 0u) {
+                continue;
+            }
+            const Chunk& chunk = chunks[m_candidateChunkIndices[i]];
+            const int chunkDistance = std::max({
+                std::abs(chunk.chunkX() - eyeChunkX),
+                std::abs(chunk.chunkY() - eyeChunkY),
+                std::abs(chunk.chunkZ() - eyeChunkZ)
+            });
+            if (chunkDistance > m_settings.occluderChunkRadius) {
+                continue;
+            }
+            const odai::math::Vector3 boundsMin{m_bounds.minX[i], m_bounds.minY[i], m_bounds.minZ[i]};
+            const odai::math::Vector3 boundsMax{m_bounds.maxX[i], m_bounds.maxY[i], m_bounds.maxZ[i]};
+            m_occluderOrder.emplace_back(distanceSquaredToBounds(eye, boundsMin, boundsMax), i);
+        }
+        std::sort(m_occluderOrder.begin(), m_occluderOrder.end());
+
+        m_occluderBoxes.clear();
+        for (const auto& [distanceSquared, candidateIndex] : m_occluderOrder) {
+            (void)distanceSquared;
+            if (m_occluderBoxes.size() >= m_settings.maxOccluderBoxes) {
+                break;
+            }
+            appendChunkOccluderBoxes(chunks[m_candidateChunkIndices[candidateIndex]], m_occluderBoxes);
+        }
+
+        m_depthBuffer.begin(clipFromWorld, eye);
+        for (const OccluderBox& box : m_occluderBoxes) {
+            m_depthBuffer.rasterizeOccluderBox(box.boundsMin, box.boundsMax);
+        }
+        m_depthBuffer.buildHierarchy();
+        stats.occluderCount += m_depthBuffer.rasterizedOccluderCount();
+        occlusionReady = m_depthBuffer.rasterizedOccluderCount() > 0;
+    }
+
+    outVisibleChunkIndices.reserve(m_candidateChunkIndices.size());
+    for (std::size_t i = 0; i < m_candidateChunkIndices.size(); ++i) {
+        if (m_frustumVisible[i] == 0u) {
+            ++stats.frustumCulledChunkCount;
+            continue;
+        }
+        if (occlusionReady &&
+            m_depthBuffer.isOccluded(
+                odai::math::Vector3{m_bounds.minX[i], m_bounds.minY[i], m_bounds.minZ[i]},
+                odai::math::Vector3{m_bounds.maxX[i], m_bounds.maxY[i], m_bounds.maxZ[i]})) {
+            ++stats.occlusionCulledChunkCount;
+            continue;
+        }
+        outVisibleChunkIndices.push_back(m_candidateChunkIndices[i]);
+    }
+}
+
+void VisibilityCuller::cullPages(
+    const CullBoundsSoA& pageBounds,
+    std::span<const std::uint8_t> terrainPageMask,
+    const odai::math::Matrix4& clipFromWorld,
+    const odai::math::Vector3& eye,
+    float clipMargin,
+    std::vector<std::uint8_t>& outVisible,
+    odai::world::SpatialQueryStats& stats
+) {
+    frustumTestBounds(extractCullFrustum(clipFromWorld, clipMargin), pageBounds, outVisible);
+
+    bool occlusionReady = false;
+    if (m_settings.occlusionEnabled) {
+        m_occluderOrder.clear();
+        for (std::size_t i = 0; i < pageBounds.size(); ++i) {
+            if (outVisible[i] == 0u || i >= terrainPageMask.size() || terrainPageMask[i] == 0u) {
+                continue;
+            }
+            // From below, the page's lowest point says nothing about what
+            // its surface hides.
+            if (!(eye.y > pageBounds.minY[i])) {
+                continue;
+            }
+            const odai::math::Vector3 boundsMin{pageBounds.minX[i], pageBounds.minY[i], pageBounds.minZ[i]};
+            const odai::math::Vector3 boundsMax{pageBounds.maxX[i], pageBounds.maxY[i], pageBounds.maxZ[i]};
+            m_occluderOrder.emplace_back(distanceSquaredToBounds(eye, boundsMin, boundsMax), i);
+        }
+        std::sort(m_occluderOrder.begin(), m_occluderOrder.end());
+        if (m_occluderOrder.size() > m_settings.maxOccluderPages) {
+            m_occluderOrder.resize(m_settings.maxOccluderPages);
+        }
+
+        m_depthBuffer.begin(clipFromWorld, eye);
+        for (const auto& [distanceSquared, pageIndex] : m_occluderOrder) {
+            (void)distanceSquared;
+            m_depthBuffer.rasterizeOccluderBox(
+                odai::math::Vector3{pageBounds.minX[pageIndex], pageBounds.minY[pageIndex], pageBounds.minZ[pageIndex]},
+                odai::math::Vector3{pageBounds.maxX[pageIndex], pageBounds.minY[pageIndex], pageBounds.maxZ[pageIndex]}
+            );
+        }
+        m_depthBuffer.buildHierarchy();
+        stats.occluderCount += m_depthBuffer.rasterizedOccluderCount();
+        occlusionReady = m_depthBuffer.rasterizedOccluderCount() > 0;
+    }
+
+    for (std::size_t i = 0; i < pageBounds.size(); ++i) {
+        if (outVisible[i] == 0u) {
+            ++stats.frustumCulledPageCount;
+            continue;
+        }
+        if (occlusionReady &&
+            m_depthBuffer.isOccluded(
+                odai::math::Vector3{pageBounds.minX[i], pageBounds.minY[i], pageBounds.minZ[i]},
+                odai::math::Vector3{pageBounds.maxX[i], pageBounds.maxY[i], pageBounds.maxZ[i]})) {
+            outVisible[i] = 0u;
+            ++stats.occlusionCulledPageCount;
+        }
+    }
+}
+
+}  // namespace odai::render
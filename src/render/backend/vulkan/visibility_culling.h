@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "math/math.h"
+#include "world/chunk.h"
+#include "world/spatial_index.h"
+
+// CPU visibility culling for voxel chunks and imported-scene pages. Bounds are
+// first tested against the view frustum in structure-of-arrays form, then the
+// survivors are tested against a low-resolution software depth buffer holding
+// only large, known-opaque occluders (solid chunk cells, terrain pages),
+// reduced into a max-depth (Hi-Z) pyramid. Renderer-agnostic and headless.
+//
+// Matrices follow the renderer: row-major, clip = M * p, Vulkan depth with
+// near -> 0 and far -> 1.
+namespace odai::render {
+
+struct CullBoundsSoA {
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> minZ;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<float> maxZ;
+
+    std::size_t size() const { return minX.size(); }
+    void clear();
+    void reserve(std::size_t count);
+    void push(const odai::math::Vector3& boundsMin, const odai::math::Vector3& boundsMax);
+};
+
+// Six planes (a, b, c, d), inside where a*x + b*y + c*z + d >= 0.
+struct CullFrustum {
+    std::array<std::array<float, 4>, 6> planes{};
+};
+
+// clipMargin widens the accepted clip volume in NDC units:
+// |ndc.xy| <= 1 + margin and -margin <= ndc.z <= 1 + margin.
+CullFrustum extractCullFrustum(const odai::math::Matrix4& clipFromWorld, float clipMargin = 0.0f);
+
+bool frustumIntersectsBounds(
+    const CullFrustum& frustum,
+    const odai::math::Vector3& boundsMin,
+    const odai::math::Vector3& boundsMax
+);
+
+// outVisible[i] = 1 when box i touches the frustum. Four boxes per step on
+// SSE2; the result matches frustumIntersectsBounds box for box.
+void frustumTestBounds(
+    const CullFrustum& frustum,
+    const CullBoundsSoA& bounds,
+    std::vector<std::uint8_t>& outVisible
+);
+
+struct OccluderBox {
+    odai::math::Vector3 boundsMin;
+    odai::math::Vector3 boundsMax;
+};
+
+// Max-depth buffer for occlusion queries. Occluder pixels are written only
+// where the box silhouette covers the whole pixel, with the farthest depth of
+// the box's front surface over that pixel, so a query can only report
+// "occluded" for bounds that really are hidden behind occluder geometry.
+class OcclusionDepthBuffer {
+public:
+    static constexpr int kDefaultWidth = 256;
+    static constexpr int kDefaultHeight = 128;
+
+    explicit OcclusionDepthBuffer(int width = kDefaultWidth, int height = kDefaultHeight);
+
+    // Clears to the far plane. eye is the camera position in world space.
+    void begin(const odai::math::Matrix4& clipFromWorld, const odai::math::Vector3& eye);
+    // Returns false when the box was skipped: off screen, crossing the near
+    // plane, containing the eye, or seen exactly edge-on.
+    bool rasterizeOccluderBox(const odai::math::Vector3& boundsMin, const odai::math::Vector3& boundsMax);
+    // Reduces level 0 into the max-depth pyramid. Call after the last
+    // occluder and before isOccluded().
+    void buildHierarchy();
+    bool isOccluded(const odai::math::Vector3& boundsMin, const odai::math::Vector3& boundsMax) const;
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    int levelCount() const { return static_cast<int>(m_levels.size()); }
+    float depthAt(int level, int x, int y) const;
+    std::uint32_t rasterizedOccluderCount() const { return m_rasterizedOccluderCount; }
+
+private:
+    struct Level {
+        int width = 0;
+        int height = 0;
+        std::size_t offset = 0;
+    };
+
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<Level> m_levels;
+    std::vector<float> m_depth;
+    odai::math::Matrix4 m_clipFromWorld{};
+    odai::math::Vector3 m_eye{};
+    std::uint32_t m_rasterizedOccluderCount = 0;
+    bool m_hierarchyBuilt = false;
+};
+
+// Boxes covering the chunk's fully solid, opaque macro cells: each macro
+// column contributes its solid run from the chunk floor up, and equal runs
+// are merged along x, then z. An all-solid chunk yields a single box.
+void appendChunkOccluderBoxes(const odai::world::Chunk& chunk, std::vector<OccluderBox>& outBoxes);
+
+class VisibilityCuller {
+public:
+    struct Settings {
+        bool occlusionEnabled = true;
+        // Only chunks within this Chebyshev distance (in chunks) of the camera
+        // contribute occluders; farther ones cover too few depth pixels.
+        int occluderChunkRadius = 3;
+        std::size_t maxOccluderBoxes = 192;
+        std::size_t maxOccluderPages = 32;
+    };
+
+    VisibilityCuller() = default;
+    VisibilityCuller(int depthWidth, int depthHeight);
+
+    Settings& settings() { return m_settings; }
+    const Settings& settings() const { return m_settings; }
+    const OcclusionDepthBuffer& depthBuffer() const { return m_depthBuffer; }
+
+    // Filters candidateChunkIndices (every chunk when empty) down to the
+    // chunks that survive frustum and occlusion culling, in input order.
+    // Culled and occluder counts are added to stats.
+    void cullChunks(
+        std::span<const odai::world::Chunk> chunks,
+        std::span<const std::size_t> candidateChunkIndices,
+        const odai::math::Matrix4& clipFromWorld,
+        const odai::math::Vector3& eye,
+        std::vector<std::size_t>& outVisibleChunkIndices,
+        odai::world::SpatialQueryStats& stats
+    );
+
+    // outVisible[i] = 1 for pages that survive both tests. Pages flagged in
+    // terrainPageMask are heightfields; each one seen from above occludes
+    // what lies below its lowest point, so it contributes a horizontal quad
+    // at boundsMin.y over its footprint as an occluder.
+    void cullPages(
+        const CullBoundsSoA& pageBounds,
+        std::span<const std::uint8_t> terrainPageMask,
+        const odai::math::Matrix4& clipFromWorld,
+        const odai::math::Vector3& eye,
+        float clipMargin,
+        std::vector<std::uint8_t>& outVisible,
+        odai::world::SpatialQueryStats& stats
+    );
+
+private:
+    Settings m_settings{};
+    OcclusionDepthBuffer m_depthBuffer{};
+    CullBoundsSoA m_bounds;
+    std::vector<std::size_t> m_candidateChunkIndices;
+    std::vector<std::uint8_t> m_frustumVisible;
+    std::vector<OccluderBox> m_occluderBoxes;
+    std::vector<std::pair<float, std::size_t>> m_occluderOrder;
+};
+
+}  // namespace odai::render
@@ -96,6 +96,10 @@ bool Renderer::uploadChunkMeshes(const odai::world::ChunkGrid& chunkGrid, std::v
     return m_backend->uploadChunkMeshes(chunkGrid, std::move(results));
 }
 
+void Renderer::setChunkMeshBufferPool(odai::world::ChunkMeshBufferPool* pool) {
+    m_backend->setChunkMeshBufferPool(pool);
+}
+
 odai::world::MeshingOptions Renderer::chunkMeshingOptions() const {
     return m_backend->chunkMeshingOptions();
 }
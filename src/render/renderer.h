@@ -78,6 +78,10 @@ public:
     // Queue meshes built off the render thread (world::ChunkMeshScheduler) for
     // upload on the next frame; the renderer skips its inline mesher for them.
     bool uploadChunkMeshes(const odai::world::ChunkGrid& chunkGrid, std::vector<odai::world::ChunkMeshResult> results);
+    // Pool that uploaded meshes are returned to once a newer mesh replaces
+    // them (world::ChunkMeshScheduler::bufferPool()). Must outlive the renderer's
+    // use of it; pass nullptr to detach.
+    void setChunkMeshBufferPool(odai::world::ChunkMeshBufferPool* pool);
     // Meshing mode the renderer's own full-rebuild path uses; mirror it in any
     // off-thread mesher so both paths produce the same geometry.
     [[nodiscard]] odai::world::MeshingOptions chunkMeshingOptions() const;
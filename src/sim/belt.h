@@ -1,5 +1,7 @@
 #pragma once
 
+#include "sim/network_graph.h"
+
 // Simulation Belt subsystem
 // Responsible for: representing a transport machine placeholder in the simulation.
 // Should NOT do: move items, resolve collisions, or interact with rendering yet.
@@ -21,6 +23,9 @@ public:
     int y = 0;
     int z = 0;
     BeltDirection direction = BeltDirection::North;
+    // Lanes, speed tier and item spacing; see Simulation::addBelt(). Free
+    // flow by default, like Simulation::setDefaultBeltEdgeData().
+    BeltEdgeData edge{.slotSpacingQ8 = 0};
 };
 
 inline Belt::Belt(int xIn, int yIn, int zIn, BeltDirection directionIn)
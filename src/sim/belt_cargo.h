@@ -10,8 +10,13 @@ namespace odai::sim {
 struct BeltCargo {
     std::uint32_t itemId = 0;
     std::uint16_t typeId = 0;
+    // Index into Simulation::belts(); beltId stays the same while belts
+    // around this one are placed and removed.
     std::int32_t beltIndex = -1;
+    std::uint32_t beltId = 0;
     std::uint32_t alongQ16 = 0;
+    // 0 is the leftmost lane facing the belt direction.
+    std::uint8_t lane = 0;
     float prevWorldPos[3] = {0.0f, 0.0f, 0.0f};
     float currWorldPos[3] = {0.0f, 0.0f, 0.0f};
 };
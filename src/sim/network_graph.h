@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <span>
 #include <vector>
 
 #include "core/grid3.h"
@@ -64,6 +65,14 @@ struct NetworkEdge {
     std::uint16_t typeId = 0;
 };
 
+// Node -> edge adjacency in compressed sparse row form: the edges touching
+// node n are edgeIds[offsets[n], offsets[n + 1]), ascending. A self-loop is
+// listed once.
+struct NetworkAdjacency {
+    std::vector<std::uint32_t> offsets;
+    std::vector<EdgeId> edgeIds;
+};
+
 class NetworkGraph {
 public:
     NodeId addNode(const Socket& socket);
@@ -74,19 +83,29 @@ public:
     std::size_t edgeCount() const;
     const std::vector<NetworkNode>& nodes() const;
     const std::vector<NetworkEdge>& edges() const;
-    const std::vector<EdgeId>& edgesForNode(NodeId nodeId) const;
+    std::span<const EdgeId> edgesForNode(NodeId nodeId) const;
     bool edgeConnectsNode(EdgeId edgeId, NodeId nodeId) const;
+    // Bumped by every addNode/addEdge/clear, so caches built from the graph
+    // (solver snapshots) know when to rebuild.
+    std::uint64_t topologyVersion() const;
+    // Kept current by addNode/addEdge/clear, so const readers never write
+    // and may run concurrently. addEdge shifts the rows after its endpoints.
+    const NetworkAdjacency& adjacency() const;
 
 private:
+    void appendToAdjacencyRow(NodeId nodeId, EdgeId edgeId);
+
     std::vector<NetworkNode> m_nodes;
     std::vector<NetworkEdge> m_edges;
-    std::vector<std::vector<EdgeId>> m_nodeEdges;
+    std::uint64_t m_topologyVersion = 0;
+    NetworkAdjacency m_adjacency{.offsets = {0u}, .edgeIds = {}};
 };
 
 inline NodeId NetworkGraph::addNode(const Socket& socket) {
     const NodeId id = static_cast<NodeId>(m_nodes.size());
     m_nodes.push_back(NetworkNode{socket});
-    m_nodeEdges.emplace_back();
+    m_adjacency.offsets.push_back(m_adjacency.offsets.back());
+    ++m_topologyVersion;
     return id;
 }
 
@@ -97,17 +116,29 @@ inline EdgeId NetworkGraph::addEdge(NodeId a, NodeId b, const EdgeSpan& span, Ne
 
     const EdgeId id = static_cast<EdgeId>(m_edges.size());
     m_edges.push_back(NetworkEdge{a, b, span, kind, typeId});
-    m_nodeEdges[a].push_back(id);
+    appendToAdjacencyRow(a, id);
     if (b != a) {
-        m_nodeEdges[b].push_back(id);
+        appendToAdjacencyRow(b, id);
     }
+    ++m_topologyVersion;
     return id;
 }
 
 inline void NetworkGraph::clear() {
     m_nodes.clear();
     m_edges.clear();
-    m_nodeEdges.clear();
+    m_adjacency.offsets.assign(1u, 0u);
+    m_adjacency.edgeIds.clear();
+    ++m_topologyVersion;
+}
+
+inline void NetworkGraph::appendToAdjacencyRow(NodeId nodeId, EdgeId edgeId) {
+    // The new edge has the highest id, so it goes at the end of the row.
+    std::vector<std::uint32_t>& offsets = m_adjacency.offsets;
+    m_adjacency.edgeIds.insert(m_adjacency.edgeIds.begin() + offsets[nodeId + 1u], edgeId);
+    for (std::size_t row = static_cast<std::size_t>(nodeId) + 1u; row < offsets.size(); ++row) {
+        ++offsets[row];
+    }
 }
 
 inline std::size_t NetworkGraph::nodeCount() const {
@@ -126,12 +157,12 @@ inline const std::vector<NetworkEdge>& NetworkGraph::edges() const {
     return m_edges;
 }
 
-inline const std::vector<EdgeId>& NetworkGraph::edgesForNode(NodeId nodeId) const {
-    static const std::vector<EdgeId> kEmpty;
-    if (nodeId >= m_nodeEdges.size()) {
-        return kEmpty;
+inline std::span<const EdgeId> NetworkGraph::edgesForNode(NodeId nodeId) const {
+    if (nodeId >= m_nodes.size()) {
+        return {};
     }
-    return m_nodeEdges[nodeId];
+    const NetworkAdjacency& csr = adjacency();
+    return std::span<const EdgeId>(csr.edgeIds).subspan(csr.offsets[nodeId], csr.offsets[nodeId + 1u] - csr.offsets[nodeId]);
 }
 
 inline bool NetworkGraph::edgeConnectsNode(EdgeId edgeId, NodeId nodeId) const {
@@ -142,6 +173,14 @@ inline bool NetworkGraph::edgeConnectsNode(EdgeId edgeId, NodeId nodeId) const {
     return edge.a == nodeId || edge.b == nodeId;
 }
 
+inline std::uint64_t NetworkGraph::topologyVersion() const {
+    return m_topologyVersion;
+}
+
+inline const NetworkAdjacency& NetworkGraph::adjacency() const {
+    return m_adjacency;
+}
+
 struct PipeEdgeData {
     std::uint16_t diameterTier = 0;
     std::uint16_t fluidTypeId = 0;
@@ -150,9 +189,12 @@ struct PipeEdgeData {
 };
 
 struct BeltEdgeData {
+    // Items move (speedTier + 1) times the base belt speed.
     std::uint16_t speedTier = 0;
     std::uint8_t laneCount = 1;
     bool reversed = false;
+    // Closest two items in a lane may get, in Q8 voxels. Zero is free flow:
+    // items never queue and may overlap.
     std::uint16_t slotSpacingQ8 = 256;
 };
 
@@ -165,8 +207,14 @@ enum class RailSegmentClass : std::uint8_t {
 
 struct RailEdgeData {
     RailSegmentClass segmentClass = RailSegmentClass::Straight;
+    // Edges sharing a non-zero group are routes through one switch: only one
+    // of them may be reserved at a time.
     std::uint16_t switchGroupId = 0;
+    // Edges sharing a non-zero block are signalled as one block. Zero makes
+    // the edge a block of its own.
     std::uint16_t blockId = 0;
+    // Traversable a -> b only.
+    bool oneWay = false;
 };
 
 struct TrackParam {
@@ -0,0 +1,369 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/job_system.h"
+#include "core/parallel_for.h"
+#include "sim/network_graph.h"
+
+// Simulation PipeFluidSolver subsystem
+// Responsible for: tick-based fluid transport over the pipe edges of a NetworkGraph.
+// Should NOT do: graph editing, fluid mixing between types, or rendering.
+namespace odai::sim {
+
+struct PipeFluidSettings {
+    // Fluid a junction holds when full; its fill level is its pressure.
+    std::uint32_t nodeBufferUnits = 1000;
+};
+
+struct PipeFluidTickStats {
+    std::uint64_t suppliedUnits = 0;
+    // Source output that did not fit into a full junction.
+    std::uint64_t blockedSupplyUnits = 0;
+    std::uint64_t drainedUnits = 0;
+    // Sink demand that an empty junction could not meet.
+    std::uint64_t unmetDemandUnits = 0;
+    std::uint64_t movedUnits = 0;
+};
+
+// Fluid lives in the nodes. Each tick, sources fill their node, every pipe
+// edge moves fluid from the fuller end to the emptier one, then sinks drain
+// their node. An edge moves (levelA - levelB) / (max(degreeA, degreeB) + 1)
+// units, capped by PipeEdgeData::capacityUnitsPerTick. The divisor keeps a
+// node from sending more than it holds and from being filled past its
+// fullest neighbour, so no clamping pass is needed and every unit is
+// conserved exactly. Pressure differences travel one edge per tick.
+//
+// The solver works on a snapshot of the graph: node and edge arrays grouped
+// by connected component, rebuilt only when the graph's topologyVersion()
+// changes. Components share nothing, so batches of them tick in parallel
+// with results identical to a serial tick.
+class PipeFluidSolver {
+public:
+    PipeFluidSolver() = default;
+    explicit PipeFluidSolver(const PipeFluidSettings& settings);
+
+    // Edges without data (or with zero capacity) carry nothing.
+    void setEdgeData(EdgeId edgeId, const PipeEdgeData& data);
+    // Positive: units added per tick (source). Negative: units removed per
+    // tick (sink).
+    void setNodeSupply(NodeId nodeId, std::int32_t unitsPerTick);
+    void setNodeUnits(NodeId nodeId, std::uint32_t units);
+
+    void tick(const NetworkGraph& graph, core::JobSystem* jobs = nullptr);
+
+    // Nodes added since the last tick report the units set on them until the
+    // next tick folds them into the snapshot.
+    std::uint32_t nodeUnits(NodeId nodeId) const;
+    std::uint64_t totalUnits() const;
+    // Indexed by EdgeId: inUnits moved a -> b last tick, outUnits b -> a.
+    const std::vector<PipeEdgeRuntimeState>& edgeStates() const;
+    const PipeFluidTickStats& lastTickStats() const;
+    std::size_t componentCount() const;
+    std::size_t snapshotBuildCount() const;
+
+private:
+    // Work per parallel batch, in nodes + edges; small components are packed
+    // together up to this size.
+    static constexpr std::size_t kBatchWork = 8192;
+
+    struct Component {
+        std::uint32_t nodeBegin = 0;
+        std::uint32_t nodeEnd = 0;
+        std::uint32_t edgeBegin = 0;
+        std::uint32_t edgeEnd = 0;
+    };
+
+    struct Batch {
+        std::uint32_t componentBegin = 0;
+        std::uint32_t componentEnd = 0;
+    };
+
+    void rebuildSnapshot(const NetworkGraph& graph);
+    PipeFluidTickStats tickComponent(const Component& component);
+
+    PipeFluidSettings m_settings{};
+    std::vector<PipeEdgeData> m_edgeData;
+    // Per NodeId, kept outside the snapshot so it survives rebuilds.
+    std::vector<std::int32_t> m_nodeSupply;
+    std::vector<std::uint32_t> m_nodeUnits;
+    std::vector<PipeEdgeRuntimeState> m_edgeStates;
+
+    // Snapshot: local node/edge slots ordered by component.
+    std::uint64_t m_snapshotVersion = 0;
+    bool m_snapshotValid = false;
+    std::size_t m_snapshotBuildCount = 0;
+    std::vector<NodeId> m_localNodeIds;
+    std::vector<std::uint32_t> m_localNodeByNodeId;
+    std::vector<std::uint32_t> m_localDegree;
+    std::vector<std::uint32_t> m_localLevel;
+    std::vector<EdgeId> m_localEdgeIds;
+    std::vector<std::uint32_t> m_localEdgeByEdgeId;
+    std::vector<std::uint32_t> m_localEdgeA;
+    std::vector<std::uint32_t> m_localEdgeB;
+    std::vector<std::uint32_t> m_localEdgeCapacity;
+    std::vector<std::int32_t> m_localEdgeFlow;
+    std::vector<Component> m_components;
+    std::vector<Batch> m_batches;
+    PipeFluidTickStats m_lastTickStats{};
+};
+
+inline PipeFluidSolver::PipeFluidSolver(const PipeFluidSettings& settings)
+    : m_settings(settings) {}
+
+inline void PipeFluidSolver::setEdgeData(EdgeId edgeId, const PipeEdgeData& data) {
+    if (edgeId >= m_edgeData.size()) {
+        m_edgeData.resize(static_cast<std::size_t>(edgeId) + 1u);
+    }
+    m_edgeData[edgeId] = data;
+    if (m_snapshotValid && edgeId < m_localEdgeByEdgeId.size() &&
+        m_localEdgeByEdgeId[edgeId] != kInvalidEdgeId) {
+        m_localEdgeCapacity[m_localEdgeByEdgeId[edgeId]] = data.capacityUnitsPerTick;
+    }
+}
+
+inline void PipeFluidSolver::setNodeSupply(NodeId nodeId, std::int32_t unitsPerTick) {
+    if (nodeId >= m_nodeSupply.size()) {
+        m_nodeSupply.resize(static_cast<std::size_t>(nodeId) + 1u, 0);
+    }
+    m_nodeSupply[nodeId] = unitsPerTick;
+}
+
+inline void PipeFluidSolver::setNodeUnits(NodeId nodeId, std::uint32_t units) {
+    units = std::min(units, m_settings.nodeBufferUnits);
+    if (m_snapshotValid && nodeId < m_localNodeByNodeId.size()) {
+        m_localLevel[m_localNodeByNodeId[nodeId]] = units;
+        return;
+    }
+    if (nodeId >= m_nodeUnits.size()) {
+        m_nodeUnits.resize(static_cast<std::size_t>(nodeId) + 1u, 0u);
+    }
+    m_nodeUnits[nodeId] = units;
+}
+
+inline void PipeFluidSolver::rebuildSnapshot(const NetworkGraph& graph) {
+    // Carry fill levels across the rebuild by NodeId.
+    if (m_snapshotValid) {
+        m_nodeUnits.resize(std::max(m_nodeUnits.size(), m_localNodeByNodeId.size()), 0u);
+        for (std::size_t local = 0; local < m_localNodeIds.size(); ++local) {
+            m_nodeUnits[m_localNodeIds[local]] = m_localLevel[local];
+        }
+    }
+
+    const std::size_t nodeCount = graph.nodeCount();
+    const std::vector<NetworkEdge>& edges = graph.edges();
+    const NetworkAdjacency& adjacency = graph.adjacency();
+    constexpr std::uint32_t kUnassigned = 0xFFFFFFFFu;
+    const auto carriesFluid = [&](EdgeId edgeId) {
+        const NetworkEdge& edge = edges[edgeId];
+        return edge.kind == NetworkKind::Pipe && edge.a != edge.b;
+    };
+
+    m_localNodeIds.clear();
+    m_localNodeIds.reserve(nodeCount);
+    m_localNodeByNodeId.assign(nodeCount, kUnassigned);
+    m_localEdgeIds.clear();
+    m_localEdgeByEdgeId.assign(edges.size(), kInvalidEdgeId);
+    m_components.clear();
+
+    // Breadth-first over the CSR rows; m_localNodeIds doubles as the queue,
+    // so each component's nodes come out contiguous.
+    for (NodeId seed = 0; seed < nodeCount; ++seed) {
+        if (m_localNodeByNodeId[seed] != kUnassigned) {
+            continue;
+        }
+        Component component{};
+        component.nodeBegin = static_cast<std::uint32_t>(m_localNodeIds.size());
+        component.edgeBegin = static_cast<std::uint32_t>(m_localEdgeIds.size());
+        m_localNodeByNodeId[seed] = static_cast<std::uint32_t>(m_localNodeIds.size());
+        m_localNodeIds.push_back(seed);
+        for (std::size_t cursor = component.nodeBegin; cursor < m_localNodeIds.size(); ++cursor) {
+            const NodeId nodeId = m_localNodeIds[cursor];
+            for (std::uint32_t slot = adjacency.offsets[nodeId]; slot < adjacency.offsets[nodeId + 1u]; ++slot) {
+                const EdgeId edgeId = adjacency.edgeIds[slot];
+                if (!carriesFluid(edgeId) || m_localEdgeByEdgeId[edgeId] != kInvalidEdgeId) {
+                    continue;
+                }
+                m_localEdgeByEdgeId[edgeId] = static_cast<std::uint32_t>(m_localEdgeIds.size());
+                m_localEdgeIds.push_back(edgeId);
+                const NetworkEdge& edge = edges[edgeId];
+                const NodeId other = (edge.a == nodeId) ? edge.b : edge.a;
+                if (m_localNodeByNodeId[other] == kUnassigned) {
+                    m_localNodeByNodeId[other] = static_cast<std::uint32_t>(m_localNodeIds.size());
+                    m_localNodeIds.push_back(other);
+                }
+            }
+        }
+        component.nodeEnd = static_cast<std::uint32_t>(m_localNodeIds.size());
+        component.edgeEnd = static_cast<std::uint32_t>(m_localEdgeIds.size());
+        m_components.push_back(component);
+    }
+
+    const std::size_t localEdgeCount = m_localEdgeIds.size();
+    m_localEdgeA.resize(localEdgeCount);
+    m_localEdgeB.resize(localEdgeCount);
+    m_localEdgeCapacity.resize(localEdgeCount);
+    m_localEdgeFlow.assign(localEdgeCount, 0);
+    m_localDegree.assign(nodeCount, 0u);
+    for (std::size_t local = 0; local < localEdgeCount; ++local) {
+        const EdgeId edgeId = m_localEdgeIds[local];
+        const NetworkEdge& edge = edges[edgeId];
+        m_localEdgeA[local] = m_localNodeByNodeId[edge.a];
+        m_localEdgeB[local] = m_localNodeByNodeId[edge.b];
+        m_localEdgeCapacity[local] = (edgeId < m_edgeData.size()) ? m_edgeData[edgeId].capacityUnitsPerTick : 0u;
+        ++m_localDegree[m_localEdgeA[local]];
+        ++m_localDegree[m_localEdgeB[local]];
+    }
+
+    m_localLevel.assign(nodeCount, 0u);
+    for (std::size_t local = 0; local < nodeCount; ++local) {
+        const NodeId nodeId = m_localNodeIds[local];
+        if (nodeId < m_nodeUnits.size()) {
+            m_localLevel[local] = std::min(m_nodeUnits[nodeId], m_settings.nodeBufferUnits);
+        }
+    }
+    m_nodeSupply.resize(std::max(m_nodeSupply.size(), nodeCount), 0);
+    m_edgeStates.assign(edges.size(), PipeEdgeRuntimeState{});
+
+    m_batches.clear();
+    std::size_t batchWork = 0;
+    for (std::size_t index = 0; index < m_components.size(); ++index) {
+        const Component& component = m_components[index];
+        if (m_batches.empty() || batchWork >= kBatchWork) {
+            m_batches.push_back(Batch{static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index)});
+            batchWork = 0;
+        }
+        m_batches.back().componentEnd = static_cast<std::uint32_t>(index + 1u);
+        batchWork += (component.nodeEnd - component.nodeBegin) + (component.edgeEnd - component.edgeBegin);
+    }
+
+    m_snapshotVersion = graph.topologyVersion();
+    m_snapshotValid = true;
+    ++m_snapshotBuildCount;
+}
+
+inline PipeFluidTickStats PipeFluidSolver::tickComponent(const Component& component) {
+    PipeFluidTickStats stats{};
+    const std::uint32_t bufferUnits = m_settings.nodeBufferUnits;
+
+    for (std::uint32_t local = component.nodeBegin; local < component.nodeEnd; ++local) {
+        const std::int32_t supply = m_nodeSupply[m_localNodeIds[local]];
+        if (supply > 0) {
+            const std::uint32_t added = std::min(static_cast<std::uint32_t>(supply), bufferUnits - m_localLevel[local]);
+            m_localLevel[local] += added;
+            stats.suppliedUnits += added;
+            stats.blockedSupplyUnits += static_cast<std::uint32_t>(supply) - added;
+        }
+    }
+
+    // Flows are all computed from the levels before any of them apply.
+    for (std::uint32_t local = component.edgeBegin; local < component.edgeEnd; ++local) {
+        const std::uint32_t a = m_localEdgeA[local];
+        const std::uint32_t b = m_localEdgeB[local];
+        const std::int64_t difference = static_cast<std::int64_t>(m_localLevel[a]) - static_cast<std::int64_t>(m_localLevel[b]);
+        const std::int64_t divisor = static_cast<std::int64_t>(std::max(m_localDegree[a], m_localDegree[b])) + 1;
+        const std::int64_t capacity = m_localEdgeCapacity[local];
+        m_localEdgeFlow[local] = static_cast<std::int32_t>(std::clamp(difference / divisor, -capacity, capacity));
+    }
+    for (std::uint32_t local = component.edgeBegin; local < component.edgeEnd; ++local) {
+        const std::int32_t flow = m_localEdgeFlow[local];
+        m_localLevel[m_localEdgeA[local]] -= static_cast<std::uint32_t>(flow);
+        m_localLevel[m_localEdgeB[local]] += static_cast<std::uint32_t>(flow);
+        PipeEdgeRuntimeState& state = m_edgeStates[m_localEdgeIds[local]];
+        state.inUnits = static_cast<std::uint32_t>(std::max(flow, 0));
+        state.outUnits = static_cast<std::uint32_t>(std::max(-flow, 0));
+        stats.movedUnits += static_cast<std::uint64_t>(flow < 0 ? -flow : flow);
+    }
+
+    for (std::uint32_t local = component.nodeBegin; local < component.nodeEnd; ++local) {
+        const std::int32_t supply = m_nodeSupply[m_localNodeIds[local]];
+        if (supply < 0) {
+            const std::uint32_t demand = static_cast<std::uint32_t>(-static_cast<std::int64_t>(supply));
+            const std::uint32_t drained = std::min(demand, m_localLevel[local]);
+            m_localLevel[local] -= drained;
+            stats.drainedUnits += drained;
+            stats.unmetDemandUnits += demand - drained;
+        }
+    }
+    return stats;
+}
+
+inline void PipeFluidSolver::tick(const NetworkGraph& graph, core::JobSystem* jobs) {
+    if (!m_snapshotValid || m_snapshotVersion != graph.topologyVersion()) {
+        rebuildSnapshot(graph);
+    }
+
+    const auto tickBatches = [&](std::size_t batchBegin, std::size_t batchEnd) {
+        PipeFluidTickStats stats{};
+        for (std::size_t batchIndex = batchBegin; batchIndex < batchEnd; ++batchIndex) {
+            const Batch& batch = m_batches[batchIndex];
+            for (std::uint32_t index = batch.componentBegin; index < batch.componentEnd; ++index) {
+                const PipeFluidTickStats componentStats = tickComponent(m_components[index]);
+                stats.suppliedUnits += componentStats.suppliedUnits;
+                stats.blockedSupplyUnits += componentStats.blockedSupplyUnits;
+                stats.drainedUnits += componentStats.drainedUnits;
+                stats.unmetDemandUnits += componentStats.unmetDemandUnits;
+                stats.movedUnits += componentStats.movedUnits;
+            }
+        }
+        return stats;
+    };
+    const auto combine = [](PipeFluidTickStats lhs, const PipeFluidTickStats& rhs) {
+        lhs.suppliedUnits += rhs.suppliedUnits;
+        lhs.blockedSupplyUnits += rhs.blockedSupplyUnits;
+        lhs.drainedUnits += rhs.drainedUnits;
+        lhs.unmetDemandUnits += rhs.unmetDemandUnits;
+        lhs.movedUnits += rhs.movedUnits;
+        return lhs;
+    };
+
+    if (jobs != nullptr && m_batches.size() > 1u) {
+        m_lastTickStats = core::parallelReduce(*jobs, 0, m_batches.size(), 1, PipeFluidTickStats{}, tickBatches, combine);
+    } else {
+        m_lastTickStats = tickBatches(0, m_batches.size());
+    }
+}
+
+inline std::uint32_t PipeFluidSolver::nodeUnits(NodeId nodeId) const {
+    if (m_snapshotValid && nodeId < m_localNodeByNodeId.size()) {
+        return m_localLevel[m_localNodeByNodeId[nodeId]];
+    }
+    return nodeId < m_nodeUnits.size() ? m_nodeUnits[nodeId] : 0u;
+}
+
+inline std::uint64_t PipeFluidSolver::totalUnits() const {
+    std::uint64_t total = 0;
+    std::size_t firstPendingNode = 0;
+    if (m_snapshotValid) {
+        for (const std::uint32_t level : m_localLevel) {
+            total += level;
+        }
+        // Below this, m_nodeUnits holds stale pre-snapshot levels.
+        firstPendingNode = m_localNodeByNodeId.size();
+    }
+    for (std::size_t nodeId = firstPendingNode; nodeId < m_nodeUnits.size(); ++nodeId) {
+        total += m_nodeUnits[nodeId];
+    }
+    return total;
+}
+
+inline const std::vector<PipeEdgeRuntimeState>& PipeFluidSolver::edgeStates() const {
+    return m_edgeStates;
+}
+
+inline const PipeFluidTickStats& PipeFluidSolver::lastTickStats() const {
+    return m_lastTickStats;
+}
+
+inline std::size_t PipeFluidSolver::componentCount() const {
+    return m_components.size();
+}
+
+inline std::size_t PipeFluidSolver::snapshotBuildCount() const {
+    return m_snapshotBuildCount;
+}
+
+} // namespace odai::sim
@@ -0,0 +1,628 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sim/network_graph.h"
+
+// Simulation RailTraffic subsystem
+// Responsible for: stepping trains along the rail edges of a NetworkGraph with
+// block signalling, switch locking and path reservation.
+// Should NOT do: graph editing, cargo transfer, or rendering.
+namespace odai::sim {
+
+using TrainId = std::uint32_t;
+
+inline constexpr TrainId kInvalidTrainId = std::numeric_limits<TrainId>::max();
+
+struct RailTrafficSettings {
+    // Ticks a train waits at each stop.
+    std::uint16_t dwellTicks = 20;
+    // Extra route cost, in Q8 voxels, of an edge another train holds, so
+    // trains take a free parallel platform over a busy one.
+    std::uint32_t busyEdgePenaltyQ8 = 16u * 256u;
+    // Longest run of switch edges reserved together as one path.
+    std::uint8_t maxSwitchChain = 8;
+};
+
+struct RailTrainDesc {
+    std::vector<TrainCar> cars;
+    // The whole train starts on start.edgeId, head distanceAlongQ8 into the
+    // edge in its travel direction; distanceAlongQ8 must be at least the
+    // train's length.
+    TrackParam start{};
+    std::uint16_t speedQ8 = 64;
+    // Visited in order, wrapping around. Must not be empty.
+    std::vector<NodeId> stops;
+};
+
+struct RailTickStats {
+    std::uint32_t movingTrains = 0;
+    std::uint32_t dwellingTrains = 0;
+    // Waiting on a block or switch another train holds.
+    std::uint32_t blockedTrains = 0;
+    // No edge from the current node leads to the next stop.
+    std::uint32_t unroutableTrains = 0;
+    // Blocked trains whose wait-for chain loops back to themselves.
+    std::uint32_t deadlockedTrains = 0;
+    std::uint32_t arrivals = 0;
+};
+
+// Trains run on edges, never between them. Before a train's head leaves an
+// edge it must hold the next one: every block and switch-group lock of that
+// edge. A switch edge is never held alone; the reservation runs on through
+// the following switch edges to the first plain edge, all or nothing, so a
+// stopped train never sits inside a junction. Locks are released as the tail
+// clears each edge, so two trains can never share an edge, block or switch.
+//
+// Routing reads a per-destination distance table (Q8 voxels to the stop,
+// built once by a reverse Dijkstra and cached until the topology or edge data
+// changes) and picks, at each node, the outgoing edge with the lowest
+// length + distance + busy penalty. Trains never turn back along the edge
+// they arrived on. Everything runs serially in train id order, so a tick is
+// fully deterministic.
+class RailTrafficSim {
+public:
+    RailTrafficSim() = default;
+    explicit RailTrafficSim(const RailTrafficSettings& settings);
+
+    void setEdgeData(EdgeId edgeId, const RailEdgeData& data);
+    // Returns kInvalidTrainId when the description is invalid, the train does
+    // not fit behind its head on the start edge, or the start edge is held by
+    // another train.
+    TrainId addTrain(const NetworkGraph& graph, const RailTrainDesc& desc);
+
+    void tick(const NetworkGraph& graph);
+
+    std::size_t trainCount() const;
+    TrackParam trainHead(TrainId trainId) const;
+    // Edges under the train, tail first.
+    std::span<const EdgeId> trainOccupiedEdges(TrainId trainId) const;
+    // Occupied edges followed by those reserved ahead of the head.
+    std::span<const EdgeId> trainPathEdges(TrainId trainId) const;
+    std::uint32_t trainLengthQ8(TrainId trainId) const;
+    std::uint32_t trainArrivals(TrainId trainId) const;
+    RailBlockState edgeBlockState(EdgeId edgeId) const;
+    const RailTickStats& lastTickStats() const;
+    std::size_t routeTableCount() const;
+    std::size_t routeTableBuildCount() const;
+
+private:
+    static constexpr std::uint32_t kNoLock = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t kUnreachable = std::numeric_limits<std::uint32_t>::max();
+
+    struct Train {
+        std::vector<TrainCar> cars;
+        std::uint32_t lengthQ8 = 0;
+        std::uint16_t speedQ8 = 0;
+        std::vector<NodeId> stops;
+        std::uint32_t stopIndex = 0;
+        // Tail first: [tailIndex, headIndex] are occupied, the rest reserved
+        // ahead. Entries before tailIndex are released and compacted away
+        // once they dominate.
+        std::vector<EdgeId> pathEdges;
+        std::vector<std::uint8_t> pathForward;
+        std::uint32_t tailIndex = 0;
+        std::uint32_t headIndex = 0;
+        // Length of the occupied edges strictly between tail and head.
+        std::uint32_t interiorLengthQ8 = 0;
+        std::uint32_t headAlongQ8 = 0;
+        std::uint16_t dwellTicks = 0;
+        // Stop whose arrival has already been counted, until the train moves.
+        NodeId stoppedAtNode = kInvalidNodeId;
+        TrainId waitingOnTrain = kInvalidTrainId;
+        std::uint32_t arrivals = 0;
+    };
+
+    struct RouteTable {
+        std::vector<std::uint32_t> distanceQ8;
+    };
+
+    enum class ReserveResult : std::uint8_t {
+        Reserved,
+        Blocked,
+        Unroutable
+    };
+
+    void refreshEdgeTables(const NetworkGraph& graph);
+    const RouteTable& routeTable(const NetworkGraph& graph, NodeId destination);
+    static bool traversableFrom(const NetworkEdge& edge, const RailEdgeData& data, NodeId fromNode);
+    const RailEdgeData& edgeData(EdgeId edgeId) const;
+    bool heldByOtherTrain(EdgeId edgeId, TrainId trainId, TrainId& outOwner) const;
+    void acquireEdge(EdgeId edgeId, TrainId trainId);
+    void releaseEdge(EdgeId edgeId);
+    bool chooseNextEdge(
+        const NetworkGraph& graph,
+        TrainId trainId,
+        NodeId node,
+        EdgeId arrivedOn,
+        const RouteTable& table,
+        EdgeId& outEdge,
+        bool& outForward
+    ) const;
+    ReserveResult reserveAhead(const NetworkGraph& graph, TrainId trainId, NodeId node);
+    void releaseClearedTail(Train& train);
+    NodeId headEndNode(const NetworkGraph& graph, const Train& train) const;
+    std::uint32_t countDeadlockedTrains() const;
+
+    RailTrafficSettings m_settings{};
+    std::vector<RailEdgeData> m_edgeData;
+    std::vector<Train> m_trains;
+
+    // Derived from the graph and edge data; rebuilt when either changes.
+    std::uint64_t m_edgeTablesVersion = 0;
+    bool m_edgeTablesValid = false;
+    std::vector<std::uint32_t> m_edgeLengthQ8;
+    std::vector<std::uint32_t> m_edgeBlockLock;
+    std::vector<std::uint32_t> m_edgeSwitchLock;
+    std::vector<RailBlockState> m_locks;
+    // Path entries of the owning train that hold each lock; one train may
+    // cover several edges of the same block.
+    std::vector<std::uint32_t> m_lockHolds;
+
+    std::unordered_map<NodeId, std::uint32_t> m_routeTableByDestination;
+    std::vector<RouteTable> m_routeTables;
+    std::size_t m_routeTableBuildCount = 0;
+
+    std::vector<EdgeId> m_chainEdges;
+    std::vector<std::uint8_t> m_chainForward;
+    RailTickStats m_lastTickStats{};
+};
+
+inline RailTrafficSim::RailTrafficSim(const RailTrafficSettings& settings)
+    : m_settings(settings) {}
+
+inline void RailTrafficSim::setEdgeData(EdgeId edgeId, const RailEdgeData& data) {
+    if (edgeId >= m_edgeData.size()) {
+        m_edgeData.resize(static_cast<std::size_t>(edgeId) + 1u);
+    }
+    m_edgeData[edgeId] = data;
+    m_edgeTablesValid = false;
+}
+
+inline const RailEdgeData& RailTrafficSim::edgeData(EdgeId edgeId) const {
+    static const RailEdgeData kDefaultData{};
+    return edgeId < m_edgeData.size() ? m_edgeData[edgeId] : kDefaultData;
+}
+
+inline bool RailTrafficSim::traversableFrom(const NetworkEdge& edge, const RailEdgeData& data, NodeId fromNode) {
+    if (edge.kind != NetworkKind::Rail || edge.a == edge.b) {
+        return false;
+    }
+    return edge.a == fromNode || (!data.oneWay && edge.b == fromNode);
+}
+
+inline void RailTrafficSim::refreshEdgeTables(const NetworkGraph& graph) {
+    if (m_edgeTablesValid && m_edgeTablesVersion == graph.topologyVersion()) {
+        return;
+    }
+    const std::vector<NetworkEdge>& edges = graph.edges();
+    m_edgeLengthQ8.assign(edges.size(), 0u);
+    m_edgeBlockLock.assign(edges.size(), kNoLock);
+    m_edgeSwitchLock.assign(edges.size(), kNoLock);
+    m_locks.clear();
+    std::unordered_map<std::uint16_t, std::uint32_t> lockByBlockId;
+    std::unordered_map<std::uint16_t, std::uint32_t> lockBySwitchGroup;
+    const auto newLock = [this]() {
+        m_locks.push_back(RailBlockState{});
+        return static_cast<std::uint32_t>(m_locks.size() - 1u);
+    };
+    for (EdgeId edgeId = 0; edgeId < edges.size(); ++edgeId) {
+        const NetworkEdge& edge = edges[edgeId];
+        if (edge.kind != NetworkKind::Rail) {
+            continue;
+        }
+        const RailEdgeData& data = edgeData(edgeId);
+        m_edgeLengthQ8[edgeId] = static_cast<std::uint32_t>(std::max<std::uint16_t>(edge.span.lengthVoxels, 1u)) << 8u;
+        if (data.blockId == 0u) {
+            m_edgeBlockLock[edgeId] = newLock();
+        } else {
+            const auto [it, inserted] = lockByBlockId.try_emplace(data.blockId, 0u);
+            if (inserted) {
+                it->second = newLock();
+            }
+            m_edgeBlockLock[edgeId] = it->second;
+        }
+        if (data.switchGroupId != 0u) {
+            const auto [it, inserted] = lockBySwitchGroup.try_emplace(data.switchGroupId, 0u);
+            if (inserted) {
+                it->second = newLock();
+            }
+            m_edgeSwitchLock[edgeId] = it->second;
+        }
+    }
+    m_lockHolds.assign(m_locks.size(), 0u);
+    // Trains keep their paths; their locks are taken again in id order.
+    for (TrainId trainId = 0; trainId < m_trains.size(); ++trainId) {
+        Train& train = m_trains[trainId];
+        train.interiorLengthQ8 = 0;
+        for (std::uint32_t index = train.tailIndex; index < train.pathEdges.size(); ++index) {
+            acquireEdge(train.pathEdges[index], trainId);
+            if (index > train.tailIndex && index < train.headIndex) {
+                train.interiorLengthQ8 += m_edgeLengthQ8[train.pathEdges[index]];
+            }
+        }
+    }
+    m_routeTableByDestination.clear();
+    m_routeTables.clear();
+    m_edgeTablesVersion = graph.topologyVersion();
+    m_edgeTablesValid = true;
+}
+
+inline const RailTrafficSim::RouteTable& RailTrafficSim::routeTable(const NetworkGraph& graph, NodeId destination) {
+    const auto [it, inserted] = m_routeTableByDestination.try_emplace(destination, 0u);
+    if (!inserted) {
+        return m_routeTables[it->second];
+    }
+    it->second = static_cast<std::uint32_t>(m_routeTables.size());
+    RouteTable& table = m_routeTables.emplace_back();
+    ++m_routeTableBuildCount;
+
+    // Reverse Dijkstra from the destination: distanceQ8[n] is the shortest
+    // travel distance from n to the destination along traversable edges.
+    const std::vector<NetworkEdge>& edges = graph.edges();
+    const NetworkAdjacency& adjacency = graph.adjacency();
+    table.distanceQ8.assign(graph.nodeCount(), kUnreachable);
+    if (destination >= graph.nodeCount()) {
+        return table;
+    }
+    using QueueEntry = std::pair<std::uint32_t, NodeId>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> frontier;
+    table.distanceQ8[destination] = 0u;
+    frontier.push(QueueEntry{0u, destination});
+    while (!frontier.empty()) {
+        const auto [distance, node] = frontier.top();
+        frontier.pop();
+        if (distance > table.distanceQ8[node]) {
+            continue;
+        }
+        for (std::uint32_t slot = adjacency.offsets[node]; slot < adjacency.offsets[node + 1u]; ++slot) {
+            const EdgeId edgeId = adjacency.edgeIds[slot];
+            const NetworkEdge& edge = edges[edgeId];
+            const NodeId from = (edge.a == node) ? edge.b : edge.a;
+            if (!traversableFrom(edge, edgeData(edgeId), from) || from == node) {
+                continue;
+            }
+            const std::uint64_t candidate = static_cast<std::uint64_t>(distance) + m_edgeLengthQ8[edgeId];
+            if (candidate < table.distanceQ8[from]) {
+                table.distanceQ8[from] = static_cast<std::uint32_t>(candidate);
+                frontier.push(QueueEntry{table.distanceQ8[from], from});
+            }
+        }
+    }
+    return table;
+}
+
+inline bool RailTrafficSim::heldByOtherTrain(EdgeId edgeId, TrainId trainId, TrainId& outOwner) const {
+    for (const std::uint32_t lock : {m_edgeBlockLock[edgeId], m_edgeSwitchLock[edgeId]}) {
+        if (lock != kNoLock && m_locks[lock].reserved && m_locks[lock].reservedByTrainId != trainId) {
+            outOwner = m_locks[lock].reservedByTrainId;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void RailTrafficSim::acquireEdge(EdgeId edgeId, TrainId trainId) {
+    for (const std::uint32_t lock : {m_edgeBlockLock[edgeId], m_edgeSwitchLock[edgeId]}) {
+        if (lock == kNoLock) {
+            continue;
+        }
+        m_locks[lock].reserved = true;
+        m_locks[lock].reservedByTrainId = trainId;
+        ++m_lockHolds[lock];
+    }
+}
+
+inline void RailTrafficSim::releaseEdge(EdgeId edgeId) {
+    for (const std::uint32_t lock : {m_edgeBlockLock[edgeId], m_edgeSwitchLock[edgeId]}) {
+        if (lock == kNoLock || m_lockHolds[lock] == 0u) {
+            continue;
+        }
+        if (--m_lockHolds[lock] == 0u) {
+            m_locks[lock] = RailBlockState{};
+        }
+    }
+}
+
+inline TrainId RailTrafficSim::addTrain(const NetworkGraph& graph, const RailTrainDesc& desc) {
+    refreshEdgeTables(graph);
+    const EdgeId edgeId = desc.start.edgeId;
+    if (desc.cars.empty() || desc.stops.empty() || desc.speedQ8 == 0u || edgeId >= graph.edges().size()) {
+        return kInvalidTrainId;
+    }
+    const NetworkEdge& edge = graph.edges()[edgeId];
+    const NodeId entryNode = desc.start.forward ? edge.a : edge.b;
+    if (!traversableFrom(edge, edgeData(edgeId), entryNode)) {
+        return kInvalidTrainId;
+    }
+    std::uint32_t lengthQ8 = 0;
+    for (std::size_t car = 0; car < desc.cars.size(); ++car) {
+        lengthQ8 += desc.cars[car].lengthQ8;
+        if (car + 1u < desc.cars.size()) {
+            lengthQ8 += desc.cars[car].maxRearCouplingQ8;
+        }
+    }
+    // Only the start edge gets locked, so the tail must not hang off it.
+    const std::uint32_t headAlongQ8 = std::min<std::uint32_t>(desc.start.distanceAlongQ8, m_edgeLengthQ8[edgeId]);
+    if (lengthQ8 > headAlongQ8) {
+        return kInvalidTrainId;
+    }
+    const TrainId trainId = static_cast<TrainId>(m_trains.size());
+    TrainId owner = kInvalidTrainId;
+    if (heldByOtherTrain(edgeId, trainId, owner)) {
+        return kInvalidTrainId;
+    }
+
+    Train& train = m_trains.emplace_back();
+    train.cars = desc.cars;
+    train.lengthQ8 = lengthQ8;
+    train.speedQ8 = desc.speedQ8;
+    train.stops = desc.stops;
+    train.pathEdges.push_back(edgeId);
+    train.pathForward.push_back(desc.start.forward ? 1u : 0u);
+    train.headAlongQ8 = headAlongQ8;
+    acquireEdge(edgeId, trainId);
+    return trainId;
+}
+
+inline NodeId RailTrafficSim::headEndNode(const NetworkGraph& graph, const Train& train) const {
+    const NetworkEdge& edge = graph.edges()[train.pathEdges[train.headIndex]];
+    return train.pathForward[train.headIndex] != 0u ? edge.b : edge.a;
+}
+
+inline bool RailTrafficSim::chooseNextEdge(
+    const NetworkGraph& graph,
+    TrainId trainId,
+    NodeId node,
+    EdgeId arrivedOn,
+    const RouteTable& table,
+    EdgeId& outEdge,
+    bool& outForward
+) const {
+    const std::vector<NetworkEdge>& edges = graph.edges();
+    const NetworkAdjacency& adjacency = graph.adjacency();
+    std::uint64_t bestCost = std::numeric_limits<std::uint64_t>::max();
+    for (std::uint32_t slot = adjacency.offsets[node]; slot < adjacency.offsets[node + 1u]; ++slot) {
+        const EdgeId edgeId = adjacency.edgeIds[slot];
+        const NetworkEdge& edge = edges[edgeId];
+        if (edgeId == arrivedOn || !traversableFrom(edge, edgeData(edgeId), node)) {
+            continue;
+        }
+        const bool forward = edge.a == node;
+        const NodeId next = forward ? edge.b : edge.a;
+        if (table.distanceQ8[next] == kUnreachable) {
+            continue;
+        }
+        TrainId owner = kInvalidTrainId;
+        std::uint64_t cost = static_cast<std::uint64_t>(table.distanceQ8[next]) + m_edgeLengthQ8[edgeId];
+        if (heldByOtherTrain(edgeId, trainId, owner)) {
+            cost += m_settings.busyEdgePenaltyQ8;
+        }
+        // Rows are ascending, so ties go to the lowest edge id.
+        if (cost < bestCost) {
+            bestCost = cost;
+            outEdge = edgeId;
+            outForward = forward;
+        }
+    }
+    return bestCost != std::numeric_limits<std::uint64_t>::max();
+}
+
+inline RailTrafficSim::ReserveResult RailTrafficSim::reserveAhead(const NetworkGraph& graph, TrainId trainId, NodeId node) {
+    const NodeId destination = m_trains[trainId].stops[m_trains[trainId].stopIndex];
+    const RouteTable& table = routeTable(graph, destination);
+    Train& train = m_trains[trainId];
+    const std::vector<NetworkEdge>& edges = graph.edges();
+
+    m_chainEdges.clear();
+    m_chainForward.clear();
+    EdgeId arrivedOn = train.pathEdges[train.headIndex];
+    NodeId from = node;
+    for (std::uint8_t step = 0; step < std::max<std::uint8_t>(m_settings.maxSwitchChain, 1u); ++step) {
+        EdgeId edgeId = kInvalidEdgeId;
+        bool forward = true;
+        if (!chooseNextEdge(graph, trainId, from, arrivedOn, table, edgeId, forward)) {
+            if (m_chainEdges.empty()) {
+                return ReserveResult::Unroutable;
+            }
+            break;
+        }
+        m_chainEdges.push_back(edgeId);
+        m_chainForward.push_back(forward ? 1u : 0u);
+        from = forward ? edges[edgeId].b : edges[edgeId].a;
+        arrivedOn = edgeId;
+        if (m_edgeSwitchLock[edgeId] == kNoLock || from == destination) {
+            break;
+        }
+    }
+
+    for (const EdgeId edgeId : m_chainEdges) {
+        TrainId owner = kInvalidTrainId;
+        if (heldByOtherTrain(edgeId, trainId, owner)) {
+            train.waitingOnTrain = owner;
+            return ReserveResult::Blocked;
+        }
+    }
+    for (std::size_t index = 0; index < m_chainEdges.size(); ++index) {
+        acquireEdge(m_chainEdges[index], trainId);
+        train.pathEdges.push_back(m_chainEdges[index]);
+        train.pathForward.push_back(m_chainForward[index]);
+    }
+    return ReserveResult::Reserved;
+}
+
+inline void RailTrafficSim::releaseClearedTail(Train& train) {
+    // Drop the tail edge once the rest of the occupied path covers the train.
+    while (train.tailIndex < train.headIndex && train.headAlongQ8 + train.interiorLengthQ8 >= train.lengthQ8) {
+        releaseEdge(train.pathEdges[train.tailIndex]);
+        ++train.tailIndex;
+        if (train.tailIndex < train.headIndex) {
+            train.interiorLengthQ8 -= m_edgeLengthQ8[train.pathEdges[train.tailIndex]];
+        }
+    }
+    if (train.tailIndex > 32u && (train.tailIndex * 2u) > train.pathEdges.size()) {
+        train.pathEdges.erase(train.pathEdges.begin(), train.pathEdges.begin() + train.tailIndex);
+        train.pathForward.erase(train.pathForward.begin(), train.pathForward.begin() + train.tailIndex);
+        train.headIndex -= train.tailIndex;
+        train.tailIndex = 0;
+    }
+}
+
+inline std::uint32_t RailTrafficSim::countDeadlockedTrains() const {
+    // Each blocked train waits on exactly one owner, so the wait-for graph is
+    // functional and a deadlock is a cycle in it.
+    enum : std::uint8_t { kUnvisited = 0, kOnWalk = 1, kDone = 2 };
+    std::vector<std::uint8_t> mark(m_trains.size(), kUnvisited);
+    std::vector<TrainId> walk;
+    std::uint32_t deadlocked = 0;
+    for (TrainId start = 0; start < m_trains.size(); ++start) {
+        walk.clear();
+        TrainId current = start;
+        while (current != kInvalidTrainId && mark[current] == kUnvisited) {
+            mark[current] = kOnWalk;
+            walk.push_back(current);
+            current = m_trains[current].waitingOnTrain;
+        }
+        if (current != kInvalidTrainId && mark[current] == kOnWalk) {
+            const auto cycleStart = std::find(walk.begin(), walk.end(), current);
+            deadlocked += static_cast<std::uint32_t>(walk.end() - cycleStart);
+        }
+        for (const TrainId visited : walk) {
+            mark[visited] = kDone;
+        }
+    }
+    return deadlocked;
+}
+
+inline void RailTrafficSim::tick(const NetworkGraph& graph) {
+    refreshEdgeTables(graph);
+    RailTickStats stats{};
+
+    for (TrainId trainId = 0; trainId < m_trains.size(); ++trainId) {
+        Train& train = m_trains[trainId];
+        train.waitingOnTrain = kInvalidTrainId;
+        if (train.dwellTicks > 0u) {
+            --train.dwellTicks;
+            ++stats.dwellingTrains;
+            continue;
+        }
+
+        std::uint32_t remainingQ8 = train.speedQ8;
+        bool moved = false;
+        ReserveResult stopReason = ReserveResult::Reserved;
+        while (remainingQ8 > 0u) {
+            const std::uint32_t roomQ8 = m_edgeLengthQ8[train.pathEdges[train.headIndex]] - train.headAlongQ8;
+            if (roomQ8 > 0u) {
+                const std::uint32_t stepQ8 = std::min(roomQ8, remainingQ8);
+                train.headAlongQ8 += stepQ8;
+                remainingQ8 -= stepQ8;
+                train.stoppedAtNode = kInvalidNodeId;
+                moved = true;
+                continue;
+            }
+
+            const NodeId node = headEndNode(graph, train);
+            if (node == train.stops[train.stopIndex] && train.stoppedAtNode != node) {
+                ++train.arrivals;
+                ++stats.arrivals;
+                train.stopIndex = (train.stopIndex + 1u) % static_cast<std::uint32_t>(train.stops.size());
+                train.stoppedAtNode = node;
+                train.dwellTicks = m_settings.dwellTicks;
+                break;
+            }
+            if (train.headIndex + 1u >= train.pathEdges.size()) {
+                stopReason = reserveAhead(graph, trainId, node);
+                if (stopReason != ReserveResult::Reserved) {
+                    break;
+                }
+            }
+            if (train.headIndex > train.tailIndex) {
+                train.interiorLengthQ8 += m_edgeLengthQ8[train.pathEdges[train.headIndex]];
+            }
+            ++train.headIndex;
+            train.headAlongQ8 = 0u;
+        }
+        releaseClearedTail(train);
+
+        if (stopReason == ReserveResult::Blocked) {
+            ++stats.blockedTrains;
+        } else if (stopReason == ReserveResult::Unroutable) {
+            ++stats.unroutableTrains;
+        } else if (moved) {
+            ++stats.movingTrains;
+        } else {
+            ++stats.dwellingTrains;
+        }
+    }
+    stats.deadlockedTrains = countDeadlockedTrains();
+    m_lastTickStats = stats;
+}
+
+inline std::size_t RailTrafficSim::trainCount() const {
+    return m_trains.size();
+}
+
+inline TrackParam RailTrafficSim::trainHead(TrainId trainId) const {
+    if (trainId >= m_trains.size()) {
+        return TrackParam{};
+    }
+    const Train& train = m_trains[trainId];
+    return TrackParam{
+        train.pathEdges[train.headIndex],
+        static_cast<std::uint16_t>(std::min<std::uint32_t>(train.headAlongQ8, std::numeric_limits<std::uint16_t>::max())),
+        train.pathForward[train.headIndex] != 0u
+    };
+}
+
+inline std::span<const EdgeId> RailTrafficSim::trainOccupiedEdges(TrainId trainId) const {
+    if (trainId >= m_trains.size()) {
+        return {};
+    }
+    const Train& train = m_trains[trainId];
+    return std::span<const EdgeId>(train.pathEdges).subspan(train.tailIndex, train.headIndex - train.tailIndex + 1u);
+}
+
+inline std::span<const EdgeId> RailTrafficSim::trainPathEdges(TrainId trainId) const {
+    if (trainId >= m_trains.size()) {
+        return {};
+    }
+    return std::span<const EdgeId>(m_trains[trainId].pathEdges).subspan(m_trains[trainId].tailIndex);
+}
+
+inline std::uint32_t RailTrafficSim::trainLengthQ8(TrainId trainId) const {
+    return trainId < m_trains.size() ? m_trains[trainId].lengthQ8 : 0u;
+}
+
+inline std::uint32_t RailTrafficSim::trainArrivals(TrainId trainId) const {
+    return trainId < m_trains.size() ? m_trains[trainId].arrivals : 0u;
+}
+
+inline RailBlockState RailTrafficSim::edgeBlockState(EdgeId edgeId) const {
+    if (edgeId >= m_edgeBlockLock.size() || m_edgeBlockLock[edgeId] == kNoLock) {
+        return RailBlockState{};
+    }
+    return m_locks[m_edgeBlockLock[edgeId]];
+}
+
+inline const RailTickStats& RailTrafficSim::lastTickStats() const {
+    return m_lastTickStats;
+}
+
+inline std::size_t RailTrafficSim::routeTableCount() const {
+    return m_routeTables.size();
+}
+
+inline std::size_t RailTrafficSim::routeTableBuildCount() const {
+    return m_routeTableBuildCount;
+}
+
+} // namespace odai::sim
@@ -4,12 +4,17 @@
 #include <cstddef>
 #include <cstdint>
 #include <cmath>
+#include <initializer_list>
 #include <unordered_map>
 #include <vector>
 
+#include "core/cell_index_map.h"
 #include "core/grid3.h"
+#include "math/math.h"
 #include "sim/belt.h"
 #include "sim/belt_cargo.h"
+#include "sim/network_graph.h"
+#include "sim/network_procedural.h"
 #include "sim/pipe.h"
 #include "sim/track.h"
 
@@ -20,6 +25,31 @@ namespace odai::sim {
 
 class Simulation {
 public:
+    // How one belt is wired, by belts() index; -1 where there is no such belt.
+    struct BeltLinkInfo {
+        std::int32_t nextBeltIndex = -1;
+        std::uint32_t incomingCount = 0;
+        std::int32_t segmentHeadIndex = -1;
+        std::uint32_t segmentSlot = 0;
+        std::int32_t nextSegmentHeadIndex = -1;
+    };
+
+    // Flow through a belt over the last completed window of
+    // kThroughputWindowTicks ticks, fixed point. Measured per straight run, so
+    // every belt of a run reports the run's numbers; the counters restart when
+    // an edit relinks the run.
+    struct BeltThroughput {
+        // Items that left the end of the run, per minute, Q8.
+        std::uint32_t itemsPerMinuteQ8 = 0;
+        // Average items on the run over its lane capacity, Q8 (256 = full).
+        std::uint16_t occupancyQ8 = 0;
+        // Share of lane-ticks whose front item waited at the end of the run
+        // for room downstream, Q8. High values mark the bottleneck's inputs.
+        std::uint16_t blockedQ8 = 0;
+    };
+
+    static constexpr std::uint32_t kThroughputWindowTicks = 300u;
+
     Simulation() = default;
     void initializeSingleBelt();
 
@@ -27,63 +57,272 @@ public:
     std::size_t beltCount() const;
     std::vector<Belt>& belts();
     const std::vector<Belt>& belts() const;
-    // Preferred over `belts().emplace_back(...)` / `belts().erase(...)`: these two
-    // methods bump `m_beltTopologyVersion` so `update()` can detect layout changes in
-    // O(1) instead of re-hashing every belt every tick. The raw `belts()` reference is
-    // still exposed for read-only iteration (rendering, hit-testing) and legacy callers;
-    // any *other* code path that adds/removes/moves belts through it will silently skip
-    // topology invalidation.
+    // Preferred over `belts().emplace_back(...)` / `belts().erase(...)`: once the
+    // first update() has linked the belts, these relink only the edited cell's
+    // neighbours and keep the cargo on every other belt. A belt placed on an
+    // occupied cell replaces the one there. removeBeltAt() moves the last belt
+    // into the freed index; beltIdAt() stays the same for every surviving belt.
+    // Code that adds/removes/moves belts through the raw `belts()` reference must
+    // call invalidateBeltTopology() afterwards.
+    //
+    // Belts placed without edge data use setDefaultBeltEdgeData(). A belt run
+    // moves its items at (speedTier + 1) x the base speed on laneCount lanes;
+    // an item never closes to within slotSpacingQ8 of the one ahead in its lane,
+    // so lanes queue up behind a blocked hand-off (slotSpacingQ8 == 0: free
+    // flow, nothing ever queues).
     void addBelt(int x, int y, int z, BeltDirection direction);
+    void addBelt(int x, int y, int z, BeltDirection direction, const BeltEdgeData& edge);
     bool removeBeltAt(std::size_t index);
+    // Relinks like an edit; cargo stays on the belt, clamped to its lanes.
+    bool setBeltEdgeData(std::size_t beltIndex, const BeltEdgeData& edge);
+    void setDefaultBeltEdgeData(const BeltEdgeData& edge);
+    // The next update() relinks every belt from belts() and reseeds cargo.
+    void invalidateBeltTopology();
+    std::uint32_t beltIdAt(std::size_t beltIndex) const;
+    // -1 once the belt has been removed.
+    std::int32_t beltIndexOf(std::uint32_t beltId) const;
+    BeltLinkInfo beltLink(std::size_t beltIndex) const;
     std::vector<Pipe>& pipes();
     std::size_t pipeCount() const;
     const std::vector<Pipe>& pipes() const;
     std::vector<Track>& tracks();
     std::size_t trackCount() const;
     const std::vector<Track>& tracks() const;
+    std::size_t beltCargoCount() const;
+    // Every belt item with world positions, materialized on first call after
+    // a tick; headless updates never pay for it.
     const std::vector<BeltCargo>& beltCargoes() const;
+    // Appends the items on belt segments that overlap [boundsMin, boundsMax]
+    // (e.g. the camera's view) and returns how many were appended. Only those
+    // items get world positions.
+    std::size_t collectBeltCargoInBounds(
+        const odai::math::Vector3& boundsMin,
+        const odai::math::Vector3& boundsMax,
+        std::vector<BeltCargo>& outCargo
+    ) const;
+    // Places an item on a belt, e.g. from an inserter. Returns false for an
+    // invalid belt, position or lane. Lane spacing is not checked; see
+    // collectBeltSlots() for free room.
+    bool insertBeltCargo(std::size_t beltIndex, std::uint32_t alongQ16, std::uint16_t typeId, std::uint8_t lane = 0);
+    // Appends one BeltSlot per slotSpacingQ8 of the belt's lane, ordered from
+    // the start of the belt, marking the slots an item's position falls in.
+    // Returns the number of slots appended (0 for an invalid belt or lane).
+    std::size_t collectBeltSlots(std::size_t beltIndex, std::uint8_t lane, std::vector<BeltSlot>& outSlots) const;
+    BeltThroughput beltThroughput(std::size_t beltIndex) const;
+    std::size_t beltSegmentCount() const;
 
 private:
     static constexpr std::uint32_t kSpanQ16 = 1u << 16u;
+    // Speed tier 0; higher tiers are integer multiples of it.
     static constexpr float kCargoSpeedVoxelsPerSecond = 1.45f;
     static constexpr float kCargoLiftAboveBelt = 0.68f;
+    // Distance between the outermost lane centres of a multi-lane belt.
+    static constexpr float kBeltLaneSpreadVoxels = 0.5f;
     static constexpr std::uint32_t kSpawnIntervalTicks = 18u;
     static constexpr std::uint32_t kSpawnMinSpacingQ16 = (kSpanQ16 * 5u) / 16u;
     static constexpr std::size_t kMaxCargoPerBelt = 3u;
+    static constexpr std::uint8_t kMaxBeltLanes = 4u;
+    static constexpr std::uint16_t kMaxBeltSpeedTier = 3u;
 
+    // Indexed by belt id. Ids are handed out from a free list, so a belt keeps
+    // its node (and its cargo its belt) while other belts come and go.
     struct BeltTopologyNode {
         odai::core::Cell3i cell{};
         BeltDirection direction = BeltDirection::North;
-        std::int32_t nextBeltIndex = -1;
+        std::int32_t nextBeltId = -1;
         std::uint32_t incomingCount = 0;
+        std::int32_t segmentIndex = -1;
+        // Position of this belt within its segment.
+        std::uint32_t segmentSlot = 0;
+        // Index into m_belts; -1 while the id is free.
+        std::int32_t beltIndex = -1;
+    };
+
+    struct BeltSegmentItem {
+        std::uint32_t itemId = 0;
+        std::uint16_t typeId = 0;
+        // Distance to the item ahead; unused for the front item, whose
+        // distance to the segment end is BeltSegment::frontDistanceQ16.
+        std::int64_t gapQ16 = 0;
+    };
+
+    // One lane of a segment. Items are stored front (nearest the end) to back
+    // as gaps, so moving every item on the lane only changes frontDistanceQ16;
+    // per-item work happens when an item leaves or joins the lane, or closes
+    // up behind a blocked front.
+    struct BeltSegmentLane {
+        // Live items are items[frontItem, items.size()); the consumed prefix
+        // is compacted away once it dominates.
+        std::vector<BeltSegmentItem> items;
+        std::size_t frontItem = 0;
+        std::int64_t frontDistanceQ16 = 0;
+        // Sum of the gaps behind the front item: the back item sits
+        // frontDistanceQ16 + trailingGapQ16 from the end.
+        std::int64_t trailingGapQ16 = 0;
+        // The items right behind the front whose gaps are already at most the
+        // spacing. They move exactly as the front does, so a queue behind a
+        // blocked front is skipped rather than walked every tick.
+        std::size_t compressedCount = 0;
+        // Rearmost position handed to this lane during tick entryClaimTick by
+        // an item still in transit.
+        std::int64_t entryClaimQ16 = 0;
+        std::uint32_t entryClaimTick = ~0u;
+        // The longest-waiting lane refused entry here, as segment * kMaxBeltLanes
+        // + lane, and when its front started waiting. While it keeps retrying
+        // (waiterTick no older than last tick) room goes to it first, so the
+        // inputs of a saturated merge are served in turn whatever their
+        // segment order.
+        std::uint32_t waiterKey = 0;
+        std::uint32_t waiterSinceTick = 0;
+        std::uint32_t waiterTick = ~0u;
+        // When the front started waiting at the end of this lane; ~0u while
+        // it is moving.
+        std::uint32_t frontBlockedSinceTick = ~0u;
+        // Items [frontItem, slowUntilItem) were held back by a blocked front
+        // last tick; interpolation treats them as moving slowFrontStepQ16.
+        std::size_t slowUntilItem = 0;
+        std::int64_t slowFrontStepQ16 = 0;
+
+        bool empty() const { return frontItem >= items.size(); }
+        std::size_t itemCount() const { return items.size() - frontItem; }
+    };
+
+    struct BeltSegmentCounters {
+        std::uint32_t exitedItems = 0;
+        std::uint64_t itemTicks = 0;
+        std::uint32_t blockedLaneTicks = 0;
+        std::uint32_t ticks = 0;
+        std::uint64_t elapsedUs = 0;
+    };
+
+    // A maximal straight run of same-direction belts with the same edge data,
+    // in which every belt but the first is fed only by the one before it.
+    struct BeltSegment {
+        BeltDirection direction = BeltDirection::North;
+        // Belt ids in travel order; empty while the segment is on the free list.
+        std::vector<std::int32_t> beltIds;
+        std::int32_t nextSegmentIndex = -1;
+        // Lane items join on the next segment (a side-load), or -1 to keep
+        // their own lane.
+        std::int32_t nextEntryLane = -1;
+        std::uint32_t speedFactor = 1;
+        // 0 for free flow.
+        std::int64_t spacingQ16 = 0;
+        std::int64_t lastStepQ16 = 0;
+        std::vector<BeltSegmentLane> lanes;
+        BeltSegmentCounters counters{};
+        BeltThroughput throughput{};
+
+        std::int64_t lengthQ16() const { return static_cast<std::int64_t>(beltIds.size()) * kSpanQ16; }
+        bool empty() const {
+            return std::all_of(lanes.begin(), lanes.end(), [](const BeltSegmentLane& lane) { return lane.empty(); });
+        }
+        std::size_t itemCount() const {
+            std::size_t count = 0;
+            for (const BeltSegmentLane& lane : lanes) {
+                count += lane.itemCount();
+            }
+            return count;
+        }
+    };
+
+    // An item pinned to a belt rather than a segment position, so it survives
+    // the segments around it being rebuilt.
+    struct BeltCargoPlacement {
+        std::uint32_t itemId = 0;
+        std::uint16_t typeId = 0;
+        std::int32_t beltId = -1;
+        std::uint32_t alongQ16 = 0;
+        std::uint8_t lane = 0;
+    };
+
+    struct BeltCargoTransfer {
+        // Where the item was before this tick's step.
+        BeltCargoPlacement from{};
+        // -1 when the item ran off the end of the network.
+        std::int32_t toSegmentIndex = -1;
+        std::uint32_t toLane = 0;
+        std::int64_t toPositionQ16 = 0;
     };
 
     static odai::core::Cell3i beltDirectionOffset(BeltDirection direction);
-    static std::uint64_t beltCellKey(const odai::core::Cell3i& cell);
+    static odai::core::Dir6 beltDirectionToDir6(BeltDirection direction);
+    static bool sameBeltFlow(const BeltEdgeData& lhs, const BeltEdgeData& rhs);
+    std::uint32_t beltLaneCount(std::int32_t beltId) const;
+    bool beltTopologyCurrent() const;
+    void syncBeltTopology();
     void rebuildBeltTopology();
+    std::int32_t allocateBeltId();
+    void insertBeltEntry(std::int32_t beltId);
+    void eraseBeltEntry(std::int32_t beltId);
+    std::size_t beltEntryCount() const;
+    std::int32_t beltEntryId(std::size_t entryCursor) const;
+    // Calls fn(beltId) for every belt whose output feeds cell.
+    template <typename Fn>
+    void forEachBeltFeeding(const odai::core::Cell3i& cell, Fn&& fn) const;
+    bool beltStartsSegment(std::int32_t beltId) const;
+    void markBeltSegmentDirty(std::int32_t beltId);
+    void resegmentDirtyBelts(std::int32_t removedBeltId);
+    void buildBeltSegments(std::vector<std::int32_t>& beltIds);
+    std::int32_t buildBeltSegmentFrom(std::int32_t headBeltId);
+    void linkBeltSegment(std::int32_t segmentIndex, std::int32_t nextSegmentIndex);
+    std::int32_t sideLoadLane(std::int32_t feederBeltId, std::int32_t segmentIndex) const;
     void seedBeltCargo();
     void trySpawnBeltCargo();
-    void updateCargoWorldPosition(BeltCargo& cargo);
+    void pushBeltCargo(
+        std::int32_t segmentIndex,
+        std::uint32_t lane,
+        std::int64_t positionQ16,
+        std::uint32_t itemId,
+        std::uint16_t typeId
+    );
+    std::int64_t laneBackPositionQ16(const BeltSegment& segment, const BeltSegmentLane& lane) const;
+    void beltWorldPosition(std::int32_t beltId, std::uint32_t alongQ16, std::uint32_t lane, float outWorldPos[3]) const;
+    void materializeSegmentCargo(std::size_t segmentIndex, std::vector<BeltCargo>& outCargo) const;
     void updateBeltCargo(float dt);
-    bool hasCargoBlockingEntry(std::int32_t entryIndex) const;
+    void advanceBeltLane(std::size_t segmentIndex, std::uint32_t laneIndex, std::int64_t stepQ16);
+    bool claimBeltEntry(std::size_t fromSegmentIndex, std::uint32_t laneIndex, std::int64_t overflowQ16, BeltCargoTransfer& transfer);
+    static void closeUpBeltLane(BeltSegmentLane& lane, std::int64_t spacingQ16, std::int64_t stepQ16, std::int64_t frontStepQ16);
+    void publishBeltThroughput();
+    bool hasCargoBlockingEntry(std::int32_t entryBeltId, std::uint32_t lane) const;
 
     std::vector<Belt> m_belts;
+    // Free flow unless a caller opts in, so belts placed before lanes and
+    // spacing existed behave as they did.
+    BeltEdgeData m_defaultBeltEdgeData{.slotSpacingQ8 = 0};
     std::vector<Pipe> m_pipes;
     std::vector<Track> m_tracks;
     std::vector<BeltTopologyNode> m_beltTopology;
-    std::unordered_map<std::uint64_t, std::size_t> m_beltCellToIndex;
-    std::vector<std::int32_t> m_beltEntryIndices;
-    // Maps a belt-topology index to its slot in m_beltEntryIndices (-1 if the belt is
-    // not an entry point). Rebuilt only alongside m_beltTopology (rare); lets the
-    // per-tick spawn-spacing check below run in O(1) instead of O(cargo count).
-    std::vector<std::int32_t> m_beltIndexToEntrySlot;
-    // Minimum alongQ16 seen this tick among cargo currently on each entry belt.
-    // Repopulated once per tick as a side effect of the cargo-advance pass in
-    // updateBeltCargo() (which already visits every cargo item), so trySpawnBeltCargo()
-    // never needs its own O(cargo) scan.
-    std::vector<std::uint32_t> m_entrySlotMinAlongQ16;
-    std::vector<BeltCargo> m_beltCargoes;
-    std::uint64_t m_beltTopologyVersion = 0;
+    std::vector<std::int32_t> m_beltIdByIndex;
+    std::vector<std::int32_t> m_freeBeltIds;
+    odai::core::CellIndexMap m_beltCellToId;
+    // Belts nothing feeds, ascending by id; spawns cycle through them.
+    std::vector<std::int32_t> m_beltEntryIds;
+    std::vector<BeltSegment> m_beltSegments;
+    std::vector<std::int32_t> m_freeSegmentIndices;
+    // World-space bounds of each segment's cargo, for collectBeltCargoInBounds().
+    std::vector<odai::math::Vector3> m_segmentBoundsMin;
+    std::vector<odai::math::Vector3> m_segmentBoundsMax;
+    // Scratch for local relinking: segments to dissolve, their belts, and
+    // their cargo until it is placed on the rebuilt segments.
+    std::vector<std::int32_t> m_dirtySegmentIndices;
+    std::vector<std::int32_t> m_resegmentBeltIds;
+    std::vector<std::int32_t> m_builtSegmentIndices;
+    std::vector<BeltCargoPlacement> m_relinkedCargo;
+    std::size_t m_beltCargoCount = 0;
+    // Items that changed segment in the last tick: every other item was its
+    // segment's lastStepQ16 (or its lane's slowFrontStepQ16) behind one tick ago.
+    std::vector<BeltCargoPlacement> m_beltCargoCrossings;
+    std::unordered_map<std::uint32_t, std::size_t> m_beltCargoCrossingByItem;
+    std::vector<BeltCargoTransfer> m_beltCargoTransfers;
+    // Base step of the last tick times the fastest speed factor: only items
+    // this close to their segment start can have crossed into it.
+    std::int64_t m_lastMaxBeltStepQ16 = 0;
+    mutable std::vector<BeltCargo> m_beltCargoes;
+    mutable bool m_beltCargoesValid = false;
+    // Starts out of date so belts added before the first update() are linked
+    // in one pass.
+    std::uint64_t m_beltTopologyVersion = 1;
     std::uint64_t m_beltTopologyBuiltVersion = 0;
     std::uint32_t m_nextCargoId = 1;
     std::uint32_t m_tickCounter = 0;
@@ -114,33 +353,203 @@ inline void Simulation::initializeSingleBelt() {
 }
 
 inline void Simulation::update(float dt) {
-    // O(1) dirty check: m_beltTopologyVersion is only bumped by addBelt()/removeBeltAt(),
-    // so this replaces what used to be an unconditional O(belts.size()) FNV hash of every
-    // belt, every tick, purely to detect layout changes that in practice only happen on
-    // discrete editor placement actions. See addBelt()/removeBeltAt() doc comment for the
-    // caveat: mutating m_belts through the raw belts() reference bypasses this.
-    if (m_beltTopologyBuiltVersion != m_beltTopologyVersion) {
+    syncBeltTopology();
+    updateBeltCargo(std::max(dt, 0.0f));
+}
+
+inline bool Simulation::beltTopologyCurrent() const {
+    return m_beltTopologyBuiltVersion == m_beltTopologyVersion;
+}
+
+inline void Simulation::syncBeltTopology() {
+    // O(1) dirty check: addBelt()/removeBeltAt() patch the topology in place, so
+    // the version only moves on invalidateBeltTopology() and before the first
+    // update(). See addBelt()/removeBeltAt() doc comment for the caveat:
+    // mutating m_belts through the raw belts() reference bypasses this.
+    if (!beltTopologyCurrent()) {
         m_beltTopologyBuiltVersion = m_beltTopologyVersion;
         rebuildBeltTopology();
         seedBeltCargo();
     }
-    updateBeltCargo(std::max(dt, 0.0f));
 }
 
 inline void Simulation::addBelt(int x, int y, int z, BeltDirection direction) {
+    addBelt(x, y, z, direction, m_defaultBeltEdgeData);
+}
+
+inline void Simulation::addBelt(int x, int y, int z, BeltDirection direction, const BeltEdgeData& edge) {
+    if (!beltTopologyCurrent()) {
+        m_belts.emplace_back(x, y, z, direction);
+        m_belts.back().edge = edge;
+        return;
+    }
+
+    const odai::core::Cell3i cell{x, y, z};
+    if (const std::int32_t occupant = m_beltCellToId.find(cell); occupant >= 0) {
+        removeBeltAt(static_cast<std::size_t>(m_beltTopology[static_cast<std::size_t>(occupant)].beltIndex));
+    }
+
+    const std::int32_t beltId = allocateBeltId();
+    m_beltIdByIndex.push_back(beltId);
     m_belts.emplace_back(x, y, z, direction);
-    ++m_beltTopologyVersion;
+    m_belts.back().edge = edge;
+    BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(beltId)];
+    node = BeltTopologyNode{};
+    node.cell = cell;
+    node.direction = direction;
+    node.beltIndex = static_cast<std::int32_t>(m_belts.size() - 1u);
+    m_beltCellToId.insert(cell, beltId);
+
+    m_dirtySegmentIndices.clear();
+    m_resegmentBeltIds.clear();
+    m_resegmentBeltIds.push_back(beltId);
+
+    const odai::core::Cell3i nextCell = cell + beltDirectionOffset(direction);
+    if (const std::int32_t nextBeltId = m_beltCellToId.find(nextCell); nextBeltId >= 0) {
+        node.nextBeltId = nextBeltId;
+        BeltTopologyNode& next = m_beltTopology[static_cast<std::size_t>(nextBeltId)];
+        if (next.incomingCount++ == 0u) {
+            eraseBeltEntry(nextBeltId);
+        }
+        // The next belt may stop continuing the segment that fed it.
+        markBeltSegmentDirty(nextBeltId);
+        forEachBeltFeeding(nextCell, [&](std::int32_t feederId) { markBeltSegmentDirty(feederId); });
+    }
+    forEachBeltFeeding(cell, [&](std::int32_t feederId) {
+        m_beltTopology[static_cast<std::size_t>(feederId)].nextBeltId = beltId;
+        m_beltTopology[static_cast<std::size_t>(beltId)].incomingCount += 1u;
+        markBeltSegmentDirty(feederId);
+    });
+    if (m_beltTopology[static_cast<std::size_t>(beltId)].incomingCount == 0u) {
+        insertBeltEntry(beltId);
+    }
+    resegmentDirtyBelts(-1);
 }
 
 inline bool Simulation::removeBeltAt(std::size_t index) {
     if (index >= m_belts.size()) {
         return false;
     }
-    m_belts.erase(m_belts.begin() + static_cast<std::ptrdiff_t>(index));
-    ++m_beltTopologyVersion;
+    if (!beltTopologyCurrent()) {
+        m_belts[index] = m_belts.back();
+        m_belts.pop_back();
+        return true;
+    }
+
+    const std::int32_t beltId = m_beltIdByIndex[index];
+    const BeltTopologyNode node = m_beltTopology[static_cast<std::size_t>(beltId)];
+    m_dirtySegmentIndices.clear();
+    m_resegmentBeltIds.clear();
+    markBeltSegmentDirty(beltId);
+
+    if (node.nextBeltId >= 0) {
+        BeltTopologyNode& next = m_beltTopology[static_cast<std::size_t>(node.nextBeltId)];
+        if (--next.incomingCount == 0u) {
+            insertBeltEntry(node.nextBeltId);
+        }
+        // With one feeder left, the next belt may now extend that feeder's segment.
+        markBeltSegmentDirty(node.nextBeltId);
+        forEachBeltFeeding(next.cell, [&](std::int32_t feederId) { markBeltSegmentDirty(feederId); });
+    }
+    forEachBeltFeeding(node.cell, [&](std::int32_t feederId) {
+        m_beltTopology[static_cast<std::size_t>(feederId)].nextBeltId = -1;
+        markBeltSegmentDirty(feederId);
+    });
+    if (node.incomingCount == 0u) {
+        eraseBeltEntry(beltId);
+    }
+    if (m_beltCellToId.find(node.cell) == beltId) {
+        m_beltCellToId.erase(node.cell);
+    }
+    resegmentDirtyBelts(beltId);
+
+    m_beltTopology[static_cast<std::size_t>(beltId)] = BeltTopologyNode{};
+    m_freeBeltIds.push_back(beltId);
+    const std::size_t lastIndex = m_belts.size() - 1u;
+    if (index != lastIndex) {
+        m_belts[index] = m_belts[lastIndex];
+        m_beltIdByIndex[index] = m_beltIdByIndex[lastIndex];
+        m_beltTopology[static_cast<std::size_t>(m_beltIdByIndex[index])].beltIndex = static_cast<std::int32_t>(index);
+    }
+    m_belts.pop_back();
+    m_beltIdByIndex.pop_back();
+    m_beltCargoesValid = false;
     return true;
 }
 
+inline bool Simulation::setBeltEdgeData(std::size_t beltIndex, const BeltEdgeData& edge) {
+    if (beltIndex >= m_belts.size()) {
+        return false;
+    }
+    m_belts[beltIndex].edge = edge;
+    if (!beltTopologyCurrent()) {
+        return true;
+    }
+
+    const std::int32_t beltId = m_beltIdByIndex[beltIndex];
+    const BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(beltId)];
+    m_dirtySegmentIndices.clear();
+    m_resegmentBeltIds.clear();
+    markBeltSegmentDirty(beltId);
+    if (node.nextBeltId >= 0) {
+        // The next belt may now continue this belt's run, or stop doing so,
+        // and its lane count picks the lanes its feeders side-load onto.
+        markBeltSegmentDirty(node.nextBeltId);
+        forEachBeltFeeding(
+            m_beltTopology[static_cast<std::size_t>(node.nextBeltId)].cell,
+            [&](std::int32_t feederId) { markBeltSegmentDirty(feederId); }
+        );
+    }
+    forEachBeltFeeding(node.cell, [&](std::int32_t feederId) { markBeltSegmentDirty(feederId); });
+    resegmentDirtyBelts(-1);
+    return true;
+}
+
+inline void Simulation::setDefaultBeltEdgeData(const BeltEdgeData& edge) {
+    m_defaultBeltEdgeData = edge;
+}
+
+inline void Simulation::invalidateBeltTopology() {
+    ++m_beltTopologyVersion;
+}
+
+inline std::uint32_t Simulation::beltIdAt(std::size_t beltIndex) const {
+    if (!beltTopologyCurrent() || beltIndex >= m_beltIdByIndex.size()) {
+        return static_cast<std::uint32_t>(beltIndex);
+    }
+    return static_cast<std::uint32_t>(m_beltIdByIndex[beltIndex]);
+}
+
+inline std::int32_t Simulation::beltIndexOf(std::uint32_t beltId) const {
+    if (beltId >= m_beltTopology.size()) {
+        return -1;
+    }
+    return m_beltTopology[beltId].beltIndex;
+}
+
+inline Simulation::BeltLinkInfo Simulation::beltLink(std::size_t beltIndex) const {
+    BeltLinkInfo info{};
+    if (!beltTopologyCurrent() || beltIndex >= m_beltIdByIndex.size()) {
+        return info;
+    }
+    const BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(m_beltIdByIndex[beltIndex])];
+    const auto indexOfBelt = [&](std::int32_t beltId) {
+        return beltId >= 0 ? m_beltTopology[static_cast<std::size_t>(beltId)].beltIndex : -1;
+    };
+    info.nextBeltIndex = indexOfBelt(node.nextBeltId);
+    info.incomingCount = node.incomingCount;
+    if (node.segmentIndex >= 0) {
+        const BeltSegment& segment = m_beltSegments[static_cast<std::size_t>(node.segmentIndex)];
+        info.segmentHeadIndex = indexOfBelt(segment.beltIds.front());
+        info.segmentSlot = node.segmentSlot;
+        if (segment.nextSegmentIndex >= 0) {
+            info.nextSegmentHeadIndex =
+                indexOfBelt(m_beltSegments[static_cast<std::size_t>(segment.nextSegmentIndex)].beltIds.front());
+        }
+    }
+    return info;
+}
+
 inline std::size_t Simulation::beltCount() const {
     return m_belts.size();
 }
@@ -177,10 +586,127 @@ inline const std::vector<Track>& Simulation::tracks() const {
     return m_tracks;
 }
 
+inline std::size_t Simulation::beltCargoCount() const {
+    return m_beltCargoCount;
+}
+
 inline const std::vector<BeltCargo>& Simulation::beltCargoes() const {
+    if (!m_beltCargoesValid) {
+        m_beltCargoes.clear();
+        m_beltCargoes.reserve(m_beltCargoCount);
+        for (std::size_t segmentIndex = 0; segmentIndex < m_beltSegments.size(); ++segmentIndex) {
+            materializeSegmentCargo(segmentIndex, m_beltCargoes);
+        }
+        m_beltCargoesValid = true;
+    }
     return m_beltCargoes;
 }
 
+inline std::size_t Simulation::collectBeltCargoInBounds(
+    const odai::math::Vector3& boundsMin,
+    const odai::math::Vector3& boundsMax,
+    std::vector<BeltCargo>& outCargo
+) const {
+    const std::size_t sizeBefore = outCargo.size();
+    for (std::size_t segmentIndex = 0; segmentIndex < m_beltSegments.size(); ++segmentIndex) {
+        if (m_beltSegments[segmentIndex].empty()) {
+            continue;
+        }
+        const odai::math::Vector3& segmentMin = m_segmentBoundsMin[segmentIndex];
+        const odai::math::Vector3& segmentMax = m_segmentBoundsMax[segmentIndex];
+        if (segmentMax.x < boundsMin.x || segmentMin.x > boundsMax.x ||
+            segmentMax.y < boundsMin.y || segmentMin.y > boundsMax.y ||
+            segmentMax.z < boundsMin.z || segmentMin.z > boundsMax.z) {
+            continue;
+        }
+        materializeSegmentCargo(segmentIndex, outCargo);
+    }
+    return outCargo.size() - sizeBefore;
+}
+
+inline bool Simulation::insertBeltCargo(
+    std::size_t beltIndex,
+    std::uint32_t alongQ16,
+    std::uint16_t typeId,
+    std::uint8_t lane
+) {
+    syncBeltTopology();
+    if (beltIndex >= m_belts.size() || alongQ16 >= kSpanQ16) {
+        return false;
+    }
+    const std::int32_t beltId = m_beltIdByIndex[beltIndex];
+    if (lane >= beltLaneCount(beltId)) {
+        return false;
+    }
+    const BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(beltId)];
+    const std::int64_t positionQ16 = (static_cast<std::int64_t>(node.segmentSlot) * kSpanQ16) + alongQ16;
+    pushBeltCargo(node.segmentIndex, lane, positionQ16, m_nextCargoId++, typeId);
+    return true;
+}
+
+// Walks the lane from its front, so the cost grows with the items ahead of
+// the belt on its run; meant for inserters polling a few belts, not for
+// every belt every tick.
+inline std::size_t Simulation::collectBeltSlots(
+    std::size_t beltIndex,
+    std::uint8_t lane,
+    std::vector<BeltSlot>& outSlots
+) const {
+    if (!beltTopologyCurrent() || beltIndex >= m_beltIdByIndex.size()) {
+        return 0u;
+    }
+    const BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(m_beltIdByIndex[beltIndex])];
+    if (node.segmentIndex < 0) {
+        return 0u;
+    }
+    const BeltSegment& segment = m_beltSegments[static_cast<std::size_t>(node.segmentIndex)];
+    if (lane >= segment.lanes.size()) {
+        return 0u;
+    }
+    const std::int64_t slotCount = (segment.spacingQ16 > 0)
+        ? std::max<std::int64_t>(1, kSpanQ16 / segment.spacingQ16)
+        : static_cast<std::int64_t>(kMaxCargoPerBelt);
+    const std::size_t firstSlot = outSlots.size();
+    outSlots.resize(firstSlot + static_cast<std::size_t>(slotCount));
+
+    const BeltSegmentLane& segmentLane = segment.lanes[lane];
+    const std::int64_t beltStartQ16 = static_cast<std::int64_t>(node.segmentSlot) * kSpanQ16;
+    std::int64_t positionQ16 = segment.lengthQ16() - segmentLane.frontDistanceQ16;
+    for (std::size_t itemIndex = segmentLane.frontItem; itemIndex < segmentLane.items.size(); ++itemIndex) {
+        const BeltSegmentItem& item = segmentLane.items[itemIndex];
+        if (itemIndex != segmentLane.frontItem) {
+            positionQ16 -= item.gapQ16;
+        }
+        if (positionQ16 >= beltStartQ16 + kSpanQ16) {
+            continue;
+        }
+        if (positionQ16 < beltStartQ16) {
+            break;
+        }
+        BeltSlot& slot = outSlots[firstSlot + static_cast<std::size_t>(((positionQ16 - beltStartQ16) * slotCount) / kSpanQ16)];
+        if (!slot.occupied) {
+            slot.itemId = item.itemId;
+            slot.occupied = true;
+        }
+    }
+    return static_cast<std::size_t>(slotCount);
+}
+
+inline Simulation::BeltThroughput Simulation::beltThroughput(std::size_t beltIndex) const {
+    if (!beltTopologyCurrent() || beltIndex >= m_beltIdByIndex.size()) {
+        return BeltThroughput{};
+    }
+    const BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(m_beltIdByIndex[beltIndex])];
+    if (node.segmentIndex < 0) {
+        return BeltThroughput{};
+    }
+    return m_beltSegments[static_cast<std::size_t>(node.segmentIndex)].throughput;
+}
+
+inline std::size_t Simulation::beltSegmentCount() const {
+    return m_beltSegments.size() - m_freeSegmentIndices.size();
+}
+
 inline odai::core::Cell3i Simulation::beltDirectionOffset(BeltDirection direction) {
     switch (direction) {
     case BeltDirection::East:
@@ -195,101 +721,500 @@ inline odai::core::Cell3i Simulation::beltDirectionOffset(BeltDirection directio
     }
 }
 
-inline std::uint64_t Simulation::beltCellKey(const odai::core::Cell3i& cell) {
-    return odai::core::packCell21(cell);
+inline odai::core::Dir6 Simulation::beltDirectionToDir6(BeltDirection direction) {
+    switch (direction) {
+    case BeltDirection::East:
+        return odai::core::Dir6::PosX;
+    case BeltDirection::West:
+        return odai::core::Dir6::NegX;
+    case BeltDirection::South:
+        return odai::core::Dir6::PosZ;
+    case BeltDirection::North:
+    default:
+        return odai::core::Dir6::NegZ;
+    }
+}
+
+// `reversed` is not part of the flow: belts already carry their direction.
+inline bool Simulation::sameBeltFlow(const BeltEdgeData& lhs, const BeltEdgeData& rhs) {
+    return lhs.laneCount == rhs.laneCount && lhs.speedTier == rhs.speedTier && lhs.slotSpacingQ8 == rhs.slotSpacingQ8;
+}
+
+inline std::uint32_t Simulation::beltLaneCount(std::int32_t beltId) const {
+    const BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(beltId)];
+    const BeltEdgeData& edge = m_belts[static_cast<std::size_t>(node.beltIndex)].edge;
+    return std::clamp<std::uint32_t>(edge.laneCount, 1u, kMaxBeltLanes);
 }
 
 inline void Simulation::rebuildBeltTopology() {
-    m_beltTopology.assign(m_belts.size(), {});
-    m_beltCellToIndex.clear();
-    m_beltEntryIndices.clear();
-    m_beltIndexToEntrySlot.assign(m_belts.size(), -1);
+    m_beltCellToId.clear();
+    m_beltCellToId.reserve(m_belts.size());
+    m_beltEntryIds.clear();
+    m_freeBeltIds.clear();
 
-    if (m_belts.empty()) {
-        m_entrySlotMinAlongQ16.clear();
-        return;
+    // As with addBelt(), the last belt placed on a cell replaces earlier ones.
+    for (std::size_t beltIndex = 0; beltIndex < m_belts.size(); ++beltIndex) {
+        const Belt& belt = m_belts[beltIndex];
+        m_beltCellToId.insert(odai::core::Cell3i{belt.x, belt.y, belt.z}, static_cast<std::int32_t>(beltIndex));
+    }
+    if (m_beltCellToId.size() != m_belts.size()) {
+        std::size_t keptCount = 0;
+        for (std::size_t beltIndex = 0; beltIndex < m_belts.size(); ++beltIndex) {
+            const Belt& belt = m_belts[beltIndex];
+            if (m_beltCellToId.find(odai::core::Cell3i{belt.x, belt.y, belt.z}) == static_cast<std::int32_t>(beltIndex)) {
+                m_belts[keptCount++] = belt;
+            }
+        }
+        m_belts.resize(keptCount);
+        m_beltCellToId.clear();
     }
 
-    m_beltCellToIndex.reserve(m_belts.size() * 2u);
+    m_beltTopology.assign(m_belts.size(), {});
+    m_beltIdByIndex.resize(m_belts.size());
     for (std::size_t beltIndex = 0; beltIndex < m_belts.size(); ++beltIndex) {
         const Belt& belt = m_belts[beltIndex];
         BeltTopologyNode& node = m_beltTopology[beltIndex];
         node.cell = odai::core::Cell3i{belt.x, belt.y, belt.z};
         node.direction = belt.direction;
-        node.nextBeltIndex = -1;
-        node.incomingCount = 0;
-        m_beltCellToIndex[beltCellKey(node.cell)] = beltIndex;
+        node.beltIndex = static_cast<std::int32_t>(beltIndex);
+        m_beltIdByIndex[beltIndex] = static_cast<std::int32_t>(beltIndex);
+        m_beltCellToId.insert(node.cell, static_cast<std::int32_t>(beltIndex));
     }
 
-    for (std::size_t beltIndex = 0; beltIndex < m_belts.size(); ++beltIndex) {
-        BeltTopologyNode& node = m_beltTopology[beltIndex];
-        const odai::core::Cell3i nextCell = node.cell + beltDirectionOffset(node.direction);
-        const auto found = m_beltCellToIndex.find(beltCellKey(nextCell));
-        if (found != m_beltCellToIndex.end()) {
-            node.nextBeltIndex = static_cast<std::int32_t>(found->second);
-            m_beltTopology[found->second].incomingCount += 1u;
+    for (BeltTopologyNode& node : m_beltTopology) {
+        node.nextBeltId = m_beltCellToId.find(node.cell + beltDirectionOffset(node.direction));
+        if (node.nextBeltId >= 0) {
+            m_beltTopology[static_cast<std::size_t>(node.nextBeltId)].incomingCount += 1u;
+        }
+    }
+
+    for (std::size_t beltId = 0; beltId < m_beltTopology.size(); ++beltId) {
+        if (m_beltTopology[beltId].incomingCount == 0u) {
+            m_beltEntryIds.push_back(static_cast<std::int32_t>(beltId));
+        }
+    }
+
+    m_beltSegments.clear();
+    m_freeSegmentIndices.clear();
+    m_segmentBoundsMin.clear();
+    m_segmentBoundsMax.clear();
+    m_beltCargoCrossings.clear();
+    m_beltCargoCrossingByItem.clear();
+    m_beltCargoCount = 0;
+    m_lastMaxBeltStepQ16 = 0;
+    m_beltCargoesValid = false;
+    m_resegmentBeltIds = m_beltIdByIndex;
+    buildBeltSegments(m_resegmentBeltIds);
+}
+
+inline std::int32_t Simulation::allocateBeltId() {
+    if (!m_freeBeltIds.empty()) {
+        const std::int32_t beltId = m_freeBeltIds.back();
+        m_freeBeltIds.pop_back();
+        return beltId;
+    }
+    m_beltTopology.emplace_back();
+    return static_cast<std::int32_t>(m_beltTopology.size() - 1u);
+}
+
+inline void Simulation::insertBeltEntry(std::int32_t beltId) {
+    const auto position = std::lower_bound(m_beltEntryIds.begin(), m_beltEntryIds.end(), beltId);
+    if (position == m_beltEntryIds.end() || *position != beltId) {
+        m_beltEntryIds.insert(position, beltId);
+    }
+}
+
+inline void Simulation::eraseBeltEntry(std::int32_t beltId) {
+    const auto position = std::lower_bound(m_beltEntryIds.begin(), m_beltEntryIds.end(), beltId);
+    if (position != m_beltEntryIds.end() && *position == beltId) {
+        m_beltEntryIds.erase(position);
+    }
+}
+
+// A network that is all loops has no entry belts; the first belt stands in.
+inline std::size_t Simulation::beltEntryCount() const {
+    if (m_belts.empty()) {
+        return 0u;
+    }
+    return std::max<std::size_t>(1u, m_beltEntryIds.size());
+}
+
+inline std::int32_t Simulation::beltEntryId(std::size_t entryCursor) const {
+    return m_beltEntryIds.empty() ? m_beltIdByIndex.front() : m_beltEntryIds[entryCursor];
+}
+
+template <typename Fn>
+inline void Simulation::forEachBeltFeeding(const odai::core::Cell3i& cell, Fn&& fn) const {
+    for (const BeltDirection direction : {BeltDirection::North, BeltDirection::East, BeltDirection::South, BeltDirection::West}) {
+        const std::int32_t beltId = m_beltCellToId.find(cell - beltDirectionOffset(direction));
+        if (beltId >= 0 && m_beltTopology[static_cast<std::size_t>(beltId)].direction == direction) {
+            fn(beltId);
+        }
+    }
+}
+
+// A belt continues the segment of its feeder only when that feeder is the
+// sole one, points the same way and moves items the same way.
+inline bool Simulation::beltStartsSegment(std::int32_t beltId) const {
+    const BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(beltId)];
+    if (node.incomingCount != 1u) {
+        return true;
+    }
+    const BeltEdgeData& edge = m_belts[static_cast<std::size_t>(node.beltIndex)].edge;
+    bool continuesFeeder = false;
+    forEachBeltFeeding(node.cell, [&](std::int32_t feederId) {
+        const BeltTopologyNode& feeder = m_beltTopology[static_cast<std::size_t>(feederId)];
+        continuesFeeder = continuesFeeder ||
+                          (feeder.direction == node.direction &&
+                           sameBeltFlow(m_belts[static_cast<std::size_t>(feeder.beltIndex)].edge, edge));
+    });
+    return !continuesFeeder;
+}
+
+inline void Simulation::markBeltSegmentDirty(std::int32_t beltId) {
+    const std::int32_t segmentIndex = m_beltTopology[static_cast<std::size_t>(beltId)].segmentIndex;
+    if (segmentIndex >= 0) {
+        m_dirtySegmentIndices.push_back(segmentIndex);
+    }
+}
+
+// Dissolves the segments marked dirty by an edit, regroups their belts (plus
+// any in m_resegmentBeltIds) and puts their cargo back on the same belts.
+// Cargo on removedBeltId is dropped.
+inline void Simulation::resegmentDirtyBelts(std::int32_t removedBeltId) {
+    std::sort(m_dirtySegmentIndices.begin(), m_dirtySegmentIndices.end());
+    m_dirtySegmentIndices.erase(
+        std::unique(m_dirtySegmentIndices.begin(), m_dirtySegmentIndices.end()),
+        m_dirtySegmentIndices.end()
+    );
+    m_relinkedCargo.clear();
+    for (const std::int32_t segmentIndex : m_dirtySegmentIndices) {
+        BeltSegment& segment = m_beltSegments[static_cast<std::size_t>(segmentIndex)];
+        for (std::size_t laneIndex = 0; laneIndex < segment.lanes.size(); ++laneIndex) {
+            const BeltSegmentLane& lane = segment.lanes[laneIndex];
+            std::int64_t positionQ16 = segment.lengthQ16() - lane.frontDistanceQ16;
+            for (std::size_t itemIndex = lane.frontItem; itemIndex < lane.items.size(); ++itemIndex) {
+                const BeltSegmentItem& item = lane.items[itemIndex];
+                if (itemIndex != lane.frontItem) {
+                    positionQ16 -= item.gapQ16;
+                }
+                --m_beltCargoCount;
+                const std::int32_t beltId = segment.beltIds[static_cast<std::size_t>(positionQ16 >> 16)];
+                if (beltId != removedBeltId) {
+                    m_relinkedCargo.push_back(BeltCargoPlacement{
+                        item.itemId,
+                        item.typeId,
+                        beltId,
+                        static_cast<std::uint32_t>(positionQ16 & (kSpanQ16 - 1u)),
+                        static_cast<std::uint8_t>(laneIndex)
+                    });
+                }
+            }
         }
+        for (const std::int32_t beltId : segment.beltIds) {
+            m_beltTopology[static_cast<std::size_t>(beltId)].segmentIndex = -1;
+            if (beltId != removedBeltId) {
+                m_resegmentBeltIds.push_back(beltId);
+            }
+        }
+        segment = BeltSegment{};
+        m_freeSegmentIndices.push_back(segmentIndex);
+    }
+
+    buildBeltSegments(m_resegmentBeltIds);
+
+    for (const BeltCargoPlacement& cargo : m_relinkedCargo) {
+        const BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(cargo.beltId)];
+        const std::int64_t positionQ16 = (static_cast<std::int64_t>(node.segmentSlot) * kSpanQ16) + cargo.alongQ16;
+        const std::uint32_t lane = std::min<std::uint32_t>(cargo.lane, beltLaneCount(cargo.beltId) - 1u);
+        pushBeltCargo(node.segmentIndex, lane, positionQ16, cargo.itemId, cargo.typeId);
     }
+    m_relinkedCargo.clear();
+    m_beltCargoesValid = false;
+}
 
-    for (std::size_t beltIndex = 0; beltIndex < m_beltTopology.size(); ++beltIndex) {
-        if (m_beltTopology[beltIndex].incomingCount == 0u) {
-            m_beltEntryIndices.push_back(static_cast<std::int32_t>(beltIndex));
+// Groups belts that have no segment yet. Every belt that would continue one of
+// their segments is among them, since an edit dirties the segments on both
+// sides of the edited cell.
+inline void Simulation::buildBeltSegments(std::vector<std::int32_t>& beltIds) {
+    std::sort(beltIds.begin(), beltIds.end());
+    m_builtSegmentIndices.clear();
+    for (const std::int32_t beltId : beltIds) {
+        if (m_beltTopology[static_cast<std::size_t>(beltId)].segmentIndex < 0 && beltStartsSegment(beltId)) {
+            m_builtSegmentIndices.push_back(buildBeltSegmentFrom(beltId));
+        }
+    }
+    // Whatever is left lies on a closed loop with no break; cut it at its
+    // lowest id.
+    for (const std::int32_t beltId : beltIds) {
+        if (m_beltTopology[static_cast<std::size_t>(beltId)].segmentIndex < 0) {
+            m_builtSegmentIndices.push_back(buildBeltSegmentFrom(beltId));
         }
     }
-    if (m_beltEntryIndices.empty()) {
-        m_beltEntryIndices.push_back(0);
+    beltIds.clear();
+
+    for (const std::int32_t segmentIndex : m_builtSegmentIndices) {
+        BeltSegment& segment = m_beltSegments[static_cast<std::size_t>(segmentIndex)];
+        const BeltTopologyNode& head = m_beltTopology[static_cast<std::size_t>(segment.beltIds.front())];
+        const BeltTopologyNode& tail = m_beltTopology[static_cast<std::size_t>(segment.beltIds.back())];
+        linkBeltSegment(
+            segmentIndex,
+            (tail.nextBeltId >= 0) ? m_beltTopology[static_cast<std::size_t>(tail.nextBeltId)].segmentIndex : -1
+        );
+        forEachBeltFeeding(head.cell, [&](std::int32_t feederId) {
+            const std::int32_t feederSegment = m_beltTopology[static_cast<std::size_t>(feederId)].segmentIndex;
+            if (feederSegment >= 0) {
+                linkBeltSegment(feederSegment, segmentIndex);
+            }
+        });
+        m_segmentBoundsMin[static_cast<std::size_t>(segmentIndex)] = odai::math::Vector3{
+            static_cast<float>(std::min(head.cell.x, tail.cell.x)),
+            static_cast<float>(head.cell.y),
+            static_cast<float>(std::min(head.cell.z, tail.cell.z))
+        };
+        m_segmentBoundsMax[static_cast<std::size_t>(segmentIndex)] = odai::math::Vector3{
+            static_cast<float>(std::max(head.cell.x, tail.cell.x) + 1),
+            static_cast<float>(head.cell.y) + 1.0f,
+            static_cast<float>(std::max(head.cell.z, tail.cell.z) + 1)
+        };
     }
+}
 
-    for (std::size_t slot = 0; slot < m_beltEntryIndices.size(); ++slot) {
-        const std::int32_t entryIndex = m_beltEntryIndices[slot];
-        if (entryIndex >= 0 && static_cast<std::size_t>(entryIndex) < m_beltIndexToEntrySlot.size()) {
-            m_beltIndexToEntrySlot[static_cast<std::size_t>(entryIndex)] = static_cast<std::int32_t>(slot);
+inline std::int32_t Simulation::buildBeltSegmentFrom(std::int32_t headBeltId) {
+    std::int32_t segmentIndex = 0;
+    if (!m_freeSegmentIndices.empty()) {
+        segmentIndex = m_freeSegmentIndices.back();
+        m_freeSegmentIndices.pop_back();
+    } else {
+        segmentIndex = static_cast<std::int32_t>(m_beltSegments.size());
+        m_beltSegments.emplace_back();
+        m_segmentBoundsMin.emplace_back();
+        m_segmentBoundsMax.emplace_back();
+    }
+    BeltSegment& segment = m_beltSegments[static_cast<std::size_t>(segmentIndex)];
+    const BeltTopologyNode& head = m_beltTopology[static_cast<std::size_t>(headBeltId)];
+    const BeltEdgeData& edge = m_belts[static_cast<std::size_t>(head.beltIndex)].edge;
+    segment.direction = head.direction;
+    segment.speedFactor = static_cast<std::uint32_t>(std::min(edge.speedTier, kMaxBeltSpeedTier)) + 1u;
+    segment.spacingQ16 = static_cast<std::int64_t>(edge.slotSpacingQ8) << 8;
+    segment.lanes.resize(beltLaneCount(headBeltId));
+    std::int32_t beltId = headBeltId;
+    for (;;) {
+        BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(beltId)];
+        node.segmentIndex = segmentIndex;
+        node.segmentSlot = static_cast<std::uint32_t>(segment.beltIds.size());
+        segment.beltIds.push_back(beltId);
+        const std::int32_t nextBeltId = node.nextBeltId;
+        if (nextBeltId < 0 ||
+            m_beltTopology[static_cast<std::size_t>(nextBeltId)].segmentIndex >= 0 ||
+            beltStartsSegment(nextBeltId)) {
+            break;
         }
+        beltId = nextBeltId;
     }
-    m_entrySlotMinAlongQ16.assign(m_beltEntryIndices.size(), kSpanQ16);
+    return segmentIndex;
 }
 
-inline void Simulation::updateCargoWorldPosition(BeltCargo& cargo) {
-    if (cargo.beltIndex < 0 || static_cast<std::size_t>(cargo.beltIndex) >= m_beltTopology.size()) {
+inline void Simulation::linkBeltSegment(std::int32_t segmentIndex, std::int32_t nextSegmentIndex) {
+    BeltSegment& segment = m_beltSegments[static_cast<std::size_t>(segmentIndex)];
+    segment.nextSegmentIndex = nextSegmentIndex;
+    segment.nextEntryLane = (nextSegmentIndex >= 0) ? sideLoadLane(segment.beltIds.back(), nextSegmentIndex) : -1;
+}
+
+// A belt feeding a junction (a tee or cross by classifyJoinPiece) from the
+// side puts its items on the near lane of the run it joins: the leftmost
+// lane from the left, the rightmost from the right. Straight-on feeders and
+// plain turns keep each item's lane.
+inline std::int32_t Simulation::sideLoadLane(std::int32_t feederBeltId, std::int32_t segmentIndex) const {
+    const BeltSegment& segment = m_beltSegments[static_cast<std::size_t>(segmentIndex)];
+    const BeltTopologyNode& head = m_beltTopology[static_cast<std::size_t>(segment.beltIds.front())];
+    const BeltTopologyNode& feeder = m_beltTopology[static_cast<std::size_t>(feederBeltId)];
+    if (feeder.direction == head.direction) {
+        return -1;
+    }
+    std::uint8_t mask = odai::core::dirBit(beltDirectionToDir6(head.direction));
+    forEachBeltFeeding(head.cell, [&](std::int32_t feederId) {
+        const BeltDirection direction = m_beltTopology[static_cast<std::size_t>(feederId)].direction;
+        mask = static_cast<std::uint8_t>(mask | odai::core::dirBit(odai::core::oppositeDir(beltDirectionToDir6(direction))));
+    });
+    const JoinPiece piece = classifyJoinPiece(mask);
+    if (piece != JoinPiece::Tee && piece != JoinPiece::Cross) {
+        return -1;
+    }
+    // Left of travel direction (x, z) is (z, -x).
+    const odai::core::Cell3i axis = beltDirectionOffset(head.direction);
+    const odai::core::Cell3i side = feeder.cell - head.cell;
+    const bool fromLeft = ((side.x * axis.z) - (side.z * axis.x)) > 0;
+    return fromLeft ? 0 : static_cast<std::int32_t>(segment.lanes.size()) - 1;
+}
+
+inline std::int64_t Simulation::laneBackPositionQ16(const BeltSegment& segment, const BeltSegmentLane& lane) const {
+    return segment.lengthQ16() - (lane.frontDistanceQ16 + lane.trailingGapQ16);
+}
+
+// Inserts an item at positionQ16 from the segment start, behind any item at
+// the same position in its lane. New items almost always join at the back
+// (spawns, hand-offs), so the search walks forward from there.
+inline void Simulation::pushBeltCargo(
+    std::int32_t segmentIndex,
+    std::uint32_t laneIndex,
+    std::int64_t positionQ16,
+    std::uint32_t itemId,
+    std::uint16_t typeId
+) {
+    if (segmentIndex < 0 || static_cast<std::size_t>(segmentIndex) >= m_beltSegments.size()) {
         return;
     }
-    const BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(cargo.beltIndex)];
+    BeltSegment& segment = m_beltSegments[static_cast<std::size_t>(segmentIndex)];
+    BeltSegmentLane& lane = segment.lanes[laneIndex];
+    ++m_beltCargoCount;
+    m_beltCargoesValid = false;
+    BeltSegmentItem item{itemId, typeId, 0};
+    if (lane.empty()) {
+        lane.items.clear();
+        lane.items.push_back(item);
+        lane.frontItem = 0;
+        lane.frontDistanceQ16 = segment.lengthQ16() - positionQ16;
+        lane.trailingGapQ16 = 0;
+        lane.compressedCount = 0;
+        lane.slowUntilItem = 0;
+        return;
+    }
+
+    std::int64_t behindPositionQ16 = laneBackPositionQ16(segment, lane);
+    if (positionQ16 <= behindPositionQ16) {
+        item.gapQ16 = behindPositionQ16 - positionQ16;
+        lane.trailingGapQ16 += item.gapQ16;
+        if (lane.compressedCount + 1u == lane.itemCount() && item.gapQ16 == segment.spacingQ16) {
+            ++lane.compressedCount;
+        }
+        lane.items.push_back(item);
+        return;
+    }
+
+    // Anything else shifts the items behind the front, so the queue is
+    // measured afresh the next time it closes up.
+    lane.compressedCount = 0;
+    lane.slowUntilItem = 0;
+    // items[behind] is the last item the new one is ahead of.
+    std::size_t behind = lane.items.size() - 1u;
+    while (behind > lane.frontItem) {
+        const std::int64_t aheadPositionQ16 = behindPositionQ16 + lane.items[behind].gapQ16;
+        if (aheadPositionQ16 >= positionQ16) {
+            break;
+        }
+        behindPositionQ16 = aheadPositionQ16;
+        --behind;
+    }
+
+    if (behind == lane.frontItem) {
+        // New front item.
+        lane.items[behind].gapQ16 = positionQ16 - behindPositionQ16;
+        lane.trailingGapQ16 += lane.items[behind].gapQ16;
+        lane.frontDistanceQ16 = segment.lengthQ16() - positionQ16;
+        if (lane.frontItem > 0u) {
+            lane.items[--lane.frontItem] = item;
+        } else {
+            lane.items.insert(lane.items.begin(), item);
+        }
+        return;
+    }
+
+    const std::int64_t aheadPositionQ16 = behindPositionQ16 + lane.items[behind].gapQ16;
+    item.gapQ16 = aheadPositionQ16 - positionQ16;
+    lane.items[behind].gapQ16 = positionQ16 - behindPositionQ16;
+    lane.items.insert(lane.items.begin() + static_cast<std::ptrdiff_t>(behind), item);
+}
+
+inline void Simulation::beltWorldPosition(
+    std::int32_t beltId,
+    std::uint32_t alongQ16,
+    std::uint32_t lane,
+    float outWorldPos[3]
+) const {
+    const BeltTopologyNode& node = m_beltTopology[static_cast<std::size_t>(beltId)];
     const odai::core::Cell3i axis = beltDirectionOffset(node.direction);
-    const float along01 = static_cast<float>(cargo.alongQ16) / static_cast<float>(kSpanQ16);
+    const float along01 = static_cast<float>(alongQ16) / static_cast<float>(kSpanQ16);
     const float alongCentered = along01 - 0.5f;
-    cargo.currWorldPos[0] = static_cast<float>(node.cell.x) + 0.5f + (static_cast<float>(axis.x) * alongCentered);
-    cargo.currWorldPos[1] = static_cast<float>(node.cell.y) + kCargoLiftAboveBelt;
-    cargo.currWorldPos[2] = static_cast<float>(node.cell.z) + 0.5f + (static_cast<float>(axis.z) * alongCentered);
+    // Lanes spread evenly to the left (+) and right (-) of the belt centre.
+    const std::uint32_t laneCount = beltLaneCount(beltId);
+    const float laneOffset = (laneCount > 1u)
+        ? kBeltLaneSpreadVoxels *
+              (0.5f - (static_cast<float>(std::min(lane, laneCount - 1u)) / static_cast<float>(laneCount - 1u)))
+        : 0.0f;
+    outWorldPos[0] = static_cast<float>(node.cell.x) + 0.5f + (static_cast<float>(axis.x) * alongCentered) +
+                     (static_cast<float>(axis.z) * laneOffset);
+    outWorldPos[1] = static_cast<float>(node.cell.y) + kCargoLiftAboveBelt;
+    outWorldPos[2] = static_cast<float>(node.cell.z) + 0.5f + (static_cast<float>(axis.z) * alongCentered) -
+                     (static_cast<float>(axis.x) * laneOffset);
 }
 
-inline void Simulation::seedBeltCargo() {
-    m_beltCargoes.clear();
-    if (m_beltEntryIndices.empty()) {
+inline void Simulation::materializeSegmentCargo(std::size_t segmentIndex, std::vector<BeltCargo>& outCargo) const {
+    const BeltSegment& segment = m_beltSegments[segmentIndex];
+    if (segment.empty()) {
         return;
     }
+    const auto beltAt = [&](std::int64_t positionQ16) {
+        return segment.beltIds[static_cast<std::size_t>(positionQ16 >> 16)];
+    };
+    const auto alongAt = [](std::int64_t positionQ16) {
+        return static_cast<std::uint32_t>(positionQ16 & (kSpanQ16 - 1u));
+    };
+    for (std::uint32_t laneIndex = 0; laneIndex < segment.lanes.size(); ++laneIndex) {
+        const BeltSegmentLane& lane = segment.lanes[laneIndex];
+        std::int64_t positionQ16 = segment.lengthQ16() - lane.frontDistanceQ16;
+        for (std::size_t itemIndex = lane.frontItem; itemIndex < lane.items.size(); ++itemIndex) {
+            const BeltSegmentItem& item = lane.items[itemIndex];
+            if (itemIndex != lane.frontItem) {
+                positionQ16 -= item.gapQ16;
+            }
+            const std::int32_t beltId = beltAt(positionQ16);
 
-    const std::size_t maxSeedCount = std::min(m_beltEntryIndices.size(), static_cast<std::size_t>(24));
-    m_beltCargoes.reserve(maxSeedCount);
-    for (std::size_t i = 0; i < maxSeedCount; ++i) {
-        const std::int32_t entryIndex = m_beltEntryIndices[i];
-        if (entryIndex < 0 || static_cast<std::size_t>(entryIndex) >= m_beltTopology.size()) {
-            continue;
+            BeltCargo cargo{};
+            cargo.itemId = item.itemId;
+            cargo.typeId = item.typeId;
+            cargo.beltIndex = m_beltTopology[static_cast<std::size_t>(beltId)].beltIndex;
+            cargo.beltId = static_cast<std::uint32_t>(beltId);
+            cargo.alongQ16 = alongAt(positionQ16);
+            cargo.lane = static_cast<std::uint8_t>(laneIndex);
+            beltWorldPosition(beltId, cargo.alongQ16, laneIndex, cargo.currWorldPos);
+            const std::int64_t stepQ16 = (itemIndex < lane.slowUntilItem) ? lane.slowFrontStepQ16 : segment.lastStepQ16;
+            const auto crossing = (positionQ16 <= m_lastMaxBeltStepQ16)
+                ? m_beltCargoCrossingByItem.find(item.itemId)
+                : m_beltCargoCrossingByItem.end();
+            if (crossing != m_beltCargoCrossingByItem.end() &&
+                m_beltTopology[static_cast<std::size_t>(m_beltCargoCrossings[crossing->second].beltId)].beltIndex >= 0) {
+                const BeltCargoPlacement& from = m_beltCargoCrossings[crossing->second];
+                beltWorldPosition(from.beltId, from.alongQ16, from.lane, cargo.prevWorldPos);
+            } else if (positionQ16 >= stepQ16) {
+                const std::int64_t previousQ16 = positionQ16 - stepQ16;
+                beltWorldPosition(beltAt(previousQ16), alongAt(previousQ16), laneIndex, cargo.prevWorldPos);
+            } else {
+                std::copy(cargo.currWorldPos, cargo.currWorldPos + 3, cargo.prevWorldPos);
+            }
+            outCargo.push_back(cargo);
         }
-        BeltCargo cargo{};
-        cargo.itemId = m_nextCargoId++;
-        cargo.typeId = static_cast<std::uint16_t>(cargo.itemId % 5u);
-        cargo.beltIndex = entryIndex;
-        cargo.alongQ16 = 0u;
-        updateCargoWorldPosition(cargo);
-        cargo.prevWorldPos[0] = cargo.currWorldPos[0];
-        cargo.prevWorldPos[1] = cargo.currWorldPos[1];
-        cargo.prevWorldPos[2] = cargo.currWorldPos[2];
-        m_beltCargoes.push_back(cargo);
+    }
+}
+
+inline void Simulation::seedBeltCargo() {
+    const std::size_t maxSeedCount = std::min(beltEntryCount(), static_cast<std::size_t>(24));
+    for (std::size_t i = 0; i < maxSeedCount; ++i) {
+        const BeltTopologyNode& entry = m_beltTopology[static_cast<std::size_t>(beltEntryId(i))];
+        const std::uint32_t itemId = m_nextCargoId++;
+        pushBeltCargo(
+            entry.segmentIndex,
+            0u,
+            static_cast<std::int64_t>(entry.segmentSlot) * kSpanQ16,
+            itemId,
+            static_cast<std::uint16_t>(itemId % 5u)
+        );
     }
 }
 
 inline void Simulation::trySpawnBeltCargo() {
-    if (m_beltEntryIndices.empty() || m_beltTopology.empty()) {
+    const std::size_t entryCount = beltEntryCount();
+    if (entryCount == 0u) {
         return;
     }
 
@@ -298,106 +1223,308 @@ inline void Simulation::trySpawnBeltCargo() {
     }
 
     const std::size_t maxCargoCount = std::max<std::size_t>(1u, m_belts.size() * kMaxCargoPerBelt);
-    if (m_beltCargoes.size() >= maxCargoCount) {
+    if (m_beltCargoCount >= maxCargoCount) {
         return;
     }
 
-    const std::size_t entryCursor = static_cast<std::size_t>((m_tickCounter / kSpawnIntervalTicks) % m_beltEntryIndices.size());
-    const std::int32_t entryIndex = m_beltEntryIndices[entryCursor];
-    if (entryIndex < 0 || static_cast<std::size_t>(entryIndex) >= m_beltTopology.size()) {
+    const std::size_t spawnRound = static_cast<std::size_t>(m_tickCounter / kSpawnIntervalTicks);
+    const std::int32_t entryBeltId = beltEntryId(spawnRound % entryCount);
+    // Each pass over the entries feeds the next lane.
+    const std::uint32_t lane = static_cast<std::uint32_t>((spawnRound / entryCount) % beltLaneCount(entryBeltId));
+    if (hasCargoBlockingEntry(entryBeltId, lane)) {
         return;
     }
 
-    if (hasCargoBlockingEntry(entryIndex)) {
-        return;
-    }
+    const BeltTopologyNode& entry = m_beltTopology[static_cast<std::size_t>(entryBeltId)];
+    const std::uint32_t itemId = m_nextCargoId++;
+    pushBeltCargo(
+        entry.segmentIndex,
+        lane,
+        static_cast<std::int64_t>(entry.segmentSlot) * kSpanQ16,
+        itemId,
+        static_cast<std::uint16_t>(itemId % 5u)
+    );
+}
 
-    BeltCargo cargo{};
-    cargo.itemId = m_nextCargoId++;
-    cargo.typeId = static_cast<std::uint16_t>(cargo.itemId % 5u);
-    cargo.beltIndex = entryIndex;
-    cargo.alongQ16 = 0u;
-    updateCargoWorldPosition(cargo);
-    cargo.prevWorldPos[0] = cargo.currWorldPos[0];
-    cargo.prevWorldPos[1] = cargo.currWorldPos[1];
-    cargo.prevWorldPos[2] = cargo.currWorldPos[2];
-    m_beltCargoes.push_back(cargo);
-}
-
-inline bool Simulation::hasCargoBlockingEntry(std::int32_t entryIndex) const {
-    // O(1) lookup instead of scanning every live cargo item: m_entrySlotMinAlongQ16 is
-    // kept up to date as a side effect of the per-cargo pass in updateBeltCargo(), which
-    // already visits every cargo item once per tick regardless. At thousands of cargo
-    // and hundreds of belt entry points, the old linear scan over m_beltCargoes cost
-    // O(total cargo) on every spawn-interval tick; this is O(1) here plus O(numEntries)
-    // amortized in the pass that was happening anyway.
-    if (entryIndex < 0 || static_cast<std::size_t>(entryIndex) >= m_beltIndexToEntrySlot.size()) {
+inline bool Simulation::hasCargoBlockingEntry(std::int32_t entryBeltId, std::uint32_t laneIndex) const {
+    // Entry belts head their segment, so this normally stops at the back item;
+    // only the stand-in entry of an all-loop network can sit further in.
+    const BeltTopologyNode& entry = m_beltTopology[static_cast<std::size_t>(entryBeltId)];
+    if (entry.segmentIndex < 0) {
         return false;
     }
-    const std::int32_t slot = m_beltIndexToEntrySlot[static_cast<std::size_t>(entryIndex)];
-    if (slot < 0 || static_cast<std::size_t>(slot) >= m_entrySlotMinAlongQ16.size()) {
+    const BeltSegment& segment = m_beltSegments[static_cast<std::size_t>(entry.segmentIndex)];
+    const BeltSegmentLane& lane = segment.lanes[laneIndex];
+    if (lane.empty()) {
         return false;
     }
-    return m_entrySlotMinAlongQ16[static_cast<std::size_t>(slot)] < kSpawnMinSpacingQ16;
+    const std::int64_t spacingQ16 = std::max<std::int64_t>(kSpawnMinSpacingQ16, segment.spacingQ16);
+    const std::int64_t entryStartQ16 = static_cast<std::int64_t>(entry.segmentSlot) * kSpanQ16;
+    std::int64_t positionQ16 = laneBackPositionQ16(segment, lane);
+    std::size_t itemIndex = lane.items.size() - 1u;
+    while (positionQ16 < entryStartQ16 && itemIndex > lane.frontItem) {
+        positionQ16 += lane.items[itemIndex].gapQ16;
+        --itemIndex;
+    }
+    return positionQ16 >= entryStartQ16 && positionQ16 < entryStartQ16 + spacingQ16;
 }
 
 inline void Simulation::updateBeltCargo(float dt) {
-    if (m_beltTopology.empty()) {
-        m_beltCargoes.clear();
+    if (m_belts.empty()) {
         return;
     }
 
     const float clampedDt = std::max(dt, 0.0f);
-    const std::uint32_t stepQ16 = std::max(
-        1u,
-        static_cast<std::uint32_t>(std::lround(clampedDt * kCargoSpeedVoxelsPerSecond * static_cast<float>(kSpanQ16)))
+    const std::int64_t stepQ16 = std::max<std::int64_t>(
+        1,
+        static_cast<std::int64_t>(std::lround(clampedDt * kCargoSpeedVoxelsPerSecond * static_cast<float>(kSpanQ16)))
     );
+    const std::uint64_t elapsedUs = static_cast<std::uint64_t>(std::llround(static_cast<double>(clampedDt) * 1e6));
+
+    m_beltCargoCrossings.clear();
+    m_beltCargoCrossingByItem.clear();
+    m_beltCargoTransfers.clear();
+    m_beltCargoesValid = false;
+    m_lastMaxBeltStepQ16 = stepQ16;
 
-    for (BeltCargo& cargo : m_beltCargoes) {
-        cargo.prevWorldPos[0] = cargo.currWorldPos[0];
-        cargo.prevWorldPos[1] = cargo.currWorldPos[1];
-        cargo.prevWorldPos[2] = cargo.currWorldPos[2];
+    // Advance every lane by moving only its front item, then hand off the
+    // items that ran off the end. Hand-offs land after every segment has
+    // moved so no item advances twice in one tick; the room they need on the
+    // next lane is claimed as they leave.
+    for (std::size_t segmentIndex = 0; segmentIndex < m_beltSegments.size(); ++segmentIndex) {
+        BeltSegment& segment = m_beltSegments[segmentIndex];
+        if (segment.beltIds.empty()) {
+            continue;
+        }
+        segment.lastStepQ16 = stepQ16 * segment.speedFactor;
+        m_lastMaxBeltStepQ16 = std::max(m_lastMaxBeltStepQ16, segment.lastStepQ16);
+        ++segment.counters.ticks;
+        segment.counters.elapsedUs += elapsedUs;
+        segment.counters.itemTicks += segment.itemCount();
+        for (std::uint32_t laneIndex = 0; laneIndex < segment.lanes.size(); ++laneIndex) {
+            if (!segment.lanes[laneIndex].empty()) {
+                advanceBeltLane(segmentIndex, laneIndex, segment.lastStepQ16);
+            }
+        }
     }
 
-    std::fill(m_entrySlotMinAlongQ16.begin(), m_entrySlotMinAlongQ16.end(), kSpanQ16);
+    for (const BeltCargoTransfer& transfer : m_beltCargoTransfers) {
+        if (transfer.toSegmentIndex < 0) {
+            continue;
+        }
+        pushBeltCargo(
+            transfer.toSegmentIndex,
+            transfer.toLane,
+            transfer.toPositionQ16,
+            transfer.from.itemId,
+            transfer.from.typeId
+        );
+        m_beltCargoCrossingByItem[transfer.from.itemId] = m_beltCargoCrossings.size();
+        m_beltCargoCrossings.push_back(transfer.from);
+    }
 
-    std::erase_if(m_beltCargoes, [&](BeltCargo& cargo) {
-        if (cargo.beltIndex < 0 || static_cast<std::size_t>(cargo.beltIndex) >= m_beltTopology.size()) {
-            return true;
+    ++m_tickCounter;
+    if ((m_tickCounter % kThroughputWindowTicks) == 0u) {
+        publishBeltThroughput();
+    }
+    trySpawnBeltCargo();
+}
+
+inline void Simulation::advanceBeltLane(std::size_t segmentIndex, std::uint32_t laneIndex, std::int64_t stepQ16) {
+    BeltSegment& segment = m_beltSegments[segmentIndex];
+    BeltSegmentLane& lane = segment.lanes[laneIndex];
+    lane.slowUntilItem = lane.frontItem;
+    lane.frontDistanceQ16 -= stepQ16;
+    while (lane.frontDistanceQ16 <= 0) {
+        const BeltSegmentItem& front = lane.items[lane.frontItem];
+        const std::int64_t fromPositionQ16 = segment.lengthQ16() - (lane.frontDistanceQ16 + stepQ16);
+        BeltCargoTransfer transfer{};
+        transfer.from.itemId = front.itemId;
+        transfer.from.typeId = front.typeId;
+        transfer.from.beltId = segment.beltIds[static_cast<std::size_t>(fromPositionQ16 >> 16)];
+        transfer.from.alongQ16 = static_cast<std::uint32_t>(fromPositionQ16 & (kSpanQ16 - 1u));
+        transfer.from.lane = static_cast<std::uint8_t>(laneIndex);
+        if (!claimBeltEntry(segmentIndex, laneIndex, -lane.frontDistanceQ16, transfer)) {
+            // No room downstream: the front waits on the last step of the lane
+            // and the items behind close up on it.
+            if (lane.frontBlockedSinceTick == ~0u) {
+                lane.frontBlockedSinceTick = m_tickCounter;
+            }
+            const std::int64_t frontStepQ16 = lane.frontDistanceQ16 + stepQ16 - 1;
+            lane.frontDistanceQ16 = 1;
+            ++segment.counters.blockedLaneTicks;
+            closeUpBeltLane(lane, segment.spacingQ16, stepQ16, frontStepQ16);
+            break;
+        }
+        m_beltCargoTransfers.push_back(transfer);
+        --m_beltCargoCount;
+        ++segment.counters.exitedItems;
+        lane.frontBlockedSinceTick = ~0u;
+
+        ++lane.frontItem;
+        lane.slowUntilItem = lane.frontItem;
+        lane.compressedCount = (lane.compressedCount > 0u) ? lane.compressedCount - 1u : 0u;
+        if (lane.empty()) {
+            lane.items.clear();
+            lane.frontItem = 0;
+            lane.frontDistanceQ16 = 0;
+            lane.trailingGapQ16 = 0;
+            lane.slowUntilItem = 0;
+            break;
         }
+        const std::int64_t gapQ16 = lane.items[lane.frontItem].gapQ16;
+        lane.frontDistanceQ16 += gapQ16;
+        lane.trailingGapQ16 -= gapQ16;
+    }
+    if (lane.frontItem > 32u && (lane.frontItem * 2u) > lane.items.size()) {
+        lane.items.erase(lane.items.begin(), lane.items.begin() + static_cast<std::ptrdiff_t>(lane.frontItem));
+        lane.slowUntilItem -= lane.frontItem;
+        lane.frontItem = 0;
+    }
+}
 
-        std::uint32_t alongQ16 = cargo.alongQ16 + stepQ16;
-        std::int32_t beltIndex = cargo.beltIndex;
-        std::size_t hopCount = 0;
-        while (alongQ16 >= kSpanQ16) {
-            alongQ16 -= kSpanQ16;
-            const std::int32_t nextIndex = m_beltTopology[static_cast<std::size_t>(beltIndex)].nextBeltIndex;
-            if (nextIndex < 0) {
-                return true;
+// Finds where an item running overflowQ16 past the end of `from` joins the
+// next lane and claims that room for the rest of the tick. A free-flow lane
+// takes the item where it lands; a spaced lane takes it no closer than its
+// spacing behind the rearmost item or claim, and refuses it when that would
+// put it before the lane start or another lane has waited longer for it.
+// Returns false only on a refusal; an item with nowhere to go leaves the
+// network with toSegmentIndex -1.
+inline bool Simulation::claimBeltEntry(
+    std::size_t fromSegmentIndex,
+    std::uint32_t laneIndex,
+    std::int64_t overflowQ16,
+    BeltCargoTransfer& transfer
+) {
+    const BeltSegment& from = m_beltSegments[fromSegmentIndex];
+    const std::uint32_t waiterKey = static_cast<std::uint32_t>(fromSegmentIndex) * kMaxBeltLanes + laneIndex;
+    const std::uint32_t blockedSinceTick = from.lanes[laneIndex].frontBlockedSinceTick;
+    const std::uint32_t waitingSinceTick = (blockedSinceTick != ~0u) ? blockedSinceTick : m_tickCounter;
+    std::int32_t segmentIndex = from.nextSegmentIndex;
+    std::uint32_t lane = (from.nextEntryLane >= 0) ? static_cast<std::uint32_t>(from.nextEntryLane) : laneIndex;
+    std::int64_t positionQ16 = overflowQ16;
+    // The last empty lane the item ran across, if a long step crossed one.
+    std::int32_t passedSegmentIndex = -1;
+    std::uint32_t passedLane = 0;
+    std::size_t hopCount = 0;
+    while (segmentIndex >= 0) {
+        BeltSegment& segment = m_beltSegments[static_cast<std::size_t>(segmentIndex)];
+        lane = std::min<std::uint32_t>(lane, static_cast<std::uint32_t>(segment.lanes.size()) - 1u);
+        BeltSegmentLane& target = segment.lanes[lane];
+        const bool claimed = target.entryClaimTick == m_tickCounter;
+        if (segment.spacingQ16 > 0 && (claimed || !target.empty())) {
+            std::int64_t rearQ16 = target.empty() ? segment.lengthQ16() : laneBackPositionQ16(segment, target);
+            if (claimed) {
+                rearQ16 = std::min(rearQ16, target.entryClaimQ16);
             }
-            beltIndex = nextIndex;
-            ++hopCount;
-            if (hopCount > m_beltTopology.size()) {
-                return true;
+            const std::int64_t limitQ16 = rearQ16 - segment.spacingQ16;
+            const bool waiterActive = target.waiterTick != ~0u && (m_tickCounter - target.waiterTick) <= 1u;
+            // Arbitration only applies at the lane an item runs onto, not
+            // after a long step carried it across empty lanes.
+            const bool otherWaiter = passedSegmentIndex < 0 && waiterActive && target.waiterKey != waiterKey;
+            if (limitQ16 >= 0 && !otherWaiter) {
+                positionQ16 = std::min(positionQ16, limitQ16);
+                if (waiterActive && target.waiterKey == waiterKey) {
+                    target.waiterTick = ~0u;
+                }
+            } else if (passedSegmentIndex >= 0) {
+                segmentIndex = passedSegmentIndex;
+                lane = passedLane;
+                positionQ16 = m_beltSegments[static_cast<std::size_t>(segmentIndex)].lengthQ16() - 1;
+            } else {
+                if (!waiterActive || target.waiterKey == waiterKey || waitingSinceTick < target.waiterSinceTick) {
+                    target.waiterKey = waiterKey;
+                    target.waiterSinceTick = waitingSinceTick;
+                    target.waiterTick = m_tickCounter;
+                }
+                return false;
             }
+            break;
+        }
+        if (positionQ16 < segment.lengthQ16()) {
+            break;
         }
+        positionQ16 -= segment.lengthQ16();
+        passedSegmentIndex = segmentIndex;
+        passedLane = lane;
+        lane = (segment.nextEntryLane >= 0) ? static_cast<std::uint32_t>(segment.nextEntryLane) : lane;
+        segmentIndex = segment.nextSegmentIndex;
+        hopCount += segment.beltIds.size();
+        if (hopCount > m_belts.size()) {
+            segmentIndex = -1;
+        }
+    }
 
-        cargo.beltIndex = beltIndex;
-        cargo.alongQ16 = alongQ16;
-        updateCargoWorldPosition(cargo);
+    transfer.toSegmentIndex = segmentIndex;
+    transfer.toLane = lane;
+    transfer.toPositionQ16 = positionQ16;
+    if (segmentIndex >= 0) {
+        BeltSegmentLane& target = m_beltSegments[static_cast<std::size_t>(segmentIndex)].lanes[lane];
+        target.entryClaimQ16 = (target.entryClaimTick == m_tickCounter) ? std::min(target.entryClaimQ16, positionQ16) : positionQ16;
+        target.entryClaimTick = m_tickCounter;
+    }
+    return true;
+}
 
-        if (beltIndex >= 0 && static_cast<std::size_t>(beltIndex) < m_beltIndexToEntrySlot.size()) {
-            const std::int32_t slot = m_beltIndexToEntrySlot[static_cast<std::size_t>(beltIndex)];
-            if (slot >= 0 && static_cast<std::size_t>(slot) < m_entrySlotMinAlongQ16.size()) {
-                std::uint32_t& slotMin = m_entrySlotMinAlongQ16[static_cast<std::size_t>(slot)];
-                slotMin = std::min(slotMin, alongQ16);
-            }
+// Moves the items behind a front that advanced only frontStepQ16 as far as
+// stepQ16 allows without closing to within spacingQ16 of the item ahead.
+// The compressed prefix already sits at the spacing and moves with the front,
+// so only the items still closing up are visited.
+inline void Simulation::closeUpBeltLane(
+    BeltSegmentLane& lane,
+    std::int64_t spacingQ16,
+    std::int64_t stepQ16,
+    std::int64_t frontStepQ16
+) {
+    std::size_t itemIndex = lane.frontItem + 1u + lane.compressedCount;
+    std::int64_t aheadStepQ16 = frontStepQ16;
+    for (; itemIndex < lane.items.size(); ++itemIndex) {
+        BeltSegmentItem& item = lane.items[itemIndex];
+        const std::int64_t itemStepQ16 = std::clamp<std::int64_t>(item.gapQ16 + aheadStepQ16 - spacingQ16, 0, stepQ16);
+        const std::int64_t gapQ16 = item.gapQ16 + aheadStepQ16 - itemStepQ16;
+        lane.trailingGapQ16 += gapQ16 - item.gapQ16;
+        item.gapQ16 = gapQ16;
+        if (gapQ16 == spacingQ16 && itemIndex == lane.frontItem + 1u + lane.compressedCount) {
+            ++lane.compressedCount;
         }
-        return false;
-    });
+        if (itemStepQ16 == stepQ16) {
+            // Every item further back keeps its gap and the full step.
+            break;
+        }
+        aheadStepQ16 = itemStepQ16;
+    }
+    lane.slowUntilItem = itemIndex;
+    lane.slowFrontStepQ16 = frontStepQ16;
+}
 
-    ++m_tickCounter;
-    trySpawnBeltCargo();
+// Turns the counters of the window that just ended into each run's
+// BeltThroughput and restarts them. Runs every kThroughputWindowTicks ticks,
+// so the per-tick cost of the counters is a few adds per segment.
+inline void Simulation::publishBeltThroughput() {
+    for (BeltSegment& segment : m_beltSegments) {
+        BeltSegmentCounters& counters = segment.counters;
+        if (segment.beltIds.empty() || counters.ticks == 0u) {
+            continue;
+        }
+        const std::uint64_t laneCount = segment.lanes.size();
+        const std::uint64_t laneCapacity = (segment.spacingQ16 > 0)
+            ? static_cast<std::uint64_t>(std::max<std::int64_t>(1, segment.lengthQ16() / segment.spacingQ16))
+            : segment.beltIds.size() * kMaxCargoPerBelt;
+        BeltThroughput& throughput = segment.throughput;
+        throughput.itemsPerMinuteQ8 = (counters.elapsedUs > 0u)
+            ? static_cast<std::uint32_t>(std::min<std::uint64_t>(
+                  0xFFFFFFFFull,
+                  (static_cast<std::uint64_t>(counters.exitedItems) * 60000000ull * 256ull) / counters.elapsedUs
+              ))
+            : 0u;
+        throughput.occupancyQ8 = static_cast<std::uint16_t>(
+            std::min<std::uint64_t>(256u, (counters.itemTicks * 256u) / (counters.ticks * laneCount * laneCapacity))
+        );
+        throughput.blockedQ8 = static_cast<std::uint16_t>(
+            std::min<std::uint64_t>(256u, (static_cast<std::uint64_t>(counters.blockedLaneTicks) * 256u) / (counters.ticks * laneCount))
+        );
+        counters = BeltSegmentCounters{};
+    }
 }
 
 } // namespace odai::sim
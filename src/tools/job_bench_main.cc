@@ -0,0 +1,76 @@
+// Headless JobSystem contention benchmark. Each round submits many tiny jobs
+// from the main thread and from inside jobs, waits on one counter, and checks
+// nothing was lost. The correctness half of this lives in
+// odai_job_system_tests; this is the throughput half, kept out of the unit
+// tests because CI machines vary too much for a pass/fail timing check.
+//
+// Usage: odai_job_bench [rounds] [workers]
+// Build optimized before reading the numbers -- see CLAUDE.md.
+
+#include "core/frame_profiler.h"
+#include "core/job_system.h"
+#include "tools/sim_bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+constexpr int kProducerJobs = 64;
+constexpr int kJobsPerProducer = 2048;
+constexpr int kJobsPerRound = kProducerJobs * (kJobsPerProducer + 1);
+
+// Returns false if any job was lost or ran twice.
+bool runContentionRound(odai::core::JobSystem& jobs) {
+    std::atomic<std::int64_t> sum{0};
+    odai::core::JobCounter all;
+    for (int producer = 0; producer < kProducerJobs; ++producer) {
+        jobs.enqueue([&jobs, &sum, &all]() {
+            for (int i = 0; i < kJobsPerProducer; ++i) {
+                jobs.enqueue([&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); },
+                             odai::core::JobPriority::Normal, &all);
+            }
+        }, odai::core::JobPriority::High, &all);
+    }
+    jobs.wait(all);
+    const std::int64_t expectedSum =
+        static_cast<std::int64_t>(kProducerJobs) * ((static_cast<std::int64_t>(kJobsPerProducer) - 1) * kJobsPerProducer / 2);
+    return sum.load() == expectedSum;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int rounds = 20;
+    unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    if (argc > 1) rounds = std::max(1, std::atoi(argv[1]));
+    if (argc > 2) workers = static_cast<unsigned>(std::max(1, std::atoi(argv[2])));
+
+    odai::core::JobSystem jobs(workers);
+    odai::tools::SimBench bench;
+    // One untimed round so worker start-up and first-touch allocations stay
+    // out of the numbers.
+    bool allRan = runContentionRound(jobs);
+    odai::core::Stopwatch watch;
+    for (int round = 0; round < rounds; ++round) {
+        watch.restart();
+        allRan = runContentionRound(jobs) && allRan;
+        bench.addMatchMs(watch.lapMs());
+    }
+
+    const odai::core::JobSystemStats stats = jobs.stats();
+    std::cout << "==== job system contention: " << rounds << " rounds x " << kJobsPerRound << " jobs, "
+              << jobs.workerCount() << " workers ====\n";
+    std::cout << "stolen jobs : " << stats.jobsStolen << "\n";
+    std::cout << "heap jobs   : " << stats.heapAllocatedJobs << "\n";
+    bench.report(std::cout, kJobsPerRound, "round", "job");
+    if (!allRan) {
+        std::cerr << "job bench: a contention round lost or repeated jobs\n";
+        return 1;
+    }
+    return 0;
+}
@@ -7,10 +7,12 @@
 #include <cstddef>
 #include <iomanip>
 #include <ostream>
+#include <string>
 #include <vector>
 
 // Wall-clock collection for the headless sweep harnesses (odai_civ_sim,
-// odai_stellaris_sim).
+// odai_stellaris_sim) and the engine micro-harnesses (odai_job_bench and
+// friends), which time repeated runs of a fixed workload the same way.
 //
 // Those sweeps already replay N deterministic seeded matches with no renderer
 // and no window -- structurally they were already a CPU benchmark, they just
@@ -30,7 +32,14 @@ public:
 
     [[nodiscard]] std::size_t matchCount() const { return m_matchMs.size(); }
 
-    void report(std::ostream& out, int turnsPerMatch) const {
+    // `runLabel` and `stepLabel` name what a match and a turn are for harnesses
+    // that are not turn-based ("round"/"job", "run"/"tick").
+    void report(
+        std::ostream& out,
+        int turnsPerMatch,
+        const char* runLabel = "match",
+        const char* stepLabel = "turn"
+    ) const {
         if (m_matchMs.empty() || turnsPerMatch <= 0) {
             return;
         }
@@ -65,21 +74,30 @@ public:
                 << " s (excluded from throughput)\n"
                 << std::setprecision(2);
         }
-        out << "  match      : mean " << (matchTotal / matches)
+        out << "  " << std::left << std::setw(11) << runLabel << std::right << ": mean " << (matchTotal / matches)
             << " ms   median " << percentile(m_matchMs, 0.50f)
             << "   p95 " << percentile(m_matchMs, 0.95f)
             << "   max " << percentile(m_matchMs, 1.0f) << "\n";
-        out << "  turn       : mean " << ((matchTotal * 1000.0) / totalTurns) << " us\n";
+        out << "  " << std::left << std::setw(11) << stepLabel << std::right << ": mean "
+            << ((matchTotal * 1000.0) / totalTurns) << " us\n";
         out << "  throughput : " << std::setprecision(0) << (totalTurns / matchSeconds)
-            << " turns/sec   (" << m_matchMs.size() << " matches x " << turnsPerMatch
+            << " " << plural(stepLabel) << "/sec   (" << m_matchMs.size() << " " << plural(runLabel) << " x "
+            << turnsPerMatch
             // Three decimals so a fast sweep reads "0.002 s" instead of "0.00 s".
-            << " turns in " << std::setprecision(3) << matchSeconds << " s)\n";
+            << " " << plural(stepLabel) << " in " << std::setprecision(3) << matchSeconds << " s)\n";
 
         out.flags(saved);
         out.precision(savedPrecision);
     }
 
 private:
+    static std::string plural(const char* label) {
+        std::string text = label;
+        const char last = text.empty() ? '\0' : text.back();
+        text += (last == 'h' || last == 's' || last == 'x') ? "es" : "s";
+        return text;
+    }
+
     static double sum(const std::vector<float>& values) {
         double total = 0.0;
         for (float v : values) total += static_cast<double>(v);
@@ -0,0 +1,161 @@
+// Headless sim network benchmark. Times the large layouts the sim network
+// gtests check for correctness (see tools/sim_network_layouts.h), kept out of
+// the unit tests because CI machines vary too much for a pass/fail timing check.
+//
+//   pipes : 16 pipe grids of 64x25 (~50k edges); target < 1 ms per tick.
+//           Ticked serially and then through a JobSystem.
+//   rail  : 500 trains on 20 one-way rings with passing loops.
+//   belts : 100k items on a 200-row serpentine of gap-encoded belt segments.
+//
+// Each run is [ticks] ticks of the same sim, after one untimed warm-up tick
+// that builds the snapshot, route tables or belt topology.
+//
+// Usage: odai_sim_network_bench [mode] [runs] [ticks] [workers]
+// Build optimized before reading the numbers -- see CLAUDE.md.
+
+#include "core/frame_profiler.h"
+#include "core/job_system.h"
+#include "sim/network_graph.h"
+#include "sim/pipe_fluid_solver.h"
+#include "sim/rail_traffic.h"
+#include "sim/simulation.h"
+#include "tools/sim_bench.h"
+#include "tools/sim_network_layouts.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+struct BenchArgs {
+    int runs = 10;
+    int ticks = 200;
+    unsigned workers = 2;
+};
+
+void runPipes(const BenchArgs& args) {
+    odai::core::JobSystem jobs(args.workers);
+    for (const bool parallel : {false, true}) {
+        odai::sim::NetworkGraph graph;
+        odai::sim::PipeFluidSolver solver;
+        odai::tools::SimBench bench;
+        odai::core::Stopwatch watch;
+        odai::tools::buildLargePipeNetwork(graph, solver);
+        odai::core::JobSystem* tickJobs = parallel ? &jobs : nullptr;
+        solver.tick(graph, tickJobs);
+        bench.addWorldgenMs(watch.lapMs());
+        for (int run = 0; run < args.runs; ++run) {
+            watch.restart();
+            for (int tick = 0; tick < args.ticks; ++tick) {
+                solver.tick(graph, tickJobs);
+            }
+            bench.addMatchMs(watch.lapMs());
+        }
+
+        std::cout << "==== pipes " << (parallel ? "parallel" : "serial") << ": " << graph.edgeCount() << " edges, "
+                  << solver.componentCount() << " components";
+        if (parallel) {
+            std::cout << ", " << jobs.workerCount() << " workers";
+        }
+        std::cout << " ====\n";
+        std::cout << "units moved last tick : " << solver.lastTickStats().movedUnits << "\n";
+        bench.report(std::cout, args.ticks, "run", "tick");
+        std::cout << "\n";
+    }
+}
+
+// Returns false if any train deadlocked or lost its route.
+bool runRail(const BenchArgs& args) {
+    odai::sim::NetworkGraph graph;
+    odai::sim::RailTrafficSim rail;
+    odai::tools::SimBench bench;
+    odai::core::Stopwatch watch;
+    const odai::tools::RailRingLayout layout = odai::tools::buildRailRingLayout(graph, rail);
+    for (const odai::sim::RailTrainDesc& desc : layout.trains) {
+        if (rail.addTrain(graph, desc) == odai::sim::kInvalidTrainId) {
+            std::cerr << "sim network bench: rail layout rejected a train\n";
+            return false;
+        }
+    }
+    rail.tick(graph);
+    bench.addWorldgenMs(watch.lapMs());
+    bool flowing = true;
+    std::uint64_t arrivals = 0;
+    for (int run = 0; run < args.runs; ++run) {
+        watch.restart();
+        for (int tick = 0; tick < args.ticks; ++tick) {
+            rail.tick(graph);
+            const odai::sim::RailTickStats& stats = rail.lastTickStats();
+            flowing = flowing && stats.deadlockedTrains == 0u && stats.unroutableTrains == 0u;
+            arrivals += stats.arrivals;
+        }
+        bench.addMatchMs(watch.lapMs());
+    }
+
+    std::cout << "==== rail: " << rail.trainCount() << " trains, " << graph.edgeCount() << " edges, "
+              << rail.routeTableCount() << " route tables ====\n";
+    std::cout << "arrivals : " << arrivals << "\n";
+    bench.report(std::cout, args.ticks, "run", "tick");
+    return flowing;
+}
+
+void runBelts(const BenchArgs& args) {
+    constexpr float kFixedDt = 1.0f / 60.0f;
+    odai::sim::Simulation simulation;
+    odai::tools::SimBench bench;
+    odai::core::Stopwatch watch;
+    const odai::tools::BeltSerpentineLayout layout = odai::tools::buildBeltSerpentine();
+    for (const odai::sim::Belt& belt : layout.belts) {
+        simulation.addBelt(belt.x, belt.y, belt.z, belt.direction);
+    }
+    for (const odai::tools::BeltCargoSeed& seed : layout.cargo) {
+        simulation.insertBeltCargo(seed.beltIndex, seed.alongQ16, seed.typeId);
+    }
+    simulation.update(kFixedDt);
+    bench.addWorldgenMs(watch.lapMs());
+    for (int run = 0; run < args.runs; ++run) {
+        watch.restart();
+        for (int tick = 0; tick < args.ticks; ++tick) {
+            simulation.update(kFixedDt);
+        }
+        bench.addMatchMs(watch.lapMs());
+    }
+
+    std::cout << "==== belts: " << layout.belts.size() << " belts, " << simulation.beltSegmentCount() << " segments, "
+              << simulation.beltCargoCount() << " items ====\n";
+    bench.report(std::cout, args.ticks, "run", "tick");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* mode = "pipes";
+    BenchArgs args;
+    args.workers = std::max(2u, std::thread::hardware_concurrency());
+    if (argc > 1) mode = argv[1];
+    if (argc > 2) args.runs = std::max(1, std::atoi(argv[2]));
+    if (argc > 3) args.ticks = std::max(1, std::atoi(argv[3]));
+    if (argc > 4) args.workers = static_cast<unsigned>(std::max(1, std::atoi(argv[4])));
+
+    if (std::strcmp(mode, "pipes") == 0) {
+        runPipes(args);
+        return 0;
+    }
+    if (std::strcmp(mode, "rail") == 0) {
+        if (!runRail(args)) {
+            std::cerr << "sim network bench: rail traffic deadlocked or lost a route\n";
+            return 1;
+        }
+        return 0;
+    }
+    if (std::strcmp(mode, "belts") == 0) {
+        runBelts(args);
+        return 0;
+    }
+    std::cerr << "sim network bench: unknown mode '" << mode << "' (expected pipes, rail or belts)\n";
+    return 2;
+}
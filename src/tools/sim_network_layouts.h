@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "core/grid3.h"
+#include "sim/belt.h"
+#include "sim/network_graph.h"
+#include "sim/pipe_fluid_solver.h"
+#include "sim/rail_traffic.h"
+
+// Network layouts shared by the sim network gtests and odai_sim_network_bench,
+// so the bench times exactly the layout the tests prove correct.
+namespace odai::tools {
+
+// width x depth grid of pipe junctions joined along +X and +Z, appended after
+// the graph's existing nodes.
+inline void addPipeGrid(
+    sim::NetworkGraph& graph,
+    sim::PipeFluidSolver& solver,
+    int width,
+    int depth,
+    std::uint16_t capacityUnitsPerTick
+) {
+    const sim::NodeId base = static_cast<sim::NodeId>(graph.nodeCount());
+    for (int z = 0; z < depth; ++z) {
+        for (int x = 0; x < width; ++x) {
+            graph.addNode(sim::Socket{.cell = core::Cell3i{x, 0, z}});
+        }
+    }
+    const auto addPipe = [&](sim::NodeId a, sim::NodeId b) {
+        const sim::EdgeId edgeId = graph.addEdge(
+            a,
+            b,
+            sim::EdgeSpan{.start = graph.nodes()[a].socket.cell, .dir = core::Dir6::PosX},
+            sim::NetworkKind::Pipe
+        );
+        solver.setEdgeData(edgeId, sim::PipeEdgeData{.capacityUnitsPerTick = capacityUnitsPerTick});
+    };
+    for (int z = 0; z < depth; ++z) {
+        for (int x = 0; x < width; ++x) {
+            const sim::NodeId node = base + static_cast<sim::NodeId>((z * width) + x);
+            if (x + 1 < width) {
+                addPipe(node, node + 1u);
+            }
+            if (z + 1 < depth) {
+                addPipe(node, node + static_cast<sim::NodeId>(width));
+            }
+        }
+    }
+}
+
+// The 50k-edge pipe target: 16 separate 64x25 grids (49,776 edges) with a
+// source or sink on every 53rd node.
+inline void buildLargePipeNetwork(sim::NetworkGraph& graph, sim::PipeFluidSolver& solver) {
+    for (int network = 0; network < 16; ++network) {
+        addPipeGrid(graph, solver, 64, 25, 40);
+    }
+    for (sim::NodeId nodeId = 0; nodeId < graph.nodeCount(); nodeId += 53u) {
+        solver.setNodeSupply(nodeId, (nodeId % 3u == 0u) ? -30 : 45);
+    }
+}
+
+struct RailRingLayout {
+    static constexpr int kRingCount = 20;
+    static constexpr int kSegmentsPerRing = 80;
+    static constexpr int kTrainsPerRing = 25;
+
+    // Indexed by EdgeId; 0 for edges outside any switch group.
+    std::vector<std::uint16_t> switchGroupByEdge;
+    // Not yet added, so callers can check each addTrain().
+    std::vector<sim::RailTrainDesc> trains;
+};
+
+// The 500-train rail target. Known-safe layout: independent one-way rings whose
+// every fourth segment is a passing loop (diverging switch, two parallel
+// blocks, merging switch). Each ring carries fewer trains than it has plain
+// blocks, so a free block always exists somewhere ahead of every queue.
+inline RailRingLayout buildRailRingLayout(sim::NetworkGraph& graph, sim::RailTrafficSim& rail) {
+    constexpr int kRingCount = RailRingLayout::kRingCount;
+    constexpr int kSegmentsPerRing = RailRingLayout::kSegmentsPerRing;
+    RailRingLayout layout;
+    std::uint16_t nextSwitchGroup = 1;
+    std::uint32_t state = 0x9E3779B9u;
+    const auto nextRandom = [&state]() {
+        state ^= state << 13u;
+        state ^= state >> 17u;
+        state ^= state << 5u;
+        return state;
+    };
+    const auto addNode = [&](int x, int z) {
+        return graph.addNode(sim::Socket{.cell = core::Cell3i{x, 0, z}});
+    };
+    const auto addRail = [&](sim::NodeId a, sim::NodeId b, std::uint16_t length, std::uint16_t switchGroup) {
+        const sim::EdgeId edgeId = graph.addEdge(
+            a,
+            b,
+            sim::EdgeSpan{.start = graph.nodes()[a].socket.cell, .dir = core::Dir6::PosX, .lengthVoxels = length},
+            sim::NetworkKind::Rail
+        );
+        rail.setEdgeData(edgeId, sim::RailEdgeData{
+            .segmentClass = switchGroup != 0u ? sim::RailSegmentClass::Switch : sim::RailSegmentClass::Straight,
+            .switchGroupId = switchGroup,
+            .oneWay = true
+        });
+        layout.switchGroupByEdge.resize(graph.edges().size(), 0u);
+        layout.switchGroupByEdge[edgeId] = switchGroup;
+        return edgeId;
+    };
+
+    struct RingPlan {
+        std::vector<sim::EdgeId> plainEdges;
+        std::vector<sim::NodeId> stops;
+    };
+    std::vector<RingPlan> rings(kRingCount);
+    for (int ring = 0; ring < kRingCount; ++ring) {
+        std::vector<sim::NodeId> ringNodes;
+        for (int segment = 0; segment < kSegmentsPerRing; ++segment) {
+            ringNodes.push_back(addNode(segment * 12, ring * 40));
+        }
+        for (int segment = 0; segment < kSegmentsPerRing; ++segment) {
+            const sim::NodeId from = ringNodes[static_cast<std::size_t>(segment)];
+            const sim::NodeId to = ringNodes[static_cast<std::size_t>((segment + 1) % kSegmentsPerRing)];
+            const std::uint16_t length = static_cast<std::uint16_t>(6u + (nextRandom() % 5u));
+            if (segment % 4 != 2) {
+                rings[static_cast<std::size_t>(ring)].plainEdges.push_back(addRail(from, to, length, 0));
+                continue;
+            }
+            const std::uint16_t diverge = nextSwitchGroup++;
+            const std::uint16_t merge = nextSwitchGroup++;
+            for (int track = 0; track < 2; ++track) {
+                const sim::NodeId loopIn = addNode(segment * 12 + 1, ring * 40 + 2 + track);
+                const sim::NodeId loopOut = addNode(segment * 12 + 9, ring * 40 + 2 + track);
+                addRail(from, loopIn, 1, diverge);
+                addRail(loopIn, loopOut, static_cast<std::uint16_t>(length + (track * 2)), 0);
+                addRail(loopOut, to, 1, merge);
+            }
+        }
+        for (const int stopSegment : {5, 31, 58}) {
+            rings[static_cast<std::size_t>(ring)].stops.push_back(ringNodes[static_cast<std::size_t>(stopSegment)]);
+        }
+    }
+
+    for (const RingPlan& plan : rings) {
+        for (int train = 0; train < RailRingLayout::kTrainsPerRing; ++train) {
+            sim::RailTrainDesc desc;
+            desc.cars.push_back(sim::TrainCar{.carId = 1, .lengthQ8 = 512});
+            desc.cars.push_back(sim::TrainCar{.carId = 2, .lengthQ8 = 512});
+            desc.start = sim::TrackParam{
+                .edgeId = plan.plainEdges[static_cast<std::size_t>(train * 2)],
+                .distanceAlongQ8 = 6u * 256u,
+                .forward = true
+            };
+            desc.speedQ8 = static_cast<std::uint16_t>(96u + (nextRandom() % 96u));
+            desc.stops = plan.stops;
+            std::rotate(desc.stops.begin(), desc.stops.begin() + (train % 3), desc.stops.end());
+            layout.trains.push_back(std::move(desc));
+        }
+    }
+    return layout;
+}
+
+struct BeltCargoSeed {
+    std::size_t beltIndex = 0;
+    std::uint32_t alongQ16 = 0;
+    std::uint16_t typeId = 0;
+};
+
+struct BeltSerpentineLayout {
+    std::vector<sim::Belt> belts;
+    std::vector<BeltCargoSeed> cargo;
+};
+
+// The 100k-item belt target: 200 rows of 500 belts alternating east and west,
+// joined by two south belts at each end, with items spread round-robin over
+// every belt.
+inline BeltSerpentineLayout buildBeltSerpentine() {
+    constexpr int kRows = 200;
+    constexpr int kRowLength = 500;
+    constexpr std::size_t kItemCount = 100000;
+    BeltSerpentineLayout layout;
+    layout.belts.reserve(static_cast<std::size_t>(kRows) * (kRowLength + 2));
+    for (int row = 0; row < kRows; ++row) {
+        const bool east = (row % 2) == 0;
+        const int z = row * 2;
+        const int rowStart = east ? 0 : kRowLength;
+        const int step = east ? 1 : -1;
+        for (int i = 0; i < kRowLength; ++i) {
+            layout.belts.emplace_back(rowStart + (i * step), 1, z, east ? sim::BeltDirection::East : sim::BeltDirection::West);
+        }
+        for (int i = 0; i < 2; ++i) {
+            layout.belts.emplace_back(rowStart + (kRowLength * step), 1, z + i, sim::BeltDirection::South);
+        }
+    }
+    layout.cargo.reserve(kItemCount);
+    for (std::size_t i = 0; i < kItemCount; ++i) {
+        layout.cargo.push_back(BeltCargoSeed{
+            .beltIndex = i % layout.belts.size(),
+            .alongQ16 = static_cast<std::uint32_t>((i / layout.belts.size()) * 0x5000u),
+            .typeId = static_cast<std::uint16_t>(i % 5u)
+        });
+    }
+    return layout;
+}
+
+} // namespace odai::tools
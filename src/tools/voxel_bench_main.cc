@@ -0,0 +1,404 @@
+// Headless voxel world benchmark. Times the world workloads whose correctness
+// the foundation and scheduler tests check, kept out of those tests because CI
+// machines vary too much for a pass/fail timing check.
+//
+//   worldgen : the golden-hash procedural chunks (8 columns x 2 layers),
+//              generated serially and split across a JobSystem.
+//   edits    : per-voxel setVoxel against the batched paths, for a layer fill
+//              (fillLayer) and a CSG box stamp (copyVolumeSolidsToChunk).
+//   mesher   : Greedy against GreedyReference over the mesher corpus
+//              (tools/voxel_layouts.h), in chunks/sec and ns per face.
+//   grass    : GrassInstanceCache over the 7x7 grass corpus -- a cold scatter
+//              (instances/sec), an unchanged update, and the rebuild after a
+//              single-voxel edit.
+//   parallel : serial against JobSystem-parallel world decode
+//              (ChunkGrid::loadFromBinaryFile) and grass scatter
+//              (buildGrassInstances loop vs buildGrassInstancesParallel).
+//   neighbors: vertices per chunk meshed alone against meshed with neighbor
+//              slabs, on the flat and procedural 6x6 worlds, with the
+//              reduction and the neighbor-aware pass time.
+//
+// [runs] defaults per mode (worldgen 5, edits 8, mesher 3, grass 10,
+// parallel 5, neighbors 3).
+//
+// Usage: odai_voxel_bench [mode] [runs] [workers]
+// Build optimized before reading the numbers -- see CLAUDE.md.
+
+#include "core/frame_profiler.h"
+#include "core/job_system.h"
+#include "core/log.h"
+#include "tools/sim_bench.h"
+#include "tools/voxel_layouts.h"
+#include "world/chunk_grid.h"
+#include "world/chunk_mesher.h"
+#include "world/grass_scatter.h"
+#include "world/csg.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+struct BenchArgs {
+    // 0 picks the mode's default.
+    int runs = 0;
+    unsigned workers = 2;
+
+    [[nodiscard]] int runsOr(int modeDefault) const { return runs > 0 ? runs : modeDefault; }
+};
+
+// Times `edit` once per run on a fresh copy of `base`; the copy stays out of
+// the numbers.
+template <typename EditFn>
+void reportChunkEdit(const char* label, int runs, int voxelsPerEdit, const odai::world::Chunk& base, EditFn&& edit) {
+    odai::tools::SimBench bench;
+    odai::core::Stopwatch watch;
+    for (int run = 0; run < runs; ++run) {
+        odai::world::Chunk chunk = base;
+        watch.restart();
+        edit(chunk);
+        bench.addMatchMs(watch.lapMs());
+    }
+    std::cout << "==== " << label << ": " << voxelsPerEdit << " voxels per edit ====\n";
+    bench.report(std::cout, voxelsPerEdit, "edit", "voxel");
+    std::cout << "\n";
+}
+
+// The columns testProceduralWorldGenerationGolden hashes.
+constexpr std::array<std::array<int, 2>, 8> kWorldgenColumns = {{
+    {0, 0}, {1, 0}, {-1, -1}, {1, -4}, {-2, 2}, {3, -9}, {8, 9}, {-7, -6}
+}};
+constexpr int kWorldgenChunks = static_cast<int>(kWorldgenColumns.size()) * 2;
+
+void runWorldgen(const BenchArgs& args) {
+    const int runs = args.runsOr(5);
+    odai::core::JobSystem jobs(args.workers);
+    for (const bool split : {false, true}) {
+        odai::core::JobSystem* buildJobs = split ? &jobs : nullptr;
+        odai::tools::SimBench bench;
+        odai::core::Stopwatch watch;
+        std::size_t uniformChunks = 0;
+        for (int run = 0; run < runs; ++run) {
+            watch.restart();
+            for (const std::array<int, 2>& column : kWorldgenColumns) {
+                for (int chunkY = 0; chunkY <= 1; ++chunkY) {
+                    const odai::world::Chunk chunk =
+                        odai::world::buildProceduralChunk(column[0], chunkY, column[1], buildJobs);
+                    uniformChunks += chunk.storageMode() == odai::world::Chunk::StorageMode::Uniform ? 1u : 0u;
+                }
+            }
+            bench.addMatchMs(watch.lapMs());
+        }
+
+        std::cout << "==== worldgen " << (split ? "split" : "serial") << ": " << kWorldgenChunks << " chunks";
+        if (split) {
+            std::cout << ", " << jobs.workerCount() << " workers";
+        }
+        std::cout << " ====\n";
+        std::cout << "uniform chunks : " << uniformChunks / static_cast<std::size_t>(runs) << "\n";
+        bench.report(std::cout, kWorldgenChunks, "run", "chunk");
+        std::cout << "\n";
+    }
+}
+
+void runEdits(const BenchArgs& args) {
+    using odai::world::Chunk;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+    const int runs = args.runsOr(8);
+
+    const Chunk terrain = odai::world::buildProceduralChunk(0, 0, 0);
+    constexpr int kLayerY = 20;
+    reportChunkEdit("layer fill, per-voxel", runs, Chunk::kSizeX * Chunk::kSizeZ, terrain, [](Chunk& chunk) {
+        for (int z = 0; z < Chunk::kSizeZ; ++z) {
+            for (int x = 0; x < Chunk::kSizeX; ++x) {
+                chunk.setVoxel(x, kLayerY, z, Voxel{VoxelType::Leaves});
+            }
+        }
+    });
+    reportChunkEdit("layer fill, fillLayer", runs, Chunk::kSizeX * Chunk::kSizeZ, terrain, [](Chunk& chunk) {
+        chunk.fillLayer(kLayerY, Voxel{VoxelType::Leaves});
+    });
+
+    const odai::core::Cell3i boxMin{4, 12, 4};
+    const odai::core::Cell3i boxMax{28, 28, 28};
+    odai::world::CsgVolume box(Chunk::kSizeX, Chunk::kSizeY, Chunk::kSizeZ);
+    odai::world::CsgCommand addBox{};
+    addBox.op = odai::world::CsgOp::AddSolid;
+    addBox.brush.kind = odai::world::BrushKind::Box;
+    addBox.brush.minCell = boxMin;
+    addBox.brush.maxCell = boxMax;
+    odai::world::applyCsgCommand(box, addBox);
+    const int boxVoxels = (boxMax.x - boxMin.x) * (boxMax.y - boxMin.y) * (boxMax.z - boxMin.z);
+    const Chunk empty(0, 0, 0);
+    reportChunkEdit("CSG box stamp, per-voxel", runs, boxVoxels, empty, [&](Chunk& chunk) {
+        for (int y = boxMin.y; y < boxMax.y; ++y) {
+            for (int z = boxMin.z; z < boxMax.z; ++z) {
+                for (int x = boxMin.x; x < boxMax.x; ++x) {
+                    chunk.setVoxel(x, y, z, box.cellAtWorld(odai::core::Cell3i{x, y, z}).voxel);
+                }
+            }
+        }
+    });
+    reportChunkEdit("CSG box stamp, copyVolumeSolidsToChunk", runs, boxVoxels, empty, [&](Chunk& chunk) {
+        (void)odai::world::copyVolumeSolidsToChunk(box, chunk);
+    });
+}
+
+void runMesher(const BenchArgs& args) {
+    using odai::world::MeshingMode;
+    const int runs = args.runsOr(3);
+    const std::vector<odai::world::Chunk> corpus = odai::tools::buildMesherCorpus();
+    std::cout << "mesher SIMD path : " << odai::world::chunkMesherSimdPath() << "\n\n";
+
+    for (const MeshingMode mode : {MeshingMode::GreedyReference, MeshingMode::Greedy}) {
+        odai::tools::SimBench bench;
+        odai::core::Stopwatch watch;
+        std::size_t facesPerPass = 0;
+        double totalMs = 0.0;
+        for (int run = 0; run < runs; ++run) {
+            std::size_t faces = 0;
+            watch.restart();
+            for (const odai::world::Chunk& chunk : corpus) {
+                odai::world::ChunkMeshingStats stats{};
+                (void)odai::world::buildChunkLodMeshes(chunk, odai::world::MeshingOptions{mode}, &stats);
+                faces += stats.exposedFaceCount;
+            }
+            const float passMs = watch.lapMs();
+            bench.addMatchMs(passMs);
+            totalMs += static_cast<double>(passMs);
+            facesPerPass = faces;
+        }
+
+        std::cout << "==== mesher " << (mode == MeshingMode::Greedy ? "Greedy" : "GreedyReference") << ": "
+                  << corpus.size() << " chunks, " << facesPerPass << " faces per pass ====\n";
+        std::cout << "ns/face : " << (totalMs * 1.0e6 / static_cast<double>(facesPerPass * static_cast<std::size_t>(runs)))
+                  << "\n";
+        bench.report(std::cout, static_cast<int>(corpus.size()), "pass", "chunk");
+        std::cout << "\n";
+    }
+}
+
+void runGrass(const BenchArgs& args) {
+    const int runs = args.runsOr(10);
+    const std::vector<odai::world::Chunk> corpus = odai::tools::buildGrassCacheCorpus();
+    odai::world::GrassScatterParams params{};
+    params.activeRadius = 8;
+    params.retainedRadius = 8;
+    odai::core::JobSystem jobs(args.workers);
+
+    // The edited column is the one testGrassInstanceCache removes.
+    constexpr std::size_t kEditedChunk = 24;
+    constexpr int kEditX = 5;
+    constexpr int kEditZ = 9;
+
+    // Unchanged and edit updates are a single short call each; they are
+    // reported as mean/max ms rather than through a throughput line.
+    odai::tools::SimBench cold;
+    double unchangedTotalMs = 0.0;
+    double unchangedMaxMs = 0.0;
+    double editTotalMs = 0.0;
+    double editMaxMs = 0.0;
+    odai::core::Stopwatch watch;
+    std::size_t instances = 0;
+    for (int run = 0; run < runs; ++run) {
+        std::vector<odai::world::Chunk> chunks = corpus;
+        odai::world::GrassInstanceCache cache;
+        watch.restart();
+        cache.update(chunks, params, &jobs);
+        cold.addMatchMs(watch.lapMs());
+        instances = cache.instances().size();
+
+        watch.restart();
+        cache.update(chunks, params, &jobs);
+        const double unchangedMs = static_cast<double>(watch.lapMs());
+        unchangedTotalMs += unchangedMs;
+        unchangedMaxMs = std::max(unchangedMaxMs, unchangedMs);
+
+        odai::world::Chunk& edited = chunks[kEditedChunk];
+        const int editY = odai::tools::grassTerraceHeight(edited.chunkX(), edited.chunkZ(), kEditX, kEditZ);
+        edited.setVoxel(kEditX, editY, kEditZ, odai::world::Voxel{});
+        cache.markVoxelEdited(
+            edited.chunkX() * odai::world::Chunk::kSizeX + kEditX,
+            editY,
+            edited.chunkZ() * odai::world::Chunk::kSizeZ + kEditZ
+        );
+        watch.restart();
+        cache.update(chunks, params, &jobs);
+        const double editMs = static_cast<double>(watch.lapMs());
+        editTotalMs += editMs;
+        editMaxMs = std::max(editMaxMs, editMs);
+    }
+
+    std::cout << "==== grass cache: " << corpus.size() << " chunks, " << instances << " instances, "
+              << jobs.workerCount() << " workers ====\n";
+    std::cout << "unchanged update  : mean " << (unchangedTotalMs / runs) << " ms   max " << unchangedMaxMs << " ms\n";
+    std::cout << "single-voxel edit : mean " << (editTotalMs / runs) << " ms   max " << editMaxMs << " ms\n";
+    std::cout << "cold scatter:";
+    cold.report(std::cout, static_cast<int>(instances), "update", "instance");
+}
+
+// Times `serialFn` and `parallelFn` alternately, once per run each, and
+// reports both plus the speedup of the means.
+template <typename SerialFn, typename ParallelFn>
+void reportSpeedup(const char* label, int runs, int chunksPerRun, SerialFn&& serialFn, ParallelFn&& parallelFn) {
+    odai::tools::SimBench serial;
+    odai::tools::SimBench parallel;
+    double serialTotalMs = 0.0;
+    double parallelTotalMs = 0.0;
+    odai::core::Stopwatch watch;
+    for (int run = 0; run < runs; ++run) {
+        watch.restart();
+        serialFn();
+        const float serialMs = watch.lapMs();
+        parallelFn();
+        const float parallelMs = watch.lapMs();
+        serial.addMatchMs(serialMs);
+        parallel.addMatchMs(parallelMs);
+        serialTotalMs += static_cast<double>(serialMs);
+        parallelTotalMs += static_cast<double>(parallelMs);
+    }
+    std::cout << "==== " << label << ": " << chunksPerRun << " chunks ====\n";
+    std::cout << "speedup : " << (serialTotalMs / std::max(parallelTotalMs, 1e-6)) << "x\n";
+    std::cout << "serial:";
+    serial.report(std::cout, chunksPerRun, "run", "chunk");
+    std::cout << "parallel:";
+    parallel.report(std::cout, chunksPerRun, "run", "chunk");
+    std::cout << "\n";
+}
+
+// Returns false if the decode corpus could not be saved or loaded.
+bool runParallel(const BenchArgs& args) {
+    const int runs = args.runsOr(5);
+    // Every load logs an Info summary; keep it out of the timings and output.
+    odai::core::setLogLevel(odai::core::LogLevel::Warn);
+    odai::core::JobSystem jobs(args.workers);
+    std::cout << "workers : " << jobs.workerCount() << "\n\n";
+
+    const std::vector<odai::world::Chunk> decodeChunks = odai::tools::buildDecodeCorpus();
+    odai::world::ChunkGrid source;
+    source.setChunks(decodeChunks);
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "odai_voxel_bench_decode.vxw";
+    if (!source.saveToBinaryFile(path)) {
+        std::cerr << "voxel bench: could not save the decode corpus to " << path << "\n";
+        return false;
+    }
+    bool loaded = true;
+    reportSpeedup(
+        "world decode",
+        runs,
+        static_cast<int>(decodeChunks.size()),
+        [&]() {
+            odai::world::ChunkGrid grid;
+            loaded = grid.loadFromBinaryFile(path) && loaded;
+        },
+        [&]() {
+            odai::world::ChunkGrid grid;
+            loaded = grid.loadFromBinaryFile(path, &jobs) && loaded;
+        }
+    );
+    std::error_code removeError;
+    std::filesystem::remove(path, removeError);
+
+    const odai::tools::GrassScatterCorpus grass = odai::tools::buildGrassScatterCorpus();
+    reportSpeedup(
+        "grass scatter",
+        runs,
+        static_cast<int>(grass.chunks.size()),
+        [&]() {
+            std::vector<std::vector<odai::world::GrassInstance>> instances;
+            for (std::size_t i = 0; i < grass.chunks.size(); ++i) {
+                instances.push_back(odai::world::buildGrassInstances(grass.chunks[i], grass.params[i]));
+            }
+        },
+        [&]() { (void)odai::world::buildGrassInstancesParallel(jobs, grass.chunks, grass.params); }
+    );
+    return loaded;
+}
+
+void reportNeighborWorld(const char* name, const std::vector<odai::world::Chunk>& chunks, int runs) {
+    const odai::world::ChunkNeighborLookup lookup(chunks);
+    std::size_t isolatedVertices = 0;
+    for (const odai::world::Chunk& chunk : chunks) {
+        isolatedVertices += odai::world::buildChunkLodMeshes(chunk, odai::world::MeshingOptions{}).lodMeshes[0].vertices.size();
+    }
+
+    odai::tools::SimBench bench;
+    odai::core::Stopwatch watch;
+    std::size_t neighborVertices = 0;
+    for (int run = 0; run < runs; ++run) {
+        neighborVertices = 0;
+        watch.restart();
+        for (const odai::world::Chunk& chunk : chunks) {
+            neighborVertices +=
+                odai::world::buildChunkLodMeshes(lookup.neighborhood(chunk), odai::world::MeshingOptions{}, nullptr)
+                    .lodMeshes[0]
+                    .vertices.size();
+        }
+        bench.addMatchMs(watch.lapMs());
+    }
+
+    const double chunkCount = static_cast<double>(chunks.size());
+    const double reduction = isolatedVertices > 0u
+        ? 100.0 * (1.0 - (static_cast<double>(neighborVertices) / static_cast<double>(isolatedVertices)))
+        : 0.0;
+    std::cout << "==== neighbor-aware meshing, " << name << " world: " << chunks.size() << " chunks ====\n";
+    std::cout << "isolated vertices/chunk : " << (static_cast<double>(isolatedVertices) / chunkCount) << "\n";
+    std::cout << "neighbor vertices/chunk : " << (static_cast<double>(neighborVertices) / chunkCount) << "\n";
+    std::cout << "reduction               : " << reduction << "%\n";
+    bench.report(std::cout, static_cast<int>(chunks.size()), "pass", "chunk");
+    std::cout << "\n";
+}
+
+void runNeighbors(const BenchArgs& args) {
+    const int runs = args.runsOr(3);
+    reportNeighborWorld("flat", odai::tools::buildFlatNeighborWorld(), runs);
+    reportNeighborWorld("procedural", odai::tools::buildProceduralNeighborWorld(), runs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* mode = "worldgen";
+    BenchArgs args;
+    args.workers = std::max(2u, std::thread::hardware_concurrency());
+    if (argc > 1) mode = argv[1];
+    if (argc > 2) args.runs = std::max(1, std::atoi(argv[2]));
+    if (argc > 3) args.workers = static_cast<unsigned>(std::max(1, std::atoi(argv[3])));
+
+    if (std::strcmp(mode, "worldgen") == 0) {
+        runWorldgen(args);
+        return 0;
+    }
+    if (std::strcmp(mode, "edits") == 0) {
+        runEdits(args);
+        return 0;
+    }
+    if (std::strcmp(mode, "mesher") == 0) {
+        runMesher(args);
+        return 0;
+    }
+    if (std::strcmp(mode, "grass") == 0) {
+        runGrass(args);
+        return 0;
+    }
+    if (std::strcmp(mode, "parallel") == 0) {
+        if (!runParallel(args)) {
+            std::cerr << "voxel bench: world decode failed\n";
+            return 1;
+        }
+        return 0;
+    }
+    if (std::strcmp(mode, "neighbors") == 0) {
+        runNeighbors(args);
+        return 0;
+    }
+    std::cerr << "voxel bench: unknown mode '" << mode
+              << "' (expected worldgen, edits, mesher, grass, parallel or neighbors)\n";
+    return 2;
+}
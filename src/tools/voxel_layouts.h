@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "world/chunk.h"
+#include "world/chunk_grid.h"
+#include "world/grass_scatter.h"
+
+// Voxel workloads shared by the foundation tests and odai_voxel_bench, so the
+// bench times exactly the chunks the tests prove correct.
+namespace odai::tools {
+
+// The mesher corpus: 6x6 procedural surface chunks (-2..3), then edge cases
+// the terrain never produces -- full, checkerboard, boundary voxels, and four
+// noise chunks with mixed palette/default colors. Every chunk is expanded to
+// Dense so meshing timings leave out the palette expansion both meshers share.
+inline std::vector<world::Chunk> buildMesherCorpus() {
+    using world::Chunk;
+    using world::Voxel;
+    using world::VoxelType;
+
+    std::vector<Chunk> corpus;
+    for (int chunkZ = -2; chunkZ <= 3; ++chunkZ) {
+        for (int chunkX = -2; chunkX <= 3; ++chunkX) {
+            corpus.push_back(world::buildProceduralChunk(chunkX, 0, chunkZ));
+        }
+    }
+
+    Chunk full(0, 0, 0);
+    Chunk checker(0, 0, 0);
+    Chunk boundary(0, 0, 0);
+    full.beginEdit();
+    checker.beginEdit();
+    for (int y = 0; y < Chunk::kSizeY; ++y) {
+        for (int z = 0; z < Chunk::kSizeZ; ++z) {
+            for (int x = 0; x < Chunk::kSizeX; ++x) {
+                full.setVoxel(x, y, z, Voxel{VoxelType::Stone});
+                if (((x + y + z) & 1) == 0) {
+                    checker.setVoxel(x, y, z, Voxel{VoxelType::Dirt, 3u});
+                }
+            }
+        }
+    }
+    full.endEdit();
+    checker.endEdit();
+    for (const int corner : {0, Chunk::kSizeX - 1}) {
+        boundary.setVoxel(corner, corner, corner, Voxel{VoxelType::Wood});
+        boundary.setVoxel(corner, 0, Chunk::kSizeZ - 1 - corner, Voxel{VoxelType::Leaves, 7u});
+    }
+    corpus.push_back(full);
+    corpus.push_back(checker);
+    corpus.push_back(boundary);
+    std::mt19937 rng(0x5EEDu);
+    for (int noiseIndex = 0; noiseIndex < 4; ++noiseIndex) {
+        Chunk noise(noiseIndex, 0, 0);
+        noise.beginEdit();
+        for (int y = 0; y < Chunk::kSizeY; ++y) {
+            for (int z = 0; z < Chunk::kSizeZ; ++z) {
+                for (int x = 0; x < Chunk::kSizeX; ++x) {
+                    // Denser toward the bottom so every AO pattern shows up.
+                    if (static_cast<int>(rng() % 40u) < (Chunk::kSizeY - y) + (noiseIndex * 4)) {
+                        const auto type = static_cast<VoxelType>(1u + (rng() % 6u));
+                        const std::uint8_t color = (rng() % 3u) == 0u ? 0xFFu : static_cast<std::uint8_t>(rng() % 12u);
+                        noise.setVoxel(x, y, z, Voxel{type, color});
+                    }
+                }
+            }
+        }
+        noise.endEdit();
+        corpus.push_back(std::move(noise));
+    }
+    for (Chunk& chunk : corpus) {
+        chunk.expandToDense();
+    }
+    return corpus;
+}
+
+// Height of the terraced grass surface at local column (lx, lz) of chunk
+// (chunkX, chunkZ) in the grass cache corpus: dirt below, one grass voxel on top.
+inline int grassTerraceHeight(int chunkX, int chunkZ, int lx, int lz) {
+    return 4 + ((lx * 3 + lz * 5 + chunkX + chunkZ + 64) % 9);
+}
+
+// The grass cache corpus: 7x7 chunks (-3..3) of terraced grass, every column
+// grass-topped.
+inline std::vector<world::Chunk> buildGrassCacheCorpus() {
+    std::vector<world::Chunk> chunks;
+    for (int x = -3; x <= 3; ++x) {
+        for (int z = -3; z <= 3; ++z) {
+            world::Chunk chunk(x, 0, z);
+            for (int lz = 0; lz < world::Chunk::kSizeZ; ++lz) {
+                for (int lx = 0; lx < world::Chunk::kSizeX; ++lx) {
+                    const int height = grassTerraceHeight(x, z, lx, lz);
+                    for (int y = 0; y < height; ++y) {
+                        chunk.setVoxel(lx, y, lz, world::Voxel{world::VoxelType::Dirt});
+                    }
+                    chunk.setVoxel(lx, height, lz, world::Voxel{world::VoxelType::Grass});
+                }
+            }
+            chunks.push_back(std::move(chunk));
+        }
+    }
+    return chunks;
+}
+
+// The neighbor-aware meshing worlds, 6x6 chunks (-3..2) each. The flat world
+// is a 16-voxel stack of stone, dirt and grass on every chunk; the procedural
+// world is the terrain generator's.
+inline std::vector<world::Chunk> buildFlatNeighborWorld() {
+    using world::VoxelType;
+    std::vector<world::Chunk> chunks;
+    for (int chunkZ = -3; chunkZ <= 2; ++chunkZ) {
+        for (int chunkX = -3; chunkX <= 2; ++chunkX) {
+            world::Chunk chunk(chunkX, 0, chunkZ);
+            for (int y = 0; y < 16; ++y) {
+                chunk.fillLayer(y, world::Voxel{y < 12 ? VoxelType::Stone : (y < 15 ? VoxelType::Dirt : VoxelType::Grass)});
+            }
+            chunks.push_back(std::move(chunk));
+        }
+    }
+    return chunks;
+}
+
+inline std::vector<world::Chunk> buildProceduralNeighborWorld() {
+    std::vector<world::Chunk> chunks;
+    for (int chunkZ = -3; chunkZ <= 2; ++chunkZ) {
+        for (int chunkX = -3; chunkX <= 2; ++chunkX) {
+            chunks.push_back(world::buildProceduralChunk(chunkX, 0, chunkZ));
+        }
+    }
+    return chunks;
+}
+
+struct GrassScatterCorpus {
+    std::vector<world::Chunk> chunks;
+    // params[i] goes with chunks[i].
+    std::vector<world::GrassScatterParams> params;
+};
+
+// The parallel grass corpus: the 7x7 grass terraces as bare grass voxels, with
+// previouslyActive alternating across chunks so both radius paths run.
+inline GrassScatterCorpus buildGrassScatterCorpus() {
+    GrassScatterCorpus corpus;
+    for (int x = -3; x <= 3; ++x) {
+        for (int z = -3; z <= 3; ++z) {
+            world::Chunk chunk(x, 0, z);
+            for (int lz = 0; lz < world::Chunk::kSizeZ; ++lz) {
+                for (int lx = 0; lx < world::Chunk::kSizeX; ++lx) {
+                    chunk.setVoxel(lx, grassTerraceHeight(x, z, lx, lz), lz, world::Voxel{world::VoxelType::Grass});
+                }
+            }
+            corpus.chunks.push_back(std::move(chunk));
+            world::GrassScatterParams chunkParams{};
+            chunkParams.activeRadius = 3;
+            chunkParams.retainedRadius = 3;
+            chunkParams.previouslyActive = ((x + z) & 1) != 0;
+            corpus.params.push_back(chunkParams);
+        }
+    }
+    return corpus;
+}
+
+// The world decode corpus: 7x7 procedural surface chunks (-3..3), with one
+// palette-colored voxel edited into the first.
+inline std::vector<world::Chunk> buildDecodeCorpus() {
+    std::vector<world::Chunk> chunks;
+    for (int chunkZ = -3; chunkZ <= 3; ++chunkZ) {
+        for (int chunkX = -3; chunkX <= 3; ++chunkX) {
+            chunks.push_back(world::buildProceduralChunk(chunkX, 0, chunkZ));
+        }
+    }
+    chunks[0].setVoxel(3, 30, 3, world::Voxel{world::VoxelType::Wood, 5u});
+    return chunks;
+}
+
+} // namespace odai::tools
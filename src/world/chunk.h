@@ -1,9 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
 #include <array>
+#include <atomic>
+#include <span>
 #include <vector>
 
 #include "world/voxel.h"
@@ -18,11 +21,12 @@ public:
     static constexpr int kSizeX = 32;
     static constexpr int kSizeY = 32;
     static constexpr int kSizeZ = 32;
+    static constexpr std::size_t kVoxelCount = static_cast<std::size_t>(kSizeX * kSizeY * kSizeZ);
 
     // Resolution-aware chunk layout:
     // - Chunk8: one macro cell represents an 8x8x8 block in chunk space.
     // - Chunk4: optional 2x2x2 subcells (each subcell is 4x4x4 voxels).
-    // - Chunk1: optional full 8x8x8 micro voxels.
+    // - Chunk1: full 8x8x8 micro voxels, read straight from voxel storage.
     static constexpr int kMacroVoxelSize = 8;
     static constexpr int kRefined4VoxelSize = 4;
     static constexpr int kRefined4CellsPerAxis = kMacroVoxelSize / kRefined4VoxelSize;
@@ -30,6 +34,7 @@ public:
     static constexpr int kMacroSizeX = kSizeX / kMacroVoxelSize;
     static constexpr int kMacroSizeY = kSizeY / kMacroVoxelSize;
     static constexpr int kMacroSizeZ = kSizeZ / kMacroVoxelSize;
+    static_assert(kMacroSizeX * kMacroSizeY * kMacroSizeZ <= 64, "Dirty macro cells are tracked in one 64-bit mask");
 
     enum class CellResolution : std::uint8_t {
         Uniform = 0,
@@ -37,10 +42,31 @@ public:
         Refined1 = 2
     };
 
+    // Voxel storage representation:
+    // - Uniform: one voxel value for the whole chunk (all air, all stone).
+    // - Palette: up to kMaxPaletteSize distinct voxels plus 1/2/4/8-bit indices
+    //   packed into 64-bit words (an index never straddles two words).
+    // - Dense: one Voxel per cell. Used while meshing and bulk generation, and
+    //   for chunks with more distinct voxels than a palette can hold.
+    // Edits demote on their own: a palette whose stale entries outnumber its
+    // live ones is recompacted (to Uniform when one value is left), and a
+    // chunk that went Dense on palette overflow retries the palette every
+    // kOverflowRecheckWrites writes. Only expandToDense() pins Dense.
+    enum class StorageMode : std::uint8_t {
+        Uniform = 0,
+        Palette = 1,
+        Dense = 2
+    };
+
+    static constexpr std::size_t kMaxPaletteSize = 256;
+    static constexpr std::uint32_t kOverflowRecheckWrites = static_cast<std::uint32_t>(kVoxelCount / 8u);
+
     struct MacroCell {
         Voxel voxel{};
         CellResolution resolution = CellResolution::Uniform;
         std::uint16_t refined4Index = kInvalidRefinementIndex;
+        // Refined1 cells keep no copy of their voxels; this is the macro cell's
+        // own linear index into the chunk.
         std::uint16_t refined1Index = kInvalidRefinementIndex;
     };
 
@@ -48,8 +74,11 @@ public:
         std::array<Voxel, static_cast<std::size_t>(kRefined4CellsPerAxis * kRefined4CellsPerAxis * kRefined4CellsPerAxis)> subcells{};
     };
 
-    struct Chunk1Cell {
-        std::array<Voxel, static_cast<std::size_t>(kMacroVoxelSize * kMacroVoxelSize * kMacroVoxelSize)> voxels{};
+    struct VoxelWrite {
+        int x = 0;
+        int y = 0;
+        int z = 0;
+        Voxel voxel{};
     };
 
     Chunk();
@@ -57,6 +86,13 @@ public:
     void setVoxel(int x, int y, int z, Voxel voxel);
     void setVoxelRefined4(int x, int y, int z, Voxel voxel);
     void setVoxelRefined(int x, int y, int z, Voxel voxel);
+    // Batched edits: between beginEdit() and the matching endEdit(), setVoxel
+    // only marks its macro cell dirty; endEdit() resolves each dirty macro cell
+    // once and demotes storage that no longer needs its width. Calls nest.
+    // macroCellAt() is stale until the outermost endEdit().
+    void beginEdit();
+    void endEdit();
+    void setVoxels(std::span<const VoxelWrite> writes);
     void setFromSolidBitfield(const std::uint8_t* packedBits, std::size_t packedByteCount);
     void setFromTypedVoxelBytes(const std::uint8_t* typeBytes, std::size_t byteCount);
     void setFromTypedVoxelAndBaseColorBytes(
@@ -65,14 +101,39 @@ public:
         std::size_t byteCount
     );
     void fillLayer(int y, Voxel voxel);
+    // Every voxel becomes `voxel`, stored as Uniform: no per-voxel storage at
+    // all, whatever the chunk held before.
+    void fill(Voxel voxel);
     Voxel voxelAt(int x, int y, int z) const;
     bool isSolid(int x, int y, int z) const;
-    const std::vector<Voxel>& voxels() const;
+    // Writes all kVoxelCount voxels in linear (x, z, y) order, whatever the
+    // storage mode.
+    void copyDenseVoxels(std::vector<Voxel>& outVoxels) const;
+    // The dense voxel array in linear (x, z, y) order; empty unless
+    // storageMode() is Dense. For hot loops that already called expandToDense().
+    std::span<const Voxel> denseVoxels() const;
     MacroCell macroCellAt(int mx, int my, int mz) const;
     bool isMacroSolid(int mx, int my, int mz) const;
     int chunkX() const;
     int chunkY() const;
     int chunkZ() const;
+    // Changes whenever the voxel contents change (once per outermost
+    // beginEdit/endEdit batch). Values come from one process-wide counter, so
+    // a chunk regenerated at the same coordinates never reuses an old version;
+    // copies keep their source's version.
+    std::uint64_t contentVersion() const;
+
+    StorageMode storageMode() const;
+    std::size_t paletteSize() const;
+    // Re-derives the smallest representation from the current contents
+    // (Uniform, else Palette, else Dense) and drops stale palette entries.
+    void compactStorage();
+    // Switches to dense storage without changing contents, and keeps it Dense
+    // until compactStorage(). Meshing and bulk writers call this first so
+    // per-voxel access is a plain array load.
+    void expandToDense();
+    // Heap plus inline bytes held by this chunk.
+    std::size_t memoryFootprintBytes() const;
 
 private:
     static std::size_t linearIndex(int x, int y, int z);
@@ -80,29 +141,54 @@ private:
     static bool isInBounds(int x, int y, int z);
     static bool isMacroInBounds(int mx, int my, int mz);
     static std::size_t refined4LinearIndex(int sx, int sy, int sz);
-    static std::size_t refined1LinearIndex(int lx, int ly, int lz);
     static VoxelType voxelTypeFromSerializedByte(std::uint8_t raw);
-    std::size_t ensureChunk4IndexForCell(MacroCell& cell);
-    std::size_t ensureChunk1IndexForCell(MacroCell& cell, int mx, int my, int mz);
-    static bool isUniformChunk4(const Chunk4Cell& chunk4Cell);
+    static std::uint8_t paletteBitsForSize(std::size_t paletteSize);
+    Voxel storedVoxel(std::size_t index) const;
+    void storeVoxel(std::size_t index, Voxel voxel);
+    std::uint32_t paletteIndexAt(std::size_t index) const;
+    void setPaletteIndexAt(std::size_t index, std::uint32_t paletteIndex);
+    void repackPaletteIndices(std::uint8_t bitsPerIndex);
+    void recompactIfStale();
+    void clearPalette();
+    void resetToUniform(Voxel voxel);
     void rebuildMacroHierarchyFromDense();
     void syncMacroCellFromDense(int mx, int my, int mz);
+    std::uint16_t acquireChunk4Slot();
+    void releaseChunk4Slot(MacroCell& cell);
+    static std::uint64_t nextContentVersion();
+
+    StorageMode m_storageMode = StorageMode::Uniform;
+    std::uint8_t m_paletteBits = 0;
+    Voxel m_uniformVoxel{};
     std::vector<Voxel> m_voxels;
+    std::vector<Voxel> m_palette;
+    std::vector<std::uint64_t> m_paletteIndices;
+    // Voxels using each palette entry; entries at 0 are stale.
+    static_assert(kVoxelCount <= 0xFFFFu, "palette use counts are 16-bit");
+    std::vector<std::uint16_t> m_paletteUseCounts;
+    std::size_t m_livePaletteEntries = 0;
+    // Dense because a palette overflowed rather than through expandToDense().
+    bool m_denseFromOverflow = false;
+    std::uint32_t m_writesSinceOverflow = 0;
     std::vector<MacroCell> m_macroCells;
     std::vector<Chunk4Cell> m_chunk4Cells;
-    std::vector<Chunk1Cell> m_chunk1Cells;
+    // Chunk4 slots released by cells that left Refined4, reused before growing.
+    std::vector<std::uint16_t> m_freeChunk4Slots;
+    // One bit per macro cell (macroLinearIndex) edited inside beginEdit/endEdit.
+    std::uint64_t m_dirtyMacroCells = 0;
+    std::uint32_t m_editDepth = 0;
+    bool m_contentEditedInBatch = false;
+    std::uint64_t m_contentVersion = nextContentVersion();
     int m_chunkX = 0;
     int m_chunkY = 0;
     int m_chunkZ = 0;
 };
 
 inline Chunk::Chunk()
-    : m_voxels(static_cast<std::size_t>(kSizeX * kSizeY * kSizeZ)),
-      m_macroCells(static_cast<std::size_t>(kMacroSizeX * kMacroSizeY * kMacroSizeZ)) {}
+    : m_macroCells(static_cast<std::size_t>(kMacroSizeX * kMacroSizeY * kMacroSizeZ)) {}
 
 inline Chunk::Chunk(int chunkX, int chunkY, int chunkZ)
-    : m_voxels(static_cast<std::size_t>(kSizeX * kSizeY * kSizeZ)),
-      m_macroCells(static_cast<std::size_t>(kMacroSizeX * kMacroSizeY * kMacroSizeZ)),
+    : m_macroCells(static_cast<std::size_t>(kMacroSizeX * kMacroSizeY * kMacroSizeZ)),
       m_chunkX(chunkX),
       m_chunkY(chunkY),
       m_chunkZ(chunkZ) {}
@@ -112,12 +198,56 @@ inline void Chunk::setVoxel(int x, int y, int z, Voxel voxel) {
         return;
     }
 
-    m_voxels[linearIndex(x, y, z)] = voxel;
+    const std::size_t index = linearIndex(x, y, z);
+    if (storedVoxel(index) == voxel) {
+        return;
+    }
+    storeVoxel(index, voxel);
 
     const int macroX = x / kMacroVoxelSize;
     const int macroY = y / kMacroVoxelSize;
     const int macroZ = z / kMacroVoxelSize;
+    if (m_editDepth != 0u) {
+        m_dirtyMacroCells |= std::uint64_t{1} << macroLinearIndex(macroX, macroY, macroZ);
+        m_contentEditedInBatch = true;
+        return;
+    }
     syncMacroCellFromDense(macroX, macroY, macroZ);
+    m_contentVersion = nextContentVersion();
+    recompactIfStale();
+}
+
+inline void Chunk::beginEdit() {
+    ++m_editDepth;
+}
+
+inline void Chunk::endEdit() {
+    if (m_editDepth == 0u || --m_editDepth != 0u) {
+        return;
+    }
+    if (m_contentEditedInBatch) {
+        m_contentEditedInBatch = false;
+        m_contentVersion = nextContentVersion();
+    }
+    std::uint64_t dirty = m_dirtyMacroCells;
+    m_dirtyMacroCells = 0;
+    while (dirty != 0u) {
+        const int macroIndex = std::countr_zero(dirty);
+        dirty &= dirty - 1u;
+        const int mx = macroIndex % kMacroSizeX;
+        const int mz = (macroIndex / kMacroSizeX) % kMacroSizeZ;
+        const int my = macroIndex / (kMacroSizeX * kMacroSizeZ);
+        syncMacroCellFromDense(mx, my, mz);
+    }
+    recompactIfStale();
+}
+
+inline void Chunk::setVoxels(std::span<const VoxelWrite> writes) {
+    beginEdit();
+    for (const VoxelWrite& write : writes) {
+        setVoxel(write.x, write.y, write.z, write.voxel);
+    }
+    endEdit();
 }
 
 inline void Chunk::setVoxelRefined4(int x, int y, int z, Voxel voxel) {
@@ -128,11 +258,17 @@ inline void Chunk::fillLayer(int y, Voxel voxel) {
     if (y < 0 || y >= kSizeY) {
         return;
     }
+    beginEdit();
     for (int z = 0; z < kSizeZ; ++z) {
         for (int x = 0; x < kSizeX; ++x) {
             setVoxel(x, y, z, voxel);
         }
     }
+    endEdit();
+}
+
+inline void Chunk::fill(Voxel voxel) {
+    resetToUniform(voxel);
 }
 
 inline void Chunk::setVoxelRefined(int x, int y, int z, Voxel voxel) {
@@ -140,18 +276,14 @@ inline void Chunk::setVoxelRefined(int x, int y, int z, Voxel voxel) {
 }
 
 inline void Chunk::setFromSolidBitfield(const std::uint8_t* packedBits, std::size_t packedByteCount) {
-    constexpr std::size_t kVoxelCount = static_cast<std::size_t>(kSizeX * kSizeY * kSizeZ);
     constexpr std::size_t kExpectedBytes = (kVoxelCount + 7u) / 8u;
 
-    std::fill(m_voxels.begin(), m_voxels.end(), Voxel{VoxelType::Empty});
-    std::fill(m_macroCells.begin(), m_macroCells.end(), MacroCell{});
-    m_chunk4Cells.clear();
-    m_chunk1Cells.clear();
-
+    resetToUniform(Voxel{VoxelType::Empty});
     if (packedBits == nullptr || packedByteCount < kExpectedBytes) {
         return;
     }
 
+    expandToDense();
     std::size_t voxelIndex = 0;
     for (int y = 0; y < kSizeY; ++y) {
         for (int z = 0; z < kSizeZ; ++z) {
@@ -166,6 +298,7 @@ inline void Chunk::setFromSolidBitfield(const std::uint8_t* packedBits, std::siz
     }
 
     rebuildMacroHierarchyFromDense();
+    compactStorage();
 }
 
 inline void Chunk::setFromTypedVoxelBytes(const std::uint8_t* typeBytes, std::size_t byteCount) {
@@ -177,17 +310,12 @@ inline void Chunk::setFromTypedVoxelAndBaseColorBytes(
     const std::uint8_t* baseColorBytes,
     std::size_t byteCount
 ) {
-    constexpr std::size_t kVoxelCount = static_cast<std::size_t>(kSizeX * kSizeY * kSizeZ);
-
-    std::fill(m_voxels.begin(), m_voxels.end(), Voxel{VoxelType::Empty});
-    std::fill(m_macroCells.begin(), m_macroCells.end(), MacroCell{});
-    m_chunk4Cells.clear();
-    m_chunk1Cells.clear();
-
+    resetToUniform(Voxel{VoxelType::Empty});
     if (typeBytes == nullptr || byteCount < kVoxelCount) {
         return;
     }
 
+    expandToDense();
     std::size_t voxelIndex = 0;
     for (int y = 0; y < kSizeY; ++y) {
         for (int z = 0; z < kSizeZ; ++z) {
@@ -201,21 +329,33 @@ inline void Chunk::setFromTypedVoxelAndBaseColorBytes(
     }
 
     rebuildMacroHierarchyFromDense();
+    compactStorage();
 }
 
 inline Voxel Chunk::voxelAt(int x, int y, int z) const {
     if (!isInBounds(x, y, z)) {
         return Voxel{VoxelType::Empty};
     }
-    return m_voxels[linearIndex(x, y, z)];
+    return storedVoxel(linearIndex(x, y, z));
 }
 
 inline bool Chunk::isSolid(int x, int y, int z) const {
     return voxelAt(x, y, z).type != VoxelType::Empty;
 }
 
-inline const std::vector<Voxel>& Chunk::voxels() const {
-    return m_voxels;
+inline void Chunk::copyDenseVoxels(std::vector<Voxel>& outVoxels) const {
+    if (m_storageMode == StorageMode::Dense) {
+        outVoxels = m_voxels;
+        return;
+    }
+    outVoxels.resize(kVoxelCount);
+    if (m_storageMode == StorageMode::Uniform) {
+        std::fill(outVoxels.begin(), outVoxels.end(), m_uniformVoxel);
+        return;
+    }
+    for (std::size_t index = 0; index < kVoxelCount; ++index) {
+        outVoxels[index] = m_palette[paletteIndexAt(index)];
+    }
 }
 
 inline Chunk::MacroCell Chunk::macroCellAt(int mx, int my, int mz) const {
@@ -241,6 +381,105 @@ inline int Chunk::chunkZ() const {
     return m_chunkZ;
 }
 
+inline std::uint64_t Chunk::contentVersion() const {
+    return m_contentVersion;
+}
+
+inline std::uint64_t Chunk::nextContentVersion() {
+    static std::atomic<std::uint64_t> counter{0};
+    return counter.fetch_add(1u, std::memory_order_relaxed) + 1u;
+}
+
+inline std::span<const Voxel> Chunk::denseVoxels() const {
+    if (m_storageMode != StorageMode::Dense) {
+        return {};
+    }
+    return m_voxels;
+}
+
+inline Chunk::StorageMode Chunk::storageMode() const {
+    return m_storageMode;
+}
+
+inline std::size_t Chunk::paletteSize() const {
+    return m_storageMode == StorageMode::Palette ? m_palette.size() : 0u;
+}
+
+inline void Chunk::compactStorage() {
+    if (m_storageMode == StorageMode::Uniform) {
+        return;
+    }
+
+    std::vector<Voxel> palette;
+    std::vector<std::uint8_t> paletteIndices(kVoxelCount);
+    std::size_t lastPaletteIndex = 0;
+    for (std::size_t index = 0; index < kVoxelCount; ++index) {
+        const Voxel voxel = storedVoxel(index);
+        // Runs of the same voxel are the common case; skip the palette search.
+        if (palette.empty() || !(palette[lastPaletteIndex] == voxel)) {
+            const auto paletteIt = std::find(palette.begin(), palette.end(), voxel);
+            if (paletteIt != palette.end()) {
+                lastPaletteIndex = static_cast<std::size_t>(paletteIt - palette.begin());
+            } else {
+                if (palette.size() == kMaxPaletteSize) {
+                    expandToDense();
+                    m_denseFromOverflow = true;
+                    return;
+                }
+                palette.push_back(voxel);
+                lastPaletteIndex = palette.size() - 1u;
+            }
+        }
+        paletteIndices[index] = static_cast<std::uint8_t>(lastPaletteIndex);
+    }
+
+    m_denseFromOverflow = false;
+    if (palette.size() == 1u) {
+        m_uniformVoxel = palette.front();
+        m_storageMode = StorageMode::Uniform;
+        m_voxels = std::vector<Voxel>{};
+        clearPalette();
+        return;
+    }
+
+    m_paletteBits = paletteBitsForSize(palette.size());
+    m_paletteIndices.assign((kVoxelCount * m_paletteBits) / 64u, 0u);
+    m_paletteUseCounts.assign(palette.size(), 0u);
+    m_livePaletteEntries = palette.size();
+    m_palette = std::move(palette);
+    m_palette.shrink_to_fit();
+    m_storageMode = StorageMode::Palette;
+    m_voxels = std::vector<Voxel>{};
+    for (std::size_t index = 0; index < kVoxelCount; ++index) {
+        setPaletteIndexAt(index, paletteIndices[index]);
+        ++m_paletteUseCounts[paletteIndices[index]];
+    }
+}
+
+inline void Chunk::expandToDense() {
+    m_denseFromOverflow = false;
+    m_writesSinceOverflow = 0;
+    if (m_storageMode == StorageMode::Dense) {
+        return;
+    }
+    std::vector<Voxel> denseVoxels;
+    copyDenseVoxels(denseVoxels);
+    m_voxels = std::move(denseVoxels);
+    m_storageMode = StorageMode::Dense;
+    clearPalette();
+}
+
+inline std::size_t Chunk::memoryFootprintBytes() const {
+    return sizeof(Chunk) +
+           (m_voxels.capacity() * sizeof(Voxel)) +
+           (m_palette.capacity() * sizeof(Voxel)) +
+           (m_paletteIndices.capacity() * sizeof(std::uint64_t)) +
+           (m_paletteUseCounts.capacity() * sizeof(std::uint16_t)) +
+           (m_macroCells.capacity() * sizeof(MacroCell)) +
+           (m_chunk4Cells.capacity() * sizeof(Chunk4Cell)) +
+           (m_freeChunk4Slots.capacity() * sizeof(std::uint16_t));
+}
+
 inline std::size_t Chunk::linearIndex(int x, int y, int z) {
     return static_cast<std::size_t>(x + (kSizeX * (z + (kSizeZ * y))));
 }
@@ -253,10 +492,6 @@ inline std::size_t Chunk::refined4LinearIndex(int sx, int sy, int sz) {
     return static_cast<std::size_t>(sx + (kRefined4CellsPerAxis * (sz + (kRefined4CellsPerAxis * sy))));
 }
 
-inline std::size_t Chunk::refined1LinearIndex(int lx, int ly, int lz) {
-    return static_cast<std::size_t>(lx + (kMacroVoxelSize * (lz + (kMacroVoxelSize * ly))));
-}
-
 inline VoxelType Chunk::voxelTypeFromSerializedByte(std::uint8_t raw) {
     switch (raw) {
     case static_cast<std::uint8_t>(VoxelType::Empty):
@@ -278,6 +513,19 @@ inline VoxelType Chunk::voxelTypeFromSerializedByte(std::uint8_t raw) {
     }
 }
 
+inline std::uint8_t Chunk::paletteBitsForSize(std::size_t paletteSize) {
+    if (paletteSize <= 2u) {
+        return 1u;
+    }
+    if (paletteSize <= 4u) {
+        return 2u;
+    }
+    if (paletteSize <= 16u) {
+        return 4u;
+    }
+    return 8u;
+}
+
 inline bool Chunk::isInBounds(int x, int y, int z) {
     return x >= 0 && x < kSizeX && y >= 0 && y < kSizeY && z >= 0 && z < kSizeZ;
 }
@@ -286,56 +534,149 @@ inline bool Chunk::isMacroInBounds(int mx, int my, int mz) {
     return mx >= 0 && mx < kMacroSizeX && my >= 0 && my < kMacroSizeY && mz >= 0 && mz < kMacroSizeZ;
 }
 
-inline std::size_t Chunk::ensureChunk4IndexForCell(MacroCell& cell) {
-    if (cell.refined4Index != kInvalidRefinementIndex && cell.refined4Index < m_chunk4Cells.size()) {
-        return static_cast<std::size_t>(cell.refined4Index);
-    }
-
-    Chunk4Cell newChunk4Cell{};
-    for (Voxel& subcell : newChunk4Cell.subcells) {
-        subcell = cell.voxel;
+inline Voxel Chunk::storedVoxel(std::size_t index) const {
+    switch (m_storageMode) {
+    case StorageMode::Dense:
+        return m_voxels[index];
+    case StorageMode::Palette:
+        return m_palette[paletteIndexAt(index)];
+    case StorageMode::Uniform:
+    default:
+        return m_uniformVoxel;
     }
-    m_chunk4Cells.push_back(newChunk4Cell);
-    const std::size_t index = m_chunk4Cells.size() - 1;
-    cell.refined4Index = static_cast<std::uint16_t>(index);
-    return index;
 }
 
-inline std::size_t Chunk::ensureChunk1IndexForCell(MacroCell& cell, int mx, int my, int mz) {
-    if (cell.refined1Index != kInvalidRefinementIndex && cell.refined1Index < m_chunk1Cells.size()) {
-        return static_cast<std::size_t>(cell.refined1Index);
+inline void Chunk::storeVoxel(std::size_t index, Voxel voxel) {
+    switch (m_storageMode) {
+    case StorageMode::Dense:
+        m_voxels[index] = voxel;
+        if (m_denseFromOverflow) {
+            ++m_writesSinceOverflow;
+        }
+        return;
+    case StorageMode::Uniform:
+        if (voxel == m_uniformVoxel) {
+            return;
+        }
+        m_palette = {m_uniformVoxel, voxel};
+        m_paletteUseCounts = {static_cast<std::uint16_t>(kVoxelCount - 1u), 1u};
+        m_livePaletteEntries = 2u;
+        m_paletteBits = 1u;
+        m_paletteIndices.assign(kVoxelCount / 64u, 0u);
+        m_storageMode = StorageMode::Palette;
+        setPaletteIndexAt(index, 1u);
+        return;
+    case StorageMode::Palette:
+    default:
+        break;
     }
 
-    Chunk1Cell newChunk1Cell{};
-    const int baseX = mx * kMacroVoxelSize;
-    const int baseY = my * kMacroVoxelSize;
-    const int baseZ = mz * kMacroVoxelSize;
-    for (int ly = 0; ly < kMacroVoxelSize; ++ly) {
-        for (int lz = 0; lz < kMacroVoxelSize; ++lz) {
-            for (int lx = 0; lx < kMacroVoxelSize; ++lx) {
-                newChunk1Cell.voxels[refined1LinearIndex(lx, ly, lz)] =
-                    m_voxels[linearIndex(baseX + lx, baseY + ly, baseZ + lz)];
+    // Entries are appended here and go stale at a use count of 0;
+    // recompactIfStale() and compactStorage() drop them.
+    auto paletteIt = std::find(m_palette.begin(), m_palette.end(), voxel);
+    if (paletteIt == m_palette.end()) {
+        if (m_palette.size() == kMaxPaletteSize) {
+            if (m_livePaletteEntries < kMaxPaletteSize) {
+                // Stale entries hold the free slots: reclaim them instead of
+                // going dense.
+                compactStorage();
+                storeVoxel(index, voxel);
+                return;
             }
+            expandToDense();
+            m_denseFromOverflow = true;
+            m_voxels[index] = voxel;
+            return;
         }
+        m_palette.push_back(voxel);
+        m_paletteUseCounts.push_back(0u);
+        paletteIt = m_palette.end() - 1;
+        if (m_palette.size() > (std::size_t{1} << m_paletteBits)) {
+            repackPaletteIndices(static_cast<std::uint8_t>(m_paletteBits * 2u));
+        }
+    }
+    const std::uint32_t previousPaletteIndex = paletteIndexAt(index);
+    const std::uint32_t paletteIndex = static_cast<std::uint32_t>(paletteIt - m_palette.begin());
+    if (--m_paletteUseCounts[previousPaletteIndex] == 0u) {
+        --m_livePaletteEntries;
     }
+    if (m_paletteUseCounts[paletteIndex]++ == 0u) {
+        ++m_livePaletteEntries;
+    }
+    setPaletteIndexAt(index, paletteIndex);
+}
+
+inline std::uint32_t Chunk::paletteIndexAt(std::size_t index) const {
+    const std::size_t bitOffset = index * m_paletteBits;
+    const std::uint64_t mask = (std::uint64_t{1} << m_paletteBits) - 1u;
+    return static_cast<std::uint32_t>((m_paletteIndices[bitOffset >> 6u] >> (bitOffset & 63u)) & mask);
+}
+
+inline void Chunk::setPaletteIndexAt(std::size_t index, std::uint32_t paletteIndex) {
+    const std::size_t bitOffset = index * m_paletteBits;
+    const std::uint64_t mask = ((std::uint64_t{1} << m_paletteBits) - 1u) << (bitOffset & 63u);
+    std::uint64_t& word = m_paletteIndices[bitOffset >> 6u];
+    word = (word & ~mask) | ((static_cast<std::uint64_t>(paletteIndex) << (bitOffset & 63u)) & mask);
+}
 
-    m_chunk1Cells.push_back(newChunk1Cell);
-    const std::size_t index = m_chunk1Cells.size() - 1;
-    cell.refined1Index = static_cast<std::uint16_t>(index);
-    return index;
+inline void Chunk::repackPaletteIndices(std::uint8_t bitsPerIndex) {
+    std::vector<std::uint32_t> paletteIndices(kVoxelCount);
+    for (std::size_t index = 0; index < kVoxelCount; ++index) {
+        paletteIndices[index] = paletteIndexAt(index);
+    }
+    m_paletteBits = bitsPerIndex;
+    m_paletteIndices.assign((kVoxelCount * m_paletteBits) / 64u, 0u);
+    for (std::size_t index = 0; index < kVoxelCount; ++index) {
+        setPaletteIndexAt(index, paletteIndices[index]);
+    }
 }
 
-inline bool Chunk::isUniformChunk4(const Chunk4Cell& chunk4Cell) {
-    const VoxelType firstType = chunk4Cell.subcells[0].type;
-    for (const Voxel& subcell : chunk4Cell.subcells) {
-        if (subcell.type != firstType) {
-            return false;
+inline void Chunk::recompactIfStale() {
+    if (m_storageMode == StorageMode::Palette) {
+        // Waiting until stale entries outnumber live ones keeps a voxel
+        // toggled back and forth from recompacting on every edit.
+        const std::size_t staleEntries = m_palette.size() - m_livePaletteEntries;
+        if (staleEntries != 0u && staleEntries >= m_livePaletteEntries) {
+            compactStorage();
         }
+        return;
+    }
+    if (m_storageMode == StorageMode::Dense && m_denseFromOverflow && m_writesSinceOverflow >= kOverflowRecheckWrites) {
+        m_writesSinceOverflow = 0;
+        compactStorage();
+    }
+}
+
+inline void Chunk::clearPalette() {
+    m_paletteBits = 0;
+    m_palette = std::vector<Voxel>{};
+    m_paletteIndices = std::vector<std::uint64_t>{};
+    m_paletteUseCounts = std::vector<std::uint16_t>{};
+    m_livePaletteEntries = 0;
+}
+
+inline void Chunk::resetToUniform(Voxel voxel) {
+    m_contentVersion = nextContentVersion();
+    m_storageMode = StorageMode::Uniform;
+    m_uniformVoxel = voxel;
+    m_denseFromOverflow = false;
+    m_writesSinceOverflow = 0;
+    m_voxels = std::vector<Voxel>{};
+    clearPalette();
+    m_chunk4Cells.clear();
+    m_freeChunk4Slots.clear();
+    m_dirtyMacroCells = 0;
+    for (MacroCell& cell : m_macroCells) {
+        cell = MacroCell{};
+        cell.voxel = voxel;
     }
-    return true;
 }
 
 inline void Chunk::rebuildMacroHierarchyFromDense() {
+    m_chunk4Cells.clear();
+    m_freeChunk4Slots.clear();
+    m_dirtyMacroCells = 0;
+    std::fill(m_macroCells.begin(), m_macroCells.end(), MacroCell{});
     for (int my = 0; my < kMacroSizeY; ++my) {
         for (int mz = 0; mz < kMacroSizeZ; ++mz) {
             for (int mx = 0; mx < kMacroSizeX; ++mx) {
@@ -354,18 +695,39 @@ inline void Chunk::syncMacroCellFromDense(int mx, int my, int mz) {
     const int beginY = my * kMacroVoxelSize;
     const int beginZ = mz * kMacroVoxelSize;
 
-    const Voxel first = m_voxels[linearIndex(beginX, beginY, beginZ)];
+    // One pass over the 8^3 block tracks whole-cell uniformity and, per 4^3
+    // subcell, its first voxel (the subcell origin comes first in y/z/x order)
+    // and whether the rest of the subcell matches its type.
+    constexpr std::size_t kSubcellCount =
+        static_cast<std::size_t>(kRefined4CellsPerAxis * kRefined4CellsPerAxis * kRefined4CellsPerAxis);
+    Chunk4Cell chunk4Cell{};
+    std::array<bool, kSubcellCount> subcellUniform{};
+    subcellUniform.fill(true);
+    const Voxel first = storedVoxel(linearIndex(beginX, beginY, beginZ));
     bool uniform = true;
-    bool anySolid = first.type != VoxelType::Empty;
+    bool anySolid = false;
 
     for (int localY = 0; localY < kMacroVoxelSize; ++localY) {
         for (int localZ = 0; localZ < kMacroVoxelSize; ++localZ) {
             for (int localX = 0; localX < kMacroVoxelSize; ++localX) {
                 const Voxel sample =
-                    m_voxels[linearIndex(beginX + localX, beginY + localY, beginZ + localZ)];
+                    storedVoxel(linearIndex(beginX + localX, beginY + localY, beginZ + localZ));
                 anySolid = anySolid || (sample.type != VoxelType::Empty);
-                if (sample.type != first.type) {
-                    uniform = false;
+                uniform = uniform && (sample.type == first.type);
+
+                const std::size_t subcell = refined4LinearIndex(
+                    localX / kRefined4VoxelSize,
+                    localY / kRefined4VoxelSize,
+                    localZ / kRefined4VoxelSize
+                );
+                const bool subcellOrigin =
+                    (localX % kRefined4VoxelSize) == 0 &&
+                    (localY % kRefined4VoxelSize) == 0 &&
+                    (localZ % kRefined4VoxelSize) == 0;
+                if (subcellOrigin) {
+                    chunk4Cell.subcells[subcell] = sample;
+                } else if (sample.type != chunk4Cell.subcells[subcell].type) {
+                    subcellUniform[subcell] = false;
                 }
             }
         }
@@ -373,57 +735,50 @@ inline void Chunk::syncMacroCellFromDense(int mx, int my, int mz) {
 
     MacroCell& cell = m_macroCells[macroLinearIndex(mx, my, mz)];
     if (uniform) {
+        releaseChunk4Slot(cell);
         cell.voxel = first;
         cell.resolution = CellResolution::Uniform;
         cell.refined4Index = kInvalidRefinementIndex;
         cell.refined1Index = kInvalidRefinementIndex;
         return;
     }
-    bool canRepresentAsChunk4 = true;
-    Chunk4Cell chunk4Cell{};
-    for (int subY = 0; subY < kRefined4CellsPerAxis; ++subY) {
-        for (int subZ = 0; subZ < kRefined4CellsPerAxis; ++subZ) {
-            for (int subX = 0; subX < kRefined4CellsPerAxis; ++subX) {
-                const int subBeginX = beginX + (subX * kRefined4VoxelSize);
-                const int subBeginY = beginY + (subY * kRefined4VoxelSize);
-                const int subBeginZ = beginZ + (subZ * kRefined4VoxelSize);
-                const Voxel subFirst = m_voxels[linearIndex(subBeginX, subBeginY, subBeginZ)];
-                for (int ly = 0; ly < kRefined4VoxelSize; ++ly) {
-                    for (int lz = 0; lz < kRefined4VoxelSize; ++lz) {
-                        for (int lx = 0; lx < kRefined4VoxelSize; ++lx) {
-                            if (m_voxels[linearIndex(subBeginX + lx, subBeginY + ly, subBeginZ + lz)].type != subFirst.type) {
-                                canRepresentAsChunk4 = false;
-                            }
-                        }
-                    }
-                }
-                chunk4Cell.subcells[refined4LinearIndex(subX, subY, subZ)] = subFirst;
-            }
-        }
-    }
 
+    const bool canRepresentAsChunk4 =
+        std::all_of(subcellUniform.begin(), subcellUniform.end(), [](bool subcellIsUniform) { return subcellIsUniform; });
     cell.voxel = Voxel{anySolid ? VoxelType::Solid : VoxelType::Empty};
     if (canRepresentAsChunk4) {
-        m_chunk4Cells.push_back(chunk4Cell);
-        cell.refined4Index = static_cast<std::uint16_t>(m_chunk4Cells.size() - 1);
+        // An edit inside a cell that is already Refined4 rewrites its slot in
+        // place; otherwise a released slot is reused before the vector grows.
+        if (cell.resolution != CellResolution::Refined4 || cell.refined4Index >= m_chunk4Cells.size()) {
+            cell.refined4Index = acquireChunk4Slot();
+        }
+        m_chunk4Cells[cell.refined4Index] = chunk4Cell;
         cell.refined1Index = kInvalidRefinementIndex;
         cell.resolution = CellResolution::Refined4;
         return;
     }
 
-    Chunk1Cell chunk1Cell{};
-    for (int ly = 0; ly < kMacroVoxelSize; ++ly) {
-        for (int lz = 0; lz < kMacroVoxelSize; ++lz) {
-            for (int lx = 0; lx < kMacroVoxelSize; ++lx) {
-                chunk1Cell.voxels[refined1LinearIndex(lx, ly, lz)] =
-                    m_voxels[linearIndex(beginX + lx, beginY + ly, beginZ + lz)];
-            }
-        }
-    }
-    m_chunk1Cells.push_back(chunk1Cell);
-    cell.refined1Index = static_cast<std::uint16_t>(m_chunk1Cells.size() - 1);
+    releaseChunk4Slot(cell);
+    cell.refined1Index = static_cast<std::uint16_t>(macroLinearIndex(mx, my, mz));
     cell.refined4Index = kInvalidRefinementIndex;
     cell.resolution = CellResolution::Refined1;
 }
 
+inline std::uint16_t Chunk::acquireChunk4Slot() {
+    if (!m_freeChunk4Slots.empty()) {
+        const std::uint16_t slot = m_freeChunk4Slots.back();
+        m_freeChunk4Slots.pop_back();
+        return slot;
+    }
+    m_chunk4Cells.emplace_back();
+    return static_cast<std::uint16_t>(m_chunk4Cells.size() - 1);
+}
+
+inline void Chunk::releaseChunk4Slot(MacroCell& cell) {
+    if (cell.resolution == CellResolution::Refined4 && cell.refined4Index < m_chunk4Cells.size()) {
+        m_freeChunk4Slots.push_back(cell.refined4Index);
+    }
+    cell.refined4Index = kInvalidRefinementIndex;
+}
+
 } // namespace odai::world
@@ -9,12 +9,22 @@
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
+#include "core/grid3.h"
+#include "core/hash.h"
+#include "core/job_system.h"
 #include "core/log.h"
+#include "core/parallel_for.h"
 #include "world/chunk.h"
 #include "world/voxel.h"
+#include "world/world_file.h"
 
 // World ChunkGrid subsystem
 // Responsible for: owning a collection of chunks that represent world space.
@@ -26,7 +36,12 @@ public:
     ChunkGrid() = default;
     void initializeEmptyWorld();
     void initializeFlatWorld();
-    bool loadFromBinaryFile(const std::filesystem::path& path);
+    // Reads VXW4 (see world/world_file.h) and the legacy VXW1 v1-v3 formats.
+    // `jobs`, when given, decodes chunks in parallel (the calling thread
+    // helps). Output is identical to the serial path: each chunk decodes
+    // independently into its own slot.
+    bool loadFromBinaryFile(const std::filesystem::path& path, core::JobSystem* jobs = nullptr);
+    // Always writes VXW4.
     bool saveToBinaryFile(const std::filesystem::path& path) const;
     std::size_t chunkCount() const;
     void setChunks(std::vector<Chunk> chunks);
@@ -34,10 +49,94 @@ public:
     const std::vector<Chunk>& chunks() const;
 
 private:
+    bool loadFromIndexedFile(const std::filesystem::path& path, core::JobSystem* jobs);
+
     std::vector<Chunk> m_chunks;
 };
 
-Chunk buildProceduralChunk(int chunkX, int chunkY, int chunkZ);
+// What buildProceduralChunk produces for a chunk. Air and Solid chunks come
+// back as Uniform chunks without the per-voxel pass.
+enum class ProceduralChunkContent : std::uint8_t {
+    Air = 0,
+    Solid = 1,
+    Terrain = 2
+};
+
+// From chunkY alone: stone below y 0, air above the highest terrain and tree
+// the generator can produce. Those layers skip sampling terrain at all.
+[[nodiscard]] ProceduralChunkContent classifyProceduralChunk(int chunkY);
+// For one chunk, from the lowest and highest surface height among its
+// columns and the columns whose trees can reach it: also Solid when the chunk
+// lies below every column's dirt band and Air when it lies above every tree.
+[[nodiscard]] ProceduralChunkContent classifyProceduralChunk(int chunkY, int minSurfaceHeight, int maxSurfaceHeight);
+
+// Terrain of a kRegionChunks x kRegionChunks block of chunk columns: the base
+// columns (every noise field, biome and settlement mask, before erosion) over
+// the block and the apron its patches read, and each column's finished
+// terrain patch, built on first use. Defined in chunk_grid_worldgen.cc.
+struct TerrainRegion;
+
+// Thread-safe cache of TerrainRegions shared by chunk generation. A chunk's
+// terrain patch overlaps its neighbours' by the apron erosion and slope
+// passes need, and every layer of a column builds the same patch. With the
+// cache, base columns are sampled once per region and each column's patch is
+// built once for all its layers. Erosion still runs per chunk column: its
+// result depends on the patch extent, and chunks must not change with it.
+// Regions are lent as shared views. One nobody else holds is idle, and idle
+// regions past maxIdleRegions are evicted least recently used first; a region
+// with all its columns built holds about 3.5 MB. Concurrent requests for a
+// region or column being built wait for it rather than building it again.
+class TerrainPatchCache {
+public:
+    static constexpr int kRegionChunks = 4;
+
+    struct Stats {
+        std::uint64_t builtRegionCount = 0;
+        std::uint64_t reusedRegionCount = 0;
+        std::uint64_t evictedRegionCount = 0;
+        std::size_t cachedRegionCount = 0;
+    };
+
+    explicit TerrainPatchCache(std::size_t maxIdleRegions = 4);
+    TerrainPatchCache(const TerrainPatchCache&) = delete;
+    TerrainPatchCache& operator=(const TerrainPatchCache&) = delete;
+
+    // The region holding chunk column (chunkX, chunkZ), built on first use.
+    // `jobs` splits the build the same way buildProceduralChunk's does.
+    [[nodiscard]] std::shared_ptr<const TerrainRegion> acquire(
+        int chunkX,
+        int chunkZ,
+        core::JobSystem* jobs = nullptr
+    );
+    [[nodiscard]] Stats stats() const;
+
+private:
+    struct Entry {
+        std::shared_future<std::shared_ptr<const TerrainRegion>> region;
+        std::uint64_t lastUse = 0;
+    };
+
+    void evictIdleRegionsLocked();
+
+    std::size_t m_maxIdleRegions = 4;
+    mutable std::mutex m_mutex;
+    std::unordered_map<core::Cell3i, Entry, core::Cell3Hash> m_entries;
+    std::uint64_t m_useClock = 0;
+    Stats m_stats{};
+};
+
+// Deterministic in (chunkX, chunkY, chunkZ): saved worlds regenerate through
+// it. `jobs`, when given, splits the terrain patch's row passes across the
+// pool (the calling thread helps). `terrainCache`, when given, supplies the
+// patch's base columns from a shared region. The chunk is bit-identical
+// either way.
+Chunk buildProceduralChunk(
+    int chunkX,
+    int chunkY,
+    int chunkZ,
+    core::JobSystem* jobs = nullptr,
+    TerrainPatchCache* terrainCache = nullptr
+);
 
 inline void ChunkGrid::initializeEmptyWorld() {
     m_chunks.clear();
@@ -59,7 +158,11 @@ inline void ChunkGrid::initializeEmptyWorld() {
     }
 }
 
-inline bool ChunkGrid::loadFromBinaryFile(const std::filesystem::path& path) {
+inline bool ChunkGrid::loadFromBinaryFile(const std::filesystem::path& path, core::JobSystem* jobs) {
+    if (isIndexedWorldFile(path)) {
+        return loadFromIndexedFile(path, jobs);
+    }
+
     using Clock = std::chrono::steady_clock;
     const auto loadStart = Clock::now();
     std::ifstream in(path, std::ios::binary);
@@ -91,54 +194,68 @@ inline bool ChunkGrid::loadFromBinaryFile(const std::filesystem::path& path) {
     constexpr std::size_t kVoxelsPerChunk =
         static_cast<std::size_t>(Chunk::kSizeX * Chunk::kSizeY * Chunk::kSizeZ);
     constexpr std::size_t kBytesPerChunk = (kVoxelsPerChunk + 7u) / 8u;
-    std::vector<std::uint8_t> typeBytes(kVoxelsPerChunk, 0u);
-    std::vector<std::uint8_t> baseColorBytes(kVoxelsPerChunk, 0xFFu);
-    std::vector<std::uint8_t> packed(kBytesPerChunk, 0u);
+    // v1: solid bitfield. v2: type plane. v3: type plane + base-color plane.
+    const std::size_t payloadBytesPerChunk =
+        (version == 1u) ? kBytesPerChunk : ((version == 2u) ? kVoxelsPerChunk : (kVoxelsPerChunk * 2u));
+    // Reading is sequential, decoding is per chunk and independent. Read a
+    // bounded batch of raw payloads, then decode the batch in parallel; the
+    // batch keeps peak staging memory at kDecodeBatchChunks payloads instead
+    // of the whole file.
+    constexpr std::size_t kDecodeBatchChunks = 64;
+    std::vector<std::uint8_t> batchPayloads(payloadBytesPerChunk * kDecodeBatchChunks, 0u);
     std::int64_t ioMicros = 0;
     std::int64_t decodeMicros = 0;
 
     std::vector<Chunk> loadedChunks;
     loadedChunks.reserve(static_cast<std::size_t>(chunkCount));
 
-    for (std::uint32_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex) {
-        const auto ioStart = Clock::now();
-        std::int32_t chunkX = 0;
-        std::int32_t chunkY = 0;
-        std::int32_t chunkZ = 0;
-        in.read(reinterpret_cast<char*>(&chunkX), sizeof(chunkX));
-        in.read(reinterpret_cast<char*>(&chunkY), sizeof(chunkY));
-        in.read(reinterpret_cast<char*>(&chunkZ), sizeof(chunkZ));
-        Chunk chunk(chunkX, chunkY, chunkZ);
+    const auto decodeChunk = [&](Chunk& chunk, const std::uint8_t* payload) {
         if (version == 1u) {
-            in.read(reinterpret_cast<char*>(packed.data()), static_cast<std::streamsize>(packed.size()));
-            if (!in.good()) {
-                return false;
-            }
-            ioMicros += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - ioStart).count();
-            const auto decodeStart = Clock::now();
-            chunk.setFromSolidBitfield(packed.data(), packed.size());
-            decodeMicros += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - decodeStart).count();
+            chunk.setFromSolidBitfield(payload, kBytesPerChunk);
         } else if (version == 2u) {
-            in.read(reinterpret_cast<char*>(typeBytes.data()), static_cast<std::streamsize>(typeBytes.size()));
+            chunk.setFromTypedVoxelBytes(payload, kVoxelsPerChunk);
+        } else {
+            chunk.setFromTypedVoxelAndBaseColorBytes(payload, payload + kVoxelsPerChunk, kVoxelsPerChunk);
+        }
+    };
+
+    for (std::uint32_t batchStart = 0; batchStart < chunkCount; batchStart += kDecodeBatchChunks) {
+        const std::size_t batchSize =
+            std::min<std::size_t>(kDecodeBatchChunks, static_cast<std::size_t>(chunkCount - batchStart));
+        const auto ioStart = Clock::now();
+        for (std::size_t batchIndex = 0; batchIndex < batchSize; ++batchIndex) {
+            std::int32_t chunkX = 0;
+            std::int32_t chunkY = 0;
+            std::int32_t chunkZ = 0;
+            in.read(reinterpret_cast<char*>(&chunkX), sizeof(chunkX));
+            in.read(reinterpret_cast<char*>(&chunkY), sizeof(chunkY));
+            in.read(reinterpret_cast<char*>(&chunkZ), sizeof(chunkZ));
+            in.read(
+                reinterpret_cast<char*>(batchPayloads.data() + (batchIndex * payloadBytesPerChunk)),
+                static_cast<std::streamsize>(payloadBytesPerChunk)
+            );
             if (!in.good()) {
                 return false;
             }
-            ioMicros += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - ioStart).count();
-            const auto decodeStart = Clock::now();
-            chunk.setFromTypedVoxelBytes(typeBytes.data(), typeBytes.size());
-            decodeMicros += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - decodeStart).count();
+            loadedChunks.emplace_back(chunkX, chunkY, chunkZ);
+        }
+        ioMicros += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - ioStart).count();
+
+        const auto decodeStart = Clock::now();
+        Chunk* batchChunks = loadedChunks.data() + batchStart;
+        const auto decodeBatchEntry = [&](std::size_t batchIndex) {
+            decodeChunk(batchChunks[batchIndex], batchPayloads.data() + (batchIndex * payloadBytesPerChunk));
+        };
+        if (jobs != nullptr) {
+            // One chunk per range: a decode is ~100us, far above the cost of
+            // claiming a range.
+            core::parallelFor(*jobs, 0, batchSize, 1, decodeBatchEntry);
         } else {
-            in.read(reinterpret_cast<char*>(typeBytes.data()), static_cast<std::streamsize>(typeBytes.size()));
-            in.read(reinterpret_cast<char*>(baseColorBytes.data()), static_cast<std::streamsize>(baseColorBytes.size()));
-            if (!in.good()) {
-                return false;
+            for (std::size_t batchIndex = 0; batchIndex < batchSize; ++batchIndex) {
+                decodeBatchEntry(batchIndex);
             }
-            ioMicros += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - ioStart).count();
-            const auto decodeStart = Clock::now();
-            chunk.setFromTypedVoxelAndBaseColorBytes(typeBytes.data(), baseColorBytes.data(), typeBytes.size());
-            decodeMicros += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - decodeStart).count();
         }
-        loadedChunks.push_back(std::move(chunk));
+        decodeMicros += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - decodeStart).count();
     }
 
     m_chunks = std::move(loadedChunks);
@@ -148,62 +265,62 @@ inline bool ChunkGrid::loadFromBinaryFile(const std::filesystem::path& path) {
     VOX_LOGI("world") << "load binary '" << path.string() << "'"
                       << " version=" << version
                       << ", chunks=" << chunkCount
+                      << ", decodeWorkers=" << ((jobs != nullptr) ? jobs->workerCount() + 1u : 1u)
                       << ", ioMs=" << ioMs
                       << ", decodeMs=" << decodeMs
                       << ", totalMs=" << totalMs;
     return true;
 }
 
-inline bool ChunkGrid::saveToBinaryFile(const std::filesystem::path& path) const {
-    std::ofstream out(path, std::ios::binary | std::ios::trunc);
-    if (!out.is_open()) {
-        return false;
-    }
-
-    constexpr char kMagic[4] = {'V', 'X', 'W', '1'};
-    constexpr std::uint32_t kVersion = 3u;
-    const std::uint32_t chunkCount = static_cast<std::uint32_t>(m_chunks.size());
-    out.write(kMagic, sizeof(kMagic));
-    out.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
-    out.write(reinterpret_cast<const char*>(&chunkCount), sizeof(chunkCount));
-    if (!out.good()) {
+inline bool ChunkGrid::loadFromIndexedFile(const std::filesystem::path& path, core::JobSystem* jobs) {
+    using Clock = std::chrono::steady_clock;
+    const auto loadStart = Clock::now();
+    WorldFileReader reader;
+    if (!reader.open(path)) {
         return false;
     }
+    // Mapping plus directory parse; payload pages fault in during decode.
+    const auto ioEnd = Clock::now();
 
-    constexpr std::size_t kVoxelsPerChunk =
-        static_cast<std::size_t>(Chunk::kSizeX * Chunk::kSizeY * Chunk::kSizeZ);
-    std::vector<std::uint8_t> typeBytes(kVoxelsPerChunk, 0u);
-    std::vector<std::uint8_t> baseColorBytes(kVoxelsPerChunk, 0xFFu);
-
-    for (const Chunk& chunk : m_chunks) {
-        const std::int32_t chunkX = static_cast<std::int32_t>(chunk.chunkX());
-        const std::int32_t chunkY = static_cast<std::int32_t>(chunk.chunkY());
-        const std::int32_t chunkZ = static_cast<std::int32_t>(chunk.chunkZ());
-        out.write(reinterpret_cast<const char*>(&chunkX), sizeof(chunkX));
-        out.write(reinterpret_cast<const char*>(&chunkY), sizeof(chunkY));
-        out.write(reinterpret_cast<const char*>(&chunkZ), sizeof(chunkZ));
-
-        std::size_t voxelIndex = 0;
-        for (int y = 0; y < Chunk::kSizeY; ++y) {
-            for (int z = 0; z < Chunk::kSizeZ; ++z) {
-                for (int x = 0; x < Chunk::kSizeX; ++x, ++voxelIndex) {
-                    const Voxel voxel = chunk.voxelAt(x, y, z);
-                    typeBytes[voxelIndex] = static_cast<std::uint8_t>(voxel.type);
-                    baseColorBytes[voxelIndex] = voxel.baseColorIndex;
-                }
-            }
-        }
-
-        out.write(reinterpret_cast<const char*>(typeBytes.data()), static_cast<std::streamsize>(typeBytes.size()));
-        out.write(reinterpret_cast<const char*>(baseColorBytes.data()), static_cast<std::streamsize>(baseColorBytes.size()));
-        if (!out.good()) {
-            return false;
+    const std::span<const WorldFileChunkEntry> entries = reader.entries();
+    std::vector<Chunk> loadedChunks(entries.size());
+    std::vector<std::uint8_t> decoded(entries.size(), 0u);
+    const auto decodeEntry = [&](std::size_t entryIndex) {
+        decoded[entryIndex] = reader.readChunk(entries[entryIndex], loadedChunks[entryIndex]) ? 1u : 0u;
+    };
+    if (jobs != nullptr) {
+        core::parallelFor(*jobs, 0, entries.size(), 1, decodeEntry);
+    } else {
+        for (std::size_t entryIndex = 0; entryIndex < entries.size(); ++entryIndex) {
+            decodeEntry(entryIndex);
         }
     }
+    if (std::find(decoded.begin(), decoded.end(), std::uint8_t{0}) != decoded.end()) {
+        VOX_LOGW("world") << "world file '" << path.string() << "' has a malformed chunk payload";
+        return false;
+    }
 
+    m_chunks = std::move(loadedChunks);
+    const auto loadEnd = Clock::now();
+    const double ioMs =
+        static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(ioEnd - loadStart).count()) / 1000.0;
+    const double decodeMs =
+        static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(loadEnd - ioEnd).count()) / 1000.0;
+    const auto totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(loadEnd - loadStart).count();
+    VOX_LOGI("world") << "load binary '" << path.string() << "'"
+                      << " version=" << kWorldFileVersion
+                      << ", chunks=" << entries.size()
+                      << ", decodeWorkers=" << ((jobs != nullptr) ? jobs->workerCount() + 1u : 1u)
+                      << ", ioMs=" << ioMs
+                      << ", decodeMs=" << decodeMs
+                      << ", totalMs=" << totalMs;
     return true;
 }
 
+inline bool ChunkGrid::saveToBinaryFile(const std::filesystem::path& path) const {
+    return writeWorldFile(path, m_chunks);
+}
+
 inline std::size_t ChunkGrid::chunkCount() const {
     return m_chunks.size();
 }
@@ -5,12 +5,30 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <future>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <span>
+#include <utility>
 #include <vector>
 
+// Terrain noise is evaluated kColumnBatchSize columns at a time in
+// structure-of-arrays form. The SSE2 path only uses IEEE add/sub/mul and sign
+// flips, which round exactly like the scalar code, and FMA contraction is not
+// enabled in shipped builds (see ODAI_ENABLE_NATIVE_ARCH), so batched and
+// scalar sampling produce bit-identical terrain -- saved worlds and the
+// worldgen golden hash in tests/foundation_tests.cc depend on it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ODAI_WORLDGEN_SSE2 1
+#endif
+
 namespace odai::world {
 
 namespace {
@@ -52,11 +70,6 @@ struct SettlementSite {
     int radius = 10;
 };
 
-struct WarpedPoint {
-    float x = 0.0f;
-    float z = 0.0f;
-};
-
 struct TerrainPatch {
     int minWorldX = 0;
     int minWorldZ = 0;
@@ -86,6 +99,19 @@ struct TerrainPatch {
 
 constexpr int kTerrainPatchBorder = 12;
 constexpr int kHydraulicErosionIterations = 10;
+// Surface heights clamp to [1, kMaxTerrainHeight], which leaves peaks room to
+// rise through the layers above the surface; columns below world y 0 are
+// solid stone.
+constexpr int kMaxTerrainHeight = (4 * Chunk::kSizeY) - 6;
+// Trees only grow on ground below this height.
+constexpr int kTreeTerrainHeightLimit = Chunk::kSizeY - 8;
+// Tallest tree above its ground voxel: a 6-voxel trunk from ground + 1, then
+// up to 3 canopy layers over the trunk top and a 1-voxel cap.
+constexpr int kMaxTreeHeightAboveGround = 10;
+// Trees are stamped from columns up to this far outside the chunk.
+constexpr int kTreeCanopyReach = 3;
+constexpr int kMaxProceduralVoxelY =
+    std::max(kMaxTerrainHeight, (kTreeTerrainHeightLimit - 1) + kMaxTreeHeightAboveGround);
 
 constexpr std::array<std::uint8_t, 256> kPerlinPermutation = {
     151,160,137,91,90,15,131,13,201,95,96,53,194,233,7,225,
@@ -160,22 +186,148 @@ float perlin2(float x, float z) {
     return lerp(x0, x1, v);
 }
 
-float ridgedPerlin2(float x, float z) {
-    return 1.0f - std::abs(std::clamp(perlin2(x, z), -1.0f, 1.0f));
+constexpr int kColumnBatchSize = 8;
+
+using NoiseLanes = std::array<float, kColumnBatchSize>;
+
+#if defined(ODAI_WORLDGEN_SSE2)
+// grad2 for four lanes: hash bit 2 picks the single-axis cases, bit 1 the z
+// axis (or a negated z in the two-axis cases), bit 0 a negated x (or result).
+__m128 grad2Lanes(__m128i hash, __m128 x, __m128 z) {
+    const __m128 signBit = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u)));
+    const __m128 bit0 = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(hash, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    const __m128 bit1 = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(hash, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+    const __m128 bit2 = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(hash, _mm_set1_epi32(4)), _mm_set1_epi32(4)));
+    const __m128 signedX = _mm_xor_ps(x, _mm_and_ps(bit0, signBit));
+    const __m128 signedZ = _mm_xor_ps(z, _mm_and_ps(bit1, signBit));
+    const __m128 twoAxis = _mm_add_ps(signedX, signedZ);
+    const __m128 axis = _mm_or_ps(_mm_and_ps(bit1, z), _mm_andnot_ps(bit1, x));
+    const __m128 oneAxis = _mm_xor_ps(axis, _mm_and_ps(bit0, signBit));
+    return _mm_or_ps(_mm_and_ps(bit2, oneAxis), _mm_andnot_ps(bit2, twoAxis));
+}
+
+__m128 fadeLanes(__m128 t) {
+    const __m128 inner = _mm_add_ps(
+        _mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))),
+        _mm_set1_ps(10.0f)
+    );
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+}
+
+__m128 lerpLanes(__m128 a, __m128 b, __m128 t) {
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+#endif
+
+// perlin2 for kColumnBatchSize points at once. Lattice lookups stay scalar
+// (they are table gathers); the fade, gradient and blend arithmetic runs four
+// lanes wide with exactly the scalar operation order.
+void perlin2Batch(const float* x, const float* z, float* out) {
+#if defined(ODAI_WORLDGEN_SSE2)
+    alignas(16) std::array<float, kColumnBatchSize> xf{};
+    alignas(16) std::array<float, kColumnBatchSize> zf{};
+    alignas(16) std::array<std::int32_t, kColumnBatchSize> hashAA{};
+    alignas(16) std::array<std::int32_t, kColumnBatchSize> hashAB{};
+    alignas(16) std::array<std::int32_t, kColumnBatchSize> hashBA{};
+    alignas(16) std::array<std::int32_t, kColumnBatchSize> hashBB{};
+    for (int lane = 0; lane < kColumnBatchSize; ++lane) {
+        const float floorX = std::floor(x[lane]);
+        const float floorZ = std::floor(z[lane]);
+        const int xi0 = static_cast<int>(floorX) & 255;
+        const int zi0 = static_cast<int>(floorZ) & 255;
+        const int xi1 = (xi0 + 1) & 255;
+        const int zi1 = (zi0 + 1) & 255;
+        xf[lane] = x[lane] - floorX;
+        zf[lane] = z[lane] - floorZ;
+        hashAA[lane] = permAt(static_cast<int>(permAt(xi0)) + zi0);
+        hashAB[lane] = permAt(static_cast<int>(permAt(xi0)) + zi1);
+        hashBA[lane] = permAt(static_cast<int>(permAt(xi1)) + zi0);
+        hashBB[lane] = permAt(static_cast<int>(permAt(xi1)) + zi1);
+    }
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (int lane = 0; lane < kColumnBatchSize; lane += 4) {
+        const __m128 fx = _mm_load_ps(&xf[lane]);
+        const __m128 fz = _mm_load_ps(&zf[lane]);
+        const __m128 fx1 = _mm_sub_ps(fx, one);
+        const __m128 fz1 = _mm_sub_ps(fz, one);
+        const __m128 u = fadeLanes(fx);
+        const __m128 v = fadeLanes(fz);
+        const auto loadHash = [lane](const std::array<std::int32_t, kColumnBatchSize>& hashes) {
+            return _mm_load_si128(reinterpret_cast<const __m128i*>(&hashes[lane]));
+        };
+        const __m128 x0 = lerpLanes(grad2Lanes(loadHash(hashAA), fx, fz), grad2Lanes(loadHash(hashBA), fx1, fz), u);
+        const __m128 x1 = lerpLanes(grad2Lanes(loadHash(hashAB), fx, fz1), grad2Lanes(loadHash(hashBB), fx1, fz1), u);
+        _mm_storeu_ps(out + lane, lerpLanes(x0, x1, v));
+    }
+#else
+    for (int lane = 0; lane < kColumnBatchSize; ++lane) {
+        out[lane] = perlin2(x[lane], z[lane]);
+    }
+#endif
+}
+
+// perlin2(x[i], z[i]) for `count` points, a batch at a time; a short tail is
+// padded with its last point.
+void perlin2Row(const float* x, const float* z, float* out, int count) {
+    for (int begin = 0; begin < count; begin += kColumnBatchSize) {
+        const int lanes = std::min(kColumnBatchSize, count - begin);
+        if (lanes == kColumnBatchSize) {
+            perlin2Batch(x + begin, z + begin, out + begin);
+            continue;
+        }
+        NoiseLanes paddedX{};
+        NoiseLanes paddedZ{};
+        NoiseLanes paddedOut{};
+        for (int lane = 0; lane < kColumnBatchSize; ++lane) {
+            const int source = begin + std::min(lane, lanes - 1);
+            paddedX[static_cast<std::size_t>(lane)] = x[source];
+            paddedZ[static_cast<std::size_t>(lane)] = z[source];
+        }
+        perlin2Batch(paddedX.data(), paddedZ.data(), paddedOut.data());
+        std::memcpy(out + begin, paddedOut.data(), static_cast<std::size_t>(lanes) * sizeof(float));
+    }
 }
 
-WarpedPoint warpTerrainDomain(float worldX, float worldZ) {
-    const float broadWarpX =
-        perlin2((worldX * 0.0065f) + 13.7f, (worldZ * 0.0065f) - 7.1f) * 22.0f;
-    const float broadWarpZ =
-        perlin2((worldX * 0.0065f) - 19.4f, (worldZ * 0.0065f) + 29.3f) * 22.0f;
-    const float foldedX = worldX + broadWarpX;
-    const float foldedZ = worldZ + broadWarpZ;
-    const float localWarpX =
-        perlin2((foldedX * 0.020f) + 101.0f, (foldedZ * 0.020f) - 61.0f) * 5.0f;
-    const float localWarpZ =
-        perlin2((foldedX * 0.020f) - 44.0f, (foldedZ * 0.020f) + 87.0f) * 5.0f;
-    return WarpedPoint{foldedX + localWarpX, foldedZ + localWarpZ};
+// warpTerrainDomain for a batch of columns: the broad fold, then a local
+// wobble sampled in the folded domain.
+void warpTerrainDomainBatch(const float* worldX, const float* worldZ, float* outX, float* outZ) {
+    NoiseLanes inputX{};
+    NoiseLanes inputZ{};
+    NoiseLanes broadWarpX{};
+    NoiseLanes broadWarpZ{};
+    for (int lane = 0; lane < kColumnBatchSize; ++lane) {
+        inputX[lane] = (worldX[lane] * 0.0065f) + 13.7f;
+        inputZ[lane] = (worldZ[lane] * 0.0065f) - 7.1f;
+    }
+    perlin2Batch(inputX.data(), inputZ.data(), broadWarpX.data());
+    for (int lane = 0; lane < kColumnBatchSize; ++lane) {
+        inputX[lane] = (worldX[lane] * 0.0065f) - 19.4f;
+        inputZ[lane] = (worldZ[lane] * 0.0065f) + 29.3f;
+    }
+    perlin2Batch(inputX.data(), inputZ.data(), broadWarpZ.data());
+
+    NoiseLanes foldedX{};
+    NoiseLanes foldedZ{};
+    for (int lane = 0; lane < kColumnBatchSize; ++lane) {
+        foldedX[lane] = worldX[lane] + (broadWarpX[lane] * 22.0f);
+        foldedZ[lane] = worldZ[lane] + (broadWarpZ[lane] * 22.0f);
+    }
+    NoiseLanes localWarpX{};
+    NoiseLanes localWarpZ{};
+    for (int lane = 0; lane < kColumnBatchSize; ++lane) {
+        inputX[lane] = (foldedX[lane] * 0.020f) + 101.0f;
+        inputZ[lane] = (foldedZ[lane] * 0.020f) - 61.0f;
+    }
+    perlin2Batch(inputX.data(), inputZ.data(), localWarpX.data());
+    for (int lane = 0; lane < kColumnBatchSize; ++lane) {
+        inputX[lane] = (foldedX[lane] * 0.020f) - 44.0f;
+        inputZ[lane] = (foldedZ[lane] * 0.020f) + 87.0f;
+    }
+    perlin2Batch(inputX.data(), inputZ.data(), localWarpZ.data());
+    for (int lane = 0; lane < kColumnBatchSize; ++lane) {
+        outX[lane] = foldedX[lane] + (localWarpX[lane] * 5.0f);
+        outZ[lane] = foldedZ[lane] + (localWarpZ[lane] * 5.0f);
+    }
 }
 
 // Thin alias so the many call sites below stay readable; the implementation is
@@ -221,11 +373,10 @@ BiomeType classifyBiome(float moisture, float temperature, float ruggedness) {
     return BiomeType::Plains;
 }
 
-std::vector<SettlementSite> settlementSitesNearWorld(int worldX, int worldZ) {
-    constexpr int kSettlementCellSize = 160;
+constexpr int kSettlementCellSize = 160;
+
+std::vector<SettlementSite> settlementSitesNearCell(int cellX, int cellZ) {
     std::vector<SettlementSite> sites;
-    const int cellX = floorDiv(worldX, kSettlementCellSize);
-    const int cellZ = floorDiv(worldZ, kSettlementCellSize);
     for (int offsetZ = -1; offsetZ <= 1; ++offsetZ) {
         for (int offsetX = -1; offsetX <= 1; ++offsetX) {
             const int sampleCellX = cellX + offsetX;
@@ -249,24 +400,58 @@ std::vector<SettlementSite> settlementSitesNearWorld(int worldX, int worldZ) {
     return sites;
 }
 
-ColumnSample sampleBaseColumnAtWorld(int worldX, int worldZ) {
-    const float wx = static_cast<float>(worldX);
-    const float wz = static_cast<float>(worldZ);
-    const WarpedPoint warped = warpTerrainDomain(wx, wz);
-    const float sampleX = warped.x;
-    const float sampleZ = warped.z;
-
-    const float macroShape = perlin2(sampleX * 0.0085f, sampleZ * 0.0085f);
-    const float rolling = perlin2(sampleX * 0.020f, sampleZ * 0.020f);
-    const float detail = perlin2(sampleX * 0.046f, sampleZ * 0.046f);
-    const float ridgePrimary = ridgedPerlin2((sampleX * 0.017f) - 24.0f, (sampleZ * 0.017f) + 18.0f);
-    const float ridgeSecondary = ridgedPerlin2((sampleX * 0.041f) + 9.0f, (sampleZ * 0.041f) - 35.0f);
-    const float ridge = std::pow(std::clamp((ridgePrimary * 0.78f) + (ridgeSecondary * 0.22f), 0.0f, 1.0f), 2.4f);
-    const float ruggednessField = (perlin2((sampleX * 0.011f) + 52.0f, (sampleZ * 0.011f) - 44.0f) * 0.5f) + 0.5f;
-    const float moisture = (perlin2((sampleX * 0.006f) + 91.0f, (sampleZ * 0.006f) - 37.0f) * 0.5f) + 0.5f;
-    const float temperature = (perlin2((sampleX * 0.005f) - 63.0f, (sampleZ * 0.005f) + 84.0f) * 0.5f) + 0.5f;
-    const float basinNoise = (perlin2((sampleX * 0.004f) + 141.0f, (sampleZ * 0.004f) + 26.0f) * 0.5f) + 0.5f;
-    const float basinDepth = std::pow(std::clamp((0.50f - basinNoise) / 0.50f, 0.0f, 1.0f), 1.7f) * 5.0f;
+// The sites near a column depend only on its settlement cell, so a run of
+// columns reuses one list instead of rebuilding it per column.
+class SettlementSiteCache {
+public:
+    std::span<const SettlementSite> sitesNearWorld(int worldX, int worldZ) {
+        const int cellX = floorDiv(worldX, kSettlementCellSize);
+        const int cellZ = floorDiv(worldZ, kSettlementCellSize);
+        if (!m_valid || cellX != m_cellX || cellZ != m_cellZ) {
+            m_sites = settlementSitesNearCell(cellX, cellZ);
+            m_cellX = cellX;
+            m_cellZ = cellZ;
+            m_valid = true;
+        }
+        return m_sites;
+    }
+
+private:
+    bool m_valid = false;
+    int m_cellX = 0;
+    int m_cellZ = 0;
+    std::vector<SettlementSite> m_sites;
+};
+
+// The noise fields a base column is shaped from, sampled in the warped domain.
+struct ColumnNoise {
+    float macroShape = 0.0f;
+    float rolling = 0.0f;
+    float detail = 0.0f;
+    float ridgePrimary = 0.0f;
+    float ridgeSecondary = 0.0f;
+    float ruggednessField = 0.0f;
+    float moisture = 0.0f;
+    float temperature = 0.0f;
+    float basinNoise = 0.0f;
+};
+
+// Everything about a base column after its noise: biome, height, settlements.
+ColumnSample finishBaseColumn(
+    int worldX,
+    int worldZ,
+    const ColumnNoise& noise,
+    std::span<const SettlementSite> settlements
+) {
+    const float macroShape = noise.macroShape;
+    const float rolling = noise.rolling;
+    const float detail = noise.detail;
+    const float ridge =
+        std::pow(std::clamp((noise.ridgePrimary * 0.78f) + (noise.ridgeSecondary * 0.22f), 0.0f, 1.0f), 2.4f);
+    const float ruggednessField = noise.ruggednessField;
+    const float moisture = noise.moisture;
+    const float temperature = noise.temperature;
+    const float basinDepth = std::pow(std::clamp((0.50f - noise.basinNoise) / 0.50f, 0.0f, 1.0f), 1.7f) * 5.0f;
 
     ColumnSample sample{};
     sample.moisture = moisture;
@@ -306,7 +491,7 @@ ColumnSample sampleBaseColumnAtWorld(int worldX, int worldZ) {
         biomeHeightBias -
         basinDepth;
 
-    for (const SettlementSite& settlement : settlementSitesNearWorld(worldX, worldZ)) {
+    for (const SettlementSite& settlement : settlements) {
         const float dx = static_cast<float>(worldX - settlement.x);
         const float dz = static_cast<float>(worldZ - settlement.z);
         const float distance = std::sqrt((dx * dx) + (dz * dz));
@@ -329,8 +514,105 @@ ColumnSample sampleBaseColumnAtWorld(int worldX, int worldZ) {
         }
     }
 
-    sample.terrainHeightF = std::clamp(terrainHeightF, 1.0f, static_cast<float>(Chunk::kSizeY - 6));
-    sample.terrainHeight = std::clamp(static_cast<int>(std::round(sample.terrainHeightF)), 1, Chunk::kSizeY - 6);
+    sample.terrainHeightF = std::clamp(terrainHeightF, 1.0f, static_cast<float>(kMaxTerrainHeight));
+    sample.terrainHeight = std::clamp(static_cast<int>(std::round(sample.terrainHeightF)), 1, kMaxTerrainHeight);
+    return sample;
+}
+
+// One noise field for a batch: input(lane, x, z) sets each lane's sample point.
+template <typename InputFn>
+void sampleNoiseField(InputFn&& input, float* out) {
+    NoiseLanes inputX{};
+    NoiseLanes inputZ{};
+    for (int lane = 0; lane < kColumnBatchSize; ++lane) {
+        input(lane, inputX[lane], inputZ[lane]);
+    }
+    perlin2Batch(inputX.data(), inputZ.data(), out);
+}
+
+// Base columns (worldMinX + i, worldZ) for i in [0, count), a batch at a time.
+void sampleBaseColumnRow(
+    int worldMinX,
+    int worldZ,
+    int count,
+    SettlementSiteCache& settlements,
+    ColumnSample* out
+) {
+    for (int begin = 0; begin < count; begin += kColumnBatchSize) {
+        const int lanes = std::min(kColumnBatchSize, count - begin);
+        NoiseLanes worldX{};
+        NoiseLanes worldZLanes{};
+        for (int lane = 0; lane < kColumnBatchSize; ++lane) {
+            // A short tail repeats its last column.
+            worldX[lane] = static_cast<float>(worldMinX + begin + std::min(lane, lanes - 1));
+            worldZLanes[lane] = static_cast<float>(worldZ);
+        }
+        NoiseLanes sampleX{};
+        NoiseLanes sampleZ{};
+        warpTerrainDomainBatch(worldX.data(), worldZLanes.data(), sampleX.data(), sampleZ.data());
+
+        std::array<NoiseLanes, 9> fields{};
+        sampleNoiseField([&](int lane, float& x, float& z) {
+            x = sampleX[lane] * 0.0085f;
+            z = sampleZ[lane] * 0.0085f;
+        }, fields[0].data());
+        sampleNoiseField([&](int lane, float& x, float& z) {
+            x = sampleX[lane] * 0.020f;
+            z = sampleZ[lane] * 0.020f;
+        }, fields[1].data());
+        sampleNoiseField([&](int lane, float& x, float& z) {
+            x = sampleX[lane] * 0.046f;
+            z = sampleZ[lane] * 0.046f;
+        }, fields[2].data());
+        sampleNoiseField([&](int lane, float& x, float& z) {
+            x = (sampleX[lane] * 0.017f) - 24.0f;
+            z = (sampleZ[lane] * 0.017f) + 18.0f;
+        }, fields[3].data());
+        sampleNoiseField([&](int lane, float& x, float& z) {
+            x = (sampleX[lane] * 0.041f) + 9.0f;
+            z = (sampleZ[lane] * 0.041f) - 35.0f;
+        }, fields[4].data());
+        sampleNoiseField([&](int lane, float& x, float& z) {
+            x = (sampleX[lane] * 0.011f) + 52.0f;
+            z = (sampleZ[lane] * 0.011f) - 44.0f;
+        }, fields[5].data());
+        sampleNoiseField([&](int lane, float& x, float& z) {
+            x = (sampleX[lane] * 0.006f) + 91.0f;
+            z = (sampleZ[lane] * 0.006f) - 37.0f;
+        }, fields[6].data());
+        sampleNoiseField([&](int lane, float& x, float& z) {
+            x = (sampleX[lane] * 0.005f) - 63.0f;
+            z = (sampleZ[lane] * 0.005f) + 84.0f;
+        }, fields[7].data());
+        sampleNoiseField([&](int lane, float& x, float& z) {
+            x = (sampleX[lane] * 0.004f) + 141.0f;
+            z = (sampleZ[lane] * 0.004f) + 26.0f;
+        }, fields[8].data());
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            const auto ridged = [](float value) { return 1.0f - std::abs(std::clamp(value, -1.0f, 1.0f)); };
+            const auto unit = [](float value) { return (value * 0.5f) + 0.5f; };
+            ColumnNoise noise{};
+            noise.macroShape = fields[0][lane];
+            noise.rolling = fields[1][lane];
+            noise.detail = fields[2][lane];
+            noise.ridgePrimary = ridged(fields[3][lane]);
+            noise.ridgeSecondary = ridged(fields[4][lane]);
+            noise.ruggednessField = unit(fields[5][lane]);
+            noise.moisture = unit(fields[6][lane]);
+            noise.temperature = unit(fields[7][lane]);
+            noise.basinNoise = unit(fields[8][lane]);
+            const int columnX = worldMinX + begin + lane;
+            out[begin + lane] =
+                finishBaseColumn(columnX, worldZ, noise, settlements.sitesNearWorld(columnX, worldZ));
+        }
+    }
+}
+
+ColumnSample sampleBaseColumnAtWorld(int worldX, int worldZ) {
+    SettlementSiteCache settlements;
+    ColumnSample sample{};
+    sampleBaseColumnRow(worldX, worldZ, 1, settlements, &sample);
     return sample;
 }
 
@@ -359,7 +641,7 @@ ColumnSample sampleTerrainAtWorld(const TerrainPatch& patch, int worldX, int wor
 
 void clampPatchHeights(TerrainPatch& patch) {
     for (ColumnSample& sample : patch.samples) {
-        sample.terrainHeightF = std::clamp(sample.terrainHeightF, 1.0f, static_cast<float>(Chunk::kSizeY - 6));
+        sample.terrainHeightF = std::clamp(sample.terrainHeightF, 1.0f, static_cast<float>(kMaxTerrainHeight));
     }
 }
 
@@ -379,86 +661,150 @@ void applyRidgeSharpening(TerrainPatch& patch) {
     clampPatchHeights(patch);
 }
 
-void runLightweightHydraulicErosion(TerrainPatch& patch) {
+// Runs fn(rowBegin, rowEnd) over the patch rows, split across `jobs` when given.
+// Row passes write only their own rows, so the split never changes results.
+template <typename Fn>
+void forEachPatchRowRange(const TerrainPatch& patch, core::JobSystem* jobs, Fn&& fn) {
+    constexpr std::size_t kRowGrain = 8;
+    const std::size_t rowCount = static_cast<std::size_t>(patch.depth);
+    if (jobs == nullptr) {
+        fn(0, patch.depth);
+        return;
+    }
+    core::parallelForRanges(*jobs, 0, rowCount, kRowGrain, [&](std::size_t, std::size_t rowBegin, std::size_t rowEnd) {
+        fn(static_cast<int>(rowBegin), static_cast<int>(rowEnd));
+    });
+}
+
+// perlin2((worldX * scale) + offsetX, (worldZ * scale) + offsetZ) for every
+// patch column, in patch index order.
+std::vector<float> samplePatchNoise(const TerrainPatch& patch, float scale, float offsetX, float offsetZ) {
+    std::vector<float> noise(patch.samples.size(), 0.0f);
+    std::vector<float> inputX(static_cast<std::size_t>(patch.width), 0.0f);
+    std::vector<float> inputZ(static_cast<std::size_t>(patch.width), 0.0f);
+    for (int localZ = 0; localZ < patch.depth; ++localZ) {
+        const float worldZ = static_cast<float>(patch.minWorldZ + localZ);
+        for (int localX = 0; localX < patch.width; ++localX) {
+            inputX[static_cast<std::size_t>(localX)] = (static_cast<float>(patch.minWorldX + localX) * scale) + offsetX;
+            inputZ[static_cast<std::size_t>(localX)] = (worldZ * scale) + offsetZ;
+        }
+        perlin2Row(
+            inputX.data(),
+            inputZ.data(),
+            noise.data() + static_cast<std::size_t>(patch.index(0, localZ)),
+            patch.width
+        );
+    }
+    return noise;
+}
+
+void runLightweightHydraulicErosion(TerrainPatch& patch, core::JobSystem* jobs) {
     const int cellCount = patch.width * patch.depth;
-    std::vector<float> water(static_cast<std::size_t>(cellCount), 0.0f);
-    std::vector<float> sediment(static_cast<std::size_t>(cellCount), 0.0f);
-    std::vector<float> nextWater(static_cast<std::size_t>(cellCount), 0.0f);
-    std::vector<float> nextSediment(static_cast<std::size_t>(cellCount), 0.0f);
+    const std::size_t cells = static_cast<std::size_t>(cellCount);
+    std::vector<float> water(cells, 0.0f);
+    std::vector<float> sediment(cells, 0.0f);
+    std::vector<float> nextWater(cells, 0.0f);
+    std::vector<float> nextSediment(cells, 0.0f);
+    // Per-cell outflow of the transport step: surface height, total drop to
+    // lower neighbors (0 when nothing flows out), and water/sediment moved.
+    std::vector<float> surface(cells, 0.0f);
+    std::vector<float> dropSum(cells, 0.0f);
+    std::vector<float> movedWater(cells, 0.0f);
+    std::vector<float> movedSediment(cells, 0.0f);
 
     constexpr std::array<int, 4> kOffsetX = {-1, 1, 0, 0};
     constexpr std::array<int, 4> kOffsetZ = {0, 0, -1, 1};
+    constexpr float kMoveFraction = 0.52f;
+
+    // Rain does not change between iterations; sample it once.
+    std::vector<float> rain = samplePatchNoise(patch, 0.071f, 11.0f, -29.0f);
+    for (float& rainNoise : rain) {
+        rainNoise = (rainNoise * 0.5f) + 0.5f;
+    }
 
     for (int iteration = 0; iteration < kHydraulicErosionIterations; ++iteration) {
-        for (int localZ = 0; localZ < patch.depth; ++localZ) {
-            for (int localX = 0; localX < patch.width; ++localX) {
-                const int worldX = patch.minWorldX + localX;
-                const int worldZ = patch.minWorldZ + localZ;
-                const int index = patch.index(localX, localZ);
-                const ColumnSample& sample = patch.sampleAtLocal(localX, localZ);
-                const float rainNoise =
-                    (perlin2((static_cast<float>(worldX) * 0.071f) + 11.0f,
-                             (static_cast<float>(worldZ) * 0.071f) - 29.0f) * 0.5f) + 0.5f;
-                const float settlementScale = 1.0f - (sample.settlementMask * 0.75f);
-                water[static_cast<std::size_t>(index)] += (0.018f + (rainNoise * 0.012f)) * settlementScale;
-            }
+        for (std::size_t index = 0; index < cells; ++index) {
+            const float settlementScale = 1.0f - (patch.samples[index].settlementMask * 0.75f);
+            water[index] += (0.018f + (rain[index] * 0.012f)) * settlementScale;
         }
 
-        std::fill(nextWater.begin(), nextWater.end(), 0.0f);
-        std::fill(nextSediment.begin(), nextSediment.end(), 0.0f);
-
-        for (int localZ = 0; localZ < patch.depth; ++localZ) {
-            for (int localX = 0; localX < patch.width; ++localX) {
-                const int index = patch.index(localX, localZ);
-                const std::size_t sampleIndex = static_cast<std::size_t>(index);
-                const float currentSurface = patch.sampleAtLocal(localX, localZ).terrainHeightF + water[sampleIndex];
-
-                std::array<int, 4> lowerIndices{};
-                std::array<float, 4> lowerWeights{};
-                int lowerCount = 0;
-                float weightSum = 0.0f;
-                for (std::size_t neighbor = 0; neighbor < kOffsetX.size(); ++neighbor) {
-                    const int nx = localX + kOffsetX[neighbor];
-                    const int nz = localZ + kOffsetZ[neighbor];
-                    if (nx < 0 || nx >= patch.width || nz < 0 || nz >= patch.depth) {
-                        continue;
-                    }
-                    const int neighborIndex = patch.index(nx, nz);
-                    const float neighborSurface =
-                        patch.sampleAtLocal(nx, nz).terrainHeightF + water[static_cast<std::size_t>(neighborIndex)];
-                    const float drop = currentSurface - neighborSurface;
-                    if (drop <= 0.001f) {
-                        continue;
+        // Transport, as a gather: every cell sums what flows into it from its
+        // north, west, own, east and south cells, in that order -- the raster
+        // order in which a serial scatter over sources would have added them,
+        // so the float sums are the same and rows can run in parallel.
+        for (std::size_t index = 0; index < cells; ++index) {
+            surface[index] = patch.samples[index].terrainHeightF + water[index];
+        }
+        forEachPatchRowRange(patch, jobs, [&](int rowBegin, int rowEnd) {
+            for (int localZ = rowBegin; localZ < rowEnd; ++localZ) {
+                for (int localX = 0; localX < patch.width; ++localX) {
+                    const std::size_t sampleIndex = static_cast<std::size_t>(patch.index(localX, localZ));
+                    int lowerCount = 0;
+                    float weightSum = 0.0f;
+                    for (std::size_t neighbor = 0; neighbor < kOffsetX.size(); ++neighbor) {
+                        const int nx = localX + kOffsetX[neighbor];
+                        const int nz = localZ + kOffsetZ[neighbor];
+                        if (nx < 0 || nx >= patch.width || nz < 0 || nz >= patch.depth) {
+                            continue;
+                        }
+                        const float drop = surface[sampleIndex] - surface[static_cast<std::size_t>(patch.index(nx, nz))];
+                        if (drop <= 0.001f) {
+                            continue;
+                        }
+                        weightSum += drop;
+                        ++lowerCount;
                     }
-                    lowerIndices[static_cast<std::size_t>(lowerCount)] = neighborIndex;
-                    lowerWeights[static_cast<std::size_t>(lowerCount)] = drop;
-                    weightSum += drop;
-                    ++lowerCount;
+                    const bool flows = lowerCount > 0 && weightSum > 0.001f;
+                    dropSum[sampleIndex] = flows ? weightSum : 0.0f;
+                    movedWater[sampleIndex] = flows ? water[sampleIndex] * kMoveFraction : 0.0f;
+                    movedSediment[sampleIndex] = flows ? sediment[sampleIndex] * kMoveFraction : 0.0f;
                 }
-
-                if (lowerCount == 0 || weightSum <= 0.001f) {
-                    nextWater[sampleIndex] += water[sampleIndex];
-                    nextSediment[sampleIndex] += sediment[sampleIndex];
-                    continue;
-                }
-
-                const float moveFraction = 0.52f;
-                const float movedWater = water[sampleIndex] * moveFraction;
-                const float movedSediment = sediment[sampleIndex] * moveFraction;
-                nextWater[sampleIndex] += water[sampleIndex] - movedWater;
-                nextSediment[sampleIndex] += sediment[sampleIndex] - movedSediment;
-                for (int lower = 0; lower < lowerCount; ++lower) {
-                    const float share = lowerWeights[static_cast<std::size_t>(lower)] / weightSum;
-                    const std::size_t lowerIndex = static_cast<std::size_t>(lowerIndices[static_cast<std::size_t>(lower)]);
-                    nextWater[lowerIndex] += movedWater * share;
-                    nextSediment[lowerIndex] += movedSediment * share;
+            }
+        });
+        forEachPatchRowRange(patch, jobs, [&](int rowBegin, int rowEnd) {
+            for (int localZ = rowBegin; localZ < rowEnd; ++localZ) {
+                for (int localX = 0; localX < patch.width; ++localX) {
+                    const std::size_t targetIndex = static_cast<std::size_t>(patch.index(localX, localZ));
+                    float inWater = 0.0f;
+                    float inSediment = 0.0f;
+                    const auto gatherFrom = [&](int sourceX, int sourceZ) {
+                        if (sourceX < 0 || sourceX >= patch.width || sourceZ < 0 || sourceZ >= patch.depth) {
+                            return;
+                        }
+                        const std::size_t sourceIndex = static_cast<std::size_t>(patch.index(sourceX, sourceZ));
+                        if (dropSum[sourceIndex] == 0.0f) {
+                            return;
+                        }
+                        const float drop = surface[sourceIndex] - surface[targetIndex];
+                        if (drop <= 0.001f) {
+                            return;
+                        }
+                        const float share = drop / dropSum[sourceIndex];
+                        inWater += movedWater[sourceIndex] * share;
+                        inSediment += movedSediment[sourceIndex] * share;
+                    };
+                    gatherFrom(localX, localZ - 1);
+                    gatherFrom(localX - 1, localZ);
+                    if (dropSum[targetIndex] == 0.0f) {
+                        inWater += water[targetIndex];
+                        inSediment += sediment[targetIndex];
+                    } else {
+                        inWater += water[targetIndex] - movedWater[targetIndex];
+                        inSediment += sediment[targetIndex] - movedSediment[targetIndex];
+                    }
+                    gatherFrom(localX + 1, localZ);
+                    gatherFrom(localX, localZ + 1);
+                    nextWater[targetIndex] = inWater;
+                    nextSediment[targetIndex] = inSediment;
                 }
             }
-        }
+        });
 
         water.swap(nextWater);
         sediment.swap(nextSediment);
 
+        // Deposition reads the heights it just updated to its west and north,
+        // so this pass stays serial.
         for (int localZ = 0; localZ < patch.depth; ++localZ) {
             for (int localX = 0; localX < patch.width; ++localX) {
                 const int index = patch.index(localX, localZ);
@@ -490,17 +836,14 @@ void generateFlowMapAndCarve(TerrainPatch& patch) {
     std::vector<int> downhill(static_cast<std::size_t>(cellCount), 0);
     std::vector<int> order(static_cast<std::size_t>(cellCount), 0);
     std::iota(order.begin(), order.end(), 0);
+    const std::vector<float> rainfallNoise = samplePatchNoise(patch, 0.015f, 73.0f, -41.0f);
 
     for (int localZ = 0; localZ < patch.depth; ++localZ) {
         for (int localX = 0; localX < patch.width; ++localX) {
             const int index = patch.index(localX, localZ);
             downhill[static_cast<std::size_t>(index)] = index;
-            const int worldX = patch.minWorldX + localX;
-            const int worldZ = patch.minWorldZ + localZ;
             const float rainfall =
-                0.75f +
-                (((perlin2((static_cast<float>(worldX) * 0.015f) + 73.0f,
-                           (static_cast<float>(worldZ) * 0.015f) - 41.0f) * 0.5f) + 0.5f) * 0.50f);
+                0.75f + (((rainfallNoise[static_cast<std::size_t>(index)] * 0.5f) + 0.5f) * 0.50f);
             flow[static_cast<std::size_t>(index)] = rainfall;
 
             float bestDrop = 0.0f;
@@ -573,10 +916,11 @@ void applySlopeBasedNoiseDetail(TerrainPatch& patch) {
         return originalHeights[static_cast<std::size_t>(patch.index(x, z))];
     };
 
+    const std::vector<float> coarseNoise = samplePatchNoise(patch, 0.170f, 19.0f, -43.0f);
+    const std::vector<float> fineNoise = samplePatchNoise(patch, 0.360f, -83.0f, 12.0f);
     for (int localZ = 0; localZ < patch.depth; ++localZ) {
         for (int localX = 0; localX < patch.width; ++localX) {
-            const int worldX = patch.minWorldX + localX;
-            const int worldZ = patch.minWorldZ + localZ;
+            const std::size_t index = static_cast<std::size_t>(patch.index(localX, localZ));
             ColumnSample& sample = patch.sampleAtLocal(localX, localZ);
             const float west = originalHeightAt(localX - 1, localZ);
             const float east = originalHeightAt(localX + 1, localZ);
@@ -587,13 +931,7 @@ void applySlopeBasedNoiseDetail(TerrainPatch& patch) {
             const float slope = std::sqrt((dx * dx) + (dz * dz));
             const float slopeMask = smoothstep(0.80f, 4.20f, slope);
             const float settlementScale = 1.0f - (sample.settlementMask * 0.85f);
-            const float coarseDetail =
-                perlin2((static_cast<float>(worldX) * 0.170f) + 19.0f,
-                        (static_cast<float>(worldZ) * 0.170f) - 43.0f);
-            const float fineDetail =
-                perlin2((static_cast<float>(worldX) * 0.360f) - 83.0f,
-                        (static_cast<float>(worldZ) * 0.360f) + 12.0f);
-            const float detail = (coarseDetail * 0.34f) + (fineDetail * 0.12f);
+            const float detail = (coarseNoise[index] * 0.34f) + (fineNoise[index] * 0.12f);
             sample.terrainHeightF += detail * slopeMask * settlementScale;
         }
     }
@@ -636,13 +974,15 @@ void finalizeTerrainPatch(TerrainPatch& patch) {
             sample.terrainHeight = std::clamp(
                 static_cast<int>(std::round(sample.terrainHeightF)),
                 1,
-                Chunk::kSizeY - 6
+                kMaxTerrainHeight
             );
         }
     }
 }
 
-TerrainPatch buildTerrainPatch(int worldMinX, int worldMinZ, int width, int depth) {
+// A patch of base columns covering [worldMinX, worldMinX + width) x
+// [worldMinZ, worldMinZ + depth) plus the erosion border.
+TerrainPatch sampleBaseTerrainPatch(int worldMinX, int worldMinZ, int width, int depth, core::JobSystem* jobs) {
     TerrainPatch patch{};
     patch.minWorldX = worldMinX - kTerrainPatchBorder;
     patch.minWorldZ = worldMinZ - kTerrainPatchBorder;
@@ -650,16 +990,65 @@ TerrainPatch buildTerrainPatch(int worldMinX, int worldMinZ, int width, int dept
     patch.depth = depth + (kTerrainPatchBorder * 2);
     patch.samples.resize(static_cast<std::size_t>(patch.width * patch.depth));
 
-    for (int localZ = 0; localZ < patch.depth; ++localZ) {
-        for (int localX = 0; localX < patch.width; ++localX) {
-            const int worldX = patch.minWorldX + localX;
-            const int worldZ = patch.minWorldZ + localZ;
-            patch.sampleAtLocal(localX, localZ) = sampleBaseColumnAtWorld(worldX, worldZ);
+    forEachPatchRowRange(patch, jobs, [&](int rowBegin, int rowEnd) {
+        SettlementSiteCache settlements;
+        for (int localZ = rowBegin; localZ < rowEnd; ++localZ) {
+            sampleBaseColumnRow(
+                patch.minWorldX,
+                patch.minWorldZ + localZ,
+                patch.width,
+                settlements,
+                &patch.sampleAtLocal(0, localZ)
+            );
         }
+    });
+    return patch;
+}
+
+// Copies the patch sampleBaseTerrainPatch would build out of a larger base
+// patch. A base column depends only on its own world position, so the copy is
+// exact. Returns false when `base` does not cover the patch.
+bool copyBaseTerrainPatch(
+    const TerrainPatch& base,
+    int worldMinX,
+    int worldMinZ,
+    int width,
+    int depth,
+    TerrainPatch& patch
+) {
+    patch.minWorldX = worldMinX - kTerrainPatchBorder;
+    patch.minWorldZ = worldMinZ - kTerrainPatchBorder;
+    patch.width = width + (kTerrainPatchBorder * 2);
+    patch.depth = depth + (kTerrainPatchBorder * 2);
+    if (!base.containsWorld(patch.minWorldX, patch.minWorldZ) ||
+        !base.containsWorld(patch.minWorldX + patch.width - 1, patch.minWorldZ + patch.depth - 1)) {
+        return false;
+    }
+    patch.samples.resize(static_cast<std::size_t>(patch.width * patch.depth));
+    for (int localZ = 0; localZ < patch.depth; ++localZ) {
+        const ColumnSample* row =
+            &base.sampleAtLocal(patch.minWorldX - base.minWorldX, patch.minWorldZ + localZ - base.minWorldZ);
+        std::copy_n(row, patch.width, &patch.sampleAtLocal(0, localZ));
+    }
+    return true;
+}
+
+// `base`, when given, supplies the base columns instead of sampling them.
+TerrainPatch buildTerrainPatch(
+    int worldMinX,
+    int worldMinZ,
+    int width,
+    int depth,
+    core::JobSystem* jobs,
+    const TerrainPatch* base
+) {
+    TerrainPatch patch{};
+    if (base == nullptr || !copyBaseTerrainPatch(*base, worldMinX, worldMinZ, width, depth, patch)) {
+        patch = sampleBaseTerrainPatch(worldMinX, worldMinZ, width, depth, jobs);
     }
 
     applyRidgeSharpening(patch);
-    runLightweightHydraulicErosion(patch);
+    runLightweightHydraulicErosion(patch, jobs);
     generateFlowMapAndCarve(patch);
     applySlopeBasedNoiseDetail(patch);
     applyCliffBias(patch);
@@ -699,6 +1088,20 @@ void refreshPatchVegetationSupport(TerrainPatch& patch) {
     }
 }
 
+// The finished terrain patch of a chunk column; `base` as in buildTerrainPatch.
+TerrainPatch buildChunkTerrainPatch(int chunkX, int chunkZ, core::JobSystem* jobs, const TerrainPatch* base) {
+    TerrainPatch patch = buildTerrainPatch(
+        chunkX * Chunk::kSizeX,
+        chunkZ * Chunk::kSizeZ,
+        Chunk::kSizeX,
+        Chunk::kSizeZ,
+        jobs,
+        base
+    );
+    refreshPatchVegetationSupport(patch);
+    return patch;
+}
+
 void stampTreeVariant(Chunk& chunk, int originX, int originY, int originZ, int variantIndex) {
     const int trunkHeight = 4 + (variantIndex % 3);
     const int canopyRadius = (variantIndex == 0) ? 2 : 1;
@@ -753,7 +1156,7 @@ void stampTreeVariant(Chunk& chunk, int originX, int originY, int originZ, int v
 
 bool shouldPlaceTreeAtWorld(const TerrainPatch& patch, int worldX, int worldZ) {
     const ColumnSample sample = sampleTerrainAtWorld(patch, worldX, worldZ);
-    if (!sample.supportsDenseVegetation || sample.terrainHeight >= Chunk::kSizeY - 8) {
+    if (!sample.supportsDenseVegetation || sample.terrainHeight >= kTreeTerrainHeightLimit) {
         return false;
     }
     const int spacing = (sample.biome == BiomeType::Forest) ? 5 : 7;
@@ -791,19 +1194,195 @@ bool shouldPlaceTreeAtWorld(const TerrainPatch& patch, int worldX, int worldZ) {
 
 } // namespace
 
-Chunk buildProceduralChunk(int chunkX, int chunkY, int chunkZ) {
+struct TerrainRegion {
+    static constexpr int kRegionChunks = TerrainPatchCache::kRegionChunks;
+
+    struct ColumnPatch {
+        std::once_flag built;
+        TerrainPatch patch;
+    };
+
+    int minChunkX = 0;
+    int minChunkZ = 0;
+    TerrainPatch base;
+    // Finished patches of the region's chunk columns, built from `base` by the
+    // first chunk of each column; the column's other layers read the same one.
+    mutable std::array<ColumnPatch, kRegionChunks * kRegionChunks> columns;
+
+    [[nodiscard]] const TerrainPatch& columnPatch(int chunkX, int chunkZ, core::JobSystem* jobs) const {
+        const std::size_t slot =
+            static_cast<std::size_t>((chunkX - minChunkX) + ((chunkZ - minChunkZ) * kRegionChunks));
+        ColumnPatch& column = columns[slot];
+        std::call_once(column.built, [&] { column.patch = buildChunkTerrainPatch(chunkX, chunkZ, jobs, &base); });
+        return column.patch;
+    }
+};
+
+TerrainPatchCache::TerrainPatchCache(std::size_t maxIdleRegions)
+    : m_maxIdleRegions(maxIdleRegions) {}
+
+std::shared_ptr<const TerrainRegion> TerrainPatchCache::acquire(int chunkX, int chunkZ, core::JobSystem* jobs) {
+    const core::Cell3i regionKey{floorDiv(chunkX, kRegionChunks), 0, floorDiv(chunkZ, kRegionChunks)};
+    std::promise<std::shared_ptr<const TerrainRegion>> promise;
+    std::shared_future<std::shared_ptr<const TerrainRegion>> region;
+    bool build = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto [entryIt, inserted] = m_entries.try_emplace(regionKey);
+        if (inserted) {
+            entryIt->second.region = promise.get_future().share();
+            ++m_stats.builtRegionCount;
+            build = true;
+        } else {
+            ++m_stats.reusedRegionCount;
+        }
+        entryIt->second.lastUse = ++m_useClock;
+        region = entryIt->second.region;
+    }
+
+    if (build) {
+        auto built = std::make_shared<TerrainRegion>();
+        built->minChunkX = regionKey.x * kRegionChunks;
+        built->minChunkZ = regionKey.z * kRegionChunks;
+        constexpr int kRegionVoxelsX = kRegionChunks * Chunk::kSizeX;
+        constexpr int kRegionVoxelsZ = kRegionChunks * Chunk::kSizeZ;
+        built->base = sampleBaseTerrainPatch(
+            regionKey.x * kRegionVoxelsX,
+            regionKey.z * kRegionVoxelsZ,
+            kRegionVoxelsX,
+            kRegionVoxelsZ,
+            jobs
+        );
+        promise.set_value(std::move(built));
+    }
+
+    std::shared_ptr<const TerrainRegion> view = region.get();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        evictIdleRegionsLocked();
+    }
+    return view;
+}
+
+TerrainPatchCache::Stats TerrainPatchCache::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.cachedRegionCount = m_entries.size();
+    return stats;
+}
+
+void TerrainPatchCache::evictIdleRegionsLocked() {
+    // Idle: built, and the entry's future holds the only reference. A caller
+    // still waiting on an evicted region's future keeps that region alive
+    // through its own copy of the future.
+    const auto isIdle = [](const Entry& entry) {
+        return entry.region.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+               entry.region.get().use_count() == 1;
+    };
+    std::vector<std::pair<std::uint64_t, core::Cell3i>> idle;
+    for (const auto& [key, entry] : m_entries) {
+        if (isIdle(entry)) {
+            idle.emplace_back(entry.lastUse, key);
+        }
+    }
+    if (idle.size() <= m_maxIdleRegions) {
+        return;
+    }
+    std::sort(idle.begin(), idle.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    const std::size_t evictCount = idle.size() - m_maxIdleRegions;
+    for (std::size_t index = 0; index < evictCount; ++index) {
+        m_entries.erase(idle[index].second);
+        ++m_stats.evictedRegionCount;
+    }
+}
+
+ProceduralChunkContent classifyProceduralChunk(int chunkY) {
+    if (chunkY < 0) {
+        return ProceduralChunkContent::Solid;
+    }
+    if (chunkY * Chunk::kSizeY > kMaxProceduralVoxelY) {
+        return ProceduralChunkContent::Air;
+    }
+    return ProceduralChunkContent::Terrain;
+}
+
+ProceduralChunkContent classifyProceduralChunk(int chunkY, int minSurfaceHeight, int maxSurfaceHeight) {
+    const ProceduralChunkContent layerContent = classifyProceduralChunk(chunkY);
+    if (layerContent != ProceduralChunkContent::Terrain) {
+        return layerContent;
+    }
+    const int worldMinY = chunkY * Chunk::kSizeY;
+    const int worldMaxY = worldMinY + Chunk::kSizeY - 1;
+    // Below every column's dirt band, and no tree grows down into it.
+    if (worldMaxY <= minSurfaceHeight - 4) {
+        return ProceduralChunkContent::Solid;
+    }
+    if (worldMinY > maxSurfaceHeight + kMaxTreeHeightAboveGround) {
+        return ProceduralChunkContent::Air;
+    }
+    return ProceduralChunkContent::Terrain;
+}
+
+Chunk buildProceduralChunk(
+    int chunkX,
+    int chunkY,
+    int chunkZ,
+    core::JobSystem* jobs,
+    TerrainPatchCache* terrainCache
+) {
     Chunk chunk(chunkX, chunkY, chunkZ);
-    if (chunkY != 0) {
+    switch (classifyProceduralChunk(chunkY)) {
+    case ProceduralChunkContent::Air:
+        return chunk;
+    case ProceduralChunkContent::Solid:
+        chunk.fill(Voxel{VoxelType::Stone});
         return chunk;
+    case ProceduralChunkContent::Terrain:
+        break;
     }
 
-    WorldGenerationStats stats{};
     const int worldMinX = chunkX * Chunk::kSizeX;
+    const int worldMinY = chunkY * Chunk::kSizeY;
     const int worldMinZ = chunkZ * Chunk::kSizeZ;
     const int worldMaxX = worldMinX + Chunk::kSizeX - 1;
+    const int worldMaxY = worldMinY + Chunk::kSizeY - 1;
     const int worldMaxZ = worldMinZ + Chunk::kSizeZ - 1;
-    TerrainPatch terrain = buildTerrainPatch(worldMinX, worldMinZ, Chunk::kSizeX, Chunk::kSizeZ);
-    refreshPatchVegetationSupport(terrain);
+    // `region` lends `terrain` out of the cache until the chunk is built.
+    const std::shared_ptr<const TerrainRegion> region =
+        terrainCache != nullptr ? terrainCache->acquire(chunkX, chunkZ, jobs) : nullptr;
+    TerrainPatch uncachedTerrain{};
+    if (region == nullptr) {
+        uncachedTerrain = buildChunkTerrainPatch(chunkX, chunkZ, jobs, nullptr);
+    }
+    const TerrainPatch& terrain =
+        region != nullptr ? region->columnPatch(chunkX, chunkZ, jobs) : uncachedTerrain;
+
+    // Every layer of a column shares this patch, so layers wholly under or
+    // above its surface skip the per-voxel pass.
+    int minSurfaceHeight = std::numeric_limits<int>::max();
+    int maxSurfaceHeight = std::numeric_limits<int>::min();
+    for (int worldZ = worldMinZ - kTreeCanopyReach; worldZ <= worldMaxZ + kTreeCanopyReach; ++worldZ) {
+        for (int worldX = worldMinX - kTreeCanopyReach; worldX <= worldMaxX + kTreeCanopyReach; ++worldX) {
+            const int surfaceHeight = sampleTerrainAtWorld(terrain, worldX, worldZ).terrainHeight;
+            minSurfaceHeight = std::min(minSurfaceHeight, surfaceHeight);
+            maxSurfaceHeight = std::max(maxSurfaceHeight, surfaceHeight);
+        }
+    }
+    switch (classifyProceduralChunk(chunkY, minSurfaceHeight, maxSurfaceHeight)) {
+    case ProceduralChunkContent::Air:
+        return chunk;
+    case ProceduralChunkContent::Solid:
+        chunk.fill(Voxel{VoxelType::Stone});
+        return chunk;
+    case ProceduralChunkContent::Terrain:
+        break;
+    }
+
+    // Generate densely as one batched edit (many per-voxel writes), then
+    // compact for residency.
+    chunk.expandToDense();
+    chunk.beginEdit();
+    WorldGenerationStats stats{};
 
     for (int localZ = 0; localZ < Chunk::kSizeZ; ++localZ) {
         for (int localX = 0; localX < Chunk::kSizeX; ++localX) {
@@ -827,7 +1406,9 @@ Chunk buildProceduralChunk(int chunkX, int chunkY, int chunkZ) {
                 ++stats.settlementColumnCount;
             }
 
-            for (int y = 0; y <= sample.terrainHeight; ++y) {
+            // Only the part of the column inside this chunk's layer.
+            const int columnTopY = std::min(sample.terrainHeight, worldMaxY);
+            for (int y = std::max(0, worldMinY); y <= columnTopY; ++y) {
                 VoxelType voxelType = VoxelType::Stone;
                 if (y <= sample.terrainHeight - 4) {
                     voxelType = VoxelType::Stone;
@@ -844,13 +1425,13 @@ Chunk buildProceduralChunk(int chunkX, int chunkY, int chunkZ) {
                 } else {
                     voxelType = VoxelType::Dirt;
                 }
-                chunk.setVoxel(localX, y, localZ, Voxel{voxelType});
+                chunk.setVoxel(localX, y - worldMinY, localZ, Voxel{voxelType});
             }
         }
     }
 
-    for (int worldZ = worldMinZ - 3; worldZ <= worldMaxZ + 3; ++worldZ) {
-        for (int worldX = worldMinX - 3; worldX <= worldMaxX + 3; ++worldX) {
+    for (int worldZ = worldMinZ - kTreeCanopyReach; worldZ <= worldMaxZ + kTreeCanopyReach; ++worldZ) {
+        for (int worldX = worldMinX - kTreeCanopyReach; worldX <= worldMaxX + kTreeCanopyReach; ++worldX) {
             const ColumnSample sample = sampleTerrainAtWorld(terrain, worldX, worldZ);
             if (!shouldPlaceTreeAtWorld(terrain, worldX, worldZ)) {
                 continue;
@@ -873,6 +1454,8 @@ Chunk buildProceduralChunk(int chunkX, int chunkY, int chunkZ) {
                       << ", denseVegetation=" << stats.denseVegetationColumnCount
                       << ", settlements=" << stats.settlementColumnCount
                       << ", trees=" << stats.treeCount;
+    chunk.endEdit();
+    chunk.compactStorage();
     return chunk;
 }
 
@@ -883,8 +1466,9 @@ void ChunkGrid::initializeFlatWorld() {
     }
 
     std::size_t treeChunkCount = 0;
+    TerrainPatchCache terrainCache;
     for (Chunk& chunk : m_chunks) {
-        chunk = buildProceduralChunk(chunk.chunkX(), chunk.chunkY(), chunk.chunkZ());
+        chunk = buildProceduralChunk(chunk.chunkX(), chunk.chunkY(), chunk.chunkZ(), nullptr, &terrainCache);
         if (chunk.chunkY() == 0) {
             ++treeChunkCount;
         }
@@ -10,20 +10,49 @@ namespace odai::world {
 
 namespace {
 
-const Chunk* findResidentChunk(const ChunkGrid& grid, ChunkMeshKey key) {
-    for (const Chunk& chunk : grid.chunks()) {
-        if (chunk.chunkX() == key.x && chunk.chunkY() == key.y && chunk.chunkZ() == key.z) {
-            return &chunk;
-        }
+float millisecondsBetween(ChunkMeshClock::time_point from, ChunkMeshClock::time_point to) {
+    return std::chrono::duration<float, std::milli>(to - from).count();
+}
+
+int floorDivInt(int value, int divisor) {
+    int quotient = value / divisor;
+    const int remainder = value % divisor;
+    if (remainder != 0 && ((remainder < 0) != (divisor < 0))) {
+        --quotient;
     }
-    return nullptr;
+    return quotient;
+}
+
+// Whether a chunk's bounding circle overlaps the horizontal view wedge.
+bool chunkInViewWedge(ChunkMeshKey key, const ChunkMeshKickParams& params) {
+    if (params.halfFovRadians <= 0.0f) {
+        return true;
+    }
+    const float forwardLength = std::hypot(params.forwardX, params.forwardZ);
+    if (forwardLength <= 0.0f) {
+        return true;
+    }
+    const float chunkCenterX = (static_cast<float>(key.x) + 0.5f) * static_cast<float>(Chunk::kSizeX);
+    const float chunkCenterZ = (static_cast<float>(key.z) + 0.5f) * static_cast<float>(Chunk::kSizeZ);
+    const float toChunkX = chunkCenterX - params.cameraX;
+    const float toChunkZ = chunkCenterZ - params.cameraZ;
+    const float distance = std::hypot(toChunkX, toChunkZ);
+    const float chunkRadius = 0.5f * std::hypot(static_cast<float>(Chunk::kSizeX), static_cast<float>(Chunk::kSizeZ));
+    if (distance <= chunkRadius) {
+        return true;
+    }
+    const float cosAngle = ((toChunkX * params.forwardX) + (toChunkZ * params.forwardZ)) / (distance * forwardLength);
+    const float angle = std::acos(std::clamp(cosAngle, -1.0f, 1.0f));
+    return angle <= params.halfFovRadians + std::asin(chunkRadius / distance);
 }
 
 } // namespace
 
-ChunkMeshScheduler::ChunkMeshScheduler(core::JobSystem& jobs, MeshingOptions options)
+ChunkMeshScheduler::ChunkMeshScheduler(core::JobSystem& jobs, MeshingOptions options, ChunkMeshSchedulerConfig config)
     : m_jobs(jobs),
-      m_options(options) {}
+      m_options(options),
+      m_config(config),
+      m_estimatedJobMs(config.initialJobCostMs) {}
 
 void ChunkMeshScheduler::setMeshingOptions(MeshingOptions options) {
     m_options = options;
@@ -37,73 +66,185 @@ void ChunkMeshScheduler::markDirty(ChunkMeshKey key) {
     Entry& entry = m_entries[key];
     ++entry.generation;
     entry.state = ChunkMeshState::Dirty;
+    entry.debounced = false;
 }
 
-std::size_t ChunkMeshScheduler::kickJobs(
-    const ChunkGrid& grid,
-    int cameraChunkX,
-    int cameraChunkZ,
-    std::size_t maxJobs
-) {
-    std::vector<ChunkMeshKey> dirtyKeys;
-    dirtyKeys.reserve(m_entries.size());
+void ChunkMeshScheduler::markEdited(ChunkMeshKey key, ChunkMeshClock::time_point editTime) {
+    Entry& entry = m_entries[key];
+    ++entry.generation;
+    if (entry.state == ChunkMeshState::Dirty) {
+        // Not kicked yet: this edit rides along with the pending mesh.
+        ++m_stats.editsCoalesced;
+    } else {
+        entry.state = ChunkMeshState::Dirty;
+        entry.debounced = true;
+        entry.firstPendingEdit = editTime;
+    }
+    entry.edited = true;
+    entry.lastEdit = editTime;
+}
+
+void ChunkMeshScheduler::markUrgent(ChunkMeshKey key) {
+    Entry& entry = m_entries[key];
+    ++entry.generation;
+    entry.state = ChunkMeshState::Dirty;
+    entry.urgent = true;
+}
+
+void ChunkMeshScheduler::markChunksArrived(const ChunkGrid& grid, std::span<const ChunkMeshKey> keys) {
+    const ChunkNeighborLookup lookup(grid.chunks());
+    for (const ChunkMeshKey& key : keys) {
+        markDirty(key);
+    }
+    for (const ChunkMeshKey& key : keys) {
+        for (std::uint32_t faceId = 0; faceId < kChunkFaceCount; ++faceId) {
+            const ChunkMeshKey neighborKey = chunkMeshNeighborKey(key, faceId);
+            if (lookup.find(neighborKey) == nullptr) {
+                continue;
+            }
+            const auto entryIt = m_entries.find(neighborKey);
+            if (entryIt != m_entries.end()) {
+                const Entry& entry = entryIt->second;
+                const std::uint8_t slabBit = static_cast<std::uint8_t>(1u << oppositeChunkFace(faceId));
+                // Dirty already re-snapshots on the next kick; a mesh that
+                // included this slab is still correct.
+                if (entry.state == ChunkMeshState::Dirty || (entry.neighborMask & slabBit) != 0u) {
+                    continue;
+                }
+            }
+            // Untracked neighbors were meshed outside the scheduler (e.g. a
+            // full renderer upload) before this chunk existed.
+            markDirty(neighborKey);
+        }
+    }
+}
+
+std::size_t ChunkMeshScheduler::kickJobs(const ChunkGrid& grid, const ChunkMeshKickParams& params) {
+    struct Candidate {
+        ChunkMeshKey key;
+        float score = 0.0f;
+    };
+    std::vector<Candidate> urgent;
+    std::vector<Candidate> background;
+    background.reserve(m_entries.size());
+    std::size_t inFlightBackground = 0;
+    const int cameraChunkX = floorDivInt(static_cast<int>(std::floor(params.cameraX)), Chunk::kSizeX);
+    const int cameraChunkZ = floorDivInt(static_cast<int>(std::floor(params.cameraZ)), Chunk::kSizeZ);
     for (const auto& [key, entry] : m_entries) {
-        if (entry.state == ChunkMeshState::Dirty) {
-            dirtyKeys.push_back(key);
+        if (entry.state == ChunkMeshState::Meshing) {
+            inFlightBackground += entry.urgent ? 0u : 1u;
+            continue;
+        }
+        if (entry.state != ChunkMeshState::Dirty) {
+            continue;
+        }
+        const float distance = static_cast<float>(std::max(std::abs(key.x - cameraChunkX), std::abs(key.z - cameraChunkZ)));
+        if (entry.urgent) {
+            urgent.push_back(Candidate{key, distance});
+            continue;
         }
+        if (entry.debounced &&
+            millisecondsBetween(entry.lastEdit, params.now) < m_config.debounceMs &&
+            millisecondsBetween(entry.firstPendingEdit, params.now) < m_config.maxDebounceMs) {
+            continue;
+        }
+        float score = distance;
+        if (!chunkInViewWedge(key, params)) {
+            score += m_config.offscreenPenaltyChunks;
+        }
+        if (entry.edited && m_config.recencyHorizonMs > 0.0f) {
+            const float age = millisecondsBetween(entry.lastEdit, params.now);
+            score -= m_config.recencyBonusChunks * std::clamp(1.0f - (age / m_config.recencyHorizonMs), 0.0f, 1.0f);
+        }
+        background.push_back(Candidate{key, score});
     }
-    if (dirtyKeys.empty()) {
+    if (urgent.empty() && background.empty()) {
         return 0;
     }
 
     // This sort is what makes meshing order independent of ChunkMeshKeyHash:
-    // the comparator below is a strict total order (distance, then x, then y,
+    // the comparator below is a strict total order (score, then x, then y,
     // then z) and map keys are unique, so no two elements ever compare
     // equivalent and std::sort's instability cannot leak the bucket order of
     // m_entries into the result. Keep it a total order if you touch it --
     // dropping a tiebreaker would make chunk streaming order depend on the
     // hash function.
-    std::sort(dirtyKeys.begin(), dirtyKeys.end(), [&](const ChunkMeshKey& a, const ChunkMeshKey& b) {
-        const auto chebyshevDistance = [&](const ChunkMeshKey& key) {
-            const int dx = std::abs(key.x - cameraChunkX);
-            const int dz = std::abs(key.z - cameraChunkZ);
-            return std::max(dx, dz);
-        };
-        const int distanceA = chebyshevDistance(a);
-        const int distanceB = chebyshevDistance(b);
-        if (distanceA != distanceB) {
-            return distanceA < distanceB;
-        }
-        if (a.x != b.x) {
-            return a.x < b.x;
-        }
-        if (a.y != b.y) {
-            return a.y < b.y;
-        }
-        return a.z < b.z;
-    });
-
-    std::size_t launchedJobCount = 0;
-    for (const ChunkMeshKey& key : dirtyKeys) {
-        if (launchedJobCount >= maxJobs) {
-            break;
+    const auto byScore = [](const Candidate& a, const Candidate& b) {
+        if (a.score != b.score) {
+            return a.score < b.score;
+        }
+        if (a.key.x != b.key.x) {
+            return a.key.x < b.key.x;
+        }
+        if (a.key.y != b.key.y) {
+            return a.key.y < b.key.y;
         }
-        const Chunk* residentChunk = findResidentChunk(grid, key);
+        return a.key.z < b.key.z;
+    };
+    std::sort(urgent.begin(), urgent.end(), byScore);
+    std::sort(background.begin(), background.end(), byScore);
+
+    const ChunkNeighborLookup lookup(grid.chunks());
+    const auto tryLaunch = [&](const Candidate& candidate, bool urgentLane) {
+        const Chunk* residentChunk = lookup.find(candidate.key);
         if (residentChunk == nullptr) {
             // Evicted while dirty: forget it rather than meshing a ghost. No
             // worker time was spent, so this is not charged as waste.
-            m_entries.erase(key);
+            m_entries.erase(candidate.key);
             ++m_stats.droppedDirtyBeforeKick;
-            continue;
+            return false;
         }
+        launchJob(lookup, *residentChunk, candidate.key, m_entries[candidate.key], urgentLane);
+        return true;
+    };
 
-        Entry& entry = m_entries[key];
-        entry.state = ChunkMeshState::Meshing;
-        const std::uint64_t generation = entry.generation;
-        const MeshingOptions options = m_options;
+    std::size_t launchedJobCount = 0;
+    std::size_t launchedUrgentCount = 0;
+    for (const Candidate& candidate : urgent) {
+        if (tryLaunch(candidate, true)) {
+            ++launchedUrgentCount;
+        }
+    }
+    launchedJobCount += launchedUrgentCount;
 
-        // Snapshot by copy: the grid chunk stays mutable on the main thread.
-        m_jobs.enqueue([this, key, generation, options, snapshot = *residentChunk]() {
+    // Background work yields to the urgent lane: its cost comes off the top.
+    const float jobMs = std::max(m_estimatedJobMs, 1.0e-3f);
+    float remainingMs = params.budgetMs - (static_cast<float>(launchedUrgentCount + inFlightBackground) * jobMs);
+    bool mayLaunch = params.budgetMs > 0.0f && inFlightBackground == 0u && launchedUrgentCount == 0u;
+    for (const Candidate& candidate : background) {
+        if (remainingMs < jobMs && !mayLaunch) {
+            break;
+        }
+        if (tryLaunch(candidate, false)) {
+            ++launchedJobCount;
+            remainingMs -= jobMs;
+            mayLaunch = false;
+        }
+    }
+    m_stats.jobsLaunched += launchedJobCount;
+    m_stats.urgentJobsLaunched += launchedUrgentCount;
+    return launchedJobCount;
+}
+
+void ChunkMeshScheduler::launchJob(
+    const ChunkNeighborLookup& lookup,
+    const Chunk& chunk,
+    ChunkMeshKey key,
+    Entry& entry,
+    bool urgent
+) {
+    // Slabs are copied here too: neighbors are just as mutable as the
+    // chunk itself.
+    const ChunkBorderSlabs borders = lookup.neighborhood(chunk).borders;
+    entry.state = ChunkMeshState::Meshing;
+    entry.neighborMask = borders.presentMask;
+    entry.debounced = false;
+    const std::uint64_t generation = entry.generation;
+    const MeshingOptions options = m_options;
+
+    // Snapshot by copy: the grid chunk stays mutable on the main thread.
+    m_jobs.enqueue(
+        [this, key, generation, options, snapshot = chunk, borders]() {
             ChunkMeshResult result;
             result.key = key;
             result.generation = generation;
@@ -111,36 +252,46 @@ std::size_t ChunkMeshScheduler::kickJobs(
             // charge it to accepted or wasted without touching shared state
             // here (m_stats stays main-thread only).
             core::Stopwatch buildWatch;
-            result.meshes = buildChunkLodMeshes(snapshot, options, &result.stats);
+            result.meshes = m_bufferPool.acquire();
+            const std::size_t pooledBytes = chunkMeshCapacityBytes(result.meshes);
+            buildChunkLodMeshesInto(ChunkNeighborhood{&snapshot, borders}, options, &result.stats, result.meshes);
+            m_bufferPool.recordBuild(pooledBytes, result.meshes);
             result.buildMs = buildWatch.elapsedMs();
             {
                 std::lock_guard<std::mutex> lock(m_readyMutex);
                 m_readyQueue.push_back(std::move(result));
             }
-        });
-        ++launchedJobCount;
-    }
-    m_stats.jobsLaunched += launchedJobCount;
-    return launchedJobCount;
+        },
+        urgent ? core::JobPriority::High : core::JobPriority::Normal,
+        urgent ? &m_urgentJobs : nullptr
+    );
 }
 
 std::vector<ChunkMeshResult> ChunkMeshScheduler::drainReady(const ChunkGrid& grid) {
+    // The calling thread helps, so this costs about one chunk mesh even when
+    // every worker is busy with background work.
+    m_jobs.wait(m_urgentJobs);
     std::vector<ChunkMeshResult> completed;
     {
         std::lock_guard<std::mutex> lock(m_readyMutex);
         completed.swap(m_readyQueue);
     }
     if (completed.empty()) {
+        syncBufferPoolStats();
         return completed;
     }
 
+    const ChunkNeighborLookup lookup(grid.chunks());
     std::vector<ChunkMeshResult> current;
     current.reserve(completed.size());
     for (ChunkMeshResult& result : completed) {
+        // Every finished job, kept or not, is a sample of what a mesh costs.
+        m_estimatedJobMs += (result.buildMs - m_estimatedJobMs) * 0.2f;
         const auto entryIt = m_entries.find(result.key);
         if (entryIt == m_entries.end()) {
             ++m_stats.discardedUntracked;
             m_stats.meshMsWasted += result.buildMs;
+            m_bufferPool.release(std::move(result.meshes));
             continue;
         }
         if (entryIt->second.generation != result.generation) {
@@ -149,22 +300,47 @@ std::vector<ChunkMeshResult> ChunkMeshScheduler::drainReady(const ChunkGrid& gri
             // The work just done is thrown away -- charge it as waste.
             ++m_stats.discardedStale;
             m_stats.meshMsWasted += result.buildMs;
+            m_bufferPool.release(std::move(result.meshes));
             continue;
         }
-        if (findResidentChunk(grid, result.key) == nullptr) {
+        if (lookup.find(result.key) == nullptr) {
             m_entries.erase(entryIt);
             ++m_stats.discardedEvicted;
             m_stats.meshMsWasted += result.buildMs;
+            m_bufferPool.release(std::move(result.meshes));
             continue;
         }
         entryIt->second.state = ChunkMeshState::Clean;
+        entryIt->second.urgent = false;
         ++m_stats.resultsAccepted;
         m_stats.meshMsAccepted += result.buildMs;
         current.push_back(std::move(result));
     }
+    syncBufferPoolStats();
     return current;
 }
 
+void ChunkMeshScheduler::releaseMeshes(ChunkLodMeshes&& meshes) {
+    m_bufferPool.release(std::move(meshes));
+}
+
+void ChunkMeshScheduler::resetStats() {
+    m_stats = ChunkMeshSchedulerStats{};
+    m_bufferPool.resetPeak();
+    m_poolAllocationsSeen = m_bufferPool.stats().allocations;
+    syncBufferPoolStats();
+}
+
+void ChunkMeshScheduler::syncBufferPoolStats() {
+    // The pool counts on workers under its own lock; fold its totals in here
+    // so m_stats stays main-thread only.
+    const ChunkMeshBufferPoolStats pool = m_bufferPool.stats();
+    m_stats.meshBufferAllocations += pool.allocations - m_poolAllocationsSeen;
+    m_poolAllocationsSeen = pool.allocations;
+    m_stats.meshBufferBytes = pool.liveBytes;
+    m_stats.peakMeshBufferBytes = std::max(m_stats.peakMeshBufferBytes, pool.peakBytes);
+}
+
 std::size_t ChunkMeshScheduler::dirtyCount() const {
     std::size_t count = 0;
     for (const auto& [key, entry] : m_entries) {
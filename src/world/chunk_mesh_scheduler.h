@@ -4,9 +4,11 @@
 #include "world/chunk_grid.h"
 #include "world/chunk_mesher.h"
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <mutex>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -23,6 +25,24 @@
 // on a Meshing chunk bumps the generation, and drainReady() discards results
 // whose generation no longer matches (the chunk stays Dirty and is re-kicked).
 //
+// Meshes are neighbor-aware: the snapshot carries the one-voxel border slabs
+// of every resident face neighbor (world::ChunkNeighborhood), and each entry
+// remembers which slabs its mesh was built with. When chunks stream in,
+// markChunksArrived() re-dirties only the neighbors that meshed without them.
+//
+// Dirty chunks reach a worker through one of three doors:
+//   markDirty()   background work (streaming, option changes): kicked as soon
+//                 as the frame budget allows.
+//   markEdited()  world edits: debounced, so a chunk edited every frame is
+//                 meshed once the edits settle instead of once per edit (each
+//                 of those meshes would be discarded as stale anyway).
+//   markUrgent()  the chunk the player is editing: kicked first, at High job
+//                 priority, outside the budget, and drainReady() waits for it,
+//                 so the edit is visible the same frame.
+// Background and edited chunks are ordered by a score that combines camera
+// distance, whether the chunk is in the view wedge and how recently it was
+// edited, and launched until the frame's worker-millisecond budget is spent.
+//
 // Pure CPU, no Vulkan. Main-thread only, except the worker-side ready queue.
 namespace odai::world {
 
@@ -54,9 +74,23 @@ struct ChunkMeshSchedulerStats {
     // cost no worker time. Tracked separately for exactly that reason.
     std::uint64_t droppedDirtyBeforeKick = 0;
 
+    // Urgent-lane launches (also counted in jobsLaunched).
+    std::uint64_t urgentJobsLaunched = 0;
+    // markEdited() calls that landed on a chunk still waiting to be kicked and
+    // so cost no extra mesh.
+    std::uint64_t editsCoalesced = 0;
+
     float meshMsAccepted = 0.0f;
     float meshMsWasted = 0.0f;
 
+    // Mesh output buffers (see ChunkMeshBufferPool): heap allocations made
+    // while building meshes, and the capacity held by pooled buffers -- in
+    // flight, handed to the consumer, or free -- now and at its peak. Once
+    // consumers release their meshes, allocations stop growing.
+    std::uint64_t meshBufferAllocations = 0;
+    std::size_t meshBufferBytes = 0;
+    std::size_t peakMeshBufferBytes = 0;
+
     [[nodiscard]] std::uint64_t discardedTotal() const {
         return discardedStale + discardedEvicted + discardedUntracked;
     }
@@ -68,9 +102,47 @@ struct ChunkMeshSchedulerStats {
     }
 };
 
+using ChunkMeshClock = std::chrono::steady_clock;
+
+// Tuning for the edit debounce and the kick priority score. Distances are in
+// chunks: the score is Chebyshev distance, plus offscreenPenaltyChunks outside
+// the view wedge, minus up to recencyBonusChunks for a fresh edit (fading to
+// nothing over recencyHorizonMs). Lower scores are kicked first.
+struct ChunkMeshSchedulerConfig {
+    // An edited chunk waits until it has gone this long without another edit...
+    float debounceMs = 50.0f;
+    // ...or until its first unmeshed edit is this old, so a chunk edited
+    // continuously still remeshes a few times a second.
+    float maxDebounceMs = 250.0f;
+    float offscreenPenaltyChunks = 4.0f;
+    float recencyBonusChunks = 2.0f;
+    float recencyHorizonMs = 2000.0f;
+    // Cost assumed per job until measured results come back.
+    float initialJobCostMs = 1.0f;
+};
+
+// Per-frame inputs to kickJobs().
+struct ChunkMeshKickParams {
+    // Camera position in world voxels.
+    float cameraX = 0.0f;
+    float cameraZ = 0.0f;
+    // Horizontal view direction (any length) and half the horizontal field of
+    // view. halfFovRadians <= 0 counts every chunk as in view.
+    float forwardX = 0.0f;
+    float forwardZ = 1.0f;
+    float halfFovRadians = 0.0f;
+    // Worker milliseconds of background meshing that may be outstanding once
+    // this kick returns. Jobs still in flight from earlier frames count, so
+    // slow workers throttle new launches instead of growing a queue. At least
+    // one job launches when nothing is in flight. Urgent jobs ignore the
+    // budget but their cost is taken out of it.
+    float budgetMs = 4.0f;
+    ChunkMeshClock::time_point now{};
+};
+
 class ChunkMeshScheduler {
 public:
-    ChunkMeshScheduler(core::JobSystem& jobs, MeshingOptions options);
+    ChunkMeshScheduler(core::JobSystem& jobs, MeshingOptions options, ChunkMeshSchedulerConfig config = {});
 
     // Dirties every tracked chunk and bumps all generations so in-flight
     // results built with the old options are discarded on drain.
@@ -78,40 +150,76 @@ public:
     [[nodiscard]] MeshingOptions meshingOptions() const { return m_options; }
 
     void markDirty(ChunkMeshKey key);
-
-    // Snapshots up to maxJobs Dirty chunks (nearest to the camera first, same
-    // Chebyshev ordering the renderer's remesh queue used) and enqueues mesh
-    // jobs for them. Dirty chunks not resident in `grid` are dropped.
-    // Returns the number of jobs launched. Main thread only.
-    std::size_t kickJobs(
-        const ChunkGrid& grid,
-        int cameraChunkX,
-        int cameraChunkZ,
-        std::size_t maxJobs
-    );
-
-    // Moves out completed results that are still current: stale generations
-    // are discarded (their chunk stays Dirty for the next kick) and results
-    // for chunks no longer resident in `grid` are dropped. Main thread only.
+    // A world edit at `editTime`; see the class comment for the debounce.
+    void markEdited(ChunkMeshKey key, ChunkMeshClock::time_point editTime);
+    // The chunk the player is editing right now (and seam neighbors the edit
+    // touches): meshed ahead of everything else and drained the same frame.
+    void markUrgent(ChunkMeshKey key);
+
+    // Chunks that just became resident in `grid`: dirties each of them, plus
+    // every resident face neighbor whose current (or in-flight) mesh was built
+    // without that chunk's slab -- its seam faces against the new chunk are
+    // still emitted and its seam AO still sees air. Neighbors that already
+    // meshed against the chunk, and chunks further away, are left alone.
+    void markChunksArrived(const ChunkGrid& grid, std::span<const ChunkMeshKey> keys);
+
+    // Snapshots every urgent chunk, then settled Dirty chunks in score order
+    // until params.budgetMs is spent, together with the border slabs of their
+    // resident face neighbors, and enqueues mesh jobs for them. Dirty chunks
+    // not resident in `grid` are dropped. Returns the number of jobs
+    // launched. Main thread only.
+    std::size_t kickJobs(const ChunkGrid& grid, const ChunkMeshKickParams& params);
+
+    // Waits for urgent jobs from the last kick (helping run them), then moves
+    // out completed results that are still current: stale generations are
+    // discarded (their chunk stays Dirty for the next kick) and results for
+    // chunks no longer resident in `grid` are dropped. Result meshes live in
+    // pooled buffers; give them back with releaseMeshes() when done with them.
+    // Main thread only.
     std::vector<ChunkMeshResult> drainReady(const ChunkGrid& grid);
 
     [[nodiscard]] std::size_t dirtyCount() const;
     [[nodiscard]] std::size_t meshingCount() const;
+    // Running average of measured job time; what the budget is spent in.
+    [[nodiscard]] float estimatedJobMs() const { return m_estimatedJobMs; }
+
+    // Hands a drained result's meshes back once they are uploaded (or no
+    // longer needed), so the next job builds into them. Any thread.
+    void releaseMeshes(ChunkLodMeshes&& meshes);
+    [[nodiscard]] ChunkMeshBufferPool& bufferPool() { return m_bufferPool; }
 
     // Main thread only, like the rest of the class: every counter is updated in
     // kickJobs()/drainReady(), never on a worker.
     [[nodiscard]] const ChunkMeshSchedulerStats& stats() const { return m_stats; }
-    void resetStats() { m_stats = ChunkMeshSchedulerStats{}; }
+    void resetStats();
 
 private:
     struct Entry {
         ChunkMeshState state = ChunkMeshState::Clean;
         std::uint64_t generation = 0;
+        // ChunkBorderSlabs::presentMask of the last kicked snapshot.
+        std::uint8_t neighborMask = 0;
+        bool urgent = false;
+        // Dirty only through markEdited() so far: held back by the debounce.
+        bool debounced = false;
+        bool edited = false;
+        ChunkMeshClock::time_point firstPendingEdit{};
+        ChunkMeshClock::time_point lastEdit{};
     };
 
+    void launchJob(const ChunkNeighborLookup& lookup, const Chunk& chunk, ChunkMeshKey key, Entry& entry, bool urgent);
+    void syncBufferPoolStats();
+
     core::JobSystem& m_jobs;
     MeshingOptions m_options;
+    ChunkMeshSchedulerConfig m_config;
+    float m_estimatedJobMs = 0.0f;
+    // Urgent jobs signal this; drainReady() waits on it.
+    core::JobCounter m_urgentJobs;
     ChunkMeshSchedulerStats m_stats{};
+    // Shared with workers (internally locked); results are built into its sets.
+    ChunkMeshBufferPool m_bufferPool;
+    std::uint64_t m_poolAllocationsSeen = 0;
     // Main-thread only.
     std::unordered_map<ChunkMeshKey, Entry, ChunkMeshKeyHash> m_entries;
     // Worker -> main-thread handoff.
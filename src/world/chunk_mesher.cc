@@ -5,7 +5,22 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// SIMD paths are picked at compile time: AVX2 when the build enables it
+// (ODAI_ENABLE_NATIVE_ARCH), otherwise SSE2, which every x86-64 target has.
+// Other architectures use the scalar path; all three produce identical masks.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ODAI_MESHER_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ODAI_MESHER_SSE2 1
+#endif
 
 namespace odai::world {
 
@@ -69,8 +84,34 @@ std::uint8_t materialForVoxel(const Voxel& voxel) {
     return materialForVoxelType(voxel.type);
 }
 
-bool isSolidVoxel(const Chunk& chunk, int x, int y, int z) {
-    return chunk.voxelAt(x, y, z).type != VoxelType::Empty;
+// The center chunk in bounds, a neighbor slab one voxel outside it on exactly
+// one axis, air anywhere else (diagonal neighbors are not captured).
+bool isSolidVoxel(const ChunkNeighborhood& neighborhood, int x, int y, int z) {
+    const bool inX = x >= 0 && x < Chunk::kSizeX;
+    const bool inY = y >= 0 && y < Chunk::kSizeY;
+    const bool inZ = z >= 0 && z < Chunk::kSizeZ;
+    if (inX && inY && inZ) {
+        return neighborhood.center->voxelAt(x, y, z).type != VoxelType::Empty;
+    }
+    std::uint32_t faceId = 0;
+    int row = 0;
+    int bit = 0;
+    if (inY && inZ && (x == -1 || x == Chunk::kSizeX)) {
+        faceId = x < 0 ? 1u : 0u;
+        row = z;
+        bit = y;
+    } else if (inX && inZ && (y == -1 || y == Chunk::kSizeY)) {
+        faceId = y < 0 ? 3u : 2u;
+        row = z;
+        bit = x;
+    } else if (inX && inY && (z == -1 || z == Chunk::kSizeZ)) {
+        faceId = z < 0 ? 5u : 4u;
+        row = y;
+        bit = x;
+    } else {
+        return false;
+    }
+    return ((neighborhood.borders.rows[faceId][static_cast<std::size_t>(row)] >> static_cast<std::uint32_t>(bit)) & 1u) != 0u;
 }
 
 struct CornerAxes {
@@ -115,15 +156,30 @@ void faceAoAxes(std::uint32_t faceId, int& ux, int& uy, int& uz, int& vx, int& v
     }
 }
 
-bool isSolidVoxelExpanded(const Chunk& chunk, int x, int y, int z) {
-    if (x < -1 || x > Chunk::kSizeX || y < -1 || y > Chunk::kSizeY || z < -1 || z > Chunk::kSizeZ) {
-        return false;
+std::uint32_t aoLevelFromNeighbors(
+    bool sideA,
+    bool sideB,
+    bool cornerSolid,
+    bool edgeAExtended,
+    bool edgeBExtended
+) {
+    float occlusion = 0.0f;
+    if (sideA && sideB) {
+        occlusion = 1.0f;
+    } else {
+        occlusion += sideA ? 0.36f : 0.0f;
+        occlusion += sideB ? 0.36f : 0.0f;
+        occlusion += cornerSolid ? 0.20f : 0.0f;
+        occlusion += edgeAExtended ? 0.04f : 0.0f;
+        occlusion += edgeBExtended ? 0.04f : 0.0f;
     }
-    return isSolidVoxel(chunk, x, y, z);
+
+    const float visibility = 1.0f - std::min(occlusion, 1.0f);
+    return static_cast<std::uint32_t>((visibility * 15.0f) + 0.5f);
 }
 
 std::uint32_t cornerAoLevel(
-    const Chunk& chunk,
+    const ChunkNeighborhood& neighborhood,
     int x,
     int y,
     int z,
@@ -152,44 +208,38 @@ std::uint32_t cornerAoLevel(
     const int baseY = y + face.ny;
     const int baseZ = z + face.nz;
 
-    const bool sideA = isSolidVoxelExpanded(chunk, baseX + (ux * uSign), baseY + (uy * uSign), baseZ + (uz * uSign));
-    const bool sideB = isSolidVoxelExpanded(chunk, baseX + (vx * vSign), baseY + (vy * vSign), baseZ + (vz * vSign));
-    const bool cornerSolid = isSolidVoxelExpanded(
-        chunk,
+    const bool sideA = isSolidVoxel(neighborhood, baseX + (ux * uSign), baseY + (uy * uSign), baseZ + (uz * uSign));
+    const bool sideB = isSolidVoxel(neighborhood, baseX + (vx * vSign), baseY + (vy * vSign), baseZ + (vz * vSign));
+    const bool cornerSolid = isSolidVoxel(
+        neighborhood,
         baseX + (ux * uSign) + (vx * vSign),
         baseY + (uy * uSign) + (vy * vSign),
         baseZ + (uz * uSign) + (vz * vSign)
     );
-    const bool edgeAExtended = isSolidVoxelExpanded(
-        chunk,
+    const bool edgeAExtended = isSolidVoxel(
+        neighborhood,
         baseX + (ux * uSign * 2),
         baseY + (uy * uSign * 2),
         baseZ + (uz * uSign * 2)
     );
-    const bool edgeBExtended = isSolidVoxelExpanded(
-        chunk,
+    const bool edgeBExtended = isSolidVoxel(
+        neighborhood,
         baseX + (vx * vSign * 2),
         baseY + (vy * vSign * 2),
         baseZ + (vz * vSign * 2)
     );
+    return aoLevelFromNeighbors(sideA, sideB, cornerSolid, edgeAExtended, edgeBExtended);
+}
 
-    float occlusion = 0.0f;
-    if (sideA && sideB) {
-        occlusion = 1.0f;
-    } else {
-        occlusion += sideA ? 0.36f : 0.0f;
-        occlusion += sideB ? 0.36f : 0.0f;
-        occlusion += cornerSolid ? 0.20f : 0.0f;
-        occlusion += edgeAExtended ? 0.04f : 0.0f;
-        occlusion += edgeBExtended ? 0.04f : 0.0f;
+void clearChunkLodMeshes(ChunkLodMeshes& meshes) {
+    for (ChunkMeshData& mesh : meshes.lodMeshes) {
+        mesh.vertices.clear();
+        mesh.indices.clear();
     }
-
-    const float visibility = 1.0f - std::min(occlusion, 1.0f);
-    return static_cast<std::uint32_t>((visibility * 15.0f) + 0.5f);
 }
 
 void appendVoxelFace(
-    const Chunk& chunk,
+    const ChunkNeighborhood& neighborhood,
     ChunkMeshData& mesh,
     int x,
     int y,
@@ -199,9 +249,8 @@ void appendVoxelFace(
     std::uint32_t baseColorIndex,
     std::uint32_t lodLevel
 ) {
-    const std::uint32_t baseVertex = static_cast<std::uint32_t>(mesh.vertices.size());
     for (std::uint32_t corner = 0; corner < 4; ++corner) {
-        const std::uint32_t ao = cornerAoLevel(chunk, x, y, z, faceId, corner);
+        const std::uint32_t ao = cornerAoLevel(neighborhood, x, y, z, faceId, corner);
         PackedVoxelVertex vertex{};
         vertex.bits = PackedVoxelVertex::pack(
             static_cast<std::uint32_t>(x),
@@ -216,13 +265,6 @@ void appendVoxelFace(
         );
         mesh.vertices.push_back(vertex);
     }
-
-    mesh.indices.push_back(baseVertex + 0);
-    mesh.indices.push_back(baseVertex + 1);
-    mesh.indices.push_back(baseVertex + 2);
-    mesh.indices.push_back(baseVertex + 0);
-    mesh.indices.push_back(baseVertex + 2);
-    mesh.indices.push_back(baseVertex + 3);
 }
 
 constexpr std::uint32_t kEmptyMaskKey = 0xFFFFFFFFu;
@@ -323,7 +365,7 @@ void faceRectCornerGrid(
 }
 
 std::uint16_t faceCornerAoSignature(
-    const Chunk& chunk,
+    const ChunkNeighborhood& neighborhood,
     int x,
     int y,
     int z,
@@ -331,7 +373,7 @@ std::uint16_t faceCornerAoSignature(
 ) {
     std::uint16_t signature = 0;
     for (std::uint32_t corner = 0; corner < 4u; ++corner) {
-        const std::uint32_t ao = cornerAoLevel(chunk, x, y, z, faceId, corner) & PackedVoxelVertex::kMask4;
+        const std::uint32_t ao = cornerAoLevel(neighborhood, x, y, z, faceId, corner) & PackedVoxelVertex::kMask4;
         signature |= static_cast<std::uint16_t>(ao << (corner * 4u));
     }
     return signature;
@@ -362,7 +404,7 @@ bool appendGreedyFaceQuad(
     std::uint32_t baseColorIndex,
     std::uint32_t lodLevel
 ) {
-    const std::uint32_t baseVertex = static_cast<std::uint32_t>(mesh.vertices.size());
+    std::array<PackedVoxelVertex, 4> corners{};
     for (std::uint32_t corner = 0; corner < 4u; ++corner) {
         int gridX = 0;
         int gridY = 0;
@@ -390,34 +432,76 @@ bool appendGreedyFaceQuad(
             baseColorIndex,
             lodLevel
         );
-        mesh.vertices.push_back(vertex);
+        corners[corner] = vertex;
     }
 
+    // Split along the diagonal with less occlusion. The quad-list pattern
+    // always splits 0-2, so the flipped split starts the quad at corner 1:
+    // triangles (1, 2, 3) and (1, 3, 0), as explicit indices used to say.
     const std::uint32_t ao0 = (aoSignature >> 0u) & PackedVoxelVertex::kMask4;
     const std::uint32_t ao1 = (aoSignature >> 4u) & PackedVoxelVertex::kMask4;
     const std::uint32_t ao2 = (aoSignature >> 8u) & PackedVoxelVertex::kMask4;
     const std::uint32_t ao3 = (aoSignature >> 12u) & PackedVoxelVertex::kMask4;
-    const bool useFlippedDiagonal = (ao0 + ao2) > (ao1 + ao3);
-    if (useFlippedDiagonal) {
-        mesh.indices.push_back(baseVertex + 1u);
-        mesh.indices.push_back(baseVertex + 2u);
-        mesh.indices.push_back(baseVertex + 3u);
-        mesh.indices.push_back(baseVertex + 1u);
-        mesh.indices.push_back(baseVertex + 3u);
-        mesh.indices.push_back(baseVertex + 0u);
-    } else {
-        mesh.indices.push_back(baseVertex + 0u);
-        mesh.indices.push_back(baseVertex + 1u);
-        mesh.indices.push_back(baseVertex + 2u);
-        mesh.indices.push_back(baseVertex + 0u);
-        mesh.indices.push_back(baseVertex + 2u);
-        mesh.indices.push_back(baseVertex + 3u);
+    const std::uint32_t firstCorner = (ao0 + ao2) > (ao1 + ao3) ? 1u : 0u;
+    for (std::uint32_t i = 0; i < 4u; ++i) {
+        mesh.vertices.push_back(corners[(firstCorner + i) & 3u]);
     }
     return true;
 }
 
-ChunkLodMeshes buildChunkLodMeshesGreedy(const Chunk& chunk, ChunkMeshingStats* outStats) {
-    ChunkLodMeshes meshes{};
+// Emits one merged quad for mask `key`, or, if the quad cannot be encoded,
+// the per-voxel faces it covers.
+void emitGreedyQuad(
+    const ChunkNeighborhood& neighborhood,
+    ChunkMeshData& mesh,
+    std::uint32_t faceId,
+    int slice,
+    int u,
+    int v,
+    int width,
+    int height,
+    std::uint32_t key
+) {
+    const std::uint8_t material = static_cast<std::uint8_t>((key >> 19u) & PackedVoxelVertex::kMask3);
+    const std::uint16_t aoSignature = static_cast<std::uint16_t>((key >> 3u) & 0xFFFFu);
+    const std::uint8_t baseColorIndex = static_cast<std::uint8_t>(key & PackedVoxelVertex::kMask3);
+    const bool mergedQuadAppended =
+        appendGreedyFaceQuad(mesh, faceId, slice, u, v, width, height, material, aoSignature, baseColorIndex, 0u);
+    if (mergedQuadAppended) {
+        return;
+    }
+    // Fallback path: preserve correctness if a merged quad cannot be encoded.
+    for (int emitV = 0; emitV < height; ++emitV) {
+        for (int emitU = 0; emitU < width; ++emitU) {
+            int x = 0;
+            int y = 0;
+            int z = 0;
+            faceSliceCellToVoxel(faceId, slice, u + emitU, v + emitV, x, y, z);
+            const Voxel voxel = neighborhood.center->voxelAt(x, y, z);
+            appendVoxelFace(
+                neighborhood,
+                mesh,
+                x,
+                y,
+                z,
+                faceId,
+                materialForVoxel(voxel),
+                packedBaseColorIndexForVoxel(voxel),
+                0u
+            );
+        }
+    }
+}
+
+// Per-voxel reference: one voxelAt() per neighbor test and five per AO corner.
+// Kept as the oracle the binary mesher is tested and benchmarked against.
+void buildChunkLodMeshesGreedyReference(
+    const ChunkNeighborhood& neighborhood,
+    ChunkMeshingStats* outStats,
+    ChunkLodMeshes& meshes
+) {
+    const Chunk& chunk = *neighborhood.center;
+    clearChunkLodMeshes(meshes);
     static_assert(Chunk::kSizeX <= 32 && Chunk::kSizeY <= 32 && Chunk::kSizeZ <= 32, "Packed position fields are 5-bit");
     ChunkMeshData& baseMesh = meshes.lodMeshes[0];
 
@@ -444,13 +528,13 @@ ChunkLodMeshes buildChunkLodMeshesGreedy(const Chunk& chunk, ChunkMeshingStats*
                     }
 
                     const FaceNeighbor& face = kFaceNeighbors[faceId];
-                    if (isSolidVoxel(chunk, x + face.nx, y + face.ny, z + face.nz)) {
+                    if (isSolidVoxel(neighborhood, x + face.nx, y + face.ny, z + face.nz)) {
                         continue;
                     }
 
                     const std::uint8_t material = materialForVoxel(voxel);
                     const std::uint8_t baseColorIndex = packedBaseColorIndexForVoxel(voxel);
-                    const std::uint16_t aoSignature = faceCornerAoSignature(chunk, x, y, z, faceId);
+                    const std::uint16_t aoSignature = faceCornerAoSignature(neighborhood, x, y, z, faceId);
                     const std::size_t maskIndex = static_cast<std::size_t>(u + (v * uCount));
                     mask[maskIndex] = makeMaskKey(material, aoSignature, baseColorIndex);
                     if (outStats != nullptr) {
@@ -493,51 +577,7 @@ ChunkLodMeshes buildChunkLodMeshesGreedy(const Chunk& chunk, ChunkMeshingStats*
                         }
                     }
 
-                    const std::uint8_t material =
-                        static_cast<std::uint8_t>((key >> 19u) & PackedVoxelVertex::kMask3);
-                    const std::uint16_t aoSignature =
-                        static_cast<std::uint16_t>((key >> 3u) & 0xFFFFu);
-                    const std::uint8_t baseColorIndex =
-                        static_cast<std::uint8_t>(key & PackedVoxelVertex::kMask3);
-                    const bool mergedQuadAppended =
-                        appendGreedyFaceQuad(
-                            baseMesh,
-                            faceId,
-                            slice,
-                            u,
-                            v,
-                            width,
-                            height,
-                            material,
-                            aoSignature,
-                            baseColorIndex,
-                            0u
-                        );
-                    if (!mergedQuadAppended) {
-                        // Fallback path: preserve correctness if a merged quad cannot be encoded.
-                        for (int emitV = 0; emitV < height; ++emitV) {
-                            for (int emitU = 0; emitU < width; ++emitU) {
-                                int x = 0;
-                                int y = 0;
-                                int z = 0;
-                                faceSliceCellToVoxel(faceId, slice, u + emitU, v + emitV, x, y, z);
-                                const Voxel voxel = chunk.voxelAt(x, y, z);
-                                const std::uint8_t fallbackMaterial = materialForVoxel(voxel);
-                                const std::uint8_t fallbackBaseColorIndex = packedBaseColorIndexForVoxel(voxel);
-                                appendVoxelFace(
-                                    chunk,
-                                    baseMesh,
-                                    x,
-                                    y,
-                                    z,
-                                    faceId,
-                                    fallbackMaterial,
-                                    fallbackBaseColorIndex,
-                                    0u
-                                );
-                            }
-                        }
-                    }
+                    emitGreedyQuad(neighborhood, baseMesh, faceId, slice, u, v, width, height, key);
 
                     for (int clearV = 0; clearV < height; ++clearV) {
                         for (int clearU = 0; clearU < width; ++clearU) {
@@ -552,8 +592,397 @@ ChunkLodMeshes buildChunkLodMeshesGreedy(const Chunk& chunk, ChunkMeshingStats*
             }
         }
     }
+}
 
-    return meshes;
+// Binary greedy mesher.
+//
+// Occupancy is held as 32-bit rows, one bit per voxel. For each face axis the
+// chunk is 32 planes of 32 rows, laid out to match faceSliceDimensions(): rows
+// run along the face's v axis and bits along its u axis.
+//   X planes: rows z, bits y    Y planes: rows z, bits x    Z planes: rows y, bits x
+// A face is visible where its plane is solid and the next plane along the
+// normal is empty (one AND-NOT per row). AO samples are bit tests in that next
+// plane, and runs are found with bit scans over the visible rows. The quads,
+// their order and every vertex bit match buildChunkLodMeshesGreedyReference().
+constexpr int kMaskRows = 32;
+using PlaneRows = std::array<std::uint32_t, kMaskRows>;
+
+static_assert(
+    Chunk::kSizeX == kMaskRows && Chunk::kSizeY == kMaskRows && Chunk::kSizeZ == kMaskRows,
+    "Binary mesher rows are one 32-bit word"
+);
+static_assert(sizeof(Voxel) == 2 && offsetof(Voxel, type) == 0, "Occupancy reads the type byte of 2-byte voxels");
+
+struct ChunkOccupancyPlanes {
+    // [axis][plane], axis 0 = X, 1 = Y, 2 = Z.
+    std::array<std::array<PlaneRows, kMaskRows>, 3> axes{};
+};
+
+// Bit x set where row[x].type != Empty, for 32 consecutive voxels.
+std::uint32_t rowOccupancy(const Voxel* row) {
+#if defined(ODAI_MESHER_AVX2)
+    const auto* words = reinterpret_cast<const __m256i*>(row);
+    const __m256i typeMask = _mm256_set1_epi16(0x00FF);
+    const __m256i low = _mm256_and_si256(_mm256_loadu_si256(words), typeMask);
+    const __m256i high = _mm256_and_si256(_mm256_loadu_si256(words + 1), typeMask);
+    // packus interleaves 128-bit lanes; the permute puts voxels back in order.
+    const __m256i types = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+    const __m256i empty = _mm256_cmpeq_epi8(types, _mm256_setzero_si256());
+    return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(empty));
+#elif defined(ODAI_MESHER_SSE2)
+    const auto* words = reinterpret_cast<const __m128i*>(row);
+    const __m128i typeMask = _mm_set1_epi16(0x00FF);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i types0 = _mm_packus_epi16(
+        _mm_and_si128(_mm_loadu_si128(words + 0), typeMask),
+        _mm_and_si128(_mm_loadu_si128(words + 1), typeMask)
+    );
+    const __m128i types1 = _mm_packus_epi16(
+        _mm_and_si128(_mm_loadu_si128(words + 2), typeMask),
+        _mm_and_si128(_mm_loadu_si128(words + 3), typeMask)
+    );
+    const std::uint32_t empty0 = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(types0, zero)));
+    const std::uint32_t empty1 = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(types1, zero)));
+    return ~(empty0 | (empty1 << 16u));
+#else
+    std::uint32_t bits = 0;
+    for (int x = 0; x < kMaskRows; ++x) {
+        bits |= (row[x].type != VoxelType::Empty ? 1u : 0u) << static_cast<std::uint32_t>(x);
+    }
+    return bits;
+#endif
+}
+
+// out[v] = solid[v] & ~covering[v].
+void andNotRows(const PlaneRows& solid, const PlaneRows& covering, PlaneRows& out) {
+#if defined(ODAI_MESHER_AVX2)
+    for (int v = 0; v < kMaskRows; v += 8) {
+        const __m256i solidRows = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(solid.data() + v));
+        const __m256i coveringRows = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(covering.data() + v));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.data() + v), _mm256_andnot_si256(coveringRows, solidRows));
+    }
+#elif defined(ODAI_MESHER_SSE2)
+    for (int v = 0; v < kMaskRows; v += 4) {
+        const __m128i solidRows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(solid.data() + v));
+        const __m128i coveringRows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(covering.data() + v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + v), _mm_andnot_si128(coveringRows, solidRows));
+    }
+#else
+    for (int v = 0; v < kMaskRows; ++v) {
+        out[v] = solid[v] & ~covering[v];
+    }
+#endif
+}
+
+// In-place 32x32 bit-matrix transpose: bit c of rows[r] moves to bit r of rows[c].
+void transposeBits32(PlaneRows& rows) {
+    std::uint32_t mask = 0x0000FFFFu;
+    for (int shift = 16; shift != 0; shift >>= 1, mask ^= (mask << shift)) {
+        for (int k = 0; k < kMaskRows; k = ((k | shift) + 1) & ~shift) {
+            const std::uint32_t swap = ((rows[k] >> shift) ^ rows[k | shift]) & mask;
+            rows[k] ^= swap << shift;
+            rows[k | shift] ^= swap;
+        }
+    }
+}
+
+void buildOccupancyPlanes(std::span<const Voxel> voxels, ChunkOccupancyPlanes& outPlanes) {
+    auto& planesX = outPlanes.axes[0];
+    auto& planesY = outPlanes.axes[1];
+    auto& planesZ = outPlanes.axes[2];
+    for (int y = 0; y < Chunk::kSizeY; ++y) {
+        for (int z = 0; z < Chunk::kSizeZ; ++z) {
+            const std::size_t rowStart = static_cast<std::size_t>(Chunk::kSizeX * (z + (Chunk::kSizeZ * y)));
+            const std::uint32_t row = rowOccupancy(voxels.data() + rowStart);
+            planesY[y][z] = row;
+            planesZ[z][y] = row;
+        }
+    }
+    for (int z = 0; z < Chunk::kSizeZ; ++z) {
+        PlaneRows columns = planesZ[z];
+        transposeBits32(columns);
+        for (int x = 0; x < Chunk::kSizeX; ++x) {
+            planesX[x][z] = columns[x];
+        }
+    }
+}
+
+// AO level for each (sideA, sideB, corner, edgeA, edgeB) bit pattern, built
+// with the same arithmetic as cornerAoLevel().
+const std::array<std::uint8_t, 32>& aoLevelTable() {
+    static const std::array<std::uint8_t, 32> table = []() {
+        std::array<std::uint8_t, 32> levels{};
+        for (std::uint32_t pattern = 0; pattern < levels.size(); ++pattern) {
+            levels[pattern] = static_cast<std::uint8_t>(aoLevelFromNeighbors(
+                (pattern & 1u) != 0u,
+                (pattern & 2u) != 0u,
+                (pattern & 4u) != 0u,
+                (pattern & 8u) != 0u,
+                (pattern & 16u) != 0u
+            ));
+        }
+        return levels;
+    }();
+    return table;
+}
+
+struct CornerSigns {
+    int u;
+    int v;
+};
+
+// Tangent directions cornerAoLevel() samples for one face corner.
+CornerSigns aoCornerSigns(std::uint32_t faceId, std::uint32_t corner) {
+    int ux = 0;
+    int uy = 0;
+    int uz = 0;
+    int vx = 0;
+    int vy = 0;
+    int vz = 0;
+    faceAoAxes(faceId, ux, uy, uz, vx, vy, vz);
+    const CornerAxes& cornerAxes = kFaceCornerAxes[faceId][corner];
+    const int uSign = ((ux != 0 ? cornerAxes.x : (uy != 0 ? cornerAxes.y : cornerAxes.z)) != 0) ? +1 : -1;
+    const int vSign = ((vx != 0 ? cornerAxes.x : (vy != 0 ? cornerAxes.y : cornerAxes.z)) != 0) ? +1 : -1;
+    return CornerSigns{uSign, vSign};
+}
+
+// The cells just outside a covering plane, read from the tangent neighbors'
+// slabs: uMinus/uPlus are the u == -1 / u == 32 columns (bit v), vMinus/vPlus
+// the v == -1 / v == 32 rows (bit u). All zero when the covering plane itself
+// lies in a neighbor, whose tangent neighbors are diagonal to the center.
+struct PlaneRing {
+    std::uint32_t uMinus = 0;
+    std::uint32_t uPlus = 0;
+    std::uint32_t vMinus = 0;
+    std::uint32_t vPlus = 0;
+};
+
+// Which slabs border the u and v edges of each axis' planes, and whether the
+// slab has to be read column-wise (transposed) to line up with that edge.
+struct PlaneRingSource {
+    std::uint32_t uMinusFace;
+    std::uint32_t uPlusFace;
+    bool uTransposed;
+    std::uint32_t vMinusFace;
+    std::uint32_t vPlusFace;
+    bool vTransposed;
+};
+
+constexpr std::array<PlaneRingSource, 3> kPlaneRingSources = {
+    PlaneRingSource{3u, 2u, true, 5u, 4u, true},
+    PlaneRingSource{1u, 0u, true, 5u, 4u, false},
+    PlaneRingSource{1u, 0u, false, 3u, 2u, false},
+};
+
+struct BorderSlabPlanes {
+    std::array<PlaneRows, kChunkFaceCount> rows{};
+    std::array<PlaneRows, kChunkFaceCount> transposed{};
+};
+
+PlaneRing planeRing(const BorderSlabPlanes& slabs, std::size_t axis, int plane) {
+    const PlaneRingSource& source = kPlaneRingSources[axis];
+    const auto& uRows = source.uTransposed ? slabs.transposed : slabs.rows;
+    const auto& vRows = source.vTransposed ? slabs.transposed : slabs.rows;
+    const std::size_t index = static_cast<std::size_t>(plane);
+    return PlaneRing{
+        uRows[source.uMinusFace][index],
+        uRows[source.uPlusFace][index],
+        vRows[source.vMinusFace][index],
+        vRows[source.vPlusFace][index],
+    };
+}
+
+std::uint32_t planeBit(const PlaneRows& plane, const PlaneRing& ring, int u, int v) {
+    const bool inU = u >= 0 && u < kMaskRows;
+    const bool inV = v >= 0 && v < kMaskRows;
+    if (inU && inV) {
+        return (plane[static_cast<std::size_t>(v)] >> static_cast<std::uint32_t>(u)) & 1u;
+    }
+    if (inV && (u == -1 || u == kMaskRows)) {
+        return ((u < 0 ? ring.uMinus : ring.uPlus) >> static_cast<std::uint32_t>(v)) & 1u;
+    }
+    if (inU && (v == -1 || v == kMaskRows)) {
+        return ((v < 0 ? ring.vMinus : ring.vPlus) >> static_cast<std::uint32_t>(u)) & 1u;
+    }
+    return 0u;
+}
+
+std::uint16_t planeAoSignature(
+    const PlaneRows& coveringPlane,
+    const PlaneRing& ring,
+    int u,
+    int v,
+    const std::array<CornerSigns, 4>& cornerSigns,
+    const std::array<std::uint8_t, 32>& aoLevels
+) {
+    std::uint16_t signature = 0;
+    for (std::uint32_t corner = 0; corner < 4u; ++corner) {
+        const int su = cornerSigns[corner].u;
+        const int sv = cornerSigns[corner].v;
+        const std::uint32_t pattern =
+            planeBit(coveringPlane, ring, u + su, v) |
+            (planeBit(coveringPlane, ring, u, v + sv) << 1u) |
+            (planeBit(coveringPlane, ring, u + su, v + sv) << 2u) |
+            (planeBit(coveringPlane, ring, u + (2 * su), v) << 3u) |
+            (planeBit(coveringPlane, ring, u, v + (2 * sv)) << 4u);
+        signature |= static_cast<std::uint16_t>(aoLevels[pattern] << (corner * 4u));
+    }
+    return signature;
+}
+
+// `voxels` is the center chunk in linear (x, z, y) order, or a single voxel
+// that fills the whole chunk (a Uniform center). A uniform chunk is solid in
+// every plane, so only the six boundary slices, covered by the neighbor
+// slabs, can show a face; the interior slices are skipped outright.
+void buildChunkLodMeshesGreedyBinary(
+    const ChunkNeighborhood& neighborhood,
+    std::span<const Voxel> voxels,
+    ChunkMeshingStats* outStats,
+    ChunkLodMeshes& meshes
+) {
+    const bool uniform = voxels.size() == 1u;
+    if (!uniform && voxels.size() != Chunk::kVoxelCount) {
+        buildChunkLodMeshesGreedyReference(neighborhood, outStats, meshes);
+        return;
+    }
+
+    clearChunkLodMeshes(meshes);
+    ChunkMeshData& baseMesh = meshes.lodMeshes[0];
+    ChunkOccupancyPlanes occupancy;
+    if (uniform) {
+        const std::uint32_t fill = voxels[0].type != VoxelType::Empty ? ~0u : 0u;
+        for (auto& planes : occupancy.axes) {
+            for (PlaneRows& plane : planes) {
+                plane.fill(fill);
+            }
+        }
+    } else {
+        buildOccupancyPlanes(voxels, occupancy);
+    }
+
+    const std::array<std::uint8_t, 32>& aoLevels = aoLevelTable();
+    // Signature of a face with nothing solid within two cells of it.
+    const std::uint16_t openAoSignature = static_cast<std::uint16_t>(aoLevels[0] * 0x1111u);
+    BorderSlabPlanes slabs;
+    slabs.rows = neighborhood.borders.rows;
+    slabs.transposed = neighborhood.borders.rows;
+    for (PlaneRows& rows : slabs.transposed) {
+        transposeBits32(rows);
+    }
+    PlaneRows visible{};
+    std::array<std::uint32_t, kMaskRows * kMaskRows> keys{};
+
+    for (std::uint32_t faceId = 0; faceId < kFaceNeighbors.size(); ++faceId) {
+        const std::size_t axis = faceId / 2u;
+        const int normalStep = (faceId & 1u) == 0u ? +1 : -1;
+        std::array<CornerSigns, 4> cornerSigns{};
+        for (std::uint32_t corner = 0; corner < 4u; ++corner) {
+            cornerSigns[corner] = aoCornerSigns(faceId, corner);
+        }
+
+        for (int slice = 0; slice < kMaskRows; ++slice) {
+            // The last plane along the normal is covered by the neighbor slab.
+            const int coveringSlice = slice + normalStep;
+            const bool coveringInChunk = coveringSlice >= 0 && coveringSlice < kMaskRows;
+            if (uniform && coveringInChunk) {
+                continue;
+            }
+            const PlaneRows& coveringPlane = coveringInChunk
+                ? occupancy.axes[axis][static_cast<std::size_t>(coveringSlice)]
+                : slabs.rows[faceId];
+            const PlaneRing ring = coveringInChunk ? planeRing(slabs, axis, coveringSlice) : PlaneRing{};
+            andNotRows(occupancy.axes[axis][static_cast<std::size_t>(slice)], coveringPlane, visible);
+
+            bool anyVisible = false;
+            for (int v = 0; v < kMaskRows; ++v) {
+                std::uint32_t row = visible[static_cast<std::size_t>(v)];
+                if (row == 0u) {
+                    continue;
+                }
+                anyVisible = true;
+                if (outStats != nullptr) {
+                    outStats->exposedFaceCount += static_cast<std::size_t>(std::popcount(row));
+                }
+                // Cells with a solid voxel anywhere in their AO footprint (two
+                // rows and two bits either way, ring included); every other
+                // cell is fully lit.
+                std::uint32_t nearby = 0;
+                for (int nearV = std::max(0, v - 2); nearV <= std::min(kMaskRows - 1, v + 2); ++nearV) {
+                    nearby |= coveringPlane[static_cast<std::size_t>(nearV)];
+                }
+                if (v <= 1) {
+                    nearby |= ring.vMinus;
+                }
+                if (v >= kMaskRows - 2) {
+                    nearby |= ring.vPlus;
+                }
+                nearby |= (nearby << 1u) | (nearby >> 1u);
+                nearby |= (nearby << 1u) | (nearby >> 1u);
+                if ((ring.uMinus | ring.uPlus) != 0u) {
+                    const int nearLow = std::max(0, v - 2);
+                    const int nearHigh = std::min(kMaskRows - 1, v + 2);
+                    const std::uint32_t nearRows = ((1u << static_cast<std::uint32_t>(nearHigh - nearLow + 1)) - 1u)
+                        << static_cast<std::uint32_t>(nearLow);
+                    nearby |= (ring.uMinus & nearRows) != 0u ? 0x00000003u : 0u;
+                    nearby |= (ring.uPlus & nearRows) != 0u ? 0xC0000000u : 0u;
+                }
+
+                while (row != 0u) {
+                    const int u = std::countr_zero(row);
+                    row &= row - 1u;
+                    int x = 0;
+                    int y = 0;
+                    int z = 0;
+                    faceSliceCellToVoxel(faceId, slice, u, v, x, y, z);
+                    const Voxel voxel = uniform
+                        ? voxels[0]
+                        : voxels[static_cast<std::size_t>(x + (Chunk::kSizeX * (z + (Chunk::kSizeZ * y))))];
+                    const std::uint16_t aoSignature = ((nearby >> static_cast<std::uint32_t>(u)) & 1u) != 0u
+                        ? planeAoSignature(coveringPlane, ring, u, v, cornerSigns, aoLevels)
+                        : openAoSignature;
+                    keys[static_cast<std::size_t>(u + (v * kMaskRows))] =
+                        makeMaskKey(materialForVoxel(voxel), aoSignature, packedBaseColorIndexForVoxel(voxel));
+                }
+            }
+            if (!anyVisible) {
+                continue;
+            }
+
+            for (int v = 0; v < kMaskRows; ++v) {
+                std::uint32_t& row = visible[static_cast<std::size_t>(v)];
+                while (row != 0u) {
+                    const int u = std::countr_zero(row);
+                    const std::uint32_t* rowKeys = keys.data() + (v * kMaskRows);
+                    const std::uint32_t key = rowKeys[u];
+                    const int run = std::countr_one(row >> static_cast<std::uint32_t>(u));
+                    int width = 1;
+                    while (width < run && rowKeys[u + width] == key) {
+                        ++width;
+                    }
+                    const std::uint32_t spanBits =
+                        (width == kMaskRows ? ~0u : ((1u << static_cast<std::uint32_t>(width)) - 1u))
+                        << static_cast<std::uint32_t>(u);
+
+                    int height = 1;
+                    while ((v + height) < kMaskRows) {
+                        if ((visible[static_cast<std::size_t>(v + height)] & spanBits) != spanBits) {
+                            break;
+                        }
+                        const std::uint32_t* growKeys = keys.data() + ((v + height) * kMaskRows) + u;
+                        if (!std::all_of(growKeys, growKeys + width, [key](std::uint32_t growKey) { return growKey == key; })) {
+                            break;
+                        }
+                        ++height;
+                    }
+
+                    emitGreedyQuad(neighborhood, baseMesh, faceId, slice, u, v, width, height, key);
+                    for (int clearV = 0; clearV < height; ++clearV) {
+                        visible[static_cast<std::size_t>(v + clearV)] &= ~spanBits;
+                    }
+                }
+            }
+        }
+    }
 }
 
 } // namespace
@@ -580,13 +1009,14 @@ std::uint32_t PackedVoxelVertex::pack(
            ((lodLevel & kMask2) << kShiftLodLevel);
 }
 
-ChunkLodMeshes buildChunkLodMeshesNaive(const Chunk& chunk, ChunkMeshingStats* outStats) {
-    ChunkLodMeshes meshes{};
+void buildChunkLodMeshesNaive(const ChunkNeighborhood& neighborhood, ChunkMeshingStats* outStats, ChunkLodMeshes& meshes) {
+    const Chunk& chunk = *neighborhood.center;
+    clearChunkLodMeshes(meshes);
     static_assert(Chunk::kSizeX <= 32 && Chunk::kSizeY <= 32 && Chunk::kSizeZ <= 32, "Packed position fields are 5-bit");
 
+    // No worst-case reserve: the buffer may be pooled, and a 32^3 * 24 vertex
+    // reservation would stay with it for good.
     ChunkMeshData& baseMesh = meshes.lodMeshes[0];
-    baseMesh.vertices.reserve(static_cast<std::size_t>(Chunk::kSizeX * Chunk::kSizeY * Chunk::kSizeZ * 6 * 4));
-    baseMesh.indices.reserve(static_cast<std::size_t>(Chunk::kSizeX * Chunk::kSizeY * Chunk::kSizeZ * 6 * 6));
 
     for (int y = 0; y < Chunk::kSizeY; ++y) {
         for (int z = 0; z < Chunk::kSizeZ; ++z) {
@@ -599,10 +1029,10 @@ ChunkLodMeshes buildChunkLodMeshesNaive(const Chunk& chunk, ChunkMeshingStats* o
                 const std::uint8_t material = materialForVoxel(voxel);
                 const std::uint8_t baseColorIndex = packedBaseColorIndexForVoxel(voxel);
                 for (const FaceNeighbor& face : kFaceNeighbors) {
-                    if (isSolidVoxel(chunk, x + face.nx, y + face.ny, z + face.nz)) {
+                    if (isSolidVoxel(neighborhood, x + face.nx, y + face.ny, z + face.nz)) {
                         continue;
                     }
-                    appendVoxelFace(chunk, baseMesh, x, y, z, face.faceId, material, baseColorIndex, 0u);
+                    appendVoxelFace(neighborhood, baseMesh, x, y, z, face.faceId, material, baseColorIndex, 0u);
                     if (outStats != nullptr) {
                         ++outStats->exposedFaceCount;
                     }
@@ -610,20 +1040,157 @@ ChunkLodMeshes buildChunkLodMeshesNaive(const Chunk& chunk, ChunkMeshingStats* o
             }
         }
     }
+}
 
-    return meshes;
+ChunkMeshKey chunkMeshNeighborKey(ChunkMeshKey key, std::uint32_t faceId) {
+    const FaceNeighbor& face = kFaceNeighbors[faceId];
+    return ChunkMeshKey{key.x + face.nx, key.y + face.ny, key.z + face.nz};
 }
 
-ChunkLodMeshes buildChunkLodMeshes(const Chunk& chunk, MeshingOptions options, ChunkMeshingStats* outStats) {
+void captureChunkBorderSlab(const Chunk& neighbor, std::uint32_t faceId, ChunkBorderSlabs& borders) {
+    // The neighbor across the center's +X face touches it with its x == 0
+    // plane, the one across -X with x == 31, and so on.
+    const int plane = (faceId & 1u) == 0u ? 0 : (kMaskRows - 1);
+    const std::span<const Voxel> voxels = neighbor.denseVoxels();
+    const bool dense = voxels.size() == Chunk::kVoxelCount;
+    const auto solidAt = [&](int x, int y, int z) {
+        const Voxel voxel = dense
+            ? voxels[static_cast<std::size_t>(x + (Chunk::kSizeX * (z + (Chunk::kSizeZ * y))))]
+            : neighbor.voxelAt(x, y, z);
+        return voxel.type != VoxelType::Empty ? 1u : 0u;
+    };
+
+    PlaneRows& rows = borders.rows[faceId];
+    for (int row = 0; row < kMaskRows; ++row) {
+        std::uint32_t bits = 0;
+        if (faceId / 2u == 1u && dense) {
+            // Y slabs are whole x rows of the neighbor: one SIMD row read each.
+            bits = rowOccupancy(voxels.data() + static_cast<std::size_t>(Chunk::kSizeX * (row + (Chunk::kSizeZ * plane))));
+        } else {
+            for (int bit = 0; bit < kMaskRows; ++bit) {
+                std::uint32_t solid = 0;
+                switch (faceId / 2u) {
+                case 0u:
+                    solid = solidAt(plane, bit, row);
+                    break;
+                case 1u:
+                    solid = solidAt(bit, plane, row);
+                    break;
+                default:
+                    solid = solidAt(bit, row, plane);
+                    break;
+                }
+                bits |= solid << static_cast<std::uint32_t>(bit);
+            }
+        }
+        rows[static_cast<std::size_t>(row)] = bits;
+    }
+    borders.presentMask = static_cast<std::uint8_t>(borders.presentMask | (1u << faceId));
+}
+
+ChunkNeighborLookup::ChunkNeighborLookup(std::span<const Chunk> chunks)
+    : m_chunks(chunks) {
+    m_indices.reserve(chunks.size());
+    for (std::size_t index = 0; index < chunks.size(); ++index) {
+        const Chunk& chunk = chunks[index];
+        m_indices.emplace(ChunkMeshKey{chunk.chunkX(), chunk.chunkY(), chunk.chunkZ()}, index);
+    }
+}
+
+const Chunk* ChunkNeighborLookup::find(ChunkMeshKey key) const {
+    const auto it = m_indices.find(key);
+    return it != m_indices.end() ? &m_chunks[it->second] : nullptr;
+}
+
+std::uint8_t ChunkNeighborLookup::residentNeighborMask(ChunkMeshKey key) const {
+    std::uint8_t mask = 0;
+    for (std::uint32_t faceId = 0; faceId < kChunkFaceCount; ++faceId) {
+        if (m_indices.contains(chunkMeshNeighborKey(key, faceId))) {
+            mask = static_cast<std::uint8_t>(mask | (1u << faceId));
+        }
+    }
+    return mask;
+}
+
+ChunkNeighborhood ChunkNeighborLookup::neighborhood(const Chunk& center) const {
+    ChunkNeighborhood result{};
+    result.center = &center;
+    const ChunkMeshKey centerKey{center.chunkX(), center.chunkY(), center.chunkZ()};
+    for (std::uint32_t faceId = 0; faceId < kChunkFaceCount; ++faceId) {
+        if (const Chunk* neighbor = find(chunkMeshNeighborKey(centerKey, faceId)); neighbor != nullptr) {
+            captureChunkBorderSlab(*neighbor, faceId, result.borders);
+        }
+    }
+    return result;
+}
+
+void buildChunkLodMeshesInto(
+    const ChunkNeighborhood& neighborhood,
+    MeshingOptions options,
+    ChunkMeshingStats* outStats,
+    ChunkLodMeshes& out
+) {
+    if (neighborhood.center == nullptr) {
+        clearChunkLodMeshes(out);
+        return;
+    }
+    const Chunk& center = *neighborhood.center;
+    const Chunk::StorageMode storage = center.storageMode();
+    if (storage == Chunk::StorageMode::Uniform && center.voxelAt(0, 0, 0).type == VoxelType::Empty) {
+        clearChunkLodMeshes(out);
+        return;
+    }
+    // Only the binary mesher needs a voxel array; Naive and the reference read
+    // the center through Chunk::voxelAt, which serves every storage mode.
     switch (options.mode) {
     case MeshingMode::Greedy:
-        return buildChunkLodMeshesGreedy(chunk, outStats);
+        if (storage == Chunk::StorageMode::Uniform) {
+            const Voxel fill = center.voxelAt(0, 0, 0);
+            buildChunkLodMeshesGreedyBinary(neighborhood, std::span<const Voxel>(&fill, 1u), outStats, out);
+        } else if (storage == Chunk::StorageMode::Palette) {
+            // Decoded into a per-thread buffer that keeps its capacity, so
+            // meshing a palette chunk allocates nothing after the first time.
+            thread_local std::vector<Voxel> t_denseScratch;
+            center.copyDenseVoxels(t_denseScratch);
+            buildChunkLodMeshesGreedyBinary(neighborhood, t_denseScratch, outStats, out);
+        } else {
+            buildChunkLodMeshesGreedyBinary(neighborhood, center.denseVoxels(), outStats, out);
+        }
+        break;
+    case MeshingMode::GreedyReference:
+        buildChunkLodMeshesGreedyReference(neighborhood, outStats, out);
+        break;
     case MeshingMode::Naive:
     default:
-        return buildChunkLodMeshesNaive(chunk, outStats);
+        buildChunkLodMeshesNaive(neighborhood, outStats, out);
+        break;
     }
 }
 
+ChunkLodMeshes buildChunkLodMeshes(
+    const ChunkNeighborhood& neighborhood,
+    MeshingOptions options,
+    ChunkMeshingStats* outStats
+) {
+    ChunkLodMeshes meshes{};
+    buildChunkLodMeshesInto(neighborhood, options, outStats, meshes);
+    return meshes;
+}
+
+ChunkLodMeshes buildChunkLodMeshes(const Chunk& chunk, MeshingOptions options, ChunkMeshingStats* outStats) {
+    return buildChunkLodMeshes(ChunkNeighborhood{&chunk, ChunkBorderSlabs{}}, options, outStats);
+}
+
+const char* chunkMesherSimdPath() {
+#if defined(ODAI_MESHER_AVX2)
+    return "avx2";
+#elif defined(ODAI_MESHER_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
 ChunkLodMeshes buildChunkLodMeshes(const Chunk& chunk, MeshingOptions options) {
     return buildChunkLodMeshes(chunk, options, nullptr);
 }
@@ -633,6 +1200,98 @@ ChunkMeshData buildChunkMesh(const Chunk& chunk, MeshingOptions options) {
     return lodMeshes.lodMeshes[0];
 }
 
+void appendMeshIndices(const ChunkMeshData& mesh, std::uint32_t baseVertex, std::vector<std::uint32_t>& out) {
+    if (!mesh.isQuadList()) {
+        out.reserve(out.size() + mesh.indices.size());
+        for (const std::uint32_t index : mesh.indices) {
+            out.push_back(index + baseVertex);
+        }
+        return;
+    }
+    const std::size_t quadCount = mesh.vertices.size() / 4u;
+    out.reserve(out.size() + (quadCount * kQuadListCornerIndices.size()));
+    for (std::size_t quad = 0; quad < quadCount; ++quad) {
+        const std::uint32_t quadBase = baseVertex + static_cast<std::uint32_t>(quad * 4u);
+        for (const std::uint32_t corner : kQuadListCornerIndices) {
+            out.push_back(quadBase + corner);
+        }
+    }
+}
+
+std::size_t chunkMeshCapacityBytes(const ChunkLodMeshes& meshes) {
+    std::size_t bytes = 0;
+    for (const ChunkMeshData& mesh : meshes.lodMeshes) {
+        bytes += mesh.vertices.capacity() * sizeof(PackedVoxelVertex);
+        bytes += mesh.indices.capacity() * sizeof(std::uint32_t);
+    }
+    return bytes;
+}
+
+ChunkMeshBufferPool::ChunkMeshBufferPool(std::size_t maxFreeSets)
+    : m_maxFreeSets(maxFreeSets) {
+    m_freeSets.reserve(maxFreeSets);
+}
+
+ChunkLodMeshes ChunkMeshBufferPool::acquire() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_freeSets.empty()) {
+        // Counted when the first build into it allocates (recordBuild).
+        return ChunkLodMeshes{};
+    }
+    ChunkLodMeshes meshes = std::move(m_freeSets.back());
+    m_freeSets.pop_back();
+    ++m_stats.reuses;
+    m_stats.freeSets = m_freeSets.size();
+    return meshes;
+}
+
+void ChunkMeshBufferPool::recordBuild(std::size_t capacityBytesBefore, const ChunkLodMeshes& built) {
+    const std::size_t capacityBytesAfter = chunkMeshCapacityBytes(built);
+    if (capacityBytesAfter <= capacityBytesBefore) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.allocations;
+    m_stats.liveBytes += capacityBytesAfter - capacityBytesBefore;
+    noteLiveBytesLocked();
+}
+
+void ChunkMeshBufferPool::release(ChunkLodMeshes&& meshes) {
+    const std::size_t bytes = chunkMeshCapacityBytes(meshes);
+    if (bytes == 0u) {
+        return;
+    }
+    clearChunkLodMeshes(meshes);
+    ChunkLodMeshes dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_freeSets.size() < m_maxFreeSets) {
+            m_freeSets.push_back(std::move(meshes));
+            m_stats.freeSets = m_freeSets.size();
+            return;
+        }
+        // Free list full: let the set go. A set built outside the pool was
+        // never counted, so saturate rather than underflow.
+        m_stats.liveBytes -= std::min(m_stats.liveBytes, bytes);
+        dropped = std::move(meshes);
+    }
+    // `dropped` frees its buffers here, outside the lock.
+}
+
+ChunkMeshBufferPoolStats ChunkMeshBufferPool::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void ChunkMeshBufferPool::resetPeak() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.peakBytes = m_stats.liveBytes;
+}
+
+void ChunkMeshBufferPool::noteLiveBytesLocked() {
+    m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.liveBytes);
+}
+
 ChunkMeshData buildSingleChunkMesh(const ChunkGrid& chunkGrid, MeshingOptions options) {
     if (chunkGrid.chunks().empty()) {
         return ChunkMeshData{};
@@ -6,6 +6,9 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <mutex>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 namespace odai::world {
@@ -14,7 +17,12 @@ constexpr std::uint32_t kChunkMeshLodCount = 3;
 
 enum class MeshingMode : std::uint8_t {
     Naive = 0,
-    Greedy = 1
+    // Binary greedy mesher: occupancy bitmasks, bit-scan merging (SIMD where
+    // available).
+    Greedy = 1,
+    // The per-voxel greedy mesher Greedy replaced. Same vertices and indices,
+    // much slower; kept as the oracle for equivalence tests and benchmarks.
+    GreedyReference = 2
 };
 
 struct MeshingOptions {
@@ -69,15 +77,85 @@ struct PackedVoxelVertex {
     );
 };
 
+// The chunk meshers emit quad lists: every four vertices are one quad, drawn
+// as triangles (0, 1, 2) and (0, 2, 3), and `indices` stays empty. The
+// pattern is the same for every chunk, so index buffers are generated at
+// upload (appendMeshIndices) instead of being stored per mesh. An AO-flipped
+// diagonal is expressed by rotating the quad's vertex order, never by its
+// indices. Other producers of ChunkMeshData (MagicaVoxel models, preview
+// cubes) still fill `indices` explicitly.
 struct ChunkMeshData {
     std::vector<PackedVoxelVertex> vertices;
     std::vector<std::uint32_t> indices;
+
+    [[nodiscard]] bool isQuadList() const { return indices.empty(); }
+    [[nodiscard]] std::size_t indexCount() const {
+        return isQuadList() ? (vertices.size() / 4u) * 6u : indices.size();
+    }
 };
 
+inline constexpr std::array<std::uint32_t, 6> kQuadListCornerIndices = {0u, 1u, 2u, 0u, 2u, 3u};
+
+// Appends the draw indices of `mesh` to `out`, offset by baseVertex: the
+// explicit indices, or the quad-list pattern expanded over its vertices.
+void appendMeshIndices(const ChunkMeshData& mesh, std::uint32_t baseVertex, std::vector<std::uint32_t>& out);
+
 struct ChunkLodMeshes {
     std::array<ChunkMeshData, kChunkMeshLodCount> lodMeshes;
 };
 
+// Bytes of heap capacity held by a mesh set's vertex and index vectors.
+[[nodiscard]] std::size_t chunkMeshCapacityBytes(const ChunkLodMeshes& meshes);
+
+struct ChunkMeshBufferPoolStats {
+    // Buffer sets created from nothing, plus pooled sets that had to grow
+    // while a mesh was built into them. Each is at least one heap allocation.
+    std::uint64_t allocations = 0;
+    // acquire() calls served from the free list.
+    std::uint64_t reuses = 0;
+    // Capacity of every set the pool has handed out and not yet had back, plus
+    // its free list.
+    std::size_t liveBytes = 0;
+    std::size_t peakBytes = 0;
+    std::size_t freeSets = 0;
+};
+
+// Recycles ChunkLodMeshes buffers between mesh builds so steady-state
+// meshing allocates nothing: a worker acquire()s a set, builds into it (the
+// vectors are cleared, capacity kept), and whoever is done with the mesh --
+// the scheduler for a discarded result, the renderer once a newer mesh
+// replaces it -- release()s it back. Thread-safe; every call takes one lock.
+//
+// Byte accounting assumes every non-empty set went through acquire() and
+// recordBuild(); a set built elsewhere may still be released, but its
+// capacity is not in liveBytes. Beyond maxFreeSets, released sets are freed
+// instead of kept.
+class ChunkMeshBufferPool {
+public:
+    explicit ChunkMeshBufferPool(std::size_t maxFreeSets = 64);
+
+    ChunkMeshBufferPool(const ChunkMeshBufferPool&) = delete;
+    ChunkMeshBufferPool& operator=(const ChunkMeshBufferPool&) = delete;
+
+    [[nodiscard]] ChunkLodMeshes acquire();
+    // Reports a build into an acquired set whose capacity was
+    // `capacityBytesBefore` when the build started.
+    void recordBuild(std::size_t capacityBytesBefore, const ChunkLodMeshes& built);
+    void release(ChunkLodMeshes&& meshes);
+
+    [[nodiscard]] ChunkMeshBufferPoolStats stats() const;
+    // Restarts peakBytes from the current liveBytes.
+    void resetPeak();
+
+private:
+    void noteLiveBytesLocked();
+
+    std::size_t m_maxFreeSets;
+    mutable std::mutex m_mutex;
+    std::vector<ChunkLodMeshes> m_freeSets;
+    ChunkMeshBufferPoolStats m_stats{};
+};
+
 // A naive mesh emits exactly 4 vertices / 6 indices per exposed face, so
 // exposedFaceCount lets callers derive naive-equivalent geometry counts
 // without running the naive mesher a second time.
@@ -101,6 +179,64 @@ struct ChunkMeshKeyHash {
     }
 };
 
+// Face ids shared by the mesher, the packed vertex format and the neighbor
+// slabs below: 0 = +X, 1 = -X, 2 = +Y, 3 = -Y, 4 = +Z, 5 = -Z.
+constexpr std::uint32_t kChunkFaceCount = 6;
+
+// The neighbor on the other side of face `faceId`, and the face that points
+// back at this chunk from it.
+ChunkMeshKey chunkMeshNeighborKey(ChunkMeshKey key, std::uint32_t faceId);
+constexpr std::uint32_t oppositeChunkFace(std::uint32_t faceId) {
+    return faceId ^ 1u;
+}
+
+// Occupancy of the six one-voxel-thick planes that touch a chunk from its
+// face neighbors: rows[faceId] is the neighbor's plane adjacent to the center
+// (x == 0 of the +X neighbor, x == 31 of the -X neighbor, ...). Rows use the
+// binary mesher's plane layout for that face's axis:
+//   X slabs: rows z, bits y    Y slabs: rows z, bits x    Z slabs: rows y, bits x
+// A face whose presentMask bit is clear reads as air, which is exactly what
+// meshing the chunk on its own does.
+struct ChunkBorderSlabs {
+    std::array<std::array<std::uint32_t, 32>, kChunkFaceCount> rows{};
+    std::uint8_t presentMask = 0;
+
+    [[nodiscard]] bool hasNeighbor(std::uint32_t faceId) const {
+        return ((presentMask >> faceId) & 1u) != 0u;
+    }
+};
+
+// Mesher input: the center chunk plus its neighbor slabs. Faces against a
+// solid slab voxel are culled and seam AO samples the slabs. Diagonal
+// neighbors are not captured, so AO samples that leave the chunk on two axes
+// at once still read as air.
+struct ChunkNeighborhood {
+    const Chunk* center = nullptr;
+    ChunkBorderSlabs borders{};
+};
+
+// Copies the plane of `neighbor` that touches the center chunk across face
+// `faceId` of the center into borders.rows[faceId] and marks it present.
+void captureChunkBorderSlab(const Chunk& neighbor, std::uint32_t faceId, ChunkBorderSlabs& borders);
+
+// Key -> chunk index over a resident chunk span, built once per meshing pass
+// so slab capture does not scan the chunk list per neighbor. Holds pointers
+// into `chunks`: rebuild it whenever the span is reallocated.
+class ChunkNeighborLookup {
+public:
+    explicit ChunkNeighborLookup(std::span<const Chunk> chunks);
+
+    [[nodiscard]] const Chunk* find(ChunkMeshKey key) const;
+    // Bit per face set where a face neighbor of `key` is resident.
+    [[nodiscard]] std::uint8_t residentNeighborMask(ChunkMeshKey key) const;
+    // `center` plus slabs from every resident face neighbor.
+    [[nodiscard]] ChunkNeighborhood neighborhood(const Chunk& center) const;
+
+private:
+    std::span<const Chunk> m_chunks;
+    std::unordered_map<ChunkMeshKey, std::size_t, ChunkMeshKeyHash> m_indices;
+};
+
 // A finished off-thread mesh for one chunk, ready for GPU upload. generation
 // is the scheduler's staleness token (see world::ChunkMeshScheduler).
 struct ChunkMeshResult {
@@ -115,6 +251,24 @@ struct ChunkMeshResult {
 };
 
 ChunkLodMeshes buildChunkLodMeshes(const Chunk& chunk, MeshingOptions options, ChunkMeshingStats* outStats);
+// Same meshers, with boundary faces culled and seam AO taken from the
+// neighbor slabs. Empty borders give the single-chunk result exactly.
+ChunkLodMeshes buildChunkLodMeshes(
+    const ChunkNeighborhood& neighborhood,
+    MeshingOptions options,
+    ChunkMeshingStats* outStats
+);
+// Same as above, built into `out`: its vectors are cleared and refilled, so
+// capacity left from an earlier mesh (e.g. a ChunkMeshBufferPool set) is
+// reused instead of reallocated.
+void buildChunkLodMeshesInto(
+    const ChunkNeighborhood& neighborhood,
+    MeshingOptions options,
+    ChunkMeshingStats* outStats,
+    ChunkLodMeshes& out
+);
+// "avx2", "sse2" or "scalar": the occupancy path this build of the mesher uses.
+const char* chunkMesherSimdPath();
 ChunkLodMeshes buildChunkLodMeshes(const Chunk& chunk, MeshingOptions options = {});
 ChunkMeshData buildChunkMesh(const Chunk& chunk, MeshingOptions options = {});
 
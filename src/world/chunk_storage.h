@@ -0,0 +1,354 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "world/chunk.h"
+#include "world/chunk_grid.h"
+
+// World ChunkStorage subsystem
+// Responsible for: owning every stored chunk exactly once in generation-checked
+// slots, and lending the resident ones to a ChunkGrid so meshing, upload and
+// raycasts keep reading one contiguous span.
+// Should NOT do: pick which chunks are resident or evicted, page chunks in
+// from disk, or decide when a chunk is saved.
+namespace odai::world {
+
+// Names a stored chunk for as long as it stays stored, whether or not it is
+// resident. Erasing the chunk bumps its slot's generation, so a stale handle
+// stops resolving instead of aliasing whatever reuses the slot.
+struct ChunkHandle {
+    static constexpr std::uint32_t kInvalidSlot = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t slot = kInvalidSlot;
+    std::uint32_t generation = 0;
+
+    [[nodiscard]] bool valid() const { return slot != kInvalidSlot; }
+    [[nodiscard]] bool operator==(const ChunkHandle& other) const = default;
+};
+
+// A resident chunk is moved (not copied) into the resident grid and moved back
+// when it leaves, so entering or leaving costs a few pointer swaps regardless
+// of chunk contents, and an edit has exactly one copy to patch.
+//
+// Non-resident chunks are kept in least-recently-used order (by when they
+// were stored, left the grid or were last edited) with their footprint
+// summed, so the owner can evict down to a memory budget.
+class ChunkStorage {
+public:
+    // `regenerable`: the chunk can be rebuilt from its key alone (e.g.
+    // untouched procedural terrain) until markEdited() is called on it.
+    ChunkHandle insert(Chunk chunk, std::uint64_t editGeneration, bool regenerable = false);
+    // Takes the chunk out of the resident grid first if it is resident.
+    bool erase(ChunkHandle handle);
+    void clear();
+
+    [[nodiscard]] bool contains(ChunkHandle handle) const;
+    // The chunk wherever it currently lives: its resident grid entry or its slot.
+    [[nodiscard]] Chunk* find(ChunkHandle handle);
+    [[nodiscard]] const Chunk* find(ChunkHandle handle) const;
+    [[nodiscard]] std::uint64_t editGeneration(ChunkHandle handle) const;
+    [[nodiscard]] bool isRegenerable(ChunkHandle handle) const;
+    // Call after changing the chunk's voxels: records the generation, clears
+    // regenerable, and for a non-resident chunk re-measures it and makes it
+    // the most recently used.
+    void markEdited(ChunkHandle handle, std::uint64_t editGeneration);
+
+    [[nodiscard]] bool isResident(ChunkHandle handle) const;
+    // Appends the chunk to the resident grid and returns its grid index.
+    std::size_t makeResident(ChunkHandle handle);
+    // The last resident chunk takes over the vacated grid index; every other
+    // resident chunk keeps its index.
+    void makeNonResident(ChunkHandle handle);
+    [[nodiscard]] ChunkHandle residentHandle(std::size_t residentIndex) const;
+
+    [[nodiscard]] std::size_t size() const;
+    // The non-resident chunk to evict first, or an invalid handle.
+    [[nodiscard]] ChunkHandle leastRecentlyUsed() const;
+    // Chunk::memoryFootprintBytes() summed over non-resident chunks.
+    [[nodiscard]] std::uint64_t nonResidentBytes() const;
+    // fn(handle, chunk, editGeneration) for every stored chunk, in slot order.
+    template <typename Fn>
+    void forEach(Fn&& fn) const;
+
+    ChunkGrid& residentGrid();
+    const ChunkGrid& residentGrid() const;
+
+private:
+    static constexpr std::uint32_t kNotResident = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t kNoSlot = std::numeric_limits<std::uint32_t>::max();
+
+    struct Slot {
+        // Moved-from (empty) while the chunk is resident.
+        Chunk chunk;
+        std::uint64_t editGeneration = 0;
+        // Footprint counted in m_nonResidentBytes while non-resident.
+        std::uint64_t footprintBytes = 0;
+        std::uint32_t generation = 0;
+        std::uint32_t residentIndex = kNotResident;
+        // Non-resident LRU list links.
+        std::uint32_t lruPrev = kNoSlot;
+        std::uint32_t lruNext = kNoSlot;
+        bool regenerable = false;
+        bool live = false;
+    };
+
+    Slot* liveSlot(ChunkHandle handle);
+    const Slot* liveSlot(ChunkHandle handle) const;
+    // Append as most recently used / remove; both keep m_nonResidentBytes.
+    void linkLru(std::uint32_t slotIndex);
+    void unlinkLru(std::uint32_t slotIndex);
+
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_freeSlots;
+    std::size_t m_liveCount = 0;
+    std::uint32_t m_lruHead = kNoSlot;
+    std::uint32_t m_lruTail = kNoSlot;
+    std::uint64_t m_nonResidentBytes = 0;
+    ChunkGrid m_residentGrid;
+    // Parallel to m_residentGrid.chunks(): the slot each resident chunk belongs to.
+    std::vector<std::uint32_t> m_residentSlots;
+};
+
+inline ChunkHandle ChunkStorage::insert(Chunk chunk, std::uint64_t editGeneration, bool regenerable) {
+    std::uint32_t slotIndex = 0;
+    if (!m_freeSlots.empty()) {
+        slotIndex = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slotIndex = static_cast<std::uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    Slot& slot = m_slots[slotIndex];
+    slot.chunk = std::move(chunk);
+    slot.editGeneration = editGeneration;
+    slot.residentIndex = kNotResident;
+    slot.regenerable = regenerable;
+    slot.live = true;
+    ++m_liveCount;
+    linkLru(slotIndex);
+    return ChunkHandle{slotIndex, slot.generation};
+}
+
+inline bool ChunkStorage::erase(ChunkHandle handle) {
+    Slot* slot = liveSlot(handle);
+    if (slot == nullptr) {
+        return false;
+    }
+    if (slot->residentIndex != kNotResident) {
+        makeNonResident(handle);
+    }
+    unlinkLru(handle.slot);
+    // Moving out frees the voxel data; assigning a fresh Chunk would allocate.
+    { Chunk released = std::move(slot->chunk); }
+    slot->live = false;
+    ++slot->generation;
+    m_freeSlots.push_back(handle.slot);
+    --m_liveCount;
+    return true;
+}
+
+inline void ChunkStorage::clear() {
+    // Generations survive a clear so handles from before it stay stale.
+    m_freeSlots.clear();
+    for (std::uint32_t slotIndex = static_cast<std::uint32_t>(m_slots.size()); slotIndex-- > 0;) {
+        Slot& slot = m_slots[slotIndex];
+        if (slot.live) {
+            { Chunk released = std::move(slot.chunk); }
+            slot.live = false;
+            ++slot.generation;
+        }
+        slot.residentIndex = kNotResident;
+        slot.lruPrev = kNoSlot;
+        slot.lruNext = kNoSlot;
+        slot.footprintBytes = 0;
+        m_freeSlots.push_back(slotIndex);
+    }
+    m_liveCount = 0;
+    m_lruHead = kNoSlot;
+    m_lruTail = kNoSlot;
+    m_nonResidentBytes = 0;
+    m_residentGrid.chunks().clear();
+    m_residentSlots.clear();
+}
+
+inline bool ChunkStorage::contains(ChunkHandle handle) const {
+    return liveSlot(handle) != nullptr;
+}
+
+inline Chunk* ChunkStorage::find(ChunkHandle handle) {
+    Slot* slot = liveSlot(handle);
+    if (slot == nullptr) {
+        return nullptr;
+    }
+    return (slot->residentIndex != kNotResident) ? &m_residentGrid.chunks()[slot->residentIndex] : &slot->chunk;
+}
+
+inline const Chunk* ChunkStorage::find(ChunkHandle handle) const {
+    const Slot* slot = liveSlot(handle);
+    if (slot == nullptr) {
+        return nullptr;
+    }
+    return (slot->residentIndex != kNotResident) ? &m_residentGrid.chunks()[slot->residentIndex] : &slot->chunk;
+}
+
+inline std::uint64_t ChunkStorage::editGeneration(ChunkHandle handle) const {
+    const Slot* slot = liveSlot(handle);
+    return (slot != nullptr) ? slot->editGeneration : 0u;
+}
+
+inline bool ChunkStorage::isRegenerable(ChunkHandle handle) const {
+    const Slot* slot = liveSlot(handle);
+    return slot != nullptr && slot->regenerable;
+}
+
+inline void ChunkStorage::markEdited(ChunkHandle handle, std::uint64_t editGeneration) {
+    Slot* slot = liveSlot(handle);
+    if (slot == nullptr) {
+        return;
+    }
+    slot->editGeneration = editGeneration;
+    slot->regenerable = false;
+    if (slot->residentIndex == kNotResident) {
+        unlinkLru(handle.slot);
+        linkLru(handle.slot);
+    }
+}
+
+inline bool ChunkStorage::isResident(ChunkHandle handle) const {
+    const Slot* slot = liveSlot(handle);
+    return slot != nullptr && slot->residentIndex != kNotResident;
+}
+
+inline std::size_t ChunkStorage::makeResident(ChunkHandle handle) {
+    Slot* slot = liveSlot(handle);
+    if (slot == nullptr) {
+        return m_residentGrid.chunkCount();
+    }
+    if (slot->residentIndex != kNotResident) {
+        return slot->residentIndex;
+    }
+    unlinkLru(handle.slot);
+    const std::size_t residentIndex = m_residentGrid.chunkCount();
+    m_residentGrid.chunks().push_back(std::move(slot->chunk));
+    m_residentSlots.push_back(handle.slot);
+    slot->residentIndex = static_cast<std::uint32_t>(residentIndex);
+    return residentIndex;
+}
+
+inline void ChunkStorage::makeNonResident(ChunkHandle handle) {
+    Slot* slot = liveSlot(handle);
+    if (slot == nullptr || slot->residentIndex == kNotResident) {
+        return;
+    }
+    std::vector<Chunk>& residentChunks = m_residentGrid.chunks();
+    const std::size_t residentIndex = slot->residentIndex;
+    const std::size_t lastIndex = residentChunks.size() - 1u;
+    slot->chunk = std::move(residentChunks[residentIndex]);
+    slot->residentIndex = kNotResident;
+    if (residentIndex != lastIndex) {
+        residentChunks[residentIndex] = std::move(residentChunks[lastIndex]);
+        m_residentSlots[residentIndex] = m_residentSlots[lastIndex];
+        m_slots[m_residentSlots[residentIndex]].residentIndex = static_cast<std::uint32_t>(residentIndex);
+    }
+    residentChunks.pop_back();
+    m_residentSlots.pop_back();
+    linkLru(handle.slot);
+}
+
+inline ChunkHandle ChunkStorage::residentHandle(std::size_t residentIndex) const {
+    if (residentIndex >= m_residentSlots.size()) {
+        return ChunkHandle{};
+    }
+    const std::uint32_t slotIndex = m_residentSlots[residentIndex];
+    return ChunkHandle{slotIndex, m_slots[slotIndex].generation};
+}
+
+inline std::size_t ChunkStorage::size() const {
+    return m_liveCount;
+}
+
+inline ChunkHandle ChunkStorage::leastRecentlyUsed() const {
+    if (m_lruHead == kNoSlot) {
+        return ChunkHandle{};
+    }
+    return ChunkHandle{m_lruHead, m_slots[m_lruHead].generation};
+}
+
+inline std::uint64_t ChunkStorage::nonResidentBytes() const {
+    return m_nonResidentBytes;
+}
+
+template <typename Fn>
+void ChunkStorage::forEach(Fn&& fn) const {
+    for (std::uint32_t slotIndex = 0; slotIndex < static_cast<std::uint32_t>(m_slots.size()); ++slotIndex) {
+        const Slot& slot = m_slots[slotIndex];
+        if (!slot.live) {
+            continue;
+        }
+        const Chunk& chunk =
+            (slot.residentIndex != kNotResident) ? m_residentGrid.chunks()[slot.residentIndex] : slot.chunk;
+        fn(ChunkHandle{slotIndex, slot.generation}, chunk, slot.editGeneration);
+    }
+}
+
+inline ChunkGrid& ChunkStorage::residentGrid() {
+    return m_residentGrid;
+}
+
+inline const ChunkGrid& ChunkStorage::residentGrid() const {
+    return m_residentGrid;
+}
+
+inline void ChunkStorage::linkLru(std::uint32_t slotIndex) {
+    Slot& slot = m_slots[slotIndex];
+    slot.footprintBytes = slot.chunk.memoryFootprintBytes();
+    m_nonResidentBytes += slot.footprintBytes;
+    slot.lruPrev = m_lruTail;
+    slot.lruNext = kNoSlot;
+    if (m_lruTail != kNoSlot) {
+        m_slots[m_lruTail].lruNext = slotIndex;
+    } else {
+        m_lruHead = slotIndex;
+    }
+    m_lruTail = slotIndex;
+}
+
+inline void ChunkStorage::unlinkLru(std::uint32_t slotIndex) {
+    Slot& slot = m_slots[slotIndex];
+    m_nonResidentBytes -= slot.footprintBytes;
+    slot.footprintBytes = 0;
+    if (slot.lruPrev != kNoSlot) {
+        m_slots[slot.lruPrev].lruNext = slot.lruNext;
+    } else {
+        m_lruHead = slot.lruNext;
+    }
+    if (slot.lruNext != kNoSlot) {
+        m_slots[slot.lruNext].lruPrev = slot.lruPrev;
+    } else {
+        m_lruTail = slot.lruPrev;
+    }
+    slot.lruPrev = kNoSlot;
+    slot.lruNext = kNoSlot;
+}
+
+inline ChunkStorage::Slot* ChunkStorage::liveSlot(ChunkHandle handle) {
+    if (handle.slot >= m_slots.size()) {
+        return nullptr;
+    }
+    Slot& slot = m_slots[handle.slot];
+    return (slot.live && slot.generation == handle.generation) ? &slot : nullptr;
+}
+
+inline const ChunkStorage::Slot* ChunkStorage::liveSlot(ChunkHandle handle) const {
+    if (handle.slot >= m_slots.size()) {
+        return nullptr;
+    }
+    const Slot& slot = m_slots[handle.slot];
+    return (slot.live && slot.generation == handle.generation) ? &slot : nullptr;
+}
+
+} // namespace odai::world
@@ -30,11 +30,18 @@ std::int32_t floorToCell(float value) {
     return static_cast<std::int32_t>(std::floor(value));
 }
 
+std::int32_t floorDivide(std::int32_t value, std::int32_t divisor) {
+    const std::int32_t quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
 } // namespace
 
 void ChunkClipmapIndex::clear() {
     m_chunkBounds.clear();
     m_allChunkIndices.clear();
+    m_chunkIndexByCoord.clear();
+    m_lastSyncedChunkCount = 0;
     m_worldBounds = {};
     m_levels.clear();
     m_valid = false;
@@ -54,9 +61,11 @@ void ChunkClipmapIndex::rebuild(const ChunkGrid& chunkGrid) {
 void ChunkClipmapIndex::syncResidentChunks(const ChunkGrid& chunkGrid) {
     m_chunkBounds.clear();
     m_allChunkIndices.clear();
+    m_chunkIndexByCoord.clear();
     m_worldBounds = {};
 
     const std::vector<Chunk>& chunks = chunkGrid.chunks();
+    m_lastSyncedChunkCount = chunks.size();
     if (chunks.empty()) {
         m_valid = false;
         return;
@@ -64,16 +73,98 @@ void ChunkClipmapIndex::syncResidentChunks(const ChunkGrid& chunkGrid) {
 
     m_chunkBounds.resize(chunks.size());
     m_allChunkIndices.resize(chunks.size());
+    m_chunkIndexByCoord.reserve(chunks.size());
     for (std::size_t chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex) {
-        const odai::core::CellAabb chunkBounds = chunkBoundsFromChunk(chunks[chunkIndex]);
-        m_chunkBounds[chunkIndex] = chunkBounds;
+        setResidentChunk(chunkIndex, chunks[chunkIndex]);
         m_allChunkIndices[chunkIndex] = chunkIndex;
-        m_worldBounds.includeAabb(chunkBounds);
+        m_worldBounds.includeAabb(m_chunkBounds[chunkIndex]);
     }
 
     m_valid = !m_levels.empty() && m_worldBounds.valid && !m_worldBounds.empty();
 }
 
+void ChunkClipmapIndex::syncResidentChunks(const ChunkGrid& chunkGrid, const World::ChunkStreamingUpdate& update) {
+    const std::vector<Chunk>& chunks = chunkGrid.chunks();
+    const std::size_t oldCount = m_chunkBounds.size();
+    const std::size_t enteredCount = update.residentChunkIndicesNeedingUpload.size();
+    std::vector<std::size_t> vacatedIndices;
+    vacatedIndices.reserve(update.exitedChunkKeys.size());
+    for (const World::ChunkKey& key : update.exitedChunkKeys) {
+        const auto indexIt = m_chunkIndexByCoord.find(odai::core::Cell3i{key.chunkX, key.chunkY, key.chunkZ});
+        if (indexIt == m_chunkIndexByCoord.end()) {
+            break;
+        }
+        vacatedIndices.push_back(indexIt->second);
+    }
+    const bool consistent =
+        oldCount > 0 && !update.requiresFullMeshUpload && vacatedIndices.size() == update.exitedChunkKeys.size() &&
+        oldCount - vacatedIndices.size() + enteredCount == chunks.size() &&
+        std::all_of(
+            update.residentChunkIndicesNeedingUpload.begin(),
+            update.residentChunkIndicesNeedingUpload.end(),
+            [&](std::size_t enteredIndex) { return enteredIndex < chunks.size(); }
+        );
+    if (!consistent) {
+        syncResidentChunks(chunkGrid);
+        return;
+    }
+
+    // Leaving chunks are swap-removed from the grid, so every slot whose chunk
+    // changed held a leaving chunk before the update (or is new at the end):
+    // a slot only receives a moved chunk when the chunk in it leaves.
+    for (const World::ChunkKey& key : update.exitedChunkKeys) {
+        m_chunkIndexByCoord.erase(odai::core::Cell3i{key.chunkX, key.chunkY, key.chunkZ});
+    }
+    bool boundsShrank = false;
+    for (const std::size_t vacatedIndex : vacatedIndices) {
+        const odai::core::CellAabb& vacated = m_chunkBounds[vacatedIndex];
+        boundsShrank = boundsShrank ||
+                       vacated.minInclusive.x == m_worldBounds.minInclusive.x ||
+                       vacated.minInclusive.y == m_worldBounds.minInclusive.y ||
+                       vacated.minInclusive.z == m_worldBounds.minInclusive.z ||
+                       vacated.maxExclusive.x == m_worldBounds.maxExclusive.x ||
+                       vacated.maxExclusive.y == m_worldBounds.maxExclusive.y ||
+                       vacated.maxExclusive.z == m_worldBounds.maxExclusive.z;
+    }
+
+    m_chunkBounds.resize(chunks.size());
+    m_allChunkIndices.resize(chunks.size());
+    std::size_t syncedCount = 0;
+    const auto resync = [&](std::size_t chunkIndex) {
+        setResidentChunk(chunkIndex, chunks[chunkIndex]);
+        m_allChunkIndices[chunkIndex] = chunkIndex;
+        m_worldBounds.includeAabb(m_chunkBounds[chunkIndex]);
+        ++syncedCount;
+    };
+    // Vacated slots past the surviving chunks hold entered chunks, read below.
+    const std::size_t survivingCount = oldCount - vacatedIndices.size();
+    for (const std::size_t vacatedIndex : vacatedIndices) {
+        if (vacatedIndex < survivingCount) {
+            resync(vacatedIndex);
+        }
+    }
+    for (const std::size_t enteredIndex : update.residentChunkIndicesNeedingUpload) {
+        resync(enteredIndex);
+    }
+    if (boundsShrank) {
+        recomputeWorldBounds();
+    }
+    m_lastSyncedChunkCount = syncedCount;
+    m_valid = !m_levels.empty() && m_worldBounds.valid && !m_worldBounds.empty();
+}
+
+void ChunkClipmapIndex::setResidentChunk(std::size_t chunkIndex, const Chunk& chunk) {
+    m_chunkBounds[chunkIndex] = chunkBoundsFromChunk(chunk);
+    m_chunkIndexByCoord[odai::core::Cell3i{chunk.chunkX(), chunk.chunkY(), chunk.chunkZ()}] = chunkIndex;
+}
+
+void ChunkClipmapIndex::recomputeWorldBounds() {
+    m_worldBounds = {};
+    for (const odai::core::CellAabb& chunkBounds : m_chunkBounds) {
+        m_worldBounds.includeAabb(chunkBounds);
+    }
+}
+
 void ChunkClipmapIndex::setConfig(const ClipmapConfig& config) {
     ClipmapConfig clamped = config;
     clamped.levelCount = std::clamp<std::uint32_t>(clamped.levelCount, 1u, 10u);
@@ -111,6 +202,10 @@ const std::vector<std::size_t>& ChunkClipmapIndex::allChunkIndices() const {
     return m_allChunkIndices;
 }
 
+std::size_t ChunkClipmapIndex::lastSyncedChunkCount() const {
+    return m_lastSyncedChunkCount;
+}
+
 void ChunkClipmapIndex::updateCamera(float cameraX, float cameraY, float cameraZ, SpatialQueryStats* outStats) {
     if (outStats != nullptr) {
         *outStats = SpatialQueryStats{};
@@ -262,41 +357,72 @@ void ChunkClipmapIndex::updateCamera(float cameraX, float cameraY, float cameraZ
     }
 }
 
-std::vector<std::size_t> ChunkClipmapIndex::queryChunksIntersecting(
+void ChunkClipmapIndex::queryChunksIntersecting(
     const odai::core::CellAabb& bounds,
+    std::vector<std::size_t>& outChunkIndices,
     SpatialQueryStats* outStats
 ) const {
-    std::vector<std::size_t> result;
+    outChunkIndices.clear();
     if (outStats != nullptr) {
         *outStats = SpatialQueryStats{};
     }
     if (!m_valid || m_levels.empty() || !bounds.valid || bounds.empty()) {
-        return result;
+        return;
     }
 
     const odai::core::CellAabb clipmapBounds = m_levels.back().bounds;
     if (!aabbIntersects(clipmapBounds, bounds)) {
-        return result;
+        return;
     }
     const odai::core::CellAabb effectiveBounds = odai::core::intersectAabb(clipmapBounds, bounds);
     if (!effectiveBounds.valid || effectiveBounds.empty()) {
-        return result;
+        return;
     }
 
-    result.reserve(m_chunkBounds.size());
+    const odai::core::Cell3i minChunk{
+        floorDivide(effectiveBounds.minInclusive.x, Chunk::kSizeX),
+        floorDivide(effectiveBounds.minInclusive.y, Chunk::kSizeY),
+        floorDivide(effectiveBounds.minInclusive.z, Chunk::kSizeZ)
+    };
+    const odai::core::Cell3i maxChunk{
+        floorDivide(effectiveBounds.maxExclusive.x - 1, Chunk::kSizeX),
+        floorDivide(effectiveBounds.maxExclusive.y - 1, Chunk::kSizeY),
+        floorDivide(effectiveBounds.maxExclusive.z - 1, Chunk::kSizeZ)
+    };
+    const std::uint64_t coveredChunkCount =
+        static_cast<std::uint64_t>(maxChunk.x - minChunk.x + 1) *
+        static_cast<std::uint64_t>(maxChunk.y - minChunk.y + 1) *
+        static_cast<std::uint64_t>(maxChunk.z - minChunk.z + 1);
+
     std::uint32_t candidateCount = 0;
-    for (std::size_t chunkIndex = 0; chunkIndex < m_chunkBounds.size(); ++chunkIndex) {
-        if (!aabbIntersects(m_chunkBounds[chunkIndex], effectiveBounds)) {
-            continue;
+    if (coveredChunkCount < m_chunkBounds.size()) {
+        // Every chunk in a covered cell intersects the bounds.
+        for (std::int32_t chunkY = minChunk.y; chunkY <= maxChunk.y; ++chunkY) {
+            for (std::int32_t chunkZ = minChunk.z; chunkZ <= maxChunk.z; ++chunkZ) {
+                for (std::int32_t chunkX = minChunk.x; chunkX <= maxChunk.x; ++chunkX) {
+                    const auto indexIt = m_chunkIndexByCoord.find(odai::core::Cell3i{chunkX, chunkY, chunkZ});
+                    if (indexIt == m_chunkIndexByCoord.end()) {
+                        continue;
+                    }
+                    ++candidateCount;
+                    outChunkIndices.push_back(indexIt->second);
+                }
+            }
+        }
+        std::sort(outChunkIndices.begin(), outChunkIndices.end());
+    } else {
+        for (std::size_t chunkIndex = 0; chunkIndex < m_chunkBounds.size(); ++chunkIndex) {
+            ++candidateCount;
+            if (aabbIntersects(m_chunkBounds[chunkIndex], effectiveBounds)) {
+                outChunkIndices.push_back(chunkIndex);
+            }
         }
-        ++candidateCount;
-        result.push_back(chunkIndex);
     }
 
     if (outStats != nullptr) {
         outStats->visitedNodeCount = static_cast<std::uint32_t>(m_levels.size());
         outStats->candidateChunkCount = candidateCount;
-        outStats->visibleChunkCount = static_cast<std::uint32_t>(result.size());
+        outStats->visibleChunkCount = static_cast<std::uint32_t>(outChunkIndices.size());
         outStats->clipmapActiveLevelCount = static_cast<std::uint32_t>(m_levels.size());
         outStats->clipmapUpdatedLevelCount = m_lastUpdatedLevelCount;
         outStats->clipmapUpdatedSlabCount = m_lastUpdatedSlabCount;
@@ -307,6 +433,14 @@ std::vector<std::size_t> ChunkClipmapIndex::queryChunksIntersecting(
         }
         outStats->clipmapResidentBrickCount = residentBricks;
     }
+}
+
+std::vector<std::size_t> ChunkClipmapIndex::queryChunksIntersecting(
+    const odai::core::CellAabb& bounds,
+    SpatialQueryStats* outStats
+) const {
+    std::vector<std::size_t> result;
+    queryChunksIntersecting(bounds, result, outStats);
     return result;
 }
 
@@ -2,11 +2,14 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 #include "core/grid3.h"
+#include "core/hash.h"
 #include "world/chunk_grid.h"
 #include "world/spatial_index.h"
+#include "world/world.h"
 
 // World ClipmapIndex subsystem
 // Responsible for: deterministic camera-centered clipmap bounds + chunk broad-phase lookup.
@@ -25,6 +28,11 @@ public:
     void clear();
     void rebuild(const ChunkGrid& chunkGrid);
     void syncResidentChunks(const ChunkGrid& chunkGrid);
+    // Applies one streaming update to the index built for the grid before it:
+    // re-reads only the entered chunks and the slots leaving chunks vacated.
+    // Falls back to the full rescan above when the counts do not add up,
+    // e.g. after the grid was replaced wholesale.
+    void syncResidentChunks(const ChunkGrid& chunkGrid, const World::ChunkStreamingUpdate& update);
     void setConfig(const ClipmapConfig& config);
 
     [[nodiscard]] const ClipmapConfig& config() const;
@@ -32,10 +40,20 @@ public:
     [[nodiscard]] std::size_t chunkCount() const;
     [[nodiscard]] const odai::core::CellAabb& worldBounds() const;
     [[nodiscard]] const std::vector<std::size_t>& allChunkIndices() const;
+    // Resident chunks the last sync read from the grid.
+    [[nodiscard]] std::size_t lastSyncedChunkCount() const;
 
     void updateCamera(float cameraX, float cameraY, float cameraZ, SpatialQueryStats* outStats = nullptr);
 
     // Query chunks intersecting the frustum broad-phase bounds and inside the active clipmap extents.
+    // Writes ascending resident indices into `outChunkIndices`, replacing its contents and reusing
+    // its capacity. Small bounds look up the chunk cells they cover instead of testing every
+    // resident chunk; candidateChunkCount reports how many chunks were tested.
+    void queryChunksIntersecting(
+        const odai::core::CellAabb& bounds,
+        std::vector<std::size_t>& outChunkIndices,
+        SpatialQueryStats* outStats = nullptr
+    ) const;
     [[nodiscard]] std::vector<std::size_t> queryChunksIntersecting(
         const odai::core::CellAabb& bounds,
         SpatialQueryStats* outStats = nullptr
@@ -56,6 +74,8 @@ private:
         odai::core::Cell3i originMin{};
         BrickCoord originBrickMin{};
         odai::core::CellAabb bounds{};
+        // Toroidal: absolute brick b lives at slot positiveModulo(b, brickGridResolution) on each
+        // axis, so a scroll rewrites only the slabs of bricks that entered, in place.
         std::vector<std::uint32_t> brickVersions;
         std::vector<std::uint8_t> brickDirtyMask;
         std::vector<odai::core::Cell3i> dirtyBrickRingQueue;
@@ -71,8 +91,14 @@ private:
     void markBrickDirtyAbsolute(ClipmapLevel& level, const BrickCoord& absoluteBrickCoord);
     std::uint32_t processDirtyBricks(ClipmapLevel& level);
 
+    void setResidentChunk(std::size_t chunkIndex, const Chunk& chunk);
+    void recomputeWorldBounds();
+
     std::vector<odai::core::CellAabb> m_chunkBounds;
     std::vector<std::size_t> m_allChunkIndices;
+    // Resident index of each chunk, keyed by chunk coordinates.
+    std::unordered_map<odai::core::Cell3i, std::size_t, odai::core::Cell3Hash> m_chunkIndexByCoord;
+    std::size_t m_lastSyncedChunkCount = 0;
     odai::core::CellAabb m_worldBounds{};
     ClipmapConfig m_config{};
     std::vector<ClipmapLevel> m_levels;
@@ -377,6 +377,7 @@ inline odai::core::CellAabb copyVolumeSolidsToChunk(const CsgVolume& volume, Chu
         return touched;
     }
 
+    chunk.beginEdit();
     for (std::int32_t y = overlap.minInclusive.y; y < overlap.maxExclusive.y; ++y) {
         for (std::int32_t z = overlap.minInclusive.z; z < overlap.maxExclusive.z; ++z) {
             for (std::int32_t x = overlap.minInclusive.x; x < overlap.maxExclusive.x; ++x) {
@@ -396,6 +397,7 @@ inline odai::core::CellAabb copyVolumeSolidsToChunk(const CsgVolume& volume, Chu
             }
         }
     }
+    chunk.endEdit();
 
     return touched;
 }
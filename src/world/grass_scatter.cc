@@ -1,11 +1,128 @@
 #include "world/grass_scatter.h"
 
+#include "core/parallel_for.h"
+
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 namespace odai::world {
 
+namespace {
+
+// Appends the clumps grown by the grass voxel at (x, y, z); the caller has
+// checked that it is Grass with air above.
+void appendGrassVoxelInstances(const Chunk& chunk, int x, int y, int z, std::vector<GrassInstance>& out) {
+    const float chunkWorldX = static_cast<float>(chunk.chunkX() * Chunk::kSizeX);
+    const float chunkWorldY = static_cast<float>(chunk.chunkY() * Chunk::kSizeY);
+    const float chunkWorldZ = static_cast<float>(chunk.chunkZ() * Chunk::kSizeZ);
+
+    const std::uint32_t hash =
+        static_cast<std::uint32_t>(x * 73856093) ^
+        static_cast<std::uint32_t>(y * 19349663) ^
+        static_cast<std::uint32_t>(z * 83492791) ^
+        static_cast<std::uint32_t>((chunk.chunkX() + 101) * 2654435761u) ^
+        static_cast<std::uint32_t>((chunk.chunkZ() + 193) * 2246822519u);
+    // Keep grass sparse and deterministic so placement feels natural and stable.
+    if ((hash % 100u) >= 22u) {
+        return;
+    }
+    const int clumpCount = 2 + static_cast<int>((hash >> 24u) & 0x1u);
+    for (int clumpIndex = 0; clumpIndex < clumpCount; ++clumpIndex) {
+        const std::uint32_t clumpHash = hash ^ (0x9E3779B9u * static_cast<std::uint32_t>(clumpIndex + 1));
+        const float rand0 = static_cast<float>(clumpHash & 0xFFu) / 255.0f;
+        const float rand1 = static_cast<float>((clumpHash >> 8u) & 0xFFu) / 255.0f;
+        const float rand2 = static_cast<float>((clumpHash >> 16u) & 0xFFu) / 255.0f;
+        const float rand3 = static_cast<float>((clumpHash >> 24u) & 0xFFu) / 255.0f;
+        const std::uint32_t tintHash = clumpHash ^ 0x85EBCA6Bu;
+        const float tintRand0 = static_cast<float>(tintHash & 0xFFu) / 255.0f;
+        const float tintRand1 = static_cast<float>((tintHash >> 8u) & 0xFFu) / 255.0f;
+        const float tintRand2 = static_cast<float>((tintHash >> 16u) & 0xFFu) / 255.0f;
+        const float radial = 0.06f + (0.18f * rand2);
+        const float angle = rand1 * (2.0f * 3.14159265f);
+        const float jitterX = std::cos(angle) * radial;
+        const float jitterZ = std::sin(angle) * radial;
+        const float yawRadians = rand0 * (2.0f * 3.14159265f);
+        const float yJitter = rand3 * 0.08f;
+
+        GrassInstance instance{};
+        instance.worldPosYaw[0] = chunkWorldX + static_cast<float>(x) + 0.5f + jitterX;
+        // Lift slightly above the supporting voxel top to avoid depth tie flicker.
+        instance.worldPosYaw[1] = chunkWorldY + static_cast<float>(y) + 1.02f + yJitter;
+        instance.worldPosYaw[2] = chunkWorldZ + static_cast<float>(z) + 0.5f + jitterZ;
+        instance.worldPosYaw[3] = yawRadians;
+        // Mostly green bushes, with some flowers.
+        const bool placeFlower = ((clumpHash >> 5u) % 100u) < 18u;
+        if (placeFlower) {
+            // Bias strongly toward poppies (tiles 1-2), with rarer lighter wildflowers (3-4).
+            const bool choosePoppy = ((clumpHash >> 13u) % 100u) < 74u;
+            const std::uint32_t flowerTile = choosePoppy
+                ? (1u + ((clumpHash >> 9u) & 0x1u))
+                : (3u + ((clumpHash >> 10u) & 0x1u));
+            if (choosePoppy) {
+                const float poppyBoost = 0.96f + (tintRand1 * 0.10f);
+                instance.colorTint[0] = (0.92f + (tintRand0 * 0.14f)) * poppyBoost;
+                instance.colorTint[1] = (0.92f + (tintRand2 * 0.14f)) * poppyBoost;
+                instance.colorTint[2] = (0.92f + (tintRand1 * 0.14f)) * poppyBoost;
+            } else {
+                const float flowerBoost = 0.94f + (tintRand1 * 0.12f);
+                instance.colorTint[0] = (0.94f + (tintRand0 * 0.14f)) * flowerBoost;
+                instance.colorTint[1] = (0.94f + (tintRand2 * 0.14f)) * flowerBoost;
+                instance.colorTint[2] = (0.94f + (tintRand1 * 0.14f)) * flowerBoost;
+            }
+            instance.colorTint[3] = static_cast<float>(flowerTile);
+        } else {
+            // Golden grass variation.
+            const float warmBias = 0.50f + (0.50f * tintRand0);
+            const float dryBias = tintRand2;
+            const float brightness = 0.82f + (tintRand1 * 0.32f);
+            const float redBase = std::lerp(0.90f, 1.28f, warmBias);
+            const float greenBase = std::lerp(0.98f, 1.36f, (warmBias * 0.70f) + (dryBias * 0.30f));
+            const float blueBase = std::lerp(0.56f, 0.20f, warmBias);
+            instance.colorTint[0] = redBase * brightness;
+            instance.colorTint[1] = greenBase * brightness;
+            instance.colorTint[2] = blueBase * brightness;
+            instance.colorTint[3] = 4.0f;
+        }
+        out.push_back(instance);
+    }
+}
+
+// Appends every instance of column (x, z) in increasing y. Uniform macro cells
+// of any type but Grass hold no grass voxels and are skipped whole.
+std::size_t appendGrassColumnInstances(const Chunk& chunk, int x, int z, std::vector<GrassInstance>& out) {
+    const std::size_t sizeBefore = out.size();
+    const int macroX = x / Chunk::kMacroVoxelSize;
+    const int macroZ = z / Chunk::kMacroVoxelSize;
+    for (int macroY = 0; macroY < Chunk::kMacroSizeY; ++macroY) {
+        const Chunk::MacroCell cell = chunk.macroCellAt(macroX, macroY, macroZ);
+        if (cell.resolution == Chunk::CellResolution::Uniform && cell.voxel.type != VoxelType::Grass) {
+            continue;
+        }
+        const int yBegin = macroY * Chunk::kMacroVoxelSize;
+        const int yEnd = std::min(yBegin + Chunk::kMacroVoxelSize, Chunk::kSizeY - 1);
+        for (int y = yBegin; y < yEnd; ++y) {
+            if (chunk.voxelAt(x, y, z).type != VoxelType::Grass) {
+                continue;
+            }
+            if (chunk.voxelAt(x, y + 1, z).type != VoxelType::Empty) {
+                continue;
+            }
+            appendGrassVoxelInstances(chunk, x, y, z, out);
+        }
+    }
+    return out.size() - sizeBefore;
+}
+
+int floorDivide(int value, int divisor) {
+    const int quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+} // namespace
+
 std::vector<GrassInstance> buildGrassInstances(const Chunk& chunk, const GrassScatterParams& params) {
     std::vector<GrassInstance> grassInstances;
     const int grassDistanceX = std::abs(chunk.chunkX() - params.residentCenterChunkX);
@@ -16,10 +133,6 @@ std::vector<GrassInstance> buildGrassInstances(const Chunk& chunk, const GrassSc
     }
     grassInstances.reserve(448);
 
-    const float chunkWorldX = static_cast<float>(chunk.chunkX() * Chunk::kSizeX);
-    const float chunkWorldY = static_cast<float>(chunk.chunkY() * Chunk::kSizeY);
-    const float chunkWorldZ = static_cast<float>(chunk.chunkZ() * Chunk::kSizeZ);
-
     for (int y = 0; y < Chunk::kSizeY - 1; ++y) {
         for (int z = 0; z < Chunk::kSizeZ; ++z) {
             for (int x = 0; x < Chunk::kSizeX; ++x) {
@@ -30,79 +143,209 @@ std::vector<GrassInstance> buildGrassInstances(const Chunk& chunk, const GrassSc
                     continue;
                 }
 
-                const std::uint32_t hash =
-                    static_cast<std::uint32_t>(x * 73856093) ^
-                    static_cast<std::uint32_t>(y * 19349663) ^
-                    static_cast<std::uint32_t>(z * 83492791) ^
-                    static_cast<std::uint32_t>((chunk.chunkX() + 101) * 2654435761u) ^
-                    static_cast<std::uint32_t>((chunk.chunkZ() + 193) * 2246822519u);
-                // Keep grass sparse and deterministic so placement feels natural and stable.
-                if ((hash % 100u) >= 22u) {
-                    continue;
-                }
-                const int clumpCount = 2 + static_cast<int>((hash >> 24u) & 0x1u);
-                for (int clumpIndex = 0; clumpIndex < clumpCount; ++clumpIndex) {
-                    const std::uint32_t clumpHash = hash ^ (0x9E3779B9u * static_cast<std::uint32_t>(clumpIndex + 1));
-                    const float rand0 = static_cast<float>(clumpHash & 0xFFu) / 255.0f;
-                    const float rand1 = static_cast<float>((clumpHash >> 8u) & 0xFFu) / 255.0f;
-                    const float rand2 = static_cast<float>((clumpHash >> 16u) & 0xFFu) / 255.0f;
-                    const float rand3 = static_cast<float>((clumpHash >> 24u) & 0xFFu) / 255.0f;
-                    const std::uint32_t tintHash = clumpHash ^ 0x85EBCA6Bu;
-                    const float tintRand0 = static_cast<float>(tintHash & 0xFFu) / 255.0f;
-                    const float tintRand1 = static_cast<float>((tintHash >> 8u) & 0xFFu) / 255.0f;
-                    const float tintRand2 = static_cast<float>((tintHash >> 16u) & 0xFFu) / 255.0f;
-                    const float radial = 0.06f + (0.18f * rand2);
-                    const float angle = rand1 * (2.0f * 3.14159265f);
-                    const float jitterX = std::cos(angle) * radial;
-                    const float jitterZ = std::sin(angle) * radial;
-                    const float yawRadians = rand0 * (2.0f * 3.14159265f);
-                    const float yJitter = rand3 * 0.08f;
-
-                    GrassInstance instance{};
-                    instance.worldPosYaw[0] = chunkWorldX + static_cast<float>(x) + 0.5f + jitterX;
-                    // Lift slightly above the supporting voxel top to avoid depth tie flicker.
-                    instance.worldPosYaw[1] = chunkWorldY + static_cast<float>(y) + 1.02f + yJitter;
-                    instance.worldPosYaw[2] = chunkWorldZ + static_cast<float>(z) + 0.5f + jitterZ;
-                    instance.worldPosYaw[3] = yawRadians;
-                    // Mostly green bushes, with some flowers.
-                    const bool placeFlower = ((clumpHash >> 5u) % 100u) < 18u;
-                    if (placeFlower) {
-                        // Bias strongly toward poppies (tiles 1-2), with rarer lighter wildflowers (3-4).
-                        const bool choosePoppy = ((clumpHash >> 13u) % 100u) < 74u;
-                        const std::uint32_t flowerTile = choosePoppy
-                            ? (1u + ((clumpHash >> 9u) & 0x1u))
-                            : (3u + ((clumpHash >> 10u) & 0x1u));
-                        if (choosePoppy) {
-                            const float poppyBoost = 0.96f + (tintRand1 * 0.10f);
-                            instance.colorTint[0] = (0.92f + (tintRand0 * 0.14f)) * poppyBoost;
-                            instance.colorTint[1] = (0.92f + (tintRand2 * 0.14f)) * poppyBoost;
-                            instance.colorTint[2] = (0.92f + (tintRand1 * 0.14f)) * poppyBoost;
-                        } else {
-                            const float flowerBoost = 0.94f + (tintRand1 * 0.12f);
-                            instance.colorTint[0] = (0.94f + (tintRand0 * 0.14f)) * flowerBoost;
-                            instance.colorTint[1] = (0.94f + (tintRand2 * 0.14f)) * flowerBoost;
-                            instance.colorTint[2] = (0.94f + (tintRand1 * 0.14f)) * flowerBoost;
-                        }
-                        instance.colorTint[3] = static_cast<float>(flowerTile);
-                    } else {
-                        // Golden grass variation.
-                        const float warmBias = 0.50f + (0.50f * tintRand0);
-                        const float dryBias = tintRand2;
-                        const float brightness = 0.82f + (tintRand1 * 0.32f);
-                        const float redBase = std::lerp(0.90f, 1.28f, warmBias);
-                        const float greenBase = std::lerp(0.98f, 1.36f, (warmBias * 0.70f) + (dryBias * 0.30f));
-                        const float blueBase = std::lerp(0.56f, 0.20f, warmBias);
-                        instance.colorTint[0] = redBase * brightness;
-                        instance.colorTint[1] = greenBase * brightness;
-                        instance.colorTint[2] = blueBase * brightness;
-                        instance.colorTint[3] = 4.0f;
-                    }
-                    grassInstances.push_back(instance);
-                }
+                appendGrassVoxelInstances(chunk, x, y, z, grassInstances);
             }
         }
     }
     return grassInstances;
 }
 
+std::vector<std::vector<GrassInstance>> buildGrassInstancesParallel(
+    core::JobSystem& jobs,
+    std::span<const Chunk> chunks,
+    std::span<const GrassScatterParams> params
+) {
+    std::vector<std::vector<GrassInstance>> instancesPerChunk;
+    if (chunks.size() != params.size()) {
+        return instancesPerChunk;
+    }
+    instancesPerChunk.resize(chunks.size());
+    // Each chunk writes only its own slot, so no reduction is needed and the
+    // output is bit-identical to the serial loop.
+    core::parallelFor(jobs, 0, chunks.size(), 1, [&](std::size_t chunkIndex) {
+        instancesPerChunk[chunkIndex] = buildGrassInstances(chunks[chunkIndex], params[chunkIndex]);
+    });
+    return instancesPerChunk;
+}
+
+void GrassInstanceCache::markVoxelEdited(int worldX, int worldY, int worldZ) {
+    const core::Cell3i chunkKey{
+        floorDivide(worldX, Chunk::kSizeX),
+        floorDivide(worldY, Chunk::kSizeY),
+        floorDivide(worldZ, Chunk::kSizeZ)
+    };
+    const auto entryIt = m_entries.find(chunkKey);
+    if (entryIt == m_entries.end() || !entryIt->second.scattered) {
+        return;
+    }
+    Entry& entry = entryIt->second;
+    // Grass only looks at the voxel above within its own chunk, so an edit
+    // never reaches past its own column.
+    const int localX = worldX - (chunkKey.x * Chunk::kSizeX);
+    const int localZ = worldZ - (chunkKey.z * Chunk::kSizeZ);
+    entry.editedColumns.push_back(static_cast<std::uint16_t>(localX + (localZ * Chunk::kSizeX)));
+    if (entry.editedColumns.size() >= kColumnCount / 8) {
+        // Large edits are cheaper to rescatter whole than to splice.
+        entry.editedColumns.clear();
+        entry.scattered = false;
+    }
+}
+
+void GrassInstanceCache::runScatterJob(ScatterJob& job) {
+    const Chunk& chunk = *job.chunk;
+    Entry& entry = *job.entry;
+    if (job.fullChunk) {
+        entry.instances.clear();
+        entry.columnOffsets.resize(kColumnCount + 1);
+        std::size_t column = 0;
+        for (int z = 0; z < Chunk::kSizeZ; ++z) {
+            for (int x = 0; x < Chunk::kSizeX; ++x, ++column) {
+                entry.columnOffsets[column] = static_cast<std::uint32_t>(entry.instances.size());
+                appendGrassColumnInstances(chunk, x, z, entry.instances);
+            }
+        }
+        entry.columnOffsets[kColumnCount] = static_cast<std::uint32_t>(entry.instances.size());
+        job.columnsScattered = static_cast<std::uint32_t>(kColumnCount);
+        job.instancesScattered = static_cast<std::uint32_t>(entry.instances.size());
+    } else {
+        std::vector<std::uint16_t>& edited = entry.editedColumns;
+        std::sort(edited.begin(), edited.end());
+        edited.erase(std::unique(edited.begin(), edited.end()), edited.end());
+
+        entry.rebuildScratch.clear();
+        entry.rebuildOffsets.resize(kColumnCount + 1);
+        std::size_t nextEdited = 0;
+        std::size_t instancesScattered = 0;
+        for (std::size_t column = 0; column < kColumnCount; ++column) {
+            entry.rebuildOffsets[column] = static_cast<std::uint32_t>(entry.rebuildScratch.size());
+            if (nextEdited < edited.size() && edited[nextEdited] == column) {
+                const int x = static_cast<int>(column % Chunk::kSizeX);
+                const int z = static_cast<int>(column / Chunk::kSizeX);
+                instancesScattered += appendGrassColumnInstances(chunk, x, z, entry.rebuildScratch);
+                ++nextEdited;
+                continue;
+            }
+            entry.rebuildScratch.insert(
+                entry.rebuildScratch.end(),
+                entry.instances.begin() + entry.columnOffsets[column],
+                entry.instances.begin() + entry.columnOffsets[column + 1]
+            );
+        }
+        entry.rebuildOffsets[kColumnCount] = static_cast<std::uint32_t>(entry.rebuildScratch.size());
+        entry.instances.swap(entry.rebuildScratch);
+        entry.columnOffsets.swap(entry.rebuildOffsets);
+        job.columnsScattered = static_cast<std::uint32_t>(edited.size());
+        job.instancesScattered = static_cast<std::uint32_t>(instancesScattered);
+    }
+    entry.editedColumns.clear();
+    entry.contentVersion = chunk.contentVersion();
+    entry.scattered = true;
+}
+
+void GrassInstanceCache::update(std::span<const Chunk> chunks, const GrassScatterParams& params, core::JobSystem* jobs) {
+    ++m_updateStamp;
+    m_jobs.clear();
+    m_nextRanges.clear();
+
+    bool layoutChanged = false;
+    for (const Chunk& chunk : chunks) {
+        const core::Cell3i chunkKey{chunk.chunkX(), chunk.chunkY(), chunk.chunkZ()};
+        Entry& entry = m_entries[chunkKey];
+        if (entry.lastUpdate == m_updateStamp) {
+            continue;
+        }
+        entry.lastUpdate = m_updateStamp;
+
+        const int distanceX = std::abs(chunk.chunkX() - params.residentCenterChunkX);
+        const int distanceZ = std::abs(chunk.chunkZ() - params.residentCenterChunkZ);
+        const int radius = entry.active ? params.retainedRadius : params.activeRadius;
+        const bool active = distanceX <= radius && distanceZ <= radius;
+        if (active != entry.active) {
+            entry.active = active;
+            layoutChanged = true;
+        }
+        if (!active) {
+            // Keep the cached instances; they are reused if the chunk comes
+            // back unchanged.
+            continue;
+        }
+
+        m_nextRanges.push_back(ChunkRange{chunkKey, 0, 0});
+        if (entry.scattered && entry.contentVersion == chunk.contentVersion()) {
+            entry.editedColumns.clear();
+            ++m_stats.chunksReused;
+            continue;
+        }
+        ScatterJob job{};
+        job.entry = &entry;
+        job.chunk = &chunk;
+        job.fullChunk = !entry.scattered || entry.editedColumns.empty();
+        m_jobs.push_back(job);
+    }
+
+    // Entries are address-stable across rehashes, and each job owns its entry.
+    if (jobs != nullptr && m_jobs.size() > 1) {
+        core::parallelFor(*jobs, 0, m_jobs.size(), 1, [this](std::size_t jobIndex) {
+            runScatterJob(m_jobs[jobIndex]);
+        });
+    } else {
+        for (ScatterJob& job : m_jobs) {
+            runScatterJob(job);
+        }
+    }
+    for (const ScatterJob& job : m_jobs) {
+        if (job.fullChunk) {
+            ++m_stats.chunksFullyScattered;
+        } else {
+            ++m_stats.chunksPartiallyScattered;
+        }
+        m_stats.columnsScattered += job.columnsScattered;
+        m_stats.instancesScattered += job.instancesScattered;
+    }
+    layoutChanged = layoutChanged || !m_jobs.empty();
+
+    for (auto entryIt = m_entries.begin(); entryIt != m_entries.end();) {
+        if (entryIt->second.lastUpdate != m_updateStamp) {
+            layoutChanged = layoutChanged || entryIt->second.active;
+            entryIt = m_entries.erase(entryIt);
+        } else {
+            ++entryIt;
+        }
+    }
+
+    if (!layoutChanged && m_nextRanges.size() == m_ranges.size()) {
+        bool sameOrder = true;
+        for (std::size_t i = 0; i < m_ranges.size() && sameOrder; ++i) {
+            sameOrder = m_ranges[i].chunk == m_nextRanges[i].chunk;
+        }
+        if (sameOrder) {
+            return;
+        }
+    }
+
+    std::size_t totalInstances = 0;
+    for (ChunkRange& range : m_nextRanges) {
+        const Entry& entry = m_entries.find(range.chunk)->second;
+        range.firstInstance = static_cast<std::uint32_t>(totalInstances);
+        range.instanceCount = static_cast<std::uint32_t>(entry.instances.size());
+        totalInstances += entry.instances.size();
+    }
+    // resize() keeps the old capacity when shrinking, so the arena settles at
+    // its high-water mark and stops reallocating.
+    m_arena.resize(totalInstances);
+    for (const ChunkRange& range : m_nextRanges) {
+        if (range.instanceCount == 0) {
+            continue;
+        }
+        const Entry& entry = m_entries.find(range.chunk)->second;
+        std::memcpy(
+            m_arena.data() + range.firstInstance,
+            entry.instances.data(),
+            sizeof(GrassInstance) * range.instanceCount
+        );
+    }
+    m_ranges.swap(m_nextRanges);
+    ++m_stats.arenaRepacks;
+}
+
 } // namespace odai::world
@@ -1,7 +1,13 @@
 #pragma once
 
+#include "core/grid3.h"
+#include "core/hash.h"
+#include "core/job_system.h"
 #include "world/chunk_grid.h"
 
+#include <cstdint>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 // Deterministic grass/flower billboard scatter over a chunk's grass voxels.
@@ -30,4 +36,108 @@ struct GrassScatterParams {
 // active radius. Deterministic: same chunk contents + params -> same output.
 std::vector<GrassInstance> buildGrassInstances(const Chunk& chunk, const GrassScatterParams& params);
 
+// buildGrassInstances for many chunks at once, one chunk per parallelFor range
+// with the calling thread helping. params[i] goes with chunks[i] (each chunk
+// has its own previouslyActive); returns one vector per chunk, in chunk order,
+// identical to calling buildGrassInstances serially. Mismatched spans return
+// an empty result. No runtime caller: the renderer's grass scatter was
+// removed (see RendererBackend::createChunkBuffers), so only its test and
+// odai_voxel_bench use this; GrassInstanceCache::update runs its own jobs.
+std::vector<std::vector<GrassInstance>> buildGrassInstancesParallel(
+    core::JobSystem& jobs,
+    std::span<const Chunk> chunks,
+    std::span<const GrassScatterParams> params
+);
+
+// Persistent per-chunk grass instances, packed into one arena.
+//
+// Each resident chunk keeps its scattered instances grouped by (x, z) column,
+// tagged with the Chunk::contentVersion() they were built from. update()
+// reuses a chunk whose version is unchanged, rescatters only the columns
+// reported through markVoxelEdited() when it changed, and rescatters the whole
+// chunk when it changed without any reported edit (regenerated or loaded
+// chunks). A grass instance depends only on its own voxel and the one above,
+// both in the same column, so a column rescatter gives the same instances as
+// a full one.
+//
+// After the scatter jobs finish, active chunks are packed into instances() in
+// the order of update()'s chunk span, one contiguous range per chunk, so the
+// renderer can copy the whole arena in one go. The arena's storage is kept
+// between updates and only grows.
+//
+// Main-thread only; the JobSystem runs the per-chunk scatter jobs.
+class GrassInstanceCache {
+public:
+    struct ChunkRange {
+        core::Cell3i chunk{};
+        std::uint32_t firstInstance = 0;
+        std::uint32_t instanceCount = 0;
+    };
+
+    // Cumulative since construction or resetStats().
+    struct Stats {
+        std::uint64_t chunksReused = 0;
+        std::uint64_t chunksFullyScattered = 0;
+        std::uint64_t chunksPartiallyScattered = 0;
+        std::uint64_t columnsScattered = 0;
+        std::uint64_t instancesScattered = 0;
+        std::uint64_t arenaRepacks = 0;
+    };
+
+    // A voxel edit at world voxel coordinates. Every edit to a cached chunk
+    // must be reported before the next update(), or that chunk must be left
+    // unreported entirely (it is then rescattered whole).
+    void markVoxelEdited(int worldX, int worldY, int worldZ);
+
+    // Refreshes grass for the resident `chunks`. Activation uses params'
+    // centre and radii; previouslyActive is ignored because the cache tracks
+    // it per chunk. Entries for chunks no longer passed in are dropped.
+    // jobs == nullptr scatters on the calling thread.
+    void update(std::span<const Chunk> chunks, const GrassScatterParams& params, core::JobSystem* jobs = nullptr);
+
+    [[nodiscard]] std::span<const GrassInstance> instances() const { return m_arena; }
+    [[nodiscard]] std::span<const ChunkRange> chunkRanges() const { return m_ranges; }
+    [[nodiscard]] std::size_t arenaCapacity() const { return m_arena.capacity(); }
+    [[nodiscard]] std::size_t cachedChunkCount() const { return m_entries.size(); }
+    [[nodiscard]] const Stats& stats() const { return m_stats; }
+    void resetStats() { m_stats = {}; }
+
+private:
+    static constexpr std::size_t kColumnCount = static_cast<std::size_t>(Chunk::kSizeX * Chunk::kSizeZ);
+
+    struct Entry {
+        std::uint64_t contentVersion = 0;
+        std::uint64_t lastUpdate = 0;
+        bool scattered = false;
+        bool active = false;
+        // Instances ordered by column (x + z * kSizeX); column c owns
+        // [columnOffsets[c], columnOffsets[c + 1]).
+        std::vector<GrassInstance> instances;
+        std::vector<std::uint32_t> columnOffsets;
+        // Double buffer for column rescatters, so neither side reallocates
+        // once warm.
+        std::vector<GrassInstance> rebuildScratch;
+        std::vector<std::uint32_t> rebuildOffsets;
+        std::vector<std::uint16_t> editedColumns;
+    };
+
+    struct ScatterJob {
+        Entry* entry = nullptr;
+        const Chunk* chunk = nullptr;
+        bool fullChunk = true;
+        std::uint32_t columnsScattered = 0;
+        std::uint32_t instancesScattered = 0;
+    };
+
+    static void runScatterJob(ScatterJob& job);
+
+    std::unordered_map<core::Cell3i, Entry, core::Cell3Hash> m_entries;
+    std::vector<ScatterJob> m_jobs;
+    std::vector<GrassInstance> m_arena;
+    std::vector<ChunkRange> m_ranges;
+    std::vector<ChunkRange> m_nextRanges;
+    std::uint64_t m_updateStamp = 0;
+    Stats m_stats{};
+};
+
 } // namespace odai::world
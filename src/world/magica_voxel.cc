@@ -1,12 +1,19 @@
 #include "world/magica_voxel.h"
 
+#include "core/parallel_for.h"
+
 #include <algorithm>
 #include <array>
+#include <charconv>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <limits>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
 #include <utility>
 
 namespace odai::world {
@@ -25,8 +32,21 @@ constexpr std::uint32_t kChunkMain = fourCc('M', 'A', 'I', 'N');
 constexpr std::uint32_t kChunkSize = fourCc('S', 'I', 'Z', 'E');
 constexpr std::uint32_t kChunkXyzi = fourCc('X', 'Y', 'Z', 'I');
 constexpr std::uint32_t kChunkRgba = fourCc('R', 'G', 'B', 'A');
-
-std::uint32_t readU32Le(const std::vector<std::uint8_t>& bytes, std::size_t offset) {
+constexpr std::uint32_t kChunkTransform = fourCc('n', 'T', 'R', 'N');
+constexpr std::uint32_t kChunkGroup = fourCc('n', 'G', 'R', 'P');
+constexpr std::uint32_t kChunkShape = fourCc('n', 'S', 'H', 'P');
+
+// Voxels decoded per read from an XYZI chunk.
+constexpr std::uint32_t kXyziBatchVoxels = 16384u;
+constexpr std::int32_t kMaxSceneNodeCount = 1 << 20;
+constexpr int kMaxSceneDepth = 64;
+// Shared nodes are walked once per reference, so a small nGRP/nTRN DAG can
+// fan out exponentially within the depth cap; this bounds the expansion.
+constexpr std::size_t kMaxSceneNodeVisits = std::size_t{1} << 20;
+// Composed scenes must fit MagicaVoxel's 16-bit coordinates.
+constexpr std::int64_t kMaxSceneExtent = 65536;
+
+std::uint32_t readU32Le(std::span<const std::uint8_t> bytes, std::size_t offset) {
     return
         static_cast<std::uint32_t>(bytes[offset + 0]) |
         (static_cast<std::uint32_t>(bytes[offset + 1]) << 8u) |
@@ -34,7 +54,7 @@ std::uint32_t readU32Le(const std::vector<std::uint8_t>& bytes, std::size_t offs
         (static_cast<std::uint32_t>(bytes[offset + 3]) << 24u);
 }
 
-std::int32_t readI32Le(const std::vector<std::uint8_t>& bytes, std::size_t offset) {
+std::int32_t readI32Le(std::span<const std::uint8_t> bytes, std::size_t offset) {
     return static_cast<std::int32_t>(readU32Le(bytes, offset));
 }
 
@@ -46,6 +66,429 @@ std::uint32_t packRgba(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint
         (static_cast<std::uint32_t>(a) << 24u);
 }
 
+bool readBytes(std::ifstream& stream, void* outBytes, std::size_t size) {
+    return static_cast<bool>(stream.read(static_cast<char*>(outBytes), static_cast<std::streamsize>(size)));
+}
+
+struct VoxChunkHeader {
+    std::uint32_t id = 0;
+    std::uint32_t contentSize = 0;
+    std::uint32_t childrenSize = 0;
+};
+
+bool readChunkHeader(std::ifstream& stream, VoxChunkHeader& outHeader) {
+    std::array<std::uint8_t, 12> bytes{};
+    if (!readBytes(stream, bytes.data(), bytes.size())) {
+        return false;
+    }
+    outHeader.id = readU32Le(bytes, 0u);
+    outHeader.contentSize = readU32Le(bytes, 4u);
+    outHeader.childrenSize = readU32Le(bytes, 8u);
+    return true;
+}
+
+struct MagicaModelData {
+    int sizeX = 0;
+    int sizeY = 0;
+    int sizeZ = 0;
+    std::vector<MagicaVoxel> voxels;
+};
+
+// Decodes an XYZI chunk straight from the stream in fixed-size batches, so a
+// large scene never needs the whole file in memory.
+bool readXyziVoxels(
+    std::ifstream& stream,
+    std::uint32_t contentSize,
+    std::vector<std::uint8_t>& scratch,
+    MagicaModelData& model
+) {
+    scratch.resize(4u);
+    if (!readBytes(stream, scratch.data(), 4u)) {
+        return false;
+    }
+    const std::uint32_t voxelCount = readU32Le(scratch, 0u);
+    if ((4u + (static_cast<std::uint64_t>(voxelCount) * 4u)) > static_cast<std::uint64_t>(contentSize)) {
+        // Truncated model: keep it empty, as the whole-file reader did.
+        return true;
+    }
+    model.voxels.reserve(voxelCount);
+
+    std::uint32_t remaining = voxelCount;
+    while (remaining > 0u) {
+        const std::uint32_t batchCount = std::min(remaining, kXyziBatchVoxels);
+        scratch.resize(static_cast<std::size_t>(batchCount) * 4u);
+        if (!readBytes(stream, scratch.data(), scratch.size())) {
+            return false;
+        }
+        for (std::size_t voxelCursor = 0; voxelCursor < scratch.size(); voxelCursor += 4u) {
+            const std::uint8_t x = scratch[voxelCursor + 0u];
+            const std::uint8_t y = scratch[voxelCursor + 1u];
+            const std::uint8_t z = scratch[voxelCursor + 2u];
+            const std::uint8_t paletteIndex = scratch[voxelCursor + 3u];
+            if (paletteIndex == 0u) {
+                continue;
+            }
+            if (static_cast<int>(x) >= model.sizeX ||
+                static_cast<int>(y) >= model.sizeY ||
+                static_cast<int>(z) >= model.sizeZ) {
+                continue;
+            }
+            model.voxels.push_back(MagicaVoxel{x, y, z, paletteIndex});
+        }
+        remaining -= batchCount;
+    }
+    return true;
+}
+
+// Signed permutation matrix, row-major, as packed in an nTRN "_r" entry.
+using SceneRotation = std::array<std::array<int, 3>, 3>;
+
+constexpr SceneRotation kIdentitySceneRotation = {{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+
+SceneRotation unpackSceneRotation(std::uint32_t packed) {
+    // Bits 0-1 and 2-3: column of the non-zero entry in rows 0 and 1 (row 2
+    // takes the remaining column); bits 4, 5, 6: rows 0, 1, 2 are negative.
+    const int column0 = static_cast<int>(packed & 0x3u);
+    const int column1 = static_cast<int>((packed >> 2u) & 0x3u);
+    if (column0 > 2 || column1 > 2 || column0 == column1) {
+        return kIdentitySceneRotation;
+    }
+    const int column2 = 3 - column0 - column1;
+    SceneRotation rotation{};
+    rotation[0][column0] = ((packed & 0x10u) != 0u) ? -1 : 1;
+    rotation[1][column1] = ((packed & 0x20u) != 0u) ? -1 : 1;
+    rotation[2][column2] = ((packed & 0x40u) != 0u) ? -1 : 1;
+    return rotation;
+}
+
+SceneRotation multiplySceneRotations(const SceneRotation& lhs, const SceneRotation& rhs) {
+    SceneRotation product{};
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            for (int k = 0; k < 3; ++k) {
+                product[row][column] += lhs[row][k] * rhs[k][column];
+            }
+        }
+    }
+    return product;
+}
+
+std::array<int, 3> rotateSceneVector(const SceneRotation& rotation, const std::array<int, 3>& vector) {
+    std::array<int, 3> rotated{};
+    for (int row = 0; row < 3; ++row) {
+        rotated[row] = (rotation[row][0] * vector[0]) + (rotation[row][1] * vector[1]) + (rotation[row][2] * vector[2]);
+    }
+    return rotated;
+}
+
+enum class SceneNodeKind : std::uint8_t {
+    None,
+    Transform,
+    Group,
+    Shape
+};
+
+struct SceneNode {
+    SceneNodeKind kind = SceneNodeKind::None;
+    bool hidden = false;
+    // Transform: one child, placed by translation and rotation.
+    int childNodeId = -1;
+    std::array<int, 3> translation{};
+    SceneRotation rotation = kIdentitySceneRotation;
+    // Group: any number of transform children.
+    std::vector<int> childNodeIds;
+    // Shape: the model it instances (the first, for animated shapes).
+    int modelId = -1;
+};
+
+// Little-endian reader over one scene chunk's content. Reads past the end
+// clear ok() and return zeros / empty strings.
+class SceneChunkCursor {
+public:
+    explicit SceneChunkCursor(const std::vector<std::uint8_t>& bytes) : m_bytes(bytes) {}
+
+    std::int32_t readI32() {
+        if (!m_ok || (m_offset + 4u) > m_bytes.size()) {
+            m_ok = false;
+            return 0;
+        }
+        const std::int32_t value = readI32Le(m_bytes, m_offset);
+        m_offset += 4u;
+        return value;
+    }
+
+    std::string_view readString() {
+        const std::int32_t length = readI32();
+        if (!m_ok || length < 0 || (m_offset + static_cast<std::size_t>(length)) > m_bytes.size()) {
+            m_ok = false;
+            return {};
+        }
+        const std::string_view text(reinterpret_cast<const char*>(m_bytes.data() + m_offset), static_cast<std::size_t>(length));
+        m_offset += static_cast<std::size_t>(length);
+        return text;
+    }
+
+    // Calls fn(key, value) for each entry of a DICT.
+    template <typename Fn>
+    void readDict(Fn&& fn) {
+        const std::int32_t entryCount = readI32();
+        for (std::int32_t entry = 0; m_ok && entry < entryCount; ++entry) {
+            const std::string_view key = readString();
+            const std::string_view value = readString();
+            if (m_ok) {
+                fn(key, value);
+            }
+        }
+    }
+
+    bool ok() const { return m_ok; }
+
+private:
+    const std::vector<std::uint8_t>& m_bytes;
+    std::size_t m_offset = 0;
+    bool m_ok = true;
+};
+
+bool parseSceneInt(std::string_view text, int& outValue) {
+    while (!text.empty() && text.front() == ' ') {
+        text.remove_prefix(1u);
+    }
+    const std::from_chars_result parsed = std::from_chars(text.data(), text.data() + text.size(), outValue);
+    return parsed.ec == std::errc{};
+}
+
+bool parseSceneTranslation(std::string_view text, std::array<int, 3>& outTranslation) {
+    for (int axis = 0; axis < 3; ++axis) {
+        while (!text.empty() && text.front() == ' ') {
+            text.remove_prefix(1u);
+        }
+        const std::from_chars_result parsed =
+            std::from_chars(text.data(), text.data() + text.size(), outTranslation[static_cast<std::size_t>(axis)]);
+        if (parsed.ec != std::errc{}) {
+            return false;
+        }
+        text.remove_prefix(static_cast<std::size_t>(parsed.ptr - text.data()));
+    }
+    return true;
+}
+
+// Parses an nTRN, nGRP or nSHP chunk into sceneNodes[nodeId].
+bool readSceneNode(std::uint32_t chunkId, const std::vector<std::uint8_t>& content, std::vector<SceneNode>& sceneNodes) {
+    SceneChunkCursor cursor(content);
+    const std::int32_t nodeId = cursor.readI32();
+    if (!cursor.ok() || nodeId < 0 || nodeId >= kMaxSceneNodeCount) {
+        return false;
+    }
+    if (static_cast<std::size_t>(nodeId) >= sceneNodes.size()) {
+        sceneNodes.resize(static_cast<std::size_t>(nodeId) + 1u);
+    }
+    SceneNode& node = sceneNodes[static_cast<std::size_t>(nodeId)];
+    node = SceneNode{};
+    cursor.readDict([&](std::string_view key, std::string_view value) {
+        if (key == "_hidden") {
+            node.hidden = value == "1";
+        }
+    });
+
+    if (chunkId == kChunkTransform) {
+        node.kind = SceneNodeKind::Transform;
+        node.childNodeId = cursor.readI32();
+        (void)cursor.readI32(); // reserved
+        (void)cursor.readI32(); // layer
+        const std::int32_t frameCount = cursor.readI32();
+        for (std::int32_t frame = 0; cursor.ok() && frame < frameCount; ++frame) {
+            cursor.readDict([&](std::string_view key, std::string_view value) {
+                if (frame != 0) {
+                    return;
+                }
+                if (key == "_t") {
+                    if (!parseSceneTranslation(value, node.translation)) {
+                        node.translation = {};
+                    }
+                } else if (key == "_r") {
+                    int packedRotation = 0;
+                    if (parseSceneInt(value, packedRotation)) {
+                        node.rotation = unpackSceneRotation(static_cast<std::uint32_t>(packedRotation));
+                    }
+                }
+            });
+        }
+    } else if (chunkId == kChunkGroup) {
+        node.kind = SceneNodeKind::Group;
+        const std::int32_t childCount = cursor.readI32();
+        for (std::int32_t child = 0; cursor.ok() && child < childCount; ++child) {
+            node.childNodeIds.push_back(cursor.readI32());
+        }
+    } else {
+        node.kind = SceneNodeKind::Shape;
+        const std::int32_t modelCount = cursor.readI32();
+        if (modelCount > 0) {
+            node.modelId = cursor.readI32();
+            cursor.readDict([](std::string_view, std::string_view) {});
+        }
+    }
+    return cursor.ok();
+}
+
+struct ShapeInstance {
+    int modelId = -1;
+    std::array<int, 3> translation{};
+    SceneRotation rotation = kIdentitySceneRotation;
+};
+
+// Returns false once the walk has used up `visitBudget`.
+bool collectShapeInstances(
+    const std::vector<SceneNode>& sceneNodes,
+    int nodeId,
+    const std::array<int, 3>& translation,
+    const SceneRotation& rotation,
+    int depth,
+    std::size_t& visitBudget,
+    std::vector<ShapeInstance>& outInstances
+) {
+    if (nodeId < 0 || static_cast<std::size_t>(nodeId) >= sceneNodes.size() || depth > kMaxSceneDepth) {
+        return true;
+    }
+    if (visitBudget == 0u) {
+        return false;
+    }
+    --visitBudget;
+    const SceneNode& node = sceneNodes[static_cast<std::size_t>(nodeId)];
+    if (node.hidden) {
+        return true;
+    }
+    switch (node.kind) {
+    case SceneNodeKind::Transform: {
+        const std::array<int, 3> offset = rotateSceneVector(rotation, node.translation);
+        const std::array<int, 3> childTranslation = {
+            translation[0] + offset[0],
+            translation[1] + offset[1],
+            translation[2] + offset[2]
+        };
+        return collectShapeInstances(
+            sceneNodes,
+            node.childNodeId,
+            childTranslation,
+            multiplySceneRotations(rotation, node.rotation),
+            depth + 1,
+            visitBudget,
+            outInstances
+        );
+    }
+    case SceneNodeKind::Group:
+        for (const int childNodeId : node.childNodeIds) {
+            if (!collectShapeInstances(sceneNodes, childNodeId, translation, rotation, depth + 1, visitBudget, outInstances)) {
+                return false;
+            }
+        }
+        return true;
+    case SceneNodeKind::Shape:
+        outInstances.push_back(ShapeInstance{node.modelId, translation, rotation});
+        return true;
+    case SceneNodeKind::None:
+    default:
+        return true;
+    }
+}
+
+int ceilHalf(int value) {
+    return (value >= 0) ? ((value + 1) / 2) : -((-value) / 2);
+}
+
+// Scene position of voxel `voxel` of a model of size `size` placed by
+// `instance`. A model is centred on its translation: the centre of voxel v
+// sits at v + 0.5 - size / 2 before rotation. Doubling keeps this integral.
+std::array<int, 3> placeSceneVoxel(
+    const ShapeInstance& instance,
+    const std::array<int, 3>& size,
+    const std::array<int, 3>& voxel
+) {
+    const std::array<int, 3> doubledCentre = {
+        (2 * voxel[0]) + 1 - size[0],
+        (2 * voxel[1]) + 1 - size[1],
+        (2 * voxel[2]) + 1 - size[2]
+    };
+    const std::array<int, 3> rotated = rotateSceneVector(instance.rotation, doubledCentre);
+    return {
+        instance.translation[0] + ceilHalf(rotated[0] - 1),
+        instance.translation[1] + ceilHalf(rotated[1] - 1),
+        instance.translation[2] + ceilHalf(rotated[2] - 1)
+    };
+}
+
+// Flattens every visible shape of the scene graph (rooted at node 0) into one
+// model whose bounds start at zero.
+bool composeSceneModel(
+    const std::vector<MagicaModelData>& models,
+    const std::vector<SceneNode>& sceneNodes,
+    MagicaVoxelModel& outModel
+) {
+    std::vector<ShapeInstance> instances;
+    std::size_t visitBudget = kMaxSceneNodeVisits;
+    if (!collectShapeInstances(sceneNodes, 0, {0, 0, 0}, kIdentitySceneRotation, 0, visitBudget, instances)) {
+        return false;
+    }
+
+    std::array<int, 3> boundsMin = {
+        std::numeric_limits<int>::max(),
+        std::numeric_limits<int>::max(),
+        std::numeric_limits<int>::max()
+    };
+    std::array<int, 3> boundsMax = {
+        std::numeric_limits<int>::min(),
+        std::numeric_limits<int>::min(),
+        std::numeric_limits<int>::min()
+    };
+    std::size_t voxelCount = 0;
+    for (const ShapeInstance& instance : instances) {
+        if (instance.modelId < 0 || static_cast<std::size_t>(instance.modelId) >= models.size()) {
+            continue;
+        }
+        const MagicaModelData& model = models[static_cast<std::size_t>(instance.modelId)];
+        if (model.voxels.empty()) {
+            continue;
+        }
+        const std::array<int, 3> size = {model.sizeX, model.sizeY, model.sizeZ};
+        const std::array<int, 3> cornerA = placeSceneVoxel(instance, size, {0, 0, 0});
+        const std::array<int, 3> cornerB = placeSceneVoxel(instance, size, {size[0] - 1, size[1] - 1, size[2] - 1});
+        for (std::size_t axis = 0; axis < 3u; ++axis) {
+            boundsMin[axis] = std::min({boundsMin[axis], cornerA[axis], cornerB[axis]});
+            boundsMax[axis] = std::max({boundsMax[axis], cornerA[axis], cornerB[axis]});
+        }
+        voxelCount += model.voxels.size();
+    }
+    if (voxelCount == 0u) {
+        return false;
+    }
+    for (std::size_t axis = 0; axis < 3u; ++axis) {
+        if ((static_cast<std::int64_t>(boundsMax[axis]) - boundsMin[axis]) >= kMaxSceneExtent) {
+            return false;
+        }
+    }
+
+    outModel.sizeX = boundsMax[0] - boundsMin[0] + 1;
+    outModel.sizeY = boundsMax[1] - boundsMin[1] + 1;
+    outModel.sizeZ = boundsMax[2] - boundsMin[2] + 1;
+    outModel.voxels.reserve(voxelCount);
+    for (const ShapeInstance& instance : instances) {
+        if (instance.modelId < 0 || static_cast<std::size_t>(instance.modelId) >= models.size()) {
+            continue;
+        }
+        const MagicaModelData& model = models[static_cast<std::size_t>(instance.modelId)];
+        const std::array<int, 3> size = {model.sizeX, model.sizeY, model.sizeZ};
+        for (const MagicaVoxel& voxel : model.voxels) {
+            const std::array<int, 3> placed = placeSceneVoxel(instance, size, {voxel.x, voxel.y, voxel.z});
+            outModel.voxels.push_back(MagicaVoxel{
+                static_cast<std::uint16_t>(placed[0] - boundsMin[0]),
+                static_cast<std::uint16_t>(placed[1] - boundsMin[1]),
+                static_cast<std::uint16_t>(placed[2] - boundsMin[2]),
+                voxel.paletteIndex
+            });
+        }
+    }
+    return true;
+}
+
 std::array<std::uint32_t, 256> makeFallbackPalette() {
     std::array<std::uint32_t, 256> palette{};
     palette[0] = 0u;
@@ -115,7 +558,10 @@ void faceAoAxes(std::uint32_t faceId, int& ux, int& uy, int& uz, int& vx, int& v
 }
 
 std::size_t denseIndex(int x, int y, int z, int sizeX, int sizeY) {
-    return static_cast<std::size_t>(x + (y * sizeX) + (z * sizeX * sizeY));
+    const std::size_t rowStride = static_cast<std::size_t>(sizeX);
+    const std::size_t sliceStride = rowStride * static_cast<std::size_t>(sizeY);
+    return static_cast<std::size_t>(x) + (static_cast<std::size_t>(y) * rowStride) +
+        (static_cast<std::size_t>(z) * sliceStride);
 }
 
 bool isSolid(
@@ -523,6 +969,259 @@ void appendDenseVoxelFaceLocal(
     mesh.indices.push_back(baseVertex + 3u);
 }
 
+// Distinct palette indices of the tile's exposed faces, in the order
+// meshMagicaTile() first reaches them. Replaying these lists tile by tile
+// reproduces the base color slots a single serial pass would assign.
+void collectTilePaletteOrder(
+    const std::vector<std::uint8_t>& densePalette,
+    int transformedSizeX,
+    int transformedSizeY,
+    int transformedSizeZ,
+    int tileX,
+    int tileY,
+    int tileZ,
+    int localSizeX,
+    int localSizeY,
+    int localSizeZ,
+    std::vector<std::uint8_t>& outPaletteOrder
+) {
+    std::array<bool, 256> seen{};
+    for (std::uint32_t faceId = 0; faceId < kFaceNeighbors.size(); ++faceId) {
+        int sliceCount = 0;
+        int uCount = 0;
+        int vCount = 0;
+        faceSliceDimensionsForVolume(faceId, localSizeX, localSizeY, localSizeZ, sliceCount, uCount, vCount);
+        const FaceNeighbor& face = kFaceNeighbors[faceId];
+        for (int slice = 0; slice < sliceCount; ++slice) {
+            for (int v = 0; v < vCount; ++v) {
+                for (int u = 0; u < uCount; ++u) {
+                    int localX = 0;
+                    int localY = 0;
+                    int localZ = 0;
+                    faceSliceCellToVoxel(faceId, slice, u, v, localX, localY, localZ);
+                    const int globalX = tileX + localX;
+                    const int globalY = tileY + localY;
+                    const int globalZ = tileZ + localZ;
+                    const std::uint8_t paletteIndex = densePalette[denseIndex(
+                        globalX,
+                        globalY,
+                        globalZ,
+                        transformedSizeX,
+                        transformedSizeY
+                    )];
+                    if (paletteIndex == 0u || seen[paletteIndex]) {
+                        continue;
+                    }
+                    if (isSolid(
+                            densePalette,
+                            transformedSizeX,
+                            transformedSizeY,
+                            transformedSizeZ,
+                            globalX + face.nx,
+                            globalY + face.ny,
+                            globalZ + face.nz
+                        )) {
+                        continue;
+                    }
+                    seen[paletteIndex] = true;
+                    outPaletteOrder.push_back(paletteIndex);
+                }
+            }
+        }
+    }
+}
+
+// Greedy-meshes one tile of the dense volume into tile-local vertices.
+void meshMagicaTile(
+    const std::vector<std::uint8_t>& densePalette,
+    int transformedSizeX,
+    int transformedSizeY,
+    int transformedSizeZ,
+    int tileX,
+    int tileY,
+    int tileZ,
+    int localSizeX,
+    int localSizeY,
+    int localSizeZ,
+    const std::array<std::uint8_t, 256>& baseColorIndexByPaletteIndex,
+    ChunkMeshData& mesh
+) {
+    for (std::uint32_t faceId = 0; faceId < kFaceNeighbors.size(); ++faceId) {
+        int sliceCount = 0;
+        int uCount = 0;
+        int vCount = 0;
+        faceSliceDimensionsForVolume(
+            faceId,
+            localSizeX,
+            localSizeY,
+            localSizeZ,
+            sliceCount,
+            uCount,
+            vCount
+        );
+        std::vector<std::uint32_t> mask(static_cast<std::size_t>(uCount * vCount), kEmptyMaskKey);
+
+        for (int slice = 0; slice < sliceCount; ++slice) {
+            std::fill(mask.begin(), mask.end(), kEmptyMaskKey);
+
+            for (int v = 0; v < vCount; ++v) {
+                for (int u = 0; u < uCount; ++u) {
+                    int localX = 0;
+                    int localY = 0;
+                    int localZ = 0;
+                    faceSliceCellToVoxel(faceId, slice, u, v, localX, localY, localZ);
+                    const int globalX = tileX + localX;
+                    const int globalY = tileY + localY;
+                    const int globalZ = tileZ + localZ;
+
+                    const std::uint8_t paletteIndex = densePalette[denseIndex(
+                        globalX,
+                        globalY,
+                        globalZ,
+                        transformedSizeX,
+                        transformedSizeY
+                    )];
+                    if (paletteIndex == 0u) {
+                        continue;
+                    }
+
+                    const FaceNeighbor& face = kFaceNeighbors[faceId];
+                    if (isSolid(
+                            densePalette,
+                            transformedSizeX,
+                            transformedSizeY,
+                            transformedSizeZ,
+                            globalX + face.nx,
+                            globalY + face.ny,
+                            globalZ + face.nz
+                        )) {
+                        continue;
+                    }
+
+                    const std::uint8_t baseColorIndex = baseColorIndexByPaletteIndex[paletteIndex];
+                    const std::uint8_t material = kMaterialPalette;
+                    const std::uint16_t aoSignature = faceCornerAoSignatureDense(
+                        densePalette,
+                        transformedSizeX,
+                        transformedSizeY,
+                        transformedSizeZ,
+                        globalX,
+                        globalY,
+                        globalZ,
+                        faceId
+                    );
+                    const std::size_t maskIndex = static_cast<std::size_t>(u + (v * uCount));
+                    mask[maskIndex] = makeMaskKey(material, aoSignature, baseColorIndex);
+                }
+            }
+
+            for (int v = 0; v < vCount; ++v) {
+                for (int u = 0; u < uCount;) {
+                    const std::size_t startIndex = static_cast<std::size_t>(u + (v * uCount));
+                    const std::uint32_t key = mask[startIndex];
+                    if (key == kEmptyMaskKey) {
+                        ++u;
+                        continue;
+                    }
+
+                    int width = 1;
+                    while ((u + width) < uCount) {
+                        const std::size_t widthIndex = static_cast<std::size_t>((u + width) + (v * uCount));
+                        if (mask[widthIndex] != key) {
+                            break;
+                        }
+                        ++width;
+                    }
+
+                    int height = 1;
+                    bool canGrow = true;
+                    while ((v + height) < vCount && canGrow) {
+                        for (int offsetU = 0; offsetU < width; ++offsetU) {
+                            const std::size_t growIndex =
+                                static_cast<std::size_t>((u + offsetU) + ((v + height) * uCount));
+                            if (mask[growIndex] != key) {
+                                canGrow = false;
+                                break;
+                            }
+                        }
+                        if (canGrow) {
+                            ++height;
+                        }
+                    }
+
+                    const std::uint8_t material =
+                        static_cast<std::uint8_t>((key >> 19u) & PackedVoxelVertex::kMask3);
+                    const std::uint16_t aoSignature =
+                        static_cast<std::uint16_t>((key >> 3u) & 0xFFFFu);
+                    const std::uint8_t baseColorIndex =
+                        static_cast<std::uint8_t>(key & PackedVoxelVertex::kMask3);
+                    const bool mergedQuadAppended = appendGreedyFaceQuadLocal(
+                        mesh,
+                        faceId,
+                        slice,
+                        u,
+                        v,
+                        width,
+                        height,
+                        material,
+                        aoSignature,
+                        baseColorIndex,
+                        0u,
+                        localSizeX,
+                        localSizeY,
+                        localSizeZ
+                    );
+                    if (!mergedQuadAppended) {
+                        for (int emitV = 0; emitV < height; ++emitV) {
+                            for (int emitU = 0; emitU < width; ++emitU) {
+                                int localX = 0;
+                                int localY = 0;
+                                int localZ = 0;
+                                faceSliceCellToVoxel(faceId, slice, u + emitU, v + emitV, localX, localY, localZ);
+                                const std::uint8_t paletteIndex = densePalette[denseIndex(
+                                    tileX + localX,
+                                    tileY + localY,
+                                    tileZ + localZ,
+                                    transformedSizeX,
+                                    transformedSizeY
+                                )];
+                                const std::uint8_t fallbackBaseColorIndex =
+                                    baseColorIndexByPaletteIndex[paletteIndex];
+                                appendDenseVoxelFaceLocal(
+                                    mesh,
+                                    densePalette,
+                                    transformedSizeX,
+                                    transformedSizeY,
+                                    transformedSizeZ,
+                                    tileX + localX,
+                                    tileY + localY,
+                                    tileZ + localZ,
+                                    localX,
+                                    localY,
+                                    localZ,
+                                    faceId,
+                                    material,
+                                    fallbackBaseColorIndex
+                                );
+                            }
+                        }
+                    }
+
+                    for (int clearV = 0; clearV < height; ++clearV) {
+                        for (int clearU = 0; clearU < width; ++clearU) {
+                            const std::size_t clearIndex =
+                                static_cast<std::size_t>((u + clearU) + ((v + clearV) * uCount));
+                            mask[clearIndex] = kEmptyMaskKey;
+                        }
+                    }
+
+                    u += width;
+                }
+            }
+        }
+    }
+}
+
 } // namespace
 
 bool loadMagicaVoxelModel(const std::filesystem::path& path, MagicaVoxelModel& outModel) {
@@ -532,43 +1231,24 @@ bool loadMagicaVoxelModel(const std::filesystem::path& path, MagicaVoxelModel& o
     if (!stream) {
         return false;
     }
-
-    const std::streamsize fileSize = stream.tellg();
-    if (fileSize <= 0) {
+    const std::streamoff fileSize = stream.tellg();
+    if (fileSize < 20) {
         return false;
     }
     stream.seekg(0, std::ios::beg);
 
-    std::vector<std::uint8_t> bytes(static_cast<std::size_t>(fileSize));
-    if (!stream.read(reinterpret_cast<char*>(bytes.data()), fileSize)) {
-        return false;
-    }
-
-    if (bytes.size() < 20u) {
+    std::array<std::uint8_t, 8> fileHeader{};
+    if (!readBytes(stream, fileHeader.data(), fileHeader.size()) || std::memcmp(fileHeader.data(), "VOX ", 4) != 0) {
         return false;
     }
-    if (std::memcmp(bytes.data(), "VOX ", 4) != 0) {
-        return false;
-    }
-
-    std::size_t offset = 4u;
-    (void)readU32Le(bytes, offset); // version
-    offset += 4u;
-
-    if ((offset + 12u) > bytes.size()) {
-        return false;
-    }
-    const std::uint32_t mainId = readU32Le(bytes, offset + 0u);
-    const std::uint32_t mainContentSize = readU32Le(bytes, offset + 4u);
-    const std::uint32_t mainChildrenSize = readU32Le(bytes, offset + 8u);
-    offset += 12u;
 
-    if (mainId != kChunkMain) {
+    VoxChunkHeader mainHeader{};
+    if (!readChunkHeader(stream, mainHeader) || mainHeader.id != kChunkMain) {
         return false;
     }
-    const std::size_t mainContentEnd = offset + static_cast<std::size_t>(mainContentSize);
-    const std::size_t mainChildrenEnd = mainContentEnd + static_cast<std::size_t>(mainChildrenSize);
-    if (mainChildrenEnd > bytes.size()) {
+    const std::uint64_t mainContentEnd = 20u + static_cast<std::uint64_t>(mainHeader.contentSize);
+    const std::uint64_t mainChildrenEnd = mainContentEnd + static_cast<std::uint64_t>(mainHeader.childrenSize);
+    if (mainChildrenEnd > static_cast<std::uint64_t>(fileSize)) {
         return false;
     }
 
@@ -579,27 +1259,33 @@ bool loadMagicaVoxelModel(const std::filesystem::path& path, MagicaVoxelModel& o
     int pendingSizeX = 0;
     int pendingSizeY = 0;
     int pendingSizeZ = 0;
-    bool loadedFirstModel = false;
+    std::vector<MagicaModelData> models;
+    std::vector<SceneNode> sceneNodes;
+    std::vector<std::uint8_t> content;
 
-    std::size_t cursor = mainContentEnd;
+    std::uint64_t cursor = mainContentEnd;
     while ((cursor + 12u) <= mainChildrenEnd) {
-        const std::uint32_t chunkId = readU32Le(bytes, cursor + 0u);
-        const std::uint32_t contentSize = readU32Le(bytes, cursor + 4u);
-        const std::uint32_t childrenSize = readU32Le(bytes, cursor + 8u);
-        cursor += 12u;
-
-        const std::size_t contentBegin = cursor;
-        const std::size_t contentEnd = contentBegin + static_cast<std::size_t>(contentSize);
-        const std::size_t childrenEnd = contentEnd + static_cast<std::size_t>(childrenSize);
+        stream.seekg(static_cast<std::streamoff>(cursor), std::ios::beg);
+        VoxChunkHeader header{};
+        if (!readChunkHeader(stream, header)) {
+            return false;
+        }
+        const std::uint64_t contentBegin = cursor + 12u;
+        const std::uint64_t contentEnd = contentBegin + static_cast<std::uint64_t>(header.contentSize);
+        const std::uint64_t childrenEnd = contentEnd + static_cast<std::uint64_t>(header.childrenSize);
         if (childrenEnd > mainChildrenEnd) {
             return false;
         }
 
-        if (chunkId == kChunkSize) {
-            if (contentSize >= 12u) {
-                const int sx = readI32Le(bytes, contentBegin + 0u);
-                const int sy = readI32Le(bytes, contentBegin + 4u);
-                const int sz = readI32Le(bytes, contentBegin + 8u);
+        if (header.id == kChunkSize) {
+            if (header.contentSize >= 12u) {
+                content.resize(12u);
+                if (!readBytes(stream, content.data(), content.size())) {
+                    return false;
+                }
+                const int sx = readI32Le(content, 0u);
+                const int sy = readI32Le(content, 4u);
+                const int sz = readI32Le(content, 8u);
                 if (sx > 0 && sy > 0 && sz > 0) {
                     pendingSizeX = sx;
                     pendingSizeY = sy;
@@ -607,60 +1293,61 @@ bool loadMagicaVoxelModel(const std::filesystem::path& path, MagicaVoxelModel& o
                     havePendingSize = true;
                 }
             }
-        } else if (chunkId == kChunkXyzi) {
-            if (havePendingSize && contentSize >= 4u) {
-                const std::uint32_t voxelCount = readU32Le(bytes, contentBegin);
-                const std::size_t voxelBytes = static_cast<std::size_t>(voxelCount) * 4u;
-                if ((4u + voxelBytes) <= static_cast<std::size_t>(contentSize) && !loadedFirstModel) {
-                    outModel.sizeX = pendingSizeX;
-                    outModel.sizeY = pendingSizeY;
-                    outModel.sizeZ = pendingSizeZ;
-                    outModel.voxels.clear();
-                    outModel.voxels.reserve(voxelCount);
-
-                    std::size_t voxelCursor = contentBegin + 4u;
-                    for (std::uint32_t i = 0; i < voxelCount; ++i) {
-                        const std::uint8_t x = bytes[voxelCursor + 0u];
-                        const std::uint8_t y = bytes[voxelCursor + 1u];
-                        const std::uint8_t z = bytes[voxelCursor + 2u];
-                        const std::uint8_t paletteIndex = bytes[voxelCursor + 3u];
-                        voxelCursor += 4u;
-
-                        if (paletteIndex == 0u) {
-                            continue;
-                        }
-                        if (static_cast<int>(x) >= pendingSizeX ||
-                            static_cast<int>(y) >= pendingSizeY ||
-                            static_cast<int>(z) >= pendingSizeZ) {
-                            continue;
-                        }
-
-                        outModel.voxels.push_back(MagicaVoxel{x, y, z, paletteIndex});
-                    }
-                    loadedFirstModel = true;
+        } else if (header.id == kChunkXyzi) {
+            // Every XYZI takes the next model id, even one that is dropped,
+            // so shape nodes keep pointing at the right model.
+            MagicaModelData& model = models.emplace_back();
+            if (havePendingSize && header.contentSize >= 4u) {
+                model.sizeX = pendingSizeX;
+                model.sizeY = pendingSizeY;
+                model.sizeZ = pendingSizeZ;
+                if (!readXyziVoxels(stream, header.contentSize, content, model)) {
+                    return false;
                 }
             }
-        } else if (chunkId == kChunkRgba) {
-            if (contentSize >= 1024u) {
+            havePendingSize = false;
+        } else if (header.id == kChunkRgba) {
+            if (header.contentSize >= 1024u) {
+                content.resize(1024u);
+                if (!readBytes(stream, content.data(), content.size())) {
+                    return false;
+                }
                 std::array<std::uint32_t, 256> parsedPalette{};
                 parsedPalette[0] = 0u;
                 for (std::uint32_t paletteIndex = 1u; paletteIndex < parsedPalette.size(); ++paletteIndex) {
-                    const std::size_t paletteByteOffset = contentBegin + ((paletteIndex - 1u) * 4u);
-                    const std::uint8_t r = bytes[paletteByteOffset + 0u];
-                    const std::uint8_t g = bytes[paletteByteOffset + 1u];
-                    const std::uint8_t b = bytes[paletteByteOffset + 2u];
-                    const std::uint8_t a = bytes[paletteByteOffset + 3u];
+                    const std::size_t paletteByteOffset = (paletteIndex - 1u) * 4u;
+                    const std::uint8_t r = content[paletteByteOffset + 0u];
+                    const std::uint8_t g = content[paletteByteOffset + 1u];
+                    const std::uint8_t b = content[paletteByteOffset + 2u];
+                    const std::uint8_t a = content[paletteByteOffset + 3u];
                     parsedPalette[paletteIndex] = packRgba(r, g, b, a);
                 }
                 palette = parsedPalette;
                 hasPalette = true;
             }
+        } else if (header.id == kChunkTransform || header.id == kChunkGroup || header.id == kChunkShape) {
+            content.resize(header.contentSize);
+            if (!readBytes(stream, content.data(), content.size())) {
+                return false;
+            }
+            if (!readSceneNode(header.id, content, sceneNodes)) {
+                return false;
+            }
         }
 
         cursor = childrenEnd;
     }
 
-    if (!loadedFirstModel || outModel.voxels.empty()) {
+    if (sceneNodes.empty()) {
+        // Files without a scene graph hold a single model at its own origin.
+        if (models.empty() || models.front().voxels.empty()) {
+            return false;
+        }
+        outModel.sizeX = models.front().sizeX;
+        outModel.sizeY = models.front().sizeY;
+        outModel.sizeZ = models.front().sizeZ;
+        outModel.voxels = std::move(models.front().voxels);
+    } else if (!composeSceneModel(models, sceneNodes, outModel)) {
         return false;
     }
 
@@ -669,7 +1356,7 @@ bool loadMagicaVoxelModel(const std::filesystem::path& path, MagicaVoxelModel& o
     return true;
 }
 
-std::vector<MagicaVoxelMeshChunk> buildMagicaVoxelMeshChunks(const MagicaVoxelModel& model) {
+std::vector<MagicaVoxelMeshChunk> buildMagicaVoxelMeshChunks(const MagicaVoxelModel& model, core::JobSystem* jobs) {
     std::vector<MagicaVoxelMeshChunk> chunks{};
 
     if (model.sizeX <= 0 || model.sizeY <= 0 || model.sizeZ <= 0 || model.voxels.empty()) {
@@ -680,241 +1367,208 @@ std::vector<MagicaVoxelMeshChunk> buildMagicaVoxelMeshChunks(const MagicaVoxelMo
     const int transformedSizeY = model.sizeZ;
     const int transformedSizeZ = model.sizeY;
 
-    std::vector<std::uint8_t> densePalette(
-        static_cast<std::size_t>(transformedSizeX * transformedSizeY * transformedSizeZ),
-        0u
-    );
-    std::array<std::uint32_t, 8> baseColorPaletteSlots{};
-    std::uint8_t baseColorPaletteSlotCount = 0u;
-
+    // Voxels are bucketed by mesh tile instead of filling one dense volume,
+    // so memory follows the voxel count rather than the model's bounds. A
+    // voxel also lands in every tile whose border it falls in; face and AO
+    // lookups read at most kTileBorder voxels past the tile.
+    constexpr int kTileExtent = 32;
+    constexpr int kTileBorder = 2;
+    struct TileBucket {
+        int tileX = 0;
+        int tileY = 0;
+        int tileZ = 0;
+        bool owned = false;
+        std::vector<MagicaVoxel> voxels;
+    };
+    const std::array<int, 3> lastTile = {
+        (transformedSizeX - 1) / kTileExtent,
+        (transformedSizeY - 1) / kTileExtent,
+        (transformedSizeZ - 1) / kTileExtent
+    };
+    std::vector<TileBucket> buckets;
+    std::unordered_map<std::uint64_t, std::size_t> bucketByTileKey;
+    const auto tileKey = [](int tileX, int tileY, int tileZ) {
+        // Ascending keys walk tiles z-major, then y, then x.
+        return (static_cast<std::uint64_t>(tileZ) << 42u) | (static_cast<std::uint64_t>(tileY) << 21u) |
+            static_cast<std::uint64_t>(tileX);
+    };
     for (const MagicaVoxel& voxel : model.voxels) {
-        const int transformedX = static_cast<int>(voxel.x);
-        const int transformedY = static_cast<int>(voxel.z);
-        const int transformedZ = static_cast<int>(voxel.y);
-        if (transformedX < 0 || transformedX >= transformedSizeX ||
-            transformedY < 0 || transformedY >= transformedSizeY ||
-            transformedZ < 0 || transformedZ >= transformedSizeZ) {
+        const std::array<int, 3> transformed = {
+            static_cast<int>(voxel.x),
+            static_cast<int>(voxel.z),
+            static_cast<int>(voxel.y)
+        };
+        if (transformed[0] >= transformedSizeX || transformed[1] >= transformedSizeY ||
+            transformed[2] >= transformedSizeZ) {
             continue;
         }
 
-        densePalette[denseIndex(transformedX, transformedY, transformedZ, transformedSizeX, transformedSizeY)] =
-            voxel.paletteIndex;
-    }
-
-    constexpr int kTileExtent = 32;
-    const int tileCountX = (transformedSizeX + (kTileExtent - 1)) / kTileExtent;
-    const int tileCountY = (transformedSizeY + (kTileExtent - 1)) / kTileExtent;
-    const int tileCountZ = (transformedSizeZ + (kTileExtent - 1)) / kTileExtent;
-    chunks.reserve(static_cast<std::size_t>(tileCountX * tileCountY * tileCountZ));
-
-    for (int tileZ = 0; tileZ < transformedSizeZ; tileZ += kTileExtent) {
-        const int tileEndZ = std::min(tileZ + kTileExtent, transformedSizeZ);
-        for (int tileY = 0; tileY < transformedSizeY; tileY += kTileExtent) {
-            const int tileEndY = std::min(tileY + kTileExtent, transformedSizeY);
-            for (int tileX = 0; tileX < transformedSizeX; tileX += kTileExtent) {
-                const int tileEndX = std::min(tileX + kTileExtent, transformedSizeX);
-
-                MagicaVoxelMeshChunk chunk{};
-                chunk.originX = tileX;
-                chunk.originY = tileY;
-                chunk.originZ = tileZ;
-                ChunkMeshData& mesh = chunk.mesh;
-                const int localSizeX = tileEndX - tileX;
-                const int localSizeY = tileEndY - tileY;
-                const int localSizeZ = tileEndZ - tileZ;
-                for (std::uint32_t faceId = 0; faceId < kFaceNeighbors.size(); ++faceId) {
-                    int sliceCount = 0;
-                    int uCount = 0;
-                    int vCount = 0;
-                    faceSliceDimensionsForVolume(
-                        faceId,
-                        localSizeX,
-                        localSizeY,
-                        localSizeZ,
-                        sliceCount,
-                        uCount,
-                        vCount
-                    );
-                    std::vector<std::uint32_t> mask(static_cast<std::size_t>(uCount * vCount), kEmptyMaskKey);
-
-                    for (int slice = 0; slice < sliceCount; ++slice) {
-                        std::fill(mask.begin(), mask.end(), kEmptyMaskKey);
-
-                        for (int v = 0; v < vCount; ++v) {
-                            for (int u = 0; u < uCount; ++u) {
-                                int localX = 0;
-                                int localY = 0;
-                                int localZ = 0;
-                                faceSliceCellToVoxel(faceId, slice, u, v, localX, localY, localZ);
-                                const int globalX = tileX + localX;
-                                const int globalY = tileY + localY;
-                                const int globalZ = tileZ + localZ;
-
-                                const std::uint8_t paletteIndex = densePalette[denseIndex(
-                                    globalX,
-                                    globalY,
-                                    globalZ,
-                                    transformedSizeX,
-                                    transformedSizeY
-                                )];
-                                if (paletteIndex == 0u) {
-                                    continue;
-                                }
-
-                                const FaceNeighbor& face = kFaceNeighbors[faceId];
-                                if (isSolid(
-                                        densePalette,
-                                        transformedSizeX,
-                                        transformedSizeY,
-                                        transformedSizeZ,
-                                        globalX + face.nx,
-                                        globalY + face.ny,
-                                        globalZ + face.nz
-                                    )) {
-                                    continue;
-                                }
-
-                                const std::uint32_t baseColorRgba = model.paletteRgba[paletteIndex];
-                                const std::uint8_t baseColorIndex = quantizeBaseColorIndex(
-                                    baseColorRgba,
-                                    baseColorPaletteSlots,
-                                    baseColorPaletteSlotCount
-                                );
-                                const std::uint8_t material = kMaterialPalette;
-                                const std::uint16_t aoSignature = faceCornerAoSignatureDense(
-                                    densePalette,
-                                    transformedSizeX,
-                                    transformedSizeY,
-                                    transformedSizeZ,
-                                    globalX,
-                                    globalY,
-                                    globalZ,
-                                    faceId
-                                );
-                                const std::size_t maskIndex = static_cast<std::size_t>(u + (v * uCount));
-                                mask[maskIndex] = makeMaskKey(material, aoSignature, baseColorIndex);
-                            }
-                        }
-
-                        for (int v = 0; v < vCount; ++v) {
-                            for (int u = 0; u < uCount;) {
-                                const std::size_t startIndex = static_cast<std::size_t>(u + (v * uCount));
-                                const std::uint32_t key = mask[startIndex];
-                                if (key == kEmptyMaskKey) {
-                                    ++u;
-                                    continue;
-                                }
-
-                                int width = 1;
-                                while ((u + width) < uCount) {
-                                    const std::size_t widthIndex = static_cast<std::size_t>((u + width) + (v * uCount));
-                                    if (mask[widthIndex] != key) {
-                                        break;
-                                    }
-                                    ++width;
-                                }
-
-                                int height = 1;
-                                bool canGrow = true;
-                                while ((v + height) < vCount && canGrow) {
-                                    for (int offsetU = 0; offsetU < width; ++offsetU) {
-                                        const std::size_t growIndex =
-                                            static_cast<std::size_t>((u + offsetU) + ((v + height) * uCount));
-                                        if (mask[growIndex] != key) {
-                                            canGrow = false;
-                                            break;
-                                        }
-                                    }
-                                    if (canGrow) {
-                                        ++height;
-                                    }
-                                }
-
-                                const std::uint8_t material =
-                                    static_cast<std::uint8_t>((key >> 19u) & PackedVoxelVertex::kMask3);
-                                const std::uint16_t aoSignature =
-                                    static_cast<std::uint16_t>((key >> 3u) & 0xFFFFu);
-                                const std::uint8_t baseColorIndex =
-                                    static_cast<std::uint8_t>(key & PackedVoxelVertex::kMask3);
-                                const bool mergedQuadAppended = appendGreedyFaceQuadLocal(
-                                    mesh,
-                                    faceId,
-                                    slice,
-                                    u,
-                                    v,
-                                    width,
-                                    height,
-                                    material,
-                                    aoSignature,
-                                    baseColorIndex,
-                                    0u,
-                                    localSizeX,
-                                    localSizeY,
-                                    localSizeZ
-                                );
-                                if (!mergedQuadAppended) {
-                                    for (int emitV = 0; emitV < height; ++emitV) {
-                                        for (int emitU = 0; emitU < width; ++emitU) {
-                                            int localX = 0;
-                                            int localY = 0;
-                                            int localZ = 0;
-                                            faceSliceCellToVoxel(faceId, slice, u + emitU, v + emitV, localX, localY, localZ);
-                                            const std::uint8_t paletteIndex = densePalette[denseIndex(
-                                                tileX + localX,
-                                                tileY + localY,
-                                                tileZ + localZ,
-                                                transformedSizeX,
-                                                transformedSizeY
-                                            )];
-                                            std::uint8_t fallbackBaseColorIndex = 0u;
-                                            if (paletteIndex != 0u) {
-                                                fallbackBaseColorIndex = quantizeBaseColorIndex(
-                                                    model.paletteRgba[paletteIndex],
-                                                    baseColorPaletteSlots,
-                                                    baseColorPaletteSlotCount
-                                                );
-                                            }
-                                            appendDenseVoxelFaceLocal(
-                                                mesh,
-                                                densePalette,
-                                                transformedSizeX,
-                                                transformedSizeY,
-                                                transformedSizeZ,
-                                                tileX + localX,
-                                                tileY + localY,
-                                                tileZ + localZ,
-                                                localX,
-                                                localY,
-                                                localZ,
-                                                faceId,
-                                                material,
-                                                fallbackBaseColorIndex
-                                            );
-                                        }
-                                    }
-                                }
-
-                                for (int clearV = 0; clearV < height; ++clearV) {
-                                    for (int clearU = 0; clearU < width; ++clearU) {
-                                        const std::size_t clearIndex =
-                                            static_cast<std::size_t>((u + clearU) + ((v + clearV) * uCount));
-                                        mask[clearIndex] = kEmptyMaskKey;
-                                    }
-                                }
-
-                                u += width;
-                            }
-                        }
+        std::array<int, 3> ownerTile{};
+        std::array<int, 3> firstTile{};
+        std::array<int, 3> endTile{};
+        for (std::size_t axis = 0; axis < 3u; ++axis) {
+            const int coordinate = transformed[axis];
+            ownerTile[axis] = coordinate / kTileExtent;
+            const int withinTile = coordinate % kTileExtent;
+            const bool inPreviousBorder = withinTile < kTileBorder && ownerTile[axis] > 0;
+            const bool inNextBorder = withinTile >= kTileExtent - kTileBorder && ownerTile[axis] < lastTile[axis];
+            firstTile[axis] = inPreviousBorder ? ownerTile[axis] - 1 : ownerTile[axis];
+            endTile[axis] = (inNextBorder ? ownerTile[axis] + 1 : ownerTile[axis]) + 1;
+        }
+        const MagicaVoxel transformedVoxel{
+            static_cast<std::uint16_t>(transformed[0]),
+            static_cast<std::uint16_t>(transformed[1]),
+            static_cast<std::uint16_t>(transformed[2]),
+            voxel.paletteIndex
+        };
+        for (int tileZ = firstTile[2]; tileZ < endTile[2]; ++tileZ) {
+            for (int tileY = firstTile[1]; tileY < endTile[1]; ++tileY) {
+                for (int tileX = firstTile[0]; tileX < endTile[0]; ++tileX) {
+                    const auto [it, inserted] = bucketByTileKey.try_emplace(tileKey(tileX, tileY, tileZ), buckets.size());
+                    if (inserted) {
+                        buckets.push_back(TileBucket{tileX, tileY, tileZ, false, {}});
+                    }
+                    TileBucket& bucket = buckets[it->second];
+                    bucket.voxels.push_back(transformedVoxel);
+                    if (tileX == ownerTile[0] && tileY == ownerTile[1] && tileZ == ownerTile[2]) {
+                        bucket.owned = true;
                     }
                 }
+            }
+        }
+    }
 
-                if (!mesh.indices.empty()) {
-                    chunks.push_back(std::move(chunk));
-                }
+    // Only tiles holding voxels of their own can emit faces.
+    std::vector<std::size_t> tileBuckets;
+    for (std::size_t bucketIndex = 0; bucketIndex < buckets.size(); ++bucketIndex) {
+        if (buckets[bucketIndex].owned) {
+            tileBuckets.push_back(bucketIndex);
+        }
+    }
+    std::sort(tileBuckets.begin(), tileBuckets.end(), [&](std::size_t a, std::size_t b) {
+        return tileKey(buckets[a].tileX, buckets[a].tileY, buckets[a].tileZ) <
+            tileKey(buckets[b].tileX, buckets[b].tileY, buckets[b].tileZ);
+    });
+    chunks.reserve(tileBuckets.size());
+    for (const std::size_t bucketIndex : tileBuckets) {
+        MagicaVoxelMeshChunk chunk{};
+        chunk.originX = buckets[bucketIndex].tileX * kTileExtent;
+        chunk.originY = buckets[bucketIndex].tileY * kTileExtent;
+        chunk.originZ = buckets[bucketIndex].tileZ * kTileExtent;
+        chunks.push_back(std::move(chunk));
+    }
+
+    const auto forEachTile = [&](auto&& fn) {
+        if (jobs != nullptr) {
+            core::parallelFor(*jobs, 0, chunks.size(), 1, fn);
+        } else {
+            for (std::size_t tileIndex = 0; tileIndex < chunks.size(); ++tileIndex) {
+                fn(tileIndex);
+            }
+        }
+    };
+    const auto tileExtent = [&](std::size_t tileIndex, int& outSizeX, int& outSizeY, int& outSizeZ) {
+        const MagicaVoxelMeshChunk& chunk = chunks[tileIndex];
+        outSizeX = std::min(chunk.originX + kTileExtent, transformedSizeX) - chunk.originX;
+        outSizeY = std::min(chunk.originY + kTileExtent, transformedSizeY) - chunk.originY;
+        outSizeZ = std::min(chunk.originZ + kTileExtent, transformedSizeZ) - chunk.originZ;
+    };
+    // Dense copy of one tile plus its border; the tile itself starts at
+    // (kTileBorder, kTileBorder, kTileBorder).
+    const auto fillTileVolume = [&](std::size_t tileIndex, int localSizeX, int localSizeY, int localSizeZ,
+                                    std::vector<std::uint8_t>& outVolume) {
+        const MagicaVoxelMeshChunk& chunk = chunks[tileIndex];
+        const int paddedSizeX = localSizeX + (2 * kTileBorder);
+        const int paddedSizeY = localSizeY + (2 * kTileBorder);
+        outVolume.assign(
+            static_cast<std::size_t>(paddedSizeX) * static_cast<std::size_t>(paddedSizeY) *
+                static_cast<std::size_t>(localSizeZ + (2 * kTileBorder)),
+            0u
+        );
+        for (const MagicaVoxel& voxel : buckets[tileBuckets[tileIndex]].voxels) {
+            outVolume[denseIndex(
+                static_cast<int>(voxel.x) - chunk.originX + kTileBorder,
+                static_cast<int>(voxel.y) - chunk.originY + kTileBorder,
+                static_cast<int>(voxel.z) - chunk.originZ + kTileBorder,
+                paddedSizeX,
+                paddedSizeY
+            )] = voxel.paletteIndex;
+        }
+    };
+
+    // Base color slots are handed out first come, first served, so they are
+    // resolved once up front in tile order; tiles then mesh independently.
+    std::vector<std::vector<std::uint8_t>> tilePaletteOrders(chunks.size());
+    forEachTile([&](std::size_t tileIndex) {
+        int localSizeX = 0;
+        int localSizeY = 0;
+        int localSizeZ = 0;
+        tileExtent(tileIndex, localSizeX, localSizeY, localSizeZ);
+        std::vector<std::uint8_t> tileVolume;
+        fillTileVolume(tileIndex, localSizeX, localSizeY, localSizeZ, tileVolume);
+        collectTilePaletteOrder(
+            tileVolume,
+            localSizeX + (2 * kTileBorder),
+            localSizeY + (2 * kTileBorder),
+            localSizeZ + (2 * kTileBorder),
+            kTileBorder,
+            kTileBorder,
+            kTileBorder,
+            localSizeX,
+            localSizeY,
+            localSizeZ,
+            tilePaletteOrders[tileIndex]
+        );
+    });
+    std::array<std::uint8_t, 256> baseColorIndexByPaletteIndex{};
+    std::array<bool, 256> paletteIndexResolved{};
+    std::array<std::uint32_t, 8> baseColorPaletteSlots{};
+    std::uint8_t baseColorPaletteSlotCount = 0u;
+    for (const std::vector<std::uint8_t>& paletteOrder : tilePaletteOrders) {
+        for (const std::uint8_t paletteIndex : paletteOrder) {
+            if (paletteIndexResolved[paletteIndex]) {
+                continue;
             }
+            paletteIndexResolved[paletteIndex] = true;
+            baseColorIndexByPaletteIndex[paletteIndex] = quantizeBaseColorIndex(
+                model.paletteRgba[paletteIndex],
+                baseColorPaletteSlots,
+                baseColorPaletteSlotCount
+            );
         }
     }
 
+    forEachTile([&](std::size_t tileIndex) {
+        int localSizeX = 0;
+        int localSizeY = 0;
+        int localSizeZ = 0;
+        tileExtent(tileIndex, localSizeX, localSizeY, localSizeZ);
+        std::vector<std::uint8_t> tileVolume;
+        fillTileVolume(tileIndex, localSizeX, localSizeY, localSizeZ, tileVolume);
+        meshMagicaTile(
+            tileVolume,
+            localSizeX + (2 * kTileBorder),
+            localSizeY + (2 * kTileBorder),
+            localSizeZ + (2 * kTileBorder),
+            kTileBorder,
+            kTileBorder,
+            kTileBorder,
+            localSizeX,
+            localSizeY,
+            localSizeZ,
+            baseColorIndexByPaletteIndex,
+            chunks[tileIndex].mesh
+        );
+    });
+
+    chunks.erase(
+        std::remove_if(
+            chunks.begin(),
+            chunks.end(),
+            [](const MagicaVoxelMeshChunk& chunk) { return chunk.mesh.indices.empty(); }
+        ),
+        chunks.end()
+    );
     return chunks;
 }
 
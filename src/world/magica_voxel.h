@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/job_system.h"
 #include "world/chunk_mesher.h"
 
 #include <array>
@@ -9,10 +10,12 @@
 
 namespace odai::world {
 
+// Coordinates are 16-bit: a single .vox model is at most 256 on a side, but a
+// composed multi-model scene can be larger.
 struct MagicaVoxel {
-    std::uint8_t x = 0;
-    std::uint8_t y = 0;
-    std::uint8_t z = 0;
+    std::uint16_t x = 0;
+    std::uint16_t y = 0;
+    std::uint16_t z = 0;
     std::uint8_t paletteIndex = 0;
 };
 
@@ -33,8 +36,17 @@ struct MagicaVoxelMeshChunk {
     ChunkMeshData mesh{};
 };
 
+// Streams the file chunk by chunk. Files with a scene graph (nTRN/nGRP/nSHP)
+// are flattened into one model: every visible shape is placed by its
+// transforms and the result is shifted so its bounds start at zero. Files
+// without one load their first model as stored.
 bool loadMagicaVoxelModel(const std::filesystem::path& path, MagicaVoxelModel& outModel);
-std::vector<MagicaVoxelMeshChunk> buildMagicaVoxelMeshChunks(const MagicaVoxelModel& model);
+// Meshes 32^3 tiles of the model; `jobs`, when given, meshes tiles in
+// parallel. The output is identical either way.
+std::vector<MagicaVoxelMeshChunk> buildMagicaVoxelMeshChunks(
+    const MagicaVoxelModel& model,
+    core::JobSystem* jobs = nullptr
+);
 ChunkMeshData buildMagicaVoxelMesh(const MagicaVoxelModel& model);
 
 } // namespace odai::world
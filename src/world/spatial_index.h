@@ -17,6 +17,13 @@ struct SpatialQueryStats {
     std::uint32_t clipmapUpdatedSlabCount = 0;
     std::uint32_t clipmapUpdatedBrickCount = 0;
     std::uint32_t clipmapResidentBrickCount = 0;
+    // CPU visibility culling after the spatial query (frustum, then Hi-Z
+    // occlusion against the occluders rasterized this frame).
+    std::uint32_t frustumCulledChunkCount = 0;
+    std::uint32_t occlusionCulledChunkCount = 0;
+    std::uint32_t frustumCulledPageCount = 0;
+    std::uint32_t occlusionCulledPageCount = 0;
+    std::uint32_t occluderCount = 0;
 };
 
 } // namespace odai::world
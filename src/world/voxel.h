@@ -22,6 +22,8 @@ struct Voxel {
     VoxelType type = VoxelType::Empty;
     // Optional 4-bit base-color index (0..15). 0xFF means "use material defaults".
     std::uint8_t baseColorIndex = 0xFFu;
+
+    [[nodiscard]] bool operator==(const Voxel&) const = default;
 };
 
 } // namespace odai::world
@@ -1,22 +1,47 @@
 #include "world/world.h"
 
+#include "core/job_system.h"
 #include "core/log.h"
+#include "core/parallel_for.h"
 #include "world/magica_voxel.h"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
 #include <limits>
 #include <string>
 #include <utility>
 #include <vector>
 
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace odai::world {
 
 namespace {
 
 constexpr int kStreamingCenterHysteresisVoxels = Chunk::kSizeX / 4;
 
+// Spill path for a world with no file on disk. The process id keeps
+// concurrent processes apart and the counter keeps worlds in one process apart.
+std::filesystem::path uniqueTempSpillPath() {
+    static std::atomic<std::uint32_t> s_spillFileCounter{0};
+#if defined(_WIN32)
+    const long long processId = _getpid();
+#else
+    const long long processId = static_cast<long long>(::getpid());
+#endif
+    return std::filesystem::temp_directory_path() /
+           ("odai_chunk_spill_" + std::to_string(processId) + "_" +
+            std::to_string(s_spillFileCounter.fetch_add(1u, std::memory_order_relaxed)) + ".bin");
+}
+
 int floorDiv(int value, int divisor) {
     int quotient = value / divisor;
     const int remainder = value % divisor;
@@ -26,6 +51,20 @@ int floorDiv(int value, int divisor) {
     return quotient;
 }
 
+// Moves the center chunk only once the camera is kStreamingCenterHysteresisVoxels
+// past the current center chunk's edge, so walking along a border does not
+// shift the window back and forth.
+int applyChunkCenterHysteresis(int worldCoord, int currentCenterChunk, int chunkSize) {
+    int centerChunk = currentCenterChunk;
+    while (worldCoord < ((centerChunk * chunkSize) - kStreamingCenterHysteresisVoxels)) {
+        --centerChunk;
+    }
+    while (worldCoord >= (((centerChunk + 1) * chunkSize) + kStreamingCenterHysteresisVoxels)) {
+        ++centerChunk;
+    }
+    return centerChunk;
+}
+
 template <typename ChunkType>
 bool worldToChunkLocalInChunks(
     std::span<ChunkType> chunks,
@@ -78,10 +117,6 @@ bool chunkKeyLess(const World::ChunkKey& a, const World::ChunkKey& b) {
     return a.chunkZ < b.chunkZ;
 }
 
-bool chunkLess(const Chunk& a, const Chunk& b) {
-    return chunkKeyLess(chunkKeyForChunk(a), chunkKeyForChunk(b));
-}
-
 MagicaVoxelModel downscaleMagicaModel(const MagicaVoxelModel& source, float scale) {
     if (scale <= 0.0f || scale >= 0.999f) {
         return source;
@@ -97,37 +132,39 @@ MagicaVoxelModel downscaleMagicaModel(const MagicaVoxelModel& source, float scal
     scaled.sizeY = scaledSizeY;
     scaled.sizeZ = scaledSizeZ;
 
-    const std::size_t cellCount =
-        static_cast<std::size_t>(scaledSizeX) * static_cast<std::size_t>(scaledSizeY) * static_cast<std::size_t>(scaledSizeZ);
-    std::vector<std::uint8_t> densePalette(cellCount, 0u);
-    auto denseIndex = [&](int x, int y, int z) -> std::size_t {
-        return static_cast<std::size_t>(x + (y * scaledSizeX) + (z * scaledSizeX * scaledSizeY));
+    // Sort voxels by scaled cell rather than filling a dense scaled volume,
+    // so memory follows the voxel count. The stable sort keeps the first
+    // source voxel of each cell, and cell order is z, then y, then x.
+    struct ScaledVoxel {
+        std::uint64_t cellKey = 0;
+        MagicaVoxel voxel{};
     };
-
+    std::vector<ScaledVoxel> scaledVoxels;
+    scaledVoxels.reserve(source.voxels.size());
     for (const MagicaVoxel& voxel : source.voxels) {
+        if (voxel.paletteIndex == 0u) {
+            continue;
+        }
         const int scaledX = std::clamp(static_cast<int>(std::floor(static_cast<float>(voxel.x) * scale)), 0, scaledSizeX - 1);
         const int scaledY = std::clamp(static_cast<int>(std::floor(static_cast<float>(voxel.y) * scale)), 0, scaledSizeY - 1);
         const int scaledZ = std::clamp(static_cast<int>(std::floor(static_cast<float>(voxel.z) * scale)), 0, scaledSizeZ - 1);
-        const std::size_t index = denseIndex(scaledX, scaledY, scaledZ);
-        if (densePalette[index] == 0u) {
-            densePalette[index] = voxel.paletteIndex;
-        }
-    }
-
-    for (int z = 0; z < scaledSizeZ; ++z) {
-        for (int y = 0; y < scaledSizeY; ++y) {
-            for (int x = 0; x < scaledSizeX; ++x) {
-                const std::uint8_t paletteIndex = densePalette[denseIndex(x, y, z)];
-                if (paletteIndex == 0u) {
-                    continue;
-                }
-                scaled.voxels.push_back(MagicaVoxel{
-                    static_cast<std::uint8_t>(x),
-                    static_cast<std::uint8_t>(y),
-                    static_cast<std::uint8_t>(z),
-                    paletteIndex
-                });
+        scaledVoxels.push_back(ScaledVoxel{
+            (static_cast<std::uint64_t>(scaledZ) << 32u) | (static_cast<std::uint64_t>(scaledY) << 16u) |
+                static_cast<std::uint64_t>(scaledX),
+            MagicaVoxel{
+                static_cast<std::uint16_t>(scaledX),
+                static_cast<std::uint16_t>(scaledY),
+                static_cast<std::uint16_t>(scaledZ),
+                voxel.paletteIndex
             }
+        });
+    }
+    std::stable_sort(scaledVoxels.begin(), scaledVoxels.end(), [](const ScaledVoxel& a, const ScaledVoxel& b) {
+        return a.cellKey < b.cellKey;
+    });
+    for (std::size_t index = 0; index < scaledVoxels.size(); ++index) {
+        if (index == 0u || scaledVoxels[index].cellKey != scaledVoxels[index - 1u].cellKey) {
+            scaled.voxels.push_back(scaledVoxels[index].voxel);
         }
     }
 
@@ -213,14 +250,60 @@ std::uint8_t quantizeBaseColorIndex(
     return nearestSlot;
 }
 
+// One voxel of a Magica resource, in its destination chunk's local space.
+struct MagicaStampEdit {
+    std::uint8_t localX = 0;
+    std::uint8_t localY = 0;
+    std::uint8_t localZ = 0;
+    Voxel voxel{};
+};
+
+struct MagicaStampBucket {
+    ChunkHandle handle{};
+    Chunk* chunk = nullptr;
+    std::vector<MagicaStampEdit> edits;
+};
+
+// Bucket index of chunk keys with no stored chunk (their voxels are clipped).
+constexpr std::size_t kNoMagicaStampBucket = std::numeric_limits<std::size_t>::max();
+
 } // namespace
 
-bool World::loadOrInitialize(const std::filesystem::path& worldPath, LoadResult* outResult) {
+struct World::PendingSave {
+    std::filesystem::path worldPath;
+    // The file the snapshot's clean chunks live in; the worker maps its own
+    // view of it so the main thread's reader stays free to page chunks in.
+    std::filesystem::path sourcePath;
+    std::vector<Chunk> dirtyChunks;
+    std::uint64_t snapshotGeneration = 0;
+    core::JobSystem* jobs = nullptr;
+    core::JobCounter counter;
+    WorldFileWriteProgress progress;
+    // Written by the worker, read only after `counter` reaches zero.
+    WorldFileWriteStats writeStats{};
+    bool written = false;
+};
+
+World::World() = default;
+
+World::~World() {
+    (void)waitForSave();
+}
+
+bool World::loadOrInitialize(const std::filesystem::path& worldPath, LoadResult* outResult, core::JobSystem* jobs) {
     LoadResult result{};
-    if (m_chunkGrid.loadFromBinaryFile(worldPath)) {
-        m_chunkStorage = m_chunkGrid.chunks();
-        rebuildChunkStorageIndex();
-        (void)syncResidentChunkGrid(0, 0);
+    (void)waitForSave();
+    m_worldFile.close();
+    m_savedGeneration = m_editGeneration;
+    m_spillPath = worldPath;
+    m_spillPath += ".spill";
+    if (isIndexedWorldFile(worldPath) && m_worldFile.open(worldPath)) {
+        clearChunkStorage();
+        m_streamingStats = ChunkStreamingStats{};
+        const ChunkStreamingUpdate initialUpdate = syncResidentChunkGrid(0, 0, 0);
+        VOX_LOGI("world") << "opened world file '" << worldPath.string() << "'"
+                          << " chunks=" << m_worldFile.entries().size()
+                          << ", pagedIn=" << initialUpdate.stats.pagedInChunkCount;
         result.loadedFromFile = true;
         if (outResult != nullptr) {
             *outResult = result;
@@ -228,10 +311,25 @@ bool World::loadOrInitialize(const std::filesystem::path& worldPath, LoadResult*
         return true;
     }
 
-    m_chunkGrid.initializeEmptyWorld();
-    m_chunkStorage.clear();
-    m_chunkStorageIndexByKey.clear();
-    m_chunkGrid.chunks().clear();
+    ChunkGrid legacyGrid;
+    if (legacyGrid.loadFromBinaryFile(worldPath, jobs)) {
+        clearChunkStorage();
+        // Nothing of a legacy file is in VXW4 yet: the first save encodes it all.
+        const std::uint64_t legacyGeneration = ++m_editGeneration;
+        for (Chunk& chunk : legacyGrid.chunks()) {
+            const ChunkKey key = chunkKeyForChunk(chunk);
+            (void)appendStoredChunk(key, std::move(chunk), legacyGeneration);
+        }
+        m_streamingStats = ChunkStreamingStats{};
+        (void)syncResidentChunkGrid(0, 0, 0);
+        result.loadedFromFile = true;
+        if (outResult != nullptr) {
+            *outResult = result;
+        }
+        return true;
+    }
+
+    clearChunkStorage();
     m_streamingStats = ChunkStreamingStats{};
     result.initializedFallback = true;
     if (outResult != nullptr) {
@@ -240,25 +338,168 @@ bool World::loadOrInitialize(const std::filesystem::path& worldPath, LoadResult*
     return false;
 }
 
-bool World::save(const std::filesystem::path& worldPath) const {
-    ChunkGrid storageGrid;
-    std::vector<Chunk> sortedChunks = m_chunkStorage;
-    std::sort(sortedChunks.begin(), sortedChunks.end(), chunkLess);
-    storageGrid.setChunks(std::move(sortedChunks));
-    return storageGrid.saveToBinaryFile(worldPath);
+bool World::save(const std::filesystem::path& worldPath) {
+    (void)waitForSave();
+    // VXW4 looks chunks up through its directory, so storage order is fine and
+    // no sorted copy of the stored chunks is needed.
+    const std::uint64_t snapshotGeneration = m_editGeneration;
+    std::vector<Chunk> dirtyChunks;
+    if (!snapshotDirtyChunks(dirtyChunks)) {
+        return false;
+    }
+    WorldFileWriteStats writeStats{};
+    if (!writeWorldFileContents(worldPath, dirtyChunks, &m_worldFile, nullptr, &writeStats)) {
+        return false;
+    }
+    return commitSave(worldPath, writeStats, snapshotGeneration);
+}
+
+bool World::beginSave(const std::filesystem::path& worldPath, core::JobSystem& jobs) {
+    if (m_pendingSave != nullptr) {
+        return false;
+    }
+    std::vector<Chunk> dirtyChunks;
+    if (!snapshotDirtyChunks(dirtyChunks)) {
+        return false;
+    }
+    m_pendingSave = std::make_unique<PendingSave>();
+    PendingSave* pending = m_pendingSave.get();
+    pending->worldPath = worldPath;
+    pending->sourcePath = m_worldFile.isOpen() ? m_worldFile.path() : std::filesystem::path{};
+    pending->dirtyChunks = std::move(dirtyChunks);
+    pending->snapshotGeneration = m_editGeneration;
+    pending->jobs = &jobs;
+    pending->progress.chunkCount.store(
+        static_cast<std::uint32_t>(pending->dirtyChunks.size() + m_worldFile.entries().size()),
+        std::memory_order_relaxed
+    );
+    jobs.enqueue(
+        [pending]() {
+            WorldFileReader source;
+            if (!pending->sourcePath.empty() && !source.open(pending->sourcePath)) {
+                return;
+            }
+            pending->written = writeWorldFileContents(
+                pending->worldPath,
+                pending->dirtyChunks,
+                &source,
+                nullptr,
+                &pending->writeStats,
+                &pending->progress
+            );
+        },
+        core::JobPriority::Low,
+        &pending->counter
+    );
+    return true;
+}
+
+World::SaveProgress World::pollSave() {
+    SaveProgress progress{};
+    if (m_pendingSave == nullptr) {
+        return progress;
+    }
+    progress.chunksWritten = m_pendingSave->progress.chunksWritten.load(std::memory_order_relaxed);
+    progress.chunkCount = m_pendingSave->progress.chunkCount.load(std::memory_order_relaxed);
+    progress.dirtyChunkCount = static_cast<std::uint32_t>(m_pendingSave->dirtyChunks.size());
+    if (!m_pendingSave->counter.done()) {
+        progress.state = SaveState::Writing;
+        return progress;
+    }
+    progress.state = finishPendingSave() ? SaveState::Committed : SaveState::Failed;
+    return progress;
+}
+
+bool World::waitForSave() {
+    return m_pendingSave == nullptr || finishPendingSave();
+}
+
+bool World::isSaveInFlight() const {
+    return m_pendingSave != nullptr;
+}
+
+bool World::hasUnsavedChanges() const {
+    // Spilled chunks are dropped from the spill file once a save writes them.
+    bool unsaved = m_spillFile.chunkCount() != 0;
+    m_chunkStorage.forEach([&](ChunkHandle, const Chunk&, std::uint64_t editGeneration) {
+        unsaved = unsaved || editGeneration > m_savedGeneration;
+    });
+    return unsaved;
+}
+
+bool World::finishPendingSave() {
+    const std::unique_ptr<PendingSave> pending = std::move(m_pendingSave);
+    // Also guarantees the worker has let go of the counter before it is freed.
+    pending->jobs->wait(pending->counter);
+    if (!pending->written) {
+        VOX_LOGE("world") << "background save of '" << pending->worldPath.string() << "' failed";
+        return false;
+    }
+    return commitSave(pending->worldPath, pending->writeStats, pending->snapshotGeneration);
+}
+
+bool World::commitSave(
+    const std::filesystem::path& worldPath,
+    const WorldFileWriteStats& writeStats,
+    std::uint64_t snapshotGeneration
+) {
+    const std::filesystem::path sourcePath = m_worldFile.path();
+    if (!commitWorldFile(worldPath, &m_worldFile)) {
+        if (!sourcePath.empty() && !m_worldFile.isOpen()) {
+            (void)m_worldFile.open(sourcePath);
+        }
+        return false;
+    }
+    // The new file holds every chunk up to the snapshot, so it becomes the
+    // source that unpaged and clean chunks are read and copied from.
+    if (!m_worldFile.open(worldPath)) {
+        VOX_LOGE("world") << "saved world file '" << worldPath.string() << "' could not be reopened";
+        if (!sourcePath.empty()) {
+            (void)m_worldFile.open(sourcePath);
+        }
+        return false;
+    }
+    m_savedGeneration = std::max(m_savedGeneration, snapshotGeneration);
+    m_spillFile.forgetUpTo(m_savedGeneration);
+    VOX_LOGI("world") << "save binary '" << worldPath.string() << "'"
+                      << " version=" << kWorldFileVersion
+                      << ", encoded=" << writeStats.encodedChunkCount
+                      << ", copied=" << writeStats.copiedChunkCount
+                      << ", bytes=" << writeStats.fileBytes
+                      << ", encodeMs=" << writeStats.encodeMs
+                      << ", ioMs=" << writeStats.ioMs;
+    return true;
+}
+
+bool World::snapshotDirtyChunks(std::vector<Chunk>& outChunks) {
+    outChunks.clear();
+    m_chunkStorage.forEach([&](ChunkHandle, const Chunk& chunk, std::uint64_t editGeneration) {
+        if (editGeneration > m_savedGeneration) {
+            outChunks.push_back(chunk);
+        }
+    });
+    // Skipping a spilled chunk would mark its edits saved without writing them.
+    if (!m_spillFile.readNewerThan(m_savedGeneration, outChunks)) {
+        VOX_LOGE("world") << "save aborted: spilled chunks could not be read back";
+        return false;
+    }
+    return true;
 }
 
 void World::regenerateFlatWorld() {
-    m_chunkStorage.clear();
-    m_chunkStorageIndexByKey.clear();
-    m_chunkGrid.chunks().clear();
+    (void)waitForSave();
+    m_worldFile.close();
+    m_savedGeneration = m_editGeneration;
+    clearChunkStorage();
     m_streamingStats = ChunkStreamingStats{};
-    (void)syncResidentChunkGrid(m_streamingStats.centerChunkX, m_streamingStats.centerChunkZ);
+    (void)syncResidentChunkGrid(m_streamingStats.centerChunkX, m_streamingStats.centerChunkY, m_streamingStats.centerChunkZ);
 }
 
 void World::setStreamingConfig(const ChunkStreamingConfig& config) {
     m_streamingConfig.radiusChunksX = std::max(0, config.radiusChunksX);
     m_streamingConfig.radiusChunksZ = std::max(0, config.radiusChunksZ);
+    m_streamingConfig.radiusChunksY = std::max(0, config.radiusChunksY);
+    m_streamingConfig.nonResidentBudgetBytes = config.nonResidentBudgetBytes;
 }
 
 World::ChunkStreamingConfig World::streamingConfig() const {
@@ -266,25 +507,57 @@ World::ChunkStreamingConfig World::streamingConfig() const {
 }
 
 World::ChunkStreamingUpdate World::updateStreamingWindowForWorldPosition(float worldX, float worldZ) {
-    const int flooredWorldX = static_cast<int>(std::floor(worldX));
-    const int flooredWorldZ = static_cast<int>(std::floor(worldZ));
-    int centerChunkX = m_streamingStats.centerChunkX;
-    int centerChunkZ = m_streamingStats.centerChunkZ;
-
-    const auto applyChunkCenterHysteresis = [](int worldCoord, int currentCenterChunk, int chunkSize) {
-        int centerChunk = currentCenterChunk;
-        while (worldCoord < ((centerChunk * chunkSize) - kStreamingCenterHysteresisVoxels)) {
-            --centerChunk;
-        }
-        while (worldCoord >= (((centerChunk + 1) * chunkSize) + kStreamingCenterHysteresisVoxels)) {
-            ++centerChunk;
-        }
-        return centerChunk;
-    };
+    const int centerChunkX = applyChunkCenterHysteresis(
+        static_cast<int>(std::floor(worldX)), m_streamingStats.centerChunkX, Chunk::kSizeX);
+    const int centerChunkZ = applyChunkCenterHysteresis(
+        static_cast<int>(std::floor(worldZ)), m_streamingStats.centerChunkZ, Chunk::kSizeZ);
+    const int centerChunkY = m_streamingConfig.radiusChunksY > 0 ? m_streamingStats.centerChunkY : 0;
+    return syncResidentChunkGrid(centerChunkX, centerChunkY, centerChunkZ);
+}
 
-    centerChunkX = applyChunkCenterHysteresis(flooredWorldX, centerChunkX, Chunk::kSizeX);
-    centerChunkZ = applyChunkCenterHysteresis(flooredWorldZ, centerChunkZ, Chunk::kSizeZ);
-    return syncResidentChunkGrid(centerChunkX, centerChunkZ);
+World::ChunkStreamingUpdate World::updateStreamingWindowForWorldPosition(float worldX, float worldY, float worldZ) {
+    const int centerChunkX = applyChunkCenterHysteresis(
+        static_cast<int>(std::floor(worldX)), m_streamingStats.centerChunkX, Chunk::kSizeX);
+    const int centerChunkZ = applyChunkCenterHysteresis(
+        static_cast<int>(std::floor(worldZ)), m_streamingStats.centerChunkZ, Chunk::kSizeZ);
+    const int centerChunkY = m_streamingConfig.radiusChunksY > 0
+        ? applyChunkCenterHysteresis(static_cast<int>(std::floor(worldY)), m_streamingStats.centerChunkY, Chunk::kSizeY)
+        : 0;
+    return syncResidentChunkGrid(centerChunkX, centerChunkY, centerChunkZ);
+}
+
+std::vector<World::ChunkKey> World::streamingWindowKeys(
+    const ChunkStreamingConfig& config,
+    int centerChunkX,
+    int centerChunkY,
+    int centerChunkZ,
+    int marginChunks
+) {
+    const int margin = std::max(0, marginChunks);
+    const int radiusX = std::max(0, config.radiusChunksX) + margin;
+    const int radiusZ = std::max(0, config.radiusChunksZ) + margin;
+    const int radiusY = config.radiusChunksY > 0 ? config.radiusChunksY + margin : 0;
+    const int maxRing = std::max(radiusX, radiusZ);
+
+    std::vector<ChunkKey> keys;
+    keys.reserve(static_cast<std::size_t>(((radiusX * 2) + 1) * ((radiusY * 2) + 1) * ((radiusZ * 2) + 1)));
+    // Ring by ring outward from the camera column; each ring is already in
+    // (|dy|, dy, z, x) order, so no sort is needed.
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        for (int layer = 0; layer <= (radiusY * 2); ++layer) {
+            // 0, -1, +1, -2, +2, ...
+            const int dy = (layer % 2 == 0) ? (layer / 2) : -((layer + 1) / 2);
+            for (int dz = -std::min(ring, radiusZ); dz <= std::min(ring, radiusZ); ++dz) {
+                for (int dx = -std::min(ring, radiusX); dx <= std::min(ring, radiusX); ++dx) {
+                    if (std::max(std::abs(dx), std::abs(dz)) != ring) {
+                        continue;
+                    }
+                    keys.push_back(ChunkKey{centerChunkX + dx, centerChunkY + dy, centerChunkZ + dz});
+                }
+            }
+        }
+    }
+    return keys;
 }
 
 const World::ChunkStreamingStats& World::streamingStats() const {
@@ -292,60 +565,83 @@ const World::ChunkStreamingStats& World::streamingStats() const {
 }
 
 bool World::setVoxelAtWorld(int worldX, int worldY, int worldZ, Voxel voxel) {
-    bool updated = false;
     const ChunkKey storageKey{
         floorDiv(worldX, Chunk::kSizeX),
         floorDiv(worldY, Chunk::kSizeY),
         floorDiv(worldZ, Chunk::kSizeZ)
     };
-    const auto storageIt = m_chunkStorageIndexByKey.find(storageKey);
-    if (storageIt != m_chunkStorageIndexByKey.end() && storageIt->second < m_chunkStorage.size()) {
-        const Chunk& storageChunk = m_chunkStorage[storageIt->second];
-        const int localX = worldX - (storageChunk.chunkX() * Chunk::kSizeX);
-        const int localY = worldY - (storageChunk.chunkY() * Chunk::kSizeY);
-        const int localZ = worldZ - (storageChunk.chunkZ() * Chunk::kSizeZ);
-        m_chunkStorage[storageIt->second].setVoxel(localX, localY, localZ, voxel);
-        updated = true;
-    }
-    std::size_t chunkIndex = 0;
-    int localX = 0;
-    int localY = 0;
-    int localZ = 0;
-    if (worldToChunkLocalInChunks(
-            std::span<Chunk>(m_chunkGrid.chunks()),
-            worldX,
-            worldY,
-            worldZ,
-            chunkIndex,
-            localX,
-            localY,
-            localZ)) {
-        m_chunkGrid.chunks()[chunkIndex].setVoxel(localX, localY, localZ, voxel);
-        updated = true;
-    }
-    return updated;
-}
-
-bool World::insertGeneratedChunk(const ChunkKey& key, Chunk chunk) {
-    if (m_chunkStorageIndexByKey.contains(key)) {
+    const auto handleIt = m_chunkHandleByKey.find(storageKey);
+    if (handleIt == m_chunkHandleByKey.end()) {
         return false;
     }
-    m_chunkStorageIndexByKey[key] = m_chunkStorage.size();
-    m_chunkStorage.push_back(std::move(chunk));
+    // Resident or not, the chunk has exactly one copy to patch.
+    Chunk* chunk = m_chunkStorage.find(handleIt->second);
+    if (chunk == nullptr) {
+        return false;
+    }
+    const int localX = worldX - (chunk->chunkX() * Chunk::kSizeX);
+    const int localY = worldY - (chunk->chunkY() * Chunk::kSizeY);
+    const int localZ = worldZ - (chunk->chunkZ() * Chunk::kSizeZ);
+    chunk->setVoxel(localX, localY, localZ, voxel);
+    markStoredChunkEdited(handleIt->second);
     return true;
 }
 
-World::MagicaStampResult World::stampMagicaResources(std::span<const MagicaStampSpec> specs) {
+bool World::hasChunk(const ChunkKey& key) const {
+    return m_chunkHandleByKey.contains(key) || m_spillFile.contains(key.chunkX, key.chunkY, key.chunkZ) ||
+           (m_worldFile.isOpen() && m_worldFile.findChunk(key.chunkX, key.chunkY, key.chunkZ) != nullptr);
+}
+
+bool World::insertGeneratedChunk(const ChunkKey& key, Chunk chunk, bool procedural) {
+    if (hasChunk(key)) {
+        return false;
+    }
+    (void)appendStoredChunk(key, std::move(chunk), ++m_editGeneration, procedural);
+    return true;
+}
+
+World::MagicaStampResult World::stampMagicaResources(std::span<const MagicaStampSpec> specs, core::JobSystem* jobs) {
+    using Clock = std::chrono::steady_clock;
     MagicaStampResult result{};
 
-    for (const MagicaStampSpec& spec : specs) {
+    // Loading touches no world state, so every resource loads at once.
+    const auto loadStart = Clock::now();
+    std::vector<std::filesystem::path> magicaPaths(specs.size());
+    std::vector<MagicaVoxelModel> magicaModels(specs.size());
+    std::vector<std::uint8_t> magicaLoaded(specs.size(), 0u);
+    const auto loadSpec = [&](std::size_t specIndex) {
+        const MagicaStampSpec& spec = specs[specIndex];
+        if (spec.relativePath == nullptr || spec.relativePath[0] == '\0') {
+            return;
+        }
+        magicaPaths[specIndex] = resolveAssetPath(std::filesystem::path{spec.relativePath});
+        MagicaVoxelModel loadedModel{};
+        if (!loadMagicaVoxelModel(magicaPaths[specIndex], loadedModel)) {
+            return;
+        }
+        magicaModels[specIndex] = downscaleMagicaModel(loadedModel, spec.uniformScale);
+        magicaLoaded[specIndex] = 1u;
+    };
+    if (jobs != nullptr) {
+        core::parallelFor(*jobs, 0, specs.size(), 1, loadSpec);
+    } else {
+        for (std::size_t specIndex = 0; specIndex < specs.size(); ++specIndex) {
+            loadSpec(specIndex);
+        }
+    }
+    const auto stampStart = Clock::now();
+    result.loadMs = std::chrono::duration<double, std::milli>(stampStart - loadStart).count();
+
+    std::vector<MagicaStampBucket> buckets;
+    std::unordered_map<ChunkKey, std::size_t, ChunkKeyHash> bucketIndexByKey;
+    for (std::size_t specIndex = 0; specIndex < specs.size(); ++specIndex) {
+        const MagicaStampSpec& spec = specs[specIndex];
         if (spec.relativePath == nullptr || spec.relativePath[0] == '\0') {
             continue;
         }
 
-        const std::filesystem::path magicaPath = resolveAssetPath(std::filesystem::path{spec.relativePath});
-        MagicaVoxelModel loadedModel{};
-        if (!loadMagicaVoxelModel(magicaPath, loadedModel)) {
+        const std::filesystem::path& magicaPath = magicaPaths[specIndex];
+        if (magicaLoaded[specIndex] == 0u) {
             std::error_code cwdError;
             const std::filesystem::path cwd = std::filesystem::current_path(cwdError);
             VOX_LOGW("world") << "failed to load magica resource at "
@@ -354,7 +650,7 @@ World::MagicaStampResult World::stampMagicaResources(std::span<const MagicaStamp
             continue;
         }
 
-        const MagicaVoxelModel magicaModel = downscaleMagicaModel(loadedModel, spec.uniformScale);
+        const MagicaVoxelModel& magicaModel = magicaModels[specIndex];
         const int transformedSizeX = magicaModel.sizeX;
         const int transformedSizeZ = magicaModel.sizeY;
         const int worldOriginX =
@@ -363,12 +659,29 @@ World::MagicaStampResult World::stampMagicaResources(std::span<const MagicaStamp
         const int worldOriginZ =
             static_cast<int>(std::lround(spec.placementZ - (0.5f * static_cast<float>(transformedSizeZ))));
 
+        std::array<VoxelType, 256> voxelTypeByPaletteIndex{};
+        for (std::size_t paletteIndex = 0; paletteIndex < voxelTypeByPaletteIndex.size(); ++paletteIndex) {
+            voxelTypeByPaletteIndex[paletteIndex] = voxelTypeForMagicaRgba(magicaModel.paletteRgba[paletteIndex]);
+        }
+        // Resolved on first use, in voxel order, so the shared base color
+        // palette fills exactly as it would voxel by voxel.
+        std::array<std::int16_t, 256> baseColorIndexByPaletteIndex{};
+        baseColorIndexByPaletteIndex.fill(-1);
+
+        // Bucket the voxels by destination chunk, keeping their order within
+        // each chunk so overlapping voxels resolve as before.
+        for (MagicaStampBucket& bucket : buckets) {
+            bucket.edits.clear();
+        }
+        std::size_t bucketCount = 0;
+        bucketIndexByKey.clear();
         std::uint64_t resourceStamped = 0;
         std::uint64_t resourceClipped = 0;
-
+        ChunkKey lastKey{};
+        std::size_t lastBucketIndex = kNoMagicaStampBucket;
+        bool haveLastKey = false;
         for (const MagicaVoxel& voxel : magicaModel.voxels) {
-            const std::uint32_t paletteRgba = magicaModel.paletteRgba[voxel.paletteIndex];
-            const VoxelType voxelType = voxelTypeForMagicaRgba(paletteRgba);
+            const VoxelType voxelType = voxelTypeByPaletteIndex[voxel.paletteIndex];
             if (voxelType == VoxelType::Empty) {
                 continue;
             }
@@ -382,25 +695,69 @@ World::MagicaStampResult World::stampMagicaResources(std::span<const MagicaStamp
                 floorDiv(worldY, Chunk::kSizeY),
                 floorDiv(worldZ, Chunk::kSizeZ)
             };
-            const auto storageIt = m_chunkStorageIndexByKey.find(storageKey);
-            if (storageIt == m_chunkStorageIndexByKey.end() || storageIt->second >= m_chunkStorage.size()) {
+            if (!haveLastKey || !(storageKey == lastKey)) {
+                const auto [bucketIt, inserted] = bucketIndexByKey.try_emplace(storageKey, kNoMagicaStampBucket);
+                if (inserted) {
+                    const auto handleIt = m_chunkHandleByKey.find(storageKey);
+                    Chunk* chunk =
+                        (handleIt != m_chunkHandleByKey.end()) ? m_chunkStorage.find(handleIt->second) : nullptr;
+                    if (chunk != nullptr) {
+                        if (bucketCount == buckets.size()) {
+                            buckets.emplace_back();
+                        }
+                        buckets[bucketCount].handle = handleIt->second;
+                        buckets[bucketCount].chunk = chunk;
+                        bucketIt->second = bucketCount;
+                        ++bucketCount;
+                    }
+                }
+                lastKey = storageKey;
+                lastBucketIndex = bucketIt->second;
+                haveLastKey = true;
+            }
+            if (lastBucketIndex == kNoMagicaStampBucket) {
                 ++resourceClipped;
                 continue;
             }
 
-            Chunk& chunk = m_chunkStorage[storageIt->second];
-            const int localX = worldX - (chunk.chunkX() * Chunk::kSizeX);
-            const int localY = worldY - (chunk.chunkY() * Chunk::kSizeY);
-            const int localZ = worldZ - (chunk.chunkZ() * Chunk::kSizeZ);
-            const std::uint8_t baseColorIndex = quantizeBaseColorIndex(
-                paletteRgba,
-                result.baseColorPalette,
-                result.baseColorPaletteCount
-            );
-            chunk.setVoxel(localX, localY, localZ, Voxel{voxelType, baseColorIndex});
+            std::int16_t& baseColorIndex = baseColorIndexByPaletteIndex[voxel.paletteIndex];
+            if (baseColorIndex < 0) {
+                baseColorIndex = static_cast<std::int16_t>(quantizeBaseColorIndex(
+                    magicaModel.paletteRgba[voxel.paletteIndex],
+                    result.baseColorPalette,
+                    result.baseColorPaletteCount
+                ));
+            }
+            buckets[lastBucketIndex].edits.push_back(MagicaStampEdit{
+                static_cast<std::uint8_t>(worldX - (storageKey.chunkX * Chunk::kSizeX)),
+                static_cast<std::uint8_t>(worldY - (storageKey.chunkY * Chunk::kSizeY)),
+                static_cast<std::uint8_t>(worldZ - (storageKey.chunkZ * Chunk::kSizeZ)),
+                Voxel{voxelType, static_cast<std::uint8_t>(baseColorIndex)}
+            });
             ++resourceStamped;
         }
 
+        // Each bucket is one batched edit of its own chunk, so buckets apply
+        // independently and each macro cell resyncs once.
+        const auto applyBucket = [&](std::size_t bucketIndex) {
+            MagicaStampBucket& bucket = buckets[bucketIndex];
+            bucket.chunk->beginEdit();
+            for (const MagicaStampEdit& edit : bucket.edits) {
+                bucket.chunk->setVoxel(edit.localX, edit.localY, edit.localZ, edit.voxel);
+            }
+            bucket.chunk->endEdit();
+        };
+        if (jobs != nullptr) {
+            core::parallelFor(*jobs, 0, bucketCount, 1, applyBucket);
+        } else {
+            for (std::size_t bucketIndex = 0; bucketIndex < bucketCount; ++bucketIndex) {
+                applyBucket(bucketIndex);
+            }
+        }
+        for (std::size_t bucketIndex = 0; bucketIndex < bucketCount; ++bucketIndex) {
+            markStoredChunkEdited(buckets[bucketIndex].handle);
+        }
+
         if (resourceStamped == 0) {
             VOX_LOGW("world") << "magica resource stamped no world voxels: "
                                << std::filesystem::absolute(magicaPath).string()
@@ -411,29 +768,78 @@ World::MagicaStampResult World::stampMagicaResources(std::span<const MagicaStamp
         ++result.stampedResourceCount;
         result.stampedVoxelCount += resourceStamped;
         result.clippedVoxelCount += resourceClipped;
+        result.stampedChunkBatchCount += static_cast<std::uint32_t>(bucketCount);
         VOX_LOGI("world") << "stamped magica resource " << std::filesystem::absolute(magicaPath).string()
-                           << " (" << resourceStamped << " voxels, clipped=" << resourceClipped
+                           << " (" << resourceStamped << " voxels in " << bucketCount
+                           << " chunks, clipped=" << resourceClipped
                            << ", scale=" << spec.uniformScale << ")";
     }
 
-    (void)syncResidentChunkGrid(m_streamingStats.centerChunkX, m_streamingStats.centerChunkZ);
+    result.stampMs = std::chrono::duration<double, std::milli>(Clock::now() - stampStart).count();
     return result;
 }
 
-void World::rebuildChunkStorageIndex() {
-    m_chunkStorageIndexByKey.clear();
-    m_chunkStorageIndexByKey.reserve(m_chunkStorage.size() * 2u);
-    for (std::size_t chunkIndex = 0; chunkIndex < m_chunkStorage.size(); ++chunkIndex) {
-        m_chunkStorageIndexByKey[chunkKeyForChunk(m_chunkStorage[chunkIndex])] = chunkIndex;
+ChunkHandle World::appendStoredChunk(
+    const ChunkKey& key,
+    Chunk chunk,
+    std::uint64_t editGeneration,
+    bool regenerable
+) {
+    const ChunkHandle handle = m_chunkStorage.insert(std::move(chunk), editGeneration, regenerable);
+    m_chunkHandleByKey[key] = handle;
+    return handle;
+}
+
+void World::markStoredChunkEdited(ChunkHandle handle) {
+    m_chunkStorage.markEdited(handle, ++m_editGeneration);
+}
+
+void World::evictOverBudget(ChunkStreamingStats& stats) {
+    while (m_chunkStorage.nonResidentBytes() > m_streamingConfig.nonResidentBudgetBytes) {
+        const ChunkHandle handle = m_chunkStorage.leastRecentlyUsed();
+        const Chunk* chunk = m_chunkStorage.find(handle);
+        if (chunk == nullptr) {
+            return;
+        }
+        const ChunkKey key = chunkKeyForChunk(*chunk);
+        const std::uint64_t editGeneration = m_chunkStorage.editGeneration(handle);
+        // Saved chunks are in the open world file; untouched procedural ones
+        // rebuild from their key. Anything else must spill to survive.
+        const bool inWorldFile = editGeneration <= m_savedGeneration && m_worldFile.isOpen() &&
+                                 m_worldFile.findChunk(key.chunkX, key.chunkY, key.chunkZ) != nullptr;
+        if (!inWorldFile && !m_chunkStorage.isRegenerable(handle)) {
+            if (!m_spillFile.isOpen()) {
+                if (m_spillPath.empty()) {
+                    m_spillPath = uniqueTempSpillPath();
+                }
+                if (!m_spillFile.open(m_spillPath)) {
+                    return;
+                }
+            }
+            // Over budget beats losing edits: keep the chunk in memory.
+            if (!m_spillFile.write(*chunk, editGeneration)) {
+                return;
+            }
+            ++stats.spilledChunkCount;
+        }
+        m_chunkHandleByKey.erase(key);
+        (void)m_chunkStorage.erase(handle);
+        ++stats.evictedChunkCount;
     }
 }
 
+void World::clearChunkStorage() {
+    m_chunkStorage.clear();
+    m_chunkHandleByKey.clear();
+    m_spillFile.close();
+}
+
 ChunkGrid& World::chunkGrid() {
-    return m_chunkGrid;
+    return m_chunkStorage.residentGrid();
 }
 
 const ChunkGrid& World::chunkGrid() const {
-    return m_chunkGrid;
+    return m_chunkStorage.residentGrid();
 }
 
 std::filesystem::path World::resolveAssetPath(const std::filesystem::path& relativePath) {
@@ -481,7 +887,7 @@ bool World::worldToChunkLocal(
     int& outLocalZ
 ) const {
     return worldToChunkLocalInChunks(
-        std::span<const Chunk>(m_chunkGrid.chunks().data(), m_chunkGrid.chunks().size()),
+        std::span<const Chunk>(chunkGrid().chunks().data(), chunkGrid().chunkCount()),
         worldX,
         worldY,
         worldZ,
@@ -492,104 +898,90 @@ bool World::worldToChunkLocal(
     );
 }
 
-World::ChunkStreamingUpdate World::syncResidentChunkGrid(int centerChunkX, int centerChunkZ) {
+World::ChunkStreamingUpdate World::syncResidentChunkGrid(int centerChunkX, int centerChunkY, int centerChunkZ) {
     ChunkStreamingUpdate update{};
     ChunkStreamingStats& stats = update.stats;
     stats.centerChunkX = centerChunkX;
+    stats.centerChunkY = centerChunkY;
     stats.centerChunkZ = centerChunkZ;
 
-    std::vector<ChunkKey> previousResidentKeys;
-    previousResidentKeys.reserve(m_chunkGrid.chunks().size());
-    for (const Chunk& chunk : m_chunkGrid.chunks()) {
-        previousResidentKeys.push_back(chunkKeyForChunk(chunk));
-    }
-    std::sort(previousResidentKeys.begin(), previousResidentKeys.end(), chunkKeyLess);
-
-    std::vector<ChunkKey> desiredKeys;
-    desiredKeys.reserve(static_cast<std::size_t>(((m_streamingConfig.radiusChunksX * 2) + 1) * ((m_streamingConfig.radiusChunksZ * 2) + 1)));
-    for (int chunkZ = centerChunkZ - m_streamingConfig.radiusChunksZ;
-         chunkZ <= centerChunkZ + m_streamingConfig.radiusChunksZ;
-         ++chunkZ) {
-        for (int chunkX = centerChunkX - m_streamingConfig.radiusChunksX;
-             chunkX <= centerChunkX + m_streamingConfig.radiusChunksX;
-             ++chunkX) {
-            desiredKeys.push_back(ChunkKey{chunkX, 0, chunkZ});
-        }
-    }
-    std::sort(desiredKeys.begin(), desiredKeys.end(), chunkKeyLess);
-
-    for (const ChunkKey& key : desiredKeys) {
-        if (m_chunkStorageIndexByKey.contains(key)) {
-            continue;
-        }
-        m_chunkStorageIndexByKey[key] = m_chunkStorage.size();
-        m_chunkStorage.push_back(buildProceduralChunk(key.chunkX, key.chunkY, key.chunkZ));
-        update.generatedChunkKeys.push_back(key);
-    }
+    const auto isInWindow = [&](const ChunkKey& key) {
+        return std::abs(key.chunkX - centerChunkX) <= m_streamingConfig.radiusChunksX &&
+               std::abs(key.chunkY - centerChunkY) <= m_streamingConfig.radiusChunksY &&
+               std::abs(key.chunkZ - centerChunkZ) <= m_streamingConfig.radiusChunksZ;
+    };
 
-    std::vector<Chunk> residentChunks;
-    residentChunks.reserve(desiredKeys.size());
-    for (const ChunkKey& desiredKey : desiredKeys) {
-        const auto storedIt = m_chunkStorageIndexByKey.find(desiredKey);
-        if (storedIt == m_chunkStorageIndexByKey.end() || storedIt->second >= m_chunkStorage.size()) {
+    // Leaving chunks move back into their storage slots. Walking backwards
+    // keeps the swap-with-last in makeNonResident from skipping a chunk.
+    const std::vector<Chunk>& residentChunks = chunkGrid().chunks();
+    for (std::size_t residentIndex = residentChunks.size(); residentIndex-- > 0;) {
+        const ChunkKey residentKey = chunkKeyForChunk(residentChunks[residentIndex]);
+        if (isInWindow(residentKey)) {
             continue;
         }
-        residentChunks.push_back(m_chunkStorage[storedIt->second]);
+        update.exitedChunkKeys.push_back(residentKey);
+        m_chunkStorage.makeNonResident(m_chunkStorage.residentHandle(residentIndex));
     }
 
-    std::vector<ChunkKey> residentKeys;
-    residentKeys.reserve(residentChunks.size());
-    for (const Chunk& chunk : residentChunks) {
-        residentKeys.push_back(chunkKeyForChunk(chunk));
-    }
-
-    std::size_t previousIndex = 0;
-    std::size_t residentIndex = 0;
-    while (previousIndex < previousResidentKeys.size() && residentIndex < residentKeys.size()) {
-        if (previousResidentKeys[previousIndex] == residentKeys[residentIndex]) {
-            ++previousIndex;
-            ++residentIndex;
-            continue;
-        }
-        if (chunkKeyLess(previousResidentKeys[previousIndex], residentKeys[residentIndex])) {
-            update.exitedChunkKeys.push_back(previousResidentKeys[previousIndex]);
-            ++previousIndex;
+    // Nearest first, so a caller that uploads or meshes the entered chunks in
+    // order fills in the camera's column before the window's rim.
+    for (const ChunkKey& key : streamingWindowKeys(m_streamingConfig, centerChunkX, centerChunkY, centerChunkZ)) {
+        ChunkHandle handle{};
+        const auto handleIt = m_chunkHandleByKey.find(key);
+        if (handleIt != m_chunkHandleByKey.end()) {
+            handle = handleIt->second;
+            if (m_chunkStorage.isResident(handle)) {
+                continue;
+            }
         } else {
-            update.enteredChunkKeys.push_back(residentKeys[residentIndex]);
-            ++residentIndex;
+            // A spilled chunk holds edits newer than anything in the world file.
+            const WorldFileChunkEntry* fileEntry =
+                m_worldFile.isOpen() ? m_worldFile.findChunk(key.chunkX, key.chunkY, key.chunkZ) : nullptr;
+            Chunk chunk;
+            std::uint64_t editGeneration = 0;
+            bool regenerable = false;
+            if (m_spillFile.take(key.chunkX, key.chunkY, key.chunkZ, chunk, editGeneration)) {
+                ++stats.reloadedChunkCount;
+            } else if (fileEntry != nullptr && m_worldFile.readChunk(*fileEntry, chunk)) {
+                ++stats.pagedInChunkCount;
+            } else {
+                chunk = buildProceduralChunk(key.chunkX, key.chunkY, key.chunkZ, nullptr, &m_terrainCache);
+                editGeneration = ++m_editGeneration;
+                regenerable = true;
+            }
+            handle = appendStoredChunk(key, std::move(chunk), editGeneration, regenerable);
+            update.generatedChunkKeys.push_back(key);
         }
+        // Entering chunks move out of their slots; no voxel data is copied.
+        update.residentChunkIndicesNeedingUpload.push_back(m_chunkStorage.makeResident(handle));
+        update.enteredChunkKeys.push_back(key);
     }
-    while (previousIndex < previousResidentKeys.size()) {
-        update.exitedChunkKeys.push_back(previousResidentKeys[previousIndex++]);
-    }
-    while (residentIndex < residentKeys.size()) {
-        update.enteredChunkKeys.push_back(residentKeys[residentIndex++]);
-    }
+    std::sort(update.exitedChunkKeys.begin(), update.exitedChunkKeys.end(), chunkKeyLess);
+
+    evictOverBudget(stats);
 
     stats.storedChunkCount = static_cast<std::uint32_t>(m_chunkStorage.size());
-    stats.residentChunkCount = static_cast<std::uint32_t>(residentChunks.size());
+    stats.residentChunkCount = static_cast<std::uint32_t>(chunkGrid().chunkCount());
     stats.enteredChunkCount = static_cast<std::uint32_t>(update.enteredChunkKeys.size());
     stats.exitedChunkCount = static_cast<std::uint32_t>(update.exitedChunkKeys.size());
+    for (const Chunk& chunk : chunkGrid().chunks()) {
+        stats.residentChunkBytes += chunk.memoryFootprintBytes();
+    }
+    stats.storedChunkBytes = stats.residentChunkBytes + m_chunkStorage.nonResidentBytes();
+    stats.spillFileChunkCount = static_cast<std::uint32_t>(m_spillFile.chunkCount());
+    stats.spillFileBytes = m_spillFile.fileBytes();
     stats.changed =
         centerChunkX != m_streamingStats.centerChunkX ||
+        centerChunkY != m_streamingStats.centerChunkY ||
         centerChunkZ != m_streamingStats.centerChunkZ ||
         !update.generatedChunkKeys.empty() ||
         !update.enteredChunkKeys.empty() ||
         !update.exitedChunkKeys.empty();
 
+    // A chunk that stayed resident keeps its grid index unless it was moved
+    // into a slot vacated by a leaving chunk; consumers that follow chunks
+    // across updates key them by chunk coordinates, as before.
     update.requiresFullMeshUpload = false;
-    m_chunkGrid.setChunks(std::move(residentChunks));
-    for (std::size_t residentChunkIndex = 0; residentChunkIndex < m_chunkGrid.chunkCount(); ++residentChunkIndex) {
-        const ChunkKey residentKey = chunkKeyForChunk(m_chunkGrid.chunks()[residentChunkIndex]);
-        const bool wasGenerated = std::find(update.generatedChunkKeys.begin(), update.generatedChunkKeys.end(), residentKey) !=
-                                  update.generatedChunkKeys.end();
-        const bool wasEntered = std::find(update.enteredChunkKeys.begin(), update.enteredChunkKeys.end(), residentKey) !=
-                                update.enteredChunkKeys.end();
-        if (wasGenerated || wasEntered) {
-            update.residentChunkIndicesNeedingUpload.push_back(residentChunkIndex);
-        }
-    }
-
     m_streamingStats = stats;
     return update;
 }
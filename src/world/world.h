@@ -2,10 +2,13 @@
 
 #include "core/hash.h"
 #include "world/chunk_grid.h"
+#include "world/chunk_storage.h"
+#include "world/world_file.h"
 
 #include <array>
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <span>
 #include <unordered_map>
 
@@ -13,6 +16,11 @@ namespace odai::world {
 
 class World {
 public:
+    World();
+    ~World();
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
     struct ChunkKey {
         int chunkX = 0;
         int chunkY = 0;
@@ -30,21 +38,51 @@ public:
     struct ChunkStreamingConfig {
         int radiusChunksX = 2;
         int radiusChunksZ = 2;
+        // Chunk layers kept resident above and below the camera's layer. With
+        // 0 the window stays on the surface layer (chunkY == 0) wherever the
+        // camera is; layers far from the surface are Uniform air or stone
+        // and cost almost nothing (see classifyProceduralChunk).
+        int radiusChunksY = 0;
+        // Memory budget for stored chunks outside the resident window. Over
+        // it, the least recently used are evicted: chunks that are still
+        // untouched procedural terrain or match the open world file are
+        // dropped and rebuilt or paged in on demand; chunks with unsaved edits
+        // spill to a scratch region file and are read back from there.
+        std::uint64_t nonResidentBudgetBytes = 64ull * 1024ull * 1024ull;
     };
 
     struct ChunkStreamingStats {
         int centerChunkX = 0;
+        int centerChunkY = 0;
         int centerChunkZ = 0;
         std::uint32_t residentChunkCount = 0;
         std::uint32_t storedChunkCount = 0;
         std::uint32_t enteredChunkCount = 0;
         std::uint32_t exitedChunkCount = 0;
+        // Chunks decoded from the open VXW4 world file (rather than generated) this update.
+        std::uint32_t pagedInChunkCount = 0;
+        // Chunk::memoryFootprintBytes() summed over storage and the resident grid.
+        // Resident chunks are counted in both: they are stored, not copied.
+        std::uint64_t storedChunkBytes = 0;
+        std::uint64_t residentChunkBytes = 0;
+        // Non-resident chunks evicted over budget this update; of those, the
+        // ones written to the spill file.
+        std::uint32_t evictedChunkCount = 0;
+        std::uint32_t spilledChunkCount = 0;
+        // Chunks read back from the spill file this update.
+        std::uint32_t reloadedChunkCount = 0;
+        // What the spill file holds after this update.
+        std::uint32_t spillFileChunkCount = 0;
+        std::uint64_t spillFileBytes = 0;
         bool changed = false;
     };
 
     struct ChunkStreamingUpdate {
         ChunkStreamingStats stats{};
+        // Newly stored this update: generated, or paged in from the world file.
         std::vector<ChunkKey> generatedChunkKeys;
+        // In streamingWindowKeys() priority order, camera column first;
+        // residentChunkIndicesNeedingUpload is parallel to it.
         std::vector<ChunkKey> enteredChunkKeys;
         std::vector<ChunkKey> exitedChunkKeys;
         std::vector<std::size_t> residentChunkIndicesNeedingUpload;
@@ -56,6 +94,24 @@ public:
         bool initializedFallback = false;
     };
 
+    enum class SaveState : std::uint8_t {
+        Idle,
+        // Snapshot taken; a worker is encoding and writing the temp file.
+        Writing,
+        // Reported once by the pollSave() that renamed the new file into place.
+        Committed,
+        // Reported once; the previous file is untouched and nothing was marked saved.
+        Failed
+    };
+
+    struct SaveProgress {
+        SaveState state = SaveState::Idle;
+        std::uint32_t chunksWritten = 0;
+        std::uint32_t chunkCount = 0;
+        // Chunks encoded by the save (the rest were copied from the open file).
+        std::uint32_t dirtyChunkCount = 0;
+    };
+
     struct MagicaStampSpec {
         const char* relativePath = nullptr;
         float placementX = 0.0f;
@@ -68,34 +124,94 @@ public:
         std::uint32_t stampedResourceCount = 0;
         std::uint64_t stampedVoxelCount = 0;
         std::uint64_t clippedVoxelCount = 0;
+        // Batched chunk edits applied; a chunk touched by two resources counts twice.
+        std::uint32_t stampedChunkBatchCount = 0;
         std::array<std::uint32_t, 16> baseColorPalette{};
         std::uint8_t baseColorPaletteCount = 0;
+        // Reading and downscaling every resource, then bucketing and applying voxels.
+        double loadMs = 0.0;
+        double stampMs = 0.0;
     };
 
-    bool loadOrInitialize(const std::filesystem::path& worldPath, LoadResult* outResult = nullptr);
-    bool save(const std::filesystem::path& worldPath) const;
+    // A VXW4 file stays memory-mapped and its chunks are paged in as the
+    // streaming window reaches them. Legacy VXW1 files are decoded up front;
+    // `jobs`, when given, decodes them in parallel (see
+    // ChunkGrid::loadFromBinaryFile) and the loaded world is identical either way.
+    bool loadOrInitialize(
+        const std::filesystem::path& worldPath,
+        LoadResult* outResult = nullptr,
+        core::JobSystem* jobs = nullptr
+    );
+    // Writes VXW4 incrementally: only chunks edited, generated or stamped since
+    // the last save are encoded; every other chunk is copied still compressed
+    // from the open world file, which afterwards maps `worldPath`. Blocks, and
+    // first finishes any save started by beginSave().
+    bool save(const std::filesystem::path& worldPath);
+    // Same file as save(), without stalling the frame: copies the dirty chunks
+    // on the calling thread (the only work proportional to the edit, not the
+    // world), then encodes, writes and fsyncs on a Low-priority `jobs` worker.
+    // pollSave() renames the result into place once it is written. Returns
+    // false if a save is already in flight. Edits made meanwhile stay dirty
+    // for the next save. `jobs` must outlive the save (waitForSave() or the
+    // destructor end it).
+    bool beginSave(const std::filesystem::path& worldPath, core::JobSystem& jobs);
+    // Call once per frame: commits a finished background write on this thread
+    // and reports progress, e.g. to drive a "saving..." spinner.
+    SaveProgress pollSave();
+    // Blocks until an in-flight save is written and committed. Returns false
+    // only if that save failed.
+    bool waitForSave();
+    [[nodiscard]] bool isSaveInFlight() const;
+    // True while any stored chunk differs from what the last save wrote.
+    [[nodiscard]] bool hasUnsavedChanges() const;
     void regenerateFlatWorld();
     void setStreamingConfig(const ChunkStreamingConfig& config);
     [[nodiscard]] ChunkStreamingConfig streamingConfig() const;
+    // The two-coordinate form keeps the current vertical center.
     [[nodiscard]] ChunkStreamingUpdate updateStreamingWindowForWorldPosition(float worldX, float worldZ);
+    [[nodiscard]] ChunkStreamingUpdate updateStreamingWindowForWorldPosition(float worldX, float worldY, float worldZ);
+    // Every key of the window centered on (centerChunkX, centerChunkY,
+    // centerChunkZ), grown by marginChunks on each axis (vertically only when
+    // radiusChunksY > 0), nearest first: by horizontal ring around the camera
+    // column, then by layer distance, below before above.
+    [[nodiscard]] static std::vector<ChunkKey> streamingWindowKeys(
+        const ChunkStreamingConfig& config,
+        int centerChunkX,
+        int centerChunkY,
+        int centerChunkZ,
+        int marginChunks = 0
+    );
     [[nodiscard]] const ChunkStreamingStats& streamingStats() const;
     bool setVoxelAtWorld(int worldX, int worldY, int worldZ, Voxel voxel);
 
     // Insert a chunk generated off the main thread (e.g. by an async streaming pipeline)
     // directly into storage, without calling buildProceduralChunk. Returns false (no-op) if
-    // a chunk for this key is already stored. Callers still call
+    // a chunk for this key is already stored or spilled, or if the open world file has one
+    // (the saved chunk wins and is paged in by the next streaming update). Callers still call
     // updateStreamingWindowForWorldPosition() afterward to sync the resident grid -- its
-    // storage lookup naturally skips regeneration for keys already present.
-    bool insertGeneratedChunk(const ChunkKey& key, Chunk chunk);
+    // storage lookup naturally skips regeneration for keys already present. Pass
+    // `procedural` when `chunk` is exactly buildProceduralChunk(key): eviction may then
+    // drop it rather than spill it.
+    bool insertGeneratedChunk(const ChunkKey& key, Chunk chunk, bool procedural = false);
+    // True when a streaming update would not generate this chunk: it is
+    // stored, spilled, or in the open world file.
+    [[nodiscard]] bool hasChunk(const ChunkKey& key) const;
 
-    MagicaStampResult stampMagicaResources(std::span<const MagicaStampSpec> specs);
+    // Loads every resource (in parallel with `jobs`), then stamps them in
+    // order: each resource's voxels are bucketed by destination chunk and each
+    // bucket is applied as one batched edit, on `jobs` workers when given.
+    // The stamped world is identical either way.
+    MagicaStampResult stampMagicaResources(std::span<const MagicaStampSpec> specs, core::JobSystem* jobs = nullptr);
 
+    // The resident chunks, lent out of storage (see world/chunk_storage.h):
+    // edits through setVoxelAtWorld land here directly, and a window shift
+    // moves only the chunks that enter or leave it.
     ChunkGrid& chunkGrid();
     const ChunkGrid& chunkGrid() const;
 
 private:
     static std::filesystem::path resolveAssetPath(const std::filesystem::path& relativePath);
-    [[nodiscard]] ChunkStreamingUpdate syncResidentChunkGrid(int centerChunkX, int centerChunkZ);
+    [[nodiscard]] ChunkStreamingUpdate syncResidentChunkGrid(int centerChunkX, int centerChunkY, int centerChunkZ);
     bool worldToChunkLocal(
         int worldX,
         int worldY,
@@ -105,13 +221,51 @@ private:
         int& outLocalY,
         int& outLocalZ
     ) const;
-    void rebuildChunkStorageIndex();
+    ChunkHandle appendStoredChunk(
+        const ChunkKey& key,
+        Chunk chunk,
+        std::uint64_t editGeneration,
+        bool regenerable = false
+    );
+    // Evicts least recently used non-resident chunks until storage is back
+    // under m_streamingConfig.nonResidentBudgetBytes.
+    void evictOverBudget(ChunkStreamingStats& stats);
+    void markStoredChunkEdited(ChunkHandle handle);
+    void clearChunkStorage();
+    // Copies every chunk with unsaved edits, reading spilled ones back.
+    bool snapshotDirtyChunks(std::vector<Chunk>& outChunks);
+    bool commitSave(
+        const std::filesystem::path& worldPath,
+        const WorldFileWriteStats& writeStats,
+        std::uint64_t snapshotGeneration
+    );
+    // Waits for the background write, commits it if it succeeded and drops
+    // the pending state.
+    bool finishPendingSave();
+
+    // State shared with the background writer; lives on the heap so the job
+    // can hold a stable pointer to it.
+    struct PendingSave;
 
-    ChunkGrid m_chunkGrid;
-    std::vector<Chunk> m_chunkStorage;
-    std::unordered_map<ChunkKey, std::size_t, ChunkKeyHash> m_chunkStorageIndexByKey;
+    // Every stored chunk, once; its resident grid is what chunkGrid() returns.
+    // Each slot also carries the edit generation that last changed its chunk,
+    // or 0 for chunks paged in unchanged from m_worldFile. A chunk is dirty
+    // while its generation is above m_savedGeneration; every chunk at or below
+    // it is in m_worldFile, which is what makes saves incremental.
+    ChunkStorage m_chunkStorage;
+    std::unordered_map<ChunkKey, ChunkHandle, ChunkKeyHash> m_chunkHandleByKey;
     ChunkStreamingConfig m_streamingConfig{};
     ChunkStreamingStats m_streamingStats{};
+    WorldFileReader m_worldFile;
+    // Evicted chunks with unsaved edits. Beside the world file once one is
+    // known, else in the temp directory; created on the first spill.
+    ChunkSpillFile m_spillFile;
+    std::filesystem::path m_spillPath;
+    // Base terrain for chunks generated by streaming updates.
+    TerrainPatchCache m_terrainCache;
+    std::uint64_t m_editGeneration = 0;
+    std::uint64_t m_savedGeneration = 0;
+    std::unique_ptr<PendingSave> m_pendingSave;
 };
 
 } // namespace odai::world
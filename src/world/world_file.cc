@@ -0,0 +1,555 @@
+#include "world/world_file.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <unordered_set>
+
+#include "core/grid3.h"
+#include "core/job_system.h"
+#include "core/log.h"
+#include "core/parallel_for.h"
+
+namespace odai::world {
+
+namespace {
+
+constexpr std::size_t kHeaderBytes = 24;
+constexpr std::size_t kDirectoryEntryBytes = 32;
+constexpr std::size_t kRawPayloadBytes = Chunk::kVoxelCount * 2u;
+constexpr std::size_t kRleRunBytes = 4;
+
+std::uint64_t packChunkKey(int chunkX, int chunkY, int chunkZ) {
+    return core::packCell21(core::Cell3i{chunkX, chunkY, chunkZ});
+}
+
+template <typename T>
+T readScalar(const std::uint8_t* bytes) {
+    T value{};
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void appendScalar(std::vector<std::uint8_t>& out, T value) {
+    const std::size_t offset = out.size();
+    out.resize(offset + sizeof(T));
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+void appendRleRun(std::vector<std::uint8_t>& out, std::uint16_t length, Voxel voxel) {
+    appendScalar(out, length);
+    out.push_back(static_cast<std::uint8_t>(voxel.type));
+    out.push_back(voxel.baseColorIndex);
+}
+
+} // namespace
+
+bool isIndexedWorldFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4]{};
+    in.read(magic, sizeof(magic));
+    return in.good() && std::memcmp(magic, kWorldFileMagic, sizeof(magic)) == 0;
+}
+
+ChunkCodec encodeChunkPayload(const Chunk& chunk, std::vector<std::uint8_t>& out) {
+    std::vector<Voxel> voxels;
+    chunk.copyDenseVoxels(voxels);
+
+    const std::size_t payloadStart = out.size();
+    std::size_t runStart = 0;
+    for (std::size_t index = 1; index <= voxels.size(); ++index) {
+        const bool runEnds = index == voxels.size() || !(voxels[index] == voxels[runStart]) ||
+                             (index - runStart) == 0xFFFFu;
+        if (!runEnds) {
+            continue;
+        }
+        appendRleRun(out, static_cast<std::uint16_t>(index - runStart), voxels[runStart]);
+        runStart = index;
+        // Noisy chunks (e.g. per-voxel base colors) compress worse than raw.
+        if ((out.size() - payloadStart) >= kRawPayloadBytes) {
+            break;
+        }
+    }
+    if ((out.size() - payloadStart) < kRawPayloadBytes) {
+        return ChunkCodec::Rle;
+    }
+
+    out.resize(payloadStart + kRawPayloadBytes);
+    std::uint8_t* typePlane = out.data() + payloadStart;
+    std::uint8_t* baseColorPlane = typePlane + Chunk::kVoxelCount;
+    for (std::size_t index = 0; index < voxels.size(); ++index) {
+        typePlane[index] = static_cast<std::uint8_t>(voxels[index].type);
+        baseColorPlane[index] = voxels[index].baseColorIndex;
+    }
+    return ChunkCodec::Raw;
+}
+
+bool decodeChunkPayload(std::span<const std::uint8_t> payload, ChunkCodec codec, Chunk& outChunk) {
+    switch (codec) {
+    case ChunkCodec::Raw:
+        if (payload.size() != kRawPayloadBytes) {
+            break;
+        }
+        outChunk.setFromTypedVoxelAndBaseColorBytes(
+            payload.data(),
+            payload.data() + Chunk::kVoxelCount,
+            Chunk::kVoxelCount
+        );
+        return true;
+    case ChunkCodec::Rle: {
+        if (payload.empty() || (payload.size() % kRleRunBytes) != 0u) {
+            break;
+        }
+        std::vector<std::uint8_t> planes(kRawPayloadBytes);
+        std::size_t voxelIndex = 0;
+        bool valid = true;
+        for (std::size_t offset = 0; offset < payload.size(); offset += kRleRunBytes) {
+            const std::size_t length = readScalar<std::uint16_t>(payload.data() + offset);
+            if (length == 0u || length > (Chunk::kVoxelCount - voxelIndex)) {
+                valid = false;
+                break;
+            }
+            std::fill_n(planes.begin() + static_cast<std::ptrdiff_t>(voxelIndex), length, payload[offset + 2u]);
+            std::fill_n(
+                planes.begin() + static_cast<std::ptrdiff_t>(Chunk::kVoxelCount + voxelIndex),
+                length,
+                payload[offset + 3u]
+            );
+            voxelIndex += length;
+        }
+        if (!valid || voxelIndex != Chunk::kVoxelCount) {
+            break;
+        }
+        outChunk.setFromTypedVoxelAndBaseColorBytes(planes.data(), planes.data() + Chunk::kVoxelCount, Chunk::kVoxelCount);
+        return true;
+    }
+    default:
+        break;
+    }
+    outChunk.setFromTypedVoxelBytes(nullptr, 0);
+    return false;
+}
+
+bool WorldFileReader::open(const std::filesystem::path& path) {
+    close();
+    if (!m_file.open(path)) {
+        return false;
+    }
+
+    const std::span<const std::uint8_t> bytes = m_file.bytes();
+    const auto fail = [this, &path](const char* reason) {
+        VOX_LOGW("world") << "rejecting world file '" << path.string() << "': " << reason;
+        close();
+        return false;
+    };
+    if (bytes.size() < kHeaderBytes || std::memcmp(bytes.data(), kWorldFileMagic, sizeof(kWorldFileMagic)) != 0) {
+        return fail("bad header");
+    }
+    const std::uint32_t version = readScalar<std::uint32_t>(bytes.data() + 4u);
+    const std::uint32_t chunkCount = readScalar<std::uint32_t>(bytes.data() + 8u);
+    const std::uint64_t directoryOffset = readScalar<std::uint64_t>(bytes.data() + 16u);
+    if (version != kWorldFileVersion) {
+        return fail("unsupported version");
+    }
+    if (directoryOffset > bytes.size() ||
+        (bytes.size() - directoryOffset) / kDirectoryEntryBytes < chunkCount) {
+        return fail("truncated directory");
+    }
+
+    m_entries.reserve(chunkCount);
+    m_entryIndexByKey.reserve(chunkCount);
+    for (std::uint32_t entryIndex = 0; entryIndex < chunkCount; ++entryIndex) {
+        const std::uint8_t* record = bytes.data() + directoryOffset + (entryIndex * kDirectoryEntryBytes);
+        WorldFileChunkEntry entry{};
+        entry.chunkX = readScalar<std::int32_t>(record + 0u);
+        entry.chunkY = readScalar<std::int32_t>(record + 4u);
+        entry.chunkZ = readScalar<std::int32_t>(record + 8u);
+        entry.codec = static_cast<ChunkCodec>(record[12]);
+        entry.payloadOffset = readScalar<std::uint64_t>(record + 16u);
+        entry.payloadSize = readScalar<std::uint32_t>(record + 24u);
+        if (entry.codec != ChunkCodec::Raw && entry.codec != ChunkCodec::Rle) {
+            return fail("unknown chunk codec");
+        }
+        if (entry.payloadOffset > bytes.size() || entry.payloadSize > (bytes.size() - entry.payloadOffset)) {
+            return fail("chunk payload out of range");
+        }
+        if (!m_entryIndexByKey.emplace(packChunkKey(entry.chunkX, entry.chunkY, entry.chunkZ), m_entries.size()).second) {
+            return fail("duplicate chunk key");
+        }
+        m_entries.push_back(entry);
+    }
+    m_path = path;
+    return true;
+}
+
+void WorldFileReader::close() {
+    m_file.close();
+    m_path.clear();
+    m_entries.clear();
+    m_entryIndexByKey.clear();
+}
+
+const WorldFileChunkEntry* WorldFileReader::findChunk(int chunkX, int chunkY, int chunkZ) const {
+    const auto it = m_entryIndexByKey.find(packChunkKey(chunkX, chunkY, chunkZ));
+    return it != m_entryIndexByKey.end() ? &m_entries[it->second] : nullptr;
+}
+
+std::span<const std::uint8_t> WorldFileReader::payload(const WorldFileChunkEntry& entry) const {
+    return m_file.bytes().subspan(static_cast<std::size_t>(entry.payloadOffset), entry.payloadSize);
+}
+
+bool WorldFileReader::readChunk(const WorldFileChunkEntry& entry, Chunk& outChunk) const {
+    outChunk = Chunk(entry.chunkX, entry.chunkY, entry.chunkZ);
+    return decodeChunkPayload(payload(entry), entry.codec, outChunk);
+}
+
+ChunkSpillFile::~ChunkSpillFile() {
+    close();
+}
+
+bool ChunkSpillFile::open(const std::filesystem::path& path) {
+    close();
+    m_stream.open(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    if (!m_stream.is_open()) {
+        VOX_LOGE("world") << "failed to create chunk spill file '" << path.string() << "'";
+        return false;
+    }
+    m_path = path;
+    return true;
+}
+
+void ChunkSpillFile::close() {
+    if (m_path.empty()) {
+        return;
+    }
+    // Removed even if the stream failed: the file is useless without m_entries.
+    m_stream.close();
+    std::error_code removeError;
+    std::filesystem::remove(m_path, removeError);
+    m_path.clear();
+    m_entries.clear();
+    m_fileBytes = 0;
+    m_liveBytes = 0;
+}
+
+bool ChunkSpillFile::contains(int chunkX, int chunkY, int chunkZ) const {
+    return m_entries.contains(packChunkKey(chunkX, chunkY, chunkZ));
+}
+
+bool ChunkSpillFile::write(const Chunk& chunk, std::uint64_t editGeneration) {
+    if (!m_stream.is_open()) {
+        return false;
+    }
+    m_payloadScratch.clear();
+    const ChunkCodec codec = encodeChunkPayload(chunk, m_payloadScratch);
+    m_stream.clear();
+    m_stream.seekp(static_cast<std::streamoff>(m_fileBytes));
+    m_stream.write(
+        reinterpret_cast<const char*>(m_payloadScratch.data()),
+        static_cast<std::streamsize>(m_payloadScratch.size())
+    );
+    if (!m_stream.good()) {
+        VOX_LOGE("world") << "failed to write chunk spill file '" << m_path.string() << "'";
+        return false;
+    }
+    Entry entry{};
+    entry.payloadOffset = m_fileBytes;
+    entry.payloadSize = static_cast<std::uint32_t>(m_payloadScratch.size());
+    entry.codec = codec;
+    entry.editGeneration = editGeneration;
+    entry.chunkX = chunk.chunkX();
+    entry.chunkY = chunk.chunkY();
+    entry.chunkZ = chunk.chunkZ();
+    const auto [it, inserted] = m_entries.try_emplace(packChunkKey(entry.chunkX, entry.chunkY, entry.chunkZ), entry);
+    if (!inserted) {
+        m_liveBytes -= it->second.payloadSize;
+        it->second = entry;
+    }
+    m_fileBytes += entry.payloadSize;
+    m_liveBytes += entry.payloadSize;
+    if (!inserted) {
+        reclaimDeadSpace();
+    }
+    return true;
+}
+
+bool ChunkSpillFile::take(int chunkX, int chunkY, int chunkZ, Chunk& outChunk, std::uint64_t& outEditGeneration) {
+    const auto it = m_entries.find(packChunkKey(chunkX, chunkY, chunkZ));
+    if (it == m_entries.end() || !readEntry(it->second, outChunk)) {
+        return false;
+    }
+    outEditGeneration = it->second.editGeneration;
+    m_liveBytes -= it->second.payloadSize;
+    m_entries.erase(it);
+    reclaimDeadSpace();
+    return true;
+}
+
+bool ChunkSpillFile::readNewerThan(std::uint64_t generation, std::vector<Chunk>& outChunks) {
+    for (const auto& [key, entry] : m_entries) {
+        if (entry.editGeneration <= generation) {
+            continue;
+        }
+        Chunk chunk;
+        if (!readEntry(entry, chunk)) {
+            return false;
+        }
+        outChunks.push_back(std::move(chunk));
+    }
+    return true;
+}
+
+void ChunkSpillFile::forgetUpTo(std::uint64_t generation) {
+    std::erase_if(m_entries, [this, generation](const auto& keyAndEntry) {
+        if (keyAndEntry.second.editGeneration > generation) {
+            return false;
+        }
+        m_liveBytes -= keyAndEntry.second.payloadSize;
+        return true;
+    });
+    reclaimDeadSpace();
+}
+
+bool ChunkSpillFile::readEntry(const Entry& entry, Chunk& outChunk) {
+    m_payloadScratch.resize(entry.payloadSize);
+    m_stream.clear();
+    m_stream.seekg(static_cast<std::streamoff>(entry.payloadOffset));
+    m_stream.read(reinterpret_cast<char*>(m_payloadScratch.data()), static_cast<std::streamsize>(entry.payloadSize));
+    if (!m_stream.good()) {
+        VOX_LOGE("world") << "failed to read chunk spill file '" << m_path.string() << "'";
+        return false;
+    }
+    outChunk = Chunk(entry.chunkX, entry.chunkY, entry.chunkZ);
+    return decodeChunkPayload(m_payloadScratch, entry.codec, outChunk);
+}
+
+void ChunkSpillFile::reclaimDeadSpace() {
+    if (!m_stream.is_open()) {
+        return;
+    }
+    if (m_entries.empty()) {
+        if (m_fileBytes == 0) {
+            return;
+        }
+        // Nothing indexed: every byte is dead, start over from offset zero.
+        m_stream.close();
+        m_stream.open(m_path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+        m_fileBytes = 0;
+        return;
+    }
+    const std::uint64_t deadBytes = m_fileBytes - m_liveBytes;
+    if (deadBytes < kCompactMinDeadBytes || deadBytes * 2u < m_fileBytes) {
+        return;
+    }
+    (void)compact();
+}
+
+bool ChunkSpillFile::compact() {
+    std::vector<Entry*> byOffset;
+    byOffset.reserve(m_entries.size());
+    for (auto& [key, entry] : m_entries) {
+        byOffset.push_back(&entry);
+    }
+    std::sort(byOffset.begin(), byOffset.end(), [](const Entry* a, const Entry* b) {
+        return a->payloadOffset < b->payloadOffset;
+    });
+    // Walking in offset order, each payload's new range ends at or before its
+    // old one, so no move overwrites a payload that has not been moved yet.
+    std::uint64_t writeOffset = 0;
+    for (Entry* entry : byOffset) {
+        if (entry->payloadOffset != writeOffset) {
+            m_payloadScratch.resize(entry->payloadSize);
+            m_stream.clear();
+            m_stream.seekg(static_cast<std::streamoff>(entry->payloadOffset));
+            m_stream.read(
+                reinterpret_cast<char*>(m_payloadScratch.data()),
+                static_cast<std::streamsize>(entry->payloadSize)
+            );
+            m_stream.seekp(static_cast<std::streamoff>(writeOffset));
+            m_stream.write(
+                reinterpret_cast<const char*>(m_payloadScratch.data()),
+                static_cast<std::streamsize>(entry->payloadSize)
+            );
+            if (!m_stream.good()) {
+                // Entries already moved point at their new offsets; this one
+                // keeps its old offset and the file is not cut to size.
+                VOX_LOGE("world") << "failed to compact chunk spill file '" << m_path.string() << "'";
+                return false;
+            }
+            entry->payloadOffset = writeOffset;
+        }
+        writeOffset += entry->payloadSize;
+    }
+    m_stream.flush();
+    std::error_code resizeError;
+    std::filesystem::resize_file(m_path, writeOffset, resizeError);
+    if (resizeError) {
+        VOX_LOGW("world") << "failed to shrink chunk spill file '" << m_path.string() << "': " << resizeError.message();
+    }
+    // Appends continue after the live payloads either way; a failed resize
+    // only leaves stale bytes past the end that later writes overwrite.
+    m_fileBytes = writeOffset;
+    return true;
+}
+
+std::filesystem::path worldFileTempPath(const std::filesystem::path& path) {
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    return tempPath;
+}
+
+bool writeWorldFileContents(
+    const std::filesystem::path& path,
+    std::span<const Chunk> chunks,
+    const WorldFileReader* passthrough,
+    core::JobSystem* jobs,
+    WorldFileWriteStats* outStats,
+    WorldFileWriteProgress* progress
+) {
+    using Clock = std::chrono::steady_clock;
+    const auto encodeStart = Clock::now();
+
+    std::vector<const WorldFileChunkEntry*> copiedEntries;
+    if (passthrough != nullptr && passthrough->isOpen()) {
+        std::unordered_set<std::uint64_t> writtenKeys;
+        writtenKeys.reserve(chunks.size());
+        for (const Chunk& chunk : chunks) {
+            writtenKeys.insert(packChunkKey(chunk.chunkX(), chunk.chunkY(), chunk.chunkZ()));
+        }
+        for (const WorldFileChunkEntry& entry : passthrough->entries()) {
+            if (!writtenKeys.contains(packChunkKey(entry.chunkX, entry.chunkY, entry.chunkZ))) {
+                copiedEntries.push_back(&entry);
+            }
+        }
+    }
+    const std::size_t chunkCount = chunks.size() + copiedEntries.size();
+    if (progress != nullptr) {
+        progress->chunksWritten.store(0u, std::memory_order_relaxed);
+        progress->chunkCount.store(static_cast<std::uint32_t>(chunkCount), std::memory_order_relaxed);
+    }
+
+    std::vector<std::vector<std::uint8_t>> payloads(chunks.size());
+    std::vector<ChunkCodec> codecs(chunks.size(), ChunkCodec::Raw);
+    const auto encodeEntry = [&](std::size_t chunkIndex) {
+        codecs[chunkIndex] = encodeChunkPayload(chunks[chunkIndex], payloads[chunkIndex]);
+        if (progress != nullptr) {
+            progress->chunksWritten.fetch_add(1u, std::memory_order_relaxed);
+        }
+    };
+    if (jobs != nullptr) {
+        core::parallelFor(*jobs, 0, chunks.size(), 4, encodeEntry);
+    } else {
+        for (std::size_t chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex) {
+            encodeEntry(chunkIndex);
+        }
+    }
+    const auto ioStart = Clock::now();
+
+    std::vector<std::uint8_t> headerAndDirectory;
+    headerAndDirectory.reserve(kHeaderBytes + (chunkCount * kDirectoryEntryBytes));
+    headerAndDirectory.insert(headerAndDirectory.end(), std::begin(kWorldFileMagic), std::end(kWorldFileMagic));
+    appendScalar(headerAndDirectory, kWorldFileVersion);
+    appendScalar(headerAndDirectory, static_cast<std::uint32_t>(chunkCount));
+    appendScalar(headerAndDirectory, std::uint32_t{0});
+    appendScalar(headerAndDirectory, static_cast<std::uint64_t>(kHeaderBytes));
+
+    std::uint64_t payloadOffset = kHeaderBytes + (chunkCount * kDirectoryEntryBytes);
+    const auto appendEntry = [&](int chunkX, int chunkY, int chunkZ, ChunkCodec codec, std::size_t payloadSize) {
+        appendScalar(headerAndDirectory, static_cast<std::int32_t>(chunkX));
+        appendScalar(headerAndDirectory, static_cast<std::int32_t>(chunkY));
+        appendScalar(headerAndDirectory, static_cast<std::int32_t>(chunkZ));
+        appendScalar(headerAndDirectory, static_cast<std::uint32_t>(codec));
+        appendScalar(headerAndDirectory, payloadOffset);
+        appendScalar(headerAndDirectory, static_cast<std::uint32_t>(payloadSize));
+        appendScalar(headerAndDirectory, std::uint32_t{0});
+        payloadOffset += payloadSize;
+    };
+    for (std::size_t chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex) {
+        const Chunk& chunk = chunks[chunkIndex];
+        appendEntry(chunk.chunkX(), chunk.chunkY(), chunk.chunkZ(), codecs[chunkIndex], payloads[chunkIndex].size());
+    }
+    for (const WorldFileChunkEntry* entry : copiedEntries) {
+        appendEntry(entry->chunkX, entry->chunkY, entry->chunkZ, entry->codec, entry->payloadSize);
+    }
+
+    const std::filesystem::path tempPath = worldFileTempPath(path);
+    const auto discardTemp = [&tempPath]() {
+        std::error_code removeError;
+        std::filesystem::remove(tempPath, removeError);
+    };
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(
+            reinterpret_cast<const char*>(headerAndDirectory.data()),
+            static_cast<std::streamsize>(headerAndDirectory.size())
+        );
+        for (const std::vector<std::uint8_t>& payload : payloads) {
+            out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        }
+        for (const WorldFileChunkEntry* entry : copiedEntries) {
+            const std::span<const std::uint8_t> payload = passthrough->payload(*entry);
+            out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+            if (progress != nullptr) {
+                progress->chunksWritten.fetch_add(1u, std::memory_order_relaxed);
+            }
+        }
+        out.flush();
+        if (!out.good()) {
+            out.close();
+            discardTemp();
+            return false;
+        }
+    }
+    if (!core::flushFileToStorage(tempPath)) {
+        VOX_LOGE("world") << "failed to flush world file '" << tempPath.string() << "' to storage";
+        discardTemp();
+        return false;
+    }
+
+    const auto ioEnd = Clock::now();
+    if (outStats != nullptr) {
+        outStats->encodedChunkCount = static_cast<std::uint32_t>(chunks.size());
+        outStats->copiedChunkCount = static_cast<std::uint32_t>(copiedEntries.size());
+        outStats->fileBytes = payloadOffset;
+        outStats->encodeMs =
+            static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(ioStart - encodeStart).count()) / 1000.0;
+        outStats->ioMs =
+            static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(ioEnd - ioStart).count()) / 1000.0;
+    }
+    return true;
+}
+
+bool commitWorldFile(const std::filesystem::path& path, WorldFileReader* mappedTarget) {
+    const std::filesystem::path tempPath = worldFileTempPath(path);
+    std::error_code fsError;
+    if (mappedTarget != nullptr && mappedTarget->isOpen() &&
+        std::filesystem::equivalent(mappedTarget->path(), path, fsError)) {
+        mappedTarget->close();
+    }
+    std::filesystem::rename(tempPath, path, fsError);
+    if (fsError) {
+        VOX_LOGE("world") << "failed to replace world file '" << path.string() << "': " << fsError.message();
+        std::filesystem::remove(tempPath, fsError);
+        return false;
+    }
+    core::flushDirectoryToStorage(path.parent_path());
+    return true;
+}
+
+bool writeWorldFile(
+    const std::filesystem::path& path,
+    std::span<const Chunk> chunks,
+    WorldFileReader* passthrough,
+    core::JobSystem* jobs,
+    WorldFileWriteStats* outStats
+) {
+    return writeWorldFileContents(path, chunks, passthrough, jobs, outStats) && commitWorldFile(path, passthrough);
+}
+
+} // namespace odai::world
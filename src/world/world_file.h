@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "core/mapped_file.h"
+#include "world/chunk.h"
+
+namespace odai::core {
+class JobSystem;
+}
+
+// World File subsystem (VXW4)
+// Responsible for: the indexed, per-chunk compressed world file format, and
+// random access to single chunks through a read-only memory map.
+// Should NOT do: decide which chunks are resident, or generate missing ones.
+//
+// Layout (native little-endian, like the VXW1 formats):
+//   header     "VXW4", u32 version (4), u32 chunkCount, u32 reserved,
+//              u64 directoryOffset
+//   directory  chunkCount x 32-byte entries:
+//              i32 chunkX, i32 chunkY, i32 chunkZ, u8 codec, u8[3] reserved,
+//              u64 payloadOffset, u32 payloadSize, u32 reserved
+//   payloads   one per chunk, at any offset, encoded with the entry's codec
+//
+// Codecs:
+//   Raw  32768 type bytes then 32768 base-color bytes (the VXW1 v3 planes).
+//   Rle  runs of (u16 length, u8 type, u8 baseColorIndex) in linear voxel
+//        order, lengths summing to Chunk::kVoxelCount.
+// The writer picks whichever is smaller per chunk; an all-air chunk is 4 bytes.
+namespace odai::world {
+
+enum class ChunkCodec : std::uint8_t {
+    Raw = 0,
+    Rle = 1
+};
+
+struct WorldFileChunkEntry {
+    std::int32_t chunkX = 0;
+    std::int32_t chunkY = 0;
+    std::int32_t chunkZ = 0;
+    ChunkCodec codec = ChunkCodec::Raw;
+    std::uint64_t payloadOffset = 0;
+    std::uint32_t payloadSize = 0;
+};
+
+inline constexpr char kWorldFileMagic[4] = {'V', 'X', 'W', '4'};
+inline constexpr std::uint32_t kWorldFileVersion = 4u;
+
+// True if `path` starts with the VXW4 magic.
+[[nodiscard]] bool isIndexedWorldFile(const std::filesystem::path& path);
+
+// Appends the chunk's payload to `out` and returns the codec used.
+ChunkCodec encodeChunkPayload(const Chunk& chunk, std::vector<std::uint8_t>& out);
+// Replaces the voxels of `outChunk` (coordinates are kept). Returns false and
+// leaves the chunk empty on a malformed payload.
+bool decodeChunkPayload(std::span<const std::uint8_t> payload, ChunkCodec codec, Chunk& outChunk);
+
+class WorldFileReader {
+public:
+    // Maps the file and validates the header and directory. Payloads are not
+    // touched until a chunk is read.
+    bool open(const std::filesystem::path& path);
+    void close();
+
+    [[nodiscard]] bool isOpen() const { return m_file.isOpen(); }
+    [[nodiscard]] const std::filesystem::path& path() const { return m_path; }
+    [[nodiscard]] std::span<const WorldFileChunkEntry> entries() const { return m_entries; }
+    [[nodiscard]] const WorldFileChunkEntry* findChunk(int chunkX, int chunkY, int chunkZ) const;
+    [[nodiscard]] std::span<const std::uint8_t> payload(const WorldFileChunkEntry& entry) const;
+    bool readChunk(const WorldFileChunkEntry& entry, Chunk& outChunk) const;
+
+private:
+    core::MappedFile m_file;
+    std::filesystem::path m_path;
+    std::vector<WorldFileChunkEntry> m_entries;
+    std::unordered_map<std::uint64_t, std::size_t> m_entryIndexByKey;
+};
+
+// Scratch region file for chunks pushed out of memory with edits that no
+// save has written yet. Payloads use the VXW4 codecs and are appended; the
+// index lives only in memory, so the file is meaningless without this object
+// and is deleted by close(). A payload that is read back or superseded
+// becomes dead space; once dead bytes are over half the file (and past
+// kCompactMinDeadBytes), live payloads slide down over it and the file is
+// cut to size.
+class ChunkSpillFile {
+public:
+    ChunkSpillFile() = default;
+    ~ChunkSpillFile();
+    ChunkSpillFile(const ChunkSpillFile&) = delete;
+    ChunkSpillFile& operator=(const ChunkSpillFile&) = delete;
+
+    // Creates (or truncates) the file at `path`.
+    bool open(const std::filesystem::path& path);
+    void close();
+
+    [[nodiscard]] bool isOpen() const { return m_stream.is_open(); }
+    [[nodiscard]] bool contains(int chunkX, int chunkY, int chunkZ) const;
+    bool write(const Chunk& chunk, std::uint64_t editGeneration);
+    // Decodes the chunk and drops it from the index. Returns false if it is
+    // not spilled or its payload cannot be read back.
+    bool take(int chunkX, int chunkY, int chunkZ, Chunk& outChunk, std::uint64_t& outEditGeneration);
+    // Decodes every spilled chunk with an edit generation above `generation`.
+    bool readNewerThan(std::uint64_t generation, std::vector<Chunk>& outChunks);
+    // Drops chunks a save has since written (edit generation <= `generation`).
+    void forgetUpTo(std::uint64_t generation);
+
+    [[nodiscard]] std::size_t chunkCount() const { return m_entries.size(); }
+    [[nodiscard]] std::uint64_t fileBytes() const { return m_fileBytes; }
+    [[nodiscard]] std::uint64_t liveBytes() const { return m_liveBytes; }
+
+    static constexpr std::uint64_t kCompactMinDeadBytes = 1ull << 20;
+
+private:
+    struct Entry {
+        std::uint64_t payloadOffset = 0;
+        std::uint32_t payloadSize = 0;
+        ChunkCodec codec = ChunkCodec::Raw;
+        std::uint64_t editGeneration = 0;
+        std::int32_t chunkX = 0;
+        std::int32_t chunkY = 0;
+        std::int32_t chunkZ = 0;
+    };
+
+    bool readEntry(const Entry& entry, Chunk& outChunk);
+    void reclaimDeadSpace();
+    bool compact();
+
+    std::fstream m_stream;
+    std::filesystem::path m_path;
+    std::unordered_map<std::uint64_t, Entry> m_entries;
+    std::uint64_t m_fileBytes = 0;
+    std::uint64_t m_liveBytes = 0;
+    std::vector<std::uint8_t> m_payloadScratch;
+};
+
+struct WorldFileWriteStats {
+    std::uint32_t encodedChunkCount = 0;
+    // Chunks copied still-encoded from the passthrough reader.
+    std::uint32_t copiedChunkCount = 0;
+    std::uint64_t fileBytes = 0;
+    double encodeMs = 0.0;
+    double ioMs = 0.0;
+};
+
+// Live counters for a write running on another thread (e.g. World::beginSave).
+// chunkCount is set once the passthrough set is known; chunksWritten then
+// climbs to it as payloads are encoded and written.
+struct WorldFileWriteProgress {
+    std::atomic<std::uint32_t> chunksWritten{0};
+    std::atomic<std::uint32_t> chunkCount{0};
+};
+
+// `path` + ".tmp": where writes are staged before commitWorldFile().
+[[nodiscard]] std::filesystem::path worldFileTempPath(const std::filesystem::path& path);
+
+// Step one of a save, safe off the main thread: writes `chunks`, plus every
+// chunk of `passthrough` (if open) whose key is not in `chunks`, copied without
+// decoding, to worldFileTempPath(path), then flushes it to stable storage. The
+// file at `path` is not touched. `jobs`, when given, encodes chunks in parallel.
+bool writeWorldFileContents(
+    const std::filesystem::path& path,
+    std::span<const Chunk> chunks,
+    const WorldFileReader* passthrough = nullptr,
+    core::JobSystem* jobs = nullptr,
+    WorldFileWriteStats* outStats = nullptr,
+    WorldFileWriteProgress* progress = nullptr
+);
+
+// Step two: renames the staged temp file over `path`. If `mappedTarget` maps
+// `path` itself it is closed first (Windows cannot replace a mapped file);
+// reopen it afterwards. On failure the temp file is removed and `path` keeps
+// its previous contents.
+bool commitWorldFile(const std::filesystem::path& path, WorldFileReader* mappedTarget = nullptr);
+
+// Both steps back to back. A failed save never truncates the previous file.
+bool writeWorldFile(
+    const std::filesystem::path& path,
+    std::span<const Chunk> chunks,
+    WorldFileReader* passthrough = nullptr,
+    core::JobSystem* jobs = nullptr,
+    WorldFileWriteStats* outStats = nullptr
+);
+
+} // namespace odai::world
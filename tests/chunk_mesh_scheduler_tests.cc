@@ -1,13 +1,21 @@
 #include "core/job_system.h"
+#include "tools/voxel_layouts.h"
 #include "world/chunk_grid.h"
 #include "world/chunk_mesh_scheduler.h"
 #include "world/chunk_mesher.h"
 #include "world/grass_scatter.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <random>
+#include <span>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -37,6 +45,16 @@ odai::world::ChunkGrid makeGrid(std::vector<odai::world::Chunk> chunks) {
     return grid;
 }
 
+// Camera in the middle of chunk (cameraChunkX, cameraChunkZ), no view wedge
+// (everything counts as in view), `budgetMs` of worker time.
+odai::world::ChunkMeshKickParams kickParams(int cameraChunkX, int cameraChunkZ, float budgetMs) {
+    odai::world::ChunkMeshKickParams params;
+    params.cameraX = (static_cast<float>(cameraChunkX) + 0.5f) * static_cast<float>(odai::world::Chunk::kSizeX);
+    params.cameraZ = (static_cast<float>(cameraChunkZ) + 0.5f) * static_cast<float>(odai::world::Chunk::kSizeZ);
+    params.budgetMs = budgetMs;
+    return params;
+}
+
 odai::world::ChunkMeshKey keyFor(const odai::world::Chunk& chunk) {
     return odai::world::ChunkMeshKey{chunk.chunkX(), chunk.chunkY(), chunk.chunkZ()};
 }
@@ -72,7 +90,7 @@ void testLifecycleAndResultEquivalence() {
     scheduler.markDirty(keyFor(grid.chunks()[0]));
     expectTrue(scheduler.dirtyCount() == 1, "markDirty leaves the chunk Dirty");
 
-    const std::size_t launched = scheduler.kickJobs(grid, 0, 0, 8);
+    const std::size_t launched = scheduler.kickJobs(grid, kickParams(0, 0, 8.0f));
     expectTrue(launched == 1, "kickJobs launches one job for one dirty chunk");
     expectTrue(scheduler.dirtyCount() == 0, "kicked chunk left the Dirty state");
 
@@ -92,7 +110,7 @@ void testLifecycleAndResultEquivalence() {
     );
 
     // Nothing dirty: no work.
-    expectTrue(scheduler.kickJobs(grid, 0, 0, 8) == 0, "clean scheduler launches nothing");
+    expectTrue(scheduler.kickJobs(grid, kickParams(0, 0, 8.0f)) == 0, "clean scheduler launches nothing");
     expectTrue(scheduler.drainReady(grid).empty(), "clean scheduler drains nothing");
 }
 
@@ -103,7 +121,7 @@ void testStaleGenerationDiscarded() {
     odai::world::ChunkGrid grid = makeGrid({makeSlabChunk(0, 0, 0, 7)});
     const odai::world::ChunkMeshKey key = keyFor(grid.chunks()[0]);
     scheduler.markDirty(key);
-    scheduler.kickJobs(grid, 0, 0, 8);
+    scheduler.kickJobs(grid, kickParams(0, 0, 8.0f));
     // Edit lands after the mesh finished but before the drain: the stored
     // result's generation is now stale and must be discarded.
     scheduler.markDirty(key);
@@ -112,7 +130,7 @@ void testStaleGenerationDiscarded() {
     expectTrue(results.empty(), "stale-generation result is discarded");
     expectTrue(scheduler.dirtyCount() == 1, "chunk stays Dirty for the next kick");
 
-    scheduler.kickJobs(grid, 0, 0, 8);
+    scheduler.kickJobs(grid, kickParams(0, 0, 8.0f));
     expectTrue(scheduler.drainReady(grid).size() == 1, "re-kicked chunk delivers a fresh result");
 }
 
@@ -122,11 +140,11 @@ void testMeshingOptionsChangeInvalidatesInFlight() {
 
     odai::world::ChunkGrid grid = makeGrid({makeSlabChunk(0, 0, 0, 7)});
     scheduler.markDirty(keyFor(grid.chunks()[0]));
-    scheduler.kickJobs(grid, 0, 0, 8);
+    scheduler.kickJobs(grid, kickParams(0, 0, 8.0f));
     scheduler.setMeshingOptions(odai::world::MeshingOptions{odai::world::MeshingMode::Naive});
 
     expectTrue(scheduler.drainReady(grid).empty(), "old-mode result discarded after options change");
-    scheduler.kickJobs(grid, 0, 0, 8);
+    scheduler.kickJobs(grid, kickParams(0, 0, 8.0f));
     const std::vector<odai::world::ChunkMeshResult> results = scheduler.drainReady(grid);
     expectTrue(results.size() == 1, "new-mode result delivered");
     const odai::world::ChunkLodMeshes naiveDirect =
@@ -141,7 +159,7 @@ void testEvictedChunkDropped() {
     odai::world::ChunkGrid grid = makeGrid({makeSlabChunk(0, 0, 0, 7), makeSlabChunk(1, 0, 0, 9)});
     scheduler.markDirty(keyFor(grid.chunks()[0]));
     scheduler.markDirty(keyFor(grid.chunks()[1]));
-    scheduler.kickJobs(grid, 0, 0, 8);
+    scheduler.kickJobs(grid, kickParams(0, 0, 8.0f));
 
     // Chunk (1,0,0) streams out before the drain.
     odai::world::ChunkGrid shrunkGrid = makeGrid({makeSlabChunk(0, 0, 0, 7)});
@@ -151,7 +169,7 @@ void testEvictedChunkDropped() {
 
     // Dirty chunks that stream out before their kick are forgotten too.
     scheduler.markDirty(odai::world::ChunkMeshKey{5, 0, 5});
-    expectTrue(scheduler.kickJobs(shrunkGrid, 0, 0, 8) == 0, "evicted dirty chunk launches no job");
+    expectTrue(scheduler.kickJobs(shrunkGrid, kickParams(0, 0, 8.0f)) == 0, "evicted dirty chunk launches no job");
     expectTrue(scheduler.dirtyCount() == 0, "evicted dirty chunk is forgotten");
 }
 
@@ -169,7 +187,7 @@ void testWastedWorkAccounting() {
 
     // A clean accept: launched, delivered, charged to accepted.
     scheduler.markDirty(key);
-    scheduler.kickJobs(grid, 0, 0, 8);
+    scheduler.kickJobs(grid, kickParams(0, 0, 8.0f));
     expectTrue(scheduler.stats().jobsLaunched == 1u, "kickJobs counts the launch");
     expectTrue(scheduler.drainReady(grid).size() == 1u, "the result is delivered");
     expectTrue(scheduler.stats().resultsAccepted == 1u, "an accepted result is counted");
@@ -177,7 +195,7 @@ void testWastedWorkAccounting() {
 
     // Edit-during-mesh: the finished mesh is thrown away and charged as waste.
     scheduler.markDirty(key);
-    scheduler.kickJobs(grid, 0, 0, 8);
+    scheduler.kickJobs(grid, kickParams(0, 0, 8.0f));
     scheduler.markDirty(key);
     expectTrue(scheduler.drainReady(grid).empty(), "the stale result is discarded");
     expectTrue(scheduler.stats().discardedStale == 1u, "a stale discard is attributed to staleness");
@@ -204,7 +222,7 @@ void testEvictionWasteIsSeparatedFromDroppedDirty() {
     odai::world::ChunkGrid grid = makeGrid({makeSlabChunk(0, 0, 0, 7), makeSlabChunk(1, 0, 0, 9)});
     scheduler.markDirty(keyFor(grid.chunks()[0]));
     scheduler.markDirty(keyFor(grid.chunks()[1]));
-    scheduler.kickJobs(grid, 0, 0, 8);
+    scheduler.kickJobs(grid, kickParams(0, 0, 8.0f));
 
     // (1,0,0) meshed, then streamed out before the drain: worker time burned.
     odai::world::ChunkGrid shrunkGrid = makeGrid({makeSlabChunk(0, 0, 0, 7)});
@@ -215,7 +233,7 @@ void testEvictionWasteIsSeparatedFromDroppedDirty() {
     // A chunk that streams out while still Dirty never reaches a worker, so it
     // must not inflate the waste numbers.
     scheduler.markDirty(odai::world::ChunkMeshKey{5, 0, 5});
-    expectTrue(scheduler.kickJobs(shrunkGrid, 0, 0, 8) == 0, "evicted dirty chunk launches no job");
+    expectTrue(scheduler.kickJobs(shrunkGrid, kickParams(0, 0, 8.0f)) == 0, "evicted dirty chunk launches no job");
     expectTrue(scheduler.stats().droppedDirtyBeforeKick == 1u, "dropped-before-kick is counted separately");
     expectTrue(scheduler.stats().discardedEvicted == 1u, "dropping before a kick adds no eviction waste");
 }
@@ -233,8 +251,9 @@ void testNearestFirstKickOrderAndBudget() {
         scheduler.markDirty(keyFor(chunk));
     }
 
-    // Camera at chunk x=4: budget of 2 must pick x=4 then x=3.
-    expectTrue(scheduler.kickJobs(grid, 4, 0, 2) == 2, "budget bounds launched jobs");
+    // Camera at chunk x=4: two jobs' worth of budget at the initial 1 ms cost
+    // estimate must pick x=4 then x=3.
+    expectTrue(scheduler.kickJobs(grid, kickParams(4, 0, 2.0f)) == 2, "budget bounds launched jobs");
     std::vector<odai::world::ChunkMeshResult> results = scheduler.drainReady(grid);
     expectTrue(results.size() == 2, "both budgeted jobs completed");
     bool sawNearest = false;
@@ -247,6 +266,325 @@ void testNearestFirstKickOrderAndBudget() {
     expectTrue(scheduler.dirtyCount() == 3, "chunks past the budget stay Dirty");
 }
 
+// Jobs mesh against snapshots of their neighbors' border slabs, and a chunk
+// streaming in re-dirties only the neighbors that meshed without it.
+void testNeighborSlabsAndArrivalRedirty() {
+    odai::core::JobSystem jobs(0);
+    odai::world::ChunkMeshScheduler scheduler(jobs, odai::world::MeshingOptions{});
+
+    const odai::world::ChunkMeshKey center{0, 0, 0};
+    const odai::world::ChunkMeshKey far{-3, 0, 0};
+    odai::world::ChunkGrid grid = makeGrid({makeSlabChunk(0, 0, 0, 7), makeSlabChunk(-3, 0, 0, 7)});
+    scheduler.markDirty(center);
+    scheduler.markDirty(far);
+    scheduler.kickJobs(grid, kickParams(0, 0, 8.0f));
+    std::vector<odai::world::ChunkMeshResult> results = scheduler.drainReady(grid);
+    expectTrue(results.size() == 2, "both lone chunks meshed");
+    std::size_t loneVertexCount = 0;
+    for (const odai::world::ChunkMeshResult& result : results) {
+        if (result.key == center) {
+            loneVertexCount = result.meshes.lodMeshes[0].vertices.size();
+        }
+    }
+
+    // (1,0,0) streams in next to the center chunk only.
+    odai::world::ChunkGrid grownGrid =
+        makeGrid({makeSlabChunk(0, 0, 0, 7), makeSlabChunk(-3, 0, 0, 7), makeSlabChunk(1, 0, 0, 7)});
+    const odai::world::ChunkMeshKey arrived{1, 0, 0};
+    scheduler.markChunksArrived(grownGrid, std::span<const odai::world::ChunkMeshKey>(&arrived, 1));
+    expectTrue(scheduler.dirtyCount() == 2, "arrival dirties the new chunk and its one resident neighbor");
+
+    scheduler.kickJobs(grownGrid, kickParams(0, 0, 8.0f));
+    results = scheduler.drainReady(grownGrid);
+    expectTrue(results.size() == 2, "arrived chunk and re-dirtied neighbor both meshed");
+    const odai::world::ChunkNeighborLookup lookup(grownGrid.chunks());
+    bool centerMatches = false;
+    for (const odai::world::ChunkMeshResult& result : results) {
+        if (result.key != center) {
+            continue;
+        }
+        const odai::world::ChunkLodMeshes direct = odai::world::buildChunkLodMeshes(
+            lookup.neighborhood(grownGrid.chunks()[0]),
+            odai::world::MeshingOptions{},
+            nullptr
+        );
+        centerMatches = meshesEqual(result.meshes, direct);
+        expectTrue(
+            result.meshes.lodMeshes[0].vertices.size() < loneVertexCount,
+            "the seam against the arrived chunk is culled"
+        );
+    }
+    expectTrue(centerMatches, "scheduled mesh matches the direct neighbor-aware mesh");
+
+    // Streaming the same chunk in again: the center already meshed with its
+    // slab, so only the arrival itself is dirtied.
+    scheduler.markChunksArrived(grownGrid, std::span<const odai::world::ChunkMeshKey>(&arrived, 1));
+    expectTrue(scheduler.dirtyCount() == 1, "neighbors that already meshed with the slab stay Clean");
+}
+
+// Rapid edits to one chunk coalesce into one mesh once they settle; a chunk
+// edited without pause still remeshes once maxDebounceMs has passed.
+void testEditDebounceCoalesces() {
+    using namespace std::chrono_literals;
+    odai::core::JobSystem jobs(0);
+    odai::world::ChunkMeshScheduler scheduler(jobs, odai::world::MeshingOptions{});
+    odai::world::ChunkGrid grid = makeGrid({makeSlabChunk(0, 0, 0, 7)});
+    const odai::world::ChunkMeshKey key = keyFor(grid.chunks()[0]);
+    const odai::world::ChunkMeshClock::time_point start{};
+
+    odai::world::ChunkMeshKickParams params = kickParams(0, 0, 8.0f);
+    scheduler.markEdited(key, start);
+    params.now = start + 10ms;
+    expectTrue(scheduler.kickJobs(grid, params) == 0, "a fresh edit waits out the debounce");
+    scheduler.markEdited(key, start + 20ms);
+    expectTrue(scheduler.stats().editsCoalesced == 1u, "a second edit before the kick coalesces");
+    params.now = start + 60ms;
+    expectTrue(scheduler.kickJobs(grid, params) == 0, "the debounce restarts at the latest edit");
+    params.now = start + 75ms;
+    expectTrue(scheduler.kickJobs(grid, params) == 1, "the settled chunk is kicked once");
+    expectTrue(scheduler.drainReady(grid).size() == 1u, "the coalesced mesh is delivered");
+
+    // Continuous edits every 16 ms never settle; the cap still lets one through.
+    std::size_t launched = 0;
+    odai::world::ChunkMeshClock::time_point now = start + 1s;
+    for (int frame = 0; frame < 20; ++frame, now += 16ms) {
+        scheduler.markEdited(key, now);
+        params.now = now;
+        launched += scheduler.kickJobs(grid, params);
+        scheduler.drainReady(grid);
+    }
+    expectTrue(launched == 1u, "a chunk edited every frame remeshes once per maxDebounceMs");
+
+    // Background dirt is not debounced.
+    scheduler.markDirty(key);
+    params.now = now;
+    expectTrue(scheduler.kickJobs(grid, params) == 1, "markDirty chunks are kicked immediately");
+}
+
+// Distance alone no longer decides: a chunk behind the camera yields to a
+// farther one in view, and a fresh edit beats an untouched chunk at the same
+// distance.
+void testKickPriorityScore() {
+    using namespace std::chrono_literals;
+    odai::core::JobSystem jobs(0);
+    odai::world::ChunkMeshScheduler scheduler(jobs, odai::world::MeshingOptions{});
+    odai::world::ChunkGrid grid = makeGrid({
+        makeSlabChunk(0, 0, 0, 7),
+        makeSlabChunk(-1, 0, 0, 7),
+        makeSlabChunk(3, 0, 0, 7),
+        makeSlabChunk(2, 0, 1, 7),
+        makeSlabChunk(2, 0, -1, 7),
+    });
+
+    // Looking down +X with a 90 degree horizontal field of view.
+    odai::world::ChunkMeshKickParams params = kickParams(0, 0, 1.0f);
+    params.forwardX = 1.0f;
+    params.forwardZ = 0.0f;
+    params.halfFovRadians = 0.785398f;
+
+    scheduler.markDirty(odai::world::ChunkMeshKey{-1, 0, 0});
+    scheduler.markDirty(odai::world::ChunkMeshKey{3, 0, 0});
+    expectTrue(scheduler.kickJobs(grid, params) == 1, "one job's worth of budget launches one job");
+    std::vector<odai::world::ChunkMeshResult> results = scheduler.drainReady(grid);
+    expectTrue(
+        results.size() == 1u && results[0].key == odai::world::ChunkMeshKey{3, 0, 0},
+        "the in-view chunk at distance 3 beats the one behind the camera at distance 1"
+    );
+    scheduler.kickJobs(grid, params);
+    scheduler.drainReady(grid);
+
+    const odai::world::ChunkMeshClock::time_point start{};
+    scheduler.markDirty(odai::world::ChunkMeshKey{2, 0, -1});
+    scheduler.markEdited(odai::world::ChunkMeshKey{2, 0, 1}, start);
+    params.now = start + 100ms;
+    scheduler.kickJobs(grid, params);
+    results = scheduler.drainReady(grid);
+    expectTrue(
+        results.size() == 1u && results[0].key == odai::world::ChunkMeshKey{2, 0, 1},
+        "a recently edited chunk is kicked before an untouched one at the same distance"
+    );
+}
+
+// The urgent lane launches regardless of budget, background work yields to
+// it, and drainReady hands its mesh back the same frame even with workers.
+void testUrgentLane() {
+    odai::core::JobSystem jobs(2);
+    odai::world::ChunkMeshScheduler scheduler(jobs, odai::world::MeshingOptions{});
+    odai::world::ChunkGrid grid = makeGrid({makeSlabChunk(0, 0, 0, 7), makeSlabChunk(4, 0, 0, 9)});
+    const odai::world::ChunkMeshKey edited{4, 0, 0};
+    const odai::world::ChunkMeshKey background{0, 0, 0};
+
+    scheduler.markDirty(background);
+    scheduler.markUrgent(edited);
+    expectTrue(scheduler.kickJobs(grid, kickParams(0, 0, 1.0f)) == 1, "only the urgent chunk launches");
+    expectTrue(scheduler.stats().urgentJobsLaunched == 1u, "the launch is counted as urgent");
+    expectTrue(scheduler.dirtyCount() == 1u, "background work yields to the urgent job's cost");
+
+    const std::vector<odai::world::ChunkMeshResult> results = scheduler.drainReady(grid);
+    expectTrue(
+        results.size() == 1u && results[0].key == edited,
+        "the urgent mesh is drained in the frame it was kicked"
+    );
+
+    scheduler.markUrgent(edited);
+    expectTrue(scheduler.kickJobs(grid, kickParams(0, 0, 0.0f)) == 1, "urgent jobs ignore an empty budget");
+    expectTrue(scheduler.drainReady(grid).size() == 1u, "and are still drained the same frame");
+    jobs.waitIdle();
+}
+
+// Scripted edit storm: three chunks edited every frame for half a second,
+// then left alone. Each frame edits, drains, then kicks, so a mesh kicked in
+// one frame meets the next frame's edits while it is still in flight. The
+// immediate scheduler (no debounce, the old behavior) throws nearly every
+// mesh away; the debounced one coalesces the storm.
+void testEditStormWastesLessWithDebounce() {
+    using namespace std::chrono_literals;
+    const auto runStorm = [](odai::world::ChunkMeshSchedulerConfig config) {
+        odai::core::JobSystem jobs(0);
+        odai::world::ChunkMeshScheduler scheduler(jobs, odai::world::MeshingOptions{}, config);
+        std::vector<odai::world::Chunk> chunks;
+        for (int z = -1; z <= 1; ++z) {
+            for (int x = -1; x <= 1; ++x) {
+                chunks.push_back(makeSlabChunk(x, 0, z, 5 + (x + 1) + (z + 1)));
+            }
+        }
+        odai::world::ChunkGrid grid = makeGrid(std::move(chunks));
+        const std::array<odai::world::ChunkMeshKey, 3> stormKeys = {
+            odai::world::ChunkMeshKey{0, 0, 0},
+            odai::world::ChunkMeshKey{1, 0, 0},
+            odai::world::ChunkMeshKey{0, 0, -1},
+        };
+
+        odai::world::ChunkMeshKickParams params = kickParams(0, 0, 100.0f);
+        odai::world::ChunkMeshClock::time_point now{};
+        for (int frame = 0; frame < 40; ++frame, now += 16ms) {
+            if (frame < 30) {
+                for (const odai::world::ChunkMeshKey& key : stormKeys) {
+                    grid.chunks()[static_cast<std::size_t>((key.x + 1) + ((key.z + 1) * 3))].setVoxel(
+                        frame % odai::world::Chunk::kSizeX,
+                        20,
+                        3,
+                        odai::world::Voxel{odai::world::VoxelType::Solid}
+                    );
+                    scheduler.markEdited(key, now);
+                }
+            }
+            scheduler.drainReady(grid);
+            params.now = now;
+            scheduler.kickJobs(grid, params);
+        }
+        scheduler.drainReady(grid);
+        expectTrue(scheduler.dirtyCount() == 0u && scheduler.meshingCount() == 0u, "the storm settles to Clean");
+        return scheduler.stats();
+    };
+
+    odai::world::ChunkMeshSchedulerConfig immediate;
+    immediate.debounceMs = 0.0f;
+    immediate.maxDebounceMs = 0.0f;
+    const odai::world::ChunkMeshSchedulerStats immediateStats = runStorm(immediate);
+    const odai::world::ChunkMeshSchedulerStats debouncedStats = runStorm(odai::world::ChunkMeshSchedulerConfig{});
+
+    expectTrue(debouncedStats.discardedStale < immediateStats.discardedStale, "debounce discards fewer stale meshes");
+    expectTrue(debouncedStats.jobsLaunched < immediateStats.jobsLaunched, "debounce launches fewer jobs");
+    expectTrue(debouncedStats.editsCoalesced > 0u, "storm edits coalesce");
+    expectTrue(
+        debouncedStats.wastedFraction() < immediateStats.wastedFraction(),
+        "debounce lowers the wasted fraction of worker time"
+    );
+}
+
+// Mesh output buffers come from a pool: once consumers hand results back,
+// remeshing the same chunks allocates nothing, and stale results are recycled
+// by the scheduler itself.
+void testMeshBufferPoolRecycles() {
+    {
+        odai::world::ChunkMeshBufferPool pool(1);
+        const odai::world::Chunk chunk = makeSlabChunk(0, 0, 0, 7);
+        odai::world::ChunkLodMeshes first = pool.acquire();
+        odai::world::buildChunkLodMeshesInto(
+            odai::world::ChunkNeighborhood{&chunk, odai::world::ChunkBorderSlabs{}},
+            odai::world::MeshingOptions{},
+            nullptr,
+            first
+        );
+        pool.recordBuild(0u, first);
+        const odai::world::ChunkMeshBufferPoolStats built = pool.stats();
+        expectTrue(built.allocations == 1u && built.reuses == 0u, "a fresh set counts one allocation");
+        expectTrue(built.liveBytes == odai::world::chunkMeshCapacityBytes(first), "live bytes track the built set");
+
+        pool.release(std::move(first));
+        odai::world::ChunkLodMeshes second = pool.acquire();
+        const std::size_t secondBytes = odai::world::chunkMeshCapacityBytes(second);
+        odai::world::buildChunkLodMeshesInto(
+            odai::world::ChunkNeighborhood{&chunk, odai::world::ChunkBorderSlabs{}},
+            odai::world::MeshingOptions{},
+            nullptr,
+            second
+        );
+        pool.recordBuild(secondBytes, second);
+        expectTrue(pool.stats().reuses == 1u && pool.stats().allocations == 1u, "a recycled set builds without allocating");
+
+        odai::world::ChunkLodMeshes third = pool.acquire();
+        odai::world::buildChunkLodMeshesInto(
+            odai::world::ChunkNeighborhood{&chunk, odai::world::ChunkBorderSlabs{}},
+            odai::world::MeshingOptions{},
+            nullptr,
+            third
+        );
+        pool.recordBuild(0u, third);
+        const std::size_t peak = pool.stats().peakBytes;
+        pool.release(std::move(second));
+        pool.release(std::move(third));
+        const odai::world::ChunkMeshBufferPoolStats released = pool.stats();
+        expectTrue(released.freeSets == 1u, "the free list is capped");
+        expectTrue(released.liveBytes < peak && released.peakBytes == peak, "a set beyond the cap is freed");
+    }
+
+    const auto runRounds = [](bool releaseResults) {
+        odai::core::JobSystem jobs(0);
+        odai::world::ChunkMeshScheduler scheduler(jobs, odai::world::MeshingOptions{});
+        odai::world::ChunkGrid grid = makeGrid({
+            makeSlabChunk(0, 0, 0, 3),
+            makeSlabChunk(1, 0, 0, 9),
+            makeSlabChunk(0, 0, 1, 15),
+            makeSlabChunk(1, 0, 1, 21),
+        });
+        std::uint64_t allocationsAfterWarmup = 0;
+        for (int round = 0; round < 16; ++round) {
+            for (const odai::world::Chunk& chunk : grid.chunks()) {
+                scheduler.markDirty(keyFor(chunk));
+            }
+            scheduler.kickJobs(grid, kickParams(0, 0, 100.0f));
+            if (round % 4 == 3) {
+                // Edited while in flight: every result is stale.
+                scheduler.markDirty(keyFor(grid.chunks()[0]));
+                scheduler.markDirty(keyFor(grid.chunks()[3]));
+            }
+            for (odai::world::ChunkMeshResult& result : scheduler.drainReady(grid)) {
+                if (releaseResults) {
+                    scheduler.releaseMeshes(std::move(result.meshes));
+                }
+            }
+            if (round == 1) {
+                allocationsAfterWarmup = scheduler.stats().meshBufferAllocations;
+            }
+        }
+        scheduler.kickJobs(grid, kickParams(0, 0, 100.0f));
+        scheduler.drainReady(grid);
+        return std::pair<std::uint64_t, odai::world::ChunkMeshSchedulerStats>{allocationsAfterWarmup, scheduler.stats()};
+    };
+
+    const auto [keptWarmup, kept] = runRounds(false);
+    const auto [releasedWarmup, released] = runRounds(true);
+    expectTrue(released.discardedStale > 0u, "the scripted rounds include stale results");
+    expectTrue(
+        released.meshBufferAllocations == releasedWarmup,
+        "released mesh buffers are reused: no allocations after warm-up"
+    );
+    expectTrue(kept.meshBufferAllocations > keptWarmup, "without releases every round allocates");
+    expectTrue(released.peakMeshBufferBytes > 0u, "peak mesh buffer bytes are reported");
+}
+
 void testGrassDeterminism() {
     odai::world::Chunk chunk(0, 0, 0);
     for (int z = 0; z < odai::world::Chunk::kSizeZ; ++z) {
@@ -277,6 +615,159 @@ void testGrassDeterminism() {
     );
 }
 
+// buildGrassInstancesParallel is a drop-in for the per-chunk loop: same
+// output, bit for bit, in chunk order. `odai_voxel_bench parallel` times both.
+void testParallelGrassMatchesSerial() {
+    const odai::tools::GrassScatterCorpus corpus = odai::tools::buildGrassScatterCorpus();
+    const std::vector<odai::world::Chunk>& chunks = corpus.chunks;
+    const std::vector<odai::world::GrassScatterParams>& params = corpus.params;
+
+    std::vector<std::vector<odai::world::GrassInstance>> serial;
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        serial.push_back(odai::world::buildGrassInstances(chunks[i], params[i]));
+    }
+
+    odai::core::JobSystem jobs(std::max(2u, std::thread::hardware_concurrency()));
+    const std::vector<std::vector<odai::world::GrassInstance>> parallel =
+        odai::world::buildGrassInstancesParallel(jobs, chunks, params);
+
+    bool identical = serial.size() == parallel.size();
+    std::size_t instanceCount = 0;
+    for (std::size_t i = 0; identical && i < serial.size(); ++i) {
+        identical = serial[i].size() == parallel[i].size() &&
+                    std::memcmp(
+                        serial[i].data(),
+                        parallel[i].data(),
+                        serial[i].size() * sizeof(odai::world::GrassInstance)
+                    ) == 0;
+        instanceCount += serial[i].size();
+    }
+    expectTrue(instanceCount > 0u, "grass test corpus scatters instances");
+    expectTrue(identical, "parallel grass scatter is bit-identical to the serial loop");
+
+    const std::vector<odai::world::GrassScatterParams> tooFew(params.begin(), params.begin() + 1);
+    expectTrue(
+        odai::world::buildGrassInstancesParallel(jobs, chunks, tooFew).empty(),
+        "mismatched chunk/params spans scatter nothing"
+    );
+}
+
+std::vector<odai::world::GrassInstance> sortedGrassInstances(std::span<const odai::world::GrassInstance> instances) {
+    std::vector<odai::world::GrassInstance> sorted(instances.begin(), instances.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+        return std::memcmp(&lhs, &rhs, sizeof(odai::world::GrassInstance)) < 0;
+    });
+    return sorted;
+}
+
+bool sameGrassInstances(
+    std::span<const odai::world::GrassInstance> lhs,
+    std::span<const odai::world::GrassInstance> rhs
+) {
+    const std::vector<odai::world::GrassInstance> sortedLhs = sortedGrassInstances(lhs);
+    const std::vector<odai::world::GrassInstance> sortedRhs = sortedGrassInstances(rhs);
+    return sortedLhs.size() == sortedRhs.size() &&
+           std::memcmp(
+               sortedLhs.data(),
+               sortedRhs.data(),
+               sortedLhs.size() * sizeof(odai::world::GrassInstance)
+           ) == 0;
+}
+
+bool grassCacheMatchesFreshScatter(
+    const odai::world::GrassInstanceCache& cache,
+    const std::vector<odai::world::Chunk>& chunks
+) {
+    if (cache.chunkRanges().size() != chunks.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        const odai::world::GrassInstanceCache::ChunkRange& range = cache.chunkRanges()[i];
+        if (range.chunk.x != chunks[i].chunkX() || range.chunk.z != chunks[i].chunkZ()) {
+            return false;
+        }
+        odai::world::GrassScatterParams params{};
+        params.activeRadius = 8;
+        params.retainedRadius = 8;
+        const std::vector<odai::world::GrassInstance> fresh = odai::world::buildGrassInstances(chunks[i], params);
+        if (!sameGrassInstances(cache.instances().subspan(range.firstInstance, range.instanceCount), fresh)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// `odai_voxel_bench grass` times the cold, unchanged and single-edit updates.
+void testGrassInstanceCache() {
+    std::vector<odai::world::Chunk> chunks = odai::tools::buildGrassCacheCorpus();
+    odai::world::GrassScatterParams params{};
+    params.activeRadius = 8;
+    params.retainedRadius = 8;
+
+    odai::core::JobSystem jobs(std::max(2u, std::thread::hardware_concurrency()));
+    odai::world::GrassInstanceCache cache;
+    cache.update(chunks, params, &jobs);
+    expectTrue(cache.stats().chunksFullyScattered == chunks.size(), "cold grass cache scatters every chunk");
+    expectTrue(!cache.instances().empty(), "grass cache corpus scatters instances");
+    expectTrue(grassCacheMatchesFreshScatter(cache, chunks), "grass cache arena matches a fresh scatter per chunk");
+    const std::size_t warmCapacity = cache.arenaCapacity();
+
+    cache.resetStats();
+    cache.update(chunks, params, &jobs);
+    expectTrue(cache.stats().chunksReused == chunks.size(), "unchanged chunks reuse their cached grass");
+    expectTrue(
+        cache.stats().columnsScattered == 0u && cache.stats().arenaRepacks == 0u,
+        "an unchanged world neither rescatters nor repacks"
+    );
+
+    // Remove the grass under one column: only that column is rescattered.
+    odai::world::Chunk& edited = chunks[24];
+    const int editX = 5;
+    const int editZ = 9;
+    const int editY = odai::tools::grassTerraceHeight(edited.chunkX(), edited.chunkZ(), editX, editZ);
+    edited.setVoxel(editX, editY, editZ, odai::world::Voxel{});
+    cache.markVoxelEdited(
+        edited.chunkX() * odai::world::Chunk::kSizeX + editX,
+        editY,
+        edited.chunkZ() * odai::world::Chunk::kSizeZ + editZ
+    );
+    cache.resetStats();
+    cache.update(chunks, params, &jobs);
+    expectTrue(
+        cache.stats().chunksPartiallyScattered == 1u && cache.stats().chunksFullyScattered == 0u &&
+            cache.stats().columnsScattered == 1u,
+        "a reported single-voxel edit rescatters only its column"
+    );
+    expectTrue(cache.stats().chunksReused == chunks.size() - 1u, "chunks next to an edit stay cached");
+    expectTrue(grassCacheMatchesFreshScatter(cache, chunks), "column rescatter matches a fresh scatter");
+    expectTrue(cache.arenaCapacity() == warmCapacity, "warm grass arena does not reallocate after an edit");
+
+    // An unreported edit still changes the content version.
+    chunks[3].setVoxel(0, 20, 0, odai::world::Voxel{odai::world::VoxelType::Grass});
+    cache.resetStats();
+    cache.update(chunks, params);
+    expectTrue(cache.stats().chunksFullyScattered == 1u, "unreported edits rescatter the whole chunk");
+    expectTrue(grassCacheMatchesFreshScatter(cache, chunks), "serial full rescatter matches a fresh scatter");
+
+    // Chunks leaving the active radius drop out of the arena but stay cached;
+    // chunks leaving the resident span are evicted.
+    odai::world::GrassScatterParams nearParams = params;
+    nearParams.activeRadius = 1;
+    nearParams.retainedRadius = 1;
+    cache.update(chunks, nearParams, &jobs);
+    expectTrue(cache.chunkRanges().size() == 9u, "only chunks within the retained radius are packed");
+    expectTrue(cache.cachedChunkCount() == chunks.size(), "inactive chunks keep their cache entry");
+    cache.resetStats();
+    cache.update(chunks, params, &jobs);
+    expectTrue(
+        cache.stats().chunksReused == chunks.size() && cache.stats().columnsScattered == 0u,
+        "reactivated chunks reuse cached grass"
+    );
+    cache.update(std::span<const odai::world::Chunk>(chunks).first(10), params, &jobs);
+    expectTrue(cache.cachedChunkCount() == 10u, "chunks no longer resident are evicted");
+    expectTrue(cache.chunkRanges().size() == 10u, "evicted chunks leave the arena");
+}
+
 void testThreadedStress() {
     odai::core::JobSystem jobs(4);
     odai::world::ChunkMeshScheduler scheduler(jobs, odai::world::MeshingOptions{});
@@ -296,7 +787,7 @@ void testThreadedStress() {
         for (int dirtyIndex = 0; dirtyIndex < 3; ++dirtyIndex) {
             scheduler.markDirty(keyFor(grid.chunks()[pickChunk(rng)]));
         }
-        scheduler.kickJobs(grid, 0, 0, 8);
+        scheduler.kickJobs(grid, kickParams(0, 0, 8.0f));
         deliveredResultCount += scheduler.drainReady(grid).size();
     }
     jobs.waitIdle();
@@ -315,7 +806,15 @@ int main() {
     testWastedWorkAccounting();
     testEvictionWasteIsSeparatedFromDroppedDirty();
     testNearestFirstKickOrderAndBudget();
+    testNeighborSlabsAndArrivalRedirty();
+    testEditDebounceCoalesces();
+    testKickPriorityScore();
+    testUrgentLane();
+    testEditStormWastesLessWithDebounce();
+    testMeshBufferPoolRecycles();
     testGrassDeterminism();
+    testParallelGrassMatchesSerial();
+    testGrassInstanceCache();
     testThreadedStress();
 
     if (g_failures != 0) {
@@ -1,16 +1,32 @@
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "core/grid3.h"
+#include "core/job_system.h"
 #include "games/voxelcraft/voxelcraft_player.h"
 #include "games/voxelcraft/voxelcraft_streaming.h"
 #include "math/math.h"
 #include "sim/network_graph.h"
 #include "sim/network_procedural.h"
 #include "sim/simulation.h"
+#include "tools/sim_network_layouts.h"
+#include "tools/voxel_layouts.h"
 #include "render/frame_arena_alias.h"
 #include "world/clipmap_index.h"
 #include "world/chunk.h"
@@ -18,6 +34,7 @@
 #include "world/magica_voxel.h"
 #include "world/csg.h"
 #include "world/world.h"
+#include "world/world_file.h"
 
 namespace {
 
@@ -280,9 +297,9 @@ void testChunkMeshingModes() {
         const odai::world::ChunkMeshData naive = odai::world::buildChunkMesh(chunk, naiveOptions);
         const odai::world::ChunkMeshData greedy = odai::world::buildChunkMesh(chunk, greedyOptions);
         expectTrue(naive.vertices.size() == 24u, "Naive single voxel vertex count");
-        expectTrue(naive.indices.size() == 36u, "Naive single voxel index count");
+        expectTrue(naive.indexCount() == 36u, "Naive single voxel index count");
         expectTrue(greedy.vertices.size() == naive.vertices.size(), "Greedy single voxel matches naive vertices");
-        expectTrue(greedy.indices.size() == naive.indices.size(), "Greedy single voxel matches naive indices");
+        expectTrue(greedy.indexCount() == naive.indexCount(), "Greedy single voxel matches naive indices");
     }
 
     {
@@ -299,9 +316,9 @@ void testChunkMeshingModes() {
 
         const std::size_t expectedNaiveVisibleQuads = static_cast<std::size_t>(6 * Chunk::kSizeX * Chunk::kSizeY);
         expectTrue(naive.vertices.size() == expectedNaiveVisibleQuads * 4u, "Naive full chunk visible vertex count");
-        expectTrue(naive.indices.size() == expectedNaiveVisibleQuads * 6u, "Naive full chunk visible index count");
+        expectTrue(naive.indexCount() == expectedNaiveVisibleQuads * 6u, "Naive full chunk visible index count");
         expectTrue(greedy.vertices.size() == 24u, "Greedy full chunk collapses to 6 quads");
-        expectTrue(greedy.indices.size() == 36u, "Greedy full chunk collapses to 6 quads indices");
+        expectTrue(greedy.indexCount() == 36u, "Greedy full chunk collapses to 6 quads indices");
     }
 
     {
@@ -318,7 +335,7 @@ void testChunkMeshingModes() {
         expectTrue(!naive.vertices.empty(), "Naive slab produces geometry");
         expectTrue(!greedy.vertices.empty(), "Greedy slab produces geometry");
         expectTrue(greedy.vertices.size() < naive.vertices.size(), "Greedy slab reduces vertex count");
-        expectTrue(greedy.indices.size() < naive.indices.size(), "Greedy slab reduces index count");
+        expectTrue(greedy.indexCount() < naive.indexCount(), "Greedy slab reduces index count");
     }
 }
 
@@ -358,7 +375,7 @@ void testChunkMeshingStats() {
             "Exposed face count times 4 equals naive vertex count"
         );
         expectTrue(
-            naiveStats.exposedFaceCount * 6u == naive.lodMeshes[0].indices.size(),
+            naiveStats.exposedFaceCount * 6u == naive.lodMeshes[0].indexCount(),
             "Exposed face count times 6 equals naive index count"
         );
     }
@@ -423,6 +440,1333 @@ void testProceduralWorldGenerationTerrain() {
     expectTrue(materialVariety >= 2, "Procedural terrain uses slope-aware surface material variety");
 }
 
+// FNV-1a over every voxel of a fixed set of surface and canopy chunks,
+// including two near settlements. Captured from the scalar, single-threaded
+// generator; saved worlds regenerate untouched chunks through it, so any
+// change here is a world-format break, not a test to update. odai_voxel_bench
+// times the same chunks, serial and split.
+void testProceduralWorldGenerationGolden() {
+    constexpr std::uint64_t kGoldenHash = 0x62A1E60DC4E3C6A2ull;
+    constexpr std::array<std::array<int, 2>, 8> kChunkColumns = {{
+        {0, 0}, {1, 0}, {-1, -1}, {1, -4}, {-2, 2}, {3, -9}, {8, 9}, {-7, -6}
+    }};
+
+    const auto hashChunks = [&](odai::core::JobSystem* jobs) {
+        std::uint64_t hash = 1469598103934665603ull;
+        for (const std::array<int, 2>& column : kChunkColumns) {
+            for (int chunkY = 0; chunkY <= 1; ++chunkY) {
+                const odai::world::Chunk chunk = odai::world::buildProceduralChunk(column[0], chunkY, column[1], jobs);
+                for (int y = 0; y < odai::world::Chunk::kSizeY; ++y) {
+                    for (int z = 0; z < odai::world::Chunk::kSizeZ; ++z) {
+                        for (int x = 0; x < odai::world::Chunk::kSizeX; ++x) {
+                            const odai::world::Voxel voxel = chunk.voxelAt(x, y, z);
+                            hash = (hash ^ static_cast<std::uint8_t>(voxel.type)) * 1099511628211ull;
+                            hash = (hash ^ voxel.baseColorIndex) * 1099511628211ull;
+                        }
+                    }
+                }
+            }
+        }
+        return hash;
+    };
+
+    expectTrue(hashChunks(nullptr) == kGoldenHash, "Procedural chunks match the worldgen golden hash");
+    odai::core::JobSystem jobs(3);
+    expectTrue(
+        hashChunks(&jobs) == kGoldenHash,
+        "Procedural chunks split across workers match the worldgen golden hash"
+    );
+}
+
+void testTerrainPatchCache() {
+    using odai::world::Chunk;
+    using odai::world::TerrainPatchCache;
+
+    // Columns straddling the corner of four regions, both terrain layers.
+    std::vector<std::array<int, 3>> keys;
+    for (int chunkZ = -2; chunkZ <= 1; ++chunkZ) {
+        for (int chunkX = 2; chunkX <= 5; ++chunkX) {
+            for (int chunkY = 0; chunkY <= 1; ++chunkY) {
+                keys.push_back({chunkX, chunkY, chunkZ});
+            }
+        }
+    }
+
+    std::vector<Chunk> uncached;
+    uncached.reserve(keys.size());
+    for (const std::array<int, 3>& key : keys) {
+        uncached.push_back(odai::world::buildProceduralChunk(key[0], key[1], key[2]));
+    }
+
+    TerrainPatchCache cache;
+    bool cachedMatches = true;
+    for (std::size_t index = 0; index < keys.size(); ++index) {
+        const std::array<int, 3>& key = keys[index];
+        const Chunk chunk = odai::world::buildProceduralChunk(key[0], key[1], key[2], nullptr, &cache);
+        cachedMatches = cachedMatches && chunksEqual(chunk, uncached[index]);
+    }
+    expectTrue(cachedMatches, "Chunks built from cached terrain regions match uncached generation");
+    const TerrainPatchCache::Stats stats = cache.stats();
+    expectTrue(stats.builtRegionCount == 4u, "Terrain cache samples each region once");
+    expectTrue(stats.reusedRegionCount == keys.size() - 4u, "Terrain cache serves the other chunks from its regions");
+    expectTrue(stats.cachedRegionCount == 4u && stats.evictedRegionCount == 0u, "Idle regions within budget stay cached");
+
+    // Concurrent generation shares regions too: a chunk whose region is being
+    // built by another worker waits for it instead of sampling it again.
+    odai::core::JobSystem jobs(3);
+    TerrainPatchCache sharedCache;
+    std::vector<Chunk> parallelChunks(keys.size());
+    odai::core::parallelFor(jobs, 0, keys.size(), 1, [&](std::size_t index) {
+        const std::array<int, 3>& key = keys[index];
+        parallelChunks[index] = odai::world::buildProceduralChunk(key[0], key[1], key[2], nullptr, &sharedCache);
+    });
+    bool parallelMatches = true;
+    for (std::size_t index = 0; index < keys.size(); ++index) {
+        parallelMatches = parallelMatches && chunksEqual(parallelChunks[index], uncached[index]);
+    }
+    expectTrue(parallelMatches, "Chunks generated concurrently from a shared terrain cache match uncached generation");
+    expectTrue(sharedCache.stats().builtRegionCount == 4u, "Concurrent generation builds each region once");
+
+    // Eviction only takes idle regions, least recently used first.
+    TerrainPatchCache smallCache(1);
+    const std::shared_ptr<const odai::world::TerrainRegion> held = smallCache.acquire(0, 0);
+    (void)smallCache.acquire(TerrainPatchCache::kRegionChunks, 0);
+    (void)smallCache.acquire(TerrainPatchCache::kRegionChunks * 2, 0);
+    (void)smallCache.acquire(1, 1);
+    const TerrainPatchCache::Stats smallStats = smallCache.stats();
+    expectTrue(
+        smallStats.evictedRegionCount == 1u && smallStats.cachedRegionCount == 2u,
+        "Terrain cache evicts idle regions past its budget"
+    );
+    (void)smallCache.acquire(TerrainPatchCache::kRegionChunks * 2, 0);
+    expectTrue(smallCache.stats().builtRegionCount == 3u, "Terrain cache keeps lent and recently used regions");
+}
+
+// compareSlots=false ignores which Chunk4 slot a Refined4 cell landed in, which
+// depends on edit order rather than contents.
+bool macroCellsEqual(const odai::world::Chunk& lhs, const odai::world::Chunk& rhs, bool compareSlots = true) {
+    for (int my = 0; my < odai::world::Chunk::kMacroSizeY; ++my) {
+        for (int mz = 0; mz < odai::world::Chunk::kMacroSizeZ; ++mz) {
+            for (int mx = 0; mx < odai::world::Chunk::kMacroSizeX; ++mx) {
+                const odai::world::Chunk::MacroCell a = lhs.macroCellAt(mx, my, mz);
+                const odai::world::Chunk::MacroCell b = rhs.macroCellAt(mx, my, mz);
+                if (!(a.voxel == b.voxel) || a.resolution != b.resolution || a.refined1Index != b.refined1Index ||
+                    (compareSlots && a.refined4Index != b.refined4Index)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void testPaletteChunkStorage() {
+    using odai::world::Chunk;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+
+    Chunk air(0, 1, 0);
+    expectTrue(air.storageMode() == Chunk::StorageMode::Uniform, "New chunk starts as uniform air");
+    expectTrue(air.memoryFootprintBytes() < 2048u, "Uniform chunk does not allocate dense voxels");
+
+    air.setVoxel(4, 5, 6, Voxel{VoxelType::Wood, 3u});
+    expectTrue(air.storageMode() == Chunk::StorageMode::Palette, "First distinct voxel switches to palette storage");
+    expectTrue(air.voxelAt(4, 5, 6) == Voxel{VoxelType::Wood, 3u}, "Palette chunk returns the edited voxel");
+    expectTrue(air.voxelAt(5, 5, 6).type == VoxelType::Empty, "Palette chunk keeps untouched voxels");
+    expectTrue(
+        air.macroCellAt(0, 0, 0).resolution == Chunk::CellResolution::Refined1,
+        "Single-voxel edit refines its macro cell"
+    );
+    air.setVoxel(4, 5, 6, Voxel{VoxelType::Empty});
+    air.compactStorage();
+    expectTrue(air.storageMode() == Chunk::StorageMode::Uniform, "Compaction collapses an all-air chunk to uniform");
+    expectTrue(
+        air.macroCellAt(0, 0, 0).resolution == Chunk::CellResolution::Uniform,
+        "Reverted edit restores the uniform macro cell"
+    );
+
+    const Chunk terrain = odai::world::buildProceduralChunk(1, 0, -2);
+    Chunk denseTerrain = terrain;
+    denseTerrain.expandToDense();
+    expectTrue(terrain.storageMode() == Chunk::StorageMode::Palette, "Procedural chunk is stored as a palette");
+    expectTrue(denseTerrain.storageMode() == Chunk::StorageMode::Dense, "expandToDense switches to dense storage");
+    expectTrue(chunksEqual(terrain, denseTerrain), "Palette and dense storage hold identical voxels");
+    expectTrue(macroCellsEqual(terrain, denseTerrain), "Palette and dense storage report identical macro cells");
+    expectTrue(
+        terrain.memoryFootprintBytes() * 3u < denseTerrain.memoryFootprintBytes(),
+        "Palette storage is several times smaller than dense storage"
+    );
+
+    const odai::world::MeshingOptions greedy{odai::world::MeshingMode::Greedy};
+    const odai::world::ChunkMeshData paletteMesh = odai::world::buildChunkMesh(terrain, greedy);
+    const odai::world::ChunkMeshData denseMesh = odai::world::buildChunkMesh(denseTerrain, greedy);
+    bool meshesMatch = paletteMesh.indices == denseMesh.indices &&
+                       paletteMesh.vertices.size() == denseMesh.vertices.size();
+    for (std::size_t i = 0; meshesMatch && i < paletteMesh.vertices.size(); ++i) {
+        meshesMatch = paletteMesh.vertices[i].bits == denseMesh.vertices[i].bits;
+    }
+    expectTrue(meshesMatch, "Meshing a palette chunk matches meshing its dense expansion");
+
+    // In-place palette edits neither duplicate the chunk nor grow the palette.
+    Chunk edited = terrain;
+    edited.setVoxel(8, 28, 8, Voxel{VoxelType::Leaves});
+    const std::size_t paletteSizeAfterFirstEdit = edited.paletteSize();
+    for (int i = 0; i < 256; ++i) {
+        edited.setVoxel(8, 28, 8, Voxel{(i & 1) != 0 ? VoxelType::Empty : VoxelType::Leaves});
+    }
+    expectTrue(
+        edited.storageMode() == Chunk::StorageMode::Palette && edited.paletteSize() == paletteSizeAfterFirstEdit,
+        "Repeated edits stay in palette storage without growing the palette"
+    );
+
+    // More distinct voxels than a palette can index falls back to dense.
+    Chunk colorful;
+    for (int i = 0; i < 384; ++i) {
+        const VoxelType type = static_cast<VoxelType>(1 + (i % 6));
+        colorful.setVoxel(i % Chunk::kSizeX, i / Chunk::kSizeX, 0, Voxel{type, static_cast<std::uint8_t>(i / 6)});
+    }
+    expectTrue(colorful.storageMode() == Chunk::StorageMode::Dense, "Palette overflow switches to dense storage");
+    expectTrue(
+        colorful.voxelAt(383 % Chunk::kSizeX, 383 / Chunk::kSizeX, 0) == Voxel{static_cast<VoxelType>(1 + (383 % 6)), 63u},
+        "Dense fallback keeps every written voxel"
+    );
+    std::vector<Voxel> denseCopy;
+    terrain.copyDenseVoxels(denseCopy);
+    expectTrue(
+        denseCopy.size() == Chunk::kVoxelCount && denseCopy[0] == terrain.voxelAt(0, 0, 0),
+        "Dense copy covers the whole chunk"
+    );
+
+    // Overwriting an overflowed chunk demotes it once the live set fits again.
+    colorful.beginEdit();
+    for (int y = 0; y < Chunk::kSizeY; ++y) {
+        for (int z = 0; z < Chunk::kSizeZ; ++z) {
+            for (int x = 0; x < Chunk::kSizeX; ++x) {
+                colorful.setVoxel(x, y, z, Voxel{y < 4 ? VoxelType::Stone : VoxelType::Empty});
+            }
+        }
+    }
+    colorful.endEdit();
+    expectTrue(
+        colorful.storageMode() == Chunk::StorageMode::Palette && colorful.paletteSize() == 2u,
+        "Overwritten dense overflow chunk demotes to a two-entry palette"
+    );
+    colorful.beginEdit();
+    for (int x = 0; x < Chunk::kSizeX; ++x) {
+        colorful.setVoxel(x, 0, 0, Voxel{VoxelType::Empty});
+    }
+    colorful.endEdit();
+    expectTrue(colorful.storageMode() == Chunk::StorageMode::Palette, "Partial overwrite stays in palette storage");
+    colorful.beginEdit();
+    for (int y = 0; y < 4; ++y) {
+        for (int z = 0; z < Chunk::kSizeZ; ++z) {
+            for (int x = 0; x < Chunk::kSizeX; ++x) {
+                colorful.setVoxel(x, y, z, Voxel{VoxelType::Empty});
+            }
+        }
+    }
+    colorful.endEdit();
+    expectTrue(colorful.storageMode() == Chunk::StorageMode::Uniform, "Clearing the last solid voxels demotes to uniform");
+
+    // Stale palette entries are dropped once they outnumber live ones.
+    Chunk churned;
+    for (int i = 0; i < 64; ++i) {
+        churned.setVoxel(i % Chunk::kSizeX, 0, i / Chunk::kSizeX, Voxel{VoxelType::Stone, static_cast<std::uint8_t>(i)});
+    }
+    const std::size_t paletteSizeBeforeChurn = churned.paletteSize();
+    for (int i = 1; i < 64; ++i) {
+        churned.setVoxel(i % Chunk::kSizeX, 0, i / Chunk::kSizeX, Voxel{VoxelType::Empty});
+    }
+    expectTrue(
+        paletteSizeBeforeChurn == 65u && churned.paletteSize() < paletteSizeBeforeChurn / 2u,
+        "Palette recompacts once stale entries outnumber live ones"
+    );
+    expectTrue(
+        churned.voxelAt(0, 0, 0) == Voxel{VoxelType::Stone, 0u} && churned.voxelAt(1, 0, 0).type == VoxelType::Empty,
+        "Recompaction keeps voxel contents"
+    );
+}
+
+// Batched edits must leave the same voxels and macro cells as per-voxel edits.
+// `odai_voxel_bench edits` times the two paths against each other.
+void testBatchedChunkEdits() {
+    using odai::world::Chunk;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+
+    const Chunk terrain = odai::world::buildProceduralChunk(0, 0, 0);
+    std::vector<Chunk::VoxelWrite> writes;
+    for (int i = 0; i < 2048; ++i) {
+        const int x = (i * 7) % Chunk::kSizeX;
+        const int y = (i * 13) % Chunk::kSizeY;
+        const int z = (i * 29) % Chunk::kSizeZ;
+        writes.push_back(Chunk::VoxelWrite{x, y, z, Voxel{(i % 3) == 0 ? VoxelType::Empty : VoxelType::Wood}});
+    }
+    Chunk perVoxel = terrain;
+    for (const Chunk::VoxelWrite& write : writes) {
+        perVoxel.setVoxel(write.x, write.y, write.z, write.voxel);
+    }
+    Chunk batched = terrain;
+    batched.setVoxels(writes);
+    expectTrue(chunksEqual(perVoxel, batched), "Batched edits write the same voxels as per-voxel edits");
+    expectTrue(macroCellsEqual(perVoxel, batched, false), "Batched edits resolve the same macro cells");
+
+    Chunk nested(0, 0, 0);
+    nested.beginEdit();
+    nested.beginEdit();
+    nested.setVoxel(1, 1, 1, Voxel{VoxelType::Stone});
+    nested.endEdit();
+    expectTrue(!nested.isMacroSolid(0, 0, 0), "Inner endEdit leaves macro cells pending");
+    nested.endEdit();
+    expectTrue(nested.isMacroSolid(0, 0, 0), "Outer endEdit resolves dirty macro cells");
+
+    // Flipping a cell between Refined4 and Refined1 reuses its freed Chunk4 slot.
+    Chunk toggled(0, 0, 0);
+    toggled.beginEdit();
+    for (int y = 0; y < Chunk::kRefined4VoxelSize; ++y) {
+        for (int z = 0; z < Chunk::kRefined4VoxelSize; ++z) {
+            for (int x = 0; x < Chunk::kRefined4VoxelSize; ++x) {
+                toggled.setVoxel(x, y, z, Voxel{VoxelType::Stone});
+            }
+        }
+    }
+    toggled.endEdit();
+    expectTrue(
+        toggled.macroCellAt(0, 0, 0).resolution == Chunk::CellResolution::Refined4,
+        "Filled subcell refines its macro cell to Chunk4"
+    );
+    toggled.setVoxel(1, 1, 1, Voxel{VoxelType::Empty});
+    toggled.setVoxel(1, 1, 1, Voxel{VoxelType::Stone});
+    const std::size_t footprintAfterFirstToggle = toggled.memoryFootprintBytes();
+    for (int i = 0; i < 200; ++i) {
+        toggled.setVoxel(1, 1, 1, Voxel{(i & 1) == 0 ? VoxelType::Empty : VoxelType::Stone});
+    }
+    expectTrue(
+        toggled.memoryFootprintBytes() == footprintAfterFirstToggle &&
+            toggled.macroCellAt(0, 0, 0).resolution == Chunk::CellResolution::Refined4,
+        "Refinement slots are reused instead of growing"
+    );
+}
+
+// The binary mesher must reproduce the per-voxel greedy mesher bit for bit:
+// same quads, same order, same AO, same index winding, over a procedural
+// corpus plus edge cases.
+void testBinaryGreedyMesherMatchesReference() {
+    using odai::world::Chunk;
+    using odai::world::ChunkLodMeshes;
+    using odai::world::ChunkMeshingStats;
+    using odai::world::MeshingMode;
+    using odai::world::MeshingOptions;
+
+    // `odai_voxel_bench mesher` times both meshers over the same corpus.
+    const std::vector<Chunk> corpus = odai::tools::buildMesherCorpus();
+
+    bool identical = true;
+    std::size_t totalFaces = 0;
+    for (std::size_t chunkIndex = 0; chunkIndex < corpus.size(); ++chunkIndex) {
+        ChunkMeshingStats binaryStats{};
+        ChunkMeshingStats referenceStats{};
+        const ChunkLodMeshes binary =
+            odai::world::buildChunkLodMeshes(corpus[chunkIndex], MeshingOptions{MeshingMode::Greedy}, &binaryStats);
+        const ChunkLodMeshes reference = odai::world::buildChunkLodMeshes(
+            corpus[chunkIndex],
+            MeshingOptions{MeshingMode::GreedyReference},
+            &referenceStats
+        );
+        const odai::world::ChunkMeshData& binaryMesh = binary.lodMeshes[0];
+        const odai::world::ChunkMeshData& referenceMesh = reference.lodMeshes[0];
+        bool same = binaryStats.exposedFaceCount == referenceStats.exposedFaceCount &&
+                    binaryMesh.vertices.size() == referenceMesh.vertices.size() &&
+                    binaryMesh.indices == referenceMesh.indices;
+        for (std::size_t vertexIndex = 0; same && vertexIndex < binaryMesh.vertices.size(); ++vertexIndex) {
+            same = binaryMesh.vertices[vertexIndex].bits == referenceMesh.vertices[vertexIndex].bits;
+        }
+        if (!same) {
+            std::cerr << "[foundation test] binary mesher differs on corpus chunk " << chunkIndex << '\n';
+        }
+        identical = identical && same;
+        totalFaces += referenceStats.exposedFaceCount;
+    }
+    expectTrue(identical, "Binary greedy mesher matches the reference vertex and index streams");
+    expectTrue(totalFaces > 0u, "Mesher corpus has exposed faces");
+}
+
+// Chunk meshes are quad lists: no stored indices, four vertices per quad, and
+// the AO-driven diagonal carried by vertex order. Building into an existing
+// set reuses its buffers.
+void testQuadListChunkMeshes() {
+    using odai::world::Chunk;
+    using odai::world::ChunkLodMeshes;
+    using odai::world::ChunkMeshData;
+    using odai::world::MeshingMode;
+    using odai::world::MeshingOptions;
+
+    const Chunk procedural = odai::world::buildProceduralChunk(1, 0, -2);
+    bool allQuadLists = true;
+    bool diagonalsFollowAo = true;
+    for (const MeshingMode mode : {MeshingMode::Naive, MeshingMode::Greedy, MeshingMode::GreedyReference}) {
+        const ChunkMeshData mesh = odai::world::buildChunkMesh(procedural, MeshingOptions{mode});
+        allQuadLists = allQuadLists && mesh.isQuadList() && !mesh.vertices.empty() && (mesh.vertices.size() % 4u) == 0u &&
+                       mesh.indexCount() == (mesh.vertices.size() / 4u) * 6u;
+        if (mode == MeshingMode::Naive) {
+            continue;
+        }
+        // Greedy quads split along the diagonal whose corners are darker
+        // (lower AO sum), which the implicit pattern always puts on 0-2.
+        for (std::size_t quad = 0; quad + 3u < mesh.vertices.size(); quad += 4u) {
+            std::array<std::uint32_t, 4> ao{};
+            for (std::size_t corner = 0; corner < 4u; ++corner) {
+                ao[corner] = (mesh.vertices[quad + corner].bits >> odai::world::PackedVoxelVertex::kShiftAo) &
+                             odai::world::PackedVoxelVertex::kMask4;
+            }
+            diagonalsFollowAo = diagonalsFollowAo && (ao[0] + ao[2]) <= (ao[1] + ao[3]);
+        }
+    }
+    expectTrue(allQuadLists, "Every chunk mesher emits a quad list with an implicit index pattern");
+    expectTrue(diagonalsFollowAo, "Greedy quads keep the AO-chosen diagonal through vertex order");
+
+    ChunkMeshData quads;
+    quads.vertices.resize(8u);
+    std::vector<std::uint32_t> indices = {7u};
+    odai::world::appendMeshIndices(quads, 100u, indices);
+    const std::vector<std::uint32_t> expectedQuadIndices = {7u, 100u, 101u, 102u, 100u, 102u, 103u, 104u, 105u, 106u, 104u, 106u, 107u};
+    expectTrue(indices == expectedQuadIndices, "Quad-list indices expand the shared pattern at the base vertex");
+    ChunkMeshData triangles;
+    triangles.vertices.resize(3u);
+    triangles.indices = {2u, 1u, 0u};
+    indices.clear();
+    odai::world::appendMeshIndices(triangles, 10u, indices);
+    expectTrue(indices == std::vector<std::uint32_t>{12u, 11u, 10u}, "Explicit indices are rebased unchanged");
+
+    // Build a big mesh, then a small one into the same set: same storage, and
+    // the output matches a fresh build exactly.
+    ChunkLodMeshes reused;
+    odai::world::buildChunkLodMeshesInto(
+        odai::world::ChunkNeighborhood{&procedural, odai::world::ChunkBorderSlabs{}},
+        MeshingOptions{},
+        nullptr,
+        reused
+    );
+    const odai::world::PackedVoxelVertex* storage = reused.lodMeshes[0].vertices.data();
+    const std::size_t capacity = reused.lodMeshes[0].vertices.capacity();
+    Chunk single(0, 0, 0);
+    single.setVoxel(4, 5, 6, odai::world::Voxel{odai::world::VoxelType::Solid});
+    odai::world::buildChunkLodMeshesInto(
+        odai::world::ChunkNeighborhood{&single, odai::world::ChunkBorderSlabs{}},
+        MeshingOptions{},
+        nullptr,
+        reused
+    );
+    const ChunkLodMeshes fresh = odai::world::buildChunkLodMeshes(single);
+    bool sameAsFresh = reused.lodMeshes[0].vertices.size() == fresh.lodMeshes[0].vertices.size();
+    for (std::size_t i = 0; sameAsFresh && i < fresh.lodMeshes[0].vertices.size(); ++i) {
+        sameAsFresh = reused.lodMeshes[0].vertices[i].bits == fresh.lodMeshes[0].vertices[i].bits;
+    }
+    expectTrue(sameAsFresh, "Building into a used set matches a fresh build");
+    expectTrue(
+        reused.lodMeshes[0].vertices.data() == storage && reused.lodMeshes[0].vertices.capacity() == capacity,
+        "Building into a used set keeps its buffer"
+    );
+}
+
+// Neighbor-aware meshing: the binary mesher still matches the reference with
+// slabs present, faces against solid neighbors are culled, seam AO sees the
+// neighbor, and empty borders reproduce the single-chunk mesh. On a flat and
+// a procedural world, neighbors only ever remove vertices.
+void testNeighborAwareMeshing() {
+    using odai::world::Chunk;
+    using odai::world::ChunkBorderSlabs;
+    using odai::world::ChunkLodMeshes;
+    using odai::world::ChunkMeshingStats;
+    using odai::world::ChunkNeighborhood;
+    using odai::world::ChunkNeighborLookup;
+    using odai::world::MeshingMode;
+    using odai::world::MeshingOptions;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+
+    const auto sameMesh = [](const ChunkLodMeshes& lhs, const ChunkLodMeshes& rhs) {
+        const odai::world::ChunkMeshData& lhsMesh = lhs.lodMeshes[0];
+        const odai::world::ChunkMeshData& rhsMesh = rhs.lodMeshes[0];
+        if (lhsMesh.vertices.size() != rhsMesh.vertices.size() || lhsMesh.indices != rhsMesh.indices) {
+            return false;
+        }
+        for (std::size_t vertexIndex = 0; vertexIndex < lhsMesh.vertices.size(); ++vertexIndex) {
+            if (lhsMesh.vertices[vertexIndex].bits != rhsMesh.vertices[vertexIndex].bits) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const std::vector<Chunk> procedural = odai::tools::buildProceduralNeighborWorld();
+    const ChunkNeighborLookup proceduralLookup(procedural);
+
+    // Random slabs around random chunks exercise every ring/AO combination
+    // the terrain does not.
+    std::mt19937 rng(0xB0A7u);
+    std::vector<ChunkNeighborhood> randomNeighborhoods;
+    std::vector<Chunk> noiseChunks;
+    noiseChunks.reserve(4);
+    for (int noiseIndex = 0; noiseIndex < 4; ++noiseIndex) {
+        Chunk noise(noiseIndex, 0, 0);
+        noise.beginEdit();
+        for (int y = 0; y < Chunk::kSizeY; ++y) {
+            for (int z = 0; z < Chunk::kSizeZ; ++z) {
+                for (int x = 0; x < Chunk::kSizeX; ++x) {
+                    if ((rng() % 3u) == 0u) {
+                        noise.setVoxel(x, y, z, Voxel{static_cast<VoxelType>(1u + (rng() % 6u))});
+                    }
+                }
+            }
+        }
+        noise.endEdit();
+        noiseChunks.push_back(std::move(noise));
+    }
+    for (const Chunk& noise : noiseChunks) {
+        ChunkNeighborhood neighborhood{&noise, ChunkBorderSlabs{}};
+        for (std::uint32_t faceId = 0; faceId < odai::world::kChunkFaceCount; ++faceId) {
+            if ((rng() % 4u) == 0u) {
+                continue;
+            }
+            for (std::uint32_t& row : neighborhood.borders.rows[faceId]) {
+                row = static_cast<std::uint32_t>(rng()) & static_cast<std::uint32_t>(rng());
+            }
+            neighborhood.borders.presentMask =
+                static_cast<std::uint8_t>(neighborhood.borders.presentMask | (1u << faceId));
+        }
+        randomNeighborhoods.push_back(neighborhood);
+    }
+
+    bool identical = true;
+    bool facesAgree = true;
+    const auto checkNeighborhood = [&](const ChunkNeighborhood& neighborhood) {
+        ChunkMeshingStats binaryStats{};
+        ChunkMeshingStats referenceStats{};
+        ChunkMeshingStats naiveStats{};
+        const ChunkLodMeshes binary =
+            odai::world::buildChunkLodMeshes(neighborhood, MeshingOptions{MeshingMode::Greedy}, &binaryStats);
+        const ChunkLodMeshes reference =
+            odai::world::buildChunkLodMeshes(neighborhood, MeshingOptions{MeshingMode::GreedyReference}, &referenceStats);
+        (void)odai::world::buildChunkLodMeshes(neighborhood, MeshingOptions{MeshingMode::Naive}, &naiveStats);
+        identical = identical && sameMesh(binary, reference) &&
+                    binaryStats.exposedFaceCount == referenceStats.exposedFaceCount;
+        facesAgree = facesAgree && naiveStats.exposedFaceCount == referenceStats.exposedFaceCount;
+    };
+    for (const Chunk& chunk : procedural) {
+        checkNeighborhood(proceduralLookup.neighborhood(chunk));
+    }
+    for (const ChunkNeighborhood& neighborhood : randomNeighborhoods) {
+        checkNeighborhood(neighborhood);
+    }
+    expectTrue(identical, "Binary mesher matches the reference mesher with neighbor slabs");
+    expectTrue(facesAgree, "Naive and greedy meshers cull the same boundary faces");
+    expectTrue(
+        sameMesh(
+            odai::world::buildChunkLodMeshes(ChunkNeighborhood{&noiseChunks[0], ChunkBorderSlabs{}}, MeshingOptions{}, nullptr),
+            odai::world::buildChunkLodMeshes(noiseChunks[0])
+        ),
+        "Empty borders reproduce the single-chunk mesh"
+    );
+
+    // A full chunk inside full neighbors has nothing left to draw.
+    Chunk full(0, 0, 0);
+    for (int y = 0; y < Chunk::kSizeY; ++y) {
+        full.fillLayer(y, Voxel{VoxelType::Stone});
+    }
+    ChunkNeighborhood buried{&full, ChunkBorderSlabs{}};
+    for (std::uint32_t faceId = 0; faceId < odai::world::kChunkFaceCount; ++faceId) {
+        odai::world::captureChunkBorderSlab(full, faceId, buried.borders);
+    }
+    ChunkMeshingStats buriedStats{};
+    const ChunkLodMeshes buriedMesh = odai::world::buildChunkLodMeshes(buried, MeshingOptions{}, &buriedStats);
+    expectTrue(buriedStats.exposedFaceCount == 0u, "Faces against solid neighbor slabs are culled");
+    expectTrue(buriedMesh.lodMeshes[0].vertices.empty(), "A buried chunk emits no vertices");
+
+    // Seam AO: a floor at y == 0 next to a wall standing at x == 0 of the +X
+    // neighbor. The floor's last column must darken toward the wall.
+    Chunk floor(0, 0, 0);
+    floor.fillLayer(0, Voxel{VoxelType::Stone});
+    Chunk wall(1, 0, 0);
+    for (int z = 0; z < Chunk::kSizeZ; ++z) {
+        wall.setVoxel(0, 1, z, Voxel{VoxelType::Stone});
+    }
+    ChunkNeighborhood seam{&floor, ChunkBorderSlabs{}};
+    odai::world::captureChunkBorderSlab(wall, 0u, seam.borders);
+    const auto darkSeamVertexCount = [](const ChunkLodMeshes& meshes) {
+        std::size_t count = 0;
+        for (const odai::world::PackedVoxelVertex& vertex : meshes.lodMeshes[0].vertices) {
+            const std::uint32_t face = (vertex.bits >> odai::world::PackedVoxelVertex::kShiftFace) &
+                                       odai::world::PackedVoxelVertex::kMask3;
+            const std::uint32_t ao = (vertex.bits >> odai::world::PackedVoxelVertex::kShiftAo) &
+                                     odai::world::PackedVoxelVertex::kMask4;
+            if (face == 2u && ao < 15u) {
+                ++count;
+            }
+        }
+        return count;
+    };
+    expectTrue(darkSeamVertexCount(odai::world::buildChunkLodMeshes(floor)) == 0u, "An isolated floor is fully lit");
+    expectTrue(
+        darkSeamVertexCount(odai::world::buildChunkLodMeshes(seam, MeshingOptions{}, nullptr)) > 0u,
+        "Seam AO darkens the floor next to the neighbor's wall"
+    );
+
+    // Vertex reduction; `odai_voxel_bench neighbors` reports the numbers.
+    const std::vector<Chunk> flat = odai::tools::buildFlatNeighborWorld();
+    const auto expectFewerVertices = [&](const std::vector<Chunk>& chunks) {
+        const ChunkNeighborLookup lookup(chunks);
+        std::size_t isolatedVertices = 0;
+        std::size_t neighborVertices = 0;
+        bool neverMoreFaces = true;
+        for (const Chunk& chunk : chunks) {
+            ChunkMeshingStats isolatedStats{};
+            ChunkMeshingStats neighborStats{};
+            isolatedVertices +=
+                odai::world::buildChunkLodMeshes(chunk, MeshingOptions{}, &isolatedStats).lodMeshes[0].vertices.size();
+            neighborVertices += odai::world::buildChunkLodMeshes(lookup.neighborhood(chunk), MeshingOptions{}, &neighborStats)
+                                    .lodMeshes[0]
+                                    .vertices.size();
+            neverMoreFaces = neverMoreFaces && neighborStats.exposedFaceCount <= isolatedStats.exposedFaceCount;
+        }
+        expectTrue(neverMoreFaces, "Neighbor slabs never expose more faces than meshing alone");
+        expectTrue(neighborVertices < isolatedVertices, "Neighbor-aware meshing emits fewer vertices");
+    };
+    expectFewerVertices(flat);
+    expectFewerVertices(procedural);
+}
+
+// Uniform and Palette centers skip the dense copy: all-air meshes to nothing,
+// all-solid meshes only its boundary against the slabs, and Palette decodes
+// into scratch. Every mode must still match meshing the Dense expansion.
+void testMeshingNonDenseCenters() {
+    using odai::world::Chunk;
+    using odai::world::ChunkBorderSlabs;
+    using odai::world::ChunkLodMeshes;
+    using odai::world::ChunkMeshingStats;
+    using odai::world::ChunkNeighborhood;
+    using odai::world::MeshingMode;
+    using odai::world::MeshingOptions;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+
+    const auto sameMesh = [](const ChunkLodMeshes& lhs, const ChunkLodMeshes& rhs) {
+        for (std::size_t lod = 0; lod < lhs.lodMeshes.size(); ++lod) {
+            const odai::world::ChunkMeshData& lhsMesh = lhs.lodMeshes[lod];
+            const odai::world::ChunkMeshData& rhsMesh = rhs.lodMeshes[lod];
+            if (lhsMesh.vertices.size() != rhsMesh.vertices.size() || lhsMesh.indices != rhsMesh.indices) {
+                return false;
+            }
+            for (std::size_t vertexIndex = 0; vertexIndex < lhsMesh.vertices.size(); ++vertexIndex) {
+                if (lhsMesh.vertices[vertexIndex].bits != rhsMesh.vertices[vertexIndex].bits) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    std::vector<Chunk> centers;
+    centers.emplace_back(0, 0, 0);
+    centers.emplace_back(0, 0, 0);
+    centers.back().fill(Voxel{VoxelType::Stone});
+    centers.emplace_back(0, 0, 0);
+    centers.back().fill(Voxel{VoxelType::Dirt, 3u});
+    Chunk palette(0, 0, 0);
+    palette.fill(Voxel{VoxelType::Stone});
+    palette.beginEdit();
+    for (int i = 0; i < 64; ++i) {
+        palette.setVoxel((i * 7) % Chunk::kSizeX, (i * 13) % Chunk::kSizeY, (i * 29) % Chunk::kSizeZ, Voxel{});
+    }
+    palette.setVoxel(0, 31, 0, Voxel{VoxelType::Leaves, 7u});
+    palette.endEdit();
+    centers.push_back(std::move(palette));
+    expectTrue(
+        centers[0].storageMode() == Chunk::StorageMode::Uniform &&
+            centers[1].storageMode() == Chunk::StorageMode::Uniform &&
+            centers[3].storageMode() == Chunk::StorageMode::Palette,
+        "Non-dense meshing corpus covers Uniform and Palette centers"
+    );
+
+    std::vector<ChunkBorderSlabs> borderSets(3);
+    for (std::uint32_t faceId = 0; faceId < odai::world::kChunkFaceCount; ++faceId) {
+        borderSets[1].rows[faceId].fill(~0u);
+    }
+    borderSets[1].presentMask = 0x3Fu;
+    std::mt19937 rng(0x51ABu);
+    for (std::uint32_t faceId = 0; faceId < odai::world::kChunkFaceCount; ++faceId) {
+        if (faceId == 2u) {
+            continue;
+        }
+        for (std::uint32_t& row : borderSets[2].rows[faceId]) {
+            row = static_cast<std::uint32_t>(rng()) | static_cast<std::uint32_t>(rng());
+        }
+        borderSets[2].presentMask = static_cast<std::uint8_t>(borderSets[2].presentMask | (1u << faceId));
+    }
+
+    bool identical = true;
+    for (const Chunk& center : centers) {
+        Chunk dense = center;
+        dense.expandToDense();
+        for (const ChunkBorderSlabs& borders : borderSets) {
+            for (const MeshingMode mode : {MeshingMode::Greedy, MeshingMode::GreedyReference, MeshingMode::Naive}) {
+                ChunkMeshingStats storedStats{};
+                ChunkMeshingStats denseStats{};
+                const ChunkLodMeshes stored =
+                    odai::world::buildChunkLodMeshes(ChunkNeighborhood{&center, borders}, MeshingOptions{mode}, &storedStats);
+                const ChunkLodMeshes expanded =
+                    odai::world::buildChunkLodMeshes(ChunkNeighborhood{&dense, borders}, MeshingOptions{mode}, &denseStats);
+                identical = identical && sameMesh(stored, expanded) &&
+                            storedStats.exposedFaceCount == denseStats.exposedFaceCount;
+            }
+        }
+    }
+    expectTrue(identical, "Uniform and Palette centers mesh like their dense expansion in every mode");
+
+    ChunkMeshingStats enclosedStats{};
+    const ChunkLodMeshes enclosed = odai::world::buildChunkLodMeshes(
+        ChunkNeighborhood{&centers[1], borderSets[1]},
+        MeshingOptions{MeshingMode::Greedy},
+        &enclosedStats
+    );
+    expectTrue(
+        enclosedStats.exposedFaceCount == 0u && enclosed.lodMeshes[0].vertices.empty(),
+        "A solid chunk enclosed by solid neighbors meshes to nothing"
+    );
+    ChunkMeshingStats isolatedStats{};
+    (void)odai::world::buildChunkLodMeshes(centers[1], MeshingOptions{MeshingMode::Greedy}, &isolatedStats);
+    expectTrue(
+        isolatedStats.exposedFaceCount == static_cast<std::size_t>(6 * Chunk::kSizeX * Chunk::kSizeZ),
+        "A lone solid chunk exposes exactly its six boundary planes"
+    );
+}
+
+// Parallel world decode must load exactly what the serial decoder loads.
+// `odai_voxel_bench parallel` times both.
+void testParallelWorldDecodeMatchesSerial() {
+    const std::vector<odai::world::Chunk> chunks = odai::tools::buildDecodeCorpus();
+    odai::world::ChunkGrid source;
+    source.setChunks(chunks);
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "odai_foundation_parallel_decode.vxw";
+    expectTrue(source.saveToBinaryFile(path), "Decode test world saves");
+
+    odai::world::ChunkGrid serial;
+    expectTrue(serial.loadFromBinaryFile(path), "Serial decode loads the saved world");
+
+    odai::core::JobSystem jobs(std::max(2u, std::thread::hardware_concurrency()));
+    odai::world::ChunkGrid parallel;
+    expectTrue(parallel.loadFromBinaryFile(path, &jobs), "Parallel decode loads the saved world");
+
+    bool identical = serial.chunkCount() == parallel.chunkCount() && serial.chunkCount() == chunks.size();
+    for (std::size_t i = 0; identical && i < serial.chunkCount(); ++i) {
+        const odai::world::Chunk& a = serial.chunks()[i];
+        const odai::world::Chunk& b = parallel.chunks()[i];
+        identical = a.chunkX() == b.chunkX() && a.chunkY() == b.chunkY() && a.chunkZ() == b.chunkZ() &&
+                    chunksEqual(a, b) && chunksEqual(a, chunks[i]);
+    }
+    expectTrue(identical, "Parallel world decode is identical to serial decode");
+
+    std::error_code removeError;
+    std::filesystem::remove(path, removeError);
+}
+
+// Writes the legacy VXW1 v3 layout (raw type + base-color planes) directly, so
+// old saves keep loading after the writer moved to VXW4.
+bool writeLegacyV3WorldFile(const std::filesystem::path& path, const std::vector<odai::world::Chunk>& chunks) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    const char magic[4] = {'V', 'X', 'W', '1'};
+    const std::uint32_t version = 3u;
+    const std::uint32_t chunkCount = static_cast<std::uint32_t>(chunks.size());
+    out.write(magic, sizeof(magic));
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char*>(&chunkCount), sizeof(chunkCount));
+    std::vector<odai::world::Voxel> voxels;
+    std::vector<std::uint8_t> planes(odai::world::Chunk::kVoxelCount * 2u);
+    for (const odai::world::Chunk& chunk : chunks) {
+        const std::int32_t coords[3] = {chunk.chunkX(), chunk.chunkY(), chunk.chunkZ()};
+        out.write(reinterpret_cast<const char*>(coords), sizeof(coords));
+        chunk.copyDenseVoxels(voxels);
+        for (std::size_t i = 0; i < voxels.size(); ++i) {
+            planes[i] = static_cast<std::uint8_t>(voxels[i].type);
+            planes[odai::world::Chunk::kVoxelCount + i] = voxels[i].baseColorIndex;
+        }
+        out.write(reinterpret_cast<const char*>(planes.data()), static_cast<std::streamsize>(planes.size()));
+    }
+    return out.good();
+}
+
+void testIndexedWorldFileFormat() {
+    using odai::world::Chunk;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+
+    std::vector<Chunk> chunks;
+    for (int chunkZ = -2; chunkZ <= 2; ++chunkZ) {
+        for (int chunkX = -2; chunkX <= 2; ++chunkX) {
+            chunks.push_back(odai::world::buildProceduralChunk(chunkX, 0, chunkZ));
+        }
+    }
+    chunks.push_back(Chunk(0, 1, 0));
+    // Per-voxel colors defeat RLE and must fall back to the raw codec.
+    Chunk noisy(9, 0, 9);
+    noisy.beginEdit();
+    for (int i = 0; i < static_cast<int>(Chunk::kVoxelCount); ++i) {
+        noisy.setVoxel(i % Chunk::kSizeX, i / (Chunk::kSizeX * Chunk::kSizeZ), (i / Chunk::kSizeX) % Chunk::kSizeZ,
+            Voxel{VoxelType::Stone, static_cast<std::uint8_t>(i % 13)});
+    }
+    noisy.endEdit();
+    chunks.push_back(noisy);
+    chunks[3].setVoxel(7, 30, 7, Voxel{VoxelType::Wood, 9u});
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "odai_foundation_vxw4.vxw";
+    odai::world::ChunkGrid source;
+    source.setChunks(chunks);
+    expectTrue(source.saveToBinaryFile(path), "VXW4 world saves");
+    expectTrue(odai::world::isIndexedWorldFile(path), "Saved world uses the indexed VXW4 format");
+
+    odai::world::ChunkGrid loaded;
+    expectTrue(loaded.loadFromBinaryFile(path), "VXW4 world loads");
+    bool identical = loaded.chunkCount() == chunks.size();
+    for (std::size_t i = 0; identical && i < chunks.size(); ++i) {
+        const Chunk& a = loaded.chunks()[i];
+        identical = a.chunkX() == chunks[i].chunkX() && a.chunkY() == chunks[i].chunkY() &&
+                    a.chunkZ() == chunks[i].chunkZ() && chunksEqual(a, chunks[i]);
+    }
+    expectTrue(identical, "VXW4 round trip preserves every chunk and voxel");
+
+    odai::world::WorldFileReader reader;
+    expectTrue(reader.open(path), "VXW4 reader maps the saved world");
+    const odai::world::WorldFileChunkEntry* edited = reader.findChunk(chunks[3].chunkX(), 0, chunks[3].chunkZ());
+    Chunk pagedChunk;
+    expectTrue(
+        edited != nullptr && reader.readChunk(*edited, pagedChunk) && chunksEqual(pagedChunk, chunks[3]),
+        "VXW4 reader decodes a single chunk by key"
+    );
+    const odai::world::WorldFileChunkEntry* sky = reader.findChunk(0, 1, 0);
+    const odai::world::WorldFileChunkEntry* noisyEntry = reader.findChunk(9, 0, 9);
+    expectTrue(sky != nullptr && sky->codec == odai::world::ChunkCodec::Rle && sky->payloadSize == 4u,
+        "Uniform chunk encodes as a single RLE run");
+    expectTrue(noisyEntry != nullptr && noisyEntry->codec == odai::world::ChunkCodec::Raw,
+        "Incompressible chunk falls back to the raw codec");
+    expectTrue(reader.findChunk(40, 0, 40) == nullptr, "VXW4 reader reports missing chunks");
+    reader.close();
+
+    // Size regression: 25 terrain chunks were 64 KB each as VXW1 v3 planes.
+    std::error_code sizeError;
+    const std::uintmax_t fileBytes = std::filesystem::file_size(path, sizeError);
+    const std::uintmax_t legacyBytes = static_cast<std::uintmax_t>(chunks.size()) * Chunk::kVoxelCount * 2u;
+    expectTrue(!sizeError && fileBytes * 8u < legacyBytes, "VXW4 file is under 1/8 the size of VXW1 v3");
+
+    const std::filesystem::path legacyPath = std::filesystem::temp_directory_path() / "odai_foundation_vxw1.vxw";
+    expectTrue(writeLegacyV3WorldFile(legacyPath, chunks), "Legacy VXW1 v3 test world writes");
+    odai::world::ChunkGrid legacy;
+    expectTrue(legacy.loadFromBinaryFile(legacyPath), "Legacy VXW1 v3 world still loads");
+    bool legacyIdentical = legacy.chunkCount() == chunks.size();
+    for (std::size_t i = 0; legacyIdentical && i < chunks.size(); ++i) {
+        legacyIdentical = chunksEqual(legacy.chunks()[i], chunks[i]);
+    }
+    expectTrue(legacyIdentical, "Legacy VXW1 v3 world decodes identically");
+
+    // World keeps the file mapped and pages chunks in as the window reaches them.
+    odai::world::World saved;
+    saved.setStreamingConfig(odai::world::World::ChunkStreamingConfig{2, 2});
+    (void)saved.loadOrInitialize(legacyPath);
+    (void)saved.setVoxelAtWorld(3, 29, 3, Voxel{VoxelType::Leaves, 2u});
+    expectTrue(saved.save(path), "World saves to VXW4");
+
+    odai::world::World paged;
+    paged.setStreamingConfig(odai::world::World::ChunkStreamingConfig{1, 1});
+    expectTrue(paged.loadOrInitialize(path), "World opens a VXW4 file");
+    expectTrue(
+        paged.streamingStats().storedChunkCount == 9u && paged.streamingStats().pagedInChunkCount == 9u,
+        "World pages in only the resident window"
+    );
+    (void)paged.setVoxelAtWorld(4, 29, 4, Voxel{VoxelType::Wood});
+    expectTrue(paged.save(path), "World saves over its own mapped file");
+
+    odai::world::World reloaded;
+    reloaded.setStreamingConfig(odai::world::World::ChunkStreamingConfig{2, 2});
+    expectTrue(reloaded.loadOrInitialize(path), "World reopens the re-saved file");
+    const Chunk* origin = nullptr;
+    for (const Chunk& chunk : reloaded.chunkGrid().chunks()) {
+        if (chunk.chunkX() == 0 && chunk.chunkY() == 0 && chunk.chunkZ() == 0) {
+            origin = &chunk;
+        }
+    }
+    expectTrue(
+        reloaded.streamingStats().pagedInChunkCount == 25u && origin != nullptr &&
+            origin->voxelAt(3, 29, 3) == Voxel{VoxelType::Leaves, 2u} && origin->voxelAt(4, 29, 4).type == VoxelType::Wood,
+        "Re-saving keeps unpaged chunks and both edits"
+    );
+
+    std::filesystem::resize_file(path, 40u, sizeError);
+    odai::world::ChunkGrid truncated;
+    expectTrue(!truncated.loadFromBinaryFile(path), "Truncated VXW4 file is rejected");
+
+    std::error_code removeError;
+    std::filesystem::remove(path, removeError);
+    std::filesystem::remove(legacyPath, removeError);
+}
+
+void testBackgroundWorldSave() {
+    using odai::world::Chunk;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+    using odai::world::World;
+
+    const std::filesystem::path asyncPath = std::filesystem::temp_directory_path() / "odai_foundation_async.vxw";
+    const std::filesystem::path syncPath = std::filesystem::temp_directory_path() / "odai_foundation_sync.vxw";
+    const auto readBytes = [](const std::filesystem::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+    const auto pollUntilDone = [](World& world) {
+        World::SaveProgress progress = world.pollSave();
+        while (progress.state == World::SaveState::Writing) {
+            std::this_thread::yield();
+            progress = world.pollSave();
+        }
+        return progress;
+    };
+
+    odai::core::JobSystem jobs(2);
+    World reference;
+    reference.setStreamingConfig(World::ChunkStreamingConfig{2, 2});
+    reference.regenerateFlatWorld();
+    expectTrue(reference.save(syncPath), "Synchronous save writes the reference file");
+
+    World world;
+    world.setStreamingConfig(World::ChunkStreamingConfig{2, 2});
+    world.regenerateFlatWorld();
+    expectTrue(world.hasUnsavedChanges(), "Generated chunks start dirty");
+    expectTrue(world.beginSave(asyncPath, jobs), "Background save starts");
+    expectTrue(world.isSaveInFlight() && !world.beginSave(asyncPath, jobs), "Only one background save runs at a time");
+    // Lands after the snapshot, so it must not be in this save and must stay dirty.
+    (void)world.setVoxelAtWorld(5, 29, 5, Voxel{VoxelType::Wood});
+    const World::SaveProgress committed = pollUntilDone(world);
+    expectTrue(committed.state == World::SaveState::Committed, "Background save commits");
+    expectTrue(
+        committed.dirtyChunkCount == 25u && committed.chunkCount == 25u && committed.chunksWritten == committed.chunkCount,
+        "Background save progress reaches its chunk count"
+    );
+    expectTrue(world.pollSave().state == World::SaveState::Idle, "Save outcome is reported once");
+    expectTrue(readBytes(asyncPath) == readBytes(syncPath), "Background save writes the same file as a blocking save");
+    expectTrue(world.hasUnsavedChanges(), "Edit made during a background save stays dirty");
+
+    // Incremental: only the edited chunk is encoded, the rest are copied.
+    expectTrue(world.beginSave(asyncPath, jobs), "Second background save starts");
+    const World::SaveProgress incremental = pollUntilDone(world);
+    expectTrue(
+        incremental.state == World::SaveState::Committed && incremental.dirtyChunkCount == 1u &&
+            incremental.chunkCount == 25u,
+        "Incremental save encodes only the dirty chunk"
+    );
+    expectTrue(!world.hasUnsavedChanges(), "Committed save clears the dirty set");
+    expectTrue(world.waitForSave(), "Waiting with no save in flight succeeds");
+
+    World reloaded;
+    reloaded.setStreamingConfig(World::ChunkStreamingConfig{2, 2});
+    expectTrue(reloaded.loadOrInitialize(asyncPath), "Background-saved world reopens");
+    const Chunk* origin = nullptr;
+    for (const Chunk& chunk : reloaded.chunkGrid().chunks()) {
+        if (chunk.chunkX() == 0 && chunk.chunkY() == 0 && chunk.chunkZ() == 0) {
+            origin = &chunk;
+        }
+    }
+    expectTrue(
+        reloaded.streamingStats().pagedInChunkCount == 25u && !reloaded.hasUnsavedChanges() && origin != nullptr &&
+            origin->voxelAt(5, 29, 5).type == VoxelType::Wood,
+        "Incremental save keeps every chunk and the late edit"
+    );
+
+    // A destructor mid-save waits for the worker instead of tearing down under it.
+    {
+        World abandoned;
+        abandoned.setStreamingConfig(World::ChunkStreamingConfig{1, 1});
+        abandoned.regenerateFlatWorld();
+        expectTrue(abandoned.beginSave(syncPath, jobs), "Background save starts before teardown");
+    }
+    World afterTeardown;
+    afterTeardown.setStreamingConfig(World::ChunkStreamingConfig{1, 1});
+    expectTrue(
+        afterTeardown.loadOrInitialize(syncPath) && afterTeardown.streamingStats().pagedInChunkCount == 9u,
+        "Save in flight at destruction is still committed"
+    );
+
+    std::error_code removeError;
+    std::filesystem::remove(asyncPath, removeError);
+    std::filesystem::remove(syncPath, removeError);
+}
+
+void testResidentChunkStorage() {
+    using odai::world::Chunk;
+    using odai::world::ChunkHandle;
+    using odai::world::ChunkStorage;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+    using odai::world::World;
+
+    ChunkStorage storage;
+    Chunk marked(3, 0, 4);
+    marked.setVoxel(1, 2, 3, Voxel{VoxelType::Wood});
+    const ChunkHandle first = storage.insert(std::move(marked), 7u);
+    const ChunkHandle second = storage.insert(Chunk(5, 0, 6), 0u);
+    const std::size_t residentIndex = storage.makeResident(first);
+    (void)storage.makeResident(second);
+    expectTrue(
+        residentIndex == 0u && storage.residentGrid().chunkCount() == 2u && storage.residentHandle(0) == first &&
+            storage.find(first) == &storage.residentGrid().chunks()[0],
+        "Resident chunk is found through its handle in the resident grid"
+    );
+    storage.makeNonResident(first);
+    expectTrue(
+        storage.residentGrid().chunkCount() == 1u && storage.residentHandle(0) == second &&
+            storage.find(first) != nullptr && storage.find(first)->voxelAt(1, 2, 3).type == VoxelType::Wood &&
+            storage.editGeneration(first) == 7u,
+        "Leaving the resident grid keeps the chunk, its contents and its edit generation"
+    );
+    expectTrue(storage.erase(second) && storage.residentGrid().chunkCount() == 0u, "Erase drops a resident chunk");
+    const ChunkHandle reused = storage.insert(Chunk(8, 0, 8), 0u);
+    expectTrue(
+        reused.slot == second.slot && !storage.contains(second) && storage.find(second) == nullptr &&
+            storage.find(reused)->chunkX() == 8,
+        "A reused slot does not resolve stale handles"
+    );
+
+    World world;
+    world.setStreamingConfig(World::ChunkStreamingConfig{2, 2});
+    world.regenerateFlatWorld();
+    expectTrue(world.setVoxelAtWorld(5, 29, 5, Voxel{VoxelType::Wood}), "Resident edit lands");
+    const auto residentVoxelAt = [&](int worldX, int worldY, int worldZ) {
+        for (const Chunk& chunk : world.chunkGrid().chunks()) {
+            if (chunk.chunkX() == (worldX >> 5) && chunk.chunkY() == (worldY >> 5) && chunk.chunkZ() == (worldZ >> 5)) {
+                return chunk.voxelAt(worldX & 31, worldY & 31, worldZ & 31).type;
+            }
+        }
+        return VoxelType::Empty;
+    };
+    expectTrue(residentVoxelAt(5, 29, 5) == VoxelType::Wood, "Resident edit is visible without a streaming update");
+
+    // One chunk east: exactly one column enters and one leaves.
+    const World::ChunkStreamingUpdate shifted = world.updateStreamingWindowForWorldPosition(48.0f, 16.0f);
+    bool uploadsAreEntered = shifted.residentChunkIndicesNeedingUpload.size() == 5u;
+    for (const std::size_t chunkIndex : shifted.residentChunkIndicesNeedingUpload) {
+        const Chunk& chunk = world.chunkGrid().chunks()[chunkIndex];
+        uploadsAreEntered = uploadsAreEntered && chunk.chunkX() == 3;
+    }
+    expectTrue(
+        shifted.enteredChunkKeys.size() == 5u && shifted.exitedChunkKeys.size() == 5u &&
+            shifted.stats.residentChunkCount == 25u && uploadsAreEntered,
+        "Window shift moves only the entering and leaving chunks"
+    );
+
+    // Edit a chunk while it is out of the window; it comes back with the edit.
+    expectTrue(world.setVoxelAtWorld(-60, 29, 5, Voxel{VoxelType::Leaves}), "Non-resident stored chunk takes the edit");
+    expectTrue(residentVoxelAt(-60, 29, 5) == VoxelType::Empty, "Non-resident chunk is not in the resident grid");
+    (void)world.updateStreamingWindowForWorldPosition(16.0f, 16.0f);
+    expectTrue(
+        residentVoxelAt(-60, 29, 5) == VoxelType::Leaves && residentVoxelAt(5, 29, 5) == VoxelType::Wood,
+        "Chunks re-enter the window with every edit"
+    );
+
+    // Back-and-forth shifts of a larger window move one column each way and
+    // nothing else.
+    World streaming;
+    streaming.setStreamingConfig(World::ChunkStreamingConfig{8, 8});
+    streaming.regenerateFlatWorld();
+    (void)streaming.updateStreamingWindowForWorldPosition(48.0f, 16.0f);
+    (void)streaming.updateStreamingWindowForWorldPosition(16.0f, 16.0f);
+    constexpr int kShifts = 20;
+    std::uint32_t movedChunks = 0;
+    for (int shift = 0; shift < kShifts; ++shift) {
+        const float worldX = ((shift % 2) == 0) ? 48.0f : 16.0f;
+        const World::ChunkStreamingUpdate update = streaming.updateStreamingWindowForWorldPosition(worldX, 16.0f);
+        movedChunks += update.stats.enteredChunkCount + update.stats.exitedChunkCount;
+    }
+    expectTrue(movedChunks == static_cast<std::uint32_t>(kShifts) * 34u, "Every shift moves one column each way");
+}
+
+void testChunkStorageEviction() {
+    using odai::world::Chunk;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+    using odai::world::World;
+
+    const std::filesystem::path savePath = std::filesystem::temp_directory_path() / "odai_foundation_evict.vxw";
+    const auto residentVoxelAt = [](const World& world, int worldX, int worldY, int worldZ) {
+        for (const Chunk& chunk : world.chunkGrid().chunks()) {
+            if (chunk.chunkX() == (worldX >> 5) && chunk.chunkY() == (worldY >> 5) && chunk.chunkZ() == (worldZ >> 5)) {
+                return chunk.voxelAt(worldX & 31, worldY & 31, worldZ & 31).type;
+            }
+        }
+        return VoxelType::Empty;
+    };
+
+    constexpr std::uint64_t kBudgetBytes = 512u * 1024u;
+    constexpr int kSteps = 96;
+    constexpr int kEditEvery = 6;
+    World world;
+    world.setStreamingConfig(World::ChunkStreamingConfig{1, 1, 0, kBudgetBytes});
+    world.regenerateFlatWorld();
+
+    // Long walk east, editing now and then: storage must stop growing.
+    std::uint32_t evicted = 0;
+    std::uint32_t spilled = 0;
+    std::uint32_t storedAtWarmup = 0;
+    std::uint32_t maxStored = 0;
+    bool withinBudget = true;
+    int editCount = 0;
+    for (int step = 1; step <= kSteps; ++step) {
+        const World::ChunkStreamingUpdate update =
+            world.updateStreamingWindowForWorldPosition(static_cast<float>(step * Chunk::kSizeX) + 16.0f, 16.0f);
+        evicted += update.stats.evictedChunkCount;
+        spilled += update.stats.spilledChunkCount;
+        withinBudget = withinBudget &&
+                       (update.stats.storedChunkBytes - update.stats.residentChunkBytes) <= kBudgetBytes;
+        if (step == kSteps / 4) {
+            storedAtWarmup = update.stats.storedChunkCount;
+        }
+        if (step > kSteps / 4) {
+            maxStored = std::max(maxStored, update.stats.storedChunkCount);
+        }
+        if ((step % kEditEvery) == 0) {
+            (void)world.setVoxelAtWorld((step * Chunk::kSizeX) + 5, 29, 5, Voxel{VoxelType::Wood});
+            ++editCount;
+        }
+    }
+    expectTrue(withinBudget, "Non-resident chunks stay within the memory budget on a long walk");
+    // Edited chunks are larger, so the count wobbles a little under a byte budget.
+    expectTrue(
+        storedAtWarmup > 9u && maxStored <= storedAtWarmup + (storedAtWarmup / 4u),
+        "Stored chunk count stays flat on a long walk"
+    );
+    expectTrue(evicted > static_cast<std::uint32_t>(kSteps), "Long walk evicts chunks");
+    expectTrue(
+        spilled > 0u && spilled < static_cast<std::uint32_t>(editCount) + 1u,
+        "Only edited chunks spill; untouched procedural chunks are dropped"
+    );
+    expectTrue(world.streamingStats().spillFileChunkCount > 0u, "Spill file holds the evicted edits");
+
+    // Walk back: every spilled edit reloads with the chunk.
+    std::uint32_t reloaded = 0;
+    bool editsSurvive = true;
+    for (int step = kSteps; step >= 0; --step) {
+        const World::ChunkStreamingUpdate update =
+            world.updateStreamingWindowForWorldPosition(static_cast<float>(step * Chunk::kSizeX) + 16.0f, 16.0f);
+        reloaded += update.stats.reloadedChunkCount;
+        if (step > 0 && (step % kEditEvery) == 0) {
+            editsSurvive = editsSurvive && residentVoxelAt(world, (step * Chunk::kSizeX) + 5, 29, 5) == VoxelType::Wood;
+        }
+    }
+    expectTrue(editsSurvive && reloaded > 0u, "Edited chunks reload from the spill file with their edits");
+
+    // Walk away again so edits are spilled, then save: the file must have them.
+    for (int step = 1; step <= kSteps / 2; ++step) {
+        (void)world.updateStreamingWindowForWorldPosition(static_cast<float>(step * Chunk::kSizeX) + 16.0f, 16.0f);
+    }
+    expectTrue(world.hasUnsavedChanges(), "Spilled edits count as unsaved");
+    expectTrue(world.save(savePath), "World with spilled chunks saves");
+    expectTrue(!world.hasUnsavedChanges(), "Save writes spilled chunks and drops them from the spill file");
+    World reloadedWorld;
+    reloadedWorld.setStreamingConfig(World::ChunkStreamingConfig{1, 1, 0, kBudgetBytes});
+    expectTrue(reloadedWorld.loadOrInitialize(savePath), "Saved world reopens");
+    (void)reloadedWorld.updateStreamingWindowForWorldPosition(static_cast<float>(kEditEvery * Chunk::kSizeX) + 16.0f, 16.0f);
+    expectTrue(
+        residentVoxelAt(reloadedWorld, (kEditEvery * Chunk::kSizeX) + 5, 29, 5) == VoxelType::Wood,
+        "A spilled edit reaches the saved file"
+    );
+
+    std::error_code removeError;
+    std::filesystem::remove(savePath, removeError);
+}
+
+// Dead payloads from taken and superseded chunks are reclaimed while other
+// chunks are still spilled, and the file is gone after close().
+void testChunkSpillFileCompaction() {
+    using odai::world::Chunk;
+    using odai::world::ChunkSpillFile;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+
+    // Noise defeats RLE, so every payload is raw and the byte counts are exact.
+    std::mt19937 rng(7u);
+    const auto noisyChunk = [&rng](int chunkX) {
+        Chunk chunk(chunkX, 0, 0);
+        chunk.beginEdit();
+        for (int y = 0; y < Chunk::kSizeY; ++y) {
+            for (int z = 0; z < Chunk::kSizeZ; ++z) {
+                for (int x = 0; x < Chunk::kSizeX; ++x) {
+                    chunk.setVoxel(x, y, z, Voxel{static_cast<VoxelType>(rng() % 4u), static_cast<std::uint8_t>(rng())});
+                }
+            }
+        }
+        chunk.endEdit();
+        return chunk;
+    };
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "odai_foundation_spill.bin";
+    ChunkSpillFile spill;
+    expectTrue(spill.open(path), "Spill file opens");
+    constexpr int kChunks = 48;
+    std::vector<Chunk> written;
+    for (int i = 0; i < kChunks; ++i) {
+        written.push_back(noisyChunk(i));
+        expectTrue(spill.write(written.back(), 1u), "Spill file takes a chunk");
+    }
+    const std::uint64_t fullBytes = spill.fileBytes();
+    expectTrue(spill.liveBytes() == fullBytes, "Fresh spill file has no dead bytes");
+
+    // Taking most chunks back crosses the dead-space threshold while some remain.
+    Chunk taken;
+    std::uint64_t takenGeneration = 0;
+    for (int i = 0; i < kChunks; i += 4) {
+        for (int j = i; j < i + 3; ++j) {
+            expectTrue(spill.take(j, 0, 0, taken, takenGeneration), "Spilled chunk is taken back");
+        }
+    }
+    expectTrue(spill.chunkCount() == kChunks / 4, "Taken chunks leave the index");
+    expectTrue(
+        spill.fileBytes() < fullBytes && spill.fileBytes() - spill.liveBytes() < ChunkSpillFile::kCompactMinDeadBytes,
+        "Dead payloads are compacted away while chunks remain spilled"
+    );
+    expectTrue(
+        std::filesystem::file_size(path) == spill.fileBytes(),
+        "Compaction cuts the file to its live payloads"
+    );
+
+    // Superseding writes leave dead copies that compaction also reclaims.
+    for (int round = 0; round < 8; ++round) {
+        for (int i = 3; i < kChunks; i += 4) {
+            expectTrue(spill.write(written[static_cast<std::size_t>(i)], 2u), "Spilled chunk is rewritten");
+        }
+    }
+    expectTrue(
+        spill.fileBytes() - spill.liveBytes() < ChunkSpillFile::kCompactMinDeadBytes ||
+            (spill.fileBytes() - spill.liveBytes()) * 2u < spill.fileBytes(),
+        "Superseded payloads do not accumulate"
+    );
+    bool survivorsMatch = true;
+    for (int i = 3; i < kChunks; i += 4) {
+        survivorsMatch = survivorsMatch && spill.take(i, 0, 0, taken, takenGeneration) && takenGeneration == 2u &&
+                         chunksEqual(taken, written[static_cast<std::size_t>(i)]);
+    }
+    expectTrue(survivorsMatch, "Chunks moved by compaction read back intact");
+    expectTrue(spill.fileBytes() == 0u, "Empty spill file truncates to zero");
+
+    expectTrue(spill.write(written.front(), 3u), "Spill file takes a chunk after truncation");
+    spill.close();
+    expectTrue(!std::filesystem::exists(path), "Closing the spill file removes it");
+}
+
+void testVerticalChunkStreaming() {
+    using odai::world::Chunk;
+    using odai::world::ProceduralChunkContent;
+    using odai::world::VoxelType;
+    using odai::world::World;
+
+    expectTrue(
+        odai::world::classifyProceduralChunk(-1) == ProceduralChunkContent::Solid &&
+            odai::world::classifyProceduralChunk(0) == ProceduralChunkContent::Terrain &&
+            odai::world::classifyProceduralChunk(4) == ProceduralChunkContent::Air,
+        "Layers below the surface band are solid and layers above it are air"
+    );
+    expectTrue(
+        odai::world::classifyProceduralChunk(0, 40, 60) == ProceduralChunkContent::Solid &&
+            odai::world::classifyProceduralChunk(1, 20, 30) == ProceduralChunkContent::Terrain &&
+            odai::world::classifyProceduralChunk(2, 5, 30) == ProceduralChunkContent::Air,
+        "Chunks under or over every covered column's surface are solid or air"
+    );
+    const Chunk underground = odai::world::buildProceduralChunk(3, -2, -1);
+    const Chunk sky = odai::world::buildProceduralChunk(3, 4, -1);
+    // Inside the band terrain can reach, but above this column's surface.
+    const Chunk lowSky = odai::world::buildProceduralChunk(3, 2, -1);
+    expectTrue(
+        underground.storageMode() == Chunk::StorageMode::Uniform &&
+            underground.voxelAt(7, 0, 7).type == VoxelType::Stone &&
+            underground.voxelAt(7, Chunk::kSizeY - 1, 7).type == VoxelType::Stone &&
+            sky.storageMode() == Chunk::StorageMode::Uniform && sky.voxelAt(7, 7, 7).type == VoxelType::Empty &&
+            lowSky.storageMode() == Chunk::StorageMode::Uniform && lowSky.voxelAt(7, 7, 7).type == VoxelType::Empty,
+        "Underground and sky chunks are uniform stone and air"
+    );
+    expectTrue(
+        underground.memoryFootprintBytes() < 2048u && sky.memoryFootprintBytes() < 2048u &&
+            lowSky.memoryFootprintBytes() < 2048u,
+        "Uniform vertical chunks do not allocate voxels"
+    );
+
+    // Whatever the surface layer generates above its top voxel lives in the
+    // layer above, so a 3D window sees trees whole.
+    bool layerAboveOnlyHoldsCanopy = true;
+    for (int chunkX = -1; chunkX <= 1; ++chunkX) {
+        const Chunk above = odai::world::buildProceduralChunk(chunkX, 1, 0);
+        for (int y = 2; y < Chunk::kSizeY; ++y) {
+            for (int z = 0; z < Chunk::kSizeZ; ++z) {
+                for (int x = 0; x < Chunk::kSizeX; ++x) {
+                    layerAboveOnlyHoldsCanopy = layerAboveOnlyHoldsCanopy && above.voxelAt(x, y, z).type == VoxelType::Empty;
+                }
+            }
+        }
+    }
+    expectTrue(layerAboveOnlyHoldsCanopy, "The layer above the surface holds at most tree tops");
+
+    World world;
+    world.setStreamingConfig(World::ChunkStreamingConfig{1, 1, 1});
+    const World::ChunkStreamingUpdate initial = world.updateStreamingWindowForWorldPosition(16.0f, 16.0f, 16.0f);
+    bool columnFirst = initial.enteredChunkKeys.size() == 27u;
+    for (std::size_t keyIndex = 0; columnFirst && keyIndex < 3u; ++keyIndex) {
+        const World::ChunkKey& key = initial.enteredChunkKeys[keyIndex];
+        columnFirst = key.chunkX == 0 && key.chunkZ == 0 && key.chunkY == std::array<int, 3>{0, -1, 1}[keyIndex];
+    }
+    expectTrue(
+        initial.stats.residentChunkCount == 27u && columnFirst,
+        "A vertical window enters the camera column first, then the rings around it"
+    );
+
+    // Past the hysteresis band below layer 0, exactly one layer changes.
+    const World::ChunkStreamingUpdate descended = world.updateStreamingWindowForWorldPosition(16.0f, -30.0f, 16.0f);
+    bool exitedTopLayer = descended.exitedChunkKeys.size() == 9u;
+    for (const World::ChunkKey& key : descended.exitedChunkKeys) {
+        exitedTopLayer = exitedTopLayer && key.chunkY == 1;
+    }
+    expectTrue(
+        descended.stats.centerChunkY == -1 && descended.enteredChunkKeys.size() == 9u && exitedTopLayer &&
+            world.chunkGrid().chunkCount() == 27u,
+        "Moving down a layer swaps one layer of chunks"
+    );
+
+    World surface;
+    surface.setStreamingConfig(World::ChunkStreamingConfig{1, 1});
+    const World::ChunkStreamingUpdate high = surface.updateStreamingWindowForWorldPosition(16.0f, 500.0f, 16.0f);
+    expectTrue(
+        high.stats.centerChunkY == 0 && high.stats.residentChunkCount == 9u,
+        "Without a vertical radius the window stays on the surface layer"
+    );
+
+    const World::ChunkStreamingConfig deepConfig{2, 2, 1};
+    const std::vector<World::ChunkKey> desired =
+        odai::games::voxelcraft::computeDesiredChunkKeys(deepConfig, 16.0f, 16.0f, 16.0f);
+    const int desiredSide = ((2 + odai::games::voxelcraft::kChunkPrefetchMarginChunks) * 2) + 1;
+    const int desiredLayers = ((1 + odai::games::voxelcraft::kChunkPrefetchMarginChunks) * 2) + 1;
+    expectTrue(
+        desired.size() == static_cast<std::size_t>(desiredSide * desiredSide * desiredLayers) &&
+            desired.front() == World::ChunkKey{0, 0, 0},
+        "computeDesiredChunkKeys covers the vertical window plus margin, camera chunk first"
+    );
+
+    World deep;
+    deep.setStreamingConfig(World::ChunkStreamingConfig{2, 2, 2});
+    const World::ChunkStreamingUpdate deepUpdate = deep.updateStreamingWindowForWorldPosition(16.0f, 16.0f, 16.0f);
+    const std::uint64_t denseBytes =
+        static_cast<std::uint64_t>(deepUpdate.stats.residentChunkCount) * Chunk::kVoxelCount * sizeof(odai::world::Voxel);
+    expectTrue(deepUpdate.stats.residentChunkCount == 125u, "Radius 2 in every axis keeps 125 chunks resident");
+    expectTrue(
+        deepUpdate.stats.residentChunkBytes * 2u < denseBytes,
+        "Most of a deep window is uniform and far below dense storage"
+    );
+}
+
 void testClipmapIndex() {
     odai::world::ChunkGrid grid;
     grid.initializeEmptyWorld();
@@ -452,10 +1796,90 @@ void testClipmapIndex() {
     clipmapIndex.updateCamera(0.2f, 0.2f, 0.2f, &stableUpdateStats);
     expectTrue(stableUpdateStats.clipmapUpdatedLevelCount == 0u, "Clipmap stays stable within same snapped cell");
 
-    odai::world::SpatialQueryStats movedUpdateStats{};
-    clipmapIndex.updateCamera(33.0f, 0.0f, 0.0f, &movedUpdateStats);
-    expectTrue(movedUpdateStats.clipmapUpdatedLevelCount > 0u, "Clipmap updates when camera crosses snapped boundary");
-    expectTrue(movedUpdateStats.clipmapUpdatedBrickCount > 0u, "Clipmap updates bricks when crossing snapped boundary");
+    odai::world::SpatialQueryStats movedUpdateStats{};
+    clipmapIndex.updateCamera(33.0f, 0.0f, 0.0f, &movedUpdateStats);
+    expectTrue(movedUpdateStats.clipmapUpdatedLevelCount > 0u, "Clipmap updates when camera crosses snapped boundary");
+    expectTrue(movedUpdateStats.clipmapUpdatedBrickCount > 0u, "Clipmap updates bricks when crossing snapped boundary");
+    expectTrue(
+        movedUpdateStats.clipmapUpdatedBrickCount < movedUpdateStats.clipmapResidentBrickCount / 4u,
+        "Clipmap scroll rewrites only the brick slabs that entered"
+    );
+
+    // Small bounds look up the chunk cells they cover; the result matches the full scan.
+    odai::core::CellAabb nearBounds{};
+    nearBounds.valid = true;
+    nearBounds.minInclusive = odai::core::Cell3i{-40, 0, -8};
+    nearBounds.maxExclusive = odai::core::Cell3i{24, 16, 40};
+    std::vector<std::size_t> nearChunks;
+    odai::world::SpatialQueryStats nearStats{};
+    clipmapIndex.queryChunksIntersecting(nearBounds, nearChunks, &nearStats);
+    std::vector<std::size_t> expectedNearChunks;
+    for (std::size_t chunkIndex = 0; chunkIndex < grid.chunks().size(); ++chunkIndex) {
+        const odai::world::Chunk& chunk = grid.chunks()[chunkIndex];
+        const int minX = chunk.chunkX() * odai::world::Chunk::kSizeX;
+        const int minZ = chunk.chunkZ() * odai::world::Chunk::kSizeZ;
+        if (chunk.chunkY() == 0 && minX < 24 && minX + odai::world::Chunk::kSizeX > -40 && minZ < 40 &&
+            minZ + odai::world::Chunk::kSizeZ > -8) {
+            expectedNearChunks.push_back(chunkIndex);
+        }
+    }
+    expectTrue(nearChunks == expectedNearChunks, "Clipmap cell lookup finds exactly the intersecting chunks");
+    expectTrue(
+        nearStats.candidateChunkCount == nearChunks.size() && nearStats.candidateChunkCount < grid.chunkCount(),
+        "Clipmap cell lookup tests only the covered chunks"
+    );
+    const std::size_t* nearData = nearChunks.data();
+    clipmapIndex.queryChunksIntersecting(nearBounds, nearChunks);
+    expectTrue(nearChunks.data() == nearData && nearChunks == expectedNearChunks, "Clipmap query reuses the caller's buffer");
+}
+
+// Incremental resident sync after streaming updates agrees with a full rebuild.
+void testClipmapIndexIncrementalSync() {
+    using odai::world::ChunkClipmapIndex;
+    using odai::world::World;
+
+    World world;
+    world.setStreamingConfig(World::ChunkStreamingConfig{2, 2, 1, 64ull * 1024ull * 1024ull});
+    world.regenerateFlatWorld();
+    ChunkClipmapIndex incremental;
+    incremental.rebuild(world.chunkGrid());
+
+    const std::array<std::array<float, 3>, 6> cameraPath = {{
+        {48.0f, 20.0f, 0.0f}, {96.0f, 20.0f, 48.0f}, {96.0f, 60.0f, 48.0f},
+        {-40.0f, 20.0f, -40.0f}, {400.0f, 20.0f, 0.0f}, {400.0f, 20.0f, 0.0f}
+    }};
+    bool matches = true;
+    bool partial = true;
+    for (const std::array<float, 3>& camera : cameraPath) {
+        const World::ChunkStreamingUpdate update =
+            world.updateStreamingWindowForWorldPosition(camera[0], camera[1], camera[2]);
+        incremental.syncResidentChunks(world.chunkGrid(), update);
+        ChunkClipmapIndex rebuilt;
+        rebuilt.rebuild(world.chunkGrid());
+        incremental.updateCamera(camera[0], camera[1], camera[2]);
+        rebuilt.updateCamera(camera[0], camera[1], camera[2]);
+
+        // Each entered chunk, plus at most one chunk moved into a leaving chunk's slot.
+        partial = partial && incremental.lastSyncedChunkCount() <= 2u * update.enteredChunkKeys.size();
+        matches = matches && incremental.valid() && incremental.chunkCount() == rebuilt.chunkCount() &&
+                  incremental.worldBounds().minInclusive == rebuilt.worldBounds().minInclusive &&
+                  incremental.worldBounds().maxExclusive == rebuilt.worldBounds().maxExclusive;
+        const odai::core::Cell3i cameraCell{
+            static_cast<std::int32_t>(camera[0]),
+            static_cast<std::int32_t>(camera[1]),
+            static_cast<std::int32_t>(camera[2])
+        };
+        for (const std::int32_t halfExtent : {20, 70, 4000}) {
+            odai::core::CellAabb bounds{};
+            bounds.valid = true;
+            bounds.minInclusive = cameraCell - odai::core::Cell3i{halfExtent, halfExtent, halfExtent};
+            bounds.maxExclusive = cameraCell + odai::core::Cell3i{halfExtent, halfExtent, halfExtent};
+            matches = matches &&
+                      incremental.queryChunksIntersecting(bounds) == rebuilt.queryChunksIntersecting(bounds);
+        }
+    }
+    expectTrue(matches, "Incremental clipmap sync matches a full rebuild after each streaming update");
+    expectTrue(partial, "Incremental clipmap sync reads only the chunks a window shift entered or moved");
 }
 
 void testSimulationBeltCargoDeterminism() {
@@ -491,6 +1915,624 @@ void testSimulationBeltCargoDeterminism() {
     }
 }
 
+// Per-item belt cargo stepping as it was before belts were grouped into
+// segments; the segment model must reproduce it tick for tick.
+class ReferenceBeltCargoSim {
+public:
+    explicit ReferenceBeltCargoSim(const std::vector<odai::sim::Belt>& belts) {
+        m_beltCount = belts.size();
+        m_cells.resize(belts.size());
+        m_axes.resize(belts.size());
+        m_next.assign(belts.size(), -1);
+        std::vector<std::uint32_t> incoming(belts.size(), 0u);
+        std::unordered_map<std::uint64_t, std::size_t> cellToIndex;
+        for (std::size_t i = 0; i < belts.size(); ++i) {
+            m_cells[i] = odai::core::Cell3i{belts[i].x, belts[i].y, belts[i].z};
+            m_axes[i] = beltAxis(belts[i].direction);
+            cellToIndex[odai::core::packCell21(m_cells[i])] = i;
+        }
+        for (std::size_t i = 0; i < belts.size(); ++i) {
+            const auto found = cellToIndex.find(odai::core::packCell21(m_cells[i] + m_axes[i]));
+            if (found != cellToIndex.end()) {
+                m_next[i] = static_cast<std::int32_t>(found->second);
+                ++incoming[found->second];
+            }
+        }
+        for (std::size_t i = 0; i < belts.size(); ++i) {
+            if (incoming[i] == 0u) {
+                m_entries.push_back(static_cast<std::int32_t>(i));
+            }
+        }
+        if (m_entries.empty()) {
+            m_entries.push_back(0);
+        }
+        for (std::size_t i = 0; i < std::min<std::size_t>(m_entries.size(), 24u); ++i) {
+            insert(static_cast<std::size_t>(m_entries[i]), 0u, static_cast<std::uint16_t>(m_nextId % 5u));
+        }
+    }
+
+    void insert(std::size_t beltIndex, std::uint32_t alongQ16, std::uint16_t typeId) {
+        odai::sim::BeltCargo cargo{};
+        cargo.itemId = m_nextId++;
+        cargo.typeId = typeId;
+        cargo.beltIndex = static_cast<std::int32_t>(beltIndex);
+        cargo.alongQ16 = alongQ16;
+        worldPosition(cargo);
+        std::copy(cargo.currWorldPos, cargo.currWorldPos + 3, cargo.prevWorldPos);
+        m_cargo.push_back(cargo);
+    }
+
+    void update(float dt) {
+        const std::uint32_t stepQ16 = std::max(1u, static_cast<std::uint32_t>(std::lround(dt * 1.45f * 65536.0f)));
+        std::erase_if(m_cargo, [&](odai::sim::BeltCargo& cargo) {
+            std::copy(cargo.currWorldPos, cargo.currWorldPos + 3, cargo.prevWorldPos);
+            std::uint32_t alongQ16 = cargo.alongQ16 + stepQ16;
+            std::int32_t beltIndex = cargo.beltIndex;
+            std::size_t hopCount = 0;
+            while (alongQ16 >= 65536u) {
+                alongQ16 -= 65536u;
+                beltIndex = m_next[static_cast<std::size_t>(beltIndex)];
+                if (beltIndex < 0 || ++hopCount > m_beltCount) {
+                    return true;
+                }
+            }
+            cargo.beltIndex = beltIndex;
+            cargo.alongQ16 = alongQ16;
+            worldPosition(cargo);
+            return false;
+        });
+
+        ++m_tick;
+        if ((m_tick % 18u) != 0u || m_cargo.size() >= std::max<std::size_t>(1u, m_beltCount * 3u)) {
+            return;
+        }
+        const std::int32_t entry = m_entries[(m_tick / 18u) % m_entries.size()];
+        for (const odai::sim::BeltCargo& cargo : m_cargo) {
+            if (cargo.beltIndex == entry && cargo.alongQ16 < (65536u * 5u) / 16u) {
+                return;
+            }
+        }
+        insert(static_cast<std::size_t>(entry), 0u, static_cast<std::uint16_t>(m_nextId % 5u));
+    }
+
+    const std::vector<odai::sim::BeltCargo>& cargo() const { return m_cargo; }
+
+private:
+    static odai::core::Cell3i beltAxis(odai::sim::BeltDirection direction) {
+        switch (direction) {
+        case odai::sim::BeltDirection::East:
+            return odai::core::Cell3i{1, 0, 0};
+        case odai::sim::BeltDirection::West:
+            return odai::core::Cell3i{-1, 0, 0};
+        case odai::sim::BeltDirection::South:
+            return odai::core::Cell3i{0, 0, 1};
+        case odai::sim::BeltDirection::North:
+        default:
+            return odai::core::Cell3i{0, 0, -1};
+        }
+    }
+
+    void worldPosition(odai::sim::BeltCargo& cargo) const {
+        const odai::core::Cell3i& cell = m_cells[static_cast<std::size_t>(cargo.beltIndex)];
+        const odai::core::Cell3i& axis = m_axes[static_cast<std::size_t>(cargo.beltIndex)];
+        const float alongCentered = (static_cast<float>(cargo.alongQ16) / 65536.0f) - 0.5f;
+        cargo.currWorldPos[0] = static_cast<float>(cell.x) + 0.5f + (static_cast<float>(axis.x) * alongCentered);
+        cargo.currWorldPos[1] = static_cast<float>(cell.y) + 0.68f;
+        cargo.currWorldPos[2] = static_cast<float>(cell.z) + 0.5f + (static_cast<float>(axis.z) * alongCentered);
+    }
+
+    std::size_t m_beltCount = 0;
+    std::vector<odai::core::Cell3i> m_cells;
+    std::vector<odai::core::Cell3i> m_axes;
+    std::vector<std::int32_t> m_next;
+    std::vector<std::int32_t> m_entries;
+    std::vector<odai::sim::BeltCargo> m_cargo;
+    std::uint32_t m_nextId = 1;
+    std::uint32_t m_tick = 0;
+};
+
+// Appends belts walking from start; each run places `count` belts facing
+// its direction.
+void appendBeltRuns(
+    std::vector<odai::sim::Belt>& belts,
+    odai::core::Cell3i start,
+    std::initializer_list<std::pair<odai::sim::BeltDirection, int>> runs
+) {
+    odai::core::Cell3i cell = start;
+    for (const auto& [direction, count] : runs) {
+        odai::core::Cell3i step{0, 0, 0};
+        switch (direction) {
+        case odai::sim::BeltDirection::East: step = odai::core::Cell3i{1, 0, 0}; break;
+        case odai::sim::BeltDirection::West: step = odai::core::Cell3i{-1, 0, 0}; break;
+        case odai::sim::BeltDirection::South: step = odai::core::Cell3i{0, 0, 1}; break;
+        case odai::sim::BeltDirection::North: step = odai::core::Cell3i{0, 0, -1}; break;
+        }
+        for (int i = 0; i < count; ++i) {
+            belts.emplace_back(cell.x, cell.y, cell.z, direction);
+            cell = cell + step;
+        }
+    }
+}
+
+std::vector<odai::sim::BeltCargo> sortedBeltCargo(std::vector<odai::sim::BeltCargo> cargo) {
+    std::sort(cargo.begin(), cargo.end(), [](const odai::sim::BeltCargo& lhs, const odai::sim::BeltCargo& rhs) {
+        return lhs.itemId < rhs.itemId;
+    });
+    return cargo;
+}
+
+bool beltCargoMatches(const std::vector<odai::sim::BeltCargo>& actual, const std::vector<odai::sim::BeltCargo>& expected) {
+    const std::vector<odai::sim::BeltCargo> lhs = sortedBeltCargo(actual);
+    const std::vector<odai::sim::BeltCargo> rhs = sortedBeltCargo(expected);
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        if (lhs[i].itemId != rhs[i].itemId || lhs[i].typeId != rhs[i].typeId ||
+            lhs[i].beltIndex != rhs[i].beltIndex || lhs[i].alongQ16 != rhs[i].alongQ16) {
+            return false;
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            if (std::fabs(lhs[i].currWorldPos[axis] - rhs[i].currWorldPos[axis]) > 1e-5f ||
+                std::fabs(lhs[i].prevWorldPos[axis] - rhs[i].prevWorldPos[axis]) > 1e-5f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void testSegmentBeltCargoMatchesReference() {
+    using odai::sim::BeltDirection;
+    struct Layout {
+        const char* name;
+        std::vector<odai::sim::Belt> belts;
+    };
+    std::vector<Layout> layouts;
+
+    layouts.push_back({"straight", {}});
+    appendBeltRuns(layouts.back().belts, {0, 1, 0}, {{BeltDirection::East, 12}});
+
+    // Two side feeders joining a main line (merge and T-junction).
+    layouts.push_back({"merge", {}});
+    appendBeltRuns(layouts.back().belts, {0, 1, 0}, {{BeltDirection::East, 14}});
+    appendBeltRuns(layouts.back().belts, {5, 1, -4}, {{BeltDirection::South, 4}});
+    appendBeltRuns(layouts.back().belts, {9, 1, 3}, {{BeltDirection::North, 3}});
+
+    layouts.push_back({"turns", {}});
+    appendBeltRuns(
+        layouts.back().belts,
+        {0, 1, 0},
+        {{BeltDirection::East, 6}, {BeltDirection::South, 5}, {BeltDirection::West, 4}, {BeltDirection::South, 2}}
+    );
+
+    // A closed ring has no entry belt; belt 0 takes that role.
+    layouts.push_back({"loop", {}});
+    appendBeltRuns(
+        layouts.back().belts,
+        {0, 1, 0},
+        {{BeltDirection::East, 6}, {BeltDirection::South, 4}, {BeltDirection::West, 6}, {BeltDirection::North, 4}}
+    );
+
+    for (const Layout& layout : layouts) {
+        odai::sim::Simulation simulation;
+        for (const odai::sim::Belt& belt : layout.belts) {
+            simulation.addBelt(belt.x, belt.y, belt.z, belt.direction);
+        }
+        ReferenceBeltCargoSim reference(layout.belts);
+
+        // Out-of-order inserts exercise placement between existing items.
+        const std::array<std::pair<std::size_t, std::uint32_t>, 5> inserts{{
+            {2u, 0x8000u}, {0u, 0x1800u}, {3u, 0xE000u}, {1u, 0x5000u}, {2u, 0x8000u}
+        }};
+        bool inserted = true;
+        for (const auto& [beltIndex, alongQ16] : inserts) {
+            inserted = simulation.insertBeltCargo(beltIndex, alongQ16, 7u) && inserted;
+            reference.insert(beltIndex, alongQ16, 7u);
+        }
+        expectTrue(inserted, "Belt cargo inserts onto valid belts");
+        expectTrue(!simulation.insertBeltCargo(layout.belts.size(), 0u, 1u), "Belt cargo insert rejects an unknown belt");
+        expectTrue(!simulation.insertBeltCargo(0u, 0x10000u, 1u), "Belt cargo insert rejects a position past the belt");
+
+        bool matches = beltCargoMatches(simulation.beltCargoes(), reference.cargo());
+        for (int tick = 0; tick < 600 && matches; ++tick) {
+            // Occasional long steps cross several belts and whole segments at once.
+            const float dt = (tick % 97 == 50) ? 1.7f : (1.0f / 60.0f);
+            simulation.update(dt);
+            reference.update(dt);
+            matches = beltCargoMatches(simulation.beltCargoes(), reference.cargo());
+            matches = matches && simulation.beltCargoCount() == reference.cargo().size();
+        }
+        expectTrue(matches, layout.name);
+        expectTrue(simulation.beltSegmentCount() < layout.belts.size(), "Belt segments group straight runs");
+
+        const std::vector<odai::sim::BeltCargo> all = sortedBeltCargo(simulation.beltCargoes());
+        std::vector<odai::sim::BeltCargo> collected;
+        const std::size_t everywhere = simulation.collectBeltCargoInBounds(
+            odai::math::Vector3{-1000.0f, -1000.0f, -1000.0f},
+            odai::math::Vector3{1000.0f, 1000.0f, 1000.0f},
+            collected
+        );
+        expectTrue(everywhere == all.size() && beltCargoMatches(collected, all), "Belt cargo bounds query covering the network returns every item");
+
+        collected.clear();
+        const odai::math::Vector3 boundsMin{0.0f, 0.0f, -0.5f};
+        const odai::math::Vector3 boundsMax{3.0f, 3.0f, 0.5f};
+        simulation.collectBeltCargoInBounds(boundsMin, boundsMax, collected);
+        bool covered = true;
+        for (const odai::sim::BeltCargo& cargo : all) {
+            const float* p = cargo.currWorldPos;
+            const bool inside = p[0] >= boundsMin.x && p[0] <= boundsMax.x && p[2] >= boundsMin.z && p[2] <= boundsMax.z;
+            const bool found = std::any_of(collected.begin(), collected.end(), [&](const odai::sim::BeltCargo& item) {
+                return item.itemId == cargo.itemId;
+            });
+            covered = covered && (!inside || found);
+        }
+        const bool subset = std::all_of(collected.begin(), collected.end(), [&](const odai::sim::BeltCargo& item) {
+            return std::any_of(all.begin(), all.end(), [&](const odai::sim::BeltCargo& cargo) {
+                return cargo.itemId == item.itemId;
+            });
+        });
+        expectTrue(covered && subset && collected.size() <= all.size(), "Belt cargo bounds query returns the items inside the bounds");
+    }
+}
+
+void testSegmentBeltCargoOnLargeNetwork() {
+    // odai_sim_network_bench times the segment path on this layout.
+    const odai::tools::BeltSerpentineLayout layout = odai::tools::buildBeltSerpentine();
+    odai::sim::Simulation simulation;
+    for (const odai::sim::Belt& belt : layout.belts) {
+        simulation.addBelt(belt.x, belt.y, belt.z, belt.direction);
+    }
+    ReferenceBeltCargoSim reference(layout.belts);
+    for (const odai::tools::BeltCargoSeed& seed : layout.cargo) {
+        simulation.insertBeltCargo(seed.beltIndex, seed.alongQ16, seed.typeId);
+        reference.insert(seed.beltIndex, seed.alongQ16, seed.typeId);
+    }
+
+    constexpr int kTicks = 240;
+    constexpr float kFixedDt = 1.0f / 60.0f;
+    for (int tick = 0; tick < kTicks; ++tick) {
+        simulation.update(kFixedDt);
+    }
+    for (int tick = 0; tick < kTicks; ++tick) {
+        reference.update(kFixedDt);
+    }
+
+    expectTrue(beltCargoMatches(simulation.beltCargoes(), reference.cargo()), "Segment belt cargo matches the per-item reference on a large network");
+}
+
+bool beltTopologyMatchesRebuild(const odai::sim::Simulation& simulation) {
+    odai::sim::Simulation rebuilt = simulation;
+    rebuilt.invalidateBeltTopology();
+    rebuilt.update(0.0f);
+    if (rebuilt.beltSegmentCount() != simulation.beltSegmentCount()) {
+        return false;
+    }
+    for (std::size_t beltIndex = 0; beltIndex < simulation.beltCount(); ++beltIndex) {
+        const odai::sim::Simulation::BeltLinkInfo lhs = simulation.beltLink(beltIndex);
+        const odai::sim::Simulation::BeltLinkInfo rhs = rebuilt.beltLink(beltIndex);
+        if (lhs.nextBeltIndex != rhs.nextBeltIndex || lhs.incomingCount != rhs.incomingCount ||
+            lhs.segmentHeadIndex != rhs.segmentHeadIndex || lhs.segmentSlot != rhs.segmentSlot ||
+            lhs.nextSegmentHeadIndex != rhs.nextSegmentHeadIndex || lhs.segmentHeadIndex < 0) {
+            return false;
+        }
+        if (simulation.beltIndexOf(simulation.beltIdAt(beltIndex)) != static_cast<std::int32_t>(beltIndex)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testIncrementalBeltTopology() {
+    using odai::sim::BeltDirection;
+    constexpr std::array<BeltDirection, 4> kDirections{
+        BeltDirection::North, BeltDirection::East, BeltDirection::South, BeltDirection::West
+    };
+    std::mt19937 rng(0xBE17u);
+    std::uniform_int_distribution<int> coordinate(0, 11);
+    std::uniform_int_distribution<int> directionPick(0, 3);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    odai::sim::Simulation simulation;
+    for (int i = 0; i < 60; ++i) {
+        simulation.addBelt(coordinate(rng), 1, coordinate(rng), kDirections[static_cast<std::size_t>(directionPick(rng))]);
+    }
+    simulation.update(1.0f / 60.0f);
+
+    bool topologyMatches = beltTopologyMatchesRebuild(simulation);
+    bool cargoKept = true;
+    for (int edit = 0; edit < 600 && topologyMatches; ++edit) {
+        for (int tick = 0; tick < 3; ++tick) {
+            simulation.update(0.2f);
+        }
+        std::unordered_map<std::uint32_t, std::pair<std::uint32_t, std::uint32_t>> before;
+        for (const odai::sim::BeltCargo& cargo : simulation.beltCargoes()) {
+            before[cargo.itemId] = {cargo.beltId, cargo.alongQ16};
+        }
+
+        std::int64_t removedBeltId = -1;
+        if (simulation.beltCount() > 0u && percent(rng) < 45) {
+            const std::size_t index = static_cast<std::size_t>(rng() % simulation.beltCount());
+            removedBeltId = simulation.beltIdAt(index);
+            simulation.removeBeltAt(index);
+        } else {
+            const int x = coordinate(rng);
+            const int z = coordinate(rng);
+            for (std::size_t index = 0; index < simulation.beltCount(); ++index) {
+                const odai::sim::Belt& belt = simulation.belts()[index];
+                if (belt.x == x && belt.y == 1 && belt.z == z) {
+                    removedBeltId = simulation.beltIdAt(index);
+                }
+            }
+            simulation.addBelt(x, 1, z, kDirections[static_cast<std::size_t>(directionPick(rng))]);
+        }
+
+        std::size_t expectedCount = 0;
+        for (const auto& [itemId, placement] : before) {
+            expectedCount += (static_cast<std::int64_t>(placement.first) != removedBeltId) ? 1u : 0u;
+        }
+        const std::vector<odai::sim::BeltCargo>& after = simulation.beltCargoes();
+        cargoKept = cargoKept && after.size() == expectedCount && simulation.beltCargoCount() == expectedCount;
+        for (const odai::sim::BeltCargo& cargo : after) {
+            const auto found = before.find(cargo.itemId);
+            cargoKept = cargoKept && found != before.end() &&
+                        found->second.first == cargo.beltId && found->second.second == cargo.alongQ16 &&
+                        simulation.beltIndexOf(cargo.beltId) == cargo.beltIndex;
+        }
+        topologyMatches = beltTopologyMatchesRebuild(simulation);
+    }
+    expectTrue(topologyMatches, "Incremental belt topology matches a full rebuild after random place/remove edits");
+    expectTrue(cargoKept, "Belt edits keep cargo on every belt that was not removed");
+
+    // Removing a belt frees its id for reuse without disturbing the others.
+    odai::sim::Simulation line;
+    for (int x = 0; x < 5; ++x) {
+        line.addBelt(x, 1, 0, BeltDirection::East);
+    }
+    line.update(1.0f / 60.0f);
+    const std::uint32_t lastId = line.beltIdAt(4u);
+    const std::uint32_t removedId = line.beltIdAt(1u);
+    expectTrue(line.removeBeltAt(1u), "Belt removal succeeds");
+    expectTrue(line.beltIdAt(1u) == lastId && line.beltIndexOf(lastId) == 1, "Belt removal moves the last belt into the freed index");
+    expectTrue(line.beltIndexOf(removedId) == -1, "Removed belt id no longer resolves");
+    expectTrue(line.beltSegmentCount() == 2u, "Belt removal splits the straight run");
+    line.addBelt(1, 1, 0, BeltDirection::East);
+    expectTrue(line.beltIdAt(4u) == removedId, "Placed belt reuses the freed id");
+    expectTrue(line.beltSegmentCount() == 1u && beltTopologyMatchesRebuild(line), "Refilling the gap rejoins the straight run");
+
+    // Placing and removing one belt at the end of a large serpentine factory.
+    odai::sim::Simulation factory;
+    constexpr int kRows = 50;
+    constexpr int kRowLength = 200;
+    for (int row = 0; row < kRows; ++row) {
+        const bool east = (row % 2) == 0;
+        for (int i = 0; i < kRowLength; ++i) {
+            factory.addBelt(east ? i : kRowLength - i, 1, row * 2, east ? BeltDirection::East : BeltDirection::West);
+        }
+        factory.addBelt(east ? kRowLength : 0, 1, row * 2, BeltDirection::South);
+        factory.addBelt(east ? kRowLength : 0, 1, row * 2 + 1, BeltDirection::South);
+    }
+    factory.update(1.0f / 60.0f);
+    for (int edit = 0; edit < 20; ++edit) {
+        factory.addBelt(-1, 1, 0, BeltDirection::East);
+        factory.removeBeltAt(factory.beltCount() - 1u);
+    }
+    expectTrue(
+        factory.beltCount() == static_cast<std::size_t>(kRows) * (kRowLength + 2) && beltTopologyMatchesRebuild(factory),
+        "Repeated edits at the end of a large factory keep its topology"
+    );
+}
+
+void testBeltLanesAndSideLoading() {
+    using odai::sim::BeltDirection;
+    const odai::sim::BeltEdgeData twoLanes{.laneCount = 2};
+
+    // A two-lane main line with feeders joining its side at x = 5 from the
+    // north (its left) and the south (its right): a cross junction.
+    odai::sim::Simulation junction;
+    junction.setDefaultBeltEdgeData(twoLanes);
+    for (int x = 0; x < 12; ++x) {
+        junction.addBelt(x, 1, 0, BeltDirection::East);
+    }
+    for (int z = -3; z < 0; ++z) {
+        junction.addBelt(5, 1, z, BeltDirection::South);
+    }
+    for (int z = 3; z > 0; --z) {
+        junction.addBelt(5, 1, z, BeltDirection::North);
+    }
+
+    // Last lane seen upstream of the junction, and 2 for the north feeder, 3
+    // for the south one.
+    std::unordered_map<std::uint32_t, int> upstream;
+    std::size_t sideLoaded = 0;
+    std::size_t straightThrough = 0;
+    bool lanesMatch = true;
+    bool lanesOffset = true;
+    for (int tick = 0; tick < 600; ++tick) {
+        junction.update(1.0f / 60.0f);
+        for (const odai::sim::BeltCargo& cargo : junction.beltCargoes()) {
+            const odai::sim::Belt& belt = junction.belts()[static_cast<std::size_t>(cargo.beltIndex)];
+            if (belt.z != 0) {
+                upstream[cargo.itemId] = (belt.z < 0) ? 2 : 3;
+                continue;
+            }
+            // Lane 0 is on the left facing east, i.e. north of the centre line.
+            lanesOffset = lanesOffset && ((cargo.lane == 0u) == (cargo.currWorldPos[2] < 0.5f));
+            const auto found = upstream.find(cargo.itemId);
+            if (belt.x < 5) {
+                upstream[cargo.itemId] = cargo.lane;
+            } else if (found != upstream.end() && found->second >= 2) {
+                lanesMatch = lanesMatch && cargo.lane == static_cast<std::uint8_t>(found->second - 2);
+                ++sideLoaded;
+            } else if (found != upstream.end()) {
+                lanesMatch = lanesMatch && cargo.lane == static_cast<std::uint8_t>(found->second);
+                ++straightThrough;
+            }
+        }
+    }
+    expectTrue(sideLoaded > 0u && straightThrough > 0u, "Junction test saw side-loaded and straight-through items");
+    expectTrue(lanesMatch, "Side feeders load onto the near lane and straight feeders keep the lane");
+    expectTrue(lanesOffset, "Belt lanes render left to right across the belt");
+
+    // A plain turn keeps an item's lane.
+    odai::sim::Simulation turn;
+    turn.setDefaultBeltEdgeData(twoLanes);
+    for (int x = 0; x < 4; ++x) {
+        turn.addBelt(x, 1, 0, BeltDirection::East);
+    }
+    for (int z = 0; z < 4; ++z) {
+        turn.addBelt(4, 1, z, BeltDirection::South);
+    }
+    expectTrue(turn.insertBeltCargo(1u, 0x4000u, 42u, 1u), "Belt cargo inserts onto the second lane");
+    expectTrue(!turn.insertBeltCargo(1u, 0x4000u, 42u, 2u), "Belt cargo insert rejects a lane the belt does not have");
+    bool turned = false;
+    bool laneKept = true;
+    for (int tick = 0; tick < 240 && !turned; ++tick) {
+        turn.update(1.0f / 60.0f);
+        for (const odai::sim::BeltCargo& cargo : turn.beltCargoes()) {
+            if (cargo.typeId == 42u) {
+                laneKept = laneKept && cargo.lane == 1u;
+                turned = turn.belts()[static_cast<std::size_t>(cargo.beltIndex)].z > 0;
+            }
+        }
+    }
+    expectTrue(turned && laneKept, "Belt turns keep an item's lane");
+
+    // Changing one belt's edge data splits its run and relinks like an edit.
+    odai::sim::Simulation line;
+    for (int x = 0; x < 10; ++x) {
+        line.addBelt(x, 1, 0, BeltDirection::East);
+    }
+    line.update(1.0f / 60.0f);
+    expectTrue(line.setBeltEdgeData(4u, odai::sim::BeltEdgeData{.speedTier = 1}), "Belt edge data updates a placed belt");
+    expectTrue(line.beltSegmentCount() == 3u && beltTopologyMatchesRebuild(line), "A faster belt splits its straight run");
+    expectTrue(line.setBeltEdgeData(4u, line.belts()[3].edge), "Belt edge data resets a placed belt");
+    expectTrue(line.beltSegmentCount() == 1u && beltTopologyMatchesRebuild(line), "Matching edge data rejoins the straight run");
+    expectTrue(!line.setBeltEdgeData(line.beltCount(), odai::sim::BeltEdgeData{}), "Belt edge data rejects an unknown belt");
+
+    // Tier 2 moves three times as far as tier 0 in the same ticks.
+    odai::sim::Simulation tiers;
+    for (int x = 0; x < 30; ++x) {
+        tiers.addBelt(x, 1, 0, BeltDirection::East, odai::sim::BeltEdgeData{.speedTier = 0});
+        tiers.addBelt(x, 1, 2, BeltDirection::East, odai::sim::BeltEdgeData{.speedTier = 2});
+    }
+    tiers.insertBeltCargo(0u, 0x100u, 40u);
+    tiers.insertBeltCargo(1u, 0x100u, 41u);
+    for (int tick = 0; tick < 60; ++tick) {
+        tiers.update(1.0f / 60.0f);
+    }
+    std::int64_t slowTravelQ16 = 0;
+    std::int64_t fastTravelQ16 = 0;
+    for (const odai::sim::BeltCargo& cargo : tiers.beltCargoes()) {
+        const std::int64_t travelQ16 =
+            (static_cast<std::int64_t>(tiers.belts()[static_cast<std::size_t>(cargo.beltIndex)].x) << 16) + cargo.alongQ16 - 0x100;
+        slowTravelQ16 = (cargo.typeId == 40u) ? travelQ16 : slowTravelQ16;
+        fastTravelQ16 = (cargo.typeId == 41u) ? travelQ16 : fastTravelQ16;
+    }
+    expectTrue(slowTravelQ16 > 0 && fastTravelQ16 == slowTravelQ16 * 3, "Belt speed tier n moves items n + 1 times the base speed");
+}
+
+// Tops up the first slot of each input belt, like an inserter that drops an
+// item whenever there is room.
+void feedBeltInputs(odai::sim::Simulation& simulation, std::initializer_list<std::size_t> inputs) {
+    std::vector<odai::sim::BeltSlot> slots;
+    for (const std::size_t beltIndex : inputs) {
+        slots.clear();
+        if (simulation.collectBeltSlots(beltIndex, 0u, slots) > 0u && !slots.front().occupied) {
+            simulation.insertBeltCargo(beltIndex, 0u, 7u);
+        }
+    }
+}
+
+// Smallest distance between neighbours in one lane of one straight run.
+std::int64_t minBeltLaneGapQ16(const odai::sim::Simulation& simulation) {
+    std::unordered_map<std::int64_t, std::vector<std::int64_t>> positionsByLane;
+    for (const odai::sim::BeltCargo& cargo : simulation.beltCargoes()) {
+        const odai::sim::Simulation::BeltLinkInfo link = simulation.beltLink(static_cast<std::size_t>(cargo.beltIndex));
+        positionsByLane[(static_cast<std::int64_t>(link.segmentHeadIndex) << 8) | cargo.lane].push_back(
+            (static_cast<std::int64_t>(link.segmentSlot) << 16) + cargo.alongQ16
+        );
+    }
+    std::int64_t minGapQ16 = std::numeric_limits<std::int64_t>::max();
+    for (auto& [lane, positions] : positionsByLane) {
+        std::sort(positions.begin(), positions.end());
+        for (std::size_t i = 1; i < positions.size(); ++i) {
+            minGapQ16 = std::min(minGapQ16, positions[i] - positions[i - 1]);
+        }
+    }
+    return minGapQ16;
+}
+
+void testBeltCompressionAndThroughput() {
+    using odai::sim::BeltDirection;
+    constexpr std::uint16_t kSpacingQ8 = 64;
+    constexpr float kFixedDt = 1.0f / 60.0f;
+
+    // Three full inputs merge onto one lane at x = 10: the main line from
+    // x = 0 and side feeders from the north and south. The run past the merge
+    // can carry one item per spacing, so the inputs queue up.
+    odai::sim::Simulation merge;
+    merge.setDefaultBeltEdgeData(odai::sim::BeltEdgeData{.slotSpacingQ8 = kSpacingQ8});
+    for (int x = 0; x < 20; ++x) {
+        merge.addBelt(x, 1, 0, BeltDirection::East);
+    }
+    for (int z = -4; z < 0; ++z) {
+        merge.addBelt(10, 1, z, BeltDirection::South);
+    }
+    for (int z = 4; z > 0; --z) {
+        merge.addBelt(10, 1, z, BeltDirection::North);
+    }
+
+    std::int64_t minGapQ16 = std::numeric_limits<std::int64_t>::max();
+    for (std::uint32_t tick = 0; tick < odai::sim::Simulation::kThroughputWindowTicks; ++tick) {
+        feedBeltInputs(merge, {0u, 20u, 24u});
+        merge.update(kFixedDt);
+        minGapQ16 = std::min(minGapQ16, minBeltLaneGapQ16(merge));
+    }
+    odai::sim::Simulation copy = merge;
+    for (std::uint32_t tick = 0; tick < odai::sim::Simulation::kThroughputWindowTicks * 2u; ++tick) {
+        feedBeltInputs(merge, {0u, 20u, 24u});
+        feedBeltInputs(copy, {0u, 20u, 24u});
+        merge.update(kFixedDt);
+        copy.update(kFixedDt);
+        minGapQ16 = std::min(minGapQ16, minBeltLaneGapQ16(merge));
+    }
+    expectTrue(minGapQ16 >= (static_cast<std::int64_t>(kSpacingQ8) << 8), "Belt items never close within the lane spacing");
+
+    const odai::sim::Simulation::BeltThroughput mainIn = merge.beltThroughput(5u);
+    const odai::sim::Simulation::BeltThroughput northIn = merge.beltThroughput(21u);
+    const odai::sim::Simulation::BeltThroughput southIn = merge.beltThroughput(25u);
+    const odai::sim::Simulation::BeltThroughput out = merge.beltThroughput(15u);
+    // 1.45 voxels/s at a quarter-voxel spacing is 348 items a minute.
+    const double outPerMinute = out.itemsPerMinuteQ8 / 256.0;
+    const double inPerMinute = (mainIn.itemsPerMinuteQ8 + northIn.itemsPerMinuteQ8 + southIn.itemsPerMinuteQ8) / 256.0;
+    expectTrue(outPerMinute > 320.0 && outPerMinute < 372.0, "Merged belt carries one item per spacing");
+    expectTrue(std::fabs(inPerMinute - outPerMinute) < 40.0, "Belt throughput into a merge matches the throughput out");
+    expectTrue(out.occupancyQ8 >= 192u && out.blockedQ8 == 0u, "The belt past a merge runs full without waiting");
+    expectTrue(mainIn.blockedQ8 > 0u && northIn.blockedQ8 > 0u && southIn.blockedQ8 > 0u, "Belt inputs to a saturated merge report waiting");
+    // The longest-waiting input goes first, so each gets about a third.
+    const std::uint32_t fairShareQ8 = out.itemsPerMinuteQ8 / 4u;
+    expectTrue(
+        mainIn.itemsPerMinuteQ8 > fairShareQ8 && northIn.itemsPerMinuteQ8 > fairShareQ8 && southIn.itemsPerMinuteQ8 > fairShareQ8,
+        "A saturated belt merge serves its inputs in turn"
+    );
+    expectTrue(merge.beltThroughput(merge.beltCount()).itemsPerMinuteQ8 == 0u, "Belt throughput of an unknown belt is empty");
+
+    const odai::sim::Simulation::BeltThroughput copyOut = copy.beltThroughput(15u);
+    expectTrue(
+        beltCargoMatches(copy.beltCargoes(), merge.beltCargoes()) &&
+            copyOut.itemsPerMinuteQ8 == out.itemsPerMinuteQ8 && copyOut.occupancyQ8 == out.occupancyQ8,
+        "Belt lanes, compression and counters are deterministic"
+    );
+
+    std::vector<odai::sim::BeltSlot> slots;
+    const std::size_t slotCount = merge.collectBeltSlots(10u, 0u, slots);
+    const bool slotsFull = std::all_of(slots.begin(), slots.end(), [](const odai::sim::BeltSlot& slot) { return slot.occupied; });
+    expectTrue(slotCount == 4u && slots.size() == 4u && slotsFull, "Belt slots cover the belt at the lane spacing");
+    expectTrue(merge.collectBeltSlots(10u, 1u, slots) == 0u, "Belt slots reject a lane the belt does not have");
+}
+
 void testMagicaVoxelMeshing() {
     odai::world::MagicaVoxelModel model{};
     model.sizeX = 4;
@@ -615,6 +2657,336 @@ void testMagicaVoxelChunkedMeshing() {
 
 } // namespace
 
+// Minimal .vox writer for the loader tests: chunks are appended to the MAIN
+// children in order.
+class VoxFileBuilder {
+public:
+    void appendChunk(const char* id, const std::vector<std::uint8_t>& content) {
+        m_children.insert(m_children.end(), id, id + 4);
+        appendU32(m_children, static_cast<std::uint32_t>(content.size()));
+        appendU32(m_children, 0u);
+        m_children.insert(m_children.end(), content.begin(), content.end());
+    }
+
+    void appendModel(int sizeX, int sizeY, int sizeZ, const std::vector<odai::world::MagicaVoxel>& voxels) {
+        std::vector<std::uint8_t> size;
+        appendU32(size, static_cast<std::uint32_t>(sizeX));
+        appendU32(size, static_cast<std::uint32_t>(sizeY));
+        appendU32(size, static_cast<std::uint32_t>(sizeZ));
+        appendChunk("SIZE", size);
+        std::vector<std::uint8_t> xyzi;
+        appendU32(xyzi, static_cast<std::uint32_t>(voxels.size()));
+        for (const odai::world::MagicaVoxel& voxel : voxels) {
+            xyzi.push_back(static_cast<std::uint8_t>(voxel.x));
+            xyzi.push_back(static_cast<std::uint8_t>(voxel.y));
+            xyzi.push_back(static_cast<std::uint8_t>(voxel.z));
+            xyzi.push_back(voxel.paletteIndex);
+        }
+        appendChunk("XYZI", xyzi);
+    }
+
+    void appendPalette(const std::array<std::uint32_t, 256>& paletteRgba) {
+        std::vector<std::uint8_t> rgba;
+        for (std::size_t index = 1; index <= 256u; ++index) {
+            appendU32(rgba, index < 256u ? paletteRgba[index] : 0u);
+        }
+        appendChunk("RGBA", rgba);
+    }
+
+    // attributes: flat key/value pairs.
+    void appendTransform(int nodeId, int childNodeId, const std::vector<std::string>& attributes,
+                         const std::vector<std::string>& frame) {
+        std::vector<std::uint8_t> content;
+        appendU32(content, static_cast<std::uint32_t>(nodeId));
+        appendDict(content, attributes);
+        appendU32(content, static_cast<std::uint32_t>(childNodeId));
+        appendU32(content, 0xFFFFFFFFu);
+        appendU32(content, 0u);
+        appendU32(content, 1u);
+        appendDict(content, frame);
+        appendChunk("nTRN", content);
+    }
+
+    void appendGroup(int nodeId, const std::vector<int>& childNodeIds) {
+        std::vector<std::uint8_t> content;
+        appendU32(content, static_cast<std::uint32_t>(nodeId));
+        appendDict(content, {});
+        appendU32(content, static_cast<std::uint32_t>(childNodeIds.size()));
+        for (const int child : childNodeIds) {
+            appendU32(content, static_cast<std::uint32_t>(child));
+        }
+        appendChunk("nGRP", content);
+    }
+
+    void appendShape(int nodeId, int modelId) {
+        std::vector<std::uint8_t> content;
+        appendU32(content, static_cast<std::uint32_t>(nodeId));
+        appendDict(content, {});
+        appendU32(content, 1u);
+        appendU32(content, static_cast<std::uint32_t>(modelId));
+        appendDict(content, {});
+        appendChunk("nSHP", content);
+    }
+
+    bool write(const std::filesystem::path& path) const {
+        std::vector<std::uint8_t> bytes = {'V', 'O', 'X', ' '};
+        appendU32(bytes, 150u);
+        bytes.insert(bytes.end(), {'M', 'A', 'I', 'N'});
+        appendU32(bytes, 0u);
+        appendU32(bytes, static_cast<std::uint32_t>(m_children.size()));
+        bytes.insert(bytes.end(), m_children.begin(), m_children.end());
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return static_cast<bool>(stream);
+    }
+
+private:
+    static void appendU32(std::vector<std::uint8_t>& bytes, std::uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            bytes.push_back(static_cast<std::uint8_t>(value >> shift));
+        }
+    }
+
+    static void appendDict(std::vector<std::uint8_t>& bytes, const std::vector<std::string>& keyValues) {
+        appendU32(bytes, static_cast<std::uint32_t>(keyValues.size() / 2u));
+        for (const std::string& text : keyValues) {
+            appendU32(bytes, static_cast<std::uint32_t>(text.size()));
+            bytes.insert(bytes.end(), text.begin(), text.end());
+        }
+    }
+
+    std::vector<std::uint8_t> m_children;
+};
+
+bool hasMagicaVoxel(const odai::world::MagicaVoxelModel& model, int x, int y, int z, std::uint8_t paletteIndex) {
+    return std::any_of(model.voxels.begin(), model.voxels.end(), [&](const odai::world::MagicaVoxel& voxel) {
+        return voxel.x == x && voxel.y == y && voxel.z == z && voxel.paletteIndex == paletteIndex;
+    });
+}
+
+void testMagicaVoxelSceneLoading() {
+    using odai::world::MagicaVoxel;
+    using odai::world::MagicaVoxelModel;
+
+    const std::filesystem::path scenePath = std::filesystem::temp_directory_path() / "odai_foundation_scene.vox";
+    VoxFileBuilder scene;
+    scene.appendModel(2, 2, 2, {MagicaVoxel{0u, 0u, 0u, 1u}, MagicaVoxel{1u, 1u, 1u, 2u}});
+    scene.appendModel(3, 1, 1, {MagicaVoxel{0u, 0u, 0u, 3u}, MagicaVoxel{2u, 0u, 0u, 3u}});
+    scene.appendTransform(0, 1, {}, {});
+    scene.appendGroup(1, {2, 4, 6});
+    scene.appendTransform(2, 3, {}, {"_t", "10 0 0"});
+    scene.appendShape(3, 0);
+    // "_r" 1 swaps x and y.
+    scene.appendTransform(4, 5, {}, {"_t", "-4 2 1", "_r", "1"});
+    scene.appendShape(5, 1);
+    scene.appendTransform(6, 7, {"_hidden", "1"}, {"_t", "50 50 50"});
+    scene.appendShape(7, 0);
+    expectTrue(scene.write(scenePath), "Magica scene file written");
+
+    MagicaVoxelModel composed{};
+    expectTrue(odai::world::loadMagicaVoxelModel(scenePath, composed), "Magica scene graph file loads");
+    expectTrue(
+        composed.sizeX == 15 && composed.sizeY == 5 && composed.sizeZ == 3,
+        "Magica scene bounds cover every visible shape"
+    );
+    expectTrue(composed.voxels.size() == 4u, "Magica scene skips hidden transforms");
+    expectTrue(
+        hasMagicaVoxel(composed, 13, 0, 0, 1u) && hasMagicaVoxel(composed, 14, 1, 1, 2u),
+        "Magica scene places translated shapes centred on their transform"
+    );
+    expectTrue(
+        hasMagicaVoxel(composed, 0, 2, 2, 3u) && hasMagicaVoxel(composed, 0, 4, 2, 3u),
+        "Magica scene applies transform rotations"
+    );
+
+    // Each group lists the next one twice: 2^40 paths through 43 nodes.
+    const std::filesystem::path fanOutPath = std::filesystem::temp_directory_path() / "odai_foundation_fanout.vox";
+    VoxFileBuilder fanOut;
+    fanOut.appendModel(1, 1, 1, {MagicaVoxel{0u, 0u, 0u, 1u}});
+    fanOut.appendTransform(0, 1, {}, {});
+    for (int nodeId = 1; nodeId <= 40; ++nodeId) {
+        fanOut.appendGroup(nodeId, {nodeId + 1, nodeId + 1});
+    }
+    fanOut.appendTransform(41, 42, {}, {});
+    fanOut.appendShape(42, 0);
+    expectTrue(fanOut.write(fanOutPath), "Magica fan-out scene file written");
+    MagicaVoxelModel fanOutModel{};
+    expectTrue(
+        !odai::world::loadMagicaVoxelModel(fanOutPath, fanOutModel),
+        "Magica loader rejects scene graphs that expand past the visit budget"
+    );
+
+    // No scene graph: the first model loads as stored, and an XYZI larger
+    // than one read batch streams in whole.
+    const std::filesystem::path legacyPath = std::filesystem::temp_directory_path() / "odai_foundation_legacy.vox";
+    std::vector<MagicaVoxel> solid;
+    for (int z = 0; z < 32; ++z) {
+        for (int y = 0; y < 32; ++y) {
+            for (int x = 0; x < 32; ++x) {
+                solid.push_back(MagicaVoxel{
+                    static_cast<std::uint16_t>(x),
+                    static_cast<std::uint16_t>(y),
+                    static_cast<std::uint16_t>(z),
+                    static_cast<std::uint8_t>(1 + ((x + y + z) % 5))
+                });
+            }
+        }
+    }
+    VoxFileBuilder legacy;
+    legacy.appendModel(32, 32, 32, solid);
+    legacy.appendModel(2, 2, 2, {MagicaVoxel{0u, 0u, 0u, 9u}});
+    expectTrue(legacy.write(legacyPath), "Magica legacy file written");
+    MagicaVoxelModel legacyModel{};
+    expectTrue(odai::world::loadMagicaVoxelModel(legacyPath, legacyModel), "Magica file without scene graph loads");
+    expectTrue(
+        legacyModel.sizeX == 32 && legacyModel.voxels.size() == solid.size() &&
+            std::equal(
+                legacyModel.voxels.begin(),
+                legacyModel.voxels.end(),
+                solid.begin(),
+                [](const MagicaVoxel& lhs, const MagicaVoxel& rhs) {
+                    return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z && lhs.paletteIndex == rhs.paletteIndex;
+                }
+            ),
+        "Magica loader streams the first model's voxels in order"
+    );
+
+    std::filesystem::resize_file(legacyPath, 64u);
+    MagicaVoxelModel truncated{};
+    expectTrue(!odai::world::loadMagicaVoxelModel(legacyPath, truncated), "Magica loader rejects truncated files");
+
+    std::error_code removeError;
+    std::filesystem::remove(scenePath, removeError);
+    std::filesystem::remove(fanOutPath, removeError);
+    std::filesystem::remove(legacyPath, removeError);
+}
+
+bool sameMagicaMeshChunks(
+    const std::vector<odai::world::MagicaVoxelMeshChunk>& lhs,
+    const std::vector<odai::world::MagicaVoxelMeshChunk>& rhs
+) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        if (lhs[i].originX != rhs[i].originX || lhs[i].originY != rhs[i].originY || lhs[i].originZ != rhs[i].originZ ||
+            lhs[i].mesh.indices != rhs[i].mesh.indices || lhs[i].mesh.vertices.size() != rhs[i].mesh.vertices.size()) {
+            return false;
+        }
+        for (std::size_t vertex = 0; vertex < lhs[i].mesh.vertices.size(); ++vertex) {
+            if (lhs[i].mesh.vertices[vertex].bits != rhs[i].mesh.vertices[vertex].bits) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void testParallelMagicaMeshingAndStamping() {
+    using odai::world::Chunk;
+    using odai::world::MagicaVoxel;
+    using odai::world::MagicaVoxelModel;
+    using odai::world::World;
+
+    // More colors than base color slots, so the nearest-slot fallback runs.
+    MagicaVoxelModel model{};
+    model.sizeX = 72;
+    model.sizeY = 40;
+    model.sizeZ = 48;
+    model.hasPalette = true;
+    model.paletteRgba.fill(0u);
+    for (std::uint32_t index = 1; index <= 12u; ++index) {
+        model.paletteRgba[index] = 0xFF000000u | ((index * 37u) & 0xFFu) | (((index * 91u) & 0xFFu) << 8u) |
+                                   (((index * 53u) & 0xFFu) << 16u);
+    }
+    std::mt19937 rng(20260214u);
+    for (int z = 0; z < model.sizeZ; ++z) {
+        for (int y = 0; y < model.sizeY; ++y) {
+            for (int x = 0; x < model.sizeX; ++x) {
+                const bool filled = z < 6 || (rng() % 100u) < 30u;
+                if (filled) {
+                    model.voxels.push_back(MagicaVoxel{
+                        static_cast<std::uint16_t>(x),
+                        static_cast<std::uint16_t>(y),
+                        static_cast<std::uint16_t>(z),
+                        static_cast<std::uint8_t>(1u + (rng() % 12u))
+                    });
+                }
+            }
+        }
+    }
+
+    odai::core::JobSystem jobs(std::max(2u, std::thread::hardware_concurrency()));
+    const std::vector<odai::world::MagicaVoxelMeshChunk> serialChunks = odai::world::buildMagicaVoxelMeshChunks(model);
+    const std::vector<odai::world::MagicaVoxelMeshChunk> parallelChunks =
+        odai::world::buildMagicaVoxelMeshChunks(model, &jobs);
+    expectTrue(serialChunks.size() == 12u, "Magica mesher emits every non-empty tile");
+    expectTrue(sameMagicaMeshChunks(serialChunks, parallelChunks), "Parallel Magica meshing matches serial output");
+
+    const std::filesystem::path modelPath = std::filesystem::temp_directory_path() / "odai_foundation_stamp.vox";
+    VoxFileBuilder file;
+    file.appendModel(model.sizeX, model.sizeY, model.sizeZ, model.voxels);
+    file.appendPalette(model.paletteRgba);
+    expectTrue(file.write(modelPath), "Magica stamp file written");
+    const std::string modelPathText = modelPath.string();
+    const std::array<World::MagicaStampSpec, 2> specs = {
+        World::MagicaStampSpec{modelPathText.c_str(), 0.0f, 8.0f, 0.0f, 1.0f},
+        World::MagicaStampSpec{modelPathText.c_str(), 20.0f, 4.0f, -10.0f, 0.5f}
+    };
+
+    World serialWorld;
+    serialWorld.setStreamingConfig(World::ChunkStreamingConfig{2, 2});
+    serialWorld.regenerateFlatWorld();
+    const World::MagicaStampResult serialResult = serialWorld.stampMagicaResources(specs);
+    World parallelWorld;
+    parallelWorld.setStreamingConfig(World::ChunkStreamingConfig{2, 2});
+    parallelWorld.regenerateFlatWorld();
+    const World::MagicaStampResult parallelResult = parallelWorld.stampMagicaResources(specs, &jobs);
+
+    expectTrue(
+        serialResult.stampedResourceCount == 2u && serialResult.stampedVoxelCount > 0u &&
+            serialResult.clippedVoxelCount > 0u && serialResult.stampedChunkBatchCount > 0u,
+        "Magica stamping reports stamped and clipped voxels"
+    );
+    expectTrue(
+        parallelResult.stampedVoxelCount == serialResult.stampedVoxelCount &&
+            parallelResult.clippedVoxelCount == serialResult.clippedVoxelCount &&
+            parallelResult.stampedChunkBatchCount == serialResult.stampedChunkBatchCount &&
+            parallelResult.baseColorPaletteCount == serialResult.baseColorPaletteCount &&
+            parallelResult.baseColorPalette == serialResult.baseColorPalette,
+        "Parallel Magica stamping reports the same counts and palette"
+    );
+    const std::vector<Chunk>& serialChunksInWorld = serialWorld.chunkGrid().chunks();
+    const std::vector<Chunk>& parallelChunksInWorld = parallelWorld.chunkGrid().chunks();
+    bool worldsMatch = serialChunksInWorld.size() == parallelChunksInWorld.size();
+    for (std::size_t chunkIndex = 0; worldsMatch && chunkIndex < serialChunksInWorld.size(); ++chunkIndex) {
+        const Chunk& serialChunk = serialChunksInWorld[chunkIndex];
+        const Chunk& parallelChunk = parallelChunksInWorld[chunkIndex];
+        for (int y = 0; worldsMatch && y < Chunk::kSizeY; ++y) {
+            for (int z = 0; worldsMatch && z < Chunk::kSizeZ; ++z) {
+                for (int x = 0; worldsMatch && x < Chunk::kSizeX; ++x) {
+                    const odai::world::Voxel a = serialChunk.voxelAt(x, y, z);
+                    const odai::world::Voxel b = parallelChunk.voxelAt(x, y, z);
+                    worldsMatch = a.type == b.type && a.baseColorIndex == b.baseColorIndex;
+                }
+            }
+        }
+        for (int mz = 0; worldsMatch && mz < Chunk::kMacroSizeZ; ++mz) {
+            for (int my = 0; worldsMatch && my < Chunk::kMacroSizeY; ++my) {
+                for (int mx = 0; worldsMatch && mx < Chunk::kMacroSizeX; ++mx) {
+                    worldsMatch = serialChunk.macroCellAt(mx, my, mz).resolution ==
+                                  parallelChunk.macroCellAt(mx, my, mz).resolution;
+                }
+            }
+        }
+    }
+    expectTrue(worldsMatch, "Parallel Magica stamping produces the same world");
+    expectTrue(serialWorld.hasUnsavedChanges(), "Magica stamping marks chunks edited");
+
+    std::error_code removeError;
+    std::filesystem::remove(modelPath, removeError);
+}
+
 void testVoxelCraftPlayerAndStreaming() {
     using namespace odai::games::voxelcraft;
 
@@ -678,6 +3050,111 @@ void testVoxelCraftPlayerAndStreaming() {
     expectTrue(allChunkYZero, "computeDesiredChunkKeys only requests chunkY == 0 (surface streaming)");
 }
 
+void testVoxelCraftStreamingPipeline() {
+    using odai::games::voxelcraft::ChunkStreamingPipeline;
+    using odai::games::voxelcraft::ChunkStreamingPipelineConfig;
+    using odai::games::voxelcraft::ChunkStreamingPipelineStats;
+    using odai::world::World;
+
+    // Synchronous pool: each kick runs its launches to completion inline, so
+    // launch order is observable one chunk at a time.
+    {
+        odai::core::JobSystem inlineJobs(0);
+        ChunkStreamingPipeline pipeline(inlineJobs, ChunkStreamingPipelineConfig{1});
+        pipeline.start();
+        pipeline.requestChunk(World::ChunkKey{2, 0, 0});
+        pipeline.requestChunk(World::ChunkKey{0, 0, 0});
+        pipeline.requestChunk(World::ChunkKey{1, 0, 0});
+        pipeline.requestChunk(World::ChunkKey{0, 0, 0});
+        expectTrue(pipeline.stats().pendingCount == 3u, "Repeated requests for a key are coalesced");
+
+        expectTrue(pipeline.kickJobs(0, 0, 0) == 1u, "A kick launches at most maxInFlight requests");
+        std::vector<ChunkStreamingPipeline::CompletedChunk> completed = pipeline.drainCompleted();
+        expectTrue(
+            completed.size() == 1u && completed[0].key == World::ChunkKey{0, 0, 0} &&
+                chunksEqual(completed[0].chunk, odai::world::buildProceduralChunk(0, 0, 0)),
+            "The request nearest the camera chunk runs first and is plain procedural output"
+        );
+        (void)pipeline.kickJobs(3, 0, 0);
+        completed = pipeline.drainCompleted();
+        expectTrue(
+            completed.size() == 1u && completed[0].key == World::ChunkKey{2, 0, 0},
+            "Pending requests are re-prioritized when the camera moves"
+        );
+
+        pipeline.requestChunk(World::ChunkKey{5, 0, 0});
+        pipeline.cancelChunk(World::ChunkKey{5, 0, 0});
+        expectTrue(pipeline.stats().cancelledPending == 1u, "Cancelling a pending request drops it before launch");
+
+        (void)pipeline.kickJobs(3, 0, 0);
+        pipeline.cancelChunk(World::ChunkKey{1, 0, 0});
+        expectTrue(pipeline.drainCompleted().empty(), "A launched request cancelled before drain is not handed back");
+        expectTrue(
+            pipeline.stats().cancelledAfterMesh == 1u && pipeline.stats().pendingCount == 0u,
+            "Late cancellations are counted, not delivered"
+        );
+
+        pipeline.requestChunk(World::ChunkKey{4, 0, 0});
+        (void)pipeline.kickJobs(4, 0, 0);
+        pipeline.cancelChunk(World::ChunkKey{4, 0, 0});
+        pipeline.requestChunk(World::ChunkKey{4, 0, 0});
+        completed = pipeline.drainCompleted();
+        expectTrue(
+            completed.size() == 1u && completed[0].key == World::ChunkKey{4, 0, 0},
+            "Re-requesting a cancelled in-flight chunk revives it"
+        );
+    }
+
+    // Worker pool: a 5x5 ring streams in whole while cancelled requests stop
+    // at a stage boundary.
+    using Clock = std::chrono::steady_clock;
+    odai::core::JobSystem jobs(2);
+    ChunkStreamingPipeline pipeline(jobs);
+    pipeline.start();
+    const std::vector<World::ChunkKey> keys = odai::world::World::streamingWindowKeys(
+        World::ChunkStreamingConfig{2, 2}, 0, 0, 0);
+    for (const World::ChunkKey& key : keys) {
+        pipeline.requestChunk(key);
+    }
+    std::vector<World::ChunkKey> drainedKeys;
+    const auto streamStart = Clock::now();
+    while (drainedKeys.size() < keys.size() && Clock::now() - streamStart < std::chrono::seconds(30)) {
+        (void)pipeline.kickJobs(0, 0, 0);
+        for (ChunkStreamingPipeline::CompletedChunk& chunk : pipeline.drainCompleted()) {
+            drainedKeys.push_back(chunk.key);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::sort(drainedKeys.begin(), drainedKeys.end(), [](const World::ChunkKey& a, const World::ChunkKey& b) {
+        return std::tie(a.chunkX, a.chunkY, a.chunkZ) < std::tie(b.chunkX, b.chunkY, b.chunkZ);
+    });
+    expectTrue(
+        drainedKeys.size() == keys.size() &&
+            std::adjacent_find(drainedKeys.begin(), drainedKeys.end()) == drainedKeys.end(),
+        "Every requested chunk is generated, meshed and drained exactly once"
+    );
+    const ChunkStreamingPipelineStats streamed = pipeline.stats();
+    expectTrue(
+        streamed.drained == keys.size() && streamed.generatingCount == 0u && streamed.meshingCount == 0u &&
+            streamed.generateMsTotal > 0.0,
+        "Stage counters settle and stage timings are recorded"
+    );
+
+    for (int chunkX = 10; chunkX < 30; ++chunkX) {
+        pipeline.requestChunk(World::ChunkKey{chunkX, 0, 0});
+    }
+    (void)pipeline.kickJobs(10, 0, 0);
+    for (int chunkX = 10; chunkX < 30; ++chunkX) {
+        pipeline.cancelChunk(World::ChunkKey{chunkX, 0, 0});
+    }
+    pipeline.stop();
+    const ChunkStreamingPipelineStats cancelled = pipeline.stats();
+    expectTrue(
+        cancelled.pendingCount == 0u && cancelled.completedCount == 0u && cancelled.drained == keys.size(),
+        "stop() waits out launched jobs and discards their results"
+    );
+}
+
 int main() {
     testGridPrimitives();
     testNetworkGraphAndProceduralUtilities();
@@ -686,11 +3163,35 @@ int main() {
     testChunkMeshingModes();
     testChunkMeshingStats();
     testProceduralWorldGenerationTerrain();
+    testProceduralWorldGenerationGolden();
+    testTerrainPatchCache();
+    testPaletteChunkStorage();
+    testBatchedChunkEdits();
+    testBinaryGreedyMesherMatchesReference();
+    testNeighborAwareMeshing();
+    testMeshingNonDenseCenters();
+    testQuadListChunkMeshes();
+    testParallelWorldDecodeMatchesSerial();
+    testIndexedWorldFileFormat();
+    testBackgroundWorldSave();
+    testResidentChunkStorage();
+    testChunkStorageEviction();
+    testChunkSpillFileCompaction();
+    testVerticalChunkStreaming();
     testClipmapIndex();
+    testClipmapIndexIncrementalSync();
     testSimulationBeltCargoDeterminism();
+    testSegmentBeltCargoMatchesReference();
+    testSegmentBeltCargoOnLargeNetwork();
+    testIncrementalBeltTopology();
+    testBeltLanesAndSideLoading();
+    testBeltCompressionAndThroughput();
     testMagicaVoxelMeshing();
     testMagicaVoxelChunkedMeshing();
+    testMagicaVoxelSceneLoading();
+    testParallelMagicaMeshingAndStamping();
     testVoxelCraftPlayerAndStreaming();
+    testVoxelCraftStreamingPipeline();
 
     if (g_failures != 0) {
         std::cerr << "[foundation test] " << g_failures << " failures\n";
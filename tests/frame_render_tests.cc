@@ -1,14 +1,25 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <vector>
 
+#include "math/math.h"
 #include "render/backend/vulkan/shadow_culling_utils.h"
+#include "render/backend/vulkan/visibility_culling.h"
 #include "world/chunk.h"
 
 namespace {
 
+using odai::math::Vector3;
+
+odai::math::Matrix4 cullingTestViewProjection(const Vector3& eye, const Vector3& target) {
+    const odai::math::Matrix4 projection =
+        odai::math::perspectiveVulkan(odai::math::radians(60.0f), 2.0f, 0.1f, 500.0f);
+    return projection * odai::math::lookAt(eye, target, Vector3{0.0f, 1.0f, 0.0f});
+}
+
 TEST(FrameRenderTest, BuildShadowCandidateMaskReturnsEmptyWhenDisabled) {
     const std::vector<odai::world::Chunk> chunks = {
         odai::world::Chunk(0, 0, 0),
@@ -57,4 +68,220 @@ TEST(FrameRenderTest, BuildShadowCandidateMaskSkipsInvalidVisibleIndices) {
     EXPECT_EQ(candidates[1u], 1u);
 }
 
+TEST(FrameRenderTest, FrustumSoaTestMatchesPerBoxTest) {
+    const odai::math::Matrix4 clipFromWorld =
+        cullingTestViewProjection(Vector3{0.0f, 0.0f, 0.0f}, Vector3{0.0f, 0.0f, -1.0f});
+    const odai::render::CullFrustum frustum = odai::render::extractCullFrustum(clipFromWorld, 0.04f);
+
+    EXPECT_TRUE(odai::render::frustumIntersectsBounds(frustum, Vector3{-1.0f, -1.0f, -12.0f}, Vector3{1.0f, 1.0f, -10.0f}));
+    EXPECT_FALSE(odai::render::frustumIntersectsBounds(frustum, Vector3{-1.0f, -1.0f, 10.0f}, Vector3{1.0f, 1.0f, 12.0f}));
+    // Past the far plane; NDC depth saturates there, so only a zero margin rejects it.
+    EXPECT_TRUE(odai::render::frustumIntersectsBounds(frustum, Vector3{-1.0f, -1.0f, -600.0f}, Vector3{1.0f, 1.0f, -550.0f}));
+    EXPECT_FALSE(odai::render::frustumIntersectsBounds(
+        odai::render::extractCullFrustum(clipFromWorld),
+        Vector3{-1.0f, -1.0f, -600.0f},
+        Vector3{1.0f, 1.0f, -550.0f}));
+    EXPECT_FALSE(odai::render::frustumIntersectsBounds(frustum, Vector3{80.0f, -1.0f, -12.0f}, Vector3{82.0f, 1.0f, -10.0f}));
+    // Straddling the eye plane is still visible.
+    EXPECT_TRUE(odai::render::frustumIntersectsBounds(frustum, Vector3{-1.0f, -1.0f, -1.0f}, Vector3{1.0f, 1.0f, 1.0f}));
+
+    odai::render::CullBoundsSoA bounds;
+    std::uint32_t state = 12345u;
+    const auto nextCoordinate = [&state]() {
+        state = (state * 1664525u) + 1013904223u;
+        return (static_cast<float>(state >> 8) / static_cast<float>(1u << 24)) * 240.0f - 120.0f;
+    };
+    // 103 boxes exercises both the four-wide path and the scalar tail.
+    for (int i = 0; i < 103; ++i) {
+        const Vector3 boundsMin{nextCoordinate(), nextCoordinate(), nextCoordinate()};
+        bounds.push(boundsMin, boundsMin + Vector3{8.0f, 8.0f, 8.0f});
+    }
+    std::vector<std::uint8_t> visible;
+    odai::render::frustumTestBounds(frustum, bounds, visible);
+    ASSERT_EQ(visible.size(), bounds.size());
+    std::size_t visibleCount = 0;
+    for (std::size_t i = 0; i < bounds.size(); ++i) {
+        const bool expected = odai::render::frustumIntersectsBounds(
+            frustum,
+            Vector3{bounds.minX[i], bounds.minY[i], bounds.minZ[i]},
+            Vector3{bounds.maxX[i], bounds.maxY[i], bounds.maxZ[i]});
+        EXPECT_EQ(visible[i], expected ? 1u : 0u) << "box " << i;
+        visibleCount += visible[i];
+    }
+    EXPECT_GT(visibleCount, 0u);
+    EXPECT_LT(visibleCount, bounds.size());
+}
+
+TEST(FrameRenderTest, OcclusionDepthBufferCullsOnlyBoundsBehindOccluder) {
+    const Vector3 eye{0.0f, 0.0f, 0.0f};
+    const odai::math::Matrix4 clipFromWorld = cullingTestViewProjection(eye, Vector3{0.0f, 0.0f, -1.0f});
+    odai::render::OcclusionDepthBuffer depthBuffer;
+    depthBuffer.begin(clipFromWorld, eye);
+    ASSERT_TRUE(depthBuffer.rasterizeOccluderBox(Vector3{-4.0f, -4.0f, -11.0f}, Vector3{4.0f, 4.0f, -10.0f}));
+    // Boxes that cross the near plane or contain the eye are never occluders.
+    EXPECT_FALSE(depthBuffer.rasterizeOccluderBox(Vector3{-1.0f, -1.0f, -1.0f}, Vector3{1.0f, 1.0f, 1.0f}));
+    depthBuffer.buildHierarchy();
+    EXPECT_EQ(depthBuffer.rasterizedOccluderCount(), 1u);
+
+    // The wall covers the screen centre but not the whole screen.
+    const int levelCount = depthBuffer.levelCount();
+    EXPECT_LT(depthBuffer.depthAt(0, depthBuffer.width() / 2, depthBuffer.height() / 2), 1.0f);
+    EXPECT_EQ(depthBuffer.depthAt(levelCount - 1, 0, 0), 1.0f);
+
+    EXPECT_TRUE(depthBuffer.isOccluded(Vector3{-1.0f, -1.0f, -30.0f}, Vector3{1.0f, 1.0f, -28.0f}));
+    EXPECT_TRUE(depthBuffer.isOccluded(Vector3{-3.0f, -3.0f, -14.0f}, Vector3{3.0f, 3.0f, -12.0f}));
+    // In front of the wall, beside it, straddling its edge, or touching it.
+    EXPECT_FALSE(depthBuffer.isOccluded(Vector3{-1.0f, -1.0f, -6.0f}, Vector3{1.0f, 1.0f, -5.0f}));
+    EXPECT_FALSE(depthBuffer.isOccluded(Vector3{14.0f, -1.0f, -30.0f}, Vector3{16.0f, 1.0f, -28.0f}));
+    EXPECT_FALSE(depthBuffer.isOccluded(Vector3{3.0f, -1.0f, -16.0f}, Vector3{9.0f, 1.0f, -14.0f}));
+    EXPECT_FALSE(depthBuffer.isOccluded(Vector3{-1.0f, -1.0f, -10.5f}, Vector3{1.0f, 1.0f, -9.5f}));
+}
+
+TEST(FrameRenderTest, ChunkOccluderBoxesCoverSolidMacroColumns) {
+    using odai::world::Chunk;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+
+    std::vector<odai::render::OccluderBox> boxes;
+    odai::render::appendChunkOccluderBoxes(Chunk(0, 0, 0), boxes);
+    EXPECT_TRUE(boxes.empty());
+
+    Chunk solid(1, -1, 2);
+    solid.fill(Voxel{VoxelType::Stone});
+    odai::render::appendChunkOccluderBoxes(solid, boxes);
+    ASSERT_EQ(boxes.size(), 1u);
+    EXPECT_EQ(boxes[0].boundsMin.x, 32.0f);
+    EXPECT_EQ(boxes[0].boundsMin.y, -32.0f);
+    EXPECT_EQ(boxes[0].boundsMin.z, 64.0f);
+    EXPECT_EQ(boxes[0].boundsMax.x, 64.0f);
+    EXPECT_EQ(boxes[0].boundsMax.y, 0.0f);
+    EXPECT_EQ(boxes[0].boundsMax.z, 96.0f);
+
+    // One solid macro layer, with one column also solid in the next layer up
+    // and leaves (never an occluder) filling another column's second layer.
+    Chunk ground(0, 0, 0);
+    ground.beginEdit();
+    for (int y = 0; y < 8; ++y) {
+        ground.fillLayer(y, Voxel{VoxelType::Dirt});
+    }
+    for (int y = 8; y < 16; ++y) {
+        for (int z = 0; z < 8; ++z) {
+            for (int x = 0; x < 8; ++x) {
+                ground.setVoxel(x + 8, y, z, Voxel{VoxelType::Stone});
+                ground.setVoxel(x, y, z + 24, Voxel{VoxelType::Leaves});
+            }
+        }
+    }
+    ground.endEdit();
+    boxes.clear();
+    odai::render::appendChunkOccluderBoxes(ground, boxes);
+    float coveredVolume = 0.0f;
+    float tallestBox = 0.0f;
+    for (const odai::render::OccluderBox& box : boxes) {
+        const Vector3 extent = box.boundsMax - box.boundsMin;
+        coveredVolume += extent.x * extent.y * extent.z;
+        tallestBox = std::max(tallestBox, extent.y);
+        EXPECT_EQ(box.boundsMin.y, 0.0f);
+    }
+    EXPECT_EQ(coveredVolume, (32.0f * 32.0f * 8.0f) + (8.0f * 8.0f * 8.0f));
+    EXPECT_EQ(tallestBox, 16.0f);
+    EXPECT_LE(boxes.size(), 4u);
+}
+
+TEST(FrameRenderTest, VisibilityCullerCullsChunksBehindSolidWall) {
+    using odai::world::Chunk;
+    using odai::world::Voxel;
+    using odai::world::VoxelType;
+
+    // A 3x3 wall of solid chunks at z = -2 hides the row of mostly empty
+    // chunks at z = -5; chunks beside the wall and behind the camera are not.
+    std::vector<Chunk> chunks;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            chunks.emplace_back(x, y, -2);
+            chunks.back().fill(Voxel{VoxelType::Stone});
+        }
+    }
+    const std::size_t hiddenBegin = chunks.size();
+    chunks.emplace_back(0, 0, -5);
+    chunks.emplace_back(-1, 0, -5);
+    const std::size_t sideChunk = chunks.size();
+    chunks.emplace_back(6, 0, -5);
+    const std::size_t behindCamera = chunks.size();
+    chunks.emplace_back(0, 0, 3);
+
+    const Vector3 eye{16.0f, 16.0f, 10.0f};
+    const odai::math::Matrix4 clipFromWorld = cullingTestViewProjection(eye, Vector3{16.0f, 16.0f, -100.0f});
+    odai::render::VisibilityCuller culler;
+    std::vector<std::size_t> visibleChunkIndices;
+    odai::world::SpatialQueryStats stats{};
+    culler.cullChunks(chunks, {}, clipFromWorld, eye, visibleChunkIndices, stats);
+
+    const auto isVisible = [&](std::size_t chunkIndex) {
+        return std::find(visibleChunkIndices.begin(), visibleChunkIndices.end(), chunkIndex) != visibleChunkIndices.end();
+    };
+    EXPECT_FALSE(isVisible(hiddenBegin));
+    EXPECT_FALSE(isVisible(hiddenBegin + 1));
+    EXPECT_TRUE(isVisible(sideChunk));
+    EXPECT_FALSE(isVisible(behindCamera));
+    EXPECT_TRUE(isVisible(4u));
+    EXPECT_EQ(stats.frustumCulledChunkCount, 1u);
+    EXPECT_EQ(stats.occlusionCulledChunkCount, 2u);
+    EXPECT_GT(stats.occluderCount, 0u);
+    EXPECT_EQ(visibleChunkIndices.size() + stats.frustumCulledChunkCount + stats.occlusionCulledChunkCount, chunks.size());
+
+    // Candidate lists keep their order, and disabling occlusion keeps
+    // everything inside the frustum.
+    const std::vector<std::size_t> candidates = {sideChunk, hiddenBegin, 4u};
+    culler.settings().occlusionEnabled = false;
+    odai::world::SpatialQueryStats frustumOnlyStats{};
+    culler.cullChunks(chunks, candidates, clipFromWorld, eye, visibleChunkIndices, frustumOnlyStats);
+    EXPECT_EQ(visibleChunkIndices, candidates);
+    EXPECT_EQ(frustumOnlyStats.occlusionCulledChunkCount, 0u);
+    EXPECT_EQ(frustumOnlyStats.occluderCount, 0u);
+}
+
+TEST(FrameRenderTest, VisibilityCullerUsesTerrainPagesAsOccluders) {
+    // A terrain page whose lowest point is y = 0 hides a static page sunk
+    // below it when seen from above, but not when the camera is underneath.
+    odai::render::CullBoundsSoA pages;
+    pages.push(Vector3{-64.0f, 0.0f, -96.0f}, Vector3{64.0f, 12.0f, 32.0f});
+    pages.push(Vector3{-8.0f, -80.0f, -48.0f}, Vector3{8.0f, -60.0f, -32.0f});
+    pages.push(Vector3{-8.0f, 14.0f, -48.0f}, Vector3{8.0f, 20.0f, -32.0f});
+    const std::vector<std::uint8_t> terrainPageMask = {1u, 0u, 0u};
+
+    odai::render::VisibilityCuller culler;
+    std::vector<std::uint8_t> visible;
+    odai::world::SpatialQueryStats stats{};
+    const Vector3 eye{0.0f, 40.0f, 20.0f};
+    culler.cullPages(
+        pages,
+        terrainPageMask,
+        cullingTestViewProjection(eye, Vector3{0.0f, 0.0f, -40.0f}),
+        eye,
+        0.04f,
+        visible,
+        stats);
+    ASSERT_EQ(visible.size(), 3u);
+    EXPECT_EQ(visible[0], 1u);
+    EXPECT_EQ(visible[1], 0u);
+    EXPECT_EQ(visible[2], 1u);
+    EXPECT_EQ(stats.occlusionCulledPageCount, 1u);
+    EXPECT_EQ(stats.frustumCulledPageCount, 0u);
+    EXPECT_EQ(stats.occluderCount, 1u);
+
+    const Vector3 underEye{0.0f, -30.0f, 20.0f};
+    odai::world::SpatialQueryStats underStats{};
+    culler.cullPages(
+        pages,
+        terrainPageMask,
+        cullingTestViewProjection(underEye, Vector3{0.0f, -70.0f, -40.0f}),
+        underEye,
+        0.04f,
+        visible,
+        underStats);
+    EXPECT_EQ(visible[1], 1u);
+    EXPECT_EQ(underStats.occluderCount, 0u);
+}
+
 }  // namespace
@@ -1,8 +1,15 @@
 #include "core/job_system.h"
+#include "core/parallel_for.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -74,6 +81,239 @@ void testWaitIdleWithNoWork() {
     expectTrue(true, "waitIdle with an empty queue returns immediately");
 }
 
+void testJobInlineStorage() {
+    int hits = 0;
+    odai::core::Job small([&hits]() { ++hits; });
+    expectTrue(!small.isHeapAllocated(), "a pointer-sized capture is stored inline");
+
+    std::array<std::uint64_t, 32> bulk{};
+    bulk[31] = 7u;
+    odai::core::Job large([&hits, bulk]() { hits += static_cast<int>(bulk[31]); });
+    expectTrue(large.isHeapAllocated(), "a capture larger than kInlineBytes falls back to the heap");
+
+    // Move-only captures work, which std::function never allowed.
+    auto owned = std::make_unique<int>(5);
+    odai::core::Job moveOnly([&hits, owned = std::move(owned)]() { hits += *owned; });
+    odai::core::Job moved = std::move(moveOnly);
+    expectTrue(!moveOnly, "a moved-from job is empty");
+
+    small();
+    large();
+    moved();
+    expectTrue(hits == 1 + 7 + 5, "inline, heap and move-only jobs all invoke their callable");
+}
+
+// One worker, held busy by a gate job, so everything else queues on its deque
+// and the lane order is observable.
+void testPriorityLanesRunUrgentWorkFirst() {
+    odai::core::JobSystem jobs(1);
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    jobs.enqueue([&gate]() { std::lock_guard<std::mutex> wait(gate); });
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    const auto record = [&](int value) {
+        return [&orderMutex, &order, value]() {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(value);
+        };
+    };
+    jobs.enqueue(record(2), odai::core::JobPriority::Low);
+    jobs.enqueue(record(1), odai::core::JobPriority::Normal);
+    jobs.enqueue(record(0), odai::core::JobPriority::High);
+    jobs.enqueue(record(3), odai::core::JobPriority::Low);
+    hold.unlock();
+    jobs.waitIdle();
+
+    const std::vector<int> expected{0, 1, 2, 3};
+    expectTrue(order == expected, "lanes drain High, then Normal, then Low, FIFO within a lane");
+}
+
+void testCounterWaitsForOneGroup() {
+    odai::core::JobSystem jobs(3);
+    odai::core::JobCounter counter;
+    std::atomic<int> done{0};
+    for (int i = 0; i < 32; ++i) {
+        jobs.enqueue([&done]() {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            done.fetch_add(1, std::memory_order_relaxed);
+        }, odai::core::JobPriority::Normal, &counter);
+    }
+    jobs.wait(counter);
+    expectTrue(counter.done(), "wait returns with the counter at zero");
+    expectTrue(done.load() == 32, "wait observes every job signalling the counter");
+}
+
+// generate -> mesh -> grass scatter, expressed as counters instead of a
+// hand-rolled state machine. Each stage fans out and must see the previous
+// stage complete.
+void testDependencyChainOrdering(unsigned threadCount) {
+    odai::core::JobSystem jobs(threadCount);
+    odai::core::JobCounter generated;
+    odai::core::JobCounter meshed;
+    odai::core::JobCounter scattered;
+    std::atomic<int> generateDone{0};
+    std::atomic<int> meshDone{0};
+    std::atomic<bool> orderViolated{false};
+    constexpr int kChunks = 16;
+
+    for (int i = 0; i < kChunks; ++i) {
+        jobs.enqueue([&generateDone]() { generateDone.fetch_add(1); }, odai::core::JobPriority::Low, &generated);
+    }
+    for (int i = 0; i < kChunks; ++i) {
+        jobs.enqueueAfter(generated, [&]() {
+            if (generateDone.load() != kChunks) {
+                orderViolated.store(true);
+            }
+            meshDone.fetch_add(1);
+        }, odai::core::JobPriority::Normal, &meshed);
+    }
+    jobs.enqueueAfter(meshed, [&]() {
+        if (meshDone.load() != kChunks) {
+            orderViolated.store(true);
+        }
+    }, odai::core::JobPriority::Normal, &scattered);
+
+    jobs.wait(scattered);
+    expectTrue(!orderViolated.load(), "each stage starts only after its dependency counter reached zero");
+    expectTrue(generated.done() && meshed.done() && scattered.done(), "every counter in the chain completed");
+
+    // A dependency that already completed releases the job immediately.
+    std::atomic<bool> ranLate{false};
+    odai::core::JobCounter late;
+    jobs.enqueueAfter(generated, [&ranLate]() { ranLate.store(true); }, odai::core::JobPriority::Normal, &late);
+    jobs.wait(late);
+    expectTrue(ranLate.load(), "enqueueAfter on a finished counter runs the job");
+}
+
+// Jobs that fan out from inside a job, then wait on their children: the
+// waiting job must help run queued work instead of deadlocking the pool.
+void testNestedWaitHelpsInsteadOfDeadlocking() {
+    odai::core::JobSystem jobs(2);
+    std::atomic<int> leaves{0};
+    odai::core::JobCounter roots;
+    for (int root = 0; root < 4; ++root) {
+        jobs.enqueue([&jobs, &leaves]() {
+            odai::core::JobCounter children;
+            for (int child = 0; child < 8; ++child) {
+                jobs.enqueue([&leaves]() { leaves.fetch_add(1); }, odai::core::JobPriority::Normal, &children);
+            }
+            jobs.wait(children);
+        }, odai::core::JobPriority::Normal, &roots);
+    }
+    jobs.wait(roots);
+    expectTrue(leaves.load() == 32, "nested fan-out completes with waits inside jobs");
+}
+
+void testSynchronousModeContinuationsRunInline() {
+    odai::core::JobSystem jobs(0);
+    odai::core::JobCounter first;
+    std::vector<int> order;
+    jobs.enqueue([&order]() { order.push_back(0); }, odai::core::JobPriority::Low, &first);
+    jobs.enqueueAfter(first, [&order]() { order.push_back(1); });
+    jobs.wait(first);
+    const std::vector<int> expected{0, 1};
+    expectTrue(order == expected, "synchronous mode runs a chain inline in dependency order");
+    expectTrue(jobs.stats().jobsExecuted == 2u, "synchronous mode counts executed jobs");
+}
+
+// Many tiny jobs submitted from the main thread and from inside jobs: nothing
+// is lost or run twice under contention, and none of them touch the heap.
+// odai_job_bench times the same workload.
+void testContentionRunsEveryJobOnce() {
+    const unsigned workerCount = std::max(2u, std::thread::hardware_concurrency());
+    odai::core::JobSystem jobs(workerCount);
+    constexpr int kProducerJobs = 64;
+    constexpr int kJobsPerProducer = 2048;
+    std::atomic<std::int64_t> sum{0};
+
+    odai::core::JobCounter all;
+    for (int producer = 0; producer < kProducerJobs; ++producer) {
+        jobs.enqueue([&jobs, &sum, &all]() {
+            for (int i = 0; i < kJobsPerProducer; ++i) {
+                jobs.enqueue([&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); },
+                             odai::core::JobPriority::Normal, &all);
+            }
+        }, odai::core::JobPriority::High, &all);
+    }
+    jobs.wait(all);
+
+    const std::int64_t expectedSum =
+        static_cast<std::int64_t>(kProducerJobs) * ((static_cast<std::int64_t>(kJobsPerProducer) - 1) * kJobsPerProducer / 2);
+    expectTrue(sum.load() == expectedSum, "contended submission ran every job exactly once");
+    expectTrue(jobs.stats().heapAllocatedJobs == 0u, "small contended jobs never touch the heap");
+}
+
+void testParallelForCoversEveryIndexOnce(unsigned threadCount) {
+    odai::core::JobSystem jobs(threadCount);
+    constexpr std::size_t kCount = 1000;
+    std::vector<std::atomic<int>> hits(kCount);
+    odai::core::parallelFor(jobs, 0, kCount, 7, [&hits](std::size_t index) {
+        hits[index].fetch_add(1, std::memory_order_relaxed);
+    });
+    bool exactlyOnce = true;
+    for (const std::atomic<int>& hit : hits) {
+        exactlyOnce = exactlyOnce && hit.load() == 1;
+    }
+    expectTrue(exactlyOnce, "parallelFor visits every index exactly once");
+
+    int emptyCalls = 0;
+    odai::core::parallelFor(jobs, 5, 5, 4, [&emptyCalls](std::size_t) { ++emptyCalls; });
+    expectTrue(emptyCalls == 0, "an empty range runs nothing");
+
+    std::atomic<int> zeroGrainHits{0};
+    odai::core::parallelFor(jobs, 0, 10, 0, [&zeroGrainHits](std::size_t) { zeroGrainHits.fetch_add(1); });
+    expectTrue(zeroGrainHits.load() == 10, "grain 0 is treated as grain 1");
+}
+
+// A float sum is order-sensitive, so this only holds because the partition
+// and fold order depend on the grain alone.
+void testParallelReduceIsDeterministicAcrossWorkerCounts() {
+    std::vector<float> values(4099);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = 1.0f / static_cast<float>(i + 1u) * ((i % 3u) == 0u ? -1.0f : 1.0f);
+    }
+    const auto sumRange = [&values](std::size_t begin, std::size_t end) {
+        float partial = 0.0f;
+        for (std::size_t i = begin; i < end; ++i) {
+            partial += values[i];
+        }
+        return partial;
+    };
+    const auto add = [](float a, float b) { return a + b; };
+
+    float reference = 0.0f;
+    bool identical = true;
+    for (unsigned threadCount : {0u, 1u, 3u, 4u}) {
+        odai::core::JobSystem jobs(threadCount);
+        for (int repeat = 0; repeat < 4; ++repeat) {
+            const float sum = odai::core::parallelReduce(jobs, 0, values.size(), 64, 0.0f, sumRange, add);
+            if (threadCount == 0u && repeat == 0) {
+                reference = sum;
+            }
+            identical = identical && std::memcmp(&sum, &reference, sizeof(float)) == 0;
+        }
+    }
+    expectTrue(identical, "parallelReduce is bit-identical for any worker count");
+}
+
+void testTaskGroupWaitsForItsJobsOnly() {
+    odai::core::JobSystem jobs(2);
+    std::atomic<int> grouped{0};
+    {
+        odai::core::TaskGroup group(jobs, odai::core::JobPriority::High);
+        for (int i = 0; i < 16; ++i) {
+            group.run([&grouped]() { grouped.fetch_add(1); });
+        }
+        group.wait();
+        expectTrue(grouped.load() == 16, "TaskGroup::wait observes every job in the group");
+        group.run([&grouped]() { grouped.fetch_add(1); });
+        // No explicit wait: the destructor joins.
+    }
+    expectTrue(grouped.load() == 17, "TaskGroup destructor waits for outstanding jobs");
+}
+
 } // namespace
 
 int main() {
@@ -81,6 +321,18 @@ int main() {
     testThreadedJobsAllRun();
     testDestructorDrainsQueuedJobs();
     testWaitIdleWithNoWork();
+    testJobInlineStorage();
+    testPriorityLanesRunUrgentWorkFirst();
+    testCounterWaitsForOneGroup();
+    testDependencyChainOrdering(0);
+    testDependencyChainOrdering(4);
+    testNestedWaitHelpsInsteadOfDeadlocking();
+    testSynchronousModeContinuationsRunInline();
+    testParallelForCoversEveryIndexOnce(0);
+    testParallelForCoversEveryIndexOnce(4);
+    testParallelReduceIsDeterministicAcrossWorkerCounts();
+    testTaskGroupWaitsForItsJobsOnly();
+    testContentionRunsEveryJobOnce();
 
     if (g_failures != 0) {
         std::cerr << "[job system test] " << g_failures << " failures\n";
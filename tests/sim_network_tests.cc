@@ -1,8 +1,20 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
 #include "core/grid3.h"
+#include "core/job_system.h"
+#include "sim/network_graph.h"
 #include "sim/network_procedural.h"
 #include "sim/pipe.h"
+#include "sim/pipe_fluid_solver.h"
+#include "sim/rail_traffic.h"
+#include "tools/sim_network_layouts.h"
 
 namespace {
 
@@ -12,6 +24,85 @@ void ExpectCell(const odai::core::Cell3i& cell, int x, int y, int z) {
     EXPECT_EQ(cell.z, z);
 }
 
+odai::sim::NodeId AddNetworkNode(odai::sim::NetworkGraph& graph, int x, int y, int z) {
+    return graph.addNode(odai::sim::Socket{.cell = odai::core::Cell3i{x, y, z}});
+}
+
+odai::sim::EdgeId AddPipeEdge(
+    odai::sim::NetworkGraph& graph,
+    odai::sim::PipeFluidSolver& solver,
+    odai::sim::NodeId a,
+    odai::sim::NodeId b,
+    std::uint16_t capacityUnitsPerTick
+) {
+    const odai::sim::EdgeId edgeId = graph.addEdge(
+        a,
+        b,
+        odai::sim::EdgeSpan{.start = graph.nodes()[a].socket.cell, .dir = odai::core::Dir6::PosX},
+        odai::sim::NetworkKind::Pipe
+    );
+    solver.setEdgeData(edgeId, odai::sim::PipeEdgeData{.capacityUnitsPerTick = capacityUnitsPerTick});
+    return edgeId;
+}
+
+odai::sim::EdgeId AddRailEdge(
+    odai::sim::NetworkGraph& graph,
+    odai::sim::RailTrafficSim& rail,
+    odai::sim::NodeId a,
+    odai::sim::NodeId b,
+    std::uint16_t lengthVoxels,
+    const odai::sim::RailEdgeData& data
+) {
+    const odai::sim::EdgeId edgeId = graph.addEdge(
+        a,
+        b,
+        odai::sim::EdgeSpan{.start = graph.nodes()[a].socket.cell, .dir = odai::core::Dir6::PosX, .lengthVoxels = lengthVoxels},
+        odai::sim::NetworkKind::Rail
+    );
+    rail.setEdgeData(edgeId, data);
+    return edgeId;
+}
+
+odai::sim::RailTrainDesc MakeRailTrain(
+    odai::sim::EdgeId startEdge,
+    std::uint16_t startAlongQ8,
+    bool forward,
+    std::uint16_t speedQ8,
+    std::vector<odai::sim::NodeId> stops
+) {
+    odai::sim::RailTrainDesc desc;
+    desc.cars.push_back(odai::sim::TrainCar{.carId = 1, .lengthQ8 = 512});
+    desc.cars.push_back(odai::sim::TrainCar{.carId = 2, .lengthQ8 = 512});
+    desc.start = odai::sim::TrackParam{.edgeId = startEdge, .distanceAlongQ8 = startAlongQ8, .forward = forward};
+    desc.speedQ8 = speedQ8;
+    desc.stops = std::move(stops);
+    return desc;
+}
+
+// Asserts no edge or switch group is under, or reserved for, two trains.
+void ExpectNoSharedTrack(
+    const odai::sim::NetworkGraph& graph,
+    const odai::sim::RailTrafficSim& rail,
+    const std::vector<std::uint16_t>& switchGroupByEdge,
+    std::uint64_t tick
+) {
+    std::vector<odai::sim::TrainId> edgeOwner(graph.edges().size(), odai::sim::kInvalidTrainId);
+    std::vector<odai::sim::TrainId> switchOwner(65536u, odai::sim::kInvalidTrainId);
+    for (odai::sim::TrainId trainId = 0; trainId < rail.trainCount(); ++trainId) {
+        for (const odai::sim::EdgeId edgeId : rail.trainPathEdges(trainId)) {
+            ASSERT_TRUE(edgeOwner[edgeId] == odai::sim::kInvalidTrainId || edgeOwner[edgeId] == trainId)
+                << "edge " << edgeId << " shared by trains " << edgeOwner[edgeId] << " and " << trainId << " at tick " << tick;
+            edgeOwner[edgeId] = trainId;
+            const std::uint16_t group = edgeId < switchGroupByEdge.size() ? switchGroupByEdge[edgeId] : 0u;
+            if (group != 0u) {
+                ASSERT_TRUE(switchOwner[group] == odai::sim::kInvalidTrainId || switchOwner[group] == trainId)
+                    << "switch " << group << " shared by trains " << switchOwner[group] << " and " << trainId << " at tick " << tick;
+                switchOwner[group] = trainId;
+            }
+        }
+    }
+}
+
 } // namespace
 
 TEST(SimNetworkProceduralTest, NeighborMask6FlagsAdjacentCells) {
@@ -95,3 +186,306 @@ TEST(SimNetworkProceduralTest, ClassifyJoinPieceCategories) {
         sim::JoinPiece::Cross
     );
 }
+
+TEST(SimNetworkGraphTest, AdjacencyMatchesEdgesAndTracksTopologyVersion) {
+    using namespace odai;
+
+    sim::NetworkGraph graph;
+    sim::PipeFluidSolver solver;
+    const std::uint64_t emptyVersion = graph.topologyVersion();
+    tools::addPipeGrid(graph, solver, 4, 3, 10);
+    const sim::NodeId loopNode = AddNetworkNode(graph, 9, 0, 9);
+    AddPipeEdge(graph, solver, loopNode, loopNode, 10);
+    EXPECT_GT(graph.topologyVersion(), emptyVersion);
+
+    const sim::NetworkAdjacency& adjacency = graph.adjacency();
+    ASSERT_EQ(adjacency.offsets.size(), graph.nodeCount() + 1u);
+    for (sim::NodeId nodeId = 0; nodeId < graph.nodeCount(); ++nodeId) {
+        std::vector<sim::EdgeId> expected;
+        for (sim::EdgeId edgeId = 0; edgeId < graph.edges().size(); ++edgeId) {
+            if (graph.edgeConnectsNode(edgeId, nodeId)) {
+                expected.push_back(edgeId);
+            }
+        }
+        const std::span<const sim::EdgeId> row = graph.edgesForNode(nodeId);
+        EXPECT_EQ(std::vector<sim::EdgeId>(row.begin(), row.end()), expected) << "node " << nodeId;
+    }
+    EXPECT_EQ(graph.edgesForNode(loopNode).size(), 1u);
+
+    const std::uint64_t builtVersion = graph.topologyVersion();
+    const sim::NodeId extra = AddNetworkNode(graph, 20, 0, 20);
+    EXPECT_GT(graph.topologyVersion(), builtVersion);
+    EXPECT_TRUE(graph.edgesForNode(extra).empty());
+    EXPECT_EQ(graph.adjacency().offsets.size(), graph.nodeCount() + 1u);
+}
+
+TEST(SimPipeFluidSolverTest, ConservesFluidAndRespectsEdgeCapacity) {
+    using namespace odai;
+
+    sim::NetworkGraph graph;
+    sim::PipeFluidSolver solver;
+    tools::addPipeGrid(graph, solver, 6, 6, 7);
+    solver.setNodeSupply(0, 120);
+    solver.setNodeSupply(35, -40);
+    solver.setNodeSupply(5, -3);
+
+    std::uint64_t previousTotal = solver.totalUnits();
+    for (int tick = 0; tick < 400; ++tick) {
+        solver.tick(graph);
+        const sim::PipeFluidTickStats& stats = solver.lastTickStats();
+        ASSERT_EQ(solver.totalUnits(), previousTotal + stats.suppliedUnits - stats.drainedUnits) << "tick " << tick;
+        previousTotal = solver.totalUnits();
+        for (const sim::PipeEdgeRuntimeState& state : solver.edgeStates()) {
+            ASSERT_LE(state.inUnits, 7u);
+            ASSERT_LE(state.outUnits, 7u);
+            ASSERT_TRUE(state.inUnits == 0u || state.outUnits == 0u);
+        }
+        for (sim::NodeId nodeId = 0; nodeId < graph.nodeCount(); ++nodeId) {
+            ASSERT_LE(solver.nodeUnits(nodeId), sim::PipeFluidSettings{}.nodeBufferUnits);
+        }
+    }
+    EXPECT_GT(solver.lastTickStats().drainedUnits, 0u);
+    EXPECT_EQ(solver.snapshotBuildCount(), 1u);
+}
+
+TEST(SimPipeFluidSolverTest, NodesAddedAfterSnapshotReportTheirUnits) {
+    using namespace odai;
+
+    sim::NetworkGraph graph;
+    sim::PipeFluidSolver solver;
+    tools::addPipeGrid(graph, solver, 3, 1, 10);
+    solver.setNodeUnits(0, 300);
+    solver.tick(graph);
+
+    const sim::NodeId late = AddNetworkNode(graph, 5, 0, 0);
+    solver.setNodeUnits(late, 200);
+    EXPECT_EQ(solver.nodeUnits(late), 200u);
+    EXPECT_EQ(solver.totalUnits(), 500u);
+    solver.tick(graph);
+    EXPECT_EQ(solver.nodeUnits(late), 200u);
+    EXPECT_EQ(solver.totalUnits(), 500u);
+}
+
+TEST(SimPipeFluidSolverTest, ClosedNetworkLevelsOut) {
+    using namespace odai;
+
+    sim::NetworkGraph graph;
+    sim::PipeFluidSolver solver;
+    tools::addPipeGrid(graph, solver, 5, 1, 200);
+    solver.setNodeUnits(0, 500);
+    solver.tick(graph);
+    EXPECT_EQ(solver.edgeStates()[0].inUnits, 166u);
+
+    for (int tick = 0; tick < 500; ++tick) {
+        solver.tick(graph);
+    }
+    EXPECT_EQ(solver.totalUnits(), 500u);
+    for (sim::NodeId nodeId = 0; nodeId + 1u < graph.nodeCount(); ++nodeId) {
+        // Integer division leaves differences smaller than the divisor (3).
+        const std::int64_t difference = static_cast<std::int64_t>(solver.nodeUnits(nodeId)) -
+                                        static_cast<std::int64_t>(solver.nodeUnits(nodeId + 1u));
+        EXPECT_LT(difference < 0 ? -difference : difference, 3) << "node " << nodeId;
+    }
+    EXPECT_NEAR(static_cast<double>(solver.nodeUnits(2)), 100.0, 4.0);
+}
+
+TEST(SimPipeFluidSolverTest, ClosedEdgesAndSeparateComponentsStayIsolated) {
+    using namespace odai;
+
+    sim::NetworkGraph graph;
+    sim::PipeFluidSolver solver;
+    const sim::NodeId a = AddNetworkNode(graph, 0, 0, 0);
+    const sim::NodeId b = AddNetworkNode(graph, 1, 0, 0);
+    const sim::NodeId c = AddNetworkNode(graph, 5, 0, 0);
+    const sim::NodeId d = AddNetworkNode(graph, 6, 0, 0);
+    const sim::EdgeId closed = AddPipeEdge(graph, solver, a, b, 0);
+    AddPipeEdge(graph, solver, c, d, 50);
+    solver.setNodeUnits(a, 400);
+    solver.setNodeUnits(c, 200);
+
+    for (int tick = 0; tick < 20; ++tick) {
+        solver.tick(graph);
+    }
+    EXPECT_EQ(solver.componentCount(), 2u);
+    EXPECT_EQ(solver.nodeUnits(a), 400u);
+    EXPECT_EQ(solver.nodeUnits(b), 0u);
+    EXPECT_EQ(solver.nodeUnits(c) + solver.nodeUnits(d), 200u);
+    EXPECT_EQ(solver.nodeUnits(d), 100u);
+
+    // Opening the valve only changes capacity, so the snapshot is reused.
+    solver.setEdgeData(closed, sim::PipeEdgeData{.capacityUnitsPerTick = 50});
+    solver.tick(graph);
+    EXPECT_EQ(solver.nodeUnits(b), 50u);
+    EXPECT_EQ(solver.snapshotBuildCount(), 1u);
+
+    // Joining the components rebuilds the snapshot and keeps every level.
+    AddPipeEdge(graph, solver, b, c, 50);
+    const std::uint64_t total = solver.totalUnits();
+    solver.tick(graph);
+    EXPECT_EQ(solver.snapshotBuildCount(), 2u);
+    EXPECT_EQ(solver.componentCount(), 1u);
+    EXPECT_EQ(solver.totalUnits(), total);
+}
+
+TEST(SimPipeFluidSolverTest, ParallelTickMatchesSerialTick) {
+    using namespace odai;
+
+    sim::NetworkGraph graph;
+    sim::PipeFluidSolver serial;
+    for (int network = 0; network < 24; ++network) {
+        tools::addPipeGrid(graph, serial, 30 + network, 20, static_cast<std::uint16_t>(4 + (network % 5)));
+    }
+    sim::PipeFluidSolver parallel = serial;
+    for (sim::NodeId nodeId = 0; nodeId < graph.nodeCount(); nodeId += 97u) {
+        const std::int32_t supply = (nodeId % 2u == 0u) ? 60 : -25;
+        serial.setNodeSupply(nodeId, supply);
+        parallel.setNodeSupply(nodeId, supply);
+    }
+
+    core::JobSystem jobs(3);
+    for (int tick = 0; tick < 60; ++tick) {
+        serial.tick(graph);
+        parallel.tick(graph, &jobs);
+        ASSERT_EQ(serial.lastTickStats().movedUnits, parallel.lastTickStats().movedUnits) << "tick " << tick;
+        ASSERT_EQ(serial.lastTickStats().drainedUnits, parallel.lastTickStats().drainedUnits) << "tick " << tick;
+    }
+    EXPECT_EQ(serial.componentCount(), 24u);
+    EXPECT_EQ(serial.totalUnits(), parallel.totalUnits());
+    for (sim::NodeId nodeId = 0; nodeId < graph.nodeCount(); ++nodeId) {
+        ASSERT_EQ(serial.nodeUnits(nodeId), parallel.nodeUnits(nodeId)) << "node " << nodeId;
+    }
+}
+
+TEST(SimPipeFluidSolverTest, LargeNetworkReusesItsSnapshotAcrossTicks) {
+    using namespace odai;
+
+    // odai_sim_network_bench times this layout against the 1 ms/tick target.
+    sim::NetworkGraph graph;
+    sim::PipeFluidSolver solver;
+    tools::buildLargePipeNetwork(graph, solver);
+
+    solver.tick(graph);
+    for (int tick = 0; tick < 50; ++tick) {
+        solver.tick(graph);
+    }
+    EXPECT_EQ(solver.componentCount(), 16u);
+    EXPECT_EQ(solver.snapshotBuildCount(), 1u);
+}
+
+TEST(SimRailTrafficTest, SwitchGroupAdmitsOneTrainAtATime) {
+    using namespace odai;
+
+    // Two one-way feeders merge through switch group 7 onto a shared exit.
+    sim::NetworkGraph graph;
+    sim::RailTrafficSim rail(sim::RailTrafficSettings{.dwellTicks = 0});
+    const sim::NodeId feedA = AddNetworkNode(graph, 0, 0, 0);
+    const sim::NodeId joinA = AddNetworkNode(graph, 8, 0, 0);
+    const sim::NodeId feedB = AddNetworkNode(graph, 0, 0, 4);
+    const sim::NodeId joinB = AddNetworkNode(graph, 8, 0, 4);
+    const sim::NodeId merge = AddNetworkNode(graph, 10, 0, 2);
+    const sim::NodeId exit = AddNetworkNode(graph, 30, 0, 2);
+    const sim::RailEdgeData plain{.oneWay = true};
+    const sim::RailEdgeData switchEdge{.segmentClass = sim::RailSegmentClass::Switch, .switchGroupId = 7, .oneWay = true};
+    const sim::EdgeId feederA = AddRailEdge(graph, rail, feedA, joinA, 8, plain);
+    const sim::EdgeId feederB = AddRailEdge(graph, rail, feedB, joinB, 8, plain);
+    const sim::EdgeId switchA = AddRailEdge(graph, rail, joinA, merge, 2, switchEdge);
+    const sim::EdgeId switchB = AddRailEdge(graph, rail, joinB, merge, 2, switchEdge);
+    const sim::EdgeId exitEdge = AddRailEdge(graph, rail, merge, exit, 20, plain);
+
+    const sim::TrainId first = rail.addTrain(graph, MakeRailTrain(feederA, 7u * 256u, true, 128, {exit}));
+    const sim::TrainId second = rail.addTrain(graph, MakeRailTrain(feederB, 7u * 256u, true, 128, {exit}));
+    ASSERT_NE(first, sim::kInvalidTrainId);
+    ASSERT_NE(second, sim::kInvalidTrainId);
+    EXPECT_EQ(rail.addTrain(graph, MakeRailTrain(feederA, 0, true, 128, {exit})), sim::kInvalidTrainId);
+    EXPECT_EQ(rail.addTrain(graph, MakeRailTrain(exitEdge, 0, false, 128, {feedA})), sim::kInvalidTrainId);
+
+    std::vector<std::uint16_t> switchGroupByEdge(graph.edges().size(), 0u);
+    switchGroupByEdge[switchA] = 7;
+    switchGroupByEdge[switchB] = 7;
+    bool sawBlocked = false;
+    for (std::uint64_t tick = 0; tick < 200; ++tick) {
+        rail.tick(graph);
+        ExpectNoSharedTrack(graph, rail, switchGroupByEdge, tick);
+        sawBlocked = sawBlocked || rail.lastTickStats().blockedTrains > 0u;
+        EXPECT_EQ(rail.lastTickStats().deadlockedTrains, 0u);
+    }
+    // The merge reservation runs through the switch onto the exit block, so
+    // the second train waits until the first has left it entirely.
+    EXPECT_TRUE(sawBlocked);
+    EXPECT_EQ(rail.trainArrivals(first), 1u);
+    EXPECT_EQ(rail.trainArrivals(second), 0u);
+    EXPECT_EQ(rail.trainHead(first).edgeId, exitEdge);
+    EXPECT_EQ(rail.edgeBlockState(exitEdge).reservedByTrainId, first);
+    EXPECT_FALSE(rail.edgeBlockState(switchA).reserved);
+    EXPECT_EQ(rail.routeTableCount(), 1u);
+}
+
+TEST(SimRailTrafficTest, HeadOnTrainsOnSingleTrackReportDeadlock) {
+    using namespace odai;
+
+    sim::NetworkGraph graph;
+    sim::RailTrafficSim rail;
+    const sim::NodeId west = AddNetworkNode(graph, 0, 0, 0);
+    const sim::NodeId middle = AddNetworkNode(graph, 10, 0, 0);
+    const sim::NodeId east = AddNetworkNode(graph, 20, 0, 0);
+    const sim::EdgeId westEdge = AddRailEdge(graph, rail, west, middle, 10, sim::RailEdgeData{});
+    const sim::EdgeId eastEdge = AddRailEdge(graph, rail, middle, east, 10, sim::RailEdgeData{});
+
+    const sim::TrainId eastbound = rail.addTrain(graph, MakeRailTrain(westEdge, 5u * 256u, true, 64, {east}));
+    const sim::TrainId westbound = rail.addTrain(graph, MakeRailTrain(eastEdge, 5u * 256u, false, 64, {west}));
+    ASSERT_NE(eastbound, sim::kInvalidTrainId);
+    ASSERT_NE(westbound, sim::kInvalidTrainId);
+    for (int tick = 0; tick < 100; ++tick) {
+        rail.tick(graph);
+    }
+    EXPECT_EQ(rail.lastTickStats().blockedTrains, 2u);
+    EXPECT_EQ(rail.lastTickStats().deadlockedTrains, 2u);
+    EXPECT_EQ(rail.trainHead(eastbound).distanceAlongQ8, 10u * 256u);
+    EXPECT_EQ(rail.trainHead(westbound).edgeId, eastEdge);
+}
+
+TEST(SimRailTrafficTest, TrainThatOverhangsItsStartEdgeIsRejected) {
+    using namespace odai;
+
+    sim::NetworkGraph graph;
+    sim::RailTrafficSim rail;
+    const sim::NodeId west = AddNetworkNode(graph, 0, 0, 0);
+    const sim::NodeId east = AddNetworkNode(graph, 10, 0, 0);
+    const sim::EdgeId edge = AddRailEdge(graph, rail, west, east, 10, sim::RailEdgeData{});
+
+    EXPECT_EQ(rail.addTrain(graph, MakeRailTrain(edge, 3u * 256u, true, 64, {east})), sim::kInvalidTrainId);
+    EXPECT_EQ(rail.trainCount(), 0u);
+    EXPECT_FALSE(rail.edgeBlockState(edge).reserved);
+    EXPECT_NE(rail.addTrain(graph, MakeRailTrain(edge, 6u * 256u, true, 64, {east})), sim::kInvalidTrainId);
+}
+
+TEST(SimRailTrafficTest, FiveHundredTrainsRunWithoutCollisionOrDeadlock) {
+    using namespace odai;
+
+    // odai_sim_network_bench times this layout's ticks/sec.
+    sim::NetworkGraph graph;
+    sim::RailTrafficSim rail;
+    const tools::RailRingLayout layout = tools::buildRailRingLayout(graph, rail);
+    for (const sim::RailTrainDesc& desc : layout.trains) {
+        ASSERT_NE(rail.addTrain(graph, desc), sim::kInvalidTrainId);
+    }
+    ASSERT_EQ(rail.trainCount(), 500u);
+
+    constexpr std::uint64_t kTicks = 3000;
+    for (std::uint64_t tick = 0; tick < kTicks; ++tick) {
+        rail.tick(graph);
+        ASSERT_EQ(rail.lastTickStats().deadlockedTrains, 0u) << "tick " << tick;
+        ASSERT_EQ(rail.lastTickStats().unroutableTrains, 0u) << "tick " << tick;
+        if (tick % 10u == 0u) {
+            ExpectNoSharedTrack(graph, rail, layout.switchGroupByEdge, tick);
+        }
+    }
+
+    std::uint32_t fewestArrivals = std::numeric_limits<std::uint32_t>::max();
+    for (sim::TrainId trainId = 0; trainId < rail.trainCount(); ++trainId) {
+        fewestArrivals = std::min(fewestArrivals, rail.trainArrivals(trainId));
+    }
+    EXPECT_GE(fewestArrivals, 2u);
+    EXPECT_EQ(rail.routeTableCount(), static_cast<std::size_t>(tools::RailRingLayout::kRingCount * 3));
+    EXPECT_EQ(rail.routeTableBuildCount(), rail.routeTableCount());
+}